@@ -0,0 +1,143 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#define _POSIX_C_SOURCE 199309L // NOLINT(bugprone-reserved-identifier)
+
+#include "./bench.h"
+#include <stdlib.h>
+
+#define ARRAY_BENCH_COUNT 50000000
+#define ARRAY_BENCH_REPEATS 5
+
+// Representation of 'Array<T>' in the runtime library.
+struct Array {
+	void*	data;
+	int64_t length, capacity;
+};
+
+// The runtime library.
+void array_SEP___init__(struct Array* p_self);
+void array_SEP___del__(struct Array* p_self);
+
+// Kernels from 'array.ll', compiled like the compiler's output.
+void	array_push(struct Array* p_numbers, int64_t n);
+int64_t array_pop(struct Array* p_numbers);
+int64_t array_get_checked(struct Array* p_numbers, int64_t n);
+int64_t array_get(struct Array* p_numbers);
+
+/**
+ * The C baseline of an 'Array<i64>': a buffer whose capacity doubles as it grows.
+ */
+struct CArray {
+	int64_t* data;
+	int64_t	 length, capacity;
+};
+
+/**
+ * The C baseline of 'array_push'.
+ *
+ * @param p_numbers The array.
+ * @param n         The number of numbers to append.
+ */
+__attribute__((noinline)) void array_bench___c_push(struct CArray* p_numbers, int64_t n) {
+	for (int64_t i = 0; i < n; i++) {
+		if (p_numbers->length == p_numbers->capacity) {
+			p_numbers->capacity = p_numbers->capacity > 4 ? p_numbers->capacity * 2 : 8;
+			p_numbers->data =
+				realloc(p_numbers->data, (size_t)p_numbers->capacity * sizeof(int64_t));
+			if (p_numbers->data == NULL) {
+				abort();
+			}
+		}
+		p_numbers->data[p_numbers->length++] = i;
+	}
+}
+
+/**
+ * The C baseline of 'array_pop'.
+ *
+ * @param p_numbers The array.
+ *
+ * @return The sum of the numbers.
+ */
+__attribute__((noinline)) int64_t array_bench___c_pop(struct CArray* p_numbers) {
+	int64_t sum = 0;
+
+	while (p_numbers->length > 0) {
+		sum += p_numbers->data[--p_numbers->length];
+	}
+
+	return sum;
+}
+
+/**
+ * The C baseline of 'array_get' and 'array_get_checked'.
+ *
+ * @param p_numbers The array.
+ *
+ * @return The sum of the numbers.
+ */
+__attribute__((noinline)) int64_t array_bench___c_get(const struct CArray* p_numbers) {
+	int64_t sum = 0;
+
+	for (int64_t i = 0; i < p_numbers->length; i++) {
+		sum += p_numbers->data[i];
+	}
+
+	return sum;
+}
+
+int main(void) {
+	int	   passed  = 1;
+	double pushed = 0, cPushed = 0, checked = 0, unchecked = 0, got = 0, popped = 0, cPopped = 0;
+	int64_t checkedSum = 0, uncheckedSum = 0, gotSum = 0, poppedSum = 0, cPoppedSum = 0;
+
+	for (int repeat = 0; repeat < ARRAY_BENCH_REPEATS; repeat++) {
+		struct Array numbers;
+		array_SEP___init__(&numbers);
+		struct CArray cNumbers = {NULL, 0, 0};
+
+		double start = bench_now();
+		array_push(&numbers, ARRAY_BENCH_COUNT);
+		pushed += bench_now() - start;
+
+		start = bench_now();
+		array_bench___c_push(&cNumbers, ARRAY_BENCH_COUNT);
+		cPushed += bench_now() - start;
+
+		start = bench_now();
+		checkedSum += array_get_checked(&numbers, ARRAY_BENCH_COUNT);
+		checked += bench_now() - start;
+
+		start = bench_now();
+		uncheckedSum += array_get(&numbers);
+		unchecked += bench_now() - start;
+
+		start = bench_now();
+		gotSum += array_bench___c_get(&cNumbers);
+		got += bench_now() - start;
+
+		start = bench_now();
+		poppedSum += array_pop(&numbers);
+		popped += bench_now() - start;
+
+		start = bench_now();
+		cPoppedSum += array_bench___c_pop(&cNumbers);
+		cPopped += bench_now() - start;
+
+		array_SEP___del__(&numbers);
+		free(cNumbers.data);
+	}
+
+	bench_report("push", pushed, cPushed);
+	passed &= bench_check("get (checked)", checkedSum, gotSum);
+	bench_report("get (checked)", checked, got);
+	passed &= bench_check("get (in bounds)", uncheckedSum, gotSum);
+	bench_report("get (in bounds)", unchecked, got);
+	passed &= bench_check("pop", poppedSum, cPoppedSum);
+	bench_report("pop", popped, cPopped);
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+; Kernels of the 'Array<T>' benchmark, as the compiler emits them. Locals live in allocas, like
+; every local the compiler emits, and are promoted to registers by the optimiser.
+
+%array = type {
+	i8*,    ; 0: _data - pointer to the elements
+	i64,    ; 1: length - number of elements
+	i64     ; 2: capacity - elements the buffer can hold
+}
+
+declare void @array_SEP_append(%array*, i8*, i64)
+declare i8* @array_SEP_get(%array*, i64, i64)
+declare void @array_SEP_remove(%array*, i64, i64)
+declare i64 @array_SEP_length(%array*)
+
+; array_push = func(numbers: Array<i64>, n: i64) {
+; 	for range(0, n) => i {
+; 		numbers.append(i)
+; 	}
+; }
+define void @array_push(%array* %numbers, i64 %n) nounwind {
+	%element = alloca i64
+	br label %loop.0.preheader
+
+loop.0.preheader:
+	%loop.0.empty = icmp sge i64 0, %n
+	br i1 %loop.0.empty, label %loop.0.exit, label %loop.0.body
+
+loop.0.body:
+	%i = phi i64 [ 0, %loop.0.preheader ], [ %loop.0.next, %loop.0.latch ]
+	store i64 %i, i64* %element
+	%1 = bitcast i64* %element to i8*
+	call void @array_SEP_append(%array* %numbers, i8* %1, i64 8)
+	br label %loop.0.latch
+
+loop.0.latch:
+	%loop.0.next = add nsw i64 %i, 1
+	%loop.0.done = icmp eq i64 %loop.0.next, %n
+	br i1 %loop.0.done, label %loop.0.exit, label %loop.0.body
+
+loop.0.exit:
+	ret void
+}
+
+; array_pop = func(numbers: Array<i64>) -> i64 {
+; 	sum: i64 = 0
+; 	while numbers.length() > 0 {
+; 		last = numbers.length() - 1
+; 		sum = sum + numbers.get(last)
+; 		numbers.remove(last)
+; 	}
+; 	return sum
+; }
+define i64 @array_pop(%array* %numbers) nounwind {
+	%sum = alloca i64
+	store i64 0, i64* %sum
+	br label %condition
+
+condition:
+	%1 = call i64 @array_SEP_length(%array* %numbers)
+	%2 = icmp sgt i64 %1, 0
+	br i1 %2, label %body, label %exit
+
+body:
+	%3 = call i64 @array_SEP_length(%array* %numbers)
+	%last = sub i64 %3, 1
+	%4 = call i8* @array_SEP_get(%array* %numbers, i64 %last, i64 8)
+	%5 = bitcast i8* %4 to i64*
+	%6 = load i64, i64* %5
+	%7 = load i64, i64* %sum
+	%8 = add i64 %7, %6
+	store i64 %8, i64* %sum
+	call void @array_SEP_remove(%array* %numbers, i64 %last, i64 8)
+	br label %condition
+
+exit:
+	%9 = load i64, i64* %sum
+	ret i64 %9
+}
+
+; array_get_checked = func(numbers: Array<i64>, n: i64) -> i64 {
+; 	sum: i64 = 0
+; 	for range(0, n) => i {
+; 		sum = sum + numbers.get(i)
+; 	}
+; 	return sum
+; }
+;
+; 'n' is not the length of 'numbers', so every access calls the checked 'array.get'.
+define i64 @array_get_checked(%array* %numbers, i64 %n) nounwind {
+	%sum = alloca i64
+	store i64 0, i64* %sum
+	br label %loop.0.preheader
+
+loop.0.preheader:
+	%loop.0.empty = icmp sge i64 0, %n
+	br i1 %loop.0.empty, label %loop.0.exit, label %loop.0.body
+
+loop.0.body:
+	%i = phi i64 [ 0, %loop.0.preheader ], [ %loop.0.next, %loop.0.latch ]
+	%number.raw = call i8* @array_SEP_get(%array* %numbers, i64 %i, i64 ptrtoint (i64* getelementptr (i64, i64* null, i32 1) to i64))
+	%number = bitcast i8* %number.raw to i64*
+	%1 = load i64, i64* %number
+	%2 = load i64, i64* %sum
+	%3 = add i64 %2, %1
+	store i64 %3, i64* %sum
+	br label %loop.0.latch
+
+loop.0.latch:
+	%loop.0.next = add nsw i64 %i, 1
+	%loop.0.done = icmp eq i64 %loop.0.next, %n
+	br i1 %loop.0.done, label %loop.0.exit, label %loop.0.body
+
+loop.0.exit:
+	%4 = load i64, i64* %sum
+	ret i64 %4
+}
+
+; array_get = func(numbers: Array<i64>) -> i64 {
+; 	sum: i64 = 0
+; 	for range(0, numbers.length()) => i {
+; 		sum = sum + numbers.get(i)
+; 	}
+; 	return sum
+; }
+;
+; The loop stops at the length of 'numbers', so the accesses are in bounds and index directly.
+define i64 @array_get(%array* %numbers) nounwind {
+	%sum = alloca i64
+	store i64 0, i64* %sum
+	%length = call i64 @array_SEP_length(%array* %numbers)
+	br label %loop.0.preheader
+
+loop.0.preheader:
+	%loop.0.empty = icmp sge i64 0, %length
+	br i1 %loop.0.empty, label %loop.0.exit, label %loop.0.body
+
+loop.0.body:
+	%i = phi i64 [ 0, %loop.0.preheader ], [ %loop.0.next, %loop.0.latch ]
+	%number.data.ptr = getelementptr inbounds %array, %array* %numbers, i64 0, i32 0
+	%number.data = load i8*, i8** %number.data.ptr
+	%number.elements = bitcast i8* %number.data to i64*
+	%number = getelementptr inbounds i64, i64* %number.elements, i64 %i
+	%1 = load i64, i64* %number
+	%2 = load i64, i64* %sum
+	%3 = add i64 %2, %1
+	store i64 %3, i64* %sum
+	br label %loop.0.latch
+
+loop.0.latch:
+	%loop.0.next = add nsw i64 %i, 1
+	%loop.0.done = icmp eq i64 %loop.0.next, %length
+	br i1 %loop.0.done, label %loop.0.exit, label %loop.0.body
+
+loop.0.exit:
+	%4 = load i64, i64* %sum
+	ret i64 %4
+}
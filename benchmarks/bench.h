@@ -0,0 +1,55 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Gets the time of a monotonic clock.
+ *
+ * @return The time in seconds.
+ */
+static inline double bench_now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + ((double)time.tv_nsec / 1e9);
+}
+
+/**
+ * Prints how long a benchmark took against its C baseline.
+ *
+ * @param p_name   The name of the benchmark.
+ * @param seconds  How long the compiled Exeme took.
+ * @param baseline How long the C baseline took.
+ */
+static inline void bench_report(const char* p_name, double seconds, double baseline) {
+	printf("%-24s %10.3f ms   C: %10.3f ms   %6.2fx\n", p_name, seconds * 1e3, baseline * 1e3,
+		   seconds / baseline);
+}
+
+/**
+ * Checks that a benchmark computed the same result as its C baseline, which also keeps the
+ * compiler from removing either of them.
+ *
+ * @param p_name   The name of the benchmark.
+ * @param result   The result of the compiled Exeme.
+ * @param baseline The result of the C baseline.
+ *
+ * @return Whether the results match.
+ */
+static inline int bench_check(const char* p_name, int64_t result, int64_t baseline) {
+	if (result == baseline) {
+		return 1;
+	}
+
+	fprintf(stderr, "%s: got %lld, but C got %lld\n", p_name, (long long)result,
+			(long long)baseline);
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#define _POSIX_C_SOURCE 199309L // NOLINT(bugprone-reserved-identifier)
+
+#include "./bench.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+#define IO_BENCH_COUNT 10000000
+
+// The runtime library.
+void io_SEP_flush(void);
+
+// Kernel from 'io.ll', compiled like the compiler's output.
+void io_print(int64_t n);
+
+/**
+ * The C baseline of 'io_print'.
+ *
+ * @param n The number of integers to print.
+ */
+__attribute__((noinline)) void io_bench___c_print(int64_t n) {
+	for (int64_t i = 0; i < n; i++) {
+		printf("%lld\n", (long long)i);
+	}
+}
+
+int main(int argc, char** argv) {
+	// Prints to '/dev/null', unless given a file, so the terminal does not set the pace
+	const char* lp_path = argc > 1 ? argv[1] : "/dev/null";
+	int			output	= open(lp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	int			saved	= dup(STDOUT_FILENO);
+	if (output < 0 || saved < 0 || dup2(output, STDOUT_FILENO) < 0) {
+		perror(lp_path);
+		return 1;
+	}
+
+	double start = bench_now();
+	io_print(IO_BENCH_COUNT);
+	io_SEP_flush();
+	double seconds = bench_now() - start;
+
+	start = bench_now();
+	io_bench___c_print(IO_BENCH_COUNT);
+	fflush(stdout);
+	double baseline = bench_now() - start;
+
+	if (dup2(saved, STDOUT_FILENO) < 0) {
+		return 1;
+	}
+	close(saved);
+	close(output);
+
+	bench_report("io::out 10M integers", seconds, baseline);
+
+	return 0;
+}
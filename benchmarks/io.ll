@@ -0,0 +1,29 @@
+; Kernel of the 'io::out' benchmark, as the compiler emits it.
+
+declare void @io_SEP_out_i64(i64)
+
+; io_print = func(n: i64) {
+; 	for range(0, n) => i {
+; 		io::out(i)
+; 	}
+; }
+define void @io_print(i64 %n) nounwind {
+	br label %loop.0.preheader
+
+loop.0.preheader:
+	%loop.0.empty = icmp sge i64 0, %n
+	br i1 %loop.0.empty, label %loop.0.exit, label %loop.0.body
+
+loop.0.body:
+	%i = phi i64 [ 0, %loop.0.preheader ], [ %loop.0.next, %loop.0.latch ]
+	call void @io_SEP_out_i64(i64 %i)
+	br label %loop.0.latch
+
+loop.0.latch:
+	%loop.0.next = add nsw i64 %i, 1
+	%loop.0.done = icmp eq i64 %loop.0.next, %n
+	br i1 %loop.0.done, label %loop.0.exit, label %loop.0.body
+
+loop.0.exit:
+	ret void
+}
@@ -0,0 +1,102 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#define _POSIX_C_SOURCE 199309L // NOLINT(bugprone-reserved-identifier)
+
+#include "./bench.h"
+#include <stdlib.h>
+
+#define RANGE_BENCH_COUNT 100000000
+#define RANGE_BENCH_REPEATS 5
+
+// Representation of 'Array<T>' in the runtime library.
+struct Array {
+	void*	data;
+	int64_t length, capacity;
+};
+
+// Kernels from 'range.ll', compiled like the compiler's output.
+int64_t range_sum(int64_t n);
+int64_t array_sum(struct Array* p_numbers);
+
+/**
+ * The C baseline of 'range_sum'.
+ *
+ * @param n The number of indexes.
+ *
+ * @return The sum.
+ */
+__attribute__((noinline)) int64_t range_bench___c_range_sum(int64_t n) {
+	int64_t sum = 0;
+
+	for (int64_t i = 0; i < n; i++) {
+		sum += i ^ (i >> 3);
+	}
+
+	return sum;
+}
+
+/**
+ * The C baseline of 'array_sum'.
+ *
+ * @param p_numbers The numbers.
+ * @param length    The number of numbers.
+ *
+ * @return The sum.
+ */
+__attribute__((noinline)) int64_t range_bench___c_array_sum(const int64_t* p_numbers,
+															 int64_t		length) {
+	int64_t sum = 0;
+
+	for (int64_t i = 0; i < length; i++) {
+		sum += p_numbers[i];
+	}
+
+	return sum;
+}
+
+int main(void) {
+	int		 passed = 1;
+	int64_t* lp_numbers = malloc(RANGE_BENCH_COUNT * sizeof(int64_t));
+	if (lp_numbers == NULL) {
+		return 1;
+	}
+	for (int64_t i = 0; i < RANGE_BENCH_COUNT; i++) {
+		lp_numbers[i] = i % 1000;
+	}
+	struct Array numbers = {lp_numbers, RANGE_BENCH_COUNT, RANGE_BENCH_COUNT};
+
+	double	seconds = 0, baseline = 0;
+	int64_t result = 0, expected = 0;
+	for (int repeat = 0; repeat < RANGE_BENCH_REPEATS; repeat++) {
+		double start = bench_now();
+		result += range_sum(RANGE_BENCH_COUNT);
+		seconds += bench_now() - start;
+
+		start = bench_now();
+		expected += range_bench___c_range_sum(RANGE_BENCH_COUNT);
+		baseline += bench_now() - start;
+	}
+	passed &= bench_check("for range(0, n) => i", result, expected);
+	bench_report("for range(0, n) => i", seconds, baseline);
+
+	seconds = baseline = 0;
+	result = expected = 0;
+	for (int repeat = 0; repeat < RANGE_BENCH_REPEATS; repeat++) {
+		double start = bench_now();
+		result += array_sum(&numbers);
+		seconds += bench_now() - start;
+
+		start = bench_now();
+		expected += range_bench___c_array_sum(lp_numbers, RANGE_BENCH_COUNT);
+		baseline += bench_now() - start;
+	}
+	passed &= bench_check("for numbers => number", result, expected);
+	bench_report("for numbers => number", seconds, baseline);
+
+	free(lp_numbers);
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+; Kernels of the counted loop benchmark, as the loop lowering emits them. Locals live in allocas,
+; like every local the compiler emits, and are promoted to registers by the optimiser.
+
+%array = type {
+	i8*,    ; 0: _data - pointer to the elements
+	i64,    ; 1: length - number of elements
+	i64     ; 2: capacity - elements the buffer can hold
+}
+
+; range_sum = func(n: i64) -> i64 {
+; 	sum: i64 = 0
+; 	for range(0, n) => i {
+; 		sum = sum + (i ^ (i >> 3))
+; 	}
+; 	return sum
+; }
+define i64 @range_sum(i64 %n) nounwind {
+	%sum = alloca i64
+	store i64 0, i64* %sum
+	br label %loop.0.preheader
+
+loop.0.preheader:
+	%loop.0.empty = icmp sge i64 0, %n
+	br i1 %loop.0.empty, label %loop.0.exit, label %loop.0.body
+
+loop.0.body:
+	%i = phi i64 [ 0, %loop.0.preheader ], [ %loop.0.next, %loop.0.latch ]
+	%1 = ashr i64 %i, 3
+	%2 = xor i64 %i, %1
+	%3 = load i64, i64* %sum
+	%4 = add i64 %3, %2
+	store i64 %4, i64* %sum
+	br label %loop.0.latch
+
+loop.0.latch:
+	%loop.0.next = add nsw i64 %i, 1
+	%loop.0.done = icmp eq i64 %loop.0.next, %n
+	br i1 %loop.0.done, label %loop.0.exit, label %loop.0.body
+
+loop.0.exit:
+	%5 = load i64, i64* %sum
+	ret i64 %5
+}
+
+; array_sum = func(numbers: Array<i64>) -> i64 {
+; 	sum: i64 = 0
+; 	for numbers => number {
+; 		sum = sum + number
+; 	}
+; 	return sum
+; }
+define i64 @array_sum(%array* %numbers) nounwind {
+	%sum = alloca i64
+	store i64 0, i64* %sum
+	%length.ptr = getelementptr inbounds %array, %array* %numbers, i64 0, i32 1
+	%length = load i64, i64* %length.ptr
+	%data.ptr = getelementptr inbounds %array, %array* %numbers, i64 0, i32 0
+	%data.raw = load i8*, i8** %data.ptr
+	%data = bitcast i8* %data.raw to i64*
+	br label %loop.0.preheader
+
+loop.0.preheader:
+	%loop.0.empty = icmp sge i64 0, %length
+	br i1 %loop.0.empty, label %loop.0.exit, label %loop.0.body
+
+loop.0.body:
+	%i = phi i64 [ 0, %loop.0.preheader ], [ %loop.0.next, %loop.0.latch ]
+	%number.ptr = getelementptr inbounds i64, i64* %data, i64 %i
+	%number = load i64, i64* %number.ptr
+	%1 = load i64, i64* %sum
+	%2 = add i64 %1, %number
+	store i64 %2, i64* %sum
+	br label %loop.0.latch
+
+loop.0.latch:
+	%loop.0.next = add nsw i64 %i, 1
+	%loop.0.done = icmp eq i64 %loop.0.next, %length
+	br i1 %loop.0.done, label %loop.0.exit, label %loop.0.body
+
+loop.0.exit:
+	%3 = load i64, i64* %sum
+	ret i64 %3
+}
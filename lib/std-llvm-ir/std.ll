@@ -1,16 +1,2582 @@
+; Runtime library linked into every program, as bitcode precompiled from this file.
+;
+; Strings are 24 bytes. Strings of up to 23 characters are stored inline, so building short strings
+; never allocates. Longer strings live in a heap buffer whose capacity doubles as they grow. The
+; characters are always followed by a NUL, so 'data' can be passed to C directly.
+;
+; Inline:  bytes 0-22 hold the characters, byte 23 holds 23 - length (0 doubles as the NUL of a
+;          23 character string).
+; Heap:    0: the buffer, 1: the length, 2: the capacity (without the NUL) with bit 63 set. Byte 23
+;          is the top byte of the capacity on little endian targets, so its top bit tells the
+;          representations apart.
+; Arena:   like heap, with bit 62 of the capacity set too. Strings initialised while an arena is
+;          the default allocator (see 'mem') start in its buffers, even when short, and grow in it.
 %str = type {
 	i8*,    ; 0: _char_buf - pointer to the character buffer
 	i64,    ; 1: length - number of characters in the buffer
+	i64     ; 2: capacity - characters the buffer can hold, with bit 63 set
 }
 
+declare noalias i8* @malloc(i64) nounwind
+declare noalias i8* @realloc(i8*, i64) nounwind
+declare void @free(i8*) nounwind
+declare i64 @strlen(i8*) nounwind readonly
+declare i32 @memcmp(i8*, i8*, i64) nounwind readonly
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8* noalias nocapture writeonly, i8* noalias nocapture readonly, i64, i1 immarg)
+
+@str___minus = private unnamed_addr constant [1 x i8] c"-"
+
+; Gets whether a string lives in a heap buffer.
+define private i1 @str___is_heap(%str* %self) alwaysinline nounwind {
+	%1 = getelementptr inbounds %str, %str* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	%2 = load i64, i64* %1
+	%3 = icmp slt i64 %2, 0 ; bit 63 set
+	ret i1 %3
+}
+
+; Gets whether a string lives in a buffer allocated from an arena.
+define private i1 @str___is_arena(%str* %self) alwaysinline nounwind {
+	%1 = getelementptr inbounds %str, %str* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	%2 = load i64, i64* %1
+	%3 = and i64 %2, -4611686018427387904 ; bits 63 and 62
+	%4 = icmp eq i64 %3, -4611686018427387904 ; both set
+	ret i1 %4
+}
+
+; Gets the byte holding 23 - length of an inline string.
+define private i8* @str___inline_remaining(%str* %self) alwaysinline nounwind {
+	%1 = bitcast %str* %self to [24 x i8]*
+	%2 = getelementptr inbounds [24 x i8], [24 x i8]* %1, i64 0, i64 23
+	ret i8* %2
+}
+
+; Sets the length of a string, and writes the NUL after its characters.
+define private void @str___set_length(%str* %self, i64 %length) alwaysinline nounwind {
+	%1 = call i8* @str_SEP_data(%str* %self)
+	%2 = getelementptr inbounds i8, i8* %1, i64 %length
+	store i8 0, i8* %2 ; terminate
+	%3 = call i1 @str___is_heap(%str* %self)
+	br i1 %3, label %heap, label %inline
+
+heap:
+	%4 = getelementptr inbounds %str, %str* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 %length, i64* %4
+	ret void
+
+inline:
+	%5 = sub i64 23, %length
+	%6 = trunc i64 %5 to i8
+	%7 = call i8* @str___inline_remaining(%str* %self)
+	store i8 %6, i8* %7
+	ret void
+}
+
+; Initialises an empty inline string, whatever the default allocator.
+define private void @str___init_inline(%str* %self) alwaysinline nounwind {
+	%1 = bitcast %str* %self to i8*
+	store i8 0, i8* %1 ; terminate
+	%2 = call i8* @str___inline_remaining(%str* %self)
+	store i8 23, i8* %2
+	ret void
+}
+
+; Initialises an empty string in a buffer of some capacity allocated from an arena.
+define private void @str___init_arena(%str* %self, %mem.arena* %arena, i64 %capacity) nounwind {
+	%1 = add i64 %capacity, 1 ; with the NUL
+	%2 = call i8* @mem___place(%mem.arena* %arena, i64 %1)
+	store i8 0, i8* %2 ; terminate
+	%3 = getelementptr inbounds %str, %str* %self, i64 0, i32 0 ; get pointer to '_char_buf'
+	store i8* %2, i8** %3
+	%4 = getelementptr inbounds %str, %str* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 0, i64* %4
+	%5 = or i64 %capacity, -4611686018427387904 ; set bits 63 and 62
+	%6 = getelementptr inbounds %str, %str* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	store i64 %5, i64* %6
+	ret void
+}
+
+; Initialises an empty string, inline unless an arena is the default allocator.
+define void @str_SEP___init_empty__(%str* %self) nounwind {
+	%1 = load %mem.arena*, %mem.arena** @mem___default
+	%2 = icmp eq %mem.arena* %1, null
+	br i1 %2, label %inline, label %arena
+
+inline:
+	call void @str___init_inline(%str* %self)
+	ret void
+
+arena:
+	call void @str___init_arena(%str* %self, %mem.arena* %1, i64 23)
+	ret void
+}
+
+; Initialises a string with a copy of some characters, inline if they fit and no arena is the
+; default allocator.
+define void @str_SEP___init_bytes__(%str* %self, i8* %bytes, i64 %length) nounwind {
+	%1 = load %mem.arena*, %mem.arena** @mem___default
+	%2 = icmp eq %mem.arena* %1, null
+	br i1 %2, label %check, label %arena
+
+check:
+	%3 = icmp ule i64 %length, 23
+	br i1 %3, label %inline, label %heap
+
+inline:
+	%4 = bitcast %str* %self to i8*
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %4, i8* %bytes, i64 %length, i1 false)
+	%5 = getelementptr inbounds i8, i8* %4, i64 %length
+	store i8 0, i8* %5 ; terminate
+	%6 = sub i64 23, %length
+	%7 = trunc i64 %6 to i8
+	%8 = call i8* @str___inline_remaining(%str* %self)
+	store i8 %7, i8* %8
+	ret void
+
+heap:
+	%9 = add i64 %length, 1
+	%buffer = call i8* @malloc(i64 %9)
+	%10 = call i8* @panic___check_allocation(i8* %buffer, i64 %9)
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %10, i8* %bytes, i64 %length, i1 false)
+	%11 = getelementptr inbounds i8, i8* %10, i64 %length
+	store i8 0, i8* %11 ; terminate
+	%12 = getelementptr inbounds %str, %str* %self, i64 0, i32 0 ; get pointer to '_char_buf'
+	store i8* %10, i8** %12
+	%13 = getelementptr inbounds %str, %str* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 %length, i64* %13
+	%14 = or i64 %length, -9223372036854775808 ; set bit 63
+	%15 = getelementptr inbounds %str, %str* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	store i64 %14, i64* %15
+	ret void
+
+arena:
+	%16 = icmp ugt i64 %length, 23
+	%17 = select i1 %16, i64 %length, i64 23 ; at least the room of an inline string
+	call void @str___init_arena(%str* %self, %mem.arena* %1, i64 %17)
+	%18 = getelementptr inbounds %str, %str* %self, i64 0, i32 0 ; get pointer to '_char_buf'
+	%19 = load i8*, i8** %18
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %19, i8* %bytes, i64 %length, i1 false)
+	call void @str___set_length(%str* %self, i64 %length)
+	ret void
+}
+
+; Initialises a string with a copy of a NUL terminated string, empty if it is null.
 define void @str_SEP___init__(%str* %self, i8* %string) nounwind {
-	; Initiailise '_char_buf'
-	%1 = getelementptr %str* %self, i64 0, i64, 0 ; get pointer to '_char_buf'
-	store i8* null, i8** %1 ; store null pointer
+	%1 = icmp eq i8* %string, null
+	br i1 %1, label %empty, label %copy
+
+empty:
+	call void @str_SEP___init_empty__(%str* %self)
+	ret void
+
+copy:
+	%2 = call i64 @strlen(i8* %string)
+	call void @str_SEP___init_bytes__(%str* %self, i8* %string, i64 %2)
+	ret void
+}
+
+; Initialises a string with a copy of another string, e.g. for 'name.clone()'. Strings are moved
+; rather than copied everywhere else, so this is the only place a string's characters are duplicated.
+define void @str_SEP_clone(%str* %self, %str* %other) nounwind {
+	%1 = call i8* @str_SEP_data(%str* %other)
+	%2 = call i64 @str_SEP_length(%str* %other)
+	call void @str_SEP___init_bytes__(%str* %self, i8* %1, i64 %2)
+	ret void
+}
+
+; Frees the buffer of a string, leaving it empty. Buffers allocated from an arena are left for the
+; arena to release.
+define void @str_SEP___del__(%str* %self) nounwind {
+	%1 = call i1 @str___is_heap(%str* %self)
+	br i1 %1, label %heap, label %done
+
+heap:
+	%2 = call i1 @str___is_arena(%str* %self)
+	br i1 %2, label %done, label %free
+
+free:
+	%3 = getelementptr inbounds %str, %str* %self, i64 0, i32 0 ; get pointer to '_char_buf'
+	%4 = load i8*, i8** %3
+	call void @free(i8* %4)
+	br label %done
+
+done:
+	call void @str___init_inline(%str* %self)
+	ret void
+}
+
+; Gets the number of characters of a string.
+define i64 @str_SEP_length(%str* %self) nounwind {
+	%1 = call i1 @str___is_heap(%str* %self)
+	br i1 %1, label %heap, label %inline
+
+heap:
+	%2 = getelementptr inbounds %str, %str* %self, i64 0, i32 1 ; get pointer to 'length'
+	%3 = load i64, i64* %2
+	ret i64 %3
+
+inline:
+	%4 = call i8* @str___inline_remaining(%str* %self)
+	%5 = load i8, i8* %4
+	%6 = zext i8 %5 to i64
+	%7 = sub i64 23, %6
+	ret i64 %7
+}
+
+; Gets the number of characters a string can hold without growing.
+define i64 @str_SEP_capacity(%str* %self) nounwind {
+	%1 = call i1 @str___is_heap(%str* %self)
+	br i1 %1, label %heap, label %inline
+
+heap:
+	%2 = getelementptr inbounds %str, %str* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	%3 = load i64, i64* %2
+	%4 = and i64 %3, 4611686018427387903 ; clear bits 63 and 62
+	ret i64 %4
+
+inline:
+	ret i64 23
+}
+
+; Gets the NUL terminated characters of a string, valid until it next grows.
+define i8* @str_SEP_data(%str* %self) nounwind {
+	%1 = call i1 @str___is_heap(%str* %self)
+	br i1 %1, label %heap, label %inline
+
+heap:
+	%2 = getelementptr inbounds %str, %str* %self, i64 0, i32 0 ; get pointer to '_char_buf'
+	%3 = load i8*, i8** %2
+	ret i8* %3
+
+inline:
+	%4 = bitcast %str* %self to i8*
+	ret i8* %4
+}
+
+; Makes sure a string can hold some number of characters, at least doubling its capacity when it
+; has to grow so appending is amortised O(1). Inline strings move to the heap, never an arena.
+define void @str_SEP_reserve(%str* %self, i64 %needed) nounwind {
+	%1 = call i64 @str_SEP_capacity(%str* %self)
+	%2 = icmp ule i64 %needed, %1
+	br i1 %2, label %done, label %grow
+
+grow:
+	%3 = shl i64 %1, 1
+	%4 = icmp ugt i64 %needed, %3
+	%5 = select i1 %4, i64 %needed, i64 %3 ; the new capacity
+	%6 = add i64 %5, 1
+	%7 = call i1 @str___is_heap(%str* %self)
+	%8 = getelementptr inbounds %str, %str* %self, i64 0, i32 0 ; get pointer to '_char_buf'
+	br i1 %7, label %heap, label %inline
+
+heap:
+	%9 = load i8*, i8** %8
+	%10 = call i1 @str___is_arena(%str* %self)
+	br i1 %10, label %arena, label %realloc
+
+arena:
+	%11 = call i8* @mem___resize(i8* %9, i64 %6)
+	store i8* %11, i8** %8
+	br label %capacity
+
+realloc:
+	%grown = call i8* @realloc(i8* %9, i64 %6)
+	%12 = call i8* @panic___check_allocation(i8* %grown, i64 %6)
+	store i8* %12, i8** %8
+	br label %capacity
+
+inline:
+	%13 = call i64 @str_SEP_length(%str* %self)
+	%buffer = call i8* @malloc(i64 %6)
+	%14 = call i8* @panic___check_allocation(i8* %buffer, i64 %6)
+	%15 = bitcast %str* %self to i8*
+	%16 = add i64 %13, 1 ; with the NUL
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %14, i8* %15, i64 %16, i1 false)
+	store i8* %14, i8** %8
+	%17 = getelementptr inbounds %str, %str* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 %13, i64* %17
+	br label %capacity
+
+capacity:
+	%18 = phi i64 [ -4611686018427387904, %arena ], [ -9223372036854775808, %realloc ], [ -9223372036854775808, %inline ] ; bit 63, and 62 in an arena
+	%19 = or i64 %5, %18
+	%20 = getelementptr inbounds %str, %str* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	store i64 %19, i64* %20
+	br label %done
+
+done:
+	ret void
+}
+
+; Appends some characters to a string. They must not be part of the string itself.
+define void @str_SEP_append_bytes(%str* %self, i8* %bytes, i64 %length) nounwind {
+	%1 = call i64 @str_SEP_length(%str* %self)
+	%2 = add i64 %1, %length
+	call void @str_SEP_reserve(%str* %self, i64 %2)
+	%3 = call i8* @str_SEP_data(%str* %self)
+	%4 = getelementptr inbounds i8, i8* %3, i64 %1
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %4, i8* %bytes, i64 %length, i1 false)
+	call void @str___set_length(%str* %self, i64 %2)
+	ret void
+}
+
+; Appends a string to a string, which may be the same string.
+define void @str_SEP_append(%str* %self, %str* %other) nounwind {
+	%1 = call i64 @str_SEP_length(%str* %self)
+	%2 = call i64 @str_SEP_length(%str* %other)
+	%3 = add i64 %1, %2
+	call void @str_SEP_reserve(%str* %self, i64 %3) ; first, as it moves 'other' if it is 'self'
+	%4 = call i8* @str_SEP_data(%str* %other)
+	call void @str_SEP_append_bytes(%str* %self, i8* %4, i64 %2)
+	ret void
+}
+
+; Appends the decimal digits of an unsigned integer to a string. The digits are written backwards
+; into a buffer on the stack, so the only allocation is the string growing.
+define void @str_SEP_append_u64(%str* %self, i64 %value) nounwind {
+entry:
+	%buffer = alloca [20 x i8] ; 18446744073709551615 has 20 digits
+	br label %digit
+
+digit:
+	%rest = phi i64 [ %value, %entry ], [ %next, %digit ]
+	%end = phi i64 [ 20, %entry ], [ %start, %digit ]
+	%next = udiv i64 %rest, 10
+	%remainder = urem i64 %rest, 10
+	%low = trunc i64 %remainder to i8
+	%start = sub i64 %end, 1
+	%first = getelementptr inbounds [20 x i8], [20 x i8]* %buffer, i64 0, i64 %start
+	%char = add i8 %low, 48 ; '0'
+	store i8 %char, i8* %first
+	%more = icmp ne i64 %next, 0
+	br i1 %more, label %digit, label %done
+
+done:
+	%length = sub i64 20, %start
+	call void @str_SEP_append_bytes(%str* %self, i8* %first, i64 %length)
+	ret void
+}
+
+; Appends the decimal digits of a signed integer to a string.
+define void @str_SEP_append_i64(%str* %self, i64 %value) nounwind {
+	%1 = icmp slt i64 %value, 0
+	br i1 %1, label %negative, label %positive
+
+negative:
+	%2 = getelementptr inbounds [1 x i8], [1 x i8]* @str___minus, i64 0, i64 0
+	call void @str_SEP_append_bytes(%str* %self, i8* %2, i64 1)
+	%3 = sub i64 0, %value ; also right for the minimum, as an unsigned value
+	call void @str_SEP_append_u64(%str* %self, i64 %3)
+	ret void
+
+positive:
+	call void @str_SEP_append_u64(%str* %self, i64 %value)
+	ret void
+}
+
+; Initialises a string with the decimal digits of a signed integer, which always fit without
+; growing.
+; Narrower integers are sign extended by the caller.
+define void @str_SEP_from_i64(%str* %self, i64 %value) nounwind {
+	call void @str_SEP___init_empty__(%str* %self)
+	call void @str_SEP_append_i64(%str* %self, i64 %value)
+	ret void
+}
+
+; Initialises a string with the decimal digits of an unsigned integer, which always fit without
+; growing.
+; Narrower integers are zero extended by the caller.
+define void @str_SEP_from_u64(%str* %self, i64 %value) nounwind {
+	call void @str_SEP___init_empty__(%str* %self)
+	call void @str_SEP_append_u64(%str* %self, i64 %value)
+	ret void
+}
+
+; Compares two strings byte by byte, then by length: negative if 'self' sorts first, zero if they are
+; equal, positive otherwise.
+define i32 @str_SEP_compare(%str* %self, %str* %other) nounwind {
+	%1 = call i64 @str_SEP_length(%str* %self)
+	%2 = call i64 @str_SEP_length(%str* %other)
+	%3 = icmp ult i64 %1, %2
+	%4 = select i1 %3, i64 %1, i64 %2
+	%5 = call i8* @str_SEP_data(%str* %self)
+	%6 = call i8* @str_SEP_data(%str* %other)
+	%7 = call i32 @memcmp(i8* %5, i8* %6, i64 %4)
+	%8 = icmp ne i32 %7, 0
+	br i1 %8, label %bytes, label %lengths
+
+bytes:
+	ret i32 %7
+
+lengths: ; the shorter string sorts first
+	%9 = icmp ugt i64 %1, %2
+	%10 = zext i1 %9 to i32
+	%11 = sext i1 %3 to i32
+	%12 = or i32 %10, %11
+	ret i32 %12
+}
+
+; Panics flush the output written so far, print why the program cannot go on to stderr and abort.
+; They are kept out of line and cold, so the checks calling them cost a compare and a branch.
+declare i32 @dprintf(i32, i8*, ...) nounwind
+declare void @abort() noreturn nounwind
+
+@panic___division_by_zero_message = private unnamed_addr constant [18 x i8] c"division by zero\0A\00"
+
+; Aborts on an integer division or remainder by zero, which the compiler checks for before dividing
+; by a value that is not a constant.
+define void @panic_SEP_division_by_zero() noinline noreturn cold nounwind {
+	call void @io_SEP_flush()
+	%1 = getelementptr inbounds [18 x i8], [18 x i8]* @panic___division_by_zero_message, i64 0, i64 0
+	%2 = call i32 (i32, i8*, ...) @dprintf(i32 2, i8* %1) ; stderr
+	call void @abort()
+	unreachable
+}
+
+@panic___out_of_memory_message = private unnamed_addr constant [37 x i8] c"out of memory allocating %llu bytes\0A\00"
+
+; Aborts when the heap cannot give some number of bytes, rather than writing through null.
+define private void @panic___out_of_memory(i64 %bytes) noinline noreturn cold nounwind {
+	call void @io_SEP_flush()
+	%1 = getelementptr inbounds [37 x i8], [37 x i8]* @panic___out_of_memory_message, i64 0, i64 0
+	%2 = call i32 (i32, i8*, ...) @dprintf(i32 2, i8* %1, i64 %bytes) ; stderr
+	call void @abort()
+	unreachable
+}
+
+; Gets the memory malloc or realloc returned, aborting if it is null. Asking for 0 bytes may give
+; null too, which is not a failure.
+define private i8* @panic___check_allocation(i8* %memory, i64 %bytes) alwaysinline nounwind {
+	%1 = icmp ne i8* %memory, null
+	%2 = icmp eq i64 %bytes, 0
+	%3 = or i1 %1, %2
+	br i1 %3, label %allocated, label %failed, !prof !0
+
+allocated:
+	ret i8* %memory
+
+failed:
+	call void @panic___out_of_memory(i64 %bytes)
+	unreachable
+}
+
+; Arrays hold their elements contiguously in a heap buffer whose capacity doubles as they grow. The
+; functions are shared by every 'Array<T>', so they take the size of T and return element pointers
+; the caller casts to 'T*'. Arrays initialised while an arena is the default allocator (see 'mem')
+; keep their elements in its buffers instead, which bit 63 of the capacity tells apart.
+%array = type {
+	i8*,    ; 0: _data - pointer to the elements
+	i64,    ; 1: length - number of elements
+	i64     ; 2: capacity - elements the buffer can hold
+}
+
+declare void @llvm.memmove.p0i8.p0i8.i64(i8* nocapture writeonly, i8* nocapture readonly, i64, i1 immarg)
+declare { i64, i1 } @llvm.umul.with.overflow.i64(i64, i64)
+
+@array___out_of_bounds_message = private unnamed_addr constant [44 x i8] c"index %lld is out of bounds of length %lld\0A\00"
+
+; Aborts on an out of bounds index. Kept out of line, so checks cost a compare and a branch.
+define private void @array___out_of_bounds(i64 %index, i64 %length) noinline noreturn cold nounwind {
+	%1 = getelementptr inbounds [44 x i8], [44 x i8]* @array___out_of_bounds_message, i64 0, i64 0
+	%2 = call i32 (i32, i8*, ...) @dprintf(i32 2, i8* %1, i64 %index, i64 %length) ; stderr
+	call void @abort()
+	unreachable
+}
+
+; Initialises an empty heap array, which does not allocate until its first element.
+define private void @array___init_empty(%array* %self) alwaysinline nounwind {
+	%1 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	store i8* null, i8** %1
+	%2 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 0, i64* %2
+	%3 = getelementptr inbounds %array, %array* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	store i64 0, i64* %3
+	ret void
+}
+
+; Initialises an empty array. While an arena is the default allocator it starts with an empty
+; buffer of the arena, so the array grows in the arena wherever it is appended to.
+define void @array_SEP___init__(%array* %self) nounwind {
+	%1 = load %mem.arena*, %mem.arena** @mem___default
+	%2 = icmp eq %mem.arena* %1, null
+	br i1 %2, label %heap, label %arena
+
+heap:
+	call void @array___init_empty(%array* %self)
+	ret void
+
+arena:
+	%3 = call i8* @mem___place(%mem.arena* %1, i64 0)
+	%4 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	store i8* %3, i8** %4
+	%5 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 0, i64* %5
+	%6 = getelementptr inbounds %array, %array* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	store i64 -9223372036854775808, i64* %6 ; no elements, with bit 63 set
+	ret void
+}
+
+; Frees the elements of an array, leaving it empty. Buffers allocated from an arena are left for
+; the arena to release.
+define void @array_SEP___del__(%array* %self) nounwind {
+	%1 = getelementptr inbounds %array, %array* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	%2 = load i64, i64* %1
+	%3 = icmp slt i64 %2, 0 ; bit 63 set
+	br i1 %3, label %done, label %heap
+
+heap:
+	%4 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	%5 = load i8*, i8** %4
+	call void @free(i8* %5)
+	br label %done
+
+done:
+	call void @array___init_empty(%array* %self)
+	ret void
+}
+
+; Gets the number of elements of an array.
+define i64 @array_SEP_length(%array* %self) alwaysinline nounwind {
+	%1 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	%2 = load i64, i64* %1
+	ret i64 %2
+}
+
+; Makes sure an array can hold some number of elements, at least doubling its capacity when it has
+; to grow so appending is amortised O(1).
+define void @array_SEP_reserve(%array* %self, i64 %needed, i64 %size) nounwind {
+	%1 = getelementptr inbounds %array, %array* %self, i64 0, i32 2 ; get pointer to 'capacity'
+	%2 = load i64, i64* %1
+	%3 = and i64 %2, 9223372036854775807 ; clear bit 63
+	%4 = icmp ule i64 %needed, %3
+	br i1 %4, label %done, label %grow
+
+grow:
+	%5 = shl i64 %3, 1
+	%6 = icmp ugt i64 %5, 8
+	%7 = select i1 %6, i64 %5, i64 8 ; start at 8 elements
+	%8 = icmp ugt i64 %needed, %7
+	%9 = select i1 %8, i64 %needed, i64 %7 ; the new capacity
+	%10 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	%11 = load i8*, i8** %10
+	%bytes = call { i64, i1 } @llvm.umul.with.overflow.i64(i64 %9, i64 %size)
+	%12 = extractvalue { i64, i1 } %bytes, 0
+	%overflow = extractvalue { i64, i1 } %bytes, 1
+	br i1 %overflow, label %too_large, label %allocate, !prof !1
+
+allocate:
+	%13 = icmp slt i64 %2, 0 ; bit 63 set, in an arena
+	br i1 %13, label %arena, label %heap
+
+heap:
+	%grown = call i8* @realloc(i8* %11, i64 %12)
+	%14 = call i8* @panic___check_allocation(i8* %grown, i64 %12)
+	store i8* %14, i8** %10
+	store i64 %9, i64* %1
+	br label %done
+
+arena:
+	%15 = call i8* @mem___resize(i8* %11, i64 %12)
+	store i8* %15, i8** %10
+	%16 = or i64 %9, -9223372036854775808 ; set bit 63
+	store i64 %16, i64* %1
+	br label %done
+
+too_large: ; more bytes than there are addresses
+	call void @panic___out_of_memory(i64 -1)
+	unreachable
+
+done:
+	ret void
+}
+
+; Appends a copy of an element to an array. It must not be an element of the array itself.
+define void @array_SEP_append(%array* %self, i8* %element, i64 %size) nounwind {
+	%1 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	%2 = load i64, i64* %1
+	%3 = add nuw i64 %2, 1
+	call void @array_SEP_reserve(%array* %self, i64 %3, i64 %size)
+	%4 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	%5 = load i8*, i8** %4
+	%6 = mul i64 %2, %size
+	%7 = getelementptr inbounds i8, i8* %5, i64 %6
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %7, i8* %element, i64 %size, i1 false)
+	store i64 %3, i64* %1
+	ret void
+}
+
+; Initialises an array with copies of another array's elements, e.g. for 'lines.clone()'. Elements
+; owning buffers are initialised with 'clone' (e.g. '@str_SEP_clone' for 'Array<str>'), the others
+; are copied byte for byte when it is null.
+define void @array_SEP_clone(%array* %self, %array* %other, i64 %size, void (i8*, i8*)* %clone) nounwind {
+entry:
+	call void @array_SEP___init__(%array* %self)
+	%0 = getelementptr inbounds %array, %array* %other, i64 0, i32 1 ; get pointer to 'length'
+	%1 = load i64, i64* %0
+	%2 = icmp eq i64 %1, 0
+	br i1 %2, label %done, label %reserve
+
+reserve:
+	call void @array_SEP_reserve(%array* %self, i64 %1, i64 %size)
+	%3 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	%4 = load i8*, i8** %3
+	%5 = getelementptr inbounds %array, %array* %other, i64 0, i32 0 ; get pointer to '_data'
+	%6 = load i8*, i8** %5
+	%7 = icmp eq void (i8*, i8*)* %clone, null
+	br i1 %7, label %bytes, label %elements
+
+bytes:
+	%8 = mul i64 %1, %size
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %4, i8* %6, i64 %8, i1 false)
+	br label %length
+
+elements:
+	%index = phi i64 [ 0, %reserve ], [ %nextIndex, %elements ]
+	%offset = mul i64 %index, %size
+	%element = getelementptr inbounds i8, i8* %4, i64 %offset
+	%source = getelementptr inbounds i8, i8* %6, i64 %offset
+	call void %clone(i8* %element, i8* %source)
+	%nextIndex = add nuw i64 %index, 1
+	%more = icmp ult i64 %nextIndex, %1
+	br i1 %more, label %elements, label %length
+
+length:
+	%9 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	store i64 %1, i64* %9
+	br label %done
+
+done:
+	ret void
+}
+
+; Gets a pointer to an element of an array, aborting if the index is out of bounds. Accesses the
+; compiler proves are in bounds index '_data' directly instead.
+define i8* @array_SEP_get(%array* %self, i64 %index, i64 %size) alwaysinline nounwind {
+	%1 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	%2 = load i64, i64* %1
+	%3 = icmp ult i64 %index, %2 ; also rejects negative indexes
+	br i1 %3, label %in_bounds, label %out_of_bounds, !prof !0
+
+in_bounds:
+	%4 = getelementptr inbounds %array, %array* %self, i64 0, i32 0 ; get pointer to '_data'
+	%5 = load i8*, i8** %4
+	%6 = mul i64 %index, %size
+	%7 = getelementptr inbounds i8, i8* %5, i64 %6
+	ret i8* %7
+
+out_of_bounds:
+	call void @array___out_of_bounds(i64 %index, i64 %2)
+	unreachable
+}
+
+; Removes an element of an array, moving the elements after it down. Removing the last element is
+; O(1), and the buffer is kept for the next append.
+define void @array_SEP_remove(%array* %self, i64 %index, i64 %size) nounwind {
+	%1 = call i8* @array_SEP_get(%array* %self, i64 %index, i64 %size)
+	%2 = getelementptr inbounds %array, %array* %self, i64 0, i32 1 ; get pointer to 'length'
+	%3 = load i64, i64* %2
+	%4 = sub nuw i64 %3, 1
+	store i64 %4, i64* %2
+	%5 = icmp eq i64 %index, %4
+	br i1 %5, label %done, label %move
+
+move:
+	%6 = getelementptr inbounds i8, i8* %1, i64 %size
+	%7 = sub nuw i64 %4, %index
+	%8 = mul i64 %7, %size
+	call void @llvm.memmove.p0i8.p0i8.i64(i8* %1, i8* %6, i64 %8, i1 false)
+	br label %done
+
+done:
+	ret void
+}
+
+!0 = !{!"branch_weights", i32 2000, i32 1}
+!1 = !{!"branch_weights", i32 1, i32 2000}
+
+; Arenas ('mem::Arena') hand out memory by bumping a pointer through chunks, each at least twice the
+; size of the one before, so allocating is a compare and an add, and n bytes take O(log n) chunks.
+; Nothing is freed on its own: everything allocated from an arena is released at once. The newest
+; chunk of a released arena is kept as the thread's spare, so arenas created over and over (e.g.
+; one per request) stop calling malloc once it is large enough.
+;
+; While an arena is the calling thread's default allocator ('mem::Arena.enter'), the arrays and
+; strings initialised on the thread take their buffers from it, for as long as they live. Such a
+; buffer follows a header naming its arena, so it grows in place while it is the arena's newest
+; allocation and is copied within the arena otherwise, and '__del__' leaves it to the arena. The
+; compiler's '@arena' blocks enter a new arena for their duration, and reject the values that could
+; outlive it.
+%mem.arena = type {
+	i8*,            ; 0: chunk - the newest chunk, null until the first allocation
+	i8*,            ; 1: next - where the next allocation goes
+	i8*,            ; 2: end - the end of the newest chunk
+	%mem.arena*     ; 3: outer - the default allocator before the arena was entered
+}
+
+%mem.chunk = type {
+	i8*,            ; 0: previous - the chunk allocated before, null for the first
+	i64             ; 1: size - bytes of the chunk, with this header
+}
+
+%mem.header = type {
+	%mem.arena*,    ; 0: arena - the arena the buffer was allocated from
+	i64             ; 1: size - bytes of the buffer, after this header
+}
+
+@mem___default = internal thread_local global %mem.arena* null ; where arrays and strings allocate, null for the heap
+@mem___spare = internal thread_local global i8* null ; the chunk kept from the last arena released
+
+; Gives an arena a new chunk with room for some bytes, twice the size of its newest chunk or 16 KiB
+; for the first. The thread's spare chunk is used when it is large enough.
+define private void @mem___add_chunk(%mem.arena* %self, i64 %bytes) noinline nounwind {
+entry:
+	%chunk = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 0 ; get pointer to 'chunk'
+	%newest = load i8*, i8** %chunk
+	%first = icmp eq i8* %newest, null
+	br i1 %first, label %size, label %double
+
+double:
+	%0 = bitcast i8* %newest to %mem.chunk*
+	%1 = getelementptr inbounds %mem.chunk, %mem.chunk* %0, i64 0, i32 1 ; get pointer to 'size'
+	%2 = load i64, i64* %1
+	%3 = shl i64 %2, 1
+	br label %size
+
+size:
+	%doubled = phi i64 [ 16384, %entry ], [ %3, %double ]
+	%4 = add i64 %bytes, 16 ; with the header
+	%5 = icmp ugt i64 %4, %doubled
+	%wanted = select i1 %5, i64 %4, i64 %doubled
+	%spare = load i8*, i8** @mem___spare
+	%6 = icmp eq i8* %spare, null
+	br i1 %6, label %allocate, label %check
+
+check:
+	%7 = bitcast i8* %spare to %mem.chunk*
+	%8 = getelementptr inbounds %mem.chunk, %mem.chunk* %7, i64 0, i32 1 ; get pointer to 'size'
+	%9 = load i64, i64* %8
+	%10 = icmp uge i64 %9, %wanted
+	br i1 %10, label %reuse, label %allocate
+
+reuse:
+	store i8* null, i8** @mem___spare
+	br label %link
+
+allocate:
+	%memory = call i8* @malloc(i64 %wanted)
+	%11 = call i8* @panic___check_allocation(i8* %memory, i64 %wanted)
+	%12 = bitcast i8* %11 to %mem.chunk*
+	%13 = getelementptr inbounds %mem.chunk, %mem.chunk* %12, i64 0, i32 1 ; get pointer to 'size'
+	store i64 %wanted, i64* %13
+	br label %link
+
+link:
+	%new = phi i8* [ %spare, %reuse ], [ %11, %allocate ]
+	%14 = bitcast i8* %new to %mem.chunk*
+	%15 = getelementptr inbounds %mem.chunk, %mem.chunk* %14, i64 0, i32 0 ; get pointer to 'previous'
+	store i8* %newest, i8** %15
+	%16 = getelementptr inbounds %mem.chunk, %mem.chunk* %14, i64 0, i32 1 ; get pointer to 'size'
+	%17 = load i64, i64* %16
+	store i8* %new, i8** %chunk
+	%18 = getelementptr inbounds i8, i8* %new, i64 16 ; after the header
+	%19 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 1 ; get pointer to 'next'
+	store i8* %18, i8** %19
+	%20 = getelementptr inbounds i8, i8* %new, i64 %17
+	%21 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 2 ; get pointer to 'end'
+	store i8* %20, i8** %21
+	ret void
+}
+
+; Frees the chunks older than an arena's newest one.
+define private void @mem___free_older(i8* %newest) nounwind {
+entry:
+	%0 = bitcast i8* %newest to %mem.chunk*
+	%1 = getelementptr inbounds %mem.chunk, %mem.chunk* %0, i64 0, i32 0 ; get pointer to 'previous'
+	%oldest = load i8*, i8** %1
+	store i8* null, i8** %1
+	br label %check
+
+check:
+	%chunk = phi i8* [ %oldest, %entry ], [ %previous, %free ]
+	%2 = icmp eq i8* %chunk, null
+	br i1 %2, label %done, label %free
+
+free:
+	%3 = bitcast i8* %chunk to %mem.chunk*
+	%4 = getelementptr inbounds %mem.chunk, %mem.chunk* %3, i64 0, i32 0 ; get pointer to 'previous'
+	%previous = load i8*, i8** %4
+	call void @free(i8* %chunk)
+	br label %check
+
+done:
+	ret void
+}
+
+; Initialises an empty arena, which does not allocate until its first allocation.
+define void @mem_SEP_Arena___init__(%mem.arena* %self) nounwind {
+	store %mem.arena zeroinitializer, %mem.arena* %self
+	ret void
+}
+
+; Allocates some bytes from an arena, aligned to 16 bytes. They live until the arena is reset or
+; released.
+define noalias i8* @mem_SEP_Arena_SEP_alloc(%mem.arena* %self, i64 %bytes) nounwind {
+entry:
+	%0 = add i64 %bytes, 15
+	%rounded = and i64 %0, -16
+	%next = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 1 ; get pointer to 'next'
+	%1 = load i8*, i8** %next
+	%2 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 2 ; get pointer to 'end'
+	%3 = load i8*, i8** %2
+	%4 = ptrtoint i8* %1 to i64
+	%5 = ptrtoint i8* %3 to i64
+	%6 = sub i64 %5, %4 ; bytes left in the newest chunk
+	%7 = icmp ule i64 %rounded, %6
+	br i1 %7, label %bump, label %grow
+
+grow:
+	call void @mem___add_chunk(%mem.arena* %self, i64 %rounded)
+	%8 = load i8*, i8** %next
+	br label %bump
+
+bump:
+	%9 = phi i8* [ %1, %entry ], [ %8, %grow ]
+	%10 = getelementptr inbounds i8, i8* %9, i64 %rounded
+	store i8* %10, i8** %next
+	ret i8* %9
+}
+
+; Releases everything allocated from an arena, keeping its newest (and largest) chunk for what is
+; allocated next.
+define void @mem_SEP_Arena_SEP_reset(%mem.arena* %self) nounwind {
+	%1 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 0 ; get pointer to 'chunk'
+	%2 = load i8*, i8** %1
+	%3 = icmp eq i8* %2, null
+	br i1 %3, label %done, label %rewind
+
+rewind:
+	call void @mem___free_older(i8* %2)
+	%4 = getelementptr inbounds i8, i8* %2, i64 16 ; after the header
+	%5 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 1 ; get pointer to 'next'
+	store i8* %4, i8** %5
+	br label %done
+
+done:
+	ret void
+}
+
+; Releases everything allocated from an arena, and its chunks, leaving it empty. The newest chunk
+; becomes the thread's spare if it is larger than the spare.
+define void @mem_SEP_Arena___del__(%mem.arena* %self) nounwind {
+	%1 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 0 ; get pointer to 'chunk'
+	%2 = load i8*, i8** %1
+	%3 = icmp eq i8* %2, null
+	br i1 %3, label %done, label %release
+
+release:
+	call void @mem___free_older(i8* %2)
+	%4 = load i8*, i8** @mem___spare
+	%5 = icmp eq i8* %4, null
+	br i1 %5, label %keep, label %compare
+
+compare:
+	%6 = bitcast i8* %2 to %mem.chunk*
+	%7 = getelementptr inbounds %mem.chunk, %mem.chunk* %6, i64 0, i32 1 ; get pointer to 'size'
+	%8 = load i64, i64* %7
+	%9 = bitcast i8* %4 to %mem.chunk*
+	%10 = getelementptr inbounds %mem.chunk, %mem.chunk* %9, i64 0, i32 1 ; get pointer to 'size'
+	%11 = load i64, i64* %10
+	%12 = icmp ugt i64 %8, %11
+	br i1 %12, label %replace, label %drop
+
+replace:
+	call void @free(i8* %4)
+	br label %keep
+
+keep:
+	store i8* %2, i8** @mem___spare
+	br label %done
+
+drop:
+	call void @free(i8* %2)
+	br label %done
+
+done:
+	call void @mem_SEP_Arena___init__(%mem.arena* %self)
+	ret void
+}
+
+; Makes an arena the calling thread's default allocator, until it leaves. Arenas entered while
+; another is the default must leave first.
+define void @mem_SEP_Arena_SEP_enter(%mem.arena* %self) nounwind {
+	%1 = load %mem.arena*, %mem.arena** @mem___default
+	%2 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 3 ; get pointer to 'outer'
+	store %mem.arena* %1, %mem.arena** %2
+	store %mem.arena* %self, %mem.arena** @mem___default
+	ret void
+}
+
+; Makes the default allocator from before an arena was entered the default again.
+define void @mem_SEP_Arena_SEP_leave(%mem.arena* %self) nounwind {
+	%1 = getelementptr inbounds %mem.arena, %mem.arena* %self, i64 0, i32 3 ; get pointer to 'outer'
+	%2 = load %mem.arena*, %mem.arena** %1
+	store %mem.arena* %2, %mem.arena** @mem___default
+	ret void
+}
+
+; Allocates a buffer of some bytes from an arena, after a header naming the arena.
+define private i8* @mem___place(%mem.arena* %arena, i64 %bytes) nounwind {
+	%1 = add i64 %bytes, 16 ; with the header
+	%2 = call i8* @mem_SEP_Arena_SEP_alloc(%mem.arena* %arena, i64 %1)
+	%3 = bitcast i8* %2 to %mem.header*
+	%4 = getelementptr inbounds %mem.header, %mem.header* %3, i64 0, i32 0 ; get pointer to 'arena'
+	store %mem.arena* %arena, %mem.arena** %4
+	%5 = getelementptr inbounds %mem.header, %mem.header* %3, i64 0, i32 1 ; get pointer to 'size'
+	store i64 %bytes, i64* %5
+	%6 = getelementptr inbounds i8, i8* %2, i64 16
+	ret i8* %6
+}
+
+; Grows a buffer allocated from an arena to some bytes. The arena's newest allocation grows in place
+; while its chunk has room, others are copied to a new buffer of the arena.
+define private i8* @mem___resize(i8* %buffer, i64 %bytes) nounwind {
+entry:
+	%0 = getelementptr inbounds i8, i8* %buffer, i64 -16
+	%header = bitcast i8* %0 to %mem.header*
+	%1 = getelementptr inbounds %mem.header, %mem.header* %header, i64 0, i32 0 ; get pointer to 'arena'
+	%arena = load %mem.arena*, %mem.arena** %1
+	%size = getelementptr inbounds %mem.header, %mem.header* %header, i64 0, i32 1 ; get pointer to 'size'
+	%2 = load i64, i64* %size
+	%3 = add i64 %2, 15
+	%4 = and i64 %3, -16
+	%5 = getelementptr inbounds i8, i8* %buffer, i64 %4 ; the end of the buffer
+	%next = getelementptr inbounds %mem.arena, %mem.arena* %arena, i64 0, i32 1 ; get pointer to 'next'
+	%6 = load i8*, i8** %next
+	%7 = icmp eq i8* %5, %6
+	br i1 %7, label %newest, label %move
+
+newest:
+	%8 = add i64 %bytes, 15
+	%9 = and i64 %8, -16
+	%10 = getelementptr inbounds i8, i8* %buffer, i64 %9
+	%11 = getelementptr inbounds %mem.arena, %mem.arena* %arena, i64 0, i32 2 ; get pointer to 'end'
+	%12 = load i8*, i8** %11
+	%13 = icmp ule i8* %10, %12
+	br i1 %13, label %extend, label %move
+
+extend:
+	store i8* %10, i8** %next
+	store i64 %bytes, i64* %size
+	ret i8* %buffer
+
+move:
+	%14 = call i8* @mem___place(%mem.arena* %arena, i64 %bytes)
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %14, i8* %buffer, i64 %2, i1 false) ; buffers only grow
+	ret i8* %14
+}
+
+; Output is collected in a buffer per thread and written with as few system calls as possible. The
+; buffer is flushed when it is full, after every line if stdout is a terminal, when the thread or
+; the program exits, and by 'io::flush()'. Chunks at least as large as the buffer are written
+; together with the buffered output in a single 'writev', without being copied.
+%iovec = type {
+	i8*,    ; 0: iov_base - pointer to the bytes
+	i64     ; 1: iov_len - number of bytes
+}
+
+declare i64 @write(i32, i8*, i64)
+declare i64 @writev(i32, %iovec*, i32)
+declare i32 @isatty(i32) nounwind
+declare i32 @atexit(void ()*) nounwind
+declare i32 @pthread_once(i32*, void ()*) nounwind
+declare i32 @pthread_key_create(i32*, void (i8*)*) nounwind
+declare i32 @pthread_setspecific(i32, i8*) nounwind
+declare i32 @snprintf(i8*, i64, i8*, ...) nounwind
+
+@io___buffer = internal thread_local global [8192 x i8] zeroinitializer
+@io___length = internal thread_local global i64 0
+@io___registered = internal thread_local global i1 false ; whether the thread flushes on exit
+@io___tty = internal global i8 0 ; 0: unknown, 1: stdout is not a terminal, 2: it is
+@io___once = internal global i32 0 ; pthread_once_t
+@io___key = internal global i32 0 ; pthread_key_t, whose destructor flushes exiting threads
+@io___float = private unnamed_addr constant [5 x i8] c"%.*g\00"
+
+; Writes all of some bytes to stdout, giving up on errors as there is nowhere to report them.
+define private void @io___write_all(i8* %bytes, i64 %length) nounwind {
+entry:
+	br label %check
+
+check:
+	%rest = phi i64 [ %length, %entry ], [ %left, %write ]
+	%cursor = phi i8* [ %bytes, %entry ], [ %next, %write ]
+	%more = icmp sgt i64 %rest, 0
+	br i1 %more, label %write, label %done
+
+write:
+	%written = call i64 @write(i32 1, i8* %cursor, i64 %rest)
+	%failed = icmp sle i64 %written, 0
+	%left = sub i64 %rest, %written
+	%next = getelementptr inbounds i8, i8* %cursor, i64 %written
+	br i1 %failed, label %done, label %check
+
+done:
+	ret void
+}
+
+; Flushes the calling thread's buffer.
+define void @io_SEP_flush() nounwind {
+	%1 = load i64, i64* @io___length
+	%2 = getelementptr inbounds [8192 x i8], [8192 x i8]* @io___buffer, i64 0, i64 0
+	call void @io___write_all(i8* %2, i64 %1)
+	store i64 0, i64* @io___length
+	ret void
+}
+
+; Flushes the buffer of a thread that is exiting.
+define private void @io___flush_thread(i8* %value) nounwind {
+	call void @io_SEP_flush()
+	ret void
+}
+
+; Creates the key flushing exiting threads, and flushes the main thread when the program exits.
+define private void @io___init() nounwind {
+	%1 = call i32 @pthread_key_create(i32* @io___key, void (i8*)* @io___flush_thread)
+	%2 = call i32 @atexit(void ()* @io_SEP_flush)
+	ret void
+}
+
+; Makes sure the calling thread's buffer is flushed when it exits.
+define private void @io___register() nounwind {
+	%1 = load i1, i1* @io___registered
+	br i1 %1, label %done, label %register
+
+register:
+	store i1 true, i1* @io___registered
+	%2 = call i32 @pthread_once(i32* @io___once, void ()* @io___init)
+	%3 = load i32, i32* @io___key
+	%4 = call i32 @pthread_setspecific(i32 %3, i8* inttoptr (i64 1 to i8*)) ; non-null, so it runs
+	br label %done
+
+done:
+	ret void
+}
+
+; Writes some bytes to stdout through the calling thread's buffer.
+define void @io_SEP_write(i8* %bytes, i64 %length) nounwind {
+entry:
+	call void @io___register()
+	%buffered = load i64, i64* @io___length
+	%buffer = getelementptr inbounds [8192 x i8], [8192 x i8]* @io___buffer, i64 0, i64 0
+	%free = sub i64 8192, %buffered
+	%fits = icmp ule i64 %length, %free
+	br i1 %fits, label %copy, label %full
+
+full:
+	%large = icmp uge i64 %length, 8192
+	br i1 %large, label %vector, label %flush
+
+flush:
+	call void @io_SEP_flush()
+	br label %copy
+
+copy:
+	%offset = phi i64 [ %buffered, %entry ], [ 0, %flush ]
+	%end = getelementptr inbounds i8, i8* %buffer, i64 %offset
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %end, i8* %bytes, i64 %length, i1 false)
+	%total = add i64 %offset, %length
+	store i64 %total, i64* @io___length
+	ret void
+
+vector: ; writev(1, { buffer, bytes }, 2), then whatever it did not write
+	%vectors = alloca [2 x %iovec]
+	%0 = getelementptr inbounds [2 x %iovec], [2 x %iovec]* %vectors, i64 0, i64 0, i32 0
+	store i8* %buffer, i8** %0
+	%1 = getelementptr inbounds [2 x %iovec], [2 x %iovec]* %vectors, i64 0, i64 0, i32 1
+	store i64 %buffered, i64* %1
+	%2 = getelementptr inbounds [2 x %iovec], [2 x %iovec]* %vectors, i64 0, i64 1, i32 0
+	store i8* %bytes, i8** %2
+	%3 = getelementptr inbounds [2 x %iovec], [2 x %iovec]* %vectors, i64 0, i64 1, i32 1
+	store i64 %length, i64* %3
+	%4 = getelementptr inbounds [2 x %iovec], [2 x %iovec]* %vectors, i64 0, i64 0
+	%5 = call i64 @writev(i32 1, %iovec* %4, i32 2)
+	%6 = icmp slt i64 %5, 0
+	%7 = select i1 %6, i64 0, i64 %5 ; retry everything with write on errors
+	store i64 0, i64* @io___length
+	%8 = icmp ult i64 %7, %buffered
+	br i1 %8, label %vector_buffer, label %vector_bytes
+
+vector_buffer:
+	%9 = getelementptr inbounds i8, i8* %buffer, i64 %7
+	%10 = sub i64 %buffered, %7
+	call void @io___write_all(i8* %9, i64 %10)
+	call void @io___write_all(i8* %bytes, i64 %length)
+	ret void
+
+vector_bytes:
+	%11 = sub i64 %7, %buffered
+	%12 = getelementptr inbounds i8, i8* %bytes, i64 %11
+	%13 = sub i64 %length, %11
+	call void @io___write_all(i8* %12, i64 %13)
+	ret void
+}
+
+; Ends a line of output, flushing it if stdout is a terminal so it is seen straight away.
+define private void @io___end_line() nounwind {
+	%1 = alloca i8
+	store i8 10, i8* %1 ; '\n'
+	call void @io_SEP_write(i8* %1, i64 1)
+	%2 = load atomic i8, i8* @io___tty monotonic, align 1
+	%3 = icmp eq i8 %2, 0
+	br i1 %3, label %check, label %known
+
+check:
+	%4 = call i32 @isatty(i32 1)
+	%5 = icmp ne i32 %4, 0
+	%6 = select i1 %5, i8 2, i8 1
+	store atomic i8 %6, i8* @io___tty monotonic, align 1
+	br label %known
+
+known:
+	%7 = phi i8 [ %2, %0 ], [ %6, %check ]
+	%8 = icmp eq i8 %7, 2
+	br i1 %8, label %flush, label %done
+
+flush:
+	call void @io_SEP_flush()
+	br label %done
+
+done:
+	ret void
+}
+
+; Writes a string and a newline to stdout.
+define void @io_SEP_out(%str* %value) nounwind {
+	%1 = call i8* @str_SEP_data(%str* %value)
+	%2 = call i64 @str_SEP_length(%str* %value)
+	call void @io_SEP_write(i8* %1, i64 %2)
+	call void @io___end_line()
+	ret void
+}
+
+; Writes a signed integer and a newline to stdout. Narrower integers are sign extended by the
+; caller.
+define void @io_SEP_out_i64(i64 %value) nounwind {
+	%1 = alloca %str
+	call void @str___init_inline(%str* %1) ; the digits fit inline, so there is nothing to free
+	call void @str_SEP_append_i64(%str* %1, i64 %value)
+	call void @io_SEP_out(%str* %1)
+	ret void
+}
+
+; Writes an unsigned integer and a newline to stdout. Narrower integers are zero extended by the
+; caller.
+define void @io_SEP_out_u64(i64 %value) nounwind {
+	%1 = alloca %str
+	call void @str___init_inline(%str* %1) ; the digits fit inline, so there is nothing to free
+	call void @str_SEP_append_u64(%str* %1, i64 %value)
+	call void @io_SEP_out(%str* %1)
+	ret void
+}
+
+; Writes a float and a newline to stdout, with as many significant digits as its type always keeps,
+; so '0.1' is written as '0.1'.
+define private void @io___out_float(double %value, i32 %digits) nounwind {
+	%1 = alloca [32 x i8] ; '-1.79769313486232e+308' has 22 characters
+	%2 = getelementptr inbounds [32 x i8], [32 x i8]* %1, i64 0, i64 0
+	%3 = getelementptr inbounds [5 x i8], [5 x i8]* @io___float, i64 0, i64 0
+	%4 = call i32 (i8*, i64, i8*, ...) @snprintf(i8* %2, i64 32, i8* %3, i32 %digits, double %value)
+	%5 = sext i32 %4 to i64
+	call void @io_SEP_write(i8* %2, i64 %5)
+	call void @io___end_line()
+	ret void
+}
+
+; Writes a double and a newline to stdout.
+define void @io_SEP_out_f64(double %value) nounwind {
+	call void @io___out_float(double %value, i32 15)
+	ret void
+}
+
+; Writes a float and a newline to stdout.
+define void @io_SEP_out_f32(float %value) nounwind {
+	%1 = fpext float %value to double
+	call void @io___out_float(double %1, i32 6)
+	ret void
+}
+
+; Async functions are coroutines, which LLVM splits into a frame holding the values live across
+; suspensions, and functions resuming and destroying it. A task waiting for I/O costs its frame,
+; usually a few dozen bytes, instead of a thread's stack. Calling an async function runs it until
+; it first has to wait and returns its handle. Its promise, at a fixed place in the frame, holds the
+; handle of the task awaiting it (null while there is none, -1 once detached by 'io::spawn'),
+; followed by its result.
+;
+; The event loop runs on the thread calling 'io::run()', so tasks never need to lock. Tasks ready
+; to continue are resumed in the order they were woken. The others wait for a file descriptor,
+; watched with 'poll', or for a timer, kept in a binary heap by deadline. A task awaiting another
+; is woken once the other completes, then reads its result and destroys it. Detached tasks are
+; destroyed by the loop once they complete.
+%io.poll = type {
+	i32,    ; 0: fd - file descriptor watched
+	i16,    ; 1: events - POLLIN (1) or POLLOUT (4)
+	i16     ; 2: revents - events that happened, set by 'poll'
+}
+
+%io.timer = type {
+	i64,    ; 0: deadline - CLOCK_MONOTONIC time to wake at, in milliseconds
+	i8*     ; 1: task - handle of the task to wake
+}
+
+%timespec = type {
+	i64,    ; 0: tv_sec - seconds
+	i64     ; 1: tv_nsec - nanoseconds
+}
+
+declare i32 @poll(%io.poll*, i64, i32)
+declare i32 @clock_gettime(i32, %timespec*) nounwind
+declare token @llvm.coro.id(i32, i8*, i8*, i8*)
+declare i1 @llvm.coro.alloc(token)
+declare i64 @llvm.coro.size.i64()
+declare i8* @llvm.coro.begin(token, i8*)
+declare i8 @llvm.coro.suspend(token, i1)
+declare i8* @llvm.coro.free(token, i8*)
+declare i1 @llvm.coro.end(i8*, i1)
+declare void @llvm.coro.resume(i8*)
+declare void @llvm.coro.destroy(i8*)
+declare i1 @llvm.coro.done(i8*)
+declare i8* @llvm.coro.promise(i8*, i32, i1)
+
+@io___ready = internal thread_local global %array zeroinitializer ; Array<i8*> of tasks to resume
+@io___finished = internal thread_local global %array zeroinitializer ; Array<i8*> to destroy
+@io___polls = internal thread_local global %array zeroinitializer ; Array<%io.poll>
+@io___pollers = internal thread_local global %array zeroinitializer ; Array<i8*>, by poll
+@io___timers = internal thread_local global %array zeroinitializer ; Array<%io.timer>, a heap
+
+; Gets the CLOCK_MONOTONIC time, in milliseconds.
+define private i64 @io___now() nounwind {
+	%1 = alloca %timespec
+	%2 = call i32 @clock_gettime(i32 1, %timespec* %1) ; CLOCK_MONOTONIC
+	%3 = getelementptr inbounds %timespec, %timespec* %1, i64 0, i32 0 ; get pointer to 'tv_sec'
+	%4 = load i64, i64* %3
+	%5 = getelementptr inbounds %timespec, %timespec* %1, i64 0, i32 1 ; get pointer to 'tv_nsec'
+	%6 = load i64, i64* %5
+	%7 = mul i64 %4, 1000
+	%8 = sdiv i64 %6, 1000000
+	%9 = add i64 %7, %8
+	ret i64 %9
+}
+
+; Appends a task to an array of tasks.
+define private void @io___append(%array* %tasks, i8* %task) nounwind {
+	%1 = alloca i8*
+	store i8* %task, i8** %1
+	%2 = bitcast i8** %1 to i8*
+	call void @array_SEP_append(%array* %tasks, i8* %2, i64 8)
+	ret void
+}
+
+; Gets the promise of a task, starting with the handle of the task awaiting it.
+define private i8** @io___waiter(i8* %task) alwaysinline nounwind {
+	%1 = call i8* @llvm.coro.promise(i8* %task, i32 8, i1 false)
+	%2 = bitcast i8* %1 to i8**
+	ret i8** %2
+}
+
+; Wakes a task, which the loop resumes once the tasks woken before it have run.
+define void @io_SEP_wake(i8* %task) nounwind {
+	call void @io___append(%array* @io___ready, i8* %task)
+	ret void
+}
+
+; Called by a task as it completes, before its final suspension: wakes the task awaiting it, or
+; has the loop destroy it if it was detached.
+define void @io_SEP_complete(i8* %task) nounwind {
+entry:
+	%0 = call i8** @io___waiter(i8* %task)
+	%waiter = load i8*, i8** %0
+	%detached = icmp eq i8* %waiter, inttoptr (i64 -1 to i8*)
+	br i1 %detached, label %finish, label %check
+
+finish:
+	call void @io___append(%array* @io___finished, i8* %task)
+	ret void
+
+check:
+	%awaited = icmp ne i8* %waiter, null
+	br i1 %awaited, label %wake, label %done
+
+wake:
+	call void @io_SEP_wake(i8* %waiter)
+	br label %done
+
+done:
+	ret void
+}
+
+; Detaches a task, which runs on without anything awaiting it. It is destroyed as soon as it is
+; complete.
+define void @io_SEP_spawn(i8* %task) nounwind {
+	%1 = call i1 @llvm.coro.done(i8* %task)
+	br i1 %1, label %destroy, label %detach
+
+destroy:
+	call void @llvm.coro.destroy(i8* %task)
+	ret void
+
+detach:
+	%2 = call i8** @io___waiter(i8* %task)
+	store i8* inttoptr (i64 -1 to i8*), i8** %2
+	ret void
+}
+
+; Destroys the detached tasks that have completed.
+define private void @io___reap() nounwind {
+entry:
+	%length = getelementptr inbounds %array, %array* @io___finished, i64 0, i32 1 ; get pointer to 'length'
+	%count = load i64, i64* %length
+	%data = getelementptr inbounds %array, %array* @io___finished, i64 0, i32 0 ; get pointer to '_data'
+	%0 = load i8*, i8** %data
+	%tasks = bitcast i8* %0 to i8**
+	br label %check
+
+check:
+	%index = phi i64 [ 0, %entry ], [ %next, %destroy ]
+	%more = icmp ult i64 %index, %count
+	br i1 %more, label %destroy, label %done
+
+destroy:
+	%1 = getelementptr inbounds i8*, i8** %tasks, i64 %index
+	%2 = load i8*, i8** %1
+	call void @llvm.coro.destroy(i8* %2)
+	%next = add nuw i64 %index, 1
+	br label %check
+
+done:
+	store i64 0, i64* %length
+	ret void
+}
+
+; Gets a pointer to a timer of the heap.
+define private %io.timer* @io___timer(i64 %index) alwaysinline nounwind {
+	%1 = getelementptr inbounds %array, %array* @io___timers, i64 0, i32 0 ; get pointer to '_data'
+	%2 = load i8*, i8** %1
+	%3 = bitcast i8* %2 to %io.timer*
+	%4 = getelementptr inbounds %io.timer, %io.timer* %3, i64 %index
+	ret %io.timer* %4
+}
+
+; Swaps two timers of the heap.
+define private void @io___swap_timers(%io.timer* %a, %io.timer* %b) alwaysinline nounwind {
+	%1 = load %io.timer, %io.timer* %a
+	%2 = load %io.timer, %io.timer* %b
+	store %io.timer %2, %io.timer* %a
+	store %io.timer %1, %io.timer* %b
+	ret void
+}
+
+; Wakes a task once some milliseconds have passed, moving the timer up the heap past the timers
+; with later deadlines.
+define private void @io___add_timer(i64 %milliseconds, i8* %task) nounwind {
+entry:
+	%now = call i64 @io___now()
+	%deadline = add i64 %now, %milliseconds
+	%timer = alloca %io.timer
+	%0 = getelementptr inbounds %io.timer, %io.timer* %timer, i64 0, i32 0 ; get pointer to 'deadline'
+	store i64 %deadline, i64* %0
+	%1 = getelementptr inbounds %io.timer, %io.timer* %timer, i64 0, i32 1 ; get pointer to 'task'
+	store i8* %task, i8** %1
+	%2 = bitcast %io.timer* %timer to i8*
+	call void @array_SEP_append(%array* @io___timers, i8* %2, i64 16)
+	%3 = call i64 @array_SEP_length(%array* @io___timers)
+	%last = sub nuw i64 %3, 1
+	br label %check
+
+check:
+	%index = phi i64 [ %last, %entry ], [ %parent, %swap ]
+	%root = icmp eq i64 %index, 0
+	br i1 %root, label %done, label %compare
+
+compare:
+	%4 = sub nuw i64 %index, 1
+	%parent = lshr i64 %4, 1
+	%child = call %io.timer* @io___timer(i64 %index)
+	%above = call %io.timer* @io___timer(i64 %parent)
+	%5 = getelementptr inbounds %io.timer, %io.timer* %child, i64 0, i32 0 ; get pointer to 'deadline'
+	%6 = load i64, i64* %5
+	%7 = getelementptr inbounds %io.timer, %io.timer* %above, i64 0, i32 0 ; get pointer to 'deadline'
+	%8 = load i64, i64* %7
+	%9 = icmp slt i64 %6, %8
+	br i1 %9, label %swap, label %done
+
+swap:
+	call void @io___swap_timers(%io.timer* %child, %io.timer* %above)
+	br label %check
+
+done:
+	ret void
+}
+
+; Removes the timer with the earliest deadline, moving the last timer into its place and then down
+; the heap past the timers with earlier deadlines.
+define private void @io___pop_timer() nounwind {
+entry:
+	%length = getelementptr inbounds %array, %array* @io___timers, i64 0, i32 1 ; get pointer to 'length'
+	%0 = load i64, i64* %length
+	%count = sub nuw i64 %0, 1
+	store i64 %count, i64* %length
+	%first = call %io.timer* @io___timer(i64 0)
+	%last = call %io.timer* @io___timer(i64 %count)
+	%1 = load %io.timer, %io.timer* %last
+	store %io.timer %1, %io.timer* %first
+	br label %check
+
+check:
+	%index = phi i64 [ 0, %entry ], [ %smallest, %swap ]
+	%2 = shl nuw i64 %index, 1
+	%left = add nuw i64 %2, 1
+	%right = add nuw i64 %2, 2
+	%3 = icmp ult i64 %left, %count
+	br i1 %3, label %children, label %done
+
+children:
+	%current = call %io.timer* @io___timer(i64 %index)
+	%4 = call %io.timer* @io___timer(i64 %left)
+	%5 = getelementptr inbounds %io.timer, %io.timer* %4, i64 0, i32 0 ; get pointer to 'deadline'
+	%6 = load i64, i64* %5
+	%7 = icmp ult i64 %right, %count
+	br i1 %7, label %both, label %compare
+
+both:
+	%8 = call %io.timer* @io___timer(i64 %right)
+	%9 = getelementptr inbounds %io.timer, %io.timer* %8, i64 0, i32 0 ; get pointer to 'deadline'
+	%10 = load i64, i64* %9
+	%11 = icmp slt i64 %10, %6
+	%12 = select i1 %11, i64 %right, i64 %left
+	%13 = select i1 %11, i64 %10, i64 %6
+	br label %compare
+
+compare:
+	%smallest = phi i64 [ %left, %children ], [ %12, %both ]
+	%earliest = phi i64 [ %6, %children ], [ %13, %both ]
+	%14 = getelementptr inbounds %io.timer, %io.timer* %current, i64 0, i32 0 ; get pointer to 'deadline'
+	%15 = load i64, i64* %14
+	%16 = icmp slt i64 %earliest, %15
+	br i1 %16, label %swap, label %done
+
+swap:
+	%17 = call %io.timer* @io___timer(i64 %smallest)
+	call void @io___swap_timers(%io.timer* %current, %io.timer* %17)
+	br label %check
+
+done:
+	ret void
+}
+
+; Wakes a task once a file descriptor is ready for some events, or fails.
+define private void @io___add_poll(i32 %fd, i16 %events, i8* %task) nounwind {
+	%1 = alloca %io.poll
+	%2 = getelementptr inbounds %io.poll, %io.poll* %1, i64 0, i32 0 ; get pointer to 'fd'
+	store i32 %fd, i32* %2
+	%3 = getelementptr inbounds %io.poll, %io.poll* %1, i64 0, i32 1 ; get pointer to 'events'
+	store i16 %events, i16* %3
+	%4 = getelementptr inbounds %io.poll, %io.poll* %1, i64 0, i32 2 ; get pointer to 'revents'
+	store i16 0, i16* %4
+	%5 = bitcast %io.poll* %1 to i8*
+	call void @array_SEP_append(%array* @io___polls, i8* %5, i64 8)
+	call void @io___append(%array* @io___pollers, i8* %task)
+	ret void
+}
+
+; The task awaited by 'io::sleep', 'io::readable' and 'io::writable': registers a timer if 'fd' is
+; negative, or else a poll, then completes once it is woken.
+define private i8* @io___wait(i32 %fd, i16 %events, i64 %milliseconds) nounwind "coroutine.presplit"="0" {
+entry:
+	%promise = alloca i8*, align 8 ; the task awaiting this one
+	store i8* null, i8** %promise
+	%0 = bitcast i8** %promise to i8*
+	%id = call token @llvm.coro.id(i32 8, i8* %0, i8* null, i8* null)
+	%1 = call i1 @llvm.coro.alloc(token %id)
+	br i1 %1, label %allocate, label %begin
+
+allocate:
+	%size = call i64 @llvm.coro.size.i64()
+	%allocated = call i8* @malloc(i64 %size)
+	%memory = call i8* @panic___check_allocation(i8* %allocated, i64 %size)
+	br label %begin
+
+begin:
+	%frame = phi i8* [ null, %entry ], [ %memory, %allocate ]
+	%task = call i8* @llvm.coro.begin(token %id, i8* %frame)
+	%timed = icmp slt i32 %fd, 0
+	br i1 %timed, label %timer, label %watch
+
+timer:
+	call void @io___add_timer(i64 %milliseconds, i8* %task)
+	br label %wait
+
+watch:
+	call void @io___add_poll(i32 %fd, i16 %events, i8* %task)
+	br label %wait
+
+wait:
+	%2 = call i8 @llvm.coro.suspend(token none, i1 false)
+	switch i8 %2, label %suspend [ i8 0, label %complete
+	                               i8 1, label %cleanup ]
+
+complete:
+	call void @io_SEP_complete(i8* %task)
+	%3 = call i8 @llvm.coro.suspend(token none, i1 true)
+	switch i8 %3, label %suspend [ i8 0, label %resumed
+	                               i8 1, label %cleanup ]
+
+resumed: ; complete tasks are never resumed
+	unreachable
+
+cleanup:
+	%4 = call i8* @llvm.coro.free(token %id, i8* %task)
+	call void @free(i8* %4)
+	br label %suspend
+
+suspend:
+	%5 = call i1 @llvm.coro.end(i8* %task, i1 false)
+	ret i8* %task
+}
+
+; Gets a task completing once some milliseconds have passed, 'io::sleep(ms)'.
+define i8* @io_SEP_sleep(i64 %milliseconds) nounwind {
+	%1 = call i8* @io___wait(i32 -1, i16 0, i64 %milliseconds)
+	ret i8* %1
+}
+
+; Gets a task completing once a file descriptor can be read without blocking, 'io::readable(fd)'.
+define i8* @io_SEP_readable(i32 %fd) nounwind {
+	%1 = call i8* @io___wait(i32 %fd, i16 1, i64 0) ; POLLIN
+	ret i8* %1
+}
+
+; Gets a task completing once a file descriptor can be written without blocking,
+; 'io::writable(fd)'.
+define i8* @io_SEP_writable(i32 %fd) nounwind {
+	%1 = call i8* @io___wait(i32 %fd, i16 4, i64 0) ; POLLOUT
+	ret i8* %1
+}
+
+; Wakes the tasks whose file descriptors are ready, removing their polls by moving the last poll
+; into their place.
+define private void @io___wake_polls() nounwind {
+entry:
+	%length = getelementptr inbounds %array, %array* @io___polls, i64 0, i32 1 ; get pointer to 'length'
+	%handles = getelementptr inbounds %array, %array* @io___pollers, i64 0, i32 1 ; get pointer to 'length'
+	%0 = getelementptr inbounds %array, %array* @io___polls, i64 0, i32 0 ; get pointer to '_data'
+	%1 = load i8*, i8** %0
+	%polls = bitcast i8* %1 to %io.poll*
+	%2 = getelementptr inbounds %array, %array* @io___pollers, i64 0, i32 0 ; get pointer to '_data'
+	%3 = load i8*, i8** %2
+	%pollers = bitcast i8* %3 to i8**
+	br label %check
+
+check:
+	%index = phi i64 [ 0, %entry ], [ %index, %remove ], [ %next, %skip ]
+	%count = load i64, i64* %length
+	%more = icmp ult i64 %index, %count
+	br i1 %more, label %test, label %done
+
+test:
+	%poll = getelementptr inbounds %io.poll, %io.poll* %polls, i64 %index
+	%4 = getelementptr inbounds %io.poll, %io.poll* %poll, i64 0, i32 2 ; get pointer to 'revents'
+	%5 = load i16, i16* %4
+	%6 = icmp eq i16 %5, 0
+	br i1 %6, label %skip, label %remove
+
+skip:
+	%next = add nuw i64 %index, 1
+	br label %check
+
+remove:
+	%poller = getelementptr inbounds i8*, i8** %pollers, i64 %index
+	%7 = load i8*, i8** %poller
+	call void @io_SEP_wake(i8* %7)
+	%last = sub nuw i64 %count, 1
+	%8 = getelementptr inbounds %io.poll, %io.poll* %polls, i64 %last
+	%9 = load %io.poll, %io.poll* %8
+	store %io.poll %9, %io.poll* %poll
+	%10 = getelementptr inbounds i8*, i8** %pollers, i64 %last
+	%11 = load i8*, i8** %10
+	store i8* %11, i8** %poller
+	store i64 %last, i64* %length
+	store i64 %last, i64* %handles
+	br label %check
+
+done:
+	ret void
+}
+
+; Wakes the tasks whose timers have expired.
+define private void @io___wake_timers() nounwind {
+entry:
+	%now = call i64 @io___now()
+	br label %check
+
+check:
+	%0 = call i64 @array_SEP_length(%array* @io___timers)
+	%1 = icmp eq i64 %0, 0
+	br i1 %1, label %done, label %test
+
+test:
+	%first = call %io.timer* @io___timer(i64 0)
+	%2 = getelementptr inbounds %io.timer, %io.timer* %first, i64 0, i32 0 ; get pointer to 'deadline'
+	%3 = load i64, i64* %2
+	%4 = icmp sgt i64 %3, %now
+	br i1 %4, label %done, label %wake
+
+wake:
+	%5 = getelementptr inbounds %io.timer, %io.timer* %first, i64 0, i32 1 ; get pointer to 'task'
+	%6 = load i8*, i8** %5
+	call void @io_SEP_wake(i8* %6)
+	call void @io___pop_timer()
+	br label %check
+
+done:
+	ret void
+}
+
+; Runs the event loop until no task is ready or waiting, 'io::run()'. Tasks woken while the ready
+; tasks run are resumed in the same round, and the loop only blocks in 'poll' when none are left.
+define void @io_SEP_run() nounwind {
+entry:
+	%ready = getelementptr inbounds %array, %array* @io___ready, i64 0, i32 1 ; get pointer to 'length'
+	%data = getelementptr inbounds %array, %array* @io___ready, i64 0, i32 0 ; get pointer to '_data'
+	call void @io___reap()
+	br label %round
+
+round:
+	%index = phi i64 [ 0, %entry ], [ %next, %resume ], [ 0, %wake ]
+	%0 = load i64, i64* %ready
+	%1 = icmp ult i64 %index, %0
+	br i1 %1, label %resume, label %idle
+
+resume:
+	%2 = load i8*, i8** %data ; reloaded, as waking tasks may grow the array
+	%3 = bitcast i8* %2 to i8**
+	%4 = getelementptr inbounds i8*, i8** %3, i64 %index
+	%task = load i8*, i8** %4
+	call void @llvm.coro.resume(i8* %task)
+	call void @io___reap()
+	%next = add nuw i64 %index, 1
+	br label %round
+
+idle:
+	store i64 0, i64* %ready
+	%polls = call i64 @array_SEP_length(%array* @io___polls)
+	%timers = call i64 @array_SEP_length(%array* @io___timers)
+	%5 = or i64 %polls, %timers
+	%6 = icmp eq i64 %5, 0
+	br i1 %6, label %done, label %timeout
+
+timeout:
+	%7 = icmp eq i64 %timers, 0
+	br i1 %7, label %wait, label %deadline
+
+deadline:
+	%first = call %io.timer* @io___timer(i64 0)
+	%8 = getelementptr inbounds %io.timer, %io.timer* %first, i64 0, i32 0 ; get pointer to 'deadline'
+	%9 = load i64, i64* %8
+	%now = call i64 @io___now()
+	%10 = sub i64 %9, %now
+	%11 = icmp slt i64 %10, 0
+	%12 = select i1 %11, i64 0, i64 %10
+	%13 = icmp sgt i64 %12, 2147483647
+	%14 = select i1 %13, i64 2147483647, i64 %12
+	%15 = trunc i64 %14 to i32
+	br label %wait
+
+wait:
+	%milliseconds = phi i32 [ -1, %timeout ], [ %15, %deadline ] ; -1 blocks until a poll is ready
+	%16 = getelementptr inbounds %array, %array* @io___polls, i64 0, i32 0 ; get pointer to '_data'
+	%17 = load i8*, i8** %16
+	%18 = bitcast i8* %17 to %io.poll*
+	%19 = call i32 @poll(%io.poll* %18, i64 %polls, i32 %milliseconds)
+	%20 = icmp sgt i32 %19, 0
+	br i1 %20, label %ready_polls, label %wake
+
+ready_polls:
+	call void @io___wake_polls()
+	br label %wake
+
+wake:
+	call void @io___wake_timers()
+	br label %round
+
+done:
+	ret void
+}
+
+; Memoisation caches map the arguments of calls to '@memo' functions, packed into i64 keys by the
+; caller, to their results packed into an i64. Each function has a cache per thread, so neither
+; lookups nor insertions lock.
+;
+; The key of a function taking a single integer indexes a table directly while it is below the
+; cache's direct limit, the table growing to the largest key seen. Other keys live in an open
+; addressing hash table of 4 slot buckets, each slot holding the stamp of its last use (0 when
+; empty), the result, then the keys. Unbounded caches probe the following buckets on collisions
+; and double when half full. Bounded caches only use a key's own bucket and evict its least
+; recently used slot, so they never hold more results than their limit.
+%memo = type {
+	i64*,   ; 0: _values - results of the direct table
+	i8*,    ; 1: _present - whether each key of the direct table has a result
+	i64,    ; 2: _directCapacity - keys the direct table can hold
+	i64,    ; 3: directLimit - keys below it are indexed directly, 0 for none
+	i64*,   ; 4: _slots - slots of the hash table
+	i64,    ; 5: _slotCount - slots of the hash table, a power of 2 from 4
+	i64,    ; 6: _used - slots holding a result
+	i64,    ; 7: keyCount - keys of each call, at least 1
+	i64,    ; 8: limit - slots of a bounded cache, a power of 2 from 4, 0 for unbounded
+	i64     ; 9: _tick - stamp of the last use
+}
+
+declare noalias i8* @calloc(i64, i64) nounwind
+declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, i8, i64, i1 immarg)
+
+; Hashes the keys of a call, mixing each one in with the finaliser of SplitMix64, so keys that only
+; differ in their high bits (e.g. floats) still spread over the buckets.
+define private i64 @memo___hash(i64* %keys, i64 %count) nounwind readonly {
+entry:
+	br label %loop
+
+loop:
+	%index = phi i64 [ 0, %entry ], [ %next, %mix ]
+	%hash = phi i64 [ -7046029254386353131, %entry ], [ %mixed, %mix ] ; 0x9E3779B97F4A7C15
+	%done = icmp eq i64 %index, %count
+	br i1 %done, label %exit, label %mix
+
+mix:
+	%keyPtr = getelementptr inbounds i64, i64* %keys, i64 %index
+	%key = load i64, i64* %keyPtr
+	%combined = xor i64 %hash, %key
+	%shifted1 = lshr i64 %combined, 30
+	%mixed1 = xor i64 %combined, %shifted1
+	%multiplied1 = mul i64 %mixed1, -4658895280553007687 ; 0xBF58476D1CE4E5B9
+	%shifted2 = lshr i64 %multiplied1, 27
+	%mixed2 = xor i64 %multiplied1, %shifted2
+	%multiplied2 = mul i64 %mixed2, -7723592293110705685 ; 0x94D049BB133111EB
+	%shifted3 = lshr i64 %multiplied2, 31
+	%mixed = xor i64 %multiplied2, %shifted3
+	%next = add nuw i64 %index, 1
+	br label %loop
+
+exit:
+	ret i64 %hash
+}
+
+; Gets whether a slot holds the keys of a call.
+define private i1 @memo___equal(i64* %slot, i64* %keys, i64 %count) alwaysinline nounwind readonly {
+entry:
+	br label %loop
+
+loop:
+	%index = phi i64 [ 0, %entry ], [ %next, %compare ]
+	%done = icmp eq i64 %index, %count
+	br i1 %done, label %equal, label %compare
+
+compare:
+	%offset = add nuw i64 %index, 2 ; skip the stamp and the result
+	%slotKeyPtr = getelementptr inbounds i64, i64* %slot, i64 %offset
+	%slotKey = load i64, i64* %slotKeyPtr
+	%keyPtr = getelementptr inbounds i64, i64* %keys, i64 %index
+	%key = load i64, i64* %keyPtr
+	%next = add nuw i64 %index, 1
+	%same = icmp eq i64 %slotKey, %key
+	br i1 %same, label %loop, label %different
+
+equal:
+	ret i1 true
+
+different:
+	ret i1 false
+}
+
+; Finds the slot holding the result of a call in the hash table, null if there is none.
+define private i64* @memo___lookup(%memo* %self, i64* %keys) nounwind {
+entry:
+	%slotsPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 4 ; get pointer to '_slots'
+	%slots = load i64*, i64** %slotsPtr
+	%empty = icmp eq i64* %slots, null
+	br i1 %empty, label %missing, label %start
+
+start:
+	%slotCountPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 5 ; get pointer to '_slotCount'
+	%slotCount = load i64, i64* %slotCountPtr
+	%countPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 7 ; get pointer to 'keyCount'
+	%count = load i64, i64* %countPtr
+	%limitPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 8 ; get pointer to 'limit'
+	%limit = load i64, i64* %limitPtr
+	%bounded = icmp ne i64 %limit, 0
+	%stride = add nuw i64 %count, 2
+	%buckets = lshr i64 %slotCount, 2
+	%mask = sub i64 %buckets, 1
+	%hash = call i64 @memo___hash(i64* %keys, i64 %count)
+	%home = and i64 %hash, %mask
+	br label %bucket
+
+bucket:
+	%current = phi i64 [ %home, %start ], [ %nextBucket, %probe ]
+	%first = shl i64 %current, 2
+	br label %slot
+
+slot:
+	%index = phi i64 [ 0, %bucket ], [ %nextIndex, %different ]
+	%slotIndex = add nuw i64 %first, %index
+	%slotOffset = mul nuw i64 %slotIndex, %stride
+	%slotPtr = getelementptr inbounds i64, i64* %slots, i64 %slotOffset
+	%stamp = load i64, i64* %slotPtr
+	%unused = icmp eq i64 %stamp, 0 ; nothing is inserted past an empty slot
+	br i1 %unused, label %missing, label %compare
+
+compare:
+	%equal = call i1 @memo___equal(i64* %slotPtr, i64* %keys, i64 %count)
+	br i1 %equal, label %found, label %different
+
+different:
+	%nextIndex = add nuw i64 %index, 1
+	%bucketDone = icmp eq i64 %nextIndex, 4
+	br i1 %bucketDone, label %probe, label %slot
+
+probe:
+	%following = add nuw i64 %current, 1
+	%nextBucket = and i64 %following, %mask
+	br i1 %bounded, label %missing, label %bucket ; bounded caches only use the key's own bucket
+
+found:
+	ret i64* %slotPtr
+
+missing:
+	ret i64* null
+}
+
+; Finds the slot to insert a result into: the first empty slot from the key's bucket, or the least
+; recently used slot of the bucket when a bounded cache's bucket is full.
+define private i64* @memo___place(%memo* %self, i64 %hash) nounwind {
+entry:
+	%slotsPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 4 ; get pointer to '_slots'
+	%slots = load i64*, i64** %slotsPtr
+	%slotCountPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 5 ; get pointer to '_slotCount'
+	%slotCount = load i64, i64* %slotCountPtr
+	%countPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 7 ; get pointer to 'keyCount'
+	%count = load i64, i64* %countPtr
+	%limitPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 8 ; get pointer to 'limit'
+	%limit = load i64, i64* %limitPtr
+	%bounded = icmp ne i64 %limit, 0
+	%stride = add nuw i64 %count, 2
+	%buckets = lshr i64 %slotCount, 2
+	%mask = sub i64 %buckets, 1
+	%home = and i64 %hash, %mask
+	br label %bucket
+
+bucket:
+	%current = phi i64 [ %home, %entry ], [ %nextBucket, %full ]
+	%first = shl i64 %current, 2
+	br label %slot
+
+slot:
+	%index = phi i64 [ 0, %bucket ], [ %nextIndex, %used ]
+	%oldest = phi i64* [ null, %bucket ], [ %newOldest, %used ]
+	%oldestStamp = phi i64 [ -1, %bucket ], [ %newOldestStamp, %used ]
+	%slotIndex = add nuw i64 %first, %index
+	%slotOffset = mul nuw i64 %slotIndex, %stride
+	%slotPtr = getelementptr inbounds i64, i64* %slots, i64 %slotOffset
+	%stamp = load i64, i64* %slotPtr
+	%unused = icmp eq i64 %stamp, 0
+	br i1 %unused, label %empty, label %used
+
+used:
+	%older = icmp ult i64 %stamp, %oldestStamp
+	%newOldest = select i1 %older, i64* %slotPtr, i64* %oldest
+	%newOldestStamp = select i1 %older, i64 %stamp, i64 %oldestStamp
+	%nextIndex = add nuw i64 %index, 1
+	%bucketDone = icmp eq i64 %nextIndex, 4
+	br i1 %bucketDone, label %full, label %slot
+
+full:
+	%following = add nuw i64 %current, 1
+	%nextBucket = and i64 %following, %mask
+	br i1 %bounded, label %evict, label %bucket
+
+evict:
+	ret i64* %newOldest
+
+empty:
+	%usedPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 6 ; get pointer to '_used'
+	%usedCount = load i64, i64* %usedPtr
+	%newUsedCount = add nuw i64 %usedCount, 1
+	store i64 %newUsedCount, i64* %usedPtr
+	ret i64* %slotPtr
+}
+
+; Allocates the hash table of a cache, or doubles it and moves the results over.
+define private void @memo___grow(%memo* %self) nounwind {
+entry:
+	%slotsPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 4 ; get pointer to '_slots'
+	%oldSlots = load i64*, i64** %slotsPtr
+	%slotCountPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 5 ; get pointer to '_slotCount'
+	%oldSlotCount = load i64, i64* %slotCountPtr
+	%countPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 7 ; get pointer to 'keyCount'
+	%count = load i64, i64* %countPtr
+	%limitPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 8 ; get pointer to 'limit'
+	%limit = load i64, i64* %limitPtr
+	%bounded = icmp ne i64 %limit, 0
+	%initial = select i1 %bounded, i64 %limit, i64 64 ; start at 64 slots unless bounded
+	%doubled = shl i64 %oldSlotCount, 1
+	%allocated = icmp ne i64* %oldSlots, null
+	%slotCount = select i1 %allocated, i64 %doubled, i64 %initial
+	%stride = add nuw i64 %count, 2
+	%words = mul nuw i64 %slotCount, %stride
+	%bytes = call i8* @calloc(i64 %words, i64 8)
+	%slots = bitcast i8* %bytes to i64*
+	store i64* %slots, i64** %slotsPtr
+	store i64 %slotCount, i64* %slotCountPtr
+	%usedPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 6 ; get pointer to '_used'
+	store i64 0, i64* %usedPtr
+	%slotSize = shl nuw i64 %stride, 3
+	br label %loop
+
+loop:
+	%index = phi i64 [ 0, %entry ], [ %nextIndex, %advance ]
+	%done = icmp eq i64 %index, %oldSlotCount
+	br i1 %done, label %exit, label %move
+
+move:
+	%oldOffset = mul nuw i64 %index, %stride
+	%oldSlot = getelementptr inbounds i64, i64* %oldSlots, i64 %oldOffset
+	%stamp = load i64, i64* %oldSlot
+	%unused = icmp eq i64 %stamp, 0
+	br i1 %unused, label %advance, label %copy
+
+copy:
+	%oldKeys = getelementptr inbounds i64, i64* %oldSlot, i64 2
+	%hash = call i64 @memo___hash(i64* %oldKeys, i64 %count)
+	%newSlot = call i64* @memo___place(%memo* %self, i64 %hash)
+	%to = bitcast i64* %newSlot to i8*
+	%from = bitcast i64* %oldSlot to i8*
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %to, i8* %from, i64 %slotSize, i1 false)
+	br label %advance
+
+advance:
+	%nextIndex = add nuw i64 %index, 1
+	br label %loop
+
+exit:
+	%oldBytes = bitcast i64* %oldSlots to i8*
+	call void @free(i8* %oldBytes)
+	ret void
+}
+
+; Finds the result of a call in a cache, writing it to 'result'. Returns whether it was found.
+define i1 @memo_SEP_find(%memo* %self, i64* %keys, i64* %result) nounwind {
+entry:
+	%directLimitPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 3 ; get pointer to 'directLimit'
+	%directLimit = load i64, i64* %directLimitPtr
+	%key = load i64, i64* %keys
+	%direct = icmp ult i64 %key, %directLimit ; also rejects negative keys
+	br i1 %direct, label %table, label %hashed
+
+table:
+	%capacityPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 2 ; get pointer to '_directCapacity'
+	%capacity = load i64, i64* %capacityPtr
+	%inTable = icmp ult i64 %key, %capacity
+	br i1 %inTable, label %check, label %missing
+
+check:
+	%presentPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 1 ; get pointer to '_present'
+	%present = load i8*, i8** %presentPtr
+	%isPresentPtr = getelementptr inbounds i8, i8* %present, i64 %key
+	%isPresent = load i8, i8* %isPresentPtr
+	%known = icmp ne i8 %isPresent, 0
+	br i1 %known, label %directHit, label %missing
+
+directHit:
+	%valuesPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 0 ; get pointer to '_values'
+	%values = load i64*, i64** %valuesPtr
+	%directValuePtr = getelementptr inbounds i64, i64* %values, i64 %key
+	%directValue = load i64, i64* %directValuePtr
+	store i64 %directValue, i64* %result
+	ret i1 true
+
+hashed:
+	%slot = call i64* @memo___lookup(%memo* %self, i64* %keys)
+	%none = icmp eq i64* %slot, null
+	br i1 %none, label %missing, label %hit
+
+hit:
+	%tickPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 9 ; get pointer to '_tick'
+	%tick = load i64, i64* %tickPtr
+	%newTick = add nuw i64 %tick, 1
+	store i64 %newTick, i64* %tickPtr
+	store i64 %newTick, i64* %slot ; the slot is now the most recently used
+	%valuePtr = getelementptr inbounds i64, i64* %slot, i64 1
+	%value = load i64, i64* %valuePtr
+	store i64 %value, i64* %result
+	ret i1 true
+
+missing:
+	ret i1 false
+}
+
+; Inserts the result of a call that is not in a cache yet.
+define void @memo_SEP_insert(%memo* %self, i64* %keys, i64 %value) nounwind {
+entry:
+	%directLimitPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 3 ; get pointer to 'directLimit'
+	%directLimit = load i64, i64* %directLimitPtr
+	%key = load i64, i64* %keys
+	%direct = icmp ult i64 %key, %directLimit ; also rejects negative keys
+	br i1 %direct, label %table, label %hashed
+
+table:
+	%capacityPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 2 ; get pointer to '_directCapacity'
+	%capacity = load i64, i64* %capacityPtr
+	%valuesPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 0 ; get pointer to '_values'
+	%presentPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 1 ; get pointer to '_present'
+	%inTable = icmp ult i64 %key, %capacity
+	br i1 %inTable, label %store, label %growTable
+
+growTable:
+	%doubled = shl i64 %capacity, 1
+	%moreThanInitial = icmp ugt i64 %doubled, 64
+	%atLeastInitial = select i1 %moreThanInitial, i64 %doubled, i64 64 ; start at 64 keys
+	%needed = add nuw i64 %key, 1
+	%moreThanNeeded = icmp ugt i64 %atLeastInitial, %needed
+	%atLeastNeeded = select i1 %moreThanNeeded, i64 %atLeastInitial, i64 %needed
+	%overLimit = icmp ugt i64 %atLeastNeeded, %directLimit
+	%newCapacity = select i1 %overLimit, i64 %directLimit, i64 %atLeastNeeded
+	%oldValues = load i64*, i64** %valuesPtr
+	%oldValueBytes = bitcast i64* %oldValues to i8*
+	%valueSize = shl nuw i64 %newCapacity, 3
+	%grownValues = call i8* @realloc(i8* %oldValueBytes, i64 %valueSize)
+	%newValueBytes = call i8* @panic___check_allocation(i8* %grownValues, i64 %valueSize)
+	%newValues = bitcast i8* %newValueBytes to i64*
+	store i64* %newValues, i64** %valuesPtr
+	%oldPresent = load i8*, i8** %presentPtr
+	%grownPresent = call i8* @realloc(i8* %oldPresent, i64 %newCapacity)
+	%newPresent = call i8* @panic___check_allocation(i8* %grownPresent, i64 %newCapacity)
+	store i8* %newPresent, i8** %presentPtr
+	%added = getelementptr inbounds i8, i8* %newPresent, i64 %capacity
+	%addedCount = sub nuw i64 %newCapacity, %capacity
+	call void @llvm.memset.p0i8.i64(i8* %added, i8 0, i64 %addedCount, i1 false)
+	store i64 %newCapacity, i64* %capacityPtr
+	br label %store
+
+store:
+	%values = load i64*, i64** %valuesPtr
+	%directValuePtr = getelementptr inbounds i64, i64* %values, i64 %key
+	store i64 %value, i64* %directValuePtr
+	%present = load i8*, i8** %presentPtr
+	%isPresentPtr = getelementptr inbounds i8, i8* %present, i64 %key
+	store i8 1, i8* %isPresentPtr
+	ret void
+
+hashed:
+	%slotsPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 4 ; get pointer to '_slots'
+	%slots = load i64*, i64** %slotsPtr
+	%unallocated = icmp eq i64* %slots, null
+	br i1 %unallocated, label %grow, label %checkLoad
+
+checkLoad:
+	%limitPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 8 ; get pointer to 'limit'
+	%limit = load i64, i64* %limitPtr
+	%bounded = icmp ne i64 %limit, 0
+	br i1 %bounded, label %place, label %checkHalf ; bounded caches evict instead of growing
+
+checkHalf:
+	%slotCountPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 5 ; get pointer to '_slotCount'
+	%slotCount = load i64, i64* %slotCountPtr
+	%usedPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 6 ; get pointer to '_used'
+	%used = load i64, i64* %usedPtr
+	%newUsed = add nuw i64 %used, 1
+	%load = shl nuw i64 %newUsed, 1
+	%halfFull = icmp ugt i64 %load, %slotCount
+	br i1 %halfFull, label %grow, label %place
+
+grow:
+	call void @memo___grow(%memo* %self)
+	br label %place
+
+place:
+	%countPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 7 ; get pointer to 'keyCount'
+	%count = load i64, i64* %countPtr
+	%hash = call i64 @memo___hash(i64* %keys, i64 %count)
+	%slot = call i64* @memo___place(%memo* %self, i64 %hash)
+	%tickPtr = getelementptr inbounds %memo, %memo* %self, i64 0, i32 9 ; get pointer to '_tick'
+	%tick = load i64, i64* %tickPtr
+	%newTick = add nuw i64 %tick, 1
+	store i64 %newTick, i64* %tickPtr
+	store i64 %newTick, i64* %slot
+	%valuePtr = getelementptr inbounds i64, i64* %slot, i64 1
+	store i64 %value, i64* %valuePtr
+	%slotKeys = getelementptr inbounds i64, i64* %slot, i64 2
+	%to = bitcast i64* %slotKeys to i8*
+	%from = bitcast i64* %keys to i8*
+	%keySize = shl nuw i64 %count, 3
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %to, i8* %from, i64 %keySize, i1 false)
+	ret void
+}
+
+; Frees the tables of a cache, leaving it empty.
+define void @memo_SEP___del__(%memo* %self) nounwind {
+	%1 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 0 ; get pointer to '_values'
+	%2 = load i64*, i64** %1
+	%3 = bitcast i64* %2 to i8*
+	call void @free(i8* %3)
+	store i64* null, i64** %1
+	%4 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 1 ; get pointer to '_present'
+	%5 = load i8*, i8** %4
+	call void @free(i8* %5)
+	store i8* null, i8** %4
+	%6 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 2 ; get pointer to '_directCapacity'
+	store i64 0, i64* %6
+	%7 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 4 ; get pointer to '_slots'
+	%8 = load i64*, i64** %7
+	%9 = bitcast i64* %8 to i8*
+	call void @free(i8* %9)
+	store i64* null, i64** %7
+	%10 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 5 ; get pointer to '_slotCount'
+	store i64 0, i64* %10
+	%11 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 6 ; get pointer to '_used'
+	store i64 0, i64* %11
+	%12 = getelementptr inbounds %memo, %memo* %self, i64 0, i32 9 ; get pointer to '_tick'
+	store i64 0, i64* %12
+	ret void
+}
+
+; Parallel loops run on a pool of worker threads, one per core (or 'EXEME_THREADS'), started the
+; first time one runs. The thread running the loop takes part as worker 0. Each worker owns a
+; Chase-Lev deque of ranges of iterations: it pushes and pops at the bottom, while idle workers
+; steal from the top. A worker running a range halves it, pushing the upper half, until it is no
+; larger than the job's grain, so the ranges stolen are the largest ones and each steal moves a lot
+; of work. Loops run from inside a parallel loop, or with a single worker, run on the calling
+; thread.
+;
+; Reductions give each worker its own accumulator, starting at the reduction's identity, which are
+; combined into the result once every iteration has run. As which worker runs which iterations
+; depends on timing, float reductions may round differently from one run to the next.
+%task.range = type {
+	i64,    ; 0: begin - first iteration
+	i64     ; 1: end - iteration to stop at
+}
+
+%task.deque = type {
+	i64,                ; 0: top - index of the oldest range, advanced by thieves
+	[7 x i64],          ; 1: padding, so the owner and thieves do not share a cache line
+	i64,                ; 2: bottom - index past the newest range, only moved by the owner
+	[7 x i64],          ; 3: padding
+	[64 x %task.range]  ; 4: ranges - circular, never more than 63 as each is half the one before
+}
+
+declare i8* @getenv(i8*) nounwind
+declare i64 @strtol(i8*, i8**, i32) nounwind
+declare i64 @sysconf(i32) nounwind
+declare i32 @sched_yield() nounwind
+declare i32 @pthread_create(i64*, i8*, i8* (i8*)*, i8*) nounwind
+declare i32 @pthread_detach(i64) nounwind
+declare i32 @pthread_mutex_init(i8*, i8*) nounwind
+declare i32 @pthread_mutex_lock(i8*) nounwind
+declare i32 @pthread_mutex_unlock(i8*) nounwind
+declare i32 @pthread_cond_init(i8*, i8*) nounwind
+declare i32 @pthread_cond_wait(i8*, i8*) nounwind
+declare i32 @pthread_cond_broadcast(i8*) nounwind
+
+@task___threads = private unnamed_addr constant [14 x i8] c"EXEME_THREADS\00"
+@task___deques = internal global [64 x %task.deque] zeroinitializer, align 64
+@task___workers = internal global i64 1 ; workers, including the thread running the loop
+@task___once = internal global i32 0 ; pthread_once_t
+@task___mutex = internal global [64 x i8] zeroinitializer, align 16 ; pthread_mutex_t
+@task___wake = internal global [64 x i8] zeroinitializer, align 16 ; pthread_cond_t
+@task___generation = internal global i64 0 ; jobs started, guarded by the mutex
+@task___pending = internal global i64 0 ; iterations of the current job still to run
+@task___body = internal global void (i8*, i64, i64, i8*)* null ; the current job
+@task___context = internal global i8* null
+@task___accumulators = internal global i8* null
+@task___stride = internal global i64 0 ; bytes between the accumulators of two workers
+@task___grain = internal global i64 1 ; ranges at most this large are not split
+@task___busy = internal thread_local global i1 false ; whether the thread is running a job
+
+; Gets a pointer to the slot of a worker's deque an index falls in.
+define private %task.range* @task___slot(i64 %id, i64 %index) alwaysinline nounwind {
+	%1 = and i64 %index, 63
+	%2 = getelementptr inbounds [64 x %task.deque], [64 x %task.deque]* @task___deques, i64 0, i64 %id, i32 4, i64 %1
+	ret %task.range* %2
+}
+
+; Pushes a range onto the bottom of the calling worker's deque.
+define private void @task___push(i64 %id, i64 %begin, i64 %end) nounwind {
+	%1 = getelementptr inbounds [64 x %task.deque], [64 x %task.deque]* @task___deques, i64 0, i64 %id, i32 2 ; get pointer to 'bottom'
+	%2 = load atomic i64, i64* %1 monotonic, align 8
+	%3 = call %task.range* @task___slot(i64 %id, i64 %2)
+	%4 = getelementptr inbounds %task.range, %task.range* %3, i64 0, i32 0 ; get pointer to 'begin'
+	store atomic i64 %begin, i64* %4 monotonic, align 8
+	%5 = getelementptr inbounds %task.range, %task.range* %3, i64 0, i32 1 ; get pointer to 'end'
+	store atomic i64 %end, i64* %5 monotonic, align 8
+	%6 = add i64 %2, 1
+	store atomic i64 %6, i64* %1 seq_cst, align 8 ; publishes the range
+	ret void
+}
+
+; Pops the newest range off the bottom of the calling worker's deque, racing thieves for the last
+; one. Returns whether a range was taken, and the range.
+define private { i1, i64, i64 } @task___pop(i64 %id) nounwind {
+entry:
+	%bottomPtr = getelementptr inbounds [64 x %task.deque], [64 x %task.deque]* @task___deques, i64 0, i64 %id, i32 2
+	%topPtr = getelementptr inbounds [64 x %task.deque], [64 x %task.deque]* @task___deques, i64 0, i64 %id, i32 0
+	%bottom = load atomic i64, i64* %bottomPtr monotonic, align 8
+	%last = sub i64 %bottom, 1
+	store atomic i64 %last, i64* %bottomPtr seq_cst, align 8 ; claims it before looking at 'top'
+	%top = load atomic i64, i64* %topPtr seq_cst, align 8
+	%empty = icmp slt i64 %last, %top
+	br i1 %empty, label %restore, label %take
+
+take:
+	%slot = call %task.range* @task___slot(i64 %id, i64 %last)
+	%beginPtr = getelementptr inbounds %task.range, %task.range* %slot, i64 0, i32 0
+	%begin = load atomic i64, i64* %beginPtr monotonic, align 8
+	%endPtr = getelementptr inbounds %task.range, %task.range* %slot, i64 0, i32 1
+	%end = load atomic i64, i64* %endPtr monotonic, align 8
+	%0 = insertvalue { i1, i64, i64 } { i1 true, i64 undef, i64 undef }, i64 %begin, 1
+	%range = insertvalue { i1, i64, i64 } %0, i64 %end, 2
+	%only = icmp eq i64 %last, %top
+	br i1 %only, label %race, label %taken
+
+race: ; a thief may be stealing the same range
+	%next = add i64 %top, 1
+	%1 = cmpxchg i64* %topPtr, i64 %top, i64 %next seq_cst seq_cst
+	%won = extractvalue { i64, i1 } %1, 1
+	store atomic i64 %bottom, i64* %bottomPtr seq_cst, align 8 ; the deque is empty either way
+	br i1 %won, label %taken, label %none
+
+taken:
+	ret { i1, i64, i64 } %range
+
+restore:
+	store atomic i64 %bottom, i64* %bottomPtr seq_cst, align 8
+	br label %none
+
+none:
+	ret { i1, i64, i64 } { i1 false, i64 0, i64 0 }
+}
+
+; Steals the oldest range off the top of a worker's deque. Returns whether a range was taken, and
+; the range.
+define private { i1, i64, i64 } @task___steal(i64 %victim) nounwind {
+entry:
+	%topPtr = getelementptr inbounds [64 x %task.deque], [64 x %task.deque]* @task___deques, i64 0, i64 %victim, i32 0
+	%bottomPtr = getelementptr inbounds [64 x %task.deque], [64 x %task.deque]* @task___deques, i64 0, i64 %victim, i32 2
+	%top = load atomic i64, i64* %topPtr seq_cst, align 8
+	%bottom = load atomic i64, i64* %bottomPtr seq_cst, align 8
+	%empty = icmp sge i64 %top, %bottom
+	br i1 %empty, label %none, label %take
+
+take:
+	%slot = call %task.range* @task___slot(i64 %victim, i64 %top)
+	%beginPtr = getelementptr inbounds %task.range, %task.range* %slot, i64 0, i32 0
+	%begin = load atomic i64, i64* %beginPtr monotonic, align 8
+	%endPtr = getelementptr inbounds %task.range, %task.range* %slot, i64 0, i32 1
+	%end = load atomic i64, i64* %endPtr monotonic, align 8
+	%next = add i64 %top, 1
+	%0 = cmpxchg i64* %topPtr, i64 %top, i64 %next seq_cst seq_cst
+	%won = extractvalue { i64, i1 } %0, 1
+	br i1 %won, label %taken, label %none
+
+taken:
+	%1 = insertvalue { i1, i64, i64 } { i1 true, i64 undef, i64 undef }, i64 %begin, 1
+	%2 = insertvalue { i1, i64, i64 } %1, i64 %end, 2
+	ret { i1, i64, i64 } %2
+
+none:
+	ret { i1, i64, i64 } { i1 false, i64 0, i64 0 }
+}
+
+; Runs a range of the current job, first splitting off upper halves for other workers to steal
+; while it is larger than the grain.
+define private void @task___run_range(i64 %id, i64 %begin, i64 %end) nounwind {
+entry:
+	%grain = load i64, i64* @task___grain
+	br label %split
+
+split:
+	%last = phi i64 [ %end, %entry ], [ %middle, %push ]
+	%size = sub i64 %last, %begin
+	%large = icmp sgt i64 %size, %grain
+	br i1 %large, label %push, label %run
+
+push:
+	%half = lshr i64 %size, 1
+	%middle = add i64 %begin, %half
+	call void @task___push(i64 %id, i64 %middle, i64 %last)
+	br label %split
+
+run:
+	%body = load void (i8*, i64, i64, i8*)*, void (i8*, i64, i64, i8*)** @task___body
+	%context = load i8*, i8** @task___context
+	%accumulators = load i8*, i8** @task___accumulators
+	%stride = load i64, i64* @task___stride
+	%offset = mul i64 %id, %stride
+	%accumulator = getelementptr i8, i8* %accumulators, i64 %offset
+	call void %body(i8* %context, i64 %begin, i64 %last, i8* %accumulator)
+	call void @io_SEP_flush() ; workers never exit, so their output must not wait in their buffers
+	%0 = atomicrmw sub i64* @task___pending, i64 %size seq_cst
+	ret void
+}
+
+; Runs ranges of the current job, the worker's own first and then stolen from random workers,
+; until every iteration of the job has run.
+define private void @task___work(i64 %id) nounwind {
+entry:
+	%0 = mul i64 %id, -7046029254386353131 ; 0x9E3779B97F4A7C15
+	%seed = or i64 %0, 1 ; xorshift needs a non-zero state
+	br label %next
+
+next:
+	%state = phi i64 [ %seed, %entry ], [ %state, %runOwn ], [ %shuffled, %runStolen ], [ %shuffled, %idle ]
+	%pending = load atomic i64, i64* @task___pending seq_cst, align 8
+	%finished = icmp eq i64 %pending, 0
+	br i1 %finished, label %done, label %pop
+
+pop:
+	%own = call { i1, i64, i64 } @task___pop(i64 %id)
+	%found = extractvalue { i1, i64, i64 } %own, 0
+	br i1 %found, label %runOwn, label %steal
+
+runOwn:
+	%ownBegin = extractvalue { i1, i64, i64 } %own, 1
+	%ownEnd = extractvalue { i1, i64, i64 } %own, 2
+	call void @task___run_range(i64 %id, i64 %ownBegin, i64 %ownEnd)
+	br label %next
+
+steal:
+	%1 = shl i64 %state, 13
+	%2 = xor i64 %state, %1
+	%3 = lshr i64 %2, 7
+	%4 = xor i64 %2, %3
+	%5 = shl i64 %4, 17
+	%shuffled = xor i64 %4, %5
+	%workers = load i64, i64* @task___workers
+	%victim = urem i64 %shuffled, %workers
+	%stolen = call { i1, i64, i64 } @task___steal(i64 %victim)
+	%success = extractvalue { i1, i64, i64 } %stolen, 0
+	br i1 %success, label %runStolen, label %idle
+
+runStolen:
+	%stolenBegin = extractvalue { i1, i64, i64 } %stolen, 1
+	%stolenEnd = extractvalue { i1, i64, i64 } %stolen, 2
+	call void @task___run_range(i64 %id, i64 %stolenBegin, i64 %stolenEnd)
+	br label %next
+
+idle:
+	%6 = call i32 @sched_yield()
+	br label %next
+
+done:
+	ret void
+}
+
+; The loop of a worker thread: sleeps until a job starts, then helps run it.
+define private i8* @task___worker(i8* %argument) nounwind {
+entry:
+	%id = ptrtoint i8* %argument to i64
+	store i1 true, i1* @task___busy ; loops run by the job's iterations run on their thread
+	%mutex = getelementptr inbounds [64 x i8], [64 x i8]* @task___mutex, i64 0, i64 0
+	%wake = getelementptr inbounds [64 x i8], [64 x i8]* @task___wake, i64 0, i64 0
+	br label %wait
+
+wait:
+	%seen = phi i64 [ 0, %entry ], [ %generation, %woken ]
+	%0 = call i32 @pthread_mutex_lock(i8* %mutex)
+	br label %check
+
+check:
+	%generation = load i64, i64* @task___generation
+	%same = icmp eq i64 %generation, %seen
+	br i1 %same, label %sleep, label %woken
+
+sleep:
+	%1 = call i32 @pthread_cond_wait(i8* %wake, i8* %mutex)
+	br label %check
+
+woken:
+	%2 = call i32 @pthread_mutex_unlock(i8* %mutex)
+	call void @task___work(i64 %id)
+	br label %wait
+}
+
+; Starts the workers, as many as 'EXEME_THREADS' says or else one per core, up to 64.
+define private void @task___init() nounwind {
+entry:
+	%thread = alloca i64
+	%mutex = getelementptr inbounds [64 x i8], [64 x i8]* @task___mutex, i64 0, i64 0
+	%wake = getelementptr inbounds [64 x i8], [64 x i8]* @task___wake, i64 0, i64 0
+	%0 = call i32 @pthread_mutex_init(i8* %mutex, i8* null)
+	%1 = call i32 @pthread_cond_init(i8* %wake, i8* null)
+	%2 = getelementptr inbounds [14 x i8], [14 x i8]* @task___threads, i64 0, i64 0
+	%variable = call i8* @getenv(i8* %2)
+	%set = icmp ne i8* %variable, null
+	br i1 %set, label %parse, label %cores
+
+parse:
+	%parsed = call i64 @strtol(i8* %variable, i8** null, i32 10)
+	br label %clamp
+
+cores:
+	%online = call i64 @sysconf(i32 84) ; _SC_NPROCESSORS_ONLN
+	br label %clamp
+
+clamp:
+	%requested = phi i64 [ %parsed, %parse ], [ %online, %cores ]
+	%few = icmp slt i64 %requested, 1
+	%3 = select i1 %few, i64 1, i64 %requested
+	%many = icmp sgt i64 %3, 64
+	%count = select i1 %many, i64 64, i64 %3
+	br label %start
+
+start:
+	%id = phi i64 [ 1, %clamp ], [ %next, %started ]
+	%more = icmp slt i64 %id, %count
+	br i1 %more, label %create, label %done
+
+create:
+	%argument = inttoptr i64 %id to i8*
+	%4 = call i32 @pthread_create(i64* %thread, i8* null, i8* (i8*)* @task___worker, i8* %argument)
+	%failed = icmp ne i32 %4, 0
+	br i1 %failed, label %done, label %started
+
+started:
+	%5 = load i64, i64* %thread
+	%6 = call i32 @pthread_detach(i64 %5)
+	%next = add nuw nsw i64 %id, 1
+	br label %start
+
+done:
+	%workers = phi i64 [ %id, %start ], [ %id, %create ] ; fewer if a thread could not start
+	store i64 %workers, i64* @task___workers
+	ret void
+}
+
+; Gets whether a loop must run on the calling thread: the pool has a single worker, or the thread
+; is already running a job.
+define private i1 @task___serial() nounwind {
+	%1 = call i32 @pthread_once(i32* @task___once, void ()* @task___init)
+	%2 = load i64, i64* @task___workers
+	%3 = icmp eq i64 %2, 1
+	%4 = load i1, i1* @task___busy
+	%5 = or i1 %3, %4
+	ret i1 %5
+}
+
+; Runs a job on every worker, returning once all of its iterations have run.
+define private void @task___run(i64 %begin, i64 %end, void (i8*, i64, i64, i8*)* %body, i8* %context, i8* %accumulators, i64 %stride) nounwind {
+	%workers = load i64, i64* @task___workers
+	%count = sub i64 %end, %begin
+	%1 = shl nuw nsw i64 %workers, 3 ; 8 ranges per worker balance uneven iterations
+	%2 = udiv i64 %count, %1
+	%3 = icmp eq i64 %2, 0
+	%grain = select i1 %3, i64 1, i64 %2
+	store void (i8*, i64, i64, i8*)* %body, void (i8*, i64, i64, i8*)** @task___body
+	store i8* %context, i8** @task___context
+	store i8* %accumulators, i8** @task___accumulators
+	store i64 %stride, i64* @task___stride
+	store i64 %grain, i64* @task___grain
+	store atomic i64 %count, i64* @task___pending seq_cst, align 8
+	store i1 true, i1* @task___busy
+	call void @task___push(i64 0, i64 %begin, i64 %end)
+	%mutex = getelementptr inbounds [64 x i8], [64 x i8]* @task___mutex, i64 0, i64 0
+	%wake = getelementptr inbounds [64 x i8], [64 x i8]* @task___wake, i64 0, i64 0
+	%4 = call i32 @pthread_mutex_lock(i8* %mutex)
+	%5 = load i64, i64* @task___generation
+	%6 = add i64 %5, 1
+	store i64 %6, i64* @task___generation
+	%7 = call i32 @pthread_cond_broadcast(i8* %wake)
+	%8 = call i32 @pthread_mutex_unlock(i8* %mutex)
+	call void @task___work(i64 0)
+	store i1 false, i1* @task___busy
+	ret void
+}
+
+; Runs 'body(context, begin, end, null)' over the iterations [begin, end), split into ranges run in
+; parallel. The ranges may run in any order, on any thread.
+define void @task_SEP_for(i64 %begin, i64 %end, void (i8*, i64, i64, i8*)* %body, i8* %context) nounwind {
+entry:
+	%empty = icmp sge i64 %begin, %end
+	br i1 %empty, label %done, label %start
+
+start:
+	%serial = call i1 @task___serial()
+	br i1 %serial, label %alone, label %parallel
+
+alone:
+	call void %body(i8* %context, i64 %begin, i64 %end, i8* null)
+	br label %done
+
+parallel:
+	call void @task___run(i64 %begin, i64 %end, void (i8*, i64, i64, i8*)* %body, i8* %context, i8* null, i64 0)
+	br label %done
+
+done:
+	ret void
+}
+
+; Runs 'body(context, begin, end, accumulator)' over the iterations [begin, end) in parallel, like
+; 'task::for', each range folding into the accumulator of the worker running it. Accumulators are
+; 'size' bytes, start as a copy of 'identity', and are folded into 'result' with
+; 'combine(result, accumulator)' at the end, so the reduction must be associative and commutative.
+define void @task_SEP_reduce(i64 %begin, i64 %end, void (i8*, i64, i64, i8*)* %body, i8* %context, i8* %identity, i64 %size, void (i8*, i8*)* %combine, i8* %result) nounwind {
+entry:
+	%empty = icmp sge i64 %begin, %end
+	br i1 %empty, label %done, label %start
+
+start:
+	%serial = call i1 @task___serial()
+	br i1 %serial, label %alone, label %parallel
+
+alone: ; a single accumulator, which may as well be the result
+	call void %body(i8* %context, i64 %begin, i64 %end, i8* %result)
+	br label %done
+
+parallel:
+	%workers = load i64, i64* @task___workers
+	%0 = add i64 %size, 63
+	%stride = and i64 %0, -64 ; a cache line each, so workers do not share them
+	%1 = mul i64 %stride, %workers
+	%memory = call i8* @malloc(i64 %1)
+	%accumulators = call i8* @panic___check_allocation(i8* %memory, i64 %1)
+	br label %initialise
+
+initialise:
+	%index = phi i64 [ 0, %parallel ], [ %nextIndex, %copy ]
+	%initialised = icmp eq i64 %index, %workers
+	br i1 %initialised, label %run, label %copy
+
+copy:
+	%2 = mul i64 %index, %stride
+	%3 = getelementptr inbounds i8, i8* %accumulators, i64 %2
+	call void @llvm.memcpy.p0i8.p0i8.i64(i8* %3, i8* %identity, i64 %size, i1 false)
+	%nextIndex = add nuw nsw i64 %index, 1
+	br label %initialise
+
+run:
+	call void @task___run(i64 %begin, i64 %end, void (i8*, i64, i64, i8*)* %body, i8* %context, i8* %accumulators, i64 %stride)
+	br label %combining
+
+combining:
+	%worker = phi i64 [ 0, %run ], [ %nextWorker, %fold ]
+	%combined = icmp eq i64 %worker, %workers
+	br i1 %combined, label %free, label %fold
+
+fold:
+	%4 = mul i64 %worker, %stride
+	%5 = getelementptr inbounds i8, i8* %accumulators, i64 %4
+	call void %combine(i8* %result, i8* %5)
+	%nextWorker = add nuw nsw i64 %worker, 1
+	br label %combining
 
-	; Initiailise 'length'
-	%2 = getelementptr %str* %self, i64 0, i64 1 ; get pointer to 'length'
-	store i64 0, i64* %2 ; store 0
+free:
+	call void @free(i8* %accumulators)
+	br label %done
 
+done:
 	ret void
 }
@@ -403,15 +403,23 @@ struct Hashmap* args_format_parse_internal(struct ArgsFormat* p_self, struct Arr
 												// internal data structures
 
 		if (strncmp(lp_argRaw, "-", 1) == 0) { // Long / short flag
-			bool longFlag = strncmp(lp_argRaw, "--", 2) == 0;
-			int	 argumentFormatIndex =
-				array_find(&p_self->argumentsFormat, args_format_parse_optional_argument_flag_match,
-						   lp_argRaw);
+			bool  longFlag		 = strncmp(lp_argRaw, "--", 2) == 0;
+			char* lp_inlineValue = longFlag ? strchr(lp_argRaw, '=') : NULL; // '--flag=value'
+			char* lp_flag		 = lp_argRaw;
+
+			if (lp_inlineValue) {
+				lp_flag								= duplicate_string(lp_argRaw);
+				lp_flag[lp_inlineValue - lp_argRaw] = '\0';
+				lp_inlineValue++;
+			}
+
+			int argumentFormatIndex = array_find(
+				&p_self->argumentsFormat, args_format_parse_optional_argument_flag_match, lp_flag);
 
 			if (argumentFormatIndex == -1) {
-				if (array_contains(p_self->reservedFlags, array___match_string, lp_argRaw)) {
+				if (array_contains(p_self->reservedFlags, array___match_string, lp_flag)) {
 					int reservedFlagsIndex = array_find((struct Array*)gp_ARGS_RESERVED_FLAGS_VALUE,
-														array___match_string, lp_argRaw);
+														array___match_string, lp_flag);
 
 					if (reservedFlagsIndex != -1) {
 						switch (reservedFlagsIndex
@@ -438,15 +446,20 @@ struct Hashmap* args_format_parse_internal(struct ArgsFormat* p_self, struct Arr
 						 ->data.arg;
 
 				if (lp_arg->type == VARIABLE_TYPE_NONE) { // Optional flag
+					if (lp_inlineValue) {
+						args_error(args, A0003, "flag does not take a value", index);
+					}
+
 					hashmap_set(lp_parsedArgs, lp_arg->name, NULL);
-				} else if (index++ == args.length - 1) { // Optional argument and no value
+				} else if (!lp_inlineValue
+						   && index++ == args.length - 1) { // Optional argument and no value
 					args_error(args, A0002,
 							   CONCATENATE_STRING("missing value for ", longFlag ? "long" : "short",
 												  " flag"),
 							   realIndex);
 				} else { // Optional argument and value
-					void* lp_argConverted =
-						convert_to_type((char*)args._values[index], lp_arg->type);
+					void* lp_argConverted = convert_to_type(
+						lp_inlineValue ? lp_inlineValue : (char*)args._values[index], lp_arg->type);
 
 					if (!lp_argConverted) {
 						args_error(args, A0003,
@@ -458,6 +471,10 @@ struct Hashmap* args_format_parse_internal(struct ArgsFormat* p_self, struct Arr
 					hashmap_set(lp_parsedArgs, lp_arg->name, lp_argConverted);
 				}
 			}
+
+			if (lp_inlineValue) {
+				free(lp_flag);
+			}
 		} else { // Required argument / Subcommand
 			if (array_index_occupied(p_self->requiredArguments,
 									 realIndex)) { // Required argument
@@ -486,6 +503,7 @@ struct Hashmap* args_format_parse_internal(struct ArgsFormat* p_self, struct Arr
 				struct Hashmap* lp_subcommandParsedArgs =
 					args_format_parse_internal(lp_subcommandFormat, args, index + 1);
 				hashmap_combine(lp_parsedArgs, lp_subcommandParsedArgs);
+				hashmap_set(lp_parsedArgs, lp_argRaw, NULL); // Which subcommand was given
 
 				hashmap_free(&lp_subcommandParsedArgs, NULL);
 				args_format_free(&lp_subcommandFormat);
@@ -0,0 +1,66 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./attributes.h"
+#include "./diagnostics.h"
+#include "../utils/array.h"
+#include "../utils/panic.h"
+#include "../utils/str.h"
+#include <string.h>
+
+// X-Macro to define attribute names
+static char* const g_ATTRIBUTE_NAMES_INTERNAL[] = {
+#define ATTRIBUTE_TO_STRING(name, string, targets) string,
+	ATTRIBUTES(ATTRIBUTE_TO_STRING)
+#undef ATTRIBUTE_TO_STRING
+};
+
+// X-Macro to define the node kinds each attribute can be applied to
+static const uint32_t g_ATTRIBUTE_TARGETS[] = {
+#define ATTRIBUTE_TO_TARGETS(name, string, targets) targets,
+	ATTRIBUTES(ATTRIBUTE_TO_TARGETS)
+#undef ATTRIBUTE_TO_TARGETS
+};
+
+const struct Array g_ATTRIBUTE_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_ATTRIBUTE_NAMES_INTERNAL,
+						sizeof(g_ATTRIBUTE_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* attribute_get_name(const enum Attributes ATTRIBUTE) {
+	if ((size_t)ATTRIBUTE + 1 > g_ATTRIBUTE_NAMES.length) {
+		PANIC("g_ATTRIBUTE_NAMES get index out of bounds");
+	}
+
+	return g_ATTRIBUTE_NAMES._values[ATTRIBUTE];
+}
+
+void attributes_apply(const char* p_filePath, struct FlatAST* p_ast, flat_ast_index_t node,
+					  const char* p_name) {
+	struct FlatASTNode* lp_node = &p_ast->nodes[node];
+
+	for (size_t attribute = 0; attribute < g_ATTRIBUTE_NAMES.length; attribute++) {
+		if (strcmp(g_ATTRIBUTE_NAMES._values[attribute], p_name) != 0) {
+			continue;
+		}
+
+		if (!(g_ATTRIBUTE_TARGETS[attribute] & (1U << lp_node->kind))) {
+			compiler_error(p_filePath, lp_node->line, C0004,
+						   CONCATENATE_STRING("attribute '@", p_name, "' cannot be applied to ",
+											  flat_ast_kind_get_name(lp_node->kind), " nodes"));
+		}
+
+		lp_node->flags |= (uint16_t)(1U << attribute);
+
+		return;
+	}
+
+	compiler_error(p_filePath, lp_node->line, C0003,
+				   CONCATENATE_STRING("unknown attribute '@", p_name, "'"));
+}
+
+bool attributes_has(const struct FlatAST* p_ast, flat_ast_index_t node,
+					const enum Attributes ATTRIBUTE) {
+	return (flat_ast_get(p_ast, node)->flags & (1U << ATTRIBUTE)) != 0;
+}
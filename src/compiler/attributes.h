@@ -0,0 +1,79 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../parser/flat.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Gets the bit of a flat AST node kind, for the kinds an attribute can be applied to
+#define ATTRIBUTE_TARGET(kind) (1U << FLATAST_##kind)
+
+// X-Macro to define attributes ('@name' before a node), and the node kinds they can be applied to
+#define ATTRIBUTES(X)                                                                              \
+	X(COMPTIME, "comptime",                                                                        \
+	  ATTRIBUTE_TARGET(FUNCTION) | ATTRIBUTE_TARGET(CALL)) /* Evaluate at compile time, or fail */ \
+	X(ORDERED, "ordered",                                                                          \
+	  ATTRIBUTE_TARGET(STRUCT)) /* Keep the declared field order, e.g. for FFI */                  \
+	X(TAILCALL, "tailcall",                                                                        \
+	  ATTRIBUTE_TARGET(CALL)) /* Run the call in constant stack, or fail */                        \
+	X(MEMO, "memo", ATTRIBUTE_TARGET(FUNCTION)) /* Cache results by arguments */                   \
+	X(MEMO_LRU, "memo_lru",                                                                        \
+	  ATTRIBUTE_TARGET(FUNCTION)) /* Cache results, evicting the least recently used */            \
+	X(ASYNC, "async", ATTRIBUTE_TARGET(FUNCTION)) /* A coroutine returning a 'Task<T>' */          \
+	X(GENERATOR, "generator",                                                                      \
+	  ATTRIBUTE_TARGET(FUNCTION)) /* A coroutine 'yield'ing the values of a 'Generator<T>' */      \
+	X(AWAIT, "await", ATTRIBUTE_TARGET(CALL)) /* Suspend until the called task completes */        \
+	X(ARENA, "arena",                                                                              \
+	  ATTRIBUTE_TARGET(BLOCK)) /* Allocate the block's arrays and strings from an arena */
+
+/**
+ * Used to identify attributes. They are stored as a bitset in the flags of the node they apply to.
+ */
+enum Attributes {
+#define ATTRIBUTE_ENUM_ENTRY(name, string, targets) ATTRIBUTE_##name,
+	ATTRIBUTES(ATTRIBUTE_ENUM_ENTRY)
+#undef ATTRIBUTE_ENUM_ENTRY
+};
+
+/**
+ * Contains the names of each of the attributes.
+ */
+extern const struct Array g_ATTRIBUTE_NAMES;
+
+/**
+ * Gets the name of an attribute.
+ *
+ * @param ATTRIBUTE The attribute.
+ *
+ * @return The name of the attribute.
+ */
+const char* attribute_get_name(
+	const enum Attributes ATTRIBUTE); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Applies an attribute to a node, erroring if it is unknown or cannot be applied to that node.
+ *
+ * @param p_filePath The path of the file containing the node, for diagnostics.
+ * @param p_ast      The AST containing the node.
+ * @param node       The node the attribute precedes.
+ * @param p_name     The attribute's name, without the '@'.
+ */
+void attributes_apply(const char* p_filePath, struct FlatAST* p_ast, flat_ast_index_t node,
+					  const char* p_name);
+
+/**
+ * Checks whether an attribute has been applied to a node.
+ *
+ * @param p_ast     The AST containing the node.
+ * @param node      The node.
+ * @param ATTRIBUTE The attribute.
+ *
+ * @return Whether the node has the attribute.
+ */
+bool attributes_has(
+	const struct FlatAST* p_ast, flat_ast_index_t node,
+	const enum Attributes ATTRIBUTE); // NOLINT(readability-avoid-const-params-in-decls)
@@ -0,0 +1,159 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./cache.h"
+#include "../utils/files.h"
+#include "../utils/panic.h"
+#include "../utils/sha256.h"
+#include "../utils/str.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define CACHE_PATH_SEPARATOR "\\"
+#else
+#define CACHE_PATH_SEPARATOR "/"
+#endif
+
+#define CACHE_FAN_OUT_LENGTH 2U // Entries are spread over sub-directories named by the key prefix.
+
+char* cache_default_directory(void) {
+#ifdef _WIN32
+	const char* lp_localAppData = getenv("LOCALAPPDATA"); // NOLINT(concurrency-mt-unsafe)
+
+	return lp_localAppData ? CONCATENATE_STRING(lp_localAppData, CACHE_PATH_SEPARATOR "exeme")
+						   : NULL;
+#else
+	const char* lp_xdgCacheHome = getenv("XDG_CACHE_HOME"); // NOLINT(concurrency-mt-unsafe)
+
+	if (lp_xdgCacheHome && *lp_xdgCacheHome) {
+		return CONCATENATE_STRING(lp_xdgCacheHome, CACHE_PATH_SEPARATOR "exeme");
+	}
+
+	const char* lp_home = getenv("HOME"); // NOLINT(concurrency-mt-unsafe)
+
+	return lp_home && *lp_home ? CONCATENATE_STRING(lp_home, CACHE_PATH_SEPARATOR ".cache"
+																   CACHE_PATH_SEPARATOR "exeme")
+							   : NULL;
+#endif
+}
+
+struct Cache* cache_new(const char* p_directory) {
+	char* lp_directory = p_directory && *p_directory ? duplicate_string(p_directory)
+													 : cache_default_directory();
+
+	if (!lp_directory) {
+		return NULL;
+	}
+
+	if (!directory_create(lp_directory)) { // A read-only home should not stop compilation
+		free(lp_directory);
+
+		return NULL;
+	}
+
+	struct Cache* lp_self = malloc(CACHE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Cache struct");
+	}
+
+	lp_self->directory = lp_directory;
+
+	return lp_self;
+}
+
+void cache_free(struct Cache** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->directory);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Cache struct has already been freed");
+	}
+}
+
+char* cache_module_key(const char* p_filePath, const char* p_compilerVersion, const char* p_flags,
+					   const struct Array* p_importInterfaceHashes) {
+	size_t sourceLength = 0;
+	char*  lp_source	= file_read(p_filePath, &sourceLength);
+
+	if (!lp_source) {
+		return NULL;
+	}
+
+	struct Sha256* lp_hasher = sha256_new();
+
+	sha256_update_str(lp_hasher, "exeme-cache-v" CACHE_FORMAT_VERSION);
+	sha256_update_str(lp_hasher, p_compilerVersion);
+	sha256_update_str(lp_hasher, p_flags);
+	sha256_update(lp_hasher, &sourceLength, sizeof(sourceLength)); // Length-prefix the source
+	sha256_update(lp_hasher, lp_source, sourceLength);
+
+	if (p_importInterfaceHashes) {
+		for (size_t index = 0; index < p_importInterfaceHashes->length; index++) {
+			sha256_update_str(lp_hasher, p_importInterfaceHashes->_values[index]);
+		}
+	}
+
+	char* lp_key = sha256_hex_digest(lp_hasher);
+
+	sha256_free(&lp_hasher);
+	free(lp_source);
+
+	return lp_key;
+}
+
+/**
+ * Gets the directory of a cache entry.
+ *
+ * @param p_self The current Cache struct.
+ * @param p_key  The key of the entry.
+ *
+ * @return The directory of the entry.
+ */
+char* cache___entry_directory(struct Cache* p_self, const char* p_key) {
+	char fanOut[CACHE_FAN_OUT_LENGTH + 1] = {p_key[0], p_key[1], '\0'};
+
+	return CONCATENATE_STRING(p_self->directory, CACHE_PATH_SEPARATOR, fanOut,
+							  CACHE_PATH_SEPARATOR, p_key);
+}
+
+char* cache_artifact_path(struct Cache* p_self, const char* p_key, const char* p_artifact) {
+	char* lp_entryDirectory = cache___entry_directory(p_self, p_key);
+	char* lp_path = CONCATENATE_STRING(lp_entryDirectory, CACHE_PATH_SEPARATOR, p_artifact);
+
+	free(lp_entryDirectory);
+
+	return lp_path;
+}
+
+char* cache_load(struct Cache* p_self, const char* p_key, const char* p_artifact,
+				 size_t* p_length) {
+	char* lp_path	  = cache_artifact_path(p_self, p_key, p_artifact);
+	char* lp_artifact = file_read(lp_path, p_length);
+
+	free(lp_path);
+
+	return lp_artifact;
+}
+
+bool cache_store(struct Cache* p_self, const char* p_key, const char* p_artifact,
+				 const void* p_data, size_t length) {
+	char* lp_entryDirectory = cache___entry_directory(p_self, p_key);
+	bool  stored			= false;
+
+	if (directory_create(lp_entryDirectory)) {
+		char* lp_path = cache_artifact_path(p_self, p_key, p_artifact);
+
+		stored = file_write_atomic(lp_path, p_data, length);
+
+		free(lp_path);
+	}
+
+	free(lp_entryDirectory);
+
+	return stored;
+}
@@ -0,0 +1,108 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../utils/array.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define CACHE_FORMAT_VERSION "2" // Bump whenever the layout of cached artifacts changes.
+
+#define CACHE_ARTIFACT_IR			"module.ll"		 // The LLVM IR generated for the module.
+#define CACHE_ARTIFACT_INTERFACE	"module.exmi"	 // The module's serialised interface.
+#define CACHE_ARTIFACT_REPORT		"module.report"	 // The reports made generating the IR.
+#define CACHE_ARTIFACT_THIN_BITCODE "module.thin.bc" // The module's bitcode, with its summary.
+#define CACHE_ARTIFACT_FULL_BITCODE "module.full.bc" // The module's bitcode, for full LTO.
+#define CACHE_ARTIFACT_OBJECT		"module.o"		 // The module's object, without LTO.
+
+/**
+ * Represents the persistent compilation cache. Entries are keyed by a hash of everything that can
+ * change a module's output, so an entry never has to be invalidated - a changed module simply gets
+ * a new key. Each entry is a directory holding the artifacts produced when compiling the module.
+ */
+struct Cache {
+	char* directory; // The root directory of the cache.
+};
+
+#define CACHE_STRUCT_SIZE sizeof(struct Cache)
+
+/**
+ * Gets the default cache directory: '$XDG_CACHE_HOME/exeme', falling back to '~/.cache/exeme'
+ * (or '%LOCALAPPDATA%\exeme' on Windows).
+ *
+ * @return The default cache directory, or NULL if the home directory is unknown.
+ */
+char* cache_default_directory(void);
+
+/**
+ * Creates a new Cache struct, creating the cache directory if needed.
+ *
+ * @param p_directory The cache directory. If empty or NULL, the default cache directory is used.
+ *
+ * @return The created Cache struct, or NULL if the cache directory is not usable.
+ */
+struct Cache* cache_new(const char* p_directory);
+
+/**
+ * Frees a Cache struct.
+ *
+ * @param p_self The current Cache struct.
+ */
+void cache_free(struct Cache** p_self);
+
+/**
+ * Computes the cache key of a module. The key is a SHA-256 hash of the module's source, the
+ * compiler version, the compiler flags and the interface hashes of the modules it imports - so a
+ * module is only rebuilt when its own source changes, or the public interface of an import does.
+ *
+ * @param p_filePath              The path of the module's source file.
+ * @param p_compilerVersion       The version of the compiler.
+ * @param p_flags                 The flags affecting compilation, as a single string.
+ * @param p_importInterfaceHashes The interface hashes of the imported modules (can be NULL).
+ *
+ * @return The hexadecimal key, or NULL if the source file could not be read.
+ */
+char* cache_module_key(const char* p_filePath, const char* p_compilerVersion, const char* p_flags,
+					   const struct Array* p_importInterfaceHashes);
+
+/**
+ * Gets the path of an artifact in a cache entry.
+ *
+ * @param p_self     The current Cache struct.
+ * @param p_key      The key of the entry.
+ * @param p_artifact The name of the artifact.
+ *
+ * @return The path of the artifact.
+ */
+char* cache_artifact_path(struct Cache* p_self, const char* p_key, const char* p_artifact);
+
+/**
+ * Loads an artifact from the cache.
+ *
+ * @param p_self     The current Cache struct.
+ * @param p_key      The key of the entry.
+ * @param p_artifact The name of the artifact.
+ * @param p_length   Where to write the length of the artifact (can be NULL).
+ *
+ * @return The contents of the artifact, or NULL on a cache miss.
+ */
+char* cache_load(struct Cache* p_self, const char* p_key, const char* p_artifact,
+				 size_t* p_length);
+
+/**
+ * Stores an artifact in the cache. Artifacts are published atomically, so concurrent builds
+ * sharing the cache never see a partially written artifact.
+ *
+ * @param p_self     The current Cache struct.
+ * @param p_key      The key of the entry.
+ * @param p_artifact The name of the artifact.
+ * @param p_data     The contents of the artifact.
+ * @param length     The length of the contents.
+ *
+ * @return Whether the artifact was stored.
+ */
+bool cache_store(struct Cache* p_self, const char* p_key, const char* p_artifact,
+				 const void* p_data, size_t length);
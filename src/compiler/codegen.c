@@ -0,0 +1,3956 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./codegen.h"
+#include "./attributes.h"
+#include "./compiler.h"
+#include "./diagnostics.h"
+#include "../globals.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CODEGEN_NAME_LENGTH		 64U
+#define CODEGEN_SYMBOL_LENGTH	 (CODEGEN_OPERAND_LENGTH + 16U) // Quoted, e.g. '@"fib.uncached"'.
+
+// The runtime's types and the functions programs call, as defined by 'std.ll'
+static const char* const g_CODEGEN_PRELUDE =
+	"%str = type { i8*, i64, i64 }\n"
+	"%array = type { i8*, i64, i64 }\n"
+	"%mem.arena = type { i8*, i8*, i8*, %mem.arena* }\n"
+	"%memo = type { i64*, i8*, i64, i64, i64*, i64, i64, i64, i64, i64 }\n\n"
+	"declare void @str_SEP___init_empty__(%str*)\n"
+	"declare void @str_SEP___init_bytes__(%str*, i8*, i64)\n"
+	"declare void @str_SEP_clone(%str*, %str*)\n"
+	"declare void @str_SEP___del__(%str*)\n"
+	"declare i64 @str_SEP_length(%str*)\n"
+	"declare i8* @str_SEP_data(%str*)\n"
+	"declare void @str_SEP_append(%str*, %str*)\n"
+	"declare void @str_SEP_append_bytes(%str*, i8*, i64)\n"
+	"declare void @str_SEP_append_i64(%str*, i64)\n"
+	"declare void @str_SEP_append_u64(%str*, i64)\n"
+	"declare void @str_SEP_from_i64(%str*, i64)\n"
+	"declare void @str_SEP_from_u64(%str*, i64)\n"
+	"declare i32 @str_SEP_compare(%str*, %str*)\n"
+	"declare void @array_SEP___init__(%array*)\n"
+	"declare void @array_SEP___del__(%array*)\n"
+	"declare i64 @array_SEP_length(%array*)\n"
+	"declare void @array_SEP_append(%array*, i8*, i64)\n"
+	"declare void @array_SEP_clone(%array*, %array*, i64, void (i8*, i8*)*)\n"
+	"declare i8* @array_SEP_get(%array*, i64, i64)\n"
+	"declare void @array_SEP_remove(%array*, i64, i64)\n"
+	"declare void @mem_SEP_Arena___init__(%mem.arena*)\n"
+	"declare void @mem_SEP_Arena___del__(%mem.arena*)\n"
+	"declare void @mem_SEP_Arena_SEP_enter(%mem.arena*)\n"
+	"declare void @mem_SEP_Arena_SEP_leave(%mem.arena*)\n"
+	"declare void @io_SEP_out(%str*)\n"
+	"declare void @io_SEP_out_i64(i64)\n"
+	"declare void @io_SEP_out_u64(i64)\n"
+	"declare void @io_SEP_out_f32(float)\n"
+	"declare void @io_SEP_out_f64(double)\n"
+	"declare void @io_SEP_flush()\n"
+	"declare void @io_SEP_spawn(i8*)\n"
+	"declare i8* @io_SEP_sleep(i64)\n"
+	"declare void @io_SEP_complete(i8*)\n"
+	"declare void @io_SEP_run()\n"
+	"declare i1 @memo_SEP_find(%memo*, i64*, i64*)\n"
+	"declare void @memo_SEP_insert(%memo*, i64*, i64)\n"
+	"declare void @panic_SEP_division_by_zero()\n"
+	"declare void @task_SEP_for(i64, i64, void (i8*, i64, i64, i8*)*, i8*)\n"
+	"declare void @task_SEP_reduce(i64, i64, void (i8*, i64, i64, i8*)*, i8*, i8*, i64, "
+	"void (i8*, i8*)*, i8*)\n"
+	"declare noalias i8* @malloc(i64)\n"
+	"declare void @free(i8*)\n"
+	"declare float @llvm.floor.f32(float)\n"
+	"declare double @llvm.floor.f64(double)\n\n";
+
+struct Codegen* codegen_new(struct Compiler* p_compiler) {
+	struct Codegen* lp_self = calloc(1, CODEGEN_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Codegen struct");
+	}
+
+	const char* lp_name = strrchr(p_compiler->filePath, '/'); // e.g. 'shapes' of 'tests/shapes.exl'
+
+	lp_self->compiler  = p_compiler;
+	lp_self->module	   = duplicate_string(lp_name ? lp_name + 1 : p_compiler->filePath);
+	lp_self->instance  = MONO_INSTANCE_NONE;
+	lp_self->types	   = string_new("\0", true);
+	lp_self->globals   = string_new("\0", true);
+	lp_self->functions = string_new("\0", true);
+	lp_self->outlined  = string_new("\0", true);
+	lp_self->entry	   = string_new("\0", true);
+	lp_self->body	   = string_new("\0", true);
+
+	char* lp_extension = strrchr(lp_self->module, '.');
+
+	if (lp_extension && lp_extension > lp_self->module) {
+		*lp_extension = '\0';
+	}
+
+	return lp_self;
+}
+
+void codegen_free(struct Codegen** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->module);
+		string_free(&(*p_self)->types);
+		string_free(&(*p_self)->globals);
+		string_free(&(*p_self)->functions);
+		string_free(&(*p_self)->outlined);
+		string_free(&(*p_self)->entry);
+		string_free(&(*p_self)->body);
+		free((*p_self)->locals);
+		free((*p_self)->scopes);
+		free((*p_self)->arenas);
+		free((*p_self)->strings);
+		free((*p_self)->imported);
+		free((*p_self)->pending);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Codegen struct has already been freed");
+	}
+}
+
+/**
+ * Reports that a node cannot be lowered yet, and exits.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The node.
+ * @param p_what What is not supported, e.g. 'calls to generic functions'.
+ */
+__attribute__((noreturn)) void codegen___unsupported(const struct Codegen* p_self,
+													 flat_ast_index_t node, const char* p_what) {
+	compiler_error(p_self->compiler->filePath, flat_ast_get(p_self->compiler->ast, node)->line,
+				   C0014, CONCATENATE_STRING(p_what, " are not supported by code generation yet"));
+}
+
+/**
+ * Gets the symbol of a function, qualified by its module's name, e.g. 'shapes::twice' for 'twice'.
+ * The functions of imported modules are declared qualified already.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_name   The function's name, e.g. 'twice', 'Square.area' or 'shapes::twice'.
+ * @param p_symbol Where to write the symbol, unquoted, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___symbol(const struct Codegen* p_self, const char* p_name, char* p_symbol) {
+	if (strstr(p_name, "::")) {
+		snprintf(p_symbol, CODEGEN_OPERAND_LENGTH, "%s", p_name);
+	} else {
+		snprintf(p_symbol, CODEGEN_OPERAND_LENGTH, "%s::%s", p_self->module, p_name);
+	}
+}
+
+/**
+ * Appends an instruction to the function being emitted.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_format The instruction's format, as for printf.
+ */
+__attribute__((format(printf, 2, 3))) void codegen___emit(struct Codegen* p_self,
+														  const char* p_format, ...) {
+	char	line[CODEGEN_LINE_LENGTH];
+	va_list lpArgs;
+
+	va_start(lpArgs, p_format);
+	vsnprintf(line, sizeof(line), p_format, lpArgs);
+	va_end(lpArgs);
+
+	string_append_str(p_self->body, "  ");
+	string_append_bytes(p_self->body, line, strlen(line));
+	string_append_chr(p_self->body, '\n');
+}
+
+/**
+ * Appends a terminator to the function being emitted, ending the current block.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_format The terminator's format, as for printf.
+ */
+__attribute__((format(printf, 2, 3))) void codegen___terminate(struct Codegen* p_self,
+															   const char* p_format, ...) {
+	char	line[CODEGEN_LINE_LENGTH];
+	va_list lpArgs;
+
+	va_start(lpArgs, p_format);
+	vsnprintf(line, sizeof(line), p_format, lpArgs);
+	va_end(lpArgs);
+
+	codegen___emit(p_self, "%s", line);
+	p_self->terminated = true;
+}
+
+/**
+ * Starts a block, falling through to it from the current block if it has no terminator.
+ *
+ * @param p_self  The current Codegen struct.
+ * @param p_label The block's label.
+ */
+void codegen___label(struct Codegen* p_self, const char* p_label) {
+	if (!p_self->terminated) {
+		codegen___emit(p_self, "br label %%%s", p_label);
+	}
+
+	string_append_str(p_self->body, p_label);
+	string_append_str(p_self->body, ":\n");
+	p_self->terminated = false;
+}
+
+/**
+ * Names a new temporary of the function being emitted, e.g. '%t.4'.
+ *
+ * @param p_self      The current Codegen struct.
+ * @param p_temporary Where to write the name, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___temporary(struct Codegen* p_self, char* p_temporary) {
+	snprintf(p_temporary, CODEGEN_OPERAND_LENGTH, "%%t.%zu", p_self->temporaries++);
+}
+
+/**
+ * Names the blocks of a new construct of the function being emitted, e.g. 'if.3'.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_prefix What the construct is, e.g. 'if'.
+ * @param p_label  Where to write the name, of CODEGEN_NAME_LENGTH.
+ */
+void codegen___label_name(struct Codegen* p_self, const char* p_prefix, char* p_label) {
+	snprintf(p_label, CODEGEN_NAME_LENGTH, "%s.%zu", p_prefix, p_self->labels++);
+}
+
+/**
+ * Adds an 'alloca' to the entry block of the function being emitted.
+ *
+ * @param p_self     The current Codegen struct.
+ * @param p_llvmType The allocated type.
+ * @param p_result   Where to write the pointer's name, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___alloca(struct Codegen* p_self, const char* p_llvmType, char* p_result) {
+	codegen___temporary(p_self, p_result);
+
+	string_append_str(p_self->entry, "  ");
+	string_append_str(p_self->entry, p_result);
+	string_append_str(p_self->entry, " = alloca ");
+	string_append_str(p_self->entry, p_llvmType);
+	string_append_chr(p_self->entry, '\n');
+}
+
+/**
+ * Gets a type of the function being emitted, with the type arguments of its instance substituted.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return The substituted type.
+ */
+type_id_t codegen___type(const struct Codegen* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE || p_self->params == TYPE_ID_NONE) {
+		return type;
+	}
+
+	return type_table_substitute(p_self->compiler->types, type, p_self->params, p_self->args);
+}
+
+/**
+ * Gets the inferred type of a node of the function being emitted.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The node.
+ *
+ * @return The node's type.
+ */
+type_id_t codegen___node_type(const struct Codegen* p_self, flat_ast_index_t node) {
+	return codegen___type(p_self, inference_get_node_type(p_self->compiler->inference, node));
+}
+
+/**
+ * Gets the primitive of a type.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return The primitive, or TYPE_PRIMITIVE_COUNT if the type is not a primitive.
+ */
+enum TypePrimitives codegen___primitive(const struct Codegen* p_self, type_id_t type) {
+	const struct Type* lp_type = type_table_get(p_self->compiler->types, type);
+
+	return lp_type->kind == TYPE_PRIMITIVE ? (enum TypePrimitives)lp_type->primitive
+										   : TYPE_PRIMITIVE_COUNT;
+}
+
+/**
+ * Checks whether a type is a floating point primitive.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return Whether the type is 'f32' or 'f64'.
+ */
+bool codegen___is_float(const struct Codegen* p_self, type_id_t type) {
+	enum TypePrimitives primitive = codegen___primitive(p_self, type);
+
+	return primitive == TYPE_PRIMITIVE_F32 || primitive == TYPE_PRIMITIVE_F64;
+}
+
+/**
+ * Checks whether a type is a signed integer primitive.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return Whether the type is 'i8', 'i16', 'i32' or 'i64'.
+ */
+bool codegen___is_signed(const struct Codegen* p_self, type_id_t type) {
+	enum TypePrimitives primitive = codegen___primitive(p_self, type);
+
+	return primitive >= TYPE_PRIMITIVE_I8 && primitive <= TYPE_PRIMITIVE_I64;
+}
+
+/**
+ * Checks whether a type is the runtime's 'Array<T>'.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return Whether the type is an array.
+ */
+bool codegen___is_array(const struct Codegen* p_self, type_id_t type) {
+	const struct Type* lp_type = type_table_get(p_self->compiler->types, type);
+
+	return lp_type->kind == TYPE_NAMED && lp_type->argCount == 1
+		   && strcmp(interner_get(p_self->compiler->interner, lp_type->name), "Array") == 0;
+}
+
+/**
+ * Checks whether a type is the handle of a coroutine, a 'Task<T>' or a 'Generator<T>'.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return Whether the type is a coroutine's handle.
+ */
+bool codegen___is_handle(const struct Codegen* p_self, type_id_t type) {
+	const struct Type* lp_type = type_table_get(p_self->compiler->types, type);
+
+	if (lp_type->kind != TYPE_NAMED || lp_type->argCount != 1) {
+		return false;
+	}
+
+	const char* lp_name = interner_get(p_self->compiler->interner, lp_type->name);
+
+	return strcmp(lp_name, CORO_TASK_TYPE) == 0 || strcmp(lp_name, CORO_GENERATOR_TYPE) == 0;
+}
+
+/**
+ * Checks whether values of a type are held by value, and passed around as pointers to them:
+ * strings and arrays.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ *
+ * @return Whether the type is held by value.
+ */
+bool codegen___by_value(const struct Codegen* p_self, type_id_t type) {
+	return codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR
+		   || codegen___is_array(p_self, type);
+}
+
+/**
+ * Gets the binding of the struct or trait a type names.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The type.
+ * @param kind   The kind of binding, SYMBOL_STRUCT or SYMBOL_TRAIT.
+ *
+ * @return The binding, or SYMBOL_BINDING_NONE if the type does not name one.
+ */
+uint32_t codegen___declaration(const struct Codegen* p_self, type_id_t type,
+							   enum SymbolKinds kind) {
+	const struct Type* lp_type = type_table_get(p_self->compiler->types, type);
+
+	if (lp_type->kind != TYPE_NAMED) {
+		return SYMBOL_BINDING_NONE;
+	}
+
+	uint32_t binding = symbol_table_resolve(p_self->compiler->symbols, lp_type->name);
+
+	if (binding == SYMBOL_BINDING_NONE
+		|| symbol_table_get(p_self->compiler->symbols, binding)->kind != kind) {
+		return SYMBOL_BINDING_NONE;
+	}
+
+	return binding;
+}
+
+/**
+ * Queues a struct type for declaration, as its LLVM type is used.
+ *
+ * @param p_self The current Codegen struct.
+ * @param type   The struct's type.
+ */
+void codegen___use_struct(struct Codegen* p_self, type_id_t type) {
+	if (layout_find(p_self->compiler->layouts, type) != LAYOUT_NONE) {
+		return;
+	}
+
+	for (size_t index = 0; index < p_self->pendingCount; index++) {
+		if (p_self->pending[index] == type) {
+			return;
+		}
+	}
+
+	p_self->pending = buffer_grow(p_self->pending, &p_self->pendingCapacity,
+								  p_self->pendingCount + 1, sizeof(type_id_t));
+	p_self->pending[p_self->pendingCount++] = type;
+}
+
+void codegen___storage_type(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+							char* p_output);
+uint32_t codegen___trait(struct Codegen* p_self, flat_ast_index_t node, type_id_t type);
+
+/**
+ * Gets the LLVM type of values of a type, e.g. 'i32', '%str*', '%"Stack<i32>"*' or, for trait
+ * objects, '%"Shape<i32>.dyn"'.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The node the type is used by, for diagnostics.
+ * @param type     The type, with no type parameters left.
+ * @param p_output Where to write the LLVM type, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___llvm_type(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+						 char* p_output) {
+	static const char* const lp_PRIMITIVES[] = {"void", "i1",  "i8",	"i16",	  "i32",
+												"i64",	"i8",  "i16",	"i32",	  "i64",
+												"float", "double", "i8", "%str*"};
+	const struct Type*		 lp_type		 = type_table_get(p_self->compiler->types, type);
+
+	if (lp_type->flags & (TYPE_FLAG_GENERIC | TYPE_FLAG_VARIABLE)) {
+		char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("values of the unresolved type '", lp_name, "'"));
+	}
+
+	switch (lp_type->kind) {
+	case TYPE_PRIMITIVE:
+		snprintf(p_output, CODEGEN_OPERAND_LENGTH, "%s", lp_PRIMITIVES[lp_type->primitive]);
+		return;
+	case TYPE_FUNCTION: {
+		const type_id_t* lp_args = type_table_get_args(p_self->compiler->types, type);
+		char			 element[CODEGEN_OPERAND_LENGTH];
+
+		codegen___storage_type(p_self, node, lp_args[lp_type->argCount - 1], p_output);
+		strncat(p_output, " (", CODEGEN_OPERAND_LENGTH - strlen(p_output) - 1);
+
+		for (uint32_t index = 0; index + 1 < lp_type->argCount; index++) {
+			codegen___llvm_type(p_self, node, lp_args[index], element);
+			strncat(p_output, index ? ", " : "", CODEGEN_OPERAND_LENGTH - strlen(p_output) - 1);
+			strncat(p_output, element, CODEGEN_OPERAND_LENGTH - strlen(p_output) - 1);
+		}
+
+		strncat(p_output, ")*", CODEGEN_OPERAND_LENGTH - strlen(p_output) - 1);
+		return;
+	}
+	case TYPE_NAMED:
+		if (codegen___is_array(p_self, type)) {
+			snprintf(p_output, CODEGEN_OPERAND_LENGTH, "%%array*");
+			return;
+		}
+
+		if (codegen___is_handle(p_self, type)) { // Points to the coroutine's frame
+			snprintf(p_output, CODEGEN_OPERAND_LENGTH, "i8*");
+			return;
+		}
+
+		if (codegen___declaration(p_self, type, SYMBOL_STRUCT) != SYMBOL_BINDING_NONE) {
+			char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+			snprintf(p_output, CODEGEN_OPERAND_LENGTH, "%%\"%s\"*", lp_name);
+			codegen___use_struct(p_self, type);
+			free(lp_name);
+
+			return;
+		}
+
+		if (codegen___declaration(p_self, type, SYMBOL_TRAIT) != SYMBOL_BINDING_NONE) {
+			char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+			codegen___trait(p_self, node, type);
+			snprintf(p_output, CODEGEN_OPERAND_LENGTH, "%%\"%s.dyn\"", lp_name); // Fat pointers
+			free(lp_name);
+
+			return;
+		}
+		break;
+	case TYPE_VECTOR:
+		simd_lowering_llvm_type(p_self->compiler->types, type, p_output);
+		return;
+	default:
+		break;
+	}
+
+	char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+	codegen___unsupported(p_self, node, CONCATENATE_STRING("values of type '", lp_name, "'"));
+}
+
+/**
+ * Gets the LLVM type locals, fields and elements of a type are stored as, e.g. '%str' for strings,
+ * which are held by value.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The node the type is used by, for diagnostics.
+ * @param type     The type, with no type parameters left.
+ * @param p_output Where to write the LLVM type, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___storage_type(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+							char* p_output) {
+	codegen___llvm_type(p_self, node, type, p_output);
+
+	if (codegen___by_value(p_self, type)) {
+		p_output[strlen(p_output) - 1] = '\0'; // Without the '*'
+	}
+}
+
+/**
+ * Writes the size of an LLVM type as a constant expression, for the runtime's arrays.
+ *
+ * @param p_llvmType The LLVM type.
+ * @param p_output   Where to write the size, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___size_of(const char* p_llvmType, char* p_output) {
+	snprintf(p_output, CODEGEN_OPERAND_LENGTH,
+			 "ptrtoint (%s* getelementptr (%s, %s* null, i32 1) to i64)", p_llvmType, p_llvmType,
+			 p_llvmType);
+}
+
+/**
+ * Opens a scope of the symbol table binding the type parameters of a struct or trait to the type
+ * arguments of an instance, e.g. 'T' to 'i32' for 'Stack<i32>', to read its annotations.
+ *
+ * @param p_self      The current Codegen struct.
+ * @param declaration The struct's or trait's generic type, e.g. 'Stack<T>'.
+ * @param instance    The instance, e.g. 'Stack<i32>'.
+ */
+void codegen___bind_parameters(struct Codegen* p_self, type_id_t declaration, type_id_t instance) {
+	struct Compiler* lp_compiler = p_self->compiler;
+	uint32_t		 paramCount	 = type_table_get(lp_compiler->types, declaration)->argCount;
+
+	symbol_table_push_scope(lp_compiler->symbols);
+
+	for (uint32_t index = 0; index < paramCount; index++) {
+		type_id_t param = type_table_get_args(lp_compiler->types, declaration)[index];
+		uint32_t  bound = symbol_table_declare(
+			 lp_compiler->symbols, type_table_get(lp_compiler->types, param)->name,
+			 SYMBOL_TYPE_PARAMETER, FLATAST_INDEX_NONE);
+
+		symbol_table_get(lp_compiler->symbols, bound)->type =
+			type_table_get_args(lp_compiler->types, instance)[index];
+	}
+}
+
+/**
+ * Declares a trait, or an instance of a generic trait, emitting the LLVM types of its vtables and
+ * trait objects. Its methods' types are its declaration's annotations, with its type parameters
+ * bound to the instance's type arguments, and their receiver erased.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The node the trait is used by, for diagnostics.
+ * @param type   The trait's type, e.g. 'Shape<i32>'.
+ *
+ * @return The index of the trait.
+ */
+uint32_t codegen___trait(struct Codegen* p_self, flat_ast_index_t node, type_id_t type) {
+	struct Compiler* lp_compiler = p_self->compiler;
+	uint32_t		 trait		 = vtable_table_find_trait(lp_compiler->vtables, type);
+
+	if (trait != VTABLE_TRAIT_NONE) {
+		return trait;
+	}
+
+	struct SymbolBinding declaration = *symbol_table_get(
+		lp_compiler->symbols, codegen___declaration(p_self, type, SYMBOL_TRAIT));
+	const struct FlatASTNode* lp_trait = flat_ast_get(lp_compiler->ast, declaration.declaration);
+	size_t					  count	   = lp_trait->value.list.length;
+	struct VtableMethod*	  lp_methods = calloc(count ? count : 1, VTABLE_METHOD_SIZE);
+
+	if (!lp_methods) {
+		PANIC("failed to malloc Codegen trait methods");
+	}
+
+	codegen___bind_parameters(p_self, declaration.type, type);
+
+	for (size_t index = 0; index < count; index++) {
+		const struct FlatASTNode* lp_field = flat_ast_get(
+			lp_compiler->ast, flat_ast_get_list_item(lp_compiler->ast, lp_trait, index));
+		const struct FlatASTNode* lp_function = flat_ast_get(lp_compiler->ast, lp_field->lhs);
+		struct String*			  lp_params	  = string_new("\0", true);
+		type_id_t result = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+		char	  llvmType[CODEGEN_OPERAND_LENGTH];
+
+		for (size_t param = 1; param < lp_function->value.list.length; param++) { // After 'Self'
+			flat_ast_index_t annotation =
+				flat_ast_get(lp_compiler->ast,
+							 flat_ast_get_list_item(lp_compiler->ast, lp_function, param))
+					->lhs;
+
+			codegen___llvm_type(
+				p_self, node,
+				inference_annotation(lp_compiler->inference, lp_compiler->ast, annotation),
+				llvmType);
+			string_append_str(lp_params, param > 1 ? ", " : "");
+			string_append_str(lp_params, llvmType);
+		}
+
+		if (lp_function->lhs != FLATAST_INDEX_NONE) {
+			result = inference_annotation(lp_compiler->inference, lp_compiler->ast,
+										  lp_function->lhs);
+		}
+
+		codegen___storage_type(p_self, node, result, llvmType);
+
+		lp_methods[index].name		 = interner_intern(
+			  lp_compiler->interner, flat_ast_get_string(lp_compiler->ast, lp_field->value.string));
+		lp_methods[index].returnType = interner_intern(lp_compiler->interner, llvmType);
+		lp_methods[index].paramTypes = interner_intern(lp_compiler->interner, lp_params->_value);
+
+		string_free(&lp_params);
+	}
+
+	symbol_table_pop_scope(lp_compiler->symbols);
+
+	trait = vtable_table_declare_trait(lp_compiler->vtables, type, lp_methods, count,
+									   p_self->types);
+
+	free(lp_methods);
+
+	return trait;
+}
+
+/**
+ * Declares a struct, or an instance of a generic struct, emitting its LLVM type. Its fields'
+ * types are its declaration's annotations, with its type parameters bound to the instance's type
+ * arguments.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The node the struct is used by, for diagnostics.
+ * @param type   The struct's type, e.g. 'Stack<i32>'.
+ *
+ * @return The index of the struct's layout.
+ */
+uint32_t codegen___struct(struct Codegen* p_self, flat_ast_index_t node, type_id_t type) {
+	struct Compiler* lp_compiler = p_self->compiler;
+	uint32_t		 layout		 = layout_find(lp_compiler->layouts, type);
+
+	if (layout != LAYOUT_NONE) {
+		return layout;
+	}
+
+	uint32_t binding = codegen___declaration(p_self, type, SYMBOL_STRUCT);
+
+	if (binding == SYMBOL_BINDING_NONE) {
+		PANIC("Codegen can only declare structs");
+	}
+
+	struct SymbolBinding	  declaration = *symbol_table_get(lp_compiler->symbols, binding);
+	const struct FlatASTNode* lp_struct	  = flat_ast_get(lp_compiler->ast, declaration.declaration);
+	struct LayoutField*		  lp_fields =
+		calloc(lp_struct->value.list.length ? lp_struct->value.list.length : 1, LAYOUT_FIELD_SIZE);
+
+	if (!lp_fields) {
+		PANIC("failed to malloc Codegen struct fields");
+	}
+
+	codegen___bind_parameters(p_self, declaration.type, type);
+
+	for (size_t index = 0; index < lp_struct->value.list.length; index++) {
+		const struct FlatASTNode* lp_field = flat_ast_get(
+			lp_compiler->ast, flat_ast_get_list_item(lp_compiler->ast, lp_struct, index));
+		char llvmType[CODEGEN_OPERAND_LENGTH];
+
+		lp_fields[index].name = interner_intern(
+			lp_compiler->interner, flat_ast_get_string(lp_compiler->ast, lp_field->value.string));
+		lp_fields[index].type =
+			inference_annotation(lp_compiler->inference, lp_compiler->ast, lp_field->lhs);
+
+		codegen___storage_type(p_self, node, lp_fields[index].type, llvmType);
+		lp_fields[index].llvmType = interner_intern(lp_compiler->interner, llvmType);
+	}
+
+	symbol_table_pop_scope(lp_compiler->symbols);
+
+	layout = layout_declare(lp_compiler->layouts, lp_compiler->ast, declaration.declaration, type,
+							lp_fields, lp_struct->value.list.length, p_self->types);
+
+	free(lp_fields);
+
+	return layout;
+}
+
+/**
+ * Finds a local in scope.
+ *
+ * @param p_self The current Codegen struct.
+ * @param name   The interned name of the local.
+ *
+ * @return The local, or NULL if no local of that name is in scope.
+ */
+const struct CodegenLocal* codegen___find_local(const struct Codegen* p_self, intern_id_t name) {
+	for (size_t index = p_self->localCount; index > 0; index--) {
+		if (p_self->locals[index - 1].name == name) {
+			return &p_self->locals[index - 1];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Writes the name of a local's slot, e.g. '%count.12'.
+ *
+ * @param p_self  The current Codegen struct.
+ * @param p_local The local.
+ * @param p_slot  Where to write the name, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___slot(const struct Codegen* p_self, const struct CodegenLocal* p_local,
+					char* p_slot) {
+	snprintf(p_slot, CODEGEN_OPERAND_LENGTH, "%%%s.%" PRIu32,
+			 interner_get(p_self->compiler->interner, p_local->name), p_local->declaration);
+}
+
+/**
+ * Declares a local in the innermost scope, adding its slot to the entry block.
+ *
+ * @param p_self      The current Codegen struct.
+ * @param declaration The declaring node, holding the local's name.
+ * @param type        The local's type.
+ *
+ * @return The local.
+ */
+const struct CodegenLocal* codegen___declare_local(struct Codegen*  p_self,
+												   flat_ast_index_t declaration, type_id_t type) {
+	const struct FlatAST* lp_ast = p_self->compiler->ast;
+	char				  slot[CODEGEN_OPERAND_LENGTH];
+	char				  llvmType[CODEGEN_OPERAND_LENGTH];
+
+	p_self->locals = buffer_grow(p_self->locals, &p_self->localCapacity, p_self->localCount + 1,
+								 CODEGEN_LOCAL_SIZE);
+
+	struct CodegenLocal* lp_local = &p_self->locals[p_self->localCount++];
+
+	lp_local->name		  = interner_intern(
+		   p_self->compiler->interner,
+		   flat_ast_get_string(lp_ast, flat_ast_get(lp_ast, declaration)->value.string));
+	lp_local->declaration = declaration;
+	lp_local->type		  = type;
+
+	codegen___slot(p_self, lp_local, slot);
+	codegen___storage_type(p_self, declaration, type, llvmType);
+
+	string_append_str(p_self->entry, "  ");
+	string_append_str(p_self->entry, slot);
+	string_append_str(p_self->entry, " = alloca ");
+	string_append_str(p_self->entry, llvmType);
+	string_append_chr(p_self->entry, '\n');
+
+	return lp_local;
+}
+
+/**
+ * Opens a scope for locals.
+ *
+ * @param p_self The current Codegen struct.
+ */
+void codegen___push_scope(struct Codegen* p_self) {
+	p_self->scopes = buffer_grow(p_self->scopes, &p_self->scopeCapacity, p_self->scopeCount + 1,
+								 sizeof(size_t));
+	p_self->scopes[p_self->scopeCount++] = p_self->localCount;
+}
+
+/**
+ * Closes the innermost scope, forgetting its locals.
+ *
+ * @param p_self The current Codegen struct.
+ */
+void codegen___pop_scope(struct Codegen* p_self) {
+	p_self->localCount = p_self->scopes[--p_self->scopeCount];
+}
+
+/**
+ * Loads a value from where it is stored. Values held by value are their storage's address.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The node the value is for, for diagnostics.
+ * @param type      The value's type.
+ * @param p_pointer The storage's address.
+ * @param p_result  Where to write the value, of CODEGEN_OPERAND_LENGTH.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___load(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+					const char* p_pointer, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char llvmType[CODEGEN_OPERAND_LENGTH];
+
+	if (codegen___by_value(p_self, type)) {
+		snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%s", p_pointer);
+		return;
+	}
+
+	codegen___llvm_type(p_self, node, type, llvmType);
+	codegen___temporary(p_self, p_result);
+	codegen___emit(p_self, "%s = load %s, %s* %s", p_result, llvmType, llvmType, p_pointer);
+}
+
+/**
+ * Stores a value where values of its type are stored. Values held by value are copied.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The node the value is for, for diagnostics.
+ * @param type      The value's type.
+ * @param p_value   The value.
+ * @param p_pointer The storage's address.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___store(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+					 const char* p_value, const char* p_pointer) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char llvmType[CODEGEN_OPERAND_LENGTH];
+	char value[CODEGEN_OPERAND_LENGTH];
+
+	codegen___storage_type(p_self, node, type, llvmType);
+
+	if (codegen___by_value(p_self, type)) {
+		codegen___temporary(p_self, value);
+		codegen___emit(p_self, "%s = load %s, %s* %s", value, llvmType, llvmType, p_value);
+		p_value = value;
+	}
+
+	codegen___emit(p_self, "store %s %s, %s* %s", llvmType, p_value, llvmType, p_pointer);
+}
+
+/**
+ * Emits a string or an array getting where it is used, as the ownership pass decided: moved out of
+ * its local, cloned, or lent as it is. Other values are used as they are.
+ *
+ * @param p_self  The current Codegen struct.
+ * @param node    The value's node.
+ * @param type    The value's type.
+ * @param p_value The pointer to the value, replaced by the pointer to use, of
+ *                CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___transfer(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+						char* p_value) {
+	enum OwnershipTransfers transfer = ownership_get_transfer(p_self->compiler->ownership, node);
+	char				llvmType[CODEGEN_OPERAND_LENGTH];
+	char				slot[CODEGEN_OPERAND_LENGTH];
+
+	if (!codegen___by_value(p_self, type) || transfer == OWNERSHIP_NONE
+		|| transfer == OWNERSHIP_BORROW) {
+		return;
+	}
+
+	codegen___storage_type(p_self, node, type, llvmType);
+	codegen___alloca(p_self, llvmType, slot);
+	ownership_emit_transfer(p_self->compiler->ownership, node, p_value, slot, p_self->body,
+							p_self->globals);
+	snprintf(p_value, CODEGEN_OPERAND_LENGTH, "%s", slot);
+}
+
+/**
+ * Emits a string constant, once per distinct string.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_string The string.
+ * @param p_output Where to write a pointer to its first byte, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The length of the string.
+ */
+size_t codegen___string_constant(struct Codegen* p_self, const char* p_string, char* p_output) {
+	intern_id_t id	   = interner_intern(p_self->compiler->interner, p_string);
+	size_t		length = strlen(p_string);
+
+	p_self->strings =
+		buffer_grow(p_self->strings, &p_self->stringCapacity, (size_t)id + 1, sizeof(uint8_t));
+
+	if (!p_self->strings[id]) {
+		char line[CODEGEN_OPERAND_LENGTH];
+
+		// @.str.ID = private unnamed_addr constant [N x i8] c"...\00"
+		snprintf(line, sizeof(line),
+				 "@.str.%" PRIu32 " = private unnamed_addr constant [%zu x i8] c\"",
+				 id, length + 1);
+		string_append_str(p_self->globals, line);
+
+		for (size_t index = 0; index < length; index++) {
+			unsigned char chr = (unsigned char)p_string[index];
+
+			if (chr < ' ' || chr > '~' || chr == '"' || chr == '\\') {
+				snprintf(line, sizeof(line), "\\%02X", chr);
+				string_append_str(p_self->globals, line);
+			} else {
+				string_append_chr(p_self->globals, (char)chr);
+			}
+		}
+
+		string_append_str(p_self->globals, "\\00\"\n");
+		p_self->strings[id] = true;
+	}
+
+	snprintf(p_output, CODEGEN_OPERAND_LENGTH,
+			 "getelementptr inbounds ([%zu x i8], [%zu x i8]* @.str.%" PRIu32 ", i64 0, i64 0)",
+			 length + 1, length + 1, id);
+
+	return length;
+}
+
+/**
+ * Emits a new string holding some bytes.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_bytes  The pointer to the bytes.
+ * @param p_length The number of bytes.
+ * @param p_result Where to write the string, of CODEGEN_OPERAND_LENGTH.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___string(struct Codegen* p_self, const char* p_bytes, const char* p_length,
+					  char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	codegen___alloca(p_self, "%str", p_result);
+	codegen___emit(p_self, "call void @str_SEP___init_bytes__(%%str* %s, i8* %s, i64 %s)",
+				   p_result, p_bytes, p_length);
+}
+
+/**
+ * Converts an integer to another integer type.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The node the value is for, for diagnostics.
+ * @param from     The value's type.
+ * @param to       The type to convert it to.
+ * @param p_value  The value, overwritten with the converted value.
+ */
+void codegen___convert(struct Codegen* p_self, flat_ast_index_t node, type_id_t from, type_id_t to,
+					   char* p_value) {
+	char fromType[CODEGEN_OPERAND_LENGTH];
+	char toType[CODEGEN_OPERAND_LENGTH];
+	char result[CODEGEN_OPERAND_LENGTH];
+
+	codegen___llvm_type(p_self, node, from, fromType);
+	codegen___llvm_type(p_self, node, to, toType);
+
+	if (strcmp(fromType, toType) == 0) {
+		return;
+	}
+
+	int fromBits = atoi(fromType + 1);
+	int toBits	 = atoi(toType + 1);
+
+	codegen___temporary(p_self, result);
+	codegen___emit(p_self, "%s = %s %s %s to %s", result,
+				   fromBits > toBits				  ? "trunc"
+				   : codegen___is_signed(p_self, from) ? "sext"
+													  : "zext",
+				   fromType, p_value, toType);
+	snprintf(p_value, CODEGEN_OPERAND_LENGTH, "%s", result);
+}
+
+type_id_t codegen___expression(struct Codegen* p_self, flat_ast_index_t node, char* p_result);
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___coerce(struct Codegen* p_self, flat_ast_index_t node, type_id_t from, type_id_t to,
+					  char* p_value);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits a short-circuiting '&&' or '||'.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The operation's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___logical(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	bool					  isAnd	  = lp_node->operation == LEXERTOKENS_LOGICAL_AND;
+	char					  slot[CODEGEN_OPERAND_LENGTH];
+	char					  value[CODEGEN_OPERAND_LENGTH];
+	char					  rhs[CODEGEN_NAME_LENGTH];
+	char					  end[CODEGEN_NAME_LENGTH];
+
+	codegen___alloca(p_self, "i1", slot);
+	codegen___label_name(p_self, isAnd ? "and.rhs" : "or.rhs", rhs);
+	codegen___label_name(p_self, isAnd ? "and.end" : "or.end", end);
+
+	codegen___expression(p_self, lp_node->lhs, value);
+	codegen___emit(p_self, "store i1 %s, i1* %s", value, slot);
+	codegen___terminate(p_self, "br i1 %s, label %%%s, label %%%s", value, isAnd ? rhs : end,
+						isAnd ? end : rhs);
+
+	codegen___label(p_self, rhs);
+	codegen___expression(p_self, lp_node->rhs, value);
+	codegen___emit(p_self, "store i1 %s, i1* %s", value, slot);
+
+	codegen___label(p_self, end);
+	codegen___temporary(p_self, p_result);
+	codegen___emit(p_self, "%s = load i1, i1* %s", p_result, slot);
+}
+
+/**
+ * Emits the check before an integer division or remainder, which is undefined for a zero divisor:
+ * a zero panics, like an out of bounds index. Constant divisors are checked at compile time, so
+ * only the other ones cost a compare and a branch.
+ *
+ * @param p_self     The current Codegen struct.
+ * @param node       The operation's node, for diagnostics.
+ * @param p_llvmType The LLVM type of the operands.
+ * @param lanes      The lanes of a vector divisor, any of which may be zero, or 0 for a scalar.
+ * @param p_rhs      The divisor.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___check_divisor(struct Codegen* p_self, flat_ast_index_t node, const char* p_llvmType,
+							 uint32_t lanes, const char* p_rhs) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char zero[CODEGEN_OPERAND_LENGTH];
+	char panic[CODEGEN_NAME_LENGTH];
+	char divide[CODEGEN_NAME_LENGTH];
+
+	if (lanes == 0 && strcmp(p_rhs, "0") == 0) { // e.g. 'count / 0', with a variable dividend
+		compiler_error(p_self->compiler->filePath,
+					   flat_ast_get(p_self->compiler->ast, node)->line, C0005, "division by zero");
+	}
+
+	if (lanes == 0 && p_rhs[0] != '%') { // Any other constant
+		return;
+	}
+
+	codegen___temporary(p_self, zero);
+
+	if (lanes == 0) {
+		codegen___emit(p_self, "%s = icmp eq %s %s, 0", zero, p_llvmType, p_rhs);
+	} else { // Whether any lane is zero, from the bits of the lane by lane mask
+		char mask[CODEGEN_OPERAND_LENGTH];
+		char bits[CODEGEN_OPERAND_LENGTH];
+
+		codegen___temporary(p_self, mask);
+		codegen___temporary(p_self, bits);
+		codegen___emit(p_self, "%s = icmp eq %s %s, zeroinitializer", mask, p_llvmType, p_rhs);
+		codegen___emit(p_self, "%s = bitcast <%" PRIu32 " x i1> %s to i%" PRIu32, bits, lanes,
+					   mask, lanes);
+		codegen___emit(p_self, "%s = icmp ne i%" PRIu32 " %s, 0", zero, lanes, bits);
+	}
+
+	codegen___label_name(p_self, "divide.zero", panic);
+	codegen___label_name(p_self, "divide", divide);
+	codegen___terminate(p_self, "br i1 %s, label %%%s, label %%%s", zero, panic, divide);
+	codegen___label(p_self, panic);
+	codegen___emit(p_self, "call void @panic_SEP_division_by_zero()");
+	codegen___terminate(p_self, "unreachable");
+	codegen___label(p_self, divide);
+}
+
+/**
+ * Emits an arithmetic or bitwise operation on two values of the same primitive type. Adding strings
+ * concatenates them into a new string.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The operation's node, for diagnostics.
+ * @param OPERATION The operator.
+ * @param type      The type of the operands.
+ * @param p_lhs     The left operand.
+ * @param p_rhs     The right operand.
+ * @param p_result  Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___arithmetic(struct Codegen* p_self, flat_ast_index_t node,
+						  const enum LexerTokenIdentifiers OPERATION, type_id_t type,
+						  const char* p_lhs, const char* p_rhs, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	bool		isFloat	 = codegen___is_float(p_self, type);
+	bool		isSigned = codegen___is_signed(p_self, type);
+	const char* lp_instruction = NULL;
+	char		llvmType[CODEGEN_OPERAND_LENGTH];
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR
+		&& OPERATION == LEXERTOKENS_ADDITION) {
+		codegen___alloca(p_self, "%str", p_result);
+		codegen___emit(p_self, "call void @str_SEP_clone(%%str* %s, %%str* %s)", p_result, p_lhs);
+		codegen___emit(p_self, "call void @str_SEP_append(%%str* %s, %%str* %s)", p_result, p_rhs);
+
+		return;
+	}
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_COUNT
+		|| codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR) {
+		char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("operations on values of type '", lp_name, "'"));
+	}
+
+	codegen___llvm_type(p_self, node, type, llvmType);
+
+	if (!isFloat
+		&& (OPERATION == LEXERTOKENS_DIVISION || OPERATION == LEXERTOKENS_FLOOR_DIVISION
+			|| OPERATION == LEXERTOKENS_MODULO)) {
+		codegen___check_divisor(p_self, node, llvmType, 0, p_rhs);
+	}
+
+	switch (OPERATION) {
+	case LEXERTOKENS_ADDITION:
+		lp_instruction = isFloat ? "fadd" : "add";
+		break;
+	case LEXERTOKENS_SUBTRACTION:
+		lp_instruction = isFloat ? "fsub" : "sub";
+		break;
+	case LEXERTOKENS_MULTIPLICATION:
+		lp_instruction = isFloat ? "fmul" : "mul";
+		break;
+	case LEXERTOKENS_DIVISION:
+		lp_instruction = isFloat ? "fdiv" : isSigned ? "sdiv" : "udiv";
+		break;
+	case LEXERTOKENS_MODULO:
+		lp_instruction = isFloat ? "frem" : isSigned ? "srem" : "urem";
+		break;
+	case LEXERTOKENS_FLOOR_DIVISION:
+		if (isFloat) { // The quotient, rounded towards negative infinity
+			char quotient[CODEGEN_OPERAND_LENGTH];
+
+			codegen___temporary(p_self, quotient);
+			codegen___temporary(p_self, p_result);
+			codegen___emit(p_self, "%s = fdiv %s %s, %s", quotient, llvmType, p_lhs, p_rhs);
+			codegen___emit(p_self, "%s = call %s @llvm.floor.%s(%s %s)", p_result, llvmType,
+						   strcmp(llvmType, "float") == 0 ? "f32" : "f64", llvmType, quotient);
+
+			return;
+		}
+
+		if (isSigned) { // Rounds towards negative infinity, unlike 'sdiv'
+			char quotient[CODEGEN_OPERAND_LENGTH];
+			char remainder[CODEGEN_OPERAND_LENGTH];
+			char inexact[CODEGEN_OPERAND_LENGTH];
+			char signs[CODEGEN_OPERAND_LENGTH];
+			char negative[CODEGEN_OPERAND_LENGTH];
+			char adjust[CODEGEN_OPERAND_LENGTH];
+			char adjustment[CODEGEN_OPERAND_LENGTH];
+
+			codegen___temporary(p_self, quotient);
+			codegen___temporary(p_self, remainder);
+			codegen___temporary(p_self, inexact);
+			codegen___temporary(p_self, signs);
+			codegen___temporary(p_self, negative);
+			codegen___temporary(p_self, adjust);
+			codegen___temporary(p_self, adjustment);
+			codegen___temporary(p_self, p_result);
+			codegen___emit(p_self, "%s = sdiv %s %s, %s", quotient, llvmType, p_lhs, p_rhs);
+			codegen___emit(p_self, "%s = srem %s %s, %s", remainder, llvmType, p_lhs, p_rhs);
+			codegen___emit(p_self, "%s = icmp ne %s %s, 0", inexact, llvmType, remainder);
+			codegen___emit(p_self, "%s = xor %s %s, %s", signs, llvmType, remainder, p_rhs);
+			codegen___emit(p_self, "%s = icmp slt %s %s, 0", negative, llvmType, signs);
+			codegen___emit(p_self, "%s = and i1 %s, %s", adjust, inexact, negative);
+			codegen___emit(p_self, "%s = zext i1 %s to %s", adjustment, adjust, llvmType);
+			codegen___emit(p_self, "%s = sub %s %s, %s", p_result, llvmType, quotient,
+						   adjustment);
+
+			return;
+		}
+
+		lp_instruction = "udiv";
+		break;
+	case LEXERTOKENS_BITWISE_AND:
+		lp_instruction = "and";
+		break;
+	case LEXERTOKENS_BITWISE_OR:
+		lp_instruction = "or";
+		break;
+	case LEXERTOKENS_BITWISE_XOR:
+		lp_instruction = "xor";
+		break;
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+		lp_instruction = "shl";
+		break;
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+		lp_instruction = isSigned ? "ashr" : "lshr";
+		break;
+	default:
+		codegen___unsupported(
+			p_self, node,
+			CONCATENATE_STRING("'", lexer_tokens_get_name(OPERATION), "' operations"));
+	}
+
+	if (isFloat && OPERATION >= LEXERTOKENS_BITWISE_AND) {
+		codegen___unsupported(p_self, node, "bitwise operations on floats");
+	}
+
+	codegen___temporary(p_self, p_result);
+	codegen___emit(p_self, "%s = %s %s %s, %s", p_result, lp_instruction, llvmType, p_lhs, p_rhs);
+}
+
+/**
+ * Emits 'base ** exponent' through the power lowering: a chain of multiplications for a constant
+ * integer exponent, exponentiation by squaring for a variable one, and intrinsics for floats.
+ *
+ * @param p_self       The current Codegen struct.
+ * @param node         The operation's node, for diagnostics.
+ * @param baseType     The type of the base.
+ * @param p_base       The base.
+ * @param exponentType The type of the exponent.
+ * @param p_exponent   The exponent.
+ * @param exponent     The exponent's node, to recognise constants, or FLATAST_INDEX_NONE.
+ * @param p_result     Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___power(struct Codegen* p_self, flat_ast_index_t node, type_id_t baseType,
+					 const char* p_base, type_id_t exponentType, const char* p_exponent,
+					 flat_ast_index_t exponent, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	enum TypePrimitives base	 = codegen___primitive(p_self, baseType);
+	enum TypePrimitives power	 = codegen___primitive(p_self, exponentType);
+	const int64_t*		lp_value = NULL;
+
+	if (base < TYPE_PRIMITIVE_I8 || base > TYPE_PRIMITIVE_F64 || power < TYPE_PRIMITIVE_I8
+		|| power > TYPE_PRIMITIVE_F64) {
+		codegen___unsupported(p_self, node, "'**' operations on values that are not numbers");
+	}
+
+	if (codegen___is_float(p_self, exponentType) && !codegen___is_float(p_self, baseType)) {
+		codegen___unsupported(p_self, node, "'**' operations of integers with float exponents");
+	}
+
+	if (exponent != FLATAST_INDEX_NONE
+		&& flat_ast_get(p_self->compiler->ast, exponent)->kind == FLATAST_INTEGER) {
+		lp_value = &flat_ast_get(p_self->compiler->ast, exponent)->value.integer;
+	}
+
+	codegen___temporary(p_self, p_result);
+	power_lowering_emit(p_self->compiler->powers, base, p_base, power, p_exponent, lp_value,
+						p_result, p_self->body, p_self->globals);
+}
+
+/**
+ * Emits a comparison of two values of the same primitive type. Strings are compared by the
+ * runtime, byte by byte.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The comparison's node, for diagnostics.
+ * @param OPERATION The operator.
+ * @param type      The type of the operands.
+ * @param p_lhs     The left operand.
+ * @param p_rhs     The right operand.
+ * @param p_result  Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___compare(struct Codegen* p_self, flat_ast_index_t node,
+					   const enum LexerTokenIdentifiers OPERATION, type_id_t type,
+					   const char* p_lhs, const char* p_rhs, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	static const char* const lp_SIGNED[]   = {"eq", "ne", "sgt", "slt", "sge", "sle"};
+	static const char* const lp_UNSIGNED[] = {"eq", "ne", "ugt", "ult", "uge", "ule"};
+	static const char* const lp_FLOAT[]	   = {"oeq", "une", "ogt", "olt", "oge", "ole"};
+	size_t					 index		   = (size_t)(OPERATION - LEXERTOKENS_EQUAL_TO);
+	char					 llvmType[CODEGEN_OPERAND_LENGTH];
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR) {
+		char order[CODEGEN_OPERAND_LENGTH];
+
+		codegen___temporary(p_self, order);
+		codegen___emit(p_self, "%s = call i32 @str_SEP_compare(%%str* %s, %%str* %s)", order,
+					   p_lhs, p_rhs);
+		codegen___temporary(p_self, p_result);
+		codegen___emit(p_self, "%s = icmp %s i32 %s, 0", p_result, lp_SIGNED[index], order);
+
+		return;
+	}
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_COUNT) {
+		char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("comparisons of values of type '", lp_name, "'"));
+	}
+
+	codegen___llvm_type(p_self, node, type, llvmType);
+	codegen___temporary(p_self, p_result);
+
+	if (codegen___is_float(p_self, type)) {
+		codegen___emit(p_self, "%s = fcmp %s %s %s, %s", p_result, lp_FLOAT[index], llvmType,
+					   p_lhs, p_rhs);
+	} else {
+		codegen___emit(p_self, "%s = icmp %s %s %s, %s", p_result,
+					   codegen___is_signed(p_self, type) ? lp_SIGNED[index] : lp_UNSIGNED[index],
+					   llvmType, p_lhs, p_rhs);
+	}
+}
+
+/**
+ * Emits a lane by lane operation on two SIMD vectors through the SIMD lowering. Comparisons give
+ * a mask.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The operation's node, for diagnostics.
+ * @param OPERATION The operator.
+ * @param type      The vector type of the left operand.
+ * @param rhsType   The type of the right operand.
+ * @param p_lhs     The left operand.
+ * @param p_rhs     The right operand.
+ * @param p_result  Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+type_id_t codegen___vector_binary(struct Codegen* p_self, flat_ast_index_t node,
+								  const enum LexerTokenIdentifiers OPERATION, type_id_t type,
+								  type_id_t rhsType, const char* p_lhs, const char* p_rhs,
+								  char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	struct TypeTable*  lp_types	 = p_self->compiler->types;
+	const struct Type* lp_vector = type_table_get(lp_types, type);
+	type_id_t		   lane		 = TYPE_ID_PRIMITIVE(lp_vector->primitive);
+
+	if (rhsType != type) { // e.g. shifting a vector by a scalar
+		codegen___unsupported(p_self, node, "operations of vectors with other values");
+	}
+
+	if (!codegen___is_float(p_self, lane)
+		&& (OPERATION == LEXERTOKENS_DIVISION || OPERATION == LEXERTOKENS_MODULO)) {
+		char llvmType[SIMD_TYPE_LENGTH];
+
+		simd_lowering_llvm_type(lp_types, type, llvmType);
+		codegen___check_divisor(p_self, node, llvmType, lp_vector->name, p_rhs);
+	}
+
+	codegen___temporary(p_self, p_result);
+
+	if (OPERATION >= LEXERTOKENS_EQUAL_TO && OPERATION <= LEXERTOKENS_LESS_THAN_OR_EQUAL) {
+		simd_lowering_emit_compare(p_self->compiler->simd, type, OPERATION, p_lhs, p_rhs, p_result,
+								   p_self->body);
+
+		return type_table_vector(lp_types, TYPE_PRIMITIVE_BOOL, lp_vector->name);
+	}
+
+	switch (OPERATION) {
+	case LEXERTOKENS_ADDITION:
+	case LEXERTOKENS_SUBTRACTION:
+	case LEXERTOKENS_MULTIPLICATION:
+	case LEXERTOKENS_DIVISION:
+	case LEXERTOKENS_MODULO:
+		break;
+	case LEXERTOKENS_BITWISE_AND:
+	case LEXERTOKENS_BITWISE_OR:
+	case LEXERTOKENS_BITWISE_XOR:
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+		if (codegen___is_float(p_self, lane)) {
+			codegen___unsupported(p_self, node, "bitwise operations on floats");
+		}
+		break;
+	default:
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("'", lexer_tokens_get_name(OPERATION),
+												 "' operations on vectors"));
+	}
+
+	simd_lowering_emit_binary(p_self->compiler->simd, type, OPERATION, p_lhs, p_rhs, p_result,
+							  p_self->body);
+
+	return type;
+}
+
+/**
+ * Emits a binary operation.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The operation's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___binary(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	char					  lhs[CODEGEN_OPERAND_LENGTH];
+	char					  rhs[CODEGEN_OPERAND_LENGTH];
+
+	switch (lp_node->operation) {
+	case LEXERTOKENS_LOGICAL_AND:
+	case LEXERTOKENS_LOGICAL_OR:
+		codegen___logical(p_self, node, p_result);
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL);
+	case LEXERTOKENS_SCOPE_RESOLUTION:
+		codegen___unsupported(p_self, node, "functions of modules used as values");
+	default:
+		break;
+	}
+
+	type_id_t lhsType = codegen___expression(p_self, lp_node->lhs, lhs);
+	type_id_t rhsType = codegen___expression(p_self, lp_node->rhs, rhs);
+
+	if (type_table_get(p_self->compiler->types, lhsType)->kind == TYPE_VECTOR) {
+		return codegen___vector_binary(p_self, node, lp_node->operation, lhsType, rhsType, lhs,
+									   rhs, p_result);
+	}
+
+	if (lp_node->operation >= LEXERTOKENS_EQUAL_TO
+		&& lp_node->operation <= LEXERTOKENS_LESS_THAN_OR_EQUAL) {
+		codegen___compare(p_self, node, lp_node->operation, lhsType, lhs, rhs, p_result);
+
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL);
+	}
+
+	if (lp_node->operation == LEXERTOKENS_EXPONENT) { // The exponent can be any number
+		codegen___power(p_self, node, lhsType, lhs, rhsType, rhs, lp_node->rhs, p_result);
+
+		return lhsType;
+	}
+
+	if (lp_node->operation == LEXERTOKENS_BITWISE_LEFT_SHIFT
+		|| lp_node->operation == LEXERTOKENS_BITWISE_RIGHT_SHIFT) { // The shift can be any integer
+		codegen___convert(p_self, node, rhsType, lhsType, rhs);
+	}
+
+	codegen___arithmetic(p_self, node, lp_node->operation, lhsType, lhs, rhs, p_result);
+
+	return lhsType;
+}
+
+/**
+ * Emits a unary operation.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The operation's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___unary(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	char					  operand[CODEGEN_OPERAND_LENGTH];
+	char					  llvmType[CODEGEN_OPERAND_LENGTH];
+	type_id_t				  type = codegen___expression(p_self, lp_node->lhs, operand);
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_COUNT
+		|| codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR) {
+		codegen___unsupported(p_self, node, "unary operations on values that are not numbers");
+	}
+
+	codegen___llvm_type(p_self, node, type, llvmType);
+	codegen___temporary(p_self, p_result);
+
+	if (lp_node->operation == LEXERTOKENS_LOGICAL_NOT) {
+		codegen___emit(p_self, "%s = xor i1 %s, true", p_result, operand);
+	} else if (lp_node->operation == LEXERTOKENS_BITWISE_NOT) {
+		codegen___emit(p_self, "%s = xor %s %s, -1", p_result, llvmType, operand);
+	} else if (codegen___is_float(p_self, type)) {
+		codegen___emit(p_self, "%s = fneg %s %s", p_result, llvmType, operand);
+	} else {
+		codegen___emit(p_self, "%s = sub %s 0, %s", p_result, llvmType, operand);
+	}
+
+	return type;
+}
+
+/**
+ * Writes a floating point constant, in the hexadecimal form LLVM reads exactly.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param type     The constant's type, 'f32' or 'f64'.
+ * @param value    The constant.
+ * @param p_result Where to write the constant, of CODEGEN_OPERAND_LENGTH.
+ */
+void codegen___float(const struct Codegen* p_self, type_id_t type, double value, char* p_result) {
+	uint64_t bits = 0;
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_F32) { // Must be exact as a float
+		value = (double)(float)value;
+	}
+
+	memcpy(&bits, &value, sizeof(bits));
+	snprintf(p_result, CODEGEN_OPERAND_LENGTH, "0x%016" PRIX64, bits);
+}
+
+/**
+ * Emits the address of a struct's field.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The MEMBER node.
+ * @param p_pointer Where to write the field's address, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The field's type.
+ */
+type_id_t codegen___field(struct Codegen* p_self, flat_ast_index_t node, char* p_pointer) {
+	const struct FlatAST*	  lp_ast  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_node = flat_ast_get(lp_ast, node);
+	char					  object[CODEGEN_OPERAND_LENGTH];
+	type_id_t				  type = codegen___node_type(p_self, lp_node->lhs);
+
+	if (codegen___declaration(p_self, type, SYMBOL_STRUCT) == SYMBOL_BINDING_NONE) {
+		codegen___unsupported(p_self, node, "members of values that are not structs");
+	}
+
+	uint32_t				  layout   = codegen___struct(p_self, node, type);
+	const struct LayoutField* lp_field = layout_get_field(
+		p_self->compiler->layouts, layout,
+		interner_intern(p_self->compiler->interner,
+						flat_ast_get_string(lp_ast, lp_node->value.string)));
+
+	if (!lp_field) {
+		codegen___unsupported(p_self, node, "methods used as values");
+	}
+
+	intern_id_t name = lp_field->name;
+
+	codegen___expression(p_self, lp_node->lhs, object); // Can declare structs, moving the field
+	lp_field = layout_get_field(p_self->compiler->layouts, layout, name);
+	codegen___temporary(p_self, p_pointer);
+	layout_emit_field(p_self->compiler->layouts, layout, lp_field, object, p_pointer,
+					  p_self->body);
+
+	return lp_field->type;
+}
+
+/**
+ * Emits a call, passing values held by value as pointers, and spilling them when returned.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The call's node, for diagnostics.
+ * @param p_callee  The function, e.g. '@"add"'.
+ * @param type      The function's type, e.g. '(i32, i32) -> i32'.
+ * @param p_args    The arguments.
+ * @param p_result  Where to write the result, of CODEGEN_OPERAND_LENGTH (empty for 'void').
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___emit_call(struct Codegen* p_self, flat_ast_index_t node, const char* p_callee,
+						 type_id_t type, char (*p_args)[CODEGEN_OPERAND_LENGTH], char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	const struct Type* lp_type	= type_table_get(p_self->compiler->types, type);
+	uint32_t		   argCount = lp_type->argCount - 1;
+	type_id_t		   result	= type_table_get_args(p_self->compiler->types, type)[argCount];
+	struct String*	   lp_call	= string_new("\0", true);
+	char			   llvmType[CODEGEN_OPERAND_LENGTH];
+
+	// 'musttail' needs the caller's prototype, and the 'ret' straight after the call
+	const char* lp_instruction =
+		tail_calls_get_kind(p_self->compiler->tailcalls, node) == TAIL_CALL_MUSTTAIL
+				&& type == p_self->type && !p_self->main && !codegen___by_value(p_self, result)
+				&& p_self->arenaCount == 0 // Else the arenas are left after the call
+			? "musttail call"
+			: "call";
+
+	for (uint32_t index = 0; index < argCount; index++) {
+		codegen___llvm_type(p_self, node,
+							type_table_get_args(p_self->compiler->types, type)[index], llvmType);
+		string_append_str(lp_call, index ? ", " : "");
+		string_append_str(lp_call, llvmType);
+		string_append_chr(lp_call, ' ');
+		string_append_str(lp_call, p_args[index]);
+	}
+
+	codegen___storage_type(p_self, node, result, llvmType);
+	p_result[0] = '\0';
+
+	if (codegen___primitive(p_self, result) == TYPE_PRIMITIVE_VOID) {
+		codegen___emit(p_self, "%s void %s(%s)", lp_instruction, p_callee, lp_call->_value);
+	} else {
+		codegen___temporary(p_self, p_result);
+		codegen___emit(p_self, "%s = %s %s %s(%s)", p_result, lp_instruction, llvmType, p_callee,
+					   lp_call->_value);
+
+		if (codegen___by_value(p_self, result)) {
+			char spill[CODEGEN_OPERAND_LENGTH];
+
+			codegen___alloca(p_self, llvmType, spill);
+			codegen___emit(p_self, "store %s %s, %s* %s", llvmType, p_result, llvmType, spill);
+			snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%s", spill);
+		}
+	}
+
+	string_free(&lp_call);
+}
+
+/**
+ * Emits a call to a function of the 'io' module, printing values with the runtime's functions for
+ * their type, or running tasks on the runtime's event loop.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param p_name   The function's name, e.g. 'out'.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH (empty for 'void').
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___io(struct Codegen* p_self, flat_ast_index_t node, const char* p_name,
+					   char* p_result) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	type_id_t				  void_	  = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	char					  value[CODEGEN_OPERAND_LENGTH];
+	char					  bytes[CODEGEN_OPERAND_LENGTH];
+	char					  length[CODEGEN_OPERAND_LENGTH];
+
+	if (strcmp(p_name, "flush") == 0) {
+		codegen___emit(p_self, "call void @io_SEP_flush()");
+		return void_;
+	}
+
+	if (strcmp(p_name, "run") == 0) { // Until every task is complete
+		codegen___emit(p_self, "call void @io_SEP_run()");
+		return void_;
+	}
+
+	if ((strcmp(p_name, "out") != 0 && strcmp(p_name, "spawn") != 0
+		 && strcmp(p_name, "sleep") != 0)
+		|| lp_node->value.list.length != 1) {
+		codegen___unsupported(p_self, node, CONCATENATE_STRING("calls to 'io::", p_name, "'"));
+	}
+
+	type_id_t type = codegen___expression(
+		p_self, flat_ast_get_list_item(p_self->compiler->ast, lp_node, 0), value);
+
+	if (strcmp(p_name, "spawn") == 0) { // Detaches the task, which the loop destroys once complete
+		codegen___emit(p_self, "call void @io_SEP_spawn(i8* %s)", value);
+		return void_;
+	}
+
+	if (strcmp(p_name, "sleep") == 0) { // A task completing after some milliseconds
+		codegen___convert(p_self, node, type, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64), value);
+		codegen___temporary(p_self, p_result);
+		codegen___emit(p_self, "%s = call i8* @io_SEP_sleep(i64 %s)", p_result, value);
+
+		return type_table_named(p_self->compiler->types,
+								interner_intern(p_self->compiler->interner, CORO_TASK_TYPE), &void_,
+								1);
+	}
+
+	switch (codegen___primitive(p_self, type)) {
+	case TYPE_PRIMITIVE_STR:
+		break;
+	case TYPE_PRIMITIVE_BOOL: {
+		char falseBytes[CODEGEN_OPERAND_LENGTH];
+		char string[CODEGEN_OPERAND_LENGTH];
+
+		codegen___string_constant(p_self, "true", bytes);
+		codegen___string_constant(p_self, "false", falseBytes);
+		snprintf(string, sizeof(string), "%s", value);
+		codegen___temporary(p_self, value);
+		codegen___emit(p_self, "%s = select i1 %s, i8* %s, i8* %s", value, string, bytes,
+					   falseBytes);
+		codegen___temporary(p_self, length);
+		codegen___emit(p_self, "%s = select i1 %s, i64 4, i64 5", length, string);
+		snprintf(bytes, sizeof(bytes), "%s", value);
+		codegen___string(p_self, bytes, length, value);
+		break;
+	}
+	case TYPE_PRIMITIVE_CHR: { // A string of one character
+		char slot[CODEGEN_OPERAND_LENGTH];
+
+		codegen___alloca(p_self, "i8", slot);
+		codegen___emit(p_self, "store i8 %s, i8* %s", value, slot);
+		codegen___string(p_self, slot, "1", value);
+		break;
+	}
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_I64:
+		codegen___convert(p_self, node, type, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64), value);
+		codegen___emit(p_self, "call void @io_SEP_out_i64(i64 %s)", value);
+		return void_;
+	case TYPE_PRIMITIVE_U8:
+	case TYPE_PRIMITIVE_U16:
+	case TYPE_PRIMITIVE_U32:
+	case TYPE_PRIMITIVE_U64:
+		codegen___convert(p_self, node, type, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_U64), value);
+		codegen___emit(p_self, "call void @io_SEP_out_u64(i64 %s)", value);
+		return void_;
+	case TYPE_PRIMITIVE_F32:
+		codegen___emit(p_self, "call void @io_SEP_out_f32(float %s)", value);
+		return void_;
+	case TYPE_PRIMITIVE_F64:
+		codegen___emit(p_self, "call void @io_SEP_out_f64(double %s)", value);
+		return void_;
+	default: {
+		char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("printing values of type '", lp_name, "'"));
+	}
+	}
+
+	codegen___emit(p_self, "call void @io_SEP_out(%%str* %s)", value);
+
+	return void_;
+}
+
+/**
+ * Emits '.clone()' of a string or an array, the explicit deep copy of it.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param value    The node of the value cloned.
+ * @param type     Its type.
+ * @param p_result Where to write the pointer to the copy, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the copy.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+type_id_t codegen___clone(struct Codegen* p_self, flat_ast_index_t node, flat_ast_index_t value,
+						  type_id_t type, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	codegen___expression(p_self, value, p_result);
+
+	if (ownership_get_transfer(p_self->compiler->ownership, node) == OWNERSHIP_CLONE) {
+		codegen___transfer(p_self, node, type, p_result);
+	} else if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR) { // e.g. of an instance
+		char copy[CODEGEN_OPERAND_LENGTH];
+
+		codegen___alloca(p_self, "%str", copy);
+		codegen___emit(p_self, "call void @str_SEP_clone(%%str* %s, %%str* %s)", copy, p_result);
+		snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%s", copy);
+	} else {
+		codegen___unsupported(p_self, node, "'.clone()' of arrays in generic functions");
+	}
+
+	return type;
+}
+
+/**
+ * Emits a call to a method of the runtime's 'Array<T>'.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___array_method(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatAST*	  lp_ast	= p_self->compiler->ast;
+	const struct FlatASTNode* lp_node	= flat_ast_get(lp_ast, node);
+	const struct FlatASTNode* lp_callee = flat_ast_get(lp_ast, lp_node->lhs);
+	const char*	   lp_method = flat_ast_get_string(lp_ast, lp_callee->value.string);
+	type_id_t	   type		 = codegen___node_type(p_self, lp_callee->lhs);
+	type_id_t	   element	 = type_table_get_args(p_self->compiler->types, type)[0];
+	char		   array[CODEGEN_OPERAND_LENGTH];
+	char		   elementType[CODEGEN_OPERAND_LENGTH];
+	char		   size[CODEGEN_OPERAND_LENGTH];
+	char		   argument[CODEGEN_OPERAND_LENGTH];
+
+	codegen___storage_type(p_self, node, element, elementType);
+	codegen___size_of(elementType, size);
+	codegen___expression(p_self, lp_callee->lhs, array);
+
+	if (lp_node->value.list.length > 0) {
+		flat_ast_index_t argumentNode = flat_ast_get_list_item(lp_ast, lp_node, 0);
+		type_id_t		 argumentType = codegen___expression(p_self, argumentNode, argument);
+
+		if (strcmp(lp_method, "append") != 0) { // An index
+			codegen___convert(p_self, node, argumentType, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64),
+							  argument);
+		} else { // Kept by the array
+			codegen___transfer(p_self, argumentNode, argumentType, argument);
+			codegen___coerce(p_self, node, argumentType, element, argument);
+		}
+	}
+
+	p_result[0] = '\0';
+
+	if (strcmp(lp_method, "length") == 0) {
+		codegen___temporary(p_self, p_result);
+		codegen___emit(p_self, "%s = call i64 @array_SEP_length(%%array* %s)", p_result, array);
+
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64);
+	}
+
+	if (strcmp(lp_method, "get") == 0) { // Unchecked if the innermost counted loop proves it
+		struct Compiler* lp_compiler = p_self->compiler;
+		char			 pointer[CODEGEN_OPERAND_LENGTH];
+		bool			 inBounds =
+			p_self->loop
+			&& loop_lowering_is_in_bounds(lp_compiler->loops, lp_ast, lp_compiler->inference,
+										  lp_compiler->types, p_self->loop, node);
+
+		codegen___temporary(p_self, pointer);
+		loop_lowering_emit_access(inBounds, elementType, array, argument, pointer, p_self->body);
+		codegen___load(p_self, node, element, pointer, p_result);
+
+		return element;
+	}
+
+	if (strcmp(lp_method, "append") == 0) {
+		char slot[CODEGEN_OPERAND_LENGTH];
+		char bytes[CODEGEN_OPERAND_LENGTH];
+
+		codegen___alloca(p_self, elementType, slot);
+		codegen___store(p_self, node, element, argument, slot);
+		codegen___temporary(p_self, bytes);
+		codegen___emit(p_self, "%s = bitcast %s* %s to i8*", bytes, elementType, slot);
+		codegen___emit(p_self, "call void @array_SEP_append(%%array* %s, i8* %s, i64 %s)", array,
+					   bytes, size);
+	} else if (strcmp(lp_method, "remove") == 0) {
+		codegen___emit(p_self, "call void @array_SEP_remove(%%array* %s, i64 %s, i64 %s)", array,
+					   argument, size);
+	} else {
+		codegen___unsupported(p_self, node, CONCATENATE_STRING("calls to 'Array.", lp_method, "'"));
+	}
+
+	return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+}
+
+/**
+ * Emits a call to a method of the runtime's string, e.g. 'String.from(42)' or 's.length()'. A
+ * number always fits inline, so 'String.from' never allocates.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___string_method(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatAST*	  lp_ast	= p_self->compiler->ast;
+	const struct FlatASTNode* lp_node	= flat_ast_get(lp_ast, node);
+	const struct FlatASTNode* lp_callee = flat_ast_get(lp_ast, lp_node->lhs);
+	const char*	  lp_method = flat_ast_get_string(lp_ast, lp_callee->value.string);
+	char		  value[CODEGEN_OPERAND_LENGTH];
+
+	if (strcmp(lp_method, "length") == 0) {
+		codegen___expression(p_self, lp_callee->lhs, value);
+		codegen___temporary(p_self, p_result);
+		codegen___emit(p_self, "%s = call i64 @str_SEP_length(%%str* %s)", p_result, value);
+
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64);
+	}
+
+	if (strcmp(lp_method, "from") != 0 || lp_node->value.list.length != 1) {
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("calls to 'String.", lp_method, "'"));
+	}
+
+	flat_ast_index_t	argument  = flat_ast_get_list_item(lp_ast, lp_node, 0);
+	type_id_t			type	  = codegen___expression(p_self, argument, value);
+	enum TypePrimitives primitive = codegen___primitive(p_self, type);
+	bool				isSigned  = codegen___is_signed(p_self, type);
+
+	if (!isSigned && (primitive < TYPE_PRIMITIVE_U8 || primitive > TYPE_PRIMITIVE_U64)) {
+		char* lp_name = type_table_to_string(p_self->compiler->types, type);
+
+		codegen___unsupported(
+			p_self, node, CONCATENATE_STRING("'String.from' of values of type '", lp_name, "'"));
+	}
+
+	// Narrower integers are sign or zero extended, as the runtime expects
+	codegen___convert(p_self, node, type,
+					  TYPE_ID_PRIMITIVE(isSigned ? TYPE_PRIMITIVE_I64 : TYPE_PRIMITIVE_U64), value);
+	codegen___alloca(p_self, "%str", p_result);
+	codegen___emit(p_self, "call void @str_SEP_from_%s(%%str* %s, i64 %s)",
+				   isSigned ? "i64" : "u64", p_result, value);
+
+	return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_STR);
+}
+
+/**
+ * Emits a call to a method of a SIMD vector through the SIMD lowering, e.g. 'v.sum()'. The lanes
+ * of a shuffle must be an array literal of constant integers.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param type     The vector type.
+ * @param bound    Whether the method is called on a vector, rather than its type.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___vector_method(struct Codegen* p_self, flat_ast_index_t node, type_id_t type,
+								  bool bound, char* p_result) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_ast, node);
+	const struct FlatASTNode* lp_callee	  = flat_ast_get(lp_ast, lp_node->lhs);
+	const struct Type*		  lp_vector	  = type_table_get(lp_compiler->types, type);
+	const char*				  lp_method	  = flat_ast_get_string(lp_ast, lp_callee->value.string);
+	size_t					  argCount	  = lp_node->value.list.length;
+	bool					  isShuffle	  = strcmp(lp_method, "shuffle") == 0;
+	const char*				  lp_mask	  = NULL; // For 'load_masked' and 'store_masked'
+	char					  vector[CODEGEN_OPERAND_LENGTH];
+	char					  args[3][CODEGEN_OPERAND_LENGTH];
+	type_id_t				  argTypes[3];
+
+	if (argCount == 3) {
+		lp_mask = args[2];
+	}
+
+	if (bound) {
+		codegen___expression(p_self, lp_callee->lhs, vector);
+	}
+
+	for (size_t index = 0; index < argCount && index < 3 && !(isShuffle && index > 0); index++) {
+		flat_ast_index_t arg = flat_ast_get_list_item(lp_ast, lp_node, index);
+
+		argTypes[index] = codegen___expression(p_self, arg, args[index]);
+	}
+
+	if (strncmp(lp_method, "load", 4) == 0 || strncmp(lp_method, "store", 5) == 0) { // The index
+		codegen___convert(p_self, node, argTypes[1], TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64),
+						  args[1]);
+	}
+
+	p_result[0] = '\0';
+
+	if (strcmp(lp_method, "store") == 0 || strcmp(lp_method, "store_masked") == 0) {
+		simd_lowering_emit_store(lp_compiler->simd, type, vector, args[0], args[1], lp_mask,
+								 p_self->body, p_self->globals);
+
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	}
+
+	codegen___temporary(p_self, p_result);
+
+	if (strcmp(lp_method, "splat") == 0) {
+		simd_lowering_emit_splat(lp_compiler->simd, type, args[0], p_result, p_self->body);
+
+		return type;
+	}
+
+	if (strcmp(lp_method, "load") == 0 || strcmp(lp_method, "load_masked") == 0) {
+		simd_lowering_emit_load(lp_compiler->simd, type, args[0], args[1], lp_mask, p_result,
+								p_self->body, p_self->globals);
+
+		return type;
+	}
+
+	if (strcmp(lp_method, "select") == 0) {
+		const struct Type* lp_selected = type_table_get(lp_compiler->types, argTypes[0]);
+
+		if (lp_selected->kind != TYPE_VECTOR || lp_selected->name != lp_vector->name) {
+			compiler_error(lp_compiler->filePath, lp_node->line, C0009,
+						   "'select' chooses between vectors with as many lanes as its mask");
+		}
+
+		simd_lowering_emit_select(lp_compiler->simd, argTypes[0], vector, args[0], args[1],
+								  p_result, p_self->body);
+
+		return argTypes[0];
+	}
+
+	if (isShuffle) {
+		const struct FlatASTNode* lp_lanes =
+			flat_ast_get(lp_ast, flat_ast_get_list_item(lp_ast, lp_node, 1));
+		uint32_t lanes[TYPE_VECTOR_MAX_LANES];
+		bool	 valid = lp_lanes->kind == FLATAST_ARRAY_LITERAL
+					 && lp_lanes->value.list.length == lp_vector->name;
+
+		for (uint32_t index = 0; valid && index < lp_vector->name; index++) {
+			const struct FlatASTNode* lp_lane =
+				flat_ast_get(lp_ast, flat_ast_get_list_item(lp_ast, lp_lanes, index));
+
+			valid = lp_lane->kind == FLATAST_INTEGER && lp_lane->value.integer >= 0
+					&& lp_lane->value.integer < 2 * (int64_t)lp_vector->name;
+			lanes[index] = valid ? (uint32_t)lp_lane->value.integer : 0;
+		}
+
+		if (!valid) {
+			compiler_error(lp_compiler->filePath, lp_node->line, C0009,
+						   "'shuffle' takes an array literal of a constant lane of either vector "
+						   "for each lane, e.g. '[0, 4, 1, 5]'");
+		}
+
+		simd_lowering_emit_shuffle(lp_compiler->simd, type, vector, args[0], lanes,
+								   lp_vector->name, p_result, p_self->body);
+
+		return type;
+	}
+
+	for (uint32_t reduction = 0; reduction <= SIMD_REDUCTION_ALL; reduction++) {
+		if (strcmp(lp_method, simd_reduction_get_name((enum SimdReductions)reduction)) == 0) {
+			simd_lowering_emit_reduce(lp_compiler->simd, type, (enum SimdReductions)reduction,
+									  vector, p_result, p_self->body, p_self->globals);
+
+			return TYPE_ID_PRIMITIVE(lp_vector->primitive);
+		}
+	}
+
+	codegen___unsupported(p_self, node, CONCATENATE_STRING("calls to 'Vec.", lp_method, "'"));
+}
+
+/**
+ * Matches a generic type against the type it is used as, binding each type parameter it mentions
+ * to the type in the same position.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param generic   The generic type, e.g. '(T, T) -> T'.
+ * @param concrete  The type it is used as, e.g. '(i32, i32) -> i32'.
+ * @param p_params  The type parameters bound so far, of MAX_STRING_LENGTH / sizeof(type_id_t).
+ * @param p_args    Their type arguments.
+ * @param p_count   The number of type parameters bound so far, updated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___match(const struct Codegen* p_self, type_id_t generic, type_id_t concrete,
+					 type_id_t* p_params, type_id_t* p_args, size_t* p_count) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	const struct TypeTable* lp_types   = p_self->compiler->types;
+	const struct Type*		lp_generic = type_table_get(lp_types, generic);
+
+	if (!(lp_generic->flags & TYPE_FLAG_GENERIC) || concrete == TYPE_ID_NONE) {
+		return;
+	}
+
+	if (lp_generic->kind == TYPE_PARAMETER) {
+		for (size_t index = 0; index < *p_count; index++) {
+			if (p_params[index] == generic) {
+				return;
+			}
+		}
+
+		if (*p_count < MAX_STRING_LENGTH / sizeof(type_id_t)) {
+			p_params[*p_count] = generic;
+			p_args[(*p_count)++] = concrete;
+		}
+
+		return;
+	}
+
+	const struct Type* lp_concrete = type_table_get(lp_types, concrete);
+
+	if (lp_concrete->kind != lp_generic->kind || lp_concrete->argCount != lp_generic->argCount) {
+		return;
+	}
+
+	for (uint32_t index = 0; index < lp_generic->argCount; index++) {
+		codegen___match(p_self, type_table_get_args(lp_types, generic)[index],
+						type_table_get_args(lp_types, concrete)[index], p_params, p_args, p_count);
+	}
+}
+
+/**
+ * Gets the function implementing a method for a receiver, instantiating it if it is generic.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param method   The method's binding, e.g. 'Rectangle.area'.
+ * @param receiver The receiver's type, e.g. 'Rectangle<i32>'.
+ * @param p_symbol Where to write the function's symbol, unquoted, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The function's type.
+ */
+type_id_t codegen___method(struct Codegen* p_self, uint32_t method, type_id_t receiver,
+						   char* p_symbol) {
+	struct Compiler*	 lp_compiler = p_self->compiler;
+	struct SymbolBinding declaration = *symbol_table_get(lp_compiler->symbols, method);
+	type_id_t			 params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	type_id_t			 args[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	size_t				 count = 0;
+
+	codegen___symbol(p_self, interner_get(lp_compiler->interner, declaration.name), p_symbol);
+
+	if (!(type_table_get(lp_compiler->types, declaration.type)->flags & TYPE_FLAG_GENERIC)) {
+		return declaration.type;
+	}
+
+	codegen___match(p_self, type_table_get_args(lp_compiler->types, declaration.type)[0],
+					receiver, params, args, &count);
+
+	type_id_t paramsTuple = type_table_tuple(lp_compiler->types, params, count);
+	type_id_t argsTuple	  = type_table_tuple(lp_compiler->types, args, count);
+	uint32_t  instance	  = mono_instantiate(lp_compiler->mono, declaration.declaration,
+											 declaration.name, declaration.type, paramsTuple,
+											 argsTuple);
+
+	snprintf(p_symbol, CODEGEN_OPERAND_LENGTH, "%s",
+			 interner_get(lp_compiler->interner, mono_get(lp_compiler->mono, instance)->symbol));
+
+	return mono_get(lp_compiler->mono, instance)->type;
+}
+
+/**
+ * Converts a value to the type it is used as. A struct used as a trait it implements becomes a
+ * trait object, pointing at the struct and at its vtable for the trait. Other values are left as
+ * they are.
+ *
+ * @param p_self  The current Codegen struct.
+ * @param node    The node the value is for, for diagnostics.
+ * @param from    The value's type.
+ * @param to      The type the value is used as.
+ * @param p_value The value, replaced by the converted one, of CODEGEN_OPERAND_LENGTH.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___coerce(struct Codegen* p_self, flat_ast_index_t node, type_id_t from, type_id_t to,
+					  char* p_value) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	struct Compiler* lp_compiler = p_self->compiler;
+
+	if (from == to || codegen___declaration(p_self, to, SYMBOL_TRAIT) == SYMBOL_BINDING_NONE
+		|| codegen___declaration(p_self, from, SYMBOL_STRUCT) == SYMBOL_BINDING_NONE) {
+		return;
+	}
+
+	uint32_t			trait = codegen___trait(p_self, node, to);
+	uint32_t			count = lp_compiler->vtables->traits[trait].methodCount;
+	struct VtableEntry* lp_entries = calloc(count ? count : 1, sizeof(struct VtableEntry));
+	char(*lp_strings)[CODEGEN_OPERAND_LENGTH] =
+		calloc(2 * (count ? count : 1), CODEGEN_OPERAND_LENGTH); // Symbols and LLVM types
+	char llvmType[CODEGEN_OPERAND_LENGTH];
+	char data[CODEGEN_OPERAND_LENGTH];
+
+	if (!lp_entries || !lp_strings) {
+		PANIC("failed to malloc Codegen vtable entries");
+	}
+
+	for (uint32_t index = 0; index < count; index++) { // In the trait's declaration order
+		const struct VtableTrait* lp_trait = &lp_compiler->vtables->traits[trait];
+		intern_id_t name = lp_compiler->vtables->methods[lp_trait->methodStart + index].name;
+		char*		lp_qualified = CONCATENATE_STRING(
+			  interner_get(lp_compiler->interner, type_table_get(lp_compiler->types, from)->name),
+			  ".", interner_get(lp_compiler->interner, name));
+		uint32_t method = symbol_table_resolve(
+			lp_compiler->symbols, interner_intern(lp_compiler->interner, lp_qualified));
+
+		free(lp_qualified);
+
+		if (method == SYMBOL_BINDING_NONE) {
+			codegen___unsupported(p_self, node, "trait objects of structs lacking trait methods");
+		}
+
+		type_id_t type = codegen___method(p_self, method, from, lp_strings[2 * index]);
+
+		codegen___llvm_type(p_self, node, type, lp_strings[2 * index + 1]);
+		lp_strings[2 * index + 1][strlen(lp_strings[2 * index + 1]) - 1] = '\0'; // Not a pointer
+		lp_entries[index].symbol   = lp_strings[2 * index];
+		lp_entries[index].llvmType = lp_strings[2 * index + 1];
+	}
+
+	vtable_table_emit(lp_compiler->vtables, trait, from, lp_entries, p_self->globals);
+	codegen___llvm_type(p_self, node, from, llvmType);
+	codegen___temporary(p_self, data);
+	codegen___emit(p_self, "%s = bitcast %s %s to i8*", data, llvmType, p_value);
+	codegen___temporary(p_self, p_value);
+	vtable_table_emit_object(lp_compiler->vtables, trait, from, data, p_value, p_self->body);
+
+	free(lp_entries);
+	free(lp_strings);
+}
+
+/**
+ * Gets the instance of a generic function a call needs, binding its type parameters to the types
+ * of the call's arguments and result.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param binding  The callee's binding.
+ * @param receiver The type of the receiver the call passes as its first argument, else none.
+ *
+ * @return The index of the instance.
+ */
+uint32_t codegen___instantiate(struct Codegen* p_self, flat_ast_index_t node, uint32_t binding,
+							   type_id_t receiver) {
+	struct Compiler*			lp_compiler = p_self->compiler;
+	const struct FlatASTNode*	lp_node		= flat_ast_get(lp_compiler->ast, node);
+	struct SymbolBinding		declaration = *symbol_table_get(lp_compiler->symbols, binding);
+	uint32_t  argCount = type_table_get(lp_compiler->types, declaration.type)->argCount;
+	type_id_t params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	type_id_t args[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	size_t	  count	   = 0;
+	bool	  bound	   = receiver != TYPE_ID_NONE;
+
+	for (uint32_t index = 0; index < argCount; index++) {
+		type_id_t concrete = TYPE_ID_NONE; // Getting it can add types, moving the generic's
+
+		if (index + 1 == argCount) {
+			concrete = codegen___node_type(p_self, node);
+		} else if (bound && index == 0) {
+			concrete = receiver;
+		} else if (index - bound < lp_node->value.list.length) {
+			concrete = codegen___node_type(
+				p_self, flat_ast_get_list_item(lp_compiler->ast, lp_node, index - bound));
+		}
+
+		codegen___match(p_self, type_table_get_args(lp_compiler->types, declaration.type)[index],
+						concrete, params, args, &count);
+	}
+
+	type_id_t paramsTuple = type_table_tuple(lp_compiler->types, params, count);
+	type_id_t argsTuple	  = type_table_tuple(lp_compiler->types, args, count);
+
+	return mono_instantiate(lp_compiler->mono, declaration.declaration, declaration.name,
+							declaration.type, paramsTuple, argsTuple);
+}
+
+/**
+ * Emits a self tail call, storing the arguments into the parameters' slots then jumping back to
+ * the start of the function, which ends the current block.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The call's node, for diagnostics.
+ * @param p_args The arguments, one per parameter.
+ */
+void codegen___tail_jump(struct Codegen* p_self, flat_ast_index_t node,
+						 char (*p_args)[CODEGEN_OPERAND_LENGTH]) {
+	size_t count = flat_ast_get(p_self->compiler->ast, node)->value.list.length;
+	char(*lp_strings)[CODEGEN_OPERAND_LENGTH] =
+		calloc(count ? 2 * count : 1, CODEGEN_OPERAND_LENGTH); // Types, then slots
+	const char** lp_pointers = calloc(count ? 3 * count : 1, sizeof(const char*));
+
+	if (!lp_strings || !lp_pointers) {
+		PANIC("failed to malloc Codegen tail call arguments");
+	}
+
+	for (size_t index = 0; index < count; index++) { // The parameters are the first locals
+		codegen___storage_type(p_self, node, p_self->locals[index].type, lp_strings[index]);
+		codegen___slot(p_self, &p_self->locals[index], lp_strings[count + index]);
+		lp_pointers[index]			   = lp_strings[index];
+		lp_pointers[count + index]	   = p_args[index];
+		lp_pointers[2 * count + index] = lp_strings[count + index];
+	}
+
+	tail_calls_emit_jump(lp_pointers, &lp_pointers[count], &lp_pointers[2 * count], count,
+						 p_self->body);
+	p_self->terminated = true;
+	p_self->looping	   = true;
+
+	free(lp_strings);
+	free(lp_pointers);
+}
+
+/**
+ * Emits a call to a function or method declared by the module.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The call's node.
+ * @param binding   The callee's binding.
+ * @param p_receiver The receiver of a method call, NULL for other calls.
+ * @param receiver  The receiver's type, else none.
+ * @param p_result  Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+type_id_t codegen___call_function(struct Codegen* p_self, flat_ast_index_t node, uint32_t binding,
+								  const char* p_receiver, type_id_t receiver, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	const struct FlatAST*	  lp_ast	  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_ast, node);
+	struct SymbolBinding*	  lp_binding  = symbol_table_get(p_self->compiler->symbols, binding);
+	size_t					  offset	  = p_receiver ? 1 : 0;
+	size_t					  argCount	  = lp_node->value.list.length + offset;
+	char(*lp_args)[CODEGEN_OPERAND_LENGTH] =
+		calloc(argCount ? argCount : 1, CODEGEN_OPERAND_LENGTH);
+	char symbol[CODEGEN_SYMBOL_LENGTH];
+
+	if (!lp_args) {
+		PANIC("failed to malloc Codegen call arguments");
+	}
+
+	type_id_t type = lp_binding->type;
+	char	  name[CODEGEN_OPERAND_LENGTH];
+
+	codegen___symbol(p_self, interner_get(p_self->compiler->interner, lp_binding->name), name);
+	snprintf(symbol, sizeof(symbol), "@\"%s\"", name);
+
+	if (type_table_get(p_self->compiler->types, type)->flags & TYPE_FLAG_GENERIC) {
+		uint32_t instance = codegen___instantiate(p_self, node, binding, receiver);
+
+		type = mono_get(p_self->compiler->mono, instance)->type;
+		snprintf(symbol, sizeof(symbol), "@\"%s\"",
+				 interner_get(p_self->compiler->interner,
+							  mono_get(p_self->compiler->mono, instance)->symbol));
+
+		if (instance == p_self->instance) { // Recursive, so instances differing by name can merge
+			snprintf(symbol, sizeof(symbol), "%s", MONO_SELF_PLACEHOLDER);
+		}
+	}
+
+	if (p_receiver) {
+		snprintf(lp_args[0], CODEGEN_OPERAND_LENGTH, "%s", p_receiver);
+	}
+
+	for (size_t index = offset; index < argCount; index++) {
+		flat_ast_index_t arg	 = flat_ast_get_list_item(lp_ast, lp_node, index - offset);
+		type_id_t		 argType = codegen___expression(p_self, arg, lp_args[index]);
+
+		codegen___transfer(p_self, arg, argType, lp_args[index]);
+		codegen___coerce(p_self, arg, argType,
+						 type_table_get_args(p_self->compiler->types, type)[index], lp_args[index]);
+	}
+
+	if (tail_calls_get_kind(p_self->compiler->tailcalls, node) == TAIL_CALL_LOOP && !p_receiver
+		&& p_self->arenaCount == 0 // Else its arguments may hold memory of the arenas it leaves
+		&& (p_self->instance == MONO_INSTANCE_NONE
+			|| strcmp(symbol, MONO_SELF_PLACEHOLDER) == 0)) { // Jumps back to the start
+		codegen___tail_jump(p_self, node, lp_args);
+	} else {
+		codegen___emit_call(p_self, node, symbol, type, lp_args, p_result);
+	}
+
+	free(lp_args);
+
+	return codegen___node_type(p_self, node);
+}
+
+/**
+ * Emits a call of a method of a trait object. The method is loaded from the object's vtable,
+ * unless the trait has a single implementation, whose method is called directly.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param receiver The trait object's type, e.g. 'Shape<i32>'.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___trait_call(struct Codegen* p_self, flat_ast_index_t node, type_id_t receiver,
+							   char* p_result) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_ast, node);
+	const struct FlatASTNode* lp_callee	  = flat_ast_get(lp_ast, lp_node->lhs);
+	const char*				  lp_name	  = flat_ast_get_string(lp_ast, lp_callee->value.string);
+	uint32_t				  trait		  = codegen___trait(p_self, node, receiver);
+	type_id_t				  result	  = codegen___node_type(p_self, node);
+	char					  object[CODEGEN_OPERAND_LENGTH];
+	char					  llvmType[CODEGEN_OPERAND_LENGTH];
+
+	codegen___expression(p_self, lp_callee->lhs, object);
+
+	if (devirt_get_dispatch(lp_compiler->devirt, node) == DEVIRT_SOLE) {
+		type_id_t implementation = devirt_get_target(lp_compiler->devirt, node); // 'Square<MU>'
+		type_id_t generic		 = inference_implementation(
+			   lp_compiler->inference, lp_ast, implementation,
+			   type_table_get(lp_compiler->types, receiver)->name); // e.g. 'Shape<MU>'
+		type_id_t params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+		type_id_t args[MAX_STRING_LENGTH / sizeof(type_id_t)];
+		size_t	  count = 0;
+		char	  data[CODEGEN_OPERAND_LENGTH];
+		char	  pointer[CODEGEN_OPERAND_LENGTH];
+
+		codegen___match(p_self, generic, receiver, params, args, &count);
+
+		type_id_t concrete = type_table_substitute(
+			lp_compiler->types, implementation, type_table_tuple(lp_compiler->types, params, count),
+			type_table_tuple(lp_compiler->types, args, count));
+		char* lp_qualified = CONCATENATE_STRING(
+			interner_get(lp_compiler->interner, type_table_get(lp_compiler->types, concrete)->name),
+			".", lp_name);
+		uint32_t method = symbol_table_resolve(
+			lp_compiler->symbols, interner_intern(lp_compiler->interner, lp_qualified));
+
+		free(lp_qualified);
+
+		if (method == SYMBOL_BINDING_NONE) {
+			codegen___unsupported(p_self, node, "trait objects of structs lacking trait methods");
+		}
+
+		codegen___llvm_type(p_self, node, receiver, llvmType);
+		codegen___temporary(p_self, data);
+		codegen___emit(p_self, "%s = extractvalue %s %s, 0", data, llvmType, object);
+		codegen___llvm_type(p_self, node, concrete, llvmType);
+		codegen___temporary(p_self, pointer);
+		codegen___emit(p_self, "%s = bitcast i8* %s to %s", pointer, data, llvmType);
+
+		return codegen___call_function(p_self, node, method, pointer, concrete, p_result);
+	}
+
+	struct String* lp_args = string_new("\0", true);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		char	  value[CODEGEN_OPERAND_LENGTH];
+		type_id_t type =
+			codegen___expression(p_self, flat_ast_get_list_item(lp_ast, lp_node, index), value);
+
+		codegen___llvm_type(p_self, node, type, llvmType);
+		string_append_str(lp_args, index ? ", " : "");
+		string_append_str(lp_args, llvmType);
+		string_append_chr(lp_args, ' ');
+		string_append_str(lp_args, value);
+	}
+
+	uint32_t slot = vtable_table_find_method(
+		lp_compiler->vtables, trait, interner_intern(lp_compiler->interner, lp_name));
+
+	p_result[0] = '\0';
+
+	if (codegen___primitive(p_self, result) == TYPE_PRIMITIVE_VOID) {
+		vtable_table_emit_call(lp_compiler->vtables, trait, slot, object, lp_args->_value, NULL,
+							   p_self->body);
+	} else {
+		codegen___temporary(p_self, p_result);
+		vtable_table_emit_call(lp_compiler->vtables, trait, slot, object, lp_args->_value,
+							   p_result, p_self->body);
+
+		if (codegen___by_value(p_self, result)) { // Returned as a value, spilled like other calls
+			char spill[CODEGEN_OPERAND_LENGTH];
+
+			codegen___storage_type(p_self, node, result, llvmType);
+			codegen___alloca(p_self, llvmType, spill);
+			codegen___emit(p_self, "store %s %s, %s* %s", llvmType, p_result, llvmType, spill);
+			snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%s", spill);
+		}
+	}
+
+	string_free(&lp_args);
+
+	return result;
+}
+
+/**
+ * Emits 'yield(value)' in the generator being emitted: stores the value in its promise, for the
+ * loop iterating it to read, then suspends it until the loop asks for the next value.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The call's node.
+ */
+void codegen___yield(struct Codegen* p_self, flat_ast_index_t node) {
+	flat_ast_index_t value = flat_ast_get_list_item(p_self->compiler->ast,
+													flat_ast_get(p_self->compiler->ast, node), 0);
+	char			 operand[CODEGEN_OPERAND_LENGTH];
+	char			 llvmType[CODEGEN_OPERAND_LENGTH];
+
+	codegen___coerce(p_self, node, codegen___expression(p_self, value, operand), p_self->yieldType,
+					 operand);
+	codegen___storage_type(p_self, node, p_self->yieldType, llvmType);
+
+	if (codegen___by_value(p_self, p_self->yieldType)) { // Yielded as a value, not a pointer
+		char loaded[CODEGEN_OPERAND_LENGTH];
+
+		codegen___temporary(p_self, loaded);
+		codegen___emit(p_self, "%s = load %s, %s* %s", loaded, llvmType, llvmType, operand);
+		snprintf(operand, sizeof(operand), "%s", loaded);
+	}
+
+	coroutines_emit_yield(p_self->compiler->coro, llvmType, operand, p_self->body);
+}
+
+type_id_t codegen___call(struct Codegen* p_self, flat_ast_index_t node, char* p_result);
+
+/**
+ * Emits '@await call()' in the async function being emitted: the call gives a task, which the
+ * function suspends until it completes, then reads the result of and destroys.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH (empty for 'void').
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___await(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	type_id_t type = codegen___node_type(p_self, node); // Of the result, 'T' of 'Task<T>'
+	char	  task[CODEGEN_OPERAND_LENGTH];
+	char	  llvmType[CODEGEN_OPERAND_LENGTH];
+
+	codegen___call(p_self, node, task);
+	codegen___storage_type(p_self, node, type, llvmType);
+	p_result[0] = '\0';
+
+	if (codegen___primitive(p_self, type) == TYPE_PRIMITIVE_VOID) {
+		coroutines_emit_await(p_self->compiler->coro, task, llvmType, NULL, p_self->body);
+		return type;
+	}
+
+	codegen___temporary(p_self, p_result);
+	coroutines_emit_await(p_self->compiler->coro, task, llvmType, p_result, p_self->body);
+
+	if (codegen___by_value(p_self, type)) {
+		char spill[CODEGEN_OPERAND_LENGTH];
+
+		codegen___alloca(p_self, llvmType, spill);
+		codegen___emit(p_self, "store %s %s, %s* %s", llvmType, p_result, llvmType, spill);
+		snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%s", spill);
+	}
+
+	return type;
+}
+
+/**
+ * Emits a call to a function of an imported module, e.g. 'shapes::twice', declaring the function
+ * the first time it is called. The imported module is linked into the program.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param p_module The module's name, e.g. 'shapes'.
+ * @param p_name   The function's name, e.g. 'twice'.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+type_id_t codegen___import_call(struct Codegen* p_self, flat_ast_index_t node, const char* p_module,
+								const char* p_name, char* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	struct Compiler* lp_compiler  = p_self->compiler;
+	char*			 lp_qualified = CONCATENATE_STRING(p_module, "::", p_name);
+	uint32_t		 binding	  = symbol_table_resolve(
+		   lp_compiler->symbols, interner_intern(lp_compiler->interner, lp_qualified));
+
+	free(lp_qualified);
+
+	// The runtime's generic functions, e.g. 'cf::range', are only lowered where they are used
+	if (binding == SYMBOL_BINDING_NONE
+		|| type_table_get(lp_compiler->types, symbol_table_get(lp_compiler->symbols, binding)->type)
+				   ->flags
+			   & TYPE_FLAG_GENERIC) {
+		codegen___unsupported(p_self, node,
+							  CONCATENATE_STRING("calls to functions of '", p_module, "'"));
+	}
+
+	p_self->imported =
+		buffer_grow(p_self->imported, &p_self->importedCapacity, (size_t)binding + 1,
+					sizeof(uint8_t));
+
+	if (!p_self->imported[binding]) { // declare R @"shapes::twice"(T0, ...)
+		type_id_t		 type	  = symbol_table_get(lp_compiler->symbols, binding)->type;
+		uint32_t		 argCount = type_table_get(lp_compiler->types, type)->argCount - 1;
+		const type_id_t* lp_types = type_table_get_args(lp_compiler->types, type);
+		char			 llvmType[CODEGEN_OPERAND_LENGTH];
+		intern_id_t		 name	  = symbol_table_get(lp_compiler->symbols, binding)->name;
+		char			 symbol[CODEGEN_OPERAND_LENGTH];
+
+		codegen___symbol(p_self, interner_get(lp_compiler->interner, name), symbol);
+		codegen___storage_type(p_self, node, lp_types[argCount], llvmType);
+		string_append_str(p_self->globals, "declare ");
+		string_append_str(p_self->globals, llvmType);
+		string_append_str(p_self->globals, " @\"");
+		string_append_str(p_self->globals, symbol);
+		string_append_str(p_self->globals, "\"(");
+
+		for (uint32_t index = 0; index < argCount; index++) {
+			codegen___llvm_type(p_self, node, lp_types[index], llvmType);
+			string_append_str(p_self->globals, index ? ", " : "");
+			string_append_str(p_self->globals, llvmType);
+		}
+
+		string_append_str(p_self->globals, ")\n");
+		p_self->imported[binding] = true;
+	}
+
+	return codegen___call_function(p_self, node, binding, NULL, TYPE_ID_NONE, p_result);
+}
+
+/**
+ * Emits a call.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The call's node.
+ * @param p_result Where to write the result, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The type of the result.
+ */
+type_id_t codegen___call(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_ast, node);
+	const struct FlatASTNode* lp_callee	  = flat_ast_get(lp_ast, lp_node->lhs);
+
+	p_result[0] = '\0';
+
+	if (lp_callee->kind == FLATAST_BINARY
+		&& lp_callee->operation == LEXERTOKENS_SCOPE_RESOLUTION) { // e.g. 'io::out'
+		const char* lp_module =
+			flat_ast_get_string(lp_ast, flat_ast_get(lp_ast, lp_callee->lhs)->value.string);
+		const char* lp_name =
+			flat_ast_get_string(lp_ast, flat_ast_get(lp_ast, lp_callee->rhs)->value.string);
+
+		if (strcmp(lp_module, "io") != 0) {
+			return codegen___import_call(p_self, node, lp_module, lp_name, p_result);
+		}
+
+		return codegen___io(p_self, node, lp_name, p_result);
+	}
+
+	if (lp_callee->kind == FLATAST_VARIABLE && p_self->coroutine == CORO_GENERATOR
+		&& strcmp(flat_ast_get_string(lp_ast, lp_callee->value.string), CORO_YIELD_FUNCTION)
+			   == 0) {
+		codegen___yield(p_self, node);
+
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	}
+
+	if (lp_callee->kind == FLATAST_VARIABLE) {
+		intern_id_t name = interner_intern(lp_compiler->interner,
+										   flat_ast_get_string(lp_ast, lp_callee->value.string));
+		uint32_t	binding = symbol_table_resolve(lp_compiler->symbols, name);
+
+		if (codegen___find_local(p_self, name) || binding == SYMBOL_BINDING_NONE
+			|| symbol_table_get(lp_compiler->symbols, binding)->kind != SYMBOL_FUNCTION
+			|| symbol_table_get(lp_compiler->symbols, binding)->declaration
+				   == FLATAST_INDEX_NONE) {
+			codegen___unsupported(p_self, node, "calls through values");
+		}
+
+		return codegen___call_function(p_self, node, binding, NULL, TYPE_ID_NONE, p_result);
+	}
+
+	if (lp_callee->kind != FLATAST_MEMBER) {
+		codegen___unsupported(p_self, node, "calls through values");
+	}
+
+	const struct FlatASTNode* lp_object = flat_ast_get(lp_ast, lp_callee->lhs);
+	type_id_t				  receiver	= codegen___node_type(p_self, lp_callee->lhs);
+	bool					  bound		= lp_object->kind != FLATAST_TYPE; // Else 'Stack<T>.new()'
+
+	if (lp_object->kind == FLATAST_VARIABLE) { // 'Point.new()' calls a method of the struct
+		intern_id_t name   = interner_intern(lp_compiler->interner,
+											 flat_ast_get_string(lp_ast, lp_object->value.string));
+		uint32_t	object = symbol_table_resolve(lp_compiler->symbols, name);
+
+		bound = codegen___find_local(p_self, name) || object == SYMBOL_BINDING_NONE
+				|| symbol_table_get(lp_compiler->symbols, object)->kind != SYMBOL_STRUCT;
+	}
+
+	if (bound && codegen___by_value(p_self, receiver)
+		&& strcmp(flat_ast_get_string(lp_ast, lp_callee->value.string), OWNERSHIP_CLONE_METHOD)
+			   == 0) {
+		return codegen___clone(p_self, node, lp_callee->lhs, receiver, p_result);
+	}
+
+	if (bound && codegen___is_array(p_self, receiver)) {
+		return codegen___array_method(p_self, node, p_result);
+	}
+
+	if (codegen___primitive(p_self, receiver) == TYPE_PRIMITIVE_STR) {
+		return codegen___string_method(p_self, node, p_result);
+	}
+
+	if (type_table_get(lp_compiler->types, receiver)->kind == TYPE_VECTOR) {
+		return codegen___vector_method(p_self, node, receiver, bound, p_result);
+	}
+
+	if (devirt_get_dispatch(lp_compiler->devirt, node) == DEVIRT_SWITCH) {
+		codegen___unsupported(p_self, node, "calls to methods of unions");
+	}
+
+	if (bound && codegen___declaration(p_self, receiver, SYMBOL_TRAIT) != SYMBOL_BINDING_NONE) {
+		return codegen___trait_call(p_self, node, receiver, p_result);
+	}
+
+	if (codegen___declaration(p_self, receiver, SYMBOL_STRUCT) == SYMBOL_BINDING_NONE) {
+		codegen___unsupported(p_self, node, "calls to methods of values that are not structs");
+	}
+
+	const char* lp_type =
+		interner_get(lp_compiler->interner, type_table_get(lp_compiler->types, receiver)->name);
+	char*	 lp_qualified = CONCATENATE_STRING(
+		   lp_type, ".", flat_ast_get_string(lp_ast, lp_callee->value.string));
+	uint32_t method =
+		symbol_table_resolve(lp_compiler->symbols, interner_intern(lp_compiler->interner,
+																   lp_qualified));
+
+	free(lp_qualified);
+
+	if (method == SYMBOL_BINDING_NONE) {
+		codegen___unsupported(p_self, node, "calls through fields");
+	}
+
+	if (!bound) {
+		return codegen___call_function(p_self, node, method, NULL, TYPE_ID_NONE, p_result);
+	}
+
+	char object[CODEGEN_OPERAND_LENGTH];
+
+	codegen___expression(p_self, lp_callee->lhs, object);
+
+	return codegen___call_function(p_self, node, method, object, receiver, p_result);
+}
+
+/**
+ * Emits a struct literal, allocating the struct and storing its fields. Fields left out are zero.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The literal's node.
+ * @param p_result Where to write the struct's address, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The struct's type.
+ */
+type_id_t codegen___struct_literal(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatAST*	  lp_ast  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_node = flat_ast_get(lp_ast, node);
+	type_id_t				  type	  = codegen___node_type(p_self, node);
+	uint32_t				  layout  = codegen___struct(p_self, node, type);
+	char					  llvmType[CODEGEN_OPERAND_LENGTH];
+
+	codegen___llvm_type(p_self, node, type, llvmType);
+	llvmType[strlen(llvmType) - 1] = '\0'; // The struct, not the pointer to it
+
+	// On the stack if it does not escape, which SROA then splits into scalars
+	codegen___temporary(p_self, p_result);
+	escape_emit_allocation(p_self->compiler->escape, node, llvmType, p_result, p_self->entry,
+						   p_self->body);
+	codegen___emit(p_self, "store %s zeroinitializer, %s* %s", llvmType, llvmType, p_result);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t		  item	   = flat_ast_get_list_item(lp_ast, lp_node, index);
+		const struct FlatASTNode* lp_item  = flat_ast_get(lp_ast, item);
+		const char*				  lp_name = flat_ast_get_string(lp_ast, lp_item->value.string);
+		intern_id_t				  name	  = interner_intern(p_self->compiler->interner, lp_name);
+		type_id_t fieldType = layout_get_field(p_self->compiler->layouts, layout, name)->type;
+		char					  value[CODEGEN_OPERAND_LENGTH];
+		char					  pointer[CODEGEN_OPERAND_LENGTH];
+
+		type_id_t valueType = codegen___expression(p_self, lp_item->lhs, value);
+
+		codegen___transfer(p_self, lp_item->lhs, valueType, value);
+		codegen___coerce(p_self, item, valueType, fieldType, value);
+		codegen___temporary(p_self, pointer);
+		// The field is looked up again, as emitting its value can declare structs and so move it
+		layout_emit_field(p_self->compiler->layouts, layout,
+						  layout_get_field(p_self->compiler->layouts, layout, name),
+						  p_result, pointer, p_self->body);
+		codegen___store(p_self, item, fieldType, value, pointer);
+	}
+
+	return type;
+}
+
+/**
+ * Emits an array literal, appending each element to a new array.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param node     The literal's node.
+ * @param p_result Where to write the array, of CODEGEN_OPERAND_LENGTH.
+ *
+ * @return The array's type.
+ */
+type_id_t codegen___array_literal(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	const struct FlatAST*	  lp_ast  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_node = flat_ast_get(lp_ast, node);
+	type_id_t				  type	  = codegen___node_type(p_self, node);
+	type_id_t element = type_table_get_args(p_self->compiler->types, type)[0];
+	char	  elementType[CODEGEN_OPERAND_LENGTH];
+	char	  size[CODEGEN_OPERAND_LENGTH];
+	char	  slot[CODEGEN_OPERAND_LENGTH];
+	char	  bytes[CODEGEN_OPERAND_LENGTH];
+
+	codegen___alloca(p_self, "%array", p_result);
+	codegen___emit(p_self, "call void @array_SEP___init__(%%array* %s)", p_result);
+
+	if (lp_node->value.list.length == 0) {
+		return type;
+	}
+
+	codegen___storage_type(p_self, node, element, elementType);
+	codegen___size_of(elementType, size);
+	codegen___alloca(p_self, elementType, slot);
+	codegen___temporary(p_self, bytes);
+	codegen___emit(p_self, "%s = bitcast %s* %s to i8*", bytes, elementType, slot);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		char			 value[CODEGEN_OPERAND_LENGTH];
+		flat_ast_index_t item = flat_ast_get_list_item(lp_ast, lp_node, index);
+
+		type_id_t valueType = codegen___expression(p_self, item, value);
+
+		codegen___transfer(p_self, item, valueType, value);
+		codegen___coerce(p_self, item, valueType, element, value);
+		codegen___store(p_self, node, element, value, slot);
+		codegen___emit(p_self, "call void @array_SEP_append(%%array* %s, i8* %s, i64 %s)",
+					   p_result, bytes, size);
+	}
+
+	return type;
+}
+
+/**
+ * Checks whether an expression is worth evaluating at compile time: all its leaves are literals or
+ * calls of functions with such arguments, e.g. '2 ** 3 + fibonacci(10)'. Calls that must be
+ * evaluated at compile time, marked '@comptime' or of a function marked so, always are.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The expression's node.
+ *
+ * @return Whether the expression is worth evaluating.
+ */
+bool codegen___foldable(const struct Codegen* p_self, flat_ast_index_t node) {
+	const struct Compiler*	  lp_compiler = p_self->compiler;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_compiler->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_INTEGER:
+	case FLATAST_FLOAT:
+	case FLATAST_CHR:
+		return true;
+	case FLATAST_UNARY:
+		return codegen___foldable(p_self, lp_node->lhs);
+	case FLATAST_BINARY:
+		return lp_node->operation != LEXERTOKENS_SCOPE_RESOLUTION
+			   && codegen___foldable(p_self, lp_node->lhs)
+			   && codegen___foldable(p_self, lp_node->rhs);
+	case FLATAST_CALL: {
+		const struct FlatASTNode* lp_callee = flat_ast_get(lp_compiler->ast, lp_node->lhs);
+
+		if (lp_callee->kind != FLATAST_VARIABLE) {
+			return false;
+		}
+
+		intern_id_t name = interner_intern(
+			lp_compiler->interner, flat_ast_get_string(lp_compiler->ast, lp_callee->value.string));
+		uint32_t	binding = symbol_table_resolve(lp_compiler->symbols, name);
+
+		if (binding == SYMBOL_BINDING_NONE || codegen___find_local(p_self, name)
+			|| symbol_table_get(lp_compiler->symbols, binding)->kind != SYMBOL_FUNCTION) {
+			return false;
+		}
+
+		flat_ast_index_t function = symbol_table_get(lp_compiler->symbols, binding)->declaration;
+
+		if (attributes_has(lp_compiler->ast, node, ATTRIBUTE_COMPTIME)
+			|| (flat_ast_get(lp_compiler->ast, function)->kind == FLATAST_FUNCTION
+				&& attributes_has(lp_compiler->ast, function, ATTRIBUTE_COMPTIME))) {
+			return true;
+		}
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			if (!codegen___foldable(p_self,
+									flat_ast_get_list_item(lp_compiler->ast, lp_node, index))) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+type_id_t codegen___expression(struct Codegen* p_self, flat_ast_index_t node, char* p_result) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_compiler->ast, node);
+	type_id_t				  type		  = codegen___node_type(p_self, node);
+	enum TypePrimitives		  primitive	  = codegen___primitive(p_self, type);
+	struct ComptimeValue	  folded;
+
+	if ((lp_node->kind == FLATAST_UNARY || lp_node->kind == FLATAST_BINARY
+		 || lp_node->kind == FLATAST_CALL)
+		&& primitive >= TYPE_PRIMITIVE_BOOL && primitive <= TYPE_PRIMITIVE_F64
+		&& codegen___foldable(p_self, node)
+		&& comptime_fold(lp_compiler->comptime, node, &folded)) {
+		struct String* lp_constant = string_new("\0", true);
+
+		comptime_value_append(&folded, primitive, lp_constant);
+		snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%s", lp_constant->_value);
+		string_free(&lp_constant);
+
+		return type;
+	}
+
+	switch (lp_node->kind) {
+	case FLATAST_INTEGER:
+		if (codegen___is_float(p_self, type)) { // e.g. '1' assigned to an 'f64'
+			codegen___float(p_self, type, (double)lp_node->value.integer, p_result);
+		} else {
+			snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%" PRId64, lp_node->value.integer);
+		}
+
+		return type;
+	case FLATAST_FLOAT:
+		codegen___float(p_self, type, lp_node->value.floating, p_result);
+		return type;
+	case FLATAST_CHR:
+		snprintf(p_result, CODEGEN_OPERAND_LENGTH, "%" PRId64, lp_node->value.integer);
+		return type;
+	case FLATAST_STRING: {
+		char bytes[CODEGEN_OPERAND_LENGTH];
+		char length[CODEGEN_OPERAND_LENGTH];
+
+		snprintf(length, sizeof(length), "%zu",
+				 codegen___string_constant(
+					 p_self, flat_ast_get_string(lp_compiler->ast, lp_node->value.string), bytes));
+		codegen___string(p_self, bytes, length, p_result);
+
+		return type;
+	}
+	case FLATAST_VARIABLE: {
+		intern_id_t name = interner_intern(
+			lp_compiler->interner, flat_ast_get_string(lp_compiler->ast, lp_node->value.string));
+		const struct CodegenLocal* lp_local = codegen___find_local(p_self, name);
+		char					   slot[CODEGEN_OPERAND_LENGTH];
+
+		if (!lp_local) {
+			codegen___unsupported(p_self, node, "functions used as values");
+		}
+
+		codegen___slot(p_self, lp_local, slot);
+		codegen___load(p_self, node, lp_local->type, slot, p_result);
+
+		return lp_local->type;
+	}
+	case FLATAST_UNARY:
+		return codegen___unary(p_self, node, p_result);
+	case FLATAST_BINARY:
+		return codegen___binary(p_self, node, p_result);
+	case FLATAST_MEMBER: {
+		char	  pointer[CODEGEN_OPERAND_LENGTH];
+		type_id_t field = codegen___field(p_self, node, pointer);
+
+		codegen___load(p_self, node, field, pointer, p_result);
+
+		return field;
+	}
+	case FLATAST_CALL:
+		if (attributes_has(lp_compiler->ast, node, ATTRIBUTE_AWAIT)) {
+			return codegen___await(p_self, node, p_result);
+		}
+
+		return codegen___call(p_self, node, p_result);
+	case FLATAST_STRUCT_LITERAL:
+		return codegen___struct_literal(p_self, node, p_result);
+	case FLATAST_ARRAY_LITERAL:
+		return codegen___array_literal(p_self, node, p_result);
+	default:
+		codegen___unsupported(
+			p_self, node,
+			CONCATENATE_STRING("'", flat_ast_kind_get_name(lp_node->kind), "' expressions"));
+	}
+}
+
+/**
+ * Emits the address an assignment stores to, declaring the local it assigns if it is new.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param node      The assignment's node.
+ * @param p_pointer Where to write the address, of CODEGEN_OPERAND_LENGTH.
+ * @param p_created Where to write whether the target is a new local.
+ *
+ * @return The target's type.
+ */
+type_id_t codegen___target(struct Codegen* p_self, flat_ast_index_t node, char* p_pointer,
+						   bool* p_created) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_ast, node);
+	const struct FlatASTNode* lp_target	  = flat_ast_get(lp_ast, lp_node->lhs);
+
+	*p_created = false;
+
+	switch (lp_target->kind) {
+	case FLATAST_VARIABLE:
+	case FLATAST_FIELD: {
+		intern_id_t name = interner_intern(lp_compiler->interner,
+										   flat_ast_get_string(lp_ast, lp_target->value.string));
+		const struct CodegenLocal* lp_local = codegen___find_local(p_self, name);
+
+		if (!lp_local || lp_target->kind == FLATAST_FIELD) { // A declaration, maybe annotated
+			lp_local   = codegen___declare_local(
+				  p_self, lp_node->lhs,
+				  codegen___node_type(p_self, lp_target->kind == FLATAST_FIELD ? lp_node->lhs
+																			   : lp_node->rhs));
+			*p_created = true;
+		}
+
+		codegen___slot(p_self, lp_local, p_pointer);
+
+		return lp_local->type;
+	}
+	case FLATAST_MEMBER:
+		return codegen___field(p_self, lp_node->lhs, p_pointer);
+	case FLATAST_CALL: { // 'a[i] = v' is an assignment to 'a.get(i)'
+		const struct FlatASTNode* lp_callee = flat_ast_get(lp_ast, lp_target->lhs);
+		type_id_t				  array		= TYPE_ID_NONE;
+
+		if (lp_callee->kind == FLATAST_MEMBER) {
+			array = codegen___node_type(p_self, lp_callee->lhs);
+		}
+
+		if (array == TYPE_ID_NONE || !codegen___is_array(p_self, array)
+			|| strcmp(flat_ast_get_string(lp_ast, lp_callee->value.string), "get") != 0) {
+			codegen___unsupported(p_self, node, "assignments to calls");
+		}
+
+		type_id_t element = type_table_get_args(lp_compiler->types, array)[0];
+		char	  elementType[CODEGEN_OPERAND_LENGTH];
+		char	  size[CODEGEN_OPERAND_LENGTH];
+		char	  object[CODEGEN_OPERAND_LENGTH];
+		char	  index[CODEGEN_OPERAND_LENGTH];
+
+		codegen___storage_type(p_self, node, element, elementType);
+		codegen___size_of(elementType, size);
+		codegen___expression(p_self, lp_callee->lhs, object);
+
+		type_id_t indexType =
+			codegen___expression(p_self, flat_ast_get_list_item(lp_ast, lp_target, 0), index);
+
+		codegen___convert(p_self, node, indexType, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64), index);
+		codegen___temporary(p_self, p_pointer);
+		codegen___emit(p_self, "%s.raw = call i8* @array_SEP_get(%%array* %s, i64 %s, i64 %s)",
+					   p_pointer, object, index, size);
+		codegen___emit(p_self, "%s = bitcast i8* %s.raw to %s*", p_pointer, p_pointer,
+					   elementType);
+
+		return element;
+	}
+	default:
+		codegen___unsupported(p_self, node, "assignments to this target");
+	}
+}
+
+/**
+ * Emits an assignment, e.g. 'x = 1', 'p.x += 2' or 'total: i64 = 0'.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The assignment's node.
+ */
+void codegen___assignment(struct Codegen* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	char					  value[CODEGEN_OPERAND_LENGTH];
+	char					  pointer[CODEGEN_OPERAND_LENGTH];
+	bool					  created = false;
+	type_id_t				  valueType = codegen___expression(p_self, lp_node->rhs, value);
+	type_id_t				  type		= codegen___target(p_self, node, pointer, &created);
+
+	if (lp_node->operation != LEXERTOKENS_ASSIGNMENT) { // e.g. '+=' is '+' then '='
+		enum LexerTokenIdentifiers operation =
+			(enum LexerTokenIdentifiers)(lp_node->operation
+										 - (LEXERTOKENS_MODULO_ASSIGNMENT - LEXERTOKENS_MODULO));
+		char current[CODEGEN_OPERAND_LENGTH];
+		char result[CODEGEN_OPERAND_LENGTH];
+
+		if (lp_node->operation >= LEXERTOKENS_BITWISE_AND_ASSIGNMENT) {
+			operation = (enum LexerTokenIdentifiers)(lp_node->operation
+													 - (LEXERTOKENS_BITWISE_AND_ASSIGNMENT
+														- LEXERTOKENS_BITWISE_AND));
+		}
+
+		if (operation == LEXERTOKENS_BITWISE_LEFT_SHIFT
+			|| operation == LEXERTOKENS_BITWISE_RIGHT_SHIFT) {
+			codegen___convert(p_self, node, valueType, type, value);
+		}
+
+		if (operation == LEXERTOKENS_ADDITION
+			&& codegen___primitive(p_self, type) == TYPE_PRIMITIVE_STR) { // Appended in place
+			codegen___emit(p_self, "call void @str_SEP_append(%%str* %s, %%str* %s)", pointer,
+						   value);
+			return;
+		}
+
+		codegen___load(p_self, node, type, pointer, current);
+
+		if (operation == LEXERTOKENS_EXPONENT) {
+			codegen___power(p_self, node, type, current, valueType, value, lp_node->rhs, result);
+		} else {
+			codegen___arithmetic(p_self, node, operation, type, current, value, result);
+		}
+		snprintf(value, sizeof(value), "%s", result);
+	} else {
+		codegen___transfer(p_self, lp_node->rhs, valueType, value);
+		codegen___coerce(p_self, node, valueType, type, value);
+	}
+
+	codegen___store(p_self, node, type, value, pointer);
+}
+
+/**
+ * Emits leaving every '@arena' block open, innermost first, before control leaves the function.
+ *
+ * @param p_self The current Codegen struct.
+ */
+void codegen___leave_arenas(struct Codegen* p_self) {
+	for (size_t index = p_self->arenaCount; index > 0; index--) {
+		regions_emit_leave(p_self->compiler->regions, p_self->arenas[index - 1], p_self->body);
+	}
+}
+
+/**
+ * Emits a return, from the function being emitted.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The return's node.
+ */
+void codegen___return(struct Codegen* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	char					  value[CODEGEN_OPERAND_LENGTH];
+	char					  llvmType[CODEGEN_OPERAND_LENGTH];
+
+	if (lp_node->lhs == FLATAST_INDEX_NONE) {
+		codegen___leave_arenas(p_self);
+
+		if (p_self->coroutine != CORO_NONE) { // Completes at the final suspension
+			coroutines_emit_return(p_self->compiler->coro, "void", NULL, p_self->body);
+			p_self->terminated = true;
+			return;
+		}
+
+		codegen___terminate(p_self, p_self->main ? "ret i32 0" : "ret void");
+		return;
+	}
+
+	type_id_t type = codegen___expression(p_self, lp_node->lhs, value);
+
+	if (p_self->terminated) { // A self tail call, which jumped back to the start
+		return;
+	}
+
+	codegen___transfer(p_self, lp_node->lhs, type, value);
+	codegen___coerce(p_self, node, type, p_self->returnType, value);
+	codegen___storage_type(p_self, node, p_self->returnType, llvmType);
+
+	if (codegen___by_value(p_self, p_self->returnType)) { // Returned as a value, not a pointer
+		char loaded[CODEGEN_OPERAND_LENGTH];
+
+		codegen___temporary(p_self, loaded);
+		codegen___emit(p_self, "%s = load %s, %s* %s", loaded, llvmType, llvmType, value);
+		snprintf(value, sizeof(value), "%s", loaded);
+	}
+
+	codegen___leave_arenas(p_self); // The value cannot hold their memory, regions checked it
+
+	if (p_self->coroutine != CORO_NONE) { // Into the task's promise, for its awaiter to read
+		coroutines_emit_return(p_self->compiler->coro, llvmType, value, p_self->body);
+		p_self->terminated = true;
+		return;
+	}
+
+	codegen___terminate(p_self, "ret %s %s", llvmType, value);
+}
+
+void codegen___statement(struct Codegen* p_self, flat_ast_index_t node);
+
+/**
+ * Emits a block, in a new scope.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The block's node.
+ */
+void codegen___block(struct Codegen* p_self, flat_ast_index_t node) {
+	const struct FlatAST*	  lp_ast  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_node = flat_ast_get(lp_ast, node);
+	bool					  arena	  = attributes_has(lp_ast, node, ATTRIBUTE_ARENA);
+
+	if (arena) { // Entered as the default allocator of the arrays and strings made in the block
+		regions_emit_enter(p_self->compiler->regions, node, p_self->entry, p_self->body);
+		p_self->arenas = buffer_grow(p_self->arenas, &p_self->arenaCapacity, p_self->arenaCount + 1,
+									 sizeof(flat_ast_index_t));
+		p_self->arenas[p_self->arenaCount++] = node;
+	}
+
+	codegen___push_scope(p_self);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		codegen___statement(p_self, flat_ast_get_list_item(lp_ast, lp_node, index));
+	}
+
+	codegen___pop_scope(p_self);
+
+	if (arena) { // Releases everything allocated in it at once, unless a 'return' already did
+		if (!p_self->terminated) {
+			regions_emit_leave(p_self->compiler->regions, node, p_self->body);
+		}
+
+		p_self->arenaCount--;
+	}
+}
+
+/**
+ * Emits an 'if' with its 'elif' and 'else' branches.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The IF node.
+ */
+void codegen___if(struct Codegen* p_self, flat_ast_index_t node) {
+	const struct FlatAST*	  lp_ast  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_node = flat_ast_get(lp_ast, node);
+	char					  end[CODEGEN_NAME_LENGTH];
+
+	codegen___label_name(p_self, "if.end", end);
+
+	for (size_t index = 0; index <= lp_node->value.list.length; index++) {
+		flat_ast_index_t branch = index ? flat_ast_get_list_item(lp_ast, lp_node, index - 1) : node;
+		const struct FlatASTNode* lp_branch = flat_ast_get(lp_ast, branch);
+		char					  condition[CODEGEN_OPERAND_LENGTH];
+		char					  then[CODEGEN_NAME_LENGTH];
+		char					  next[CODEGEN_NAME_LENGTH];
+
+		if (lp_branch->kind != FLATAST_IF) { // The 'else' block
+			codegen___block(p_self, branch);
+			break;
+		}
+
+		codegen___label_name(p_self, "if.then", then);
+		codegen___label_name(p_self, "if.next", next);
+		codegen___expression(p_self, lp_branch->lhs, condition);
+		codegen___terminate(p_self, "br i1 %s, label %%%s, label %%%s", condition, then, next);
+
+		codegen___label(p_self, then);
+		codegen___block(p_self, lp_branch->rhs);
+
+		if (!p_self->terminated) {
+			codegen___terminate(p_self, "br label %%%s", end);
+		}
+
+		codegen___label(p_self, next);
+	}
+
+	codegen___label(p_self, end);
+}
+
+/**
+ * Emits a 'while' loop.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The WHILE node.
+ */
+void codegen___while(struct Codegen* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	char					  condition[CODEGEN_OPERAND_LENGTH];
+	char					  header[CODEGEN_NAME_LENGTH];
+	char					  body[CODEGEN_NAME_LENGTH];
+	char					  end[CODEGEN_NAME_LENGTH];
+
+	codegen___label_name(p_self, "while.cond", header);
+	codegen___label_name(p_self, "while.body", body);
+	codegen___label_name(p_self, "while.end", end);
+
+	codegen___label(p_self, header);
+	codegen___expression(p_self, lp_node->lhs, condition);
+	codegen___terminate(p_self, "br i1 %s, label %%%s, label %%%s", condition, body, end);
+
+	codegen___label(p_self, body);
+	codegen___block(p_self, lp_node->rhs);
+
+	if (!p_self->terminated) {
+		codegen___terminate(p_self, "br label %%%s", header);
+	}
+
+	codegen___label(p_self, end);
+}
+
+/**
+ * Emits a parallel 'for' loop, 'for numbers.par() => n', through the parallel lowering. Its body
+ * is outlined into a function running a range of the iterations, which reaches the locals it reads
+ * through pointers to their slots in its context, and reduces into the partial results of its
+ * worker. The first pointer of the context is the elements of the array an array loop iterates.
+ *
+ * @param p_self The current Codegen struct.
+ * @param p_loop The loop, as analysed by loop_lowering_analyse.
+ * @param type   The type of the induction variable of a range loop, or of the array's elements.
+ */
+void codegen___parallel_for(struct Codegen* p_self, struct CountedLoop* p_loop, type_id_t type) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	struct ParallelLowering*  lp_parallel = lp_compiler->parallel;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	flat_ast_index_t		  node		  = p_loop->node;
+	type_id_t				  i64		  = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64);
+	struct String*			  lp_entry	  = p_self->entry; // Restored after the body
+	struct String*			  lp_body	  = p_self->body;
+	const struct CountedLoop* lp_outer	  = p_self->loop;
+	char					  llvmType[CODEGEN_OPERAND_LENGTH];
+	char					  begin[CODEGEN_OPERAND_LENGTH] = "0";
+	char					  end[CODEGEN_OPERAND_LENGTH];
+	char					  data[CODEGEN_OPERAND_LENGTH]	= "null";
+	char					  context[CODEGEN_OPERAND_LENGTH];
+	char					  slot[CODEGEN_OPERAND_LENGTH];
+	char					  binding[CODEGEN_OPERAND_LENGTH];
+
+	if (p_self->parallel) {
+		codegen___unsupported(p_self, node, "parallel 'for' loops in parallel loops");
+	}
+
+	parallel_lowering_analyse(lp_parallel, lp_ast, lp_compiler->inference, lp_compiler->ownership,
+							  p_self->function, p_self->params, p_self->args, p_loop);
+
+	if (p_loop->kind == LOOP_RANGE) {
+		codegen___llvm_type(p_self, node, type, llvmType);
+
+		if (p_loop->start != FLATAST_INDEX_NONE) {
+			codegen___convert(p_self, node, codegen___expression(p_self, p_loop->start, begin), i64,
+							  begin);
+		}
+
+		codegen___convert(p_self, node, codegen___expression(p_self, p_loop->end, end), i64, end);
+	} else { // The body cannot grow the array, so its elements are loaded once
+		char array[CODEGEN_OPERAND_LENGTH];
+
+		codegen___storage_type(p_self, node, type, llvmType);
+		codegen___expression(p_self, p_loop->iterable, array);
+		codegen___temporary(p_self, end);
+		codegen___emit(p_self, "%s = call i64 @array_SEP_length(%%array* %s)", end, array);
+		codegen___temporary(p_self, data);
+		codegen___emit(p_self, "%s.ptr = getelementptr inbounds %%array, %%array* %s, i64 0, i32 0",
+					   data, array);
+		codegen___emit(p_self, "%s = load i8*, i8** %s.ptr", data, data);
+	}
+
+	// [1 + captures x i8*], pointing to the array's elements, then to the locals the body reads
+	size_t	   captureCount = lp_parallel->captureCount;
+	char	   contextType[CODEGEN_OPERAND_LENGTH];
+	char(*lp_reductions)[CODEGEN_OPERAND_LENGTH] =
+		malloc((lp_parallel->reductionCount + 1) * CODEGEN_OPERAND_LENGTH);
+	const char** lp_variables = malloc((lp_parallel->reductionCount + 1) * sizeof(char*));
+
+	if (!lp_reductions || !lp_variables) {
+		PANIC("failed to malloc parallel loop reductions");
+	}
+
+	snprintf(contextType, sizeof(contextType), "[%zu x i8*]", captureCount + 1);
+	codegen___alloca(p_self, contextType, context);
+	codegen___emit(p_self, "%s.0 = getelementptr inbounds %s, %s* %s, i64 0, i64 0", context,
+				   contextType, contextType, context);
+	codegen___emit(p_self, "store i8* %s, i8** %s.0", data, context);
+
+	for (size_t index = 0; index < captureCount; index++) {
+		const char*				   lp_name	= lp_parallel->captures[index];
+		const struct CodegenLocal* lp_local = codegen___find_local(
+			p_self, interner_intern(lp_compiler->interner, lp_name));
+		char storageType[CODEGEN_OPERAND_LENGTH];
+
+		if (!lp_local || parallel_lowering_get_reduction(lp_parallel, lp_name)) {
+			continue;
+		}
+
+		codegen___slot(p_self, lp_local, slot);
+		codegen___storage_type(p_self, node, lp_local->type, storageType);
+		codegen___emit(p_self, "%s.%zu = getelementptr inbounds %s, %s* %s, i64 0, i64 %zu",
+					   context, index + 1, contextType, contextType, context, index + 1);
+		codegen___emit(p_self, "%s.%zu.raw = bitcast %s* %s to i8*", context, index + 1,
+					   storageType, slot);
+		codegen___emit(p_self, "store i8* %s.%zu.raw, i8** %s.%zu", context, index + 1, context,
+					   index + 1);
+	}
+
+	for (size_t index = 0; index < lp_parallel->reductionCount; index++) {
+		const struct CodegenLocal* lp_local = codegen___find_local(
+			p_self, interner_intern(lp_compiler->interner, lp_parallel->reductions[index].name));
+
+		codegen___slot(p_self, lp_local, lp_reductions[index]);
+		lp_variables[index] = lp_reductions[index];
+	}
+
+	// The outlined body, whose locals are allocated in its own entry block
+	struct String* lp_header   = string_new("\0", true);
+	struct String* lp_iterations = string_new("\0", true);
+
+	codegen___temporary(p_self, binding);
+	parallel_lowering_emit_begin(lp_parallel, lp_compiler->loops, p_loop, binding, llvmType,
+								 lp_header);
+	p_self->entry	   = string_new("\0", true);
+	p_self->body	   = p_self->entry;
+	p_self->parallel   = true;
+	p_self->terminated = false;
+
+	codegen___emit(p_self, "%%par.slots = bitcast i8* %%par.context to i8**");
+
+	for (size_t index = 0; index < captureCount; index++) {
+		const char*				   lp_name	= lp_parallel->captures[index];
+		const struct CodegenLocal* lp_local = codegen___find_local(
+			p_self, interner_intern(lp_compiler->interner, lp_name));
+		char storageType[CODEGEN_OPERAND_LENGTH];
+
+		if (!lp_local || parallel_lowering_get_reduction(lp_parallel, lp_name)) {
+			continue;
+		}
+
+		codegen___slot(p_self, lp_local, slot);
+		codegen___storage_type(p_self, node, lp_local->type, storageType);
+		codegen___emit(p_self,
+					   "%%par.slot.%zu = getelementptr inbounds i8*, i8** %%par.slots, i64 %zu",
+					   index + 1, index + 1);
+		codegen___emit(p_self, "%%par.slot.%zu.raw = load i8*, i8** %%par.slot.%zu", index + 1,
+					   index + 1);
+		codegen___emit(p_self, "%s = bitcast i8* %%par.slot.%zu.raw to %s*", slot, index + 1,
+					   storageType);
+	}
+
+	p_self->body = lp_iterations;
+
+	for (size_t index = 0; index < lp_parallel->reductionCount; index++) { // Into the partials
+		const char*				   lp_name	= lp_parallel->reductions[index].name;
+		const struct CodegenLocal* lp_local = codegen___find_local(
+			p_self, interner_intern(lp_compiler->interner, lp_name));
+		char storageType[CODEGEN_OPERAND_LENGTH];
+
+		codegen___storage_type(p_self, node, lp_local->type, storageType);
+		codegen___emit(p_self, "%s = bitcast %s* %%%s.partial to %s*", lp_reductions[index],
+					   storageType, lp_name, storageType);
+	}
+
+	codegen___push_scope(p_self);
+	codegen___slot(p_self, codegen___declare_local(p_self, p_loop->binding, type), slot);
+
+	if (p_loop->kind == LOOP_RANGE) {
+		codegen___emit(p_self, "store %s %s, %s* %s", llvmType, binding, llvmType, slot);
+	} else {
+		char elements[CODEGEN_OPERAND_LENGTH];
+		char element[CODEGEN_OPERAND_LENGTH];
+
+		codegen___temporary(p_self, elements);
+		codegen___emit(p_self, "%s.raw = load i8*, i8** %%par.slots", elements);
+		codegen___emit(p_self, "%s = bitcast i8* %s.raw to %s*", elements, elements, llvmType);
+		codegen___temporary(p_self, element);
+		loop_lowering_emit_element(p_loop, llvmType, elements, element, p_self->body);
+		codegen___emit(p_self, "store %s %s, %s* %s", llvmType, element, llvmType, slot);
+	}
+
+	p_self->loop = p_loop;
+	codegen___block(p_self, flat_ast_get(lp_ast, node)->rhs);
+	p_self->loop = lp_outer;
+
+	if (p_self->terminated) {
+		char dead[CODEGEN_NAME_LENGTH];
+
+		codegen___label_name(p_self, "dead", dead);
+		codegen___label(p_self, dead);
+	}
+
+	parallel_lowering_emit_end(lp_parallel, p_loop, lp_iterations);
+	codegen___pop_scope(p_self);
+
+	// The header, with the body's allocas at the start of its entry block, then the body
+	const char* lp_start  = strstr(lp_header->_value, "\nentry:\n") + strlen("\nentry:\n");
+	size_t		headerLength = (size_t)(lp_start - lp_header->_value);
+
+	string_append_bytes(p_self->outlined, lp_header->_value, headerLength);
+	string_append_bytes(p_self->outlined, p_self->entry->_value, p_self->entry->length);
+	string_append_bytes(p_self->outlined, lp_start, lp_header->length - headerLength);
+	string_append_bytes(p_self->outlined, lp_iterations->_value, lp_iterations->length);
+
+	string_free(&p_self->entry);
+	string_free(&lp_iterations);
+	string_free(&lp_header);
+	p_self->entry	   = lp_entry;
+	p_self->body	   = lp_body;
+	p_self->parallel   = false;
+	p_self->terminated = false;
+
+	char raw[CODEGEN_OPERAND_LENGTH];
+
+	codegen___temporary(p_self, raw);
+	codegen___emit(p_self, "%s = bitcast %s* %s to i8*", raw, contextType, context);
+	parallel_lowering_emit_run(lp_parallel, begin, end, raw, lp_variables, p_self->body,
+							   p_self->outlined);
+
+	free(lp_variables);
+	free(lp_reductions);
+}
+
+/**
+ * Emits a 'for' loop over a generator, resuming it for each value until it completes, then
+ * destroying it.
+ *
+ * @param p_self The current Codegen struct.
+ * @param p_loop The loop, which iterates its iterable through an iterator.
+ */
+void codegen___generator_for(struct Codegen* p_self, const struct CountedLoop* p_loop) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_compiler->ast, p_loop->node);
+	type_id_t				  type		  = codegen___node_type(p_self, lp_node->lhs);
+	const struct Type*		  lp_type	  = type_table_get(lp_compiler->types, type);
+	char					  generator[CODEGEN_OPERAND_LENGTH];
+	char					  llvmType[CODEGEN_OPERAND_LENGTH];
+	char					  done[CODEGEN_OPERAND_LENGTH];
+	char					  value[CODEGEN_OPERAND_LENGTH];
+	char					  slot[CODEGEN_OPERAND_LENGTH];
+	char					  next[CODEGEN_NAME_LENGTH];
+	char					  body[CODEGEN_NAME_LENGTH];
+	char					  end[CODEGEN_NAME_LENGTH];
+
+	if (lp_node->value.list.length != 1 || !codegen___is_handle(p_self, type)
+		|| strcmp(interner_get(lp_compiler->interner, lp_type->name), CORO_GENERATOR_TYPE) != 0) {
+		codegen___unsupported(p_self, p_loop->node, "'for' loops over iterators");
+	}
+
+	type_id_t element = type_table_get_args(lp_compiler->types, type)[0];
+
+	codegen___expression(p_self, lp_node->lhs, generator);
+	codegen___storage_type(p_self, p_loop->node, element, llvmType);
+	codegen___label_name(p_self, "generator.next", next);
+	codegen___label_name(p_self, "generator.body", body);
+	codegen___label_name(p_self, "generator.end", end);
+
+	codegen___push_scope(p_self);
+	codegen___slot(p_self, codegen___declare_local(p_self, p_loop->binding, element), slot);
+	codegen___label(p_self, next);
+	codegen___temporary(p_self, done);
+	codegen___temporary(p_self, value);
+	coroutines_emit_next(lp_compiler->coro, generator, llvmType, done, value, p_self->body,
+						 p_self->globals);
+	codegen___terminate(p_self, "br i1 %s, label %%%s, label %%%s", done, end, body);
+	codegen___label(p_self, body);
+	codegen___emit(p_self, "store %s %s, %s* %s", llvmType, value, llvmType, slot);
+	codegen___block(p_self, lp_node->rhs);
+	codegen___pop_scope(p_self);
+
+	if (!p_self->terminated) {
+		codegen___terminate(p_self, "br label %%%s", next);
+	}
+
+	codegen___label(p_self, end);
+	coroutines_emit_destroy(lp_compiler->coro, generator, p_self->body, p_self->globals);
+}
+
+/**
+ * Emits a 'for' loop over a range or an array as a counted loop: an integer induction variable
+ * stepping by one towards a bound computed once, which LLVM can unroll and vectorize. Other for
+ * loops go through an iterator, of which only generators are supported.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The FOR node.
+ */
+void codegen___for(struct Codegen* p_self, flat_ast_index_t node) {
+	struct Compiler*	  lp_compiler = p_self->compiler;
+	const struct FlatAST* lp_ast	  = lp_compiler->ast;
+	struct CountedLoop	  loop;
+	char				  llvmType[CODEGEN_OPERAND_LENGTH];
+	char				  elementType[CODEGEN_OPERAND_LENGTH];
+	char				  start[CODEGEN_OPERAND_LENGTH] = "0";
+	char				  end[CODEGEN_OPERAND_LENGTH];
+	char				  array[CODEGEN_OPERAND_LENGTH];
+	char				  index[CODEGEN_OPERAND_LENGTH];
+	char				  slot[CODEGEN_OPERAND_LENGTH];
+
+	const struct CountedLoop* lp_outer = p_self->loop; // Restored after the body
+
+	if (loop_lowering_analyse(lp_compiler->loops, lp_ast, lp_compiler->inference,
+							  lp_compiler->types, node, &loop)
+		== LOOP_GENERIC) {
+		codegen___generator_for(p_self, &loop);
+
+		return;
+	}
+
+	type_id_t type = codegen___type(p_self, loop.type); // Of the induction variable or elements
+
+	if (loop.parallel) {
+		codegen___parallel_for(p_self, &loop, type);
+
+		return;
+	}
+
+	if (loop.kind == LOOP_RANGE) {
+		codegen___llvm_type(p_self, node, type, llvmType);
+
+		if (loop.start != FLATAST_INDEX_NONE) {
+			codegen___convert(p_self, node, codegen___expression(p_self, loop.start, start), type,
+							  start);
+		}
+
+		codegen___convert(p_self, node, codegen___expression(p_self, loop.end, end), type, end);
+	} else { // Over the indexes of the array, up to its length when the loop starts, or when an
+			 // iteration starts if the loop is checked
+		snprintf(llvmType, sizeof(llvmType), "i64");
+		codegen___storage_type(p_self, node, type, elementType);
+		codegen___expression(p_self, loop.iterable, array);
+		codegen___temporary(p_self, end);
+		codegen___emit(p_self, "%s = call i64 @array_SEP_length(%%array* %s)", end, array);
+	}
+
+	codegen___push_scope(p_self);
+	codegen___slot(p_self, codegen___declare_local(p_self, loop.binding, type), slot);
+	codegen___temporary(p_self, index);
+	loop_lowering_emit_begin(lp_compiler->loops, &loop, llvmType, start, end, index,
+							 p_self->body);
+	p_self->terminated = false;
+
+	if (loop.kind == LOOP_RANGE) {
+		codegen___emit(p_self, "store %s %s, %s* %s", llvmType, index, llvmType, slot);
+	} else { // The elements are loaded again each iteration, as the body can grow the array
+		char data[CODEGEN_OPERAND_LENGTH];
+		char element[CODEGEN_OPERAND_LENGTH];
+
+		if (loop.checked) { // And the array itself, as the body can shrink or replace it
+			codegen___expression(p_self, loop.iterable, array);
+			loop_lowering_emit_check(&loop, array, p_self->body);
+		}
+
+		codegen___temporary(p_self, data);
+		codegen___emit(p_self, "%s.ptr = getelementptr inbounds %%array, %%array* %s, i64 0, i32 0",
+					   data, array);
+		codegen___emit(p_self, "%s.raw = load i8*, i8** %s.ptr", data, data);
+		codegen___emit(p_self, "%s = bitcast i8* %s.raw to %s*", data, data, elementType);
+		codegen___temporary(p_self, element);
+		loop_lowering_emit_element(&loop, elementType, data, element, p_self->body);
+		codegen___emit(p_self, "store %s %s, %s* %s", elementType, element, elementType, slot);
+	}
+
+	p_self->loop = &loop;
+	codegen___block(p_self, flat_ast_get(lp_ast, node)->rhs);
+	p_self->loop = lp_outer;
+
+	if (p_self->terminated) { // e.g. after a 'return', the latch is unreachable but must be valid
+		char dead[CODEGEN_NAME_LENGTH];
+
+		codegen___label_name(p_self, "dead", dead);
+		codegen___label(p_self, dead);
+	}
+
+	loop_lowering_emit_end(&loop, p_self->body);
+	codegen___pop_scope(p_self);
+}
+
+/**
+ * Walks a pattern of a match. Before the match, the structs it destructures are declared, so
+ * their fields can be tested. In its case, its bindings are declared as locals holding the parts
+ * of the value it matched.
+ *
+ * @param p_self    The current Codegen struct.
+ * @param pattern   The pattern's node.
+ * @param p_value   The value it matched, a pointer for structs, NULL to declare its structs.
+ */
+void codegen___pattern(struct Codegen* p_self, flat_ast_index_t pattern, const char* p_value) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	const struct FlatASTNode* lp_pattern  = flat_ast_get(lp_ast, pattern);
+	type_id_t				  type		  = codegen___node_type(p_self, pattern);
+
+	if (lp_pattern->kind == FLATAST_VARIABLE && p_value
+		&& strcmp(flat_ast_get_string(lp_ast, lp_pattern->value.string), "_") != 0) {
+		char slot[CODEGEN_OPERAND_LENGTH];
+
+		codegen___slot(p_self, codegen___declare_local(p_self, pattern, type), slot);
+		codegen___store(p_self, pattern, type, p_value, slot);
+	}
+
+	if (lp_pattern->kind != FLATAST_STRUCT_LITERAL) {
+		return;
+	}
+
+	uint32_t layout = codegen___struct(p_self, pattern, type);
+
+	for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+		flat_ast_index_t		  field	   = flat_ast_get_list_item(lp_ast, lp_pattern, index);
+		const struct FlatASTNode* lp_field = flat_ast_get(lp_ast, field);
+		char					  pointer[CODEGEN_OPERAND_LENGTH];
+		char					  value[CODEGEN_OPERAND_LENGTH];
+
+		if (!p_value) {
+			codegen___pattern(p_self, lp_field->lhs, NULL);
+			continue;
+		}
+
+		codegen___temporary(p_self, pointer);
+		layout_emit_field(
+			lp_compiler->layouts, layout,
+			layout_get_field(lp_compiler->layouts, layout,
+							 interner_intern(lp_compiler->interner,
+											 flat_ast_get_string(lp_ast, lp_field->value.string))),
+			p_value, pointer, p_self->body);
+		codegen___load(p_self, field, codegen___node_type(p_self, field), pointer, value);
+		codegen___pattern(p_self, lp_field->lhs, value);
+	}
+}
+
+/**
+ * Emits a 'match', as a decision tree branching to the first case whose pattern matches. Nothing
+ * runs if no case does.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The MATCH node.
+ */
+void codegen___match_statement(struct Codegen* p_self, flat_ast_index_t node) {
+	struct Compiler*		  lp_compiler = p_self->compiler;
+	const struct FlatAST*	  lp_ast	  = lp_compiler->ast;
+	const struct FlatASTNode* lp_node	  = flat_ast_get(lp_ast, node);
+	size_t					  count		  = lp_node->value.list.length;
+	char(*lp_labels)[CODEGEN_NAME_LENGTH] = calloc(count ? count : 1, CODEGEN_NAME_LENGTH);
+	const char** lp_pointers			  = calloc(count ? count : 1, sizeof(const char*));
+	char		 scrutinee[CODEGEN_OPERAND_LENGTH];
+	char		 end[CODEGEN_NAME_LENGTH];
+
+	if (!lp_labels || !lp_pointers) {
+		PANIC("failed to malloc Codegen match labels");
+	}
+
+	codegen___expression(p_self, lp_node->lhs, scrutinee);
+
+	for (size_t index = 0; index < count; index++) { // Declares the structs the patterns test
+		flat_ast_index_t item = flat_ast_get_list_item(lp_ast, lp_node, index);
+
+		codegen___pattern(p_self, flat_ast_get(lp_ast, item)->lhs, NULL);
+		codegen___label_name(p_self, "case", lp_labels[index]);
+		lp_pointers[index] = lp_labels[index];
+	}
+
+	codegen___label_name(p_self, "match.end", end);
+	match_lowering_analyse(lp_compiler->matches, lp_ast, lp_compiler->inference,
+						   lp_compiler->layouts, node, scrutinee);
+	match_lowering_emit(lp_compiler->matches, lp_pointers, end, p_self->body);
+	p_self->terminated = true;
+
+	for (size_t index = 0; index < count; index++) {
+		const struct FlatASTNode* lp_case =
+			flat_ast_get(lp_ast, flat_ast_get_list_item(lp_ast, lp_node, index));
+
+		codegen___label(p_self, lp_labels[index]);
+		codegen___push_scope(p_self); // Bindings only live in their case
+		codegen___pattern(p_self, lp_case->lhs, scrutinee);
+		codegen___block(p_self, lp_case->rhs);
+		codegen___pop_scope(p_self);
+
+		if (!p_self->terminated) {
+			codegen___terminate(p_self, "br label %%%s", end);
+		}
+	}
+
+	codegen___label(p_self, end);
+
+	free(lp_labels);
+	free(lp_pointers);
+}
+
+/**
+ * Emits a statement of the function being emitted.
+ *
+ * @param p_self The current Codegen struct.
+ * @param node   The statement's node.
+ */
+void codegen___statement(struct Codegen* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->compiler->ast, node);
+	char					  value[CODEGEN_OPERAND_LENGTH];
+
+	if (p_self->terminated) { // Unreachable, e.g. after a 'return', but must still be valid
+		char dead[CODEGEN_NAME_LENGTH];
+
+		codegen___label_name(p_self, "dead", dead);
+		codegen___label(p_self, dead);
+	}
+
+	switch (lp_node->kind) {
+	case FLATAST_ASSIGNMENT:
+		if (flat_ast_get(p_self->compiler->ast, lp_node->rhs)->kind == FLATAST_FUNCTION) {
+			codegen___unsupported(p_self, node, "nested functions");
+		}
+
+		codegen___assignment(p_self, node);
+		break;
+	case FLATAST_BLOCK:
+		codegen___block(p_self, node);
+		break;
+	case FLATAST_IF:
+		codegen___if(p_self, node);
+		break;
+	case FLATAST_WHILE:
+		codegen___while(p_self, node);
+		break;
+	case FLATAST_RETURN:
+		codegen___return(p_self, node);
+		break;
+	case FLATAST_FOR:
+		codegen___for(p_self, node);
+		break;
+	case FLATAST_MATCH:
+		codegen___match_statement(p_self, node);
+		break;
+	default:
+		codegen___expression(p_self, node, value);
+		break;
+	}
+}
+
+/**
+ * Emits a function, or an instance of a generic function.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param function The FUNCTION node.
+ * @param p_symbol The function's symbol, e.g. '@"shapes::add"'.
+ * @param type     The function's type, with no type parameters left.
+ * @param params   Tuple of the type parameters of the instance, TYPE_ID_NONE if not generic.
+ * @param args     Tuple of their type arguments.
+ * @param p_output Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void codegen___function(struct Codegen* p_self, flat_ast_index_t function, const char* p_symbol,
+						type_id_t type, type_id_t params, type_id_t args, struct String* p_output) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	const struct FlatAST*	  lp_ast	  = p_self->compiler->ast;
+	const struct FlatASTNode* lp_function = flat_ast_get(lp_ast, function);
+	const type_id_t*		  lp_types	  = type_table_get_args(p_self->compiler->types, type);
+	uint32_t paramCount = type_table_get(p_self->compiler->types, type)->argCount - 1;
+	char	 llvmType[CODEGEN_OPERAND_LENGTH];
+	char	 valueType[CODEGEN_OPERAND_LENGTH] = "void"; // What a coroutine returns or yields
+	char	 line[CODEGEN_LINE_LENGTH];
+
+	p_self->function   = function;
+	p_self->params	   = params;
+	p_self->args	   = args;
+	p_self->type	   = type;
+	p_self->returnType = lp_types[paramCount];
+	p_self->yieldType  = TYPE_ID_NONE;
+	p_self->coroutine  = coroutines_analyse(p_self->compiler->coro, lp_ast, function);
+	p_self->terminated = false;
+	p_self->looping	   = false;
+	p_self->temporaries = 0;
+	p_self->labels		= 0;
+	p_self->localCount	= 0;
+	p_self->scopeCount	= 0;
+	p_self->arenaCount	= 0;
+	string_clear(p_self->entry);
+	string_clear(p_self->body);
+
+	if (p_self->main && (paramCount > 0 || codegen___primitive(p_self, p_self->returnType)
+											   != TYPE_PRIMITIVE_VOID)) {
+		codegen___unsupported(p_self, function, "'main' functions with parameters or results");
+	}
+
+	if (p_self->coroutine != CORO_NONE) { // Returns its handle, its value goes in its promise
+		type_id_t value = type_table_get_args(p_self->compiler->types, p_self->returnType)[0];
+
+		if (p_self->coroutine == CORO_GENERATOR) {
+			p_self->yieldType  = value;
+			p_self->returnType = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+		} else {
+			p_self->returnType = value;
+		}
+
+		codegen___storage_type(p_self, function, value, valueType);
+	}
+
+	codegen___storage_type(p_self, function, lp_types[paramCount], llvmType);
+	// Instances are emitted by each module calling them, so they are kept to the module
+	snprintf(line, sizeof(line), "define %s%s %s(",
+			 p_self->instance != MONO_INSTANCE_NONE ? "internal " : "",
+			 p_self->main ? "i32" : llvmType, p_symbol);
+	string_append_str(p_output, line);
+	codegen___push_scope(p_self);
+
+	struct String* lp_body = p_self->body;
+
+	if (p_self->coroutine == CORO_NONE) { // Stored once, before self tail calls loop
+		p_self->body = p_self->entry;
+	} // Else after the coroutine's frame is allocated, as it holds them across suspensions
+
+	for (uint32_t index = 0; index < paramCount; index++) {
+		flat_ast_index_t		   param   = flat_ast_get_list_item(lp_ast, lp_function, index);
+		const struct CodegenLocal* lp_local =
+			codegen___declare_local(p_self, param, lp_types[index]);
+		char					   slot[CODEGEN_OPERAND_LENGTH];
+		char					   value[CODEGEN_OPERAND_LENGTH];
+
+		codegen___llvm_type(p_self, param, lp_types[index], llvmType);
+		snprintf(line, sizeof(line), "%s%s %%p.%" PRIu32, index ? ", " : "", llvmType, index);
+		string_append_str(p_output, line);
+
+		snprintf(value, sizeof(value), "%%p.%" PRIu32, index);
+		codegen___slot(p_self, lp_local, slot);
+		codegen___store(p_self, param, lp_local->type, value, slot);
+	}
+
+	p_self->body = lp_body;
+	codegen___block(p_self, lp_function->rhs);
+	codegen___pop_scope(p_self);
+
+	if (!p_self->terminated && p_self->coroutine != CORO_NONE
+		&& codegen___primitive(p_self, p_self->returnType) == TYPE_PRIMITIVE_VOID) {
+		coroutines_emit_return(p_self->compiler->coro, "void", NULL, p_self->body);
+		p_self->terminated = true;
+	}
+
+	if (!p_self->terminated) { // Falling off the end returns nothing
+		codegen___terminate(p_self,
+							p_self->main ? "ret i32 0"
+							: codegen___primitive(p_self, p_self->returnType) == TYPE_PRIMITIVE_VOID
+								? "ret void"
+								: "unreachable");
+	}
+
+	string_append_str(p_output,
+					  p_self->coroutine != CORO_NONE ? ") " CORO_ATTRIBUTES " {\nentry:\n"
+													 : ") {\nentry:\n");
+	string_append_bytes(p_output, p_self->entry->_value, p_self->entry->length);
+
+	if (p_self->coroutine != CORO_NONE) {
+		coroutines_emit_begin(p_self->compiler->coro, valueType, p_output, p_self->globals);
+	}
+
+	if (p_self->looping) {
+		tail_calls_emit_header(p_output);
+	} else {
+		string_append_str(p_output, "  br label %body\nbody:\n");
+	}
+
+	string_append_bytes(p_output, p_self->body->_value, p_self->body->length);
+
+	if (p_self->coroutine != CORO_NONE) { // Its final suspension, and the blocks freeing its frame
+		coroutines_emit_end(p_self->compiler->coro, p_output);
+		string_append_chr(p_output, '\n');
+	} else {
+		string_append_str(p_output, "}\n\n");
+	}
+
+	string_append_bytes(p_self->functions, p_self->outlined->_value, p_self->outlined->length);
+	string_clear(p_self->outlined);
+}
+
+void codegen_module(struct Codegen* p_self, struct String* p_output) {
+	struct Compiler* lp_compiler = p_self->compiler;
+
+	for (size_t index = 0; index < lp_compiler->functionCount; index++) {
+		const struct CodegenFunction* lp_function = &lp_compiler->functions[index];
+		const struct SymbolBinding*	  lp_binding =
+			symbol_table_get(lp_compiler->symbols, lp_function->binding);
+		const char* lp_name = interner_get(lp_compiler->interner, lp_binding->name);
+		char		name[CODEGEN_OPERAND_LENGTH];
+		char		symbol[CODEGEN_SYMBOL_LENGTH];
+
+		if (type_table_get(lp_compiler->types, lp_binding->type)->flags & TYPE_FLAG_GENERIC) {
+			continue; // Emitted for each of the type arguments it is called with
+		}
+
+		p_self->main = strcmp(lp_name, "main") == 0;
+		codegen___symbol(p_self, lp_name, name);
+		snprintf(symbol, sizeof(symbol), "@\"%s\"", name);
+
+		if (lp_function->memo.strategy != MEMO_NONE) { // Its body, behind the cache's wrapper
+			snprintf(symbol, sizeof(symbol), "@\"%s" MEMO_UNCACHED_SUFFIX "\"", name);
+			memo_emit(lp_compiler->memo, &lp_function->memo, name, p_self->functions);
+		}
+
+		codegen___function(p_self, lp_function->function, symbol, lp_binding->type,
+						   TYPE_ID_NONE, TYPE_ID_NONE, p_self->functions);
+		p_self->main = false;
+	}
+
+	struct String* lp_instance = string_new("\0", true);
+	uint32_t	   instance	   = MONO_INSTANCE_NONE;
+
+	while (mono_next(lp_compiler->mono, &instance)) { // Emitting an instance can use more instances
+		struct MonoInstance copy = *mono_get(lp_compiler->mono, instance);
+		char				llvmType[CODEGEN_OPERAND_LENGTH];
+
+		string_clear(lp_instance);
+		p_self->instance = instance;
+		codegen___function(p_self, copy.declaration, MONO_SELF_PLACEHOLDER, copy.type, copy.params,
+						   copy.args, lp_instance);
+		codegen___llvm_type(p_self, copy.declaration, copy.type, llvmType);
+		llvmType[strlen(llvmType) - 1] = '\0'; // The function, not the pointer to it
+		mono_emit(lp_compiler->mono, instance, llvmType, lp_instance->_value, p_self->functions);
+	}
+
+	p_self->instance = MONO_INSTANCE_NONE;
+	string_free(&lp_instance);
+
+	while (p_self->pendingCount > 0) { // Declaring a struct can use more structs
+		type_id_t type = p_self->pending[--p_self->pendingCount];
+
+		codegen___struct(p_self, FLATAST_INDEX_NONE, type);
+	}
+
+	string_append_bytes(p_output, g_CODEGEN_PRELUDE, strlen(g_CODEGEN_PRELUDE));
+	string_append_bytes(p_output, p_self->types->_value, p_self->types->length);
+	string_append_chr(p_output, '\n');
+	string_append_bytes(p_output, p_self->globals->_value, p_self->globals->length);
+	string_append_chr(p_output, '\n');
+	string_append_bytes(p_output, p_self->functions->_value, p_self->functions->length);
+}
+
+void codegen_entry(struct Codegen* p_self, struct String* p_output) {
+	struct Compiler* lp_compiler = p_self->compiler;
+	uint32_t		 binding =
+		symbol_table_resolve(lp_compiler->symbols, interner_intern(lp_compiler->interner, "main"));
+
+	if (binding == SYMBOL_BINDING_NONE
+		|| symbol_table_get(lp_compiler->symbols, binding)->kind != SYMBOL_FUNCTION) {
+		return;
+	}
+
+	char line[CODEGEN_LINE_LENGTH];
+
+	// declare i32 @"<module>::main"()
+	//
+	// define i32 @main() {
+	//   %status = call i32 @"<module>::main"()
+	//   ret i32 %status
+	// }
+	snprintf(line, sizeof(line),
+			 "declare i32 @\"%s::main\"()\n\n"
+			 "define i32 @main() {\n  %%status = call i32 @\"%s::main\"()\n  ret i32 %%status\n}\n",
+			 p_self->module, p_self->module);
+	string_append_str(p_output, line);
+}
@@ -0,0 +1,126 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./coro.h"
+#include "./loops.h"
+#include "./memo.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CODEGEN_OPERAND_LENGTH 512U	 // The longest operand, e.g. a constant expression.
+#define CODEGEN_LINE_LENGTH	   2048U // The longest instruction.
+
+/**
+ * Represents a function or method declared at the top level of a module.
+ */
+struct CodegenFunction {
+	flat_ast_index_t function; // The FUNCTION node.
+	uint32_t		 binding;  // The function's binding, named e.g. 'add' or 'Stack.push'.
+	type_id_t		 selfType; // The type methods are declared on, e.g. 'Stack<T>', else none.
+	type_id_t		 params;   // Tuple of the type parameters the function is generic over.
+	uint8_t			 state;	   // Whether its inference has not started, is running or is done.
+	struct MemoPlan	 memo;	   // How its results are cached, if it is marked '@memo'.
+};
+
+#define CODEGEN_FUNCTION_SIZE sizeof(struct CodegenFunction)
+
+/**
+ * Represents a local of the function being emitted, stored in an 'alloca' of the entry block.
+ */
+struct CodegenLocal {
+	intern_id_t		 name;
+	flat_ast_index_t declaration; // The declaring node, which names the local's slot.
+	type_id_t		 type;
+};
+
+#define CODEGEN_LOCAL_SIZE sizeof(struct CodegenLocal)
+
+/**
+ * Represents the code generator of a module, emitting the LLVM IR of its functions once they have
+ * been inferred. Strings and arrays are values of 24 bytes, held by value in locals, fields and
+ * elements, and passed around as pointers to them. Structs are held by reference. Trait objects
+ * are fat pointers to a struct and its vtable, made where a struct is used as a trait. Constructs
+ * whose lowering is not supported fail with C0014, rather than emitting wrong code.
+ *
+ * Functions are emitted qualified by the module's name, e.g. '@"shapes::twice"', so the modules of
+ * a program link together without clashing, and the program's entry point '@main' calls the
+ * 'main' of the module it was built from.
+ */
+struct Codegen {
+	struct Compiler* compiler; // Not owned, the tables and passes of the module.
+	char*			 module;   // The module's name, qualifying its symbols, e.g. 'shapes'.
+	struct String*	 types;	   // Definitions of the module's struct types.
+	struct String*	 globals;  // String constants, and the imported functions called.
+	struct String*	 functions;
+	struct String*	 outlined; // Bodies of parallel loops, appended after the function emitted.
+	struct String*	 entry; // The 'alloca's of the function being emitted.
+	struct String*	 body;	// The instructions of the function being emitted.
+	struct CodegenLocal* locals;  // The locals in scope, innermost last.
+	size_t*				 scopes;  // The locals length when each open scope was opened.
+	flat_ast_index_t*	 arenas;  // The '@arena' blocks open, innermost last.
+	uint8_t*			 strings; // Whether each string constant was emitted, by intern id.
+	uint8_t*			 imported; // Whether each imported function was declared, by binding.
+	type_id_t*			 pending; // Struct types whose LLVM types are used but not yet declared.
+	const struct CountedLoop* loop; // The innermost counted loop being emitted, else NULL.
+	flat_ast_index_t	 function;	 // The FUNCTION node being emitted.
+	uint32_t			 instance;	 // The instance being emitted, else MONO_INSTANCE_NONE.
+	type_id_t			 params;	 // Tuple of the type parameters of the instance being emitted.
+	type_id_t			 args;		 // Tuple of their type arguments.
+	type_id_t			 type;		 // The type of the function being emitted.
+	type_id_t			 returnType; // The return type of the function being emitted.
+	type_id_t			 yieldType;	 // What the generator being emitted yields, else none.
+	uint8_t				 coroutine;	 // enum CoroKinds of the function being emitted.
+	bool				 main;		 // Whether the function is the program's entry point.
+	bool				 terminated; // Whether the current block has a terminator.
+	bool				 looping;	 // Whether a self tail call jumps back to the start.
+	bool				 parallel;	 // Whether the body of a parallel loop is being outlined.
+	size_t temporaries, labels, localCount, localCapacity, scopeCount, scopeCapacity, arenaCount,
+		arenaCapacity, stringCapacity, importedCapacity, pendingCount, pendingCapacity;
+};
+
+#define CODEGEN_STRUCT_SIZE sizeof(struct Codegen)
+
+/**
+ * Creates a new Codegen struct.
+ *
+ * @param p_compiler The compiler of the module.
+ *
+ * @return The created Codegen struct.
+ */
+struct Codegen* codegen_new(struct Compiler* p_compiler);
+
+/**
+ * Frees a Codegen struct.
+ *
+ * @param p_self The current Codegen struct.
+ */
+void codegen_free(struct Codegen** p_self);
+
+/**
+ * Emits the module: every function that is not generic, then every instance of a generic function
+ * they use, after the types and declarations of the runtime. Instances whose IR is identical are
+ * merged by the monomorphizer.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_output Where to append the IR.
+ */
+void codegen_module(struct Codegen* p_self, struct String* p_output);
+
+/**
+ * Emits the program's entry point, '@main', calling the module's 'main'. Emitted apart from the
+ * module, so the modules importing it can link the module without it. Nothing is emitted if the
+ * module has no 'main'.
+ *
+ * @param p_self   The current Codegen struct.
+ * @param p_output Where to append the IR.
+ */
+void codegen_entry(struct Codegen* p_self, struct String* p_output);
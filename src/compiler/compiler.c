@@ -4,27 +4,120 @@
  */
 
 #include "./compiler.h"
-#include "../parser/parser.h"
-#include "../parser/tokens.h"
+#include "./diagnostics.h"
+#include "../globals.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/files.h"
 #include "../utils/panic.h"
+#include "../utils/sha256.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-struct Compiler* compiler_new(const char* p_filePath) {
-	struct Compiler* lp_compiler = malloc(COMPILER_STRUCT_SIZE);
+#define COMPILER_FUNCTION_PENDING 0U // Not inferred yet.
+#define COMPILER_FUNCTION_RUNNING 1U // Being inferred, so calls to it are recursive.
+#define COMPILER_FUNCTION_DONE	  2U
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+struct Compiler* compiler_new(const char* p_filePath, struct Cache* p_cache, const char* p_version,
+							  const char* p_flags, struct Report* p_report,
+							  const char* p_targetFeatures) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	struct Compiler* lp_compiler = calloc(1, COMPILER_STRUCT_SIZE);
 
 	if (!lp_compiler) {
 		PANIC("failed to malloc Compiler struct");
 	}
 
-	lp_compiler->parser = parser_new(p_filePath);
+	lp_compiler->startTime = report_clock();
+	lp_compiler->filePath  = p_filePath;
+	lp_compiler->version   = p_version;
+	lp_compiler->flags	   = p_flags;
+	lp_compiler->cache	   = p_cache;
+	lp_compiler->report	   = p_report;
+	lp_compiler->generated = report_new("");
+	lp_compiler->ast	   = flat_ast_new();
+	lp_compiler->parser	   = flat_parser_new(p_filePath, lp_compiler->ast);
+	lp_compiler->interface = interface_writer_new(lp_compiler->ast);
+	lp_compiler->interner  = interner_new();
+	lp_compiler->symbols   = symbol_table_new();
+	lp_compiler->types	   = type_table_new(lp_compiler->interner);
+	lp_compiler->inference = inference_new(p_filePath, lp_compiler->interner, lp_compiler->symbols,
+										   lp_compiler->types, p_report);
+	lp_compiler->mono	   = mono_new(lp_compiler->types, lp_compiler->interner);
+	lp_compiler->devirt	   = devirt_new(p_filePath, lp_compiler->interner, lp_compiler->symbols,
+										lp_compiler->types, lp_compiler->generated);
+	lp_compiler->vtables   = vtable_table_new(lp_compiler->types, lp_compiler->interner);
+	lp_compiler->loops	   = loop_lowering_new();
+	lp_compiler->powers	   = power_lowering_new();
+	lp_compiler->comptime  = comptime_new(p_filePath, lp_compiler->ast, lp_compiler->interner);
+	lp_compiler->escape	   = escape_analysis_new(p_filePath, lp_compiler->interner,
+												 lp_compiler->types, lp_compiler->generated);
+	lp_compiler->layouts   = layout_table_new(p_filePath, lp_compiler->types,
+											  lp_compiler->interner, lp_compiler->generated);
+	lp_compiler->tailcalls = tail_calls_new(p_filePath, lp_compiler->types);
+	lp_compiler->memo	   = memo_new(p_filePath, lp_compiler->types, lp_compiler->comptime);
+	lp_compiler->matches   = match_lowering_new(p_filePath);
+	lp_compiler->simd	   = simd_lowering_new(p_filePath, lp_compiler->types, p_targetFeatures);
+	lp_compiler->parallel  = parallel_lowering_new(p_filePath, lp_compiler->types);
+	lp_compiler->coro	   = coroutines_new(p_filePath, lp_compiler->types);
+	lp_compiler->regions   = regions_new(p_filePath, lp_compiler->interner, lp_compiler->types);
+	lp_compiler->ownership = ownership_new(p_filePath, lp_compiler->interner, lp_compiler->types,
+										   lp_compiler->layouts, p_report);
+	lp_compiler->codegen   = codegen_new(lp_compiler);
+	lp_compiler->linked	   = array_new();
+	lp_compiler->output	   = string_new("\0", true);
+	lp_compiler->entry	   = string_new("\0", true);
+
+	// Every kind, so a later build requesting other reports can replay them from the cache
+	lp_compiler->generated->enabled = UINT32_MAX;
 
 	return lp_compiler;
 }
 
 void compiler_free(struct Compiler** p_self) {
 	if (p_self && *p_self) {
-		parser_free(&(*p_self)->parser);
+		flat_parser_free(&(*p_self)->parser);
+		interface_writer_free(&(*p_self)->interface);
+		flat_ast_free(&(*p_self)->ast);
+		interner_free(&(*p_self)->interner);
+		symbol_table_free(&(*p_self)->symbols);
+		type_table_free(&(*p_self)->types);
+		inference_free(&(*p_self)->inference);
+		mono_free(&(*p_self)->mono);
+		devirt_free(&(*p_self)->devirt);
+		vtable_table_free(&(*p_self)->vtables);
+		loop_lowering_free(&(*p_self)->loops);
+		power_lowering_free(&(*p_self)->powers);
+		comptime_free(&(*p_self)->comptime);
+		escape_analysis_free(&(*p_self)->escape);
+		layout_table_free(&(*p_self)->layouts);
+		tail_calls_free(&(*p_self)->tailcalls);
+		memo_free(&(*p_self)->memo);
+		match_lowering_free(&(*p_self)->matches);
+		simd_lowering_free(&(*p_self)->simd);
+		parallel_lowering_free(&(*p_self)->parallel);
+		coroutines_free(&(*p_self)->coro);
+		regions_free(&(*p_self)->regions);
+		ownership_free(&(*p_self)->ownership);
+		codegen_free(&(*p_self)->codegen);
+
+		for (size_t index = 0; index < (*p_self)->importCount; index++) {
+			interface_free(&(*p_self)->imports[index]);
+		}
+
+		for (size_t index = 0; index < (*p_self)->linked->length; index++) {
+			free((void*)(*p_self)->linked->_values[index]); // NOLINT(clang-diagnostic-cast-qual)
+		}
+
+		array_free(&(*p_self)->linked);
+		string_free(&(*p_self)->output);
+		string_free(&(*p_self)->entry);
+		report_free(&(*p_self)->generated);
+		free((*p_self)->functions);
+		free((*p_self)->imports);
+		free((*p_self)->cacheKey);
 
 		free(*p_self);
 		*p_self = NULL;
@@ -33,17 +126,854 @@ void compiler_free(struct Compiler** p_self) {
 	}
 }
 
+/**
+ * Gets the name a node holds, e.g. of a VARIABLE, interned.
+ *
+ * @param p_self The current Compiler struct.
+ * @param node   The node.
+ *
+ * @return The interned name.
+ */
+intern_id_t compiler___name(struct Compiler* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	const char*				  lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+
+	return interner_intern(p_self->interner, lp_name);
+}
+
+/**
+ * Declares a symbol of the module, erroring if the module already declares it.
+ *
+ * @param p_self      The current Compiler struct.
+ * @param node        The node declaring the symbol, for diagnostics.
+ * @param name        The interned name of the symbol.
+ * @param kind        The kind of symbol.
+ * @param declaration The declaration's node.
+ *
+ * @return The symbol's binding.
+ */
+uint32_t compiler___declare(struct Compiler* p_self, flat_ast_index_t node, intern_id_t name,
+							enum SymbolKinds kind, flat_ast_index_t declaration) {
+	uint32_t binding = symbol_table_declare(p_self->symbols, name, kind, declaration);
+
+	if (binding == SYMBOL_BINDING_NONE) {
+		compiler_error(p_self->filePath, flat_ast_get(p_self->ast, node)->line, C0002,
+					   CONCATENATE_STRING("'", interner_get(p_self->interner, name),
+										  "' is already declared"));
+	}
+
+	return binding;
+}
+
+/**
+ * Declares a function of the runtime, reached through a module, e.g. 'io::out'.
+ *
+ * @param p_self   The current Compiler struct.
+ * @param p_name   The function's qualified name.
+ * @param p_params The types of the function's parameters.
+ * @param count    The number of parameters.
+ * @param result   The function's return type.
+ */
+void compiler___declare_runtime(struct Compiler* p_self, const char* p_name,
+								const type_id_t* p_params, size_t count, type_id_t result) {
+	uint32_t binding = symbol_table_declare(
+		p_self->symbols, interner_intern(p_self->interner, p_name), SYMBOL_FUNCTION, 0);
+
+	symbol_table_get(p_self->symbols, binding)->type =
+		type_table_function(p_self->types, p_params, count, result);
+}
+
+/**
+ * Gets the path of the LLVM IR a module writes for the modules importing it, next to its
+ * interface, e.g. 'shapes.ll' for 'geometry/shapes.exl'.
+ *
+ * @param p_sourcePath The path of the module's source file.
+ *
+ * @return The path of the LLVM IR.
+ */
+char* compiler___ir_path(const char* p_sourcePath) {
+	char* lp_interface = interface_path(p_sourcePath);
+
+	lp_interface[strlen(lp_interface) - strlen(INTERFACE_EXTENSION)] = '\0';
+
+	char* lp_path = CONCATENATE_STRING(lp_interface, COMPILER_IR_EXTENSION);
+
+	free(lp_interface);
+
+	return lp_path;
+}
+
+/**
+ * Opens the interface of an imported module, written to the working directory when it was
+ * compiled, e.g. 'shapes.exmi' for 'geometry.shapes', and declares the functions it exports, e.g.
+ * 'shapes::twice', typed by their signatures. Functions whose signatures mention types of the
+ * module, e.g. 'func(Square) -> i64', stay untyped, and cannot be used yet. The module's LLVM IR is
+ * linked into the program. The modules of the runtime have no interface, they are declared by
+ * compiler___declare_imports.
+ *
+ * @param p_self   The current Compiler struct.
+ * @param p_import The import's path, e.g. 'geometry.shapes' or 'geometry.{shapes, lines}'.
+ * @param p_name   The module's name, e.g. 'shapes'.
+ * @param line     The import's line index, for diagnostics.
+ */
+void compiler___import(struct Compiler* p_self, const char* p_import, const char* p_name,
+					   size_t line) {
+	if (strncmp(p_import, COMPILER_RUNTIME_MODULES, strlen(COMPILER_RUNTIME_MODULES)) == 0) {
+		return;
+	}
+
+	char* lp_directory	  = duplicate_string(p_self->filePath);
+	char* lp_package	  = duplicate_string(p_import);
+	char* lp_directoryEnd = strrchr(lp_directory, '/');
+	char* lp_packageEnd	  = strrchr(lp_package, '.'); // e.g. after 'geometry' of 'geometry.shapes'
+
+	*(lp_directoryEnd ? lp_directoryEnd + 1 : lp_directory) = '\0';
+	*(lp_packageEnd ? lp_packageEnd + 1 : lp_package)		= '\0';
+
+	for (char* lp_chr = lp_package; *lp_chr; lp_chr++) { // A directory per component
+		*lp_chr = *lp_chr == '.' ? '/' : *lp_chr;
+	}
+
+	// Relative to the importing module
+	char*			  lp_source	   = CONCATENATE_STRING(lp_directory, lp_package, p_name, ".exl");
+	char*			  lp_path	   = interface_path(lp_source);
+	struct Interface* lp_interface = interface_open(lp_path);
+
+	free(lp_directory);
+	free(lp_package);
+	free(lp_path);
+
+	if (!lp_interface) {
+		compiler_error(p_self->filePath, line, C0002,
+					   CONCATENATE_STRING("unknown module '", p_name, "', compile '", lp_source,
+										  "' first to write its interface"));
+	}
+
+	array_append(p_self->linked, compiler___ir_path(lp_source));
+	free(lp_source);
+
+	p_self->imports = buffer_grow(p_self->imports, &p_self->importCapacity, p_self->importCount + 1,
+								  sizeof(struct Interface*));
+	p_self->imports[p_self->importCount++] = lp_interface;
+
+	for (uint32_t index = 0; index < lp_interface->header->symbolCount; index++) {
+		const struct InterfaceSymbol* lp_symbol = &lp_interface->symbols[index];
+		const char* lp_function = flat_ast_get_string(lp_interface->ast, lp_symbol->name);
+
+		// Its entry point is only called by the program built from it
+		if (lp_symbol->kind != INTERFACE_SYMBOL_FUNCTION || strcmp(lp_function, "main") == 0) {
+			continue;
+		}
+
+		char*	 lp_qualified = CONCATENATE_STRING(p_name, "::", lp_function);
+		uint32_t binding =
+			symbol_table_declare(p_self->symbols, interner_intern(p_self->interner, lp_qualified),
+								 SYMBOL_FUNCTION, FLATAST_INDEX_NONE);
+
+		if (binding != SYMBOL_BINDING_NONE) {
+			symbol_table_get(p_self->symbols, binding)->type = type_table_parse(
+				p_self->types, flat_ast_get_string(lp_interface->ast, lp_symbol->signature));
+		}
+
+		free(lp_qualified);
+	}
+}
+
+/**
+ * Declares the modules the module imports, e.g. 'io' for 'std.io', and 'array' and 'number' for
+ * 'std.types.{array, number}'.
+ *
+ * @param p_self The current Compiler struct.
+ */
+void compiler___declare_imports(struct Compiler* p_self) {
+	struct Array* lp_imports = p_self->parser->imports;
+	type_id_t	  value		 = type_table_parameter(
+		  p_self->types, interner_intern(p_self->interner, "T"), TYPE_ID_NONE);
+	type_id_t void_ = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	type_id_t range =
+		type_table_named(p_self->types, interner_intern(p_self->interner, "Range"), &value, 1);
+	intern_id_t taskName	 = interner_intern(p_self->interner, CORO_TASK_TYPE);
+	type_id_t	task		 = type_table_named(p_self->types, taskName, &value, 1);
+	type_id_t	sleep		 = type_table_named(p_self->types, taskName, &void_, 1);
+	type_id_t	milliseconds = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64);
+
+	for (size_t index = 0; index < lp_imports->length; index++) {
+		const char* lp_path	 = lp_imports->_values[index];
+		const char* lp_names = strrchr(lp_path, '.');
+		char		name[MAX_STRING_LENGTH];
+
+		lp_names = lp_names ? lp_names + 1 : lp_path;
+
+		if (*lp_names == '{') {
+			lp_names++;
+		}
+
+		while (*lp_names && *lp_names != '}') { // Each name of the list, e.g. '{array, number}'
+			size_t length = strcspn(lp_names, ",}");
+
+			if (length >= sizeof(name)) {
+				length = sizeof(name) - 1;
+			}
+
+			memcpy(name, lp_names, length);
+			name[length] = '\0';
+
+			char* lp_name = name;
+
+			while (*lp_name == ' ') {
+				lp_name++;
+			}
+
+			// Imported twice is the same module
+			if (*lp_name
+				&& symbol_table_declare(p_self->symbols, interner_intern(p_self->interner, lp_name),
+										SYMBOL_MODULE, FLATAST_INDEX_NONE)
+					   != SYMBOL_BINDING_NONE) {
+				compiler___import(p_self, lp_path, lp_name, p_self->parser->importLines[index]);
+			}
+
+			lp_names += length;
+			lp_names += *lp_names == ',';
+		}
+	}
+
+	compiler___declare_runtime(p_self, "io::out", &value, 1, void_);
+	compiler___declare_runtime(p_self, "io::flush", NULL, 0, void_);
+	compiler___declare_runtime(p_self, "io::spawn", &task, 1, void_);
+	compiler___declare_runtime(p_self, "io::run", NULL, 0, void_);
+	compiler___declare_runtime(p_self, "io::sleep", &milliseconds, 1, sleep);
+	compiler___declare_runtime(p_self, "cf::range", (type_id_t[]){value, value}, 2, range);
+}
+
+/**
+ * Gets the type parameters of a generic declaration, e.g. 'MU' of 'Square<MU: UInt|Float>'. A
+ * bound can mention the type parameters declared before it, e.g. 'MU' in '<MU, T: Geometry<MU>>'.
+ *
+ * @param p_self   The current Compiler struct.
+ * @param target   The declaration's target, a TYPE node for generic declarations.
+ * @param p_params Where to write the type parameters, of MAX_STRING_LENGTH / sizeof(type_id_t).
+ *
+ * @return The number of type parameters.
+ */
+size_t compiler___parameters(struct Compiler* p_self, flat_ast_index_t target,
+							 type_id_t* p_params) {
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, target);
+	size_t					  count		= 0;
+
+	if (lp_target->kind != FLATAST_TYPE) {
+		return 0;
+	}
+
+	symbol_table_push_scope(p_self->symbols);
+
+	for (; count < lp_target->value.list.length && count < MAX_STRING_LENGTH / sizeof(type_id_t);
+		 count++) {
+		flat_ast_index_t		  param	   = flat_ast_get_list_item(p_self->ast, lp_target, count);
+		const struct FlatASTNode* lp_param = flat_ast_get(p_self->ast, param);
+		type_id_t				  bound	   = TYPE_ID_NONE;
+
+		if (lp_param->lhs != FLATAST_INDEX_NONE) {
+			bound = inference_annotation(p_self->inference, p_self->ast, lp_param->lhs);
+		}
+
+		p_params[count] =
+			type_table_parameter(p_self->types, compiler___name(p_self, param), bound);
+
+		uint32_t binding = symbol_table_declare(p_self->symbols, compiler___name(p_self, param),
+												SYMBOL_TYPE_PARAMETER, FLATAST_INDEX_NONE);
+
+		if (binding != SYMBOL_BINDING_NONE) {
+			symbol_table_get(p_self->symbols, binding)->type = p_params[count];
+		}
+	}
+
+	symbol_table_pop_scope(p_self->symbols);
+
+	return count;
+}
+
+/**
+ * Declares a function or method, to be inferred at the end of the module.
+ *
+ * @param p_self    The current Compiler struct.
+ * @param statement The declaring assignment.
+ */
+void compiler___declare_function(struct Compiler* p_self, flat_ast_index_t statement) {
+	const struct FlatASTNode* lp_statement = flat_ast_get(p_self->ast, statement);
+	const struct FlatASTNode* lp_target	   = flat_ast_get(p_self->ast, lp_statement->lhs);
+	type_id_t				  params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	size_t	  paramCount = compiler___parameters(p_self, lp_statement->lhs, params);
+	intern_id_t name	 = TYPE_ID_NONE;
+
+	if (lp_target->kind == FLATAST_MEMBER) { // e.g. 'Stack.push = func(self, item) { ... }'
+		char* lp_qualified = CONCATENATE_STRING(
+			interner_get(p_self->interner, compiler___name(p_self, lp_target->lhs)), ".",
+			flat_ast_get_string(p_self->ast, lp_target->value.string));
+
+		name = interner_intern(p_self->interner, lp_qualified);
+		free(lp_qualified);
+	} else {
+		name = compiler___name(p_self, lp_target->kind == FLATAST_TYPE ? lp_target->lhs
+																		: lp_statement->lhs);
+	}
+
+	p_self->functions = buffer_grow(p_self->functions, &p_self->functionCapacity,
+									p_self->functionCount + 1, CODEGEN_FUNCTION_SIZE);
+
+	struct CodegenFunction* lp_function = &p_self->functions[p_self->functionCount++];
+
+	lp_function->function = lp_statement->rhs;
+	lp_function->binding =
+		compiler___declare(p_self, statement, name, SYMBOL_FUNCTION, lp_statement->rhs);
+	lp_function->params = type_table_tuple(p_self->types, params, paramCount);
+
+	if (lp_target->kind != FLATAST_MEMBER) { // Calls to it with constant arguments can be folded
+		comptime_declare(p_self->comptime, name, lp_statement->rhs);
+	}
+}
+
+/**
+ * Declares a struct or a trait, whose type is its name applied to its type parameters.
+ *
+ * @param p_self    The current Compiler struct.
+ * @param statement The declaring assignment.
+ * @param kind      SYMBOL_STRUCT or SYMBOL_TRAIT.
+ */
+void compiler___declare_type(struct Compiler* p_self, flat_ast_index_t statement,
+							 enum SymbolKinds kind) {
+	const struct FlatASTNode* lp_statement = flat_ast_get(p_self->ast, statement);
+	const struct FlatASTNode* lp_target	   = flat_ast_get(p_self->ast, lp_statement->lhs);
+	type_id_t				  params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	size_t		paramCount = compiler___parameters(p_self, lp_statement->lhs, params);
+	intern_id_t name	   = compiler___name(
+		  p_self, lp_target->kind == FLATAST_TYPE ? lp_target->lhs : lp_statement->lhs);
+	uint32_t binding = compiler___declare(p_self, statement, name, kind, lp_statement->rhs);
+	type_id_t type	  = type_table_named(p_self->types, name, params, paramCount);
+	flat_ast_index_t impl = flat_ast_get(p_self->ast, lp_statement->rhs)->lhs;
+
+	symbol_table_get(p_self->symbols, binding)->type = type;
+
+	char* lp_signature = type_table_to_string(p_self->types, type); // e.g. 'Stack<T>'
+
+	interface_writer_add(p_self->interface, interner_get(p_self->interner, name),
+						 kind == SYMBOL_STRUCT ? INTERFACE_SYMBOL_STRUCT : INTERFACE_SYMBOL_TRAIT,
+						 lp_signature, NULL, lp_statement->rhs, FLATAST_INDEX_NONE);
+	free(lp_signature);
+
+	if (kind != SYMBOL_STRUCT || impl == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_impl = flat_ast_get(p_self->ast, impl);
+
+	for (size_t index = 0; index < lp_impl->value.list.length; index++) { // e.g. 'Geometry<MU>'
+		flat_ast_index_t		  trait		= flat_ast_get_list_item(p_self->ast, lp_impl, index);
+		const struct FlatASTNode* lp_trait	= flat_ast_get(p_self->ast, trait);
+		intern_id_t				  traitName = compiler___name(
+			  p_self, lp_trait->kind == FLATAST_TYPE ? lp_trait->lhs : trait);
+		char* lp_symbol = CONCATENATE_STRING(interner_get(p_self->interner, name), " impl ",
+											 interner_get(p_self->interner, traitName));
+
+		devirt_add_implementation(p_self->devirt, traitName, type);
+
+		if (!hashmap_get(p_self->interface->symbols, lp_symbol)) { // Listed twice is one impl
+			interface_writer_add(p_self->interface, lp_symbol, INTERFACE_SYMBOL_IMPL, NULL,
+								 interner_get(p_self->interner, traitName), trait,
+								 FLATAST_INDEX_NONE);
+		}
+
+		free(lp_symbol);
+	}
+}
+
 void compiler_compile_next(struct Compiler* p_self) {
-	switch (p_self->parser->AST->identifier) {
+	const struct FlatASTNode* lp_statement = flat_ast_get(p_self->ast, p_self->statement);
+
+	if (lp_statement->kind == FLATAST_ASSIGNMENT
+		&& lp_statement->operation == LEXERTOKENS_ASSIGNMENT) {
+		switch (flat_ast_get(p_self->ast, lp_statement->rhs)->kind) {
+		case FLATAST_FUNCTION:
+			compiler___declare_function(p_self, p_self->statement);
+			return;
+		case FLATAST_STRUCT:
+			compiler___declare_type(p_self, p_self->statement, SYMBOL_STRUCT);
+			return;
+		case FLATAST_TRAIT:
+			compiler___declare_type(p_self, p_self->statement, SYMBOL_TRAIT);
+			return;
+		default:
+			break;
+		}
+	}
+
+	compiler_error(p_self->filePath, lp_statement->line, C0014,
+				   "statements at the top level of a module are not supported by code generation "
+				   "yet, only declarations");
+}
+
+/**
+ * Opens a scope binding the type parameters a function can mention: its own, and for methods the
+ * type parameters of their struct, and 'Self'.
+ *
+ * @param p_self      The current Compiler struct.
+ * @param p_function  The function.
+ */
+void compiler___push_parameters(struct Compiler* p_self, const struct CodegenFunction* p_function) {
+	type_id_t tuples[2] = {p_function->params, TYPE_ID_NONE};
+
+	symbol_table_push_scope(p_self->symbols);
+
+	if (p_function->selfType != TYPE_ID_NONE) {
+		tuples[1] = p_function->selfType;
+
+		uint32_t self = symbol_table_declare(p_self->symbols,
+											 interner_intern(p_self->interner, "Self"),
+											 SYMBOL_TYPE_PARAMETER, FLATAST_INDEX_NONE);
+
+		symbol_table_get(p_self->symbols, self)->type = p_function->selfType;
+	}
+
+	for (size_t tuple = 0; tuple < 2; tuple++) {
+		if (tuples[tuple] == TYPE_ID_NONE) {
+			continue;
+		}
+
+		const type_id_t* lp_params = type_table_get_args(p_self->types, tuples[tuple]);
+
+		for (uint32_t index = 0; index < type_table_get(p_self->types, tuples[tuple])->argCount;
+			 index++) {
+			uint32_t binding = symbol_table_declare(
+				p_self->symbols, type_table_get(p_self->types, lp_params[index])->name,
+				SYMBOL_TYPE_PARAMETER, FLATAST_INDEX_NONE);
+
+			if (binding != SYMBOL_BINDING_NONE) {
+				symbol_table_get(p_self->symbols, binding)->type = lp_params[index];
+			}
+		}
+	}
+}
+
+/**
+ * Gets the type parameters a function declares, with those of a method's struct.
+ *
+ * @param p_self     The current Compiler struct.
+ * @param p_function The function.
+ *
+ * @return Tuple of the type parameters.
+ */
+type_id_t compiler___declared_parameters(struct Compiler*			   p_self,
+										 const struct CodegenFunction* p_function) {
+	type_id_t params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	size_t	  count		= 0;
+	type_id_t tuples[2] = {p_function->params, p_function->selfType};
+
+	for (size_t tuple = 0; tuple < 2; tuple++) {
+		if (tuples[tuple] == TYPE_ID_NONE) {
+			continue;
+		}
+
+		uint32_t argCount = type_table_get(p_self->types, tuples[tuple])->argCount;
+
+		for (uint32_t index = 0; index < argCount && count < sizeof(params) / sizeof(type_id_t);
+			 index++) {
+			params[count++] = type_table_get_args(p_self->types, tuples[tuple])[index];
+		}
+	}
+
+	return type_table_tuple(p_self->types, params, count);
+}
+
+void compiler___infer(struct Compiler* p_self, size_t index);
+
+/**
+ * Infers the functions a node may call before the node's function, so their generalised types
+ * are used. A method is reached through any member of its name.
+ *
+ * @param p_self The current Compiler struct.
+ * @param node   A node of the function.
+ */
+void compiler___infer_callees(struct Compiler* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (lp_node->kind == FLATAST_VARIABLE || lp_node->kind == FLATAST_MEMBER) {
+		const char* lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+
+		for (size_t index = 0; index < p_self->functionCount; index++) {
+			const char* lp_function = interner_get(
+				p_self->interner,
+				symbol_table_get(p_self->symbols, p_self->functions[index].binding)->name);
+			const char* lp_method = strchr(lp_function, '.');
+
+			bool matches = lp_node->kind == FLATAST_VARIABLE
+							   ? strcmp(lp_function, lp_name) == 0
+							   : lp_method && strcmp(lp_method + 1, lp_name) == 0;
+
+			if (matches) {
+				compiler___infer(p_self, index);
+			}
+		}
+	}
+
+	compiler___infer_callees(p_self, lp_node->lhs);
+	compiler___infer_callees(p_self, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			compiler___infer_callees(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
 	default:
-		printf("unsupported parser token for compiler: %s\n",
-			   ast_tokens_get_name(p_self->parser->AST->identifier)); // TODO: fix
 		break;
 	}
 }
 
+/**
+ * Infers a function after its callees, then records its generalised type in its binding.
+ * Recursive calls see the type the function has so far.
+ *
+ * @param p_self The current Compiler struct.
+ * @param index  The index of the function.
+ */
+void compiler___infer(struct Compiler* p_self, size_t index) {
+	if (p_self->functions[index].state != COMPILER_FUNCTION_PENDING) {
+		return;
+	}
+
+	p_self->functions[index].state = COMPILER_FUNCTION_RUNNING;
+
+	flat_ast_index_t node = p_self->functions[index].function;
+
+	compiler___infer_callees(p_self, flat_ast_get(p_self->ast, node)->rhs);
+
+	struct CodegenFunction function = p_self->functions[index];
+	const char*			   lp_name	= interner_get(
+		   p_self->interner, symbol_table_get(p_self->symbols, function.binding)->name);
+
+	compiler___push_parameters(p_self, &function);
+
+	type_id_t type = inference_infer_function(p_self->inference, p_self->ast, function.function,
+											  function.selfType, lp_name);
+
+	devirt_function(p_self->devirt, p_self->ast, p_self->inference,
+					compiler___declared_parameters(p_self, &function), lp_name);
+	escape_function(p_self->escape, p_self->ast, p_self->inference, node, lp_name);
+	tail_calls_analyse(p_self->tailcalls, p_self->ast, p_self->inference, node, lp_name);
+	simd_lowering_analyse(p_self->simd, p_self->ast, p_self->inference, node);
+	regions_analyse(p_self->regions, p_self->ast, p_self->inference, node);
+
+	if (function.selfType == TYPE_ID_NONE) { // Methods are not declared for compile time calls
+		intern_id_t name = symbol_table_get(p_self->symbols, function.binding)->name;
+
+		memo_analyse(p_self->memo, p_self->ast, p_self->inference, node,
+					 (uint32_t)p_self->comptime->byName[name] - 1, lp_name,
+					 &p_self->functions[index].memo);
+	}
+	symbol_table_pop_scope(p_self->symbols);
+
+	struct SymbolBinding* lp_binding = symbol_table_get(p_self->symbols, function.binding);
+
+	if (lp_binding->type != TYPE_ID_NONE) { // Used before it was inferred, e.g. recursively
+		inference_unify(p_self->inference, lp_binding->type, type);
+	}
+
+	lp_binding->type			   = inference_resolve(p_self->inference, type);
+	p_self->functions[index].state = COMPILER_FUNCTION_DONE;
+}
+
+/**
+ * Gets the type methods are declared on, e.g. 'Stack<T>' for 'Stack.push'.
+ *
+ * @param p_self     The current Compiler struct.
+ * @param p_function The method.
+ *
+ * @return The struct's type, or TYPE_ID_NONE if the function is not a method.
+ */
+type_id_t compiler___self_type(struct Compiler* p_self, const struct CodegenFunction* p_function) {
+	intern_id_t name	= symbol_table_get(p_self->symbols, p_function->binding)->name;
+	const char* lp_name = interner_get(p_self->interner, name);
+	const char* lp_method = strchr(lp_name, '.');
+
+	if (!lp_method) {
+		return TYPE_ID_NONE;
+	}
+
+	char type[MAX_STRING_LENGTH];
+
+	snprintf(type, sizeof(type), "%.*s", (int)(lp_method - lp_name), lp_name);
+
+	uint32_t binding =
+		symbol_table_resolve(p_self->symbols, interner_intern(p_self->interner, type));
+
+	if (binding == SYMBOL_BINDING_NONE
+		|| symbol_table_get(p_self->symbols, binding)->kind != SYMBOL_STRUCT) {
+		compiler_error(p_self->filePath, flat_ast_get(p_self->ast, p_function->function)->line,
+					   C0002, CONCATENATE_STRING("unknown struct '", type, "'"));
+	}
+
+	return symbol_table_get(p_self->symbols, binding)->type;
+}
+
+/**
+ * Runs the ownership pass over every function of the module, once they have all been inferred:
+ * summarises which parameters each keeps, then decides how each of their strings and arrays gets
+ * where it is used.
+ *
+ * @param p_self The current Compiler struct.
+ */
+void compiler___ownership(struct Compiler* p_self) {
+	size_t			  count	   = p_self->functionCount;
+	flat_ast_index_t* lp_nodes = malloc((count ? count : 1) * sizeof(flat_ast_index_t));
+	const char**	  lp_names = malloc((count ? count : 1) * sizeof(const char*));
+
+	if (!lp_nodes || !lp_names) {
+		PANIC("failed to malloc ownership functions");
+	}
+
+	for (size_t index = 0; index < count; index++) {
+		lp_nodes[index] = p_self->functions[index].function;
+		lp_names[index] = interner_get(
+			p_self->interner,
+			symbol_table_get(p_self->symbols, p_self->functions[index].binding)->name);
+	}
+
+	ownership_summarise(p_self->ownership, p_self->ast, p_self->inference, lp_nodes, lp_names,
+						count);
+
+	for (size_t index = 0; index < count; index++) {
+		ownership_function(p_self->ownership, p_self->ast, p_self->inference, lp_nodes[index],
+						   lp_names[index]);
+	}
+
+	free(lp_nodes);
+	free(lp_names);
+}
+
+/**
+ * Exports the module's functions and methods, with their inferred signatures and their bodies, to
+ * its interface.
+ *
+ * @param p_self The current Compiler struct.
+ */
+void compiler___export(struct Compiler* p_self) {
+	for (size_t index = 0; index < p_self->functionCount; index++) {
+		const struct CodegenFunction* lp_function = &p_self->functions[index];
+		const struct SymbolBinding*	  lp_binding  =
+			symbol_table_get(p_self->symbols, lp_function->binding);
+
+		const char* lp_name		 = interner_get(p_self->interner, lp_binding->name);
+		const char* lp_method	 = strchr(lp_name, '.'); // e.g. 'Stack.push'
+		char*		lp_signature = type_table_to_string(p_self->types, lp_binding->type);
+		char		related[MAX_STRING_LENGTH];
+
+		if (lp_method) {
+			snprintf(related, sizeof(related), "%.*s", (int)(lp_method - lp_name), lp_name);
+		}
+
+		interface_writer_add(p_self->interface, lp_name,
+							 lp_method ? INTERFACE_SYMBOL_METHOD : INTERFACE_SYMBOL_FUNCTION,
+							 lp_signature, lp_method ? related : NULL, lp_function->function,
+							 flat_ast_get(p_self->ast, lp_function->function)->rhs);
+		free(lp_signature);
+	}
+}
+
+/**
+ * Computes the module's cache key from its source and the interfaces of its imports, and loads its
+ * LLVM IR from the cache if it was stored under that key, i.e. neither changed since, replaying
+ * the reports made generating it.
+ *
+ * @param p_self The current Compiler struct.
+ *
+ * @return Whether the IR was loaded.
+ */
+bool compiler___load_cached(struct Compiler* p_self) {
+	if (!p_self->cache) {
+		return false;
+	}
+
+	struct Array* lp_hashes = array_new();
+
+	for (size_t index = 0; index < p_self->importCount; index++) { // Editing an import rebuilds
+		struct Sha256* lp_hasher = sha256_new();
+
+		sha256_update(lp_hasher, p_self->imports[index]->data, p_self->imports[index]->length);
+		array_append(lp_hashes, sha256_hex_digest(lp_hasher));
+		sha256_free(&lp_hasher);
+	}
+
+	p_self->cacheKey =
+		cache_module_key(p_self->filePath, p_self->version, p_self->flags, lp_hashes);
+
+	array_clear(lp_hashes, (void (*)(const void*))free);
+	array_free(&lp_hashes);
+
+	if (!p_self->cacheKey) { // The source could not be read
+		return false;
+	}
+
+	size_t outputLength = 0;
+	char*  lp_output =
+		cache_load(p_self->cache, p_self->cacheKey, CACHE_ARTIFACT_IR, &outputLength);
+
+	if (!lp_output) {
+		return false;
+	}
+
+	char* lp_generated = cache_load(p_self->cache, p_self->cacheKey, CACHE_ARTIFACT_REPORT, NULL);
+
+	if (!lp_generated) { // Stored before its reports were
+		free(lp_output);
+
+		return false;
+	}
+
+	report_replay(p_self->report, lp_generated);
+	free(lp_generated);
+
+	string_free(&p_self->output);
+	p_self->output = string_new_with_length(lp_output, outputLength);
+	p_self->cached = true;
+
+	return true;
+}
+
+/**
+ * Adds what each pass of the back end did to the time report made generating the module's IR.
+ *
+ * @param p_self The current Compiler struct.
+ */
+void compiler___report_passes(struct Compiler* p_self) {
+	char line[MAX_STRING_LENGTH];
+
+	snprintf(line, sizeof(line), "monomorphize %s: %zu instances, %zu merged, %zu requests",
+			 p_self->filePath, p_self->mono->instanceCount, p_self->mono->merged,
+			 p_self->mono->requests);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	const size_t* lp_calls = p_self->devirt->counts;
+
+	snprintf(line, sizeof(line),
+			 "devirt %s: %zu static, %zu instance, %zu sole, %zu switch, %zu dynamic",
+			 p_self->filePath, lp_calls[DEVIRT_STATIC], lp_calls[DEVIRT_INSTANCE],
+			 lp_calls[DEVIRT_SOLE], lp_calls[DEVIRT_SWITCH], lp_calls[DEVIRT_DYNAMIC]);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line),
+			 "loops %s: %zu counted, %zu through an iterator, %zu/%zu accesses unchecked",
+			 p_self->filePath, p_self->loops->counted,
+			 p_self->loops->loops - p_self->loops->counted, p_self->loops->inBoundsAccesses,
+			 p_self->loops->accesses);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "powers %s: %zu chains, %zu squarings, %zu intrinsics",
+			 p_self->filePath, p_self->powers->chains, p_self->powers->squarings,
+			 p_self->powers->intrinsicCalls);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "comptime %s: %zu folded, %zu left to runtime, %zu steps",
+			 p_self->filePath, p_self->comptime->folded, p_self->comptime->failed,
+			 p_self->comptime->totalSteps);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "escape %s: %zu on the stack, %zu on the heap", p_self->filePath,
+			 p_self->escape->stack, p_self->escape->heap);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "layout %s: %zu structs reordered, %zu bytes saved",
+			 p_self->filePath, p_self->layouts->reordered, p_self->layouts->saved);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "tail calls %s: %zu loops, %zu musttail", p_self->filePath,
+			 p_self->tailcalls->loops, p_self->tailcalls->musttails);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "memo %s: %zu functions, %zu direct, %zu bounded",
+			 p_self->filePath, p_self->memo->memoized, p_self->memo->direct, p_self->memo->bounded);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "match %s: %zu matches, %zu jump tables, %zu searches",
+			 p_self->filePath, p_self->matches->matches, p_self->matches->tables,
+			 p_self->matches->searches);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "simd %s: %zu vectors, %zu operations, %zu intrinsics",
+			 p_self->filePath, p_self->simd->vectors, p_self->simd->operations,
+			 p_self->simd->intrinsicCalls);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "parallel %s: %zu loops, %zu reductions", p_self->filePath,
+			 p_self->parallel->loops, p_self->parallel->reduced);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "coro %s: %zu async, %zu generators, %zu awaits, %zu yields",
+			 p_self->filePath, p_self->coro->asyncs, p_self->coro->generators, p_self->coro->awaits,
+			 p_self->coro->yields);
+	report_add(p_self->generated, REPORT_TIME, line);
+
+	snprintf(line, sizeof(line), "regions %s: %zu arena blocks, %zu checks", p_self->filePath,
+			 p_self->regions->blocks, p_self->regions->checks);
+	report_add(p_self->generated, REPORT_TIME, line);
+}
+
+/**
+ * Infers and checks every function of the module, and generates its LLVM IR unless it is cached.
+ * The front end runs even then, so a warm build reports the same diagnostics as a cold one, and
+ * writes the same interface. Only code generation is skipped: the reports it made are replayed.
+ *
+ * @param p_self The current Compiler struct.
+ */
+void compiler___generate(struct Compiler* p_self) {
+	compiler___declare_imports(p_self);
+
+	for (size_t index = 0; index < p_self->functionCount; index++) {
+		p_self->functions[index].selfType = compiler___self_type(p_self, &p_self->functions[index]);
+	}
+
+	for (size_t index = 0; index < p_self->functionCount; index++) {
+		compiler___infer(p_self, index);
+	}
+
+	compiler___ownership(p_self);
+	compiler___export(p_self);
+
+	if (!compiler___load_cached(p_self)) {
+		codegen_module(p_self->codegen, p_self->output);
+		compiler___report_passes(p_self);
+		report_replay(p_self->report, p_self->generated->output->_value);
+	}
+
+	codegen_entry(p_self->codegen, p_self->entry);
+
+	if (report_enabled(p_self->report, REPORT_TIME)) {
+		char line[MAX_STRING_LENGTH];
+
+		snprintf(line, sizeof(line), "ownership %s: %zu moves, %zu borrows, %zu copies",
+				 p_self->filePath, p_self->ownership->moves, p_self->ownership->borrows,
+				 p_self->ownership->copies);
+		report_add(p_self->report, REPORT_TIME, line);
+
+		snprintf(line, sizeof(line), "interface %s: %zu exported, %zu imported", p_self->filePath,
+				 p_self->interface->symbolCount, p_self->importCount);
+		report_add(p_self->report, REPORT_TIME, line);
+	}
+}
+
 bool compiler_compile(struct Compiler* p_self) {
-	if (!parser_parse(p_self->parser, true, true)) {
+	p_self->statement = flat_parser_parse(p_self->parser);
+
+	if (p_self->statement == FLATAST_INDEX_NONE) {
+		compiler___generate(p_self);
+
 		return false;
 	}
 
@@ -51,3 +981,42 @@ bool compiler_compile(struct Compiler* p_self) {
 
 	return true;
 }
+
+void compiler_finish(struct Compiler* p_self) {
+	size_t interfaceLength	= 0;
+	char*  lp_interface		= interface_writer_serialise(p_self->interface, &interfaceLength);
+	char*  lp_interfacePath = interface_path(p_self->filePath);
+	char*  lp_irPath		= compiler___ir_path(p_self->filePath);
+
+	// In the working directory, where the modules importing it open it, and link its IR
+	if (!file_write_atomic(lp_interfacePath, lp_interface, interfaceLength)) {
+		error(CONCATENATE_STRING("failed to write the interface '", lp_interfacePath, "'"));
+	}
+
+	if (!file_write_atomic(lp_irPath, p_self->output->_value, p_self->output->length)) {
+		error(CONCATENATE_STRING("failed to write the LLVM IR '", lp_irPath, "'"));
+	}
+
+	if (!p_self->cached && p_self->cacheKey && p_self->output->length > 0) {
+		// The IR goes last: an entry with IR is treated as complete when it is loaded
+		cache_store(p_self->cache, p_self->cacheKey, CACHE_ARTIFACT_INTERFACE, lp_interface,
+					interfaceLength);
+		cache_store(p_self->cache, p_self->cacheKey, CACHE_ARTIFACT_REPORT,
+					p_self->generated->output->_value, p_self->generated->output->length);
+		cache_store(p_self->cache, p_self->cacheKey, CACHE_ARTIFACT_IR, p_self->output->_value,
+					p_self->output->length);
+	}
+
+	free(lp_irPath);
+	free(lp_interfacePath);
+	free(lp_interface);
+
+	if (report_enabled(p_self->report, REPORT_TIME)) {
+		char line[MAX_STRING_LENGTH];
+
+		snprintf(line, sizeof(line), "compile %s: %.3fms%s", p_self->filePath,
+				 (double)(report_clock() - p_self->startTime) / 1000000.0,
+				 p_self->cached ? " (cached)" : "");
+		report_add(p_self->report, REPORT_TIME, line);
+	}
+}
@@ -5,13 +5,84 @@
 
 #pragma once
 
+#include "./cache.h"
+#include "./codegen.h"
+#include "./comptime.h"
+#include "./coro.h"
+#include "./devirt.h"
+#include "./escape.h"
+#include "./infer.h"
+#include "./interface.h"
+#include "./layout.h"
+#include "./loops.h"
+#include "./match.h"
+#include "./memo.h"
+#include "./mono.h"
+#include "./ownership.h"
+#include "./parallel.h"
+#include "./power.h"
+#include "./regions.h"
+#include "./report.h"
+#include "./simd.h"
+#include "./symbols.h"
+#include "./tailcall.h"
+#include "./types.h"
+#include "./vtable.h"
+#include "../parser/flat.h"
+#include "../parser/flat_parser.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+#define COMPILER_RUNTIME_BITCODE "std-llvm-ir/std.bc" // Linked into every program, from '--stdlib'.
+#define COMPILER_RUNTIME_MODULES "std."				  // The modules the runtime implements.
+#define COMPILER_IR_EXTENSION	 ".ll"				  // Next to the interface, the module's IR.
 
 /**
  * Represents a compiler.
  */
 struct Compiler {
-	struct Parser* parser;
+	bool						cached;	   // Whether the output was loaded from the cache.
+	uint64_t					startTime; // When compiling started, for the time report.
+	const char*					filePath;
+	const char*					version;  // The compiler's version, for the module's cache key.
+	const char*					flags;	  // The flags affecting compilation, likewise.
+	char*						cacheKey; // The module's cache key, NULL if caching is disabled.
+	struct Cache*				cache;
+	struct Report*				report;
+	struct Report*				generated; // Every report made generating the IR, for the cache.
+	struct FlatParser*			parser;
+	struct FlatAST*				ast;
+	struct InterfaceWriter*		interface;
+	struct Interner*			interner;
+	struct SymbolTable*			symbols;
+	struct TypeTable*			types;
+	struct Inference*			inference;
+	struct Monomorphizer*		mono;
+	struct Devirtualizer*		devirt;
+	struct VtableTable*			vtables;
+	struct LoopLowering*		loops;
+	struct PowerLowering*		powers;
+	struct Comptime*			comptime;
+	struct EscapeAnalysis*		escape;
+	struct LayoutTable*			layouts;
+	struct TailCalls*			tailcalls;
+	struct Memo*				memo;
+	struct MatchLowering*		matches;
+	struct SimdLowering*		simd;
+	struct ParallelLowering*	parallel;
+	struct Coroutines*			coro;
+	struct Regions*				regions;
+	struct Ownership*			ownership;
+	struct Codegen*				codegen;
+	struct CodegenFunction*		functions; // The functions and methods the module declares.
+	struct Interface**			imports;   // The interfaces of the modules imported.
+	struct Array*				linked;	   // The LLVM IR of each module imported, e.g. 'shapes.ll'.
+	flat_ast_index_t			statement; // The last parsed top-level statement.
+	struct String*				output;	   // The LLVM IR generated for the module.
+	struct String*				entry;	   // The entry point, calling the module's 'main'.
+	size_t						functionCount, functionCapacity, importCount, importCapacity;
 };
 
 #define COMPILER_STRUCT_SIZE sizeof(struct Compiler)
@@ -19,11 +90,20 @@ struct Compiler {
 /**
  * Creates a new Compiler struct.
  *
- * @param p_filePath The path to the file to compile.
+ * @param p_filePath       The path to the file to compile.
+ * @param p_cache          The compilation cache (can be NULL).
+ * @param p_version        The compiler's version, for the module's cache key.
+ * @param p_flags          The flags affecting compilation, for the module's cache key.
+ * @param p_report         The requested reports (can be NULL).
+ * @param p_targetFeatures The target features, comma separated like LLVM's, e.g. '+avx2'.
  *
  * @return The created Compiler struct.
  */
-struct Compiler* compiler_new(const char* p_filePath);
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+struct Compiler* compiler_new(const char* p_filePath, struct Cache* p_cache, const char* p_version,
+							  const char* p_flags, struct Report* p_report,
+							  const char* p_targetFeatures);
+// NOLINTEND(bugprone-easily-swappable-parameters)
 
 /**
  * Frees the Compiler struct.
@@ -33,17 +113,29 @@ struct Compiler* compiler_new(const char* p_filePath);
 void compiler_free(struct Compiler** p_self);
 
 /**
- * Calls the correct function for compiling the current parser token.
+ * Declares the last parsed top-level statement: an import, a struct, a trait, or a function or
+ * method. Other statements cannot run at the top level of a module, and fail with C0014.
  *
  * @param p_self The current Compiler struct.
  */
 void compiler_compile_next(struct Compiler* p_self);
 
 /**
- * Gets the next parser token and compiles it.
+ * Parses and declares the next top-level statement. At the end of the file, every function is
+ * inferred and checked, callees first, and the module's LLVM IR is generated, or loaded from the
+ * cache when neither the module nor the interfaces of its imports changed.
  *
  * @param p_self The current Compiler struct.
  *
- * @return Whether compiling succeeded.
+ * @return Whether there are more statements to compile.
  */
 bool compiler_compile(struct Compiler* p_self);
+
+/**
+ * Finishes compiling the module, writing its interface and its LLVM IR to the working directory
+ * for the modules importing it, and storing its output and interface in the cache. Errors if they
+ * cannot be written.
+ *
+ * @param p_self The current Compiler struct.
+ */
+void compiler_finish(struct Compiler* p_self);
@@ -0,0 +1,1314 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./comptime.h"
+#include "./attributes.h"
+#include "./diagnostics.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Comptime* comptime_new(const char* p_filePath, struct FlatAST* p_ast,
+							  struct Interner* p_interner) {
+	struct Comptime* lp_self = calloc(1, COMPTIME_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Comptime struct");
+	}
+
+	lp_self->filePath  = p_filePath;
+	lp_self->ast	   = p_ast;
+	lp_self->interner  = p_interner;
+	lp_self->trueName  = interner_intern(p_interner, "true");
+	lp_self->falseName = interner_intern(p_interner, "false");
+
+	return lp_self;
+}
+
+void comptime_free(struct Comptime** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->functions);
+		free((*p_self)->byName);
+		free((*p_self)->locals);
+		free((*p_self)->failure);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Comptime struct has already been freed");
+	}
+}
+
+void comptime_declare(struct Comptime* p_self, intern_id_t name, flat_ast_index_t function) {
+	p_self->functions = buffer_grow(p_self->functions, &p_self->functionCapacity,
+									p_self->functionCount + 1, COMPTIME_FUNCTION_SIZE);
+	p_self->byName	  = buffer_grow(p_self->byName, &p_self->byNameCapacity, (size_t)name + 1,
+									sizeof(uint32_t));
+
+	p_self->functions[p_self->functionCount].function = function;
+	p_self->functions[p_self->functionCount].purity	  = COMPTIME_PURITY_UNKNOWN;
+	p_self->byName[name]							  = (uint32_t)++p_self->functionCount;
+}
+
+/**
+ * Interns the name held by a node, e.g. a variable or a parameter.
+ *
+ * @param p_self The current Comptime struct.
+ * @param node   The node.
+ *
+ * @return The interned name.
+ */
+intern_id_t comptime___name(struct Comptime* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	return interner_intern(p_self->interner,
+						   flat_ast_get_string(p_self->ast, lp_node->value.string));
+}
+
+/**
+ * Finds the declared function a callee refers to.
+ *
+ * @param p_self The current Comptime struct.
+ * @param callee The callee's node.
+ *
+ * @return The index of the function, or UINT32_MAX if the callee is not a declared function.
+ */
+uint32_t comptime___find(struct Comptime* p_self, flat_ast_index_t callee) {
+	if (flat_ast_get(p_self->ast, callee)->kind != FLATAST_VARIABLE) {
+		return UINT32_MAX;
+	}
+
+	intern_id_t name = comptime___name(p_self, callee);
+
+	if (name >= p_self->byNameCapacity || !p_self->byName[name]) {
+		return UINT32_MAX;
+	}
+
+	return p_self->byName[name] - 1;
+}
+
+/**
+ * Checks whether a callee is 'range', the only iterable loops can be evaluated over.
+ *
+ * @param p_self The current Comptime struct.
+ * @param callee The callee's node.
+ *
+ * @return Whether the callee is range.
+ */
+bool comptime___is_range(const struct Comptime* p_self, flat_ast_index_t callee) {
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, callee);
+
+	return lp_callee->kind == FLATAST_VARIABLE
+		   && strcmp(flat_ast_get_string(p_self->ast, lp_callee->value.string), "range") == 0;
+}
+
+bool comptime___is_pure_node(struct Comptime* p_self, flat_ast_index_t node);
+
+/**
+ * Checks whether every item of a node's list is pure.
+ *
+ * @param p_self The current Comptime struct.
+ * @param node   The node.
+ *
+ * @return Whether the items are pure.
+ */
+bool comptime___is_pure_list(struct Comptime* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		if (!comptime___is_pure_node(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Checks whether a node of a function's body is pure, i.e. it only reads and writes locals and
+ * calls pure functions.
+ *
+ * @param p_self The current Comptime struct.
+ * @param node   The node.
+ *
+ * @return Whether the node is pure.
+ */
+bool comptime___is_pure_node(struct Comptime* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return true;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_INTEGER:
+	case FLATAST_FLOAT:
+	case FLATAST_CHR:
+	case FLATAST_VARIABLE:
+	case FLATAST_TYPE:
+	case FLATAST_PARAMETER:
+		return true;
+	case FLATAST_UNARY:
+	case FLATAST_FIELD:
+	case FLATAST_RETURN:
+		return comptime___is_pure_node(p_self, lp_node->lhs);
+	case FLATAST_BINARY: // Module accesses, e.g. 'io::out', reach outside the function
+		return lp_node->operation != LEXERTOKENS_SCOPE_RESOLUTION
+			   && lp_node->operation != LEXERTOKENS_DOT
+			   && comptime___is_pure_node(p_self, lp_node->lhs)
+			   && comptime___is_pure_node(p_self, lp_node->rhs);
+	case FLATAST_ASSIGNMENT: { // Only locals can be written
+		uint8_t target = flat_ast_get(p_self->ast, lp_node->lhs)->kind;
+
+		return (target == FLATAST_VARIABLE || target == FLATAST_FIELD)
+			   && comptime___is_pure_node(p_self, lp_node->rhs);
+	}
+	case FLATAST_CALL: {
+		uint32_t function = comptime___find(p_self, lp_node->lhs);
+
+		return function != UINT32_MAX && comptime_is_pure(p_self, function)
+			   && comptime___is_pure_list(p_self, node);
+	}
+	case FLATAST_BLOCK:
+		return comptime___is_pure_list(p_self, node);
+	case FLATAST_IF:
+		return comptime___is_pure_node(p_self, lp_node->lhs)
+			   && comptime___is_pure_node(p_self, lp_node->rhs)
+			   && comptime___is_pure_list(p_self, node);
+	case FLATAST_WHILE:
+		return comptime___is_pure_node(p_self, lp_node->lhs)
+			   && comptime___is_pure_node(p_self, lp_node->rhs);
+	case FLATAST_FOR: {
+		const struct FlatASTNode* lp_iterable = flat_ast_get(p_self->ast, lp_node->lhs);
+
+		return lp_node->value.list.length == 1 && lp_iterable->kind == FLATAST_CALL
+			   && comptime___is_range(p_self, lp_iterable->lhs)
+			   && comptime___is_pure_list(p_self, lp_node->lhs)
+			   && comptime___is_pure_node(p_self, lp_node->rhs);
+	}
+	default: // Strings, members, literals and nested functions allocate or reach into memory
+		return false;
+	}
+}
+
+bool comptime_is_pure(struct Comptime* p_self, uint32_t function) {
+	if (function >= p_self->functionCount) {
+		PANIC("Comptime function index out of bounds");
+	}
+
+	switch (p_self->functions[function].purity) {
+	case COMPTIME_PURITY_PURE:
+	case COMPTIME_PURITY_CHECKING: // Recursive call, pure unless the rest of the body is not
+		return true;
+	case COMPTIME_PURITY_IMPURE:
+		return false;
+	default:
+		break;
+	}
+
+	const struct FlatASTNode* lp_function =
+		flat_ast_get(p_self->ast, p_self->functions[function].function);
+	bool outermost = true;
+
+	for (size_t index = 0; index < p_self->functionCount; index++) {
+		outermost = outermost && p_self->functions[index].purity != COMPTIME_PURITY_CHECKING;
+	}
+
+	p_self->functions[function].purity = COMPTIME_PURITY_CHECKING;
+
+	bool pure = comptime___is_pure_node(p_self, lp_function->rhs);
+
+	if (!pure) {
+		p_self->functions[function].purity = COMPTIME_PURITY_IMPURE;
+	}
+
+	// Functions found pure while checking this one assumed that the functions still being checked
+	// were pure, so they are only settled once the outermost check has finished
+	if (outermost) {
+		for (size_t index = 0; index < p_self->functionCount; index++) {
+			if (p_self->functions[index].purity == COMPTIME_PURITY_CHECKING) {
+				p_self->functions[index].purity =
+					pure ? COMPTIME_PURITY_PURE : COMPTIME_PURITY_UNKNOWN;
+			}
+		}
+	}
+
+	return pure;
+}
+
+/**
+ * Records why the current fold failed, keeping the first reason.
+ *
+ * @param p_self   The current Comptime struct.
+ * @param node     The node that could not be evaluated.
+ * @param p_reason The reason (ownership is taken).
+ *
+ * @return false, so callers can return it.
+ */
+bool comptime___fail(struct Comptime* p_self, flat_ast_index_t node, char* p_reason) {
+	if (p_self->failure) {
+		free(p_reason);
+	} else {
+		p_self->failure		= p_reason;
+		p_self->failureLine = flat_ast_get(p_self->ast, node)->line;
+	}
+
+	return false;
+}
+
+/**
+ * Takes a step of the current fold.
+ *
+ * @param p_self The current Comptime struct.
+ * @param node   The node being evaluated.
+ *
+ * @return Whether the step budget allows it.
+ */
+bool comptime___step(struct Comptime* p_self, flat_ast_index_t node) {
+	if (++p_self->steps <= COMPTIME_STEP_BUDGET) {
+		return true;
+	}
+
+	char* lp_budget = ul_to_string(COMPTIME_STEP_BUDGET);
+	char* lp_reason = CONCATENATE_STRING("step budget of ", lp_budget, " exceeded");
+
+	free(lp_budget);
+
+	return comptime___fail(p_self, node, lp_reason);
+}
+
+/**
+ * Gets the width of an integer primitive, in bits.
+ *
+ * @param PRIMITIVE The primitive, TYPE_PRIMITIVE_VOID for an untyped literal.
+ *
+ * @return The width.
+ */
+unsigned comptime___width(const enum TypePrimitives PRIMITIVE) {
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_U8:
+	case TYPE_PRIMITIVE_CHR:
+		return 8;
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_U16:
+		return 16;
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_U32:
+		return 32;
+	default:
+		return 64;
+	}
+}
+
+/**
+ * Checks whether a primitive is an unsigned integer.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return Whether the primitive is unsigned.
+ */
+bool comptime___is_unsigned(const enum TypePrimitives PRIMITIVE) {
+	return PRIMITIVE >= TYPE_PRIMITIVE_U8 && PRIMITIVE <= TYPE_PRIMITIVE_U64;
+}
+
+/**
+ * Converts a value to a primitive, wrapping integers around like a runtime conversion would.
+ *
+ * @param p_value   The value to convert.
+ * @param PRIMITIVE The primitive, TYPE_PRIMITIVE_VOID to leave the value as is.
+ */
+void comptime___convert(struct ComptimeValue* p_value, const enum TypePrimitives PRIMITIVE) {
+	if (PRIMITIVE == TYPE_PRIMITIVE_VOID || p_value->kind == COMPTIME_BOOL) {
+		return;
+	}
+
+	p_value->primitive = (uint8_t)PRIMITIVE;
+
+	if (PRIMITIVE == TYPE_PRIMITIVE_F32 || PRIMITIVE == TYPE_PRIMITIVE_F64) {
+		if (p_value->kind == COMPTIME_INTEGER) {
+			p_value->value.floating = (double)p_value->value.integer;
+			p_value->kind			= COMPTIME_FLOAT;
+		}
+
+		if (PRIMITIVE == TYPE_PRIMITIVE_F32) {
+			p_value->value.floating = (double)(float)p_value->value.floating;
+		}
+
+		return;
+	}
+
+	if (p_value->kind == COMPTIME_FLOAT) {
+		p_value->value.integer = (int64_t)p_value->value.floating;
+		p_value->kind		   = COMPTIME_INTEGER;
+	}
+
+	unsigned width = comptime___width(PRIMITIVE);
+
+	if (width < 64) {
+		uint64_t bits = (uint64_t)p_value->value.integer & ((UINT64_C(1) << width) - 1);
+
+		if (!comptime___is_unsigned(PRIMITIVE) && (bits >> (width - 1))) { // Sign extend
+			bits |= ~((UINT64_C(1) << width) - 1);
+		}
+
+		p_value->value.integer = (int64_t)bits;
+	}
+}
+
+/**
+ * Gets the primitive named by a type annotation, e.g. 'i32'.
+ *
+ * @param p_self The current Comptime struct.
+ * @param node   The annotation's node (can be FLATAST_INDEX_NONE).
+ *
+ * @return The primitive, TYPE_PRIMITIVE_VOID if it is not a primitive.
+ */
+enum TypePrimitives comptime___annotation(const struct Comptime* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return TYPE_PRIMITIVE_VOID;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (lp_node->kind == FLATAST_TYPE) {
+		lp_node = flat_ast_get(p_self->ast, lp_node->lhs);
+	}
+
+	if (lp_node->kind != FLATAST_VARIABLE) {
+		return TYPE_PRIMITIVE_VOID;
+	}
+
+	const char* lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+
+	for (int primitive = TYPE_PRIMITIVE_BOOL; primitive < TYPE_PRIMITIVE_STR; primitive++) {
+		if (strcmp(type_primitive_get_name((enum TypePrimitives)primitive), lp_name) == 0) {
+			return (enum TypePrimitives)primitive;
+		}
+	}
+
+	return TYPE_PRIMITIVE_VOID;
+}
+
+/**
+ * Finds a local of the call being evaluated.
+ *
+ * @param p_self The current Comptime struct.
+ * @param name   The interned name of the local.
+ *
+ * @return The index of the local, or SIZE_MAX if there is none.
+ */
+size_t comptime___lookup(const struct Comptime* p_self, intern_id_t name) {
+	for (size_t index = p_self->localCount; index > p_self->frame; index--) {
+		if (p_self->locals[index - 1].name == name) {
+			return index - 1;
+		}
+	}
+
+	return SIZE_MAX;
+}
+
+/**
+ * Declares a local of the call being evaluated.
+ *
+ * @param p_self  The current Comptime struct.
+ * @param name    The interned name of the local.
+ * @param p_value The value of the local.
+ */
+void comptime___push(struct Comptime* p_self, intern_id_t name,
+					 const struct ComptimeValue* p_value) {
+	p_self->locals = buffer_grow(p_self->locals, &p_self->localCapacity, p_self->localCount + 1,
+								 COMPTIME_LOCAL_SIZE);
+
+	p_self->locals[p_self->localCount].name	 = name;
+	p_self->locals[p_self->localCount].value = *p_value;
+	p_self->localCount++;
+}
+
+/**
+ * Raises an integer to an integer power by squaring, wrapping around. Negative exponents truncate
+ * towards zero, like the runtime lowering of '**'.
+ *
+ * @param base     The base.
+ * @param exponent The exponent.
+ *
+ * @return The power.
+ */
+int64_t comptime___ipow(int64_t base, int64_t exponent) {
+	if (exponent < 0) {
+		return base == 1 ? 1 : base == -1 ? (exponent & 1 ? -1 : 1) : 0;
+	}
+
+	uint64_t result = 1;
+	uint64_t square = (uint64_t)base;
+
+	for (uint64_t remaining = (uint64_t)exponent; remaining; remaining >>= 1) {
+		if (remaining & 1) {
+			result *= square;
+		}
+
+		square *= square;
+	}
+
+	return (int64_t)result;
+}
+
+/**
+ * Applies a binary operator to floats. The operators needing libm ('//', '%' and '**' with a
+ * fractional exponent) are left to runtime.
+ *
+ * @param p_self     The current Comptime struct.
+ * @param node       The operator's node.
+ * @param OPERATION  The operator.
+ * @param lhs        The left operand.
+ * @param rhs        The right operand.
+ * @param p_result   Where to write the result.
+ *
+ * @return Whether the operator could be applied.
+ */
+bool comptime___binary_float(struct Comptime* p_self, flat_ast_index_t node,
+							 const enum LexerTokenIdentifiers OPERATION, double lhs, double rhs,
+							 struct ComptimeValue* p_result) {
+	p_result->kind = COMPTIME_FLOAT;
+
+	switch (OPERATION) {
+	case LEXERTOKENS_ADDITION:
+		p_result->value.floating = lhs + rhs;
+		break;
+	case LEXERTOKENS_SUBTRACTION:
+		p_result->value.floating = lhs - rhs;
+		break;
+	case LEXERTOKENS_MULTIPLICATION:
+		p_result->value.floating = lhs * rhs;
+		break;
+	case LEXERTOKENS_DIVISION:
+		p_result->value.floating = lhs / rhs;
+		break;
+	case LEXERTOKENS_EXPONENT: {
+		if (!(rhs >= INT32_MIN && rhs <= INT32_MAX)) { // Including NaN
+			return comptime___fail(
+				p_self, node, CONCATENATE_STRING("exponents outside of i32 are left to runtime"));
+		}
+
+		if (rhs != (double)(int32_t)rhs) {
+			return comptime___fail(p_self, node,
+								   CONCATENATE_STRING("fractional exponents are left to runtime"));
+		}
+
+		double	square	  = lhs;
+		int64_t remaining = (int32_t)rhs < 0 ? -(int64_t)(int32_t)rhs : (int32_t)rhs;
+
+		p_result->value.floating = 1.0;
+
+		for (; remaining; remaining >>= 1) { // Same as 'llvm.powi'
+			if (remaining & 1) {
+				p_result->value.floating *= square;
+			}
+
+			square *= square;
+		}
+
+		if (rhs < 0) {
+			p_result->value.floating = 1.0 / p_result->value.floating;
+		}
+		break;
+	}
+	case LEXERTOKENS_EQUAL_TO:
+	case LEXERTOKENS_NOT_EQUAL_TO:
+	case LEXERTOKENS_GREATER_THAN:
+	case LEXERTOKENS_LESS_THAN:
+	case LEXERTOKENS_GREATER_THAN_OR_EQUAL:
+	case LEXERTOKENS_LESS_THAN_OR_EQUAL:
+		p_result->kind			= COMPTIME_BOOL;
+		p_result->primitive		= TYPE_PRIMITIVE_BOOL;
+		p_result->value.boolean = OPERATION == LEXERTOKENS_EQUAL_TO			? lhs == rhs
+								  : OPERATION == LEXERTOKENS_NOT_EQUAL_TO	? lhs != rhs
+								  : OPERATION == LEXERTOKENS_GREATER_THAN	? lhs > rhs
+								  : OPERATION == LEXERTOKENS_LESS_THAN		? lhs < rhs
+								  : OPERATION == LEXERTOKENS_GREATER_THAN_OR_EQUAL ? lhs >= rhs
+																				   : lhs <= rhs;
+		break;
+	default:
+		return comptime___fail(p_self, node,
+							   CONCATENATE_STRING("'", lexer_tokens_get_name(OPERATION),
+												  "' on floats is left to runtime"));
+	}
+
+	return true;
+}
+
+/**
+ * Applies a binary operator to integers of the same primitive.
+ *
+ * @param p_self     The current Comptime struct.
+ * @param node       The operator's node.
+ * @param OPERATION  The operator.
+ * @param PRIMITIVE  The primitive of the operands.
+ * @param lhs        The left operand.
+ * @param rhs        The right operand.
+ * @param p_result   Where to write the result.
+ *
+ * @return Whether the operator could be applied.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+bool comptime___binary_integer(struct Comptime* p_self, flat_ast_index_t node,
+							   const enum LexerTokenIdentifiers OPERATION,
+							   const enum TypePrimitives PRIMITIVE, int64_t lhs, int64_t rhs,
+							   struct ComptimeValue* p_result) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	bool	 isUnsigned = comptime___is_unsigned(PRIMITIVE);
+	unsigned width		= comptime___width(PRIMITIVE);
+	int64_t	 minimum	= width < 64 ? -(INT64_C(1) << (width - 1)) : INT64_MIN;
+	uint64_t left = (uint64_t)lhs, right = (uint64_t)rhs;
+
+	p_result->kind = COMPTIME_INTEGER;
+
+	switch (OPERATION) {
+	case LEXERTOKENS_DIVISION:
+	case LEXERTOKENS_FLOOR_DIVISION:
+	case LEXERTOKENS_MODULO:
+		if (rhs == 0) {
+			p_self->fatal = !p_self->failure; // Unless it follows the failure being reported
+
+			return comptime___fail(p_self, node, CONCATENATE_STRING("division by zero"));
+		}
+
+		if (!isUnsigned && lhs == minimum && rhs == -1) {
+			return comptime___fail(p_self, node, CONCATENATE_STRING("division overflows"));
+		}
+		break;
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+		if (right >= width) {
+			return comptime___fail(p_self, node, CONCATENATE_STRING("shift out of range"));
+		}
+		break;
+	default:
+		break;
+	}
+
+	switch (OPERATION) {
+	case LEXERTOKENS_ADDITION:
+		p_result->value.integer = (int64_t)(left + right);
+		break;
+	case LEXERTOKENS_SUBTRACTION:
+		p_result->value.integer = (int64_t)(left - right);
+		break;
+	case LEXERTOKENS_MULTIPLICATION:
+		p_result->value.integer = (int64_t)(left * right);
+		break;
+	case LEXERTOKENS_EXPONENT:
+		p_result->value.integer =
+			comptime___ipow(lhs, isUnsigned ? (int64_t)(right & INT64_MAX) : rhs);
+		break;
+	case LEXERTOKENS_DIVISION:
+	case LEXERTOKENS_FLOOR_DIVISION:
+		if (isUnsigned) {
+			p_result->value.integer = (int64_t)(left / right);
+		} else {
+			p_result->value.integer = lhs / rhs;
+
+			if (OPERATION == LEXERTOKENS_FLOOR_DIVISION && lhs % rhs != 0
+				&& (lhs < 0) != (rhs < 0)) {
+				p_result->value.integer--;
+			}
+		}
+		break;
+	case LEXERTOKENS_MODULO:
+		p_result->value.integer = isUnsigned ? (int64_t)(left % right) : lhs % rhs;
+		break;
+	case LEXERTOKENS_BITWISE_AND:
+		p_result->value.integer = lhs & rhs;
+		break;
+	case LEXERTOKENS_BITWISE_OR:
+		p_result->value.integer = lhs | rhs;
+		break;
+	case LEXERTOKENS_BITWISE_XOR:
+		p_result->value.integer = lhs ^ rhs;
+		break;
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+		p_result->value.integer = (int64_t)(left << right);
+		break;
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT: // Unsigned values are stored zero extended
+		p_result->value.integer = isUnsigned ? (int64_t)(left >> right) : lhs >> rhs;
+		break;
+	case LEXERTOKENS_EQUAL_TO:
+	case LEXERTOKENS_NOT_EQUAL_TO:
+	case LEXERTOKENS_GREATER_THAN:
+	case LEXERTOKENS_LESS_THAN:
+	case LEXERTOKENS_GREATER_THAN_OR_EQUAL:
+	case LEXERTOKENS_LESS_THAN_OR_EQUAL: {
+		int order = isUnsigned ? (left > right) - (left < right) : (lhs > rhs) - (lhs < rhs);
+
+		p_result->kind			= COMPTIME_BOOL;
+		p_result->primitive		= TYPE_PRIMITIVE_BOOL;
+		p_result->value.boolean = OPERATION == LEXERTOKENS_EQUAL_TO			? order == 0
+								  : OPERATION == LEXERTOKENS_NOT_EQUAL_TO	? order != 0
+								  : OPERATION == LEXERTOKENS_GREATER_THAN	? order > 0
+								  : OPERATION == LEXERTOKENS_LESS_THAN		? order < 0
+								  : OPERATION == LEXERTOKENS_GREATER_THAN_OR_EQUAL ? order >= 0
+																				   : order <= 0;
+		return true;
+	}
+	default:
+		return comptime___fail(p_self, node,
+							   CONCATENATE_STRING("'", lexer_tokens_get_name(OPERATION),
+												  "' on integers is left to runtime"));
+	}
+
+	comptime___convert(p_result, PRIMITIVE);
+
+	return true;
+}
+
+/**
+ * Applies a binary operator. An untyped literal operand takes the type of the other operand.
+ *
+ * @param p_self    The current Comptime struct.
+ * @param node      The operator's node.
+ * @param OPERATION The operator.
+ * @param p_lhs     The left operand.
+ * @param p_rhs     The right operand.
+ * @param p_result  Where to write the result.
+ *
+ * @return Whether the operator could be applied.
+ */
+bool comptime___binary(struct Comptime* p_self, flat_ast_index_t node,
+					   const enum LexerTokenIdentifiers OPERATION,
+					   const struct ComptimeValue* p_lhs, const struct ComptimeValue* p_rhs,
+					   struct ComptimeValue* p_result) {
+	enum TypePrimitives primitive =
+		p_lhs->primitive != TYPE_PRIMITIVE_VOID ? p_lhs->primitive : p_rhs->primitive;
+
+	memset(p_result, 0, COMPTIME_VALUE_SIZE);
+	p_result->primitive = (uint8_t)primitive;
+
+	if (p_lhs->kind == COMPTIME_BOOL || p_rhs->kind == COMPTIME_BOOL) {
+		if (p_lhs->kind != p_rhs->kind) {
+			return comptime___fail(p_self, node, CONCATENATE_STRING("mixed bool operands"));
+		}
+
+		bool lhs = p_lhs->value.boolean, rhs = p_rhs->value.boolean;
+
+		p_result->kind = COMPTIME_BOOL;
+
+		switch (OPERATION) {
+		case LEXERTOKENS_EQUAL_TO:
+			p_result->value.boolean = lhs == rhs;
+			return true;
+		case LEXERTOKENS_NOT_EQUAL_TO:
+		case LEXERTOKENS_BITWISE_XOR:
+			p_result->value.boolean = lhs != rhs;
+			return true;
+		case LEXERTOKENS_BITWISE_AND:
+			p_result->value.boolean = lhs && rhs;
+			return true;
+		case LEXERTOKENS_BITWISE_OR:
+			p_result->value.boolean = lhs || rhs;
+			return true;
+		default:
+			return comptime___fail(p_self, node,
+								   CONCATENATE_STRING("'", lexer_tokens_get_name(OPERATION),
+													  "' on bools is left to runtime"));
+		}
+	}
+
+	if (p_lhs->kind == COMPTIME_FLOAT || p_rhs->kind == COMPTIME_FLOAT) {
+		struct ComptimeValue lhs = *p_lhs, rhs = *p_rhs;
+
+		if (primitive != TYPE_PRIMITIVE_F32 && primitive != TYPE_PRIMITIVE_F64) {
+			primitive = p_lhs->kind == COMPTIME_FLOAT ? p_lhs->primitive : p_rhs->primitive;
+		}
+
+		comptime___convert(&lhs, TYPE_PRIMITIVE_F64);
+		comptime___convert(&rhs, TYPE_PRIMITIVE_F64);
+
+		if (!comptime___binary_float(p_self, node, OPERATION, lhs.value.floating,
+									 rhs.value.floating, p_result)) {
+			return false;
+		}
+
+		if (p_result->kind == COMPTIME_FLOAT) {
+			p_result->primitive = TYPE_PRIMITIVE_VOID;
+			comptime___convert(p_result, primitive);
+		}
+
+		return true;
+	}
+
+	return comptime___binary_integer(p_self, node, OPERATION, primitive, p_lhs->value.integer,
+									 p_rhs->value.integer, p_result);
+}
+
+bool comptime___evaluate(struct Comptime* p_self, flat_ast_index_t node,
+						 struct ComptimeValue* p_value);
+
+/**
+ * Applies a unary operator.
+ *
+ * @param p_self  The current Comptime struct.
+ * @param node    The operator's node.
+ * @param p_value Where to write the result.
+ *
+ * @return Whether the operator could be applied.
+ */
+bool comptime___unary(struct Comptime* p_self, flat_ast_index_t node,
+					  struct ComptimeValue* p_value) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (!comptime___evaluate(p_self, lp_node->lhs, p_value)) {
+		return false;
+	}
+
+	switch (lp_node->operation) {
+	case LEXERTOKENS_ADDITION:
+		return true;
+	case LEXERTOKENS_SUBTRACTION:
+		if (p_value->kind == COMPTIME_FLOAT) {
+			p_value->value.floating = -p_value->value.floating;
+		} else if (p_value->kind == COMPTIME_INTEGER) {
+			p_value->value.integer = (int64_t)(0 - (uint64_t)p_value->value.integer);
+		} else {
+			break;
+		}
+
+		comptime___convert(p_value, p_value->primitive);
+		return true;
+	case LEXERTOKENS_LOGICAL_NOT:
+		if (p_value->kind != COMPTIME_BOOL) {
+			break;
+		}
+
+		p_value->value.boolean = !p_value->value.boolean;
+		return true;
+	case LEXERTOKENS_BITWISE_NOT:
+		if (p_value->kind != COMPTIME_INTEGER) {
+			break;
+		}
+
+		p_value->value.integer = ~p_value->value.integer;
+		comptime___convert(p_value, p_value->primitive);
+		return true;
+	default:
+		break;
+	}
+
+	return comptime___fail(p_self, node,
+						   CONCATENATE_STRING("unary '", lexer_tokens_get_name(lp_node->operation),
+											  "' is left to runtime"));
+}
+
+enum ComptimeFlows comptime___execute(struct Comptime* p_self, flat_ast_index_t node,
+									  struct ComptimeValue* p_result);
+
+/**
+ * Evaluates a call to a declared pure function.
+ *
+ * @param p_self  The current Comptime struct.
+ * @param node    The call's node.
+ * @param p_value Where to write the returned value.
+ *
+ * @return Whether the call was evaluated.
+ */
+bool comptime___call(struct Comptime* p_self, flat_ast_index_t node,
+					 struct ComptimeValue* p_value) {
+	const struct FlatASTNode* lp_node  = flat_ast_get(p_self->ast, node);
+	uint32_t				  function = comptime___find(p_self, lp_node->lhs);
+
+	if (function == UINT32_MAX || !comptime_is_pure(p_self, function)) {
+		const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+
+		if (lp_callee->kind != FLATAST_VARIABLE) {
+			return comptime___fail(p_self, node,
+								   CONCATENATE_STRING("only plain calls can be evaluated"));
+		}
+
+		return comptime___fail(
+			p_self, node,
+			CONCATENATE_STRING("'", flat_ast_get_string(p_self->ast, lp_callee->value.string),
+							   function == UINT32_MAX ? "' is not a function of this module"
+													  : "' is not pure"));
+	}
+
+	const struct FlatASTNode* lp_function =
+		flat_ast_get(p_self->ast, p_self->functions[function].function);
+	size_t argCount = lp_node->value.list.length;
+
+	if (argCount != lp_function->value.list.length) {
+		return comptime___fail(p_self, node, CONCATENATE_STRING("wrong number of arguments"));
+	}
+
+	if (p_self->depth >= COMPTIME_MAX_DEPTH) {
+		char* lp_depth	= ul_to_string(COMPTIME_MAX_DEPTH);
+		char* lp_reason = CONCATENATE_STRING("calls nested deeper than ", lp_depth);
+
+		free(lp_depth);
+
+		return comptime___fail(p_self, node, lp_reason);
+	}
+
+	// Arguments are pushed unnamed, so evaluating the next one cannot see the previous ones
+	size_t base = p_self->localCount;
+
+	for (size_t index = 0; index < argCount; index++) {
+		struct ComptimeValue	  arg;
+		flat_ast_index_t		  param = flat_ast_get_list_item(p_self->ast, lp_function, index);
+		const struct FlatASTNode* lp_param = flat_ast_get(p_self->ast, param);
+		flat_ast_index_t		  value	   = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+		if (!comptime___evaluate(p_self, value, &arg)) {
+			p_self->localCount = base;
+			return false;
+		}
+
+		comptime___convert(&arg, comptime___annotation(p_self, lp_param->lhs));
+		comptime___push(p_self, INTERN_ID_NONE, &arg);
+	}
+
+	for (size_t index = 0; index < argCount; index++) {
+		p_self->locals[base + index].name =
+			comptime___name(p_self, flat_ast_get_list_item(p_self->ast, lp_function, index));
+	}
+
+	size_t			   outerFrame = p_self->frame;
+	enum ComptimeFlows flow		  = COMPTIME_FLOW_NORMAL;
+
+	p_self->frame = base;
+	p_self->depth++;
+
+	memset(p_value, 0, COMPTIME_VALUE_SIZE);
+	flow = comptime___execute(p_self, lp_function->rhs, p_value);
+
+	p_self->depth--;
+	p_self->frame	   = outerFrame;
+	p_self->localCount = base;
+
+	if (flow == COMPTIME_FLOW_FAILED) {
+		return false;
+	}
+
+	if (p_value->kind == COMPTIME_NONE) {
+		return comptime___fail(p_self, node, CONCATENATE_STRING("the call returns no value"));
+	}
+
+	comptime___convert(p_value, comptime___annotation(p_self, lp_function->lhs));
+
+	return true;
+}
+
+/**
+ * Evaluates an expression.
+ *
+ * @param p_self  The current Comptime struct.
+ * @param node    The expression's node.
+ * @param p_value Where to write the value.
+ *
+ * @return Whether the expression was evaluated.
+ */
+bool comptime___evaluate(struct Comptime* p_self, flat_ast_index_t node,
+						 struct ComptimeValue* p_value) {
+	if (!comptime___step(p_self, node)) {
+		return false;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	memset(p_value, 0, COMPTIME_VALUE_SIZE);
+
+	switch (lp_node->kind) {
+	case FLATAST_INTEGER:
+	case FLATAST_CHR:
+		p_value->kind		   = COMPTIME_INTEGER;
+		p_value->primitive =
+			lp_node->kind == FLATAST_CHR ? TYPE_PRIMITIVE_CHR : TYPE_PRIMITIVE_VOID;
+		p_value->value.integer = lp_node->value.integer;
+		comptime___convert(p_value, (enum TypePrimitives)p_value->primitive); // e.g. '\xff' is -1
+		return true;
+	case FLATAST_FLOAT:
+		p_value->kind			= COMPTIME_FLOAT;
+		p_value->value.floating = lp_node->value.floating;
+		return true;
+	case FLATAST_VARIABLE: {
+		intern_id_t name  = comptime___name(p_self, node);
+		size_t		local = comptime___lookup(p_self, name);
+
+		if (local != SIZE_MAX) {
+			*p_value = p_self->locals[local].value;
+			return true;
+		}
+
+		if (name == p_self->trueName || name == p_self->falseName) {
+			p_value->kind		   = COMPTIME_BOOL;
+			p_value->primitive	   = TYPE_PRIMITIVE_BOOL;
+			p_value->value.boolean = name == p_self->trueName;
+			return true;
+		}
+
+		return comptime___fail(
+			p_self, node,
+			CONCATENATE_STRING("'", flat_ast_get_string(p_self->ast, lp_node->value.string),
+							   "' is not known at compile time"));
+	}
+	case FLATAST_UNARY:
+		return comptime___unary(p_self, node, p_value);
+	case FLATAST_BINARY: {
+		struct ComptimeValue lhs, rhs;
+
+		if (!comptime___evaluate(p_self, lp_node->lhs, &lhs)) {
+			return false;
+		}
+
+		if ((lp_node->operation == LEXERTOKENS_LOGICAL_AND
+			 || lp_node->operation == LEXERTOKENS_LOGICAL_OR)
+			&& lhs.kind == COMPTIME_BOOL) { // Short circuits, like at runtime
+			if (lhs.value.boolean == (lp_node->operation == LEXERTOKENS_LOGICAL_OR)) {
+				*p_value = lhs;
+				return true;
+			}
+
+			return comptime___evaluate(p_self, lp_node->rhs, p_value);
+		}
+
+		return comptime___evaluate(p_self, lp_node->rhs, &rhs)
+			   && comptime___binary(p_self, node, lp_node->operation, &lhs, &rhs, p_value);
+	}
+	case FLATAST_CALL:
+		return comptime___call(p_self, node, p_value);
+	default:
+		return comptime___fail(p_self, node,
+							   CONCATENATE_STRING(flat_ast_kind_get_name(lp_node->kind),
+												  " nodes are not known at compile time"));
+	}
+}
+
+/**
+ * Gets the operator a compound assignment applies, e.g. '+' for '+='.
+ *
+ * @param OPERATION The compound assignment.
+ *
+ * @return The operator.
+ */
+enum LexerTokenIdentifiers comptime___compound(const enum LexerTokenIdentifiers OPERATION) {
+	// The compound assignments are declared in the same order as the operators they apply
+	if (OPERATION >= LEXERTOKENS_BITWISE_AND_ASSIGNMENT) {
+		return (enum LexerTokenIdentifiers)(OPERATION - LEXERTOKENS_BITWISE_AND_ASSIGNMENT
+											+ LEXERTOKENS_BITWISE_AND);
+	}
+
+	return (enum LexerTokenIdentifiers)(OPERATION - LEXERTOKENS_MODULO_ASSIGNMENT
+										+ LEXERTOKENS_MODULO);
+}
+
+/**
+ * Evaluates an assignment to a local, declaring it if it is new.
+ *
+ * @param p_self The current Comptime struct.
+ * @param node   The assignment's node.
+ *
+ * @return Whether the assignment was evaluated.
+ */
+bool comptime___assign(struct Comptime* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, lp_node->lhs);
+	struct ComptimeValue	  value;
+
+	if (lp_target->kind != FLATAST_VARIABLE && lp_target->kind != FLATAST_FIELD) {
+		return comptime___fail(p_self, node, CONCATENATE_STRING("only locals can be assigned"));
+	}
+
+	if (!comptime___evaluate(p_self, lp_node->rhs, &value)) {
+		return false;
+	}
+
+	intern_id_t name  = comptime___name(p_self, lp_node->lhs);
+	size_t		local = comptime___lookup(p_self, name);
+
+	if (lp_target->kind == FLATAST_FIELD) { // Typed declaration, e.g. 'sum: i32 = 0'
+		comptime___convert(&value, comptime___annotation(p_self, lp_target->lhs));
+		comptime___push(p_self, name, &value);
+		return true;
+	}
+
+	if (local == SIZE_MAX) {
+		comptime___push(p_self, name, &value);
+		return true;
+	}
+
+	if (lp_node->operation != LEXERTOKENS_ASSIGNMENT) { // e.g. 'total += n'
+		struct ComptimeValue current = p_self->locals[local].value;
+		struct ComptimeValue result;
+
+		if (!comptime___binary(p_self, node, comptime___compound(lp_node->operation), &current,
+							   &value, &result)) {
+			return false;
+		}
+
+		value = result;
+	}
+
+	comptime___convert(&value, p_self->locals[local].value.primitive);
+	p_self->locals[local].value = value;
+
+	return true;
+}
+
+/**
+ * Evaluates a condition, which must be a bool.
+ *
+ * @param p_self    The current Comptime struct.
+ * @param node      The condition's node.
+ * @param p_boolean Where to write the condition's value.
+ *
+ * @return Whether the condition was evaluated.
+ */
+bool comptime___condition(struct Comptime* p_self, flat_ast_index_t node, bool* p_boolean) {
+	struct ComptimeValue value;
+
+	if (!comptime___evaluate(p_self, node, &value)) {
+		return false;
+	}
+
+	if (value.kind != COMPTIME_BOOL) {
+		return comptime___fail(p_self, node, CONCATENATE_STRING("condition is not a bool"));
+	}
+
+	*p_boolean = value.value.boolean;
+
+	return true;
+}
+
+/**
+ * Evaluates a 'for range(a, b) => i' loop.
+ *
+ * @param p_self   The current Comptime struct.
+ * @param node     The loop's node.
+ * @param p_result Where to write the value returned from within the loop.
+ *
+ * @return How the loop was left.
+ */
+enum ComptimeFlows comptime___for(struct Comptime* p_self, flat_ast_index_t node,
+								  struct ComptimeValue* p_result) {
+	const struct FlatASTNode* lp_node	  = flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_iterable = flat_ast_get(p_self->ast, lp_node->lhs);
+	size_t					  argCount	  = lp_iterable->value.list.length;
+	struct ComptimeValue	  start		  = {COMPTIME_INTEGER, TYPE_PRIMITIVE_VOID, {0}}, end;
+
+	if (lp_node->value.list.length != 1 || lp_iterable->kind != FLATAST_CALL
+		|| !comptime___is_range(p_self, lp_iterable->lhs) || (argCount != 1 && argCount != 2)) {
+		comptime___fail(p_self, node, CONCATENATE_STRING("only range loops can be evaluated"));
+		return COMPTIME_FLOW_FAILED;
+	}
+
+	if ((argCount == 2
+		 && !comptime___evaluate(p_self, flat_ast_get_list_item(p_self->ast, lp_iterable, 0),
+								 &start))
+		|| !comptime___evaluate(p_self,
+								flat_ast_get_list_item(p_self->ast, lp_iterable, argCount - 1),
+								&end)) {
+		return COMPTIME_FLOW_FAILED;
+	}
+
+	if (start.kind != COMPTIME_INTEGER || end.kind != COMPTIME_INTEGER) {
+		comptime___fail(p_self, node, CONCATENATE_STRING("range bounds are not integers"));
+		return COMPTIME_FLOW_FAILED;
+	}
+
+	size_t			   mark	   = p_self->localCount;
+	enum ComptimeFlows flow	   = COMPTIME_FLOW_NORMAL;
+	struct ComptimeValue index = start;
+
+	index.primitive = start.primitive != TYPE_PRIMITIVE_VOID ? start.primitive : end.primitive;
+
+	flat_ast_index_t binding = flat_ast_get_list_item(p_self->ast, lp_node, 0);
+
+	comptime___push(p_self, comptime___name(p_self, binding), &index);
+
+	for (int64_t value = start.value.integer; value < end.value.integer; value++) {
+		p_self->locals[mark].value.value.integer = value; // Reset, even if the body wrote it
+
+		flow = comptime___execute(p_self, lp_node->rhs, p_result);
+
+		if (flow != COMPTIME_FLOW_NORMAL) {
+			break;
+		}
+	}
+
+	p_self->localCount = mark;
+
+	return flow;
+}
+
+/**
+ * Evaluates a statement.
+ *
+ * @param p_self   The current Comptime struct.
+ * @param node     The statement's node.
+ * @param p_result Where to write the value of a return statement.
+ *
+ * @return How the statement was left.
+ */
+enum ComptimeFlows comptime___execute(struct Comptime* p_self, flat_ast_index_t node,
+									  struct ComptimeValue* p_result) {
+	if (!comptime___step(p_self, node)) {
+		return COMPTIME_FLOW_FAILED;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	enum ComptimeFlows		  flow	  = COMPTIME_FLOW_NORMAL;
+	bool					  taken	  = false;
+
+	switch (lp_node->kind) {
+	case FLATAST_BLOCK: { // Locals declared in the block go out of scope with it
+		size_t mark = p_self->localCount;
+
+		for (size_t index = 0; index < lp_node->value.list.length && flow == COMPTIME_FLOW_NORMAL;
+			 index++) {
+			flow = comptime___execute(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index),
+									  p_result);
+		}
+
+		p_self->localCount = mark;
+
+		return flow;
+	}
+	case FLATAST_IF:
+		if (!comptime___condition(p_self, lp_node->lhs, &taken)) {
+			return COMPTIME_FLOW_FAILED;
+		}
+
+		if (taken) {
+			return comptime___execute(p_self, lp_node->rhs, p_result);
+		}
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			flat_ast_index_t branch = flat_ast_get_list_item(p_self->ast, lp_node, index);
+			const struct FlatASTNode* lp_branch = flat_ast_get(p_self->ast, branch);
+
+			if (lp_branch->kind != FLATAST_IF) { // else
+				return comptime___execute(p_self, branch, p_result);
+			}
+
+			if (!comptime___condition(p_self, lp_branch->lhs, &taken)) {
+				return COMPTIME_FLOW_FAILED;
+			}
+
+			if (taken) {
+				return comptime___execute(p_self, lp_branch->rhs, p_result);
+			}
+		}
+
+		return COMPTIME_FLOW_NORMAL;
+	case FLATAST_WHILE:
+		while (flow == COMPTIME_FLOW_NORMAL) {
+			if (!comptime___condition(p_self, lp_node->lhs, &taken)) {
+				return COMPTIME_FLOW_FAILED;
+			}
+
+			if (!taken) {
+				break;
+			}
+
+			flow = comptime___execute(p_self, lp_node->rhs, p_result);
+		}
+
+		return flow;
+	case FLATAST_FOR:
+		return comptime___for(p_self, node, p_result);
+	case FLATAST_RETURN:
+		if (lp_node->lhs != FLATAST_INDEX_NONE
+			&& !comptime___evaluate(p_self, lp_node->lhs, p_result)) {
+			return COMPTIME_FLOW_FAILED;
+		}
+
+		return COMPTIME_FLOW_RETURN;
+	case FLATAST_ASSIGNMENT:
+		return comptime___assign(p_self, node) ? COMPTIME_FLOW_NORMAL : COMPTIME_FLOW_FAILED;
+	default: { // Expression statement
+		struct ComptimeValue value;
+
+		return comptime___evaluate(p_self, node, &value) ? COMPTIME_FLOW_NORMAL
+														 : COMPTIME_FLOW_FAILED;
+	}
+	}
+}
+
+bool comptime_fold(struct Comptime* p_self, flat_ast_index_t node, struct ComptimeValue* p_value) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	bool					  forced  = false;
+
+	if (lp_node->kind == FLATAST_CALL) {
+		uint32_t function = comptime___find(p_self, lp_node->lhs);
+
+		forced = attributes_has(p_self->ast, node, ATTRIBUTE_COMPTIME)
+				 || (function != UINT32_MAX
+					 && attributes_has(p_self->ast, p_self->functions[function].function,
+									   ATTRIBUTE_COMPTIME));
+	}
+
+	p_self->steps	   = 0;
+	p_self->depth	   = 0;
+	p_self->frame	   = 0;
+	p_self->localCount = 0;
+	p_self->fatal	   = false;
+
+	bool folded = comptime___evaluate(p_self, node, p_value);
+
+	p_self->totalSteps += p_self->steps;
+
+	if (folded) {
+		p_self->folded++;
+
+		return true;
+	}
+
+	if (p_self->fatal) { // Rather than leaving it to panic at runtime
+		compiler_error(p_self->filePath, p_self->failureLine, C0005, p_self->failure);
+	}
+
+	if (forced) {
+		compiler_error(p_self->filePath, p_self->failureLine, C0005,
+					   CONCATENATE_STRING("cannot evaluate at compile time: ", p_self->failure));
+	}
+
+	p_self->failed++;
+
+	free(p_self->failure);
+	p_self->failure = NULL;
+
+	return false;
+}
+
+void comptime_value_append(const struct ComptimeValue* p_value, const enum TypePrimitives TYPE,
+						   struct String* p_output) {
+	struct ComptimeValue value = *p_value;
+	char				 constant[32];
+
+	comptime___convert(&value, TYPE);
+
+	switch (value.kind) {
+	case COMPTIME_BOOL:
+		string_append_str(p_output, value.value.boolean ? "true" : "false");
+		return;
+	case COMPTIME_FLOAT: { // Hexadecimal, so the constant is exact (a float is stored widened)
+		uint64_t bits = 0;
+
+		memcpy(&bits, &value.value.floating, sizeof(bits));
+		snprintf(constant, sizeof(constant), "0x%016" PRIX64, bits);
+		break;
+	}
+	case COMPTIME_INTEGER: // Signed, which LLVM accepts for unsigned types of the same width
+		snprintf(constant, sizeof(constant), "%" PRId64, value.value.integer);
+		break;
+	default:
+		PANIC("Comptime value has no kind");
+	}
+
+	string_append_str(p_output, constant);
+}
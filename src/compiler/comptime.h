@@ -0,0 +1,172 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMPTIME_STEP_BUDGET 1000000U // Nodes evaluated per fold before giving up.
+#define COMPTIME_MAX_DEPTH	 512U	  // Nested calls per fold, so the compiler's stack is safe.
+
+/**
+ * Used to identify the kinds of values known at compile time.
+ */
+enum ComptimeValueKinds {
+	COMPTIME_NONE,
+	COMPTIME_INTEGER,
+	COMPTIME_FLOAT,
+	COMPTIME_BOOL,
+};
+
+/**
+ * Used to identify how a statement was left while evaluating it.
+ */
+enum ComptimeFlows {
+	COMPTIME_FLOW_NORMAL,
+	COMPTIME_FLOW_RETURN,
+	COMPTIME_FLOW_FAILED,
+};
+
+/**
+ * Represents a value known at compile time. Integers hold the bits of their primitive sign or zero
+ * extended to 64 bits, and wrap around like they would at runtime.
+ */
+struct ComptimeValue {
+	uint8_t kind;	   // enum ComptimeValueKinds
+	uint8_t primitive; // enum TypePrimitives, TYPE_PRIMITIVE_VOID for an untyped literal.
+	union {
+		int64_t integer;
+		double	floating;
+		bool	boolean;
+	} value;
+};
+
+#define COMPTIME_VALUE_SIZE sizeof(struct ComptimeValue)
+
+/**
+ * Used to identify whether a function can be evaluated at compile time.
+ */
+enum ComptimePurities {
+	COMPTIME_PURITY_UNKNOWN,
+	COMPTIME_PURITY_CHECKING, // Being checked, so recursive calls are assumed pure.
+	COMPTIME_PURITY_PURE,
+	COMPTIME_PURITY_IMPURE,
+};
+
+/**
+ * Represents a function declared in the module, e.g. 'fibonacci = func(n: i32) -> i32 { ... }'.
+ */
+struct ComptimeFunction {
+	flat_ast_index_t function; // The FUNCTION node.
+	uint8_t			 purity;   // enum ComptimePurities
+};
+
+#define COMPTIME_FUNCTION_SIZE sizeof(struct ComptimeFunction)
+
+/**
+ * Represents a local variable of a function being evaluated.
+ */
+struct ComptimeLocal {
+	intern_id_t			 name;
+	struct ComptimeValue value;
+};
+
+#define COMPTIME_LOCAL_SIZE sizeof(struct ComptimeLocal)
+
+/**
+ * Represents the compile time evaluator of a module, an interpreter walking the FlatAST. Pure
+ * functions (no I/O, no memory, only calls to other pure functions) called with constant arguments
+ * and constant expressions are evaluated within a step budget, so their results can be emitted as
+ * constants instead of being computed at startup. Folding is best effort, unless the call or the
+ * function is marked '@comptime', in which case failing to fold is an error.
+ */
+struct Comptime {
+	const char*				 filePath;
+	struct FlatAST*			 ast;
+	struct Interner*		 interner;
+	struct ComptimeFunction* functions;
+	uint32_t*				 byName; // Function indexes + 1, indexed by interned name.
+	struct ComptimeLocal*	 locals; // The locals of every call being evaluated.
+	size_t functionCount, functionCapacity, byNameCapacity, localCount, localCapacity;
+	size_t		frame;	 // Where the locals of the innermost call start.
+	size_t		depth;	 // Nested calls being evaluated.
+	size_t		steps;	 // Steps taken by the current fold.
+	char*		failure; // Why the current fold failed, NULL if it has not.
+	uint32_t	failureLine;
+	bool		fatal; // Whether the failure would fail at runtime too, e.g. a division by zero.
+	intern_id_t trueName, falseName;
+	size_t		folded, failed, totalSteps; // For the time report.
+};
+
+#define COMPTIME_STRUCT_SIZE sizeof(struct Comptime)
+
+/**
+ * Creates a new Comptime struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_ast      The module's AST.
+ * @param p_interner The module's interner.
+ *
+ * @return The created Comptime struct.
+ */
+struct Comptime* comptime_new(const char* p_filePath, struct FlatAST* p_ast,
+							  struct Interner* p_interner);
+
+/**
+ * Frees a Comptime struct.
+ *
+ * @param p_self The current Comptime struct.
+ */
+void comptime_free(struct Comptime** p_self);
+
+/**
+ * Declares a function of the module, so calls to it can be evaluated.
+ *
+ * @param p_self   The current Comptime struct.
+ * @param name     The interned name of the function.
+ * @param function The FUNCTION node.
+ */
+void comptime_declare(struct Comptime* p_self, intern_id_t name, flat_ast_index_t function);
+
+/**
+ * Checks whether a declared function is pure, i.e. only computes a result from its arguments.
+ *
+ * @param p_self   The current Comptime struct.
+ * @param function The index of the function.
+ *
+ * @return Whether the function is pure.
+ */
+bool comptime_is_pure(struct Comptime* p_self, uint32_t function);
+
+/**
+ * Tries to evaluate an expression at compile time, e.g. '2 ** 3 + 5 * 4 - 10 / 2' or
+ * 'fibonacci(10)'. Errors if the expression is a call marked '@comptime', or a call to a function
+ * marked '@comptime', that cannot be evaluated.
+ *
+ * @param p_self  The current Comptime struct.
+ * @param node    The expression's node.
+ * @param p_value Where to write the value.
+ *
+ * @return Whether the expression was evaluated.
+ */
+bool comptime_fold(struct Comptime* p_self, flat_ast_index_t node, struct ComptimeValue* p_value);
+
+/**
+ * Appends a value as an LLVM constant of a primitive type, e.g. '55' or '0x4002000000000000'.
+ *
+ * @param p_value  The value.
+ * @param TYPE     The primitive type of the constant.
+ * @param p_output Where to append the constant.
+ */
+void comptime_value_append(
+	const struct ComptimeValue* p_value,
+	const enum TypePrimitives	TYPE, // NOLINT(readability-avoid-const-params-in-decls)
+	struct String*				p_output);
@@ -0,0 +1,462 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./coro.h"
+#include "./attributes.h"
+#include "./diagnostics.h"
+#include "./loops.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CORO_TYPE_LENGTH 128U
+#define CORO_LINE_LENGTH 1024U
+
+struct Coroutines* coroutines_new(const char* p_filePath, const struct TypeTable* p_types) {
+	struct Coroutines* lp_self = calloc(1, COROUTINES_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Coroutines struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->types	  = p_types;
+
+	return lp_self;
+}
+
+void coroutines_free(struct Coroutines** p_self) {
+	if (p_self && *p_self) {
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Coroutines struct has already been freed");
+	}
+}
+
+/**
+ * Errors on a node of the current function that cannot be used in it.
+ *
+ * @param p_self    The current Coroutines struct.
+ * @param node      The node.
+ * @param p_message The error message.
+ */
+void coroutines___error(const struct Coroutines* p_self, flat_ast_index_t node,
+						const char* p_message) {
+	compiler_error(p_self->filePath, flat_ast_get(p_self->ast, node)->line, C0011, p_message);
+}
+
+/**
+ * Checks whether a call is 'yield(value)'.
+ *
+ * @param p_self The current Coroutines struct.
+ * @param p_call The call.
+ *
+ * @return Whether the call yields.
+ */
+bool coroutines___is_yield(const struct Coroutines* p_self, const struct FlatASTNode* p_call) {
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, p_call->lhs);
+
+	return lp_callee->kind == FLATAST_VARIABLE
+		   && strcmp(flat_ast_get_string(p_self->ast, lp_callee->value.string),
+					 CORO_YIELD_FUNCTION)
+				  == 0;
+}
+
+/**
+ * Checks the suspension points of the current function, counting them. Nested functions are
+ * checked on their own.
+ *
+ * @param p_self   The current Coroutines struct.
+ * @param node     A node of the function.
+ * @param parallel Whether the node is in the body of a parallel loop, which is outlined.
+ */
+void coroutines___walk(struct Coroutines* p_self, flat_ast_index_t node, bool parallel) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_FUNCTION:
+		return;
+	case FLATAST_CALL:
+		if (attributes_has(p_self->ast, node, ATTRIBUTE_AWAIT)) {
+			if (p_self->kind != CORO_ASYNC) {
+				coroutines___error(p_self, node,
+								   "'@await' can only be used in '@async' functions");
+			}
+
+			if (parallel) {
+				coroutines___error(p_self, node, "'@await' cannot be used in parallel loops");
+			}
+
+			p_self->awaits++;
+		}
+
+		if (coroutines___is_yield(p_self, lp_node)) {
+			if (p_self->kind != CORO_GENERATOR || lp_node->value.list.length != 1) {
+				coroutines___error(p_self, node,
+								   "'" CORO_YIELD_FUNCTION
+								   "' takes one value, and can only be called in '@generator' "
+								   "functions");
+			}
+
+			if (parallel) {
+				coroutines___error(p_self, node,
+								   "'" CORO_YIELD_FUNCTION "' cannot be called in parallel loops");
+			}
+
+			p_self->yields++;
+		}
+
+		if (p_self->kind != CORO_NONE && attributes_has(p_self->ast, node, ATTRIBUTE_TAILCALL)) {
+			coroutines___error(p_self, node,
+							   "'@tailcall' calls cannot be made from coroutines, whose frame "
+							   "must stay alive until they complete");
+		}
+		break;
+	case FLATAST_RETURN:
+		if (p_self->kind == CORO_GENERATOR && lp_node->lhs != FLATAST_INDEX_NONE) {
+			coroutines___error(p_self, node,
+							   "generators cannot return a value, they '" CORO_YIELD_FUNCTION
+							   "' them");
+		}
+		break;
+	case FLATAST_FOR:
+		parallel = parallel
+				   || loop_lowering_get_parallel_source(p_self->ast, lp_node->lhs)
+						  != FLATAST_INDEX_NONE;
+		break;
+	default:
+		break;
+	}
+
+	coroutines___walk(p_self, lp_node->lhs, parallel);
+	coroutines___walk(p_self, lp_node->rhs, parallel);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			coroutines___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index),
+							  parallel);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+enum CoroKinds coroutines_analyse(struct Coroutines* p_self, const struct FlatAST* p_ast,
+								  flat_ast_index_t function) {
+	bool isAsync	 = attributes_has(p_ast, function, ATTRIBUTE_ASYNC);
+	bool isGenerator = attributes_has(p_ast, function, ATTRIBUTE_GENERATOR);
+
+	p_self->ast		 = p_ast;
+	p_self->suspends = 0;
+	p_self->kind	 = isAsync ? CORO_ASYNC : isGenerator ? CORO_GENERATOR : CORO_NONE;
+
+	if (isAsync && isGenerator) {
+		coroutines___error(p_self, function,
+						   "functions cannot be both '@async' and '@generator'");
+	}
+
+	if (p_self->kind != CORO_NONE
+		&& (attributes_has(p_ast, function, ATTRIBUTE_MEMO)
+			|| attributes_has(p_ast, function, ATTRIBUTE_MEMO_LRU)
+			|| attributes_has(p_ast, function, ATTRIBUTE_COMPTIME))) {
+		coroutines___error(p_self, function,
+						   "coroutines cannot be '@memo', '@memo_lru' or '@comptime', as "
+						   "calling one gives a new task or generator every time");
+	}
+
+	coroutines___walk(p_self, flat_ast_get(p_ast, function)->rhs, false);
+
+	if (p_self->kind == CORO_ASYNC) {
+		p_self->asyncs++;
+	} else if (p_self->kind == CORO_GENERATOR) {
+		p_self->generators++;
+	}
+
+	return p_self->kind;
+}
+
+/**
+ * Writes the LLVM type of a coroutine's promise: the handle of the coroutine awaiting it, then its
+ * value, if any.
+ *
+ * @param p_valueType The LLVM type of the value, or 'void'.
+ * @param p_promise   Where to write the type (CORO_TYPE_LENGTH characters), e.g. '{ i8*, i32 }'.
+ */
+void coroutines___promise_type(const char* p_valueType, char* p_promise) {
+	if (strcmp(p_valueType, "void") == 0) {
+		snprintf(p_promise, CORO_TYPE_LENGTH, "{ i8* }");
+	} else {
+		snprintf(p_promise, CORO_TYPE_LENGTH, "{ i8*, %s }", p_valueType);
+	}
+}
+
+/**
+ * Declares the coroutine intrinsics, once per module.
+ *
+ * @param p_self   The current Coroutines struct.
+ * @param p_module Where to append the declarations, at module level.
+ */
+void coroutines___declare(struct Coroutines* p_self, struct String* p_module) {
+	if (p_self->declared) {
+		return;
+	}
+
+	string_append_str(p_module, "declare token @llvm.coro.id(i32, i8*, i8*, i8*)\n"
+								"declare i1 @llvm.coro.alloc(token)\n"
+								"declare i64 @llvm.coro.size.i64()\n"
+								"declare i8* @llvm.coro.begin(token, i8*)\n"
+								"declare i8 @llvm.coro.suspend(token, i1)\n"
+								"declare i8* @llvm.coro.free(token, i8*)\n"
+								"declare i1 @llvm.coro.end(i8*, i1)\n"
+								"declare void @llvm.coro.resume(i8*)\n"
+								"declare void @llvm.coro.destroy(i8*)\n"
+								"declare i1 @llvm.coro.done(i8*)\n"
+								"declare i8* @llvm.coro.promise(i8*, i32, i1)\n");
+	p_self->declared = true;
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_begin(struct Coroutines* p_self, const char* p_valueType,
+						   struct String* p_function, struct String* p_module) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char promise[CORO_TYPE_LENGTH];
+	char line[CORO_LINE_LENGTH];
+
+	coroutines___declare(p_self, p_module);
+	coroutines___promise_type(p_valueType, promise);
+
+	// %coro.promise = alloca PROMISE, align 8
+	// %coro.waiter = getelementptr inbounds PROMISE, PROMISE* %coro.promise, i64 0, i32 0
+	// store i8* null, i8** %coro.waiter
+	snprintf(line, sizeof(line),
+			 "  %%coro.promise = alloca %s, align 8\n"
+			 "  %%coro.waiter = getelementptr inbounds %s, %s* %%coro.promise, i64 0, i32 0\n"
+			 "  store i8* null, i8** %%coro.waiter\n",
+			 promise, promise, promise);
+	string_append_str(p_function, line);
+
+	if (strcmp(p_valueType, "void") != 0) {
+		// %coro.result = getelementptr inbounds PROMISE, PROMISE* %coro.promise, i64 0, i32 1
+		snprintf(line, sizeof(line),
+				 "  %%coro.result = getelementptr inbounds %s, %s* %%coro.promise, i64 0, i32 1\n",
+				 promise, promise);
+		string_append_str(p_function, line);
+	}
+
+	// The frame is only allocated if LLVM cannot elide it into the caller's
+	snprintf(line, sizeof(line),
+			 "  %%coro.promise.raw = bitcast %s* %%coro.promise to i8*\n"
+			 "  %%coro.id = call token @llvm.coro.id(i32 8, i8* %%coro.promise.raw, i8* null, "
+			 "i8* null)\n",
+			 promise);
+	string_append_str(p_function, line);
+	string_append_str(p_function,
+					  "  %coro.allocate = call i1 @llvm.coro.alloc(token %coro.id)\n"
+					  "  br i1 %coro.allocate, label %coro.alloc, label %coro.begin\n\n"
+					  "coro.alloc:\n"
+					  "  %coro.size = call i64 @llvm.coro.size.i64()\n"
+					  "  %coro.memory = call i8* @malloc(i64 %coro.size)\n"
+					  "  br label %coro.begin\n\n"
+					  "coro.begin:\n"
+					  "  %coro.frame = phi i8* [ null, %entry ], [ %coro.memory, %coro.alloc ]\n"
+					  "  %coro.handle = call i8* @llvm.coro.begin(token %coro.id, i8* "
+					  "%coro.frame)\n");
+
+	if (p_self->kind == CORO_GENERATOR) { // Lazy, so creating a generator runs none of it
+		string_append_str(p_function,
+						  "  %coro.start = call i8 @llvm.coro.suspend(token none, i1 false)\n"
+						  "  switch i8 %coro.start, label %coro.suspend [ i8 0, label %coro.body "
+						  "i8 1, label %coro.cleanup ]\n\n"
+						  "coro.body:\n");
+	}
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_return(const struct Coroutines* p_self, const char* p_valueType,
+							const char* p_value, struct String* p_function) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char line[CORO_LINE_LENGTH];
+
+	if (p_self->kind == CORO_ASYNC && p_value) {
+		// store T value, T* %coro.result
+		snprintf(line, sizeof(line), "  store %s %s, %s* %%coro.result\n", p_valueType, p_value,
+				 p_valueType);
+		string_append_str(p_function, line);
+	}
+
+	string_append_str(p_function, "  br label %coro.final\n");
+}
+
+/**
+ * Emits a suspension of the current coroutine, which continues at a new block once resumed, or
+ * frees its frame if it is destroyed instead.
+ *
+ * @param p_self     The current Coroutines struct.
+ * @param p_prefix   The prefix of the suspension's names, e.g. 'yield'.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+void coroutines___emit_suspend(struct Coroutines* p_self, const char* p_prefix,
+							   struct String* p_function) {
+	char line[CORO_LINE_LENGTH];
+
+	// %PREFIX.N.state = call i8 @llvm.coro.suspend(token none, i1 false)
+	// switch i8 %PREFIX.N.state, label %coro.suspend [ i8 0, label %PREFIX.N.resume
+	//                                                  i8 1, label %coro.cleanup ]
+	// PREFIX.N.resume:
+	snprintf(line, sizeof(line),
+			 "  %%%s.%zu.state = call i8 @llvm.coro.suspend(token none, i1 false)\n"
+			 "  switch i8 %%%s.%zu.state, label %%coro.suspend [ i8 0, label %%%s.%zu.resume "
+			 "i8 1, label %%coro.cleanup ]\n\n%s.%zu.resume:\n",
+			 p_prefix, p_self->suspends, p_prefix, p_self->suspends, p_prefix, p_self->suspends,
+			 p_prefix, p_self->suspends);
+	string_append_str(p_function, line);
+
+	p_self->suspends++;
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_yield(struct Coroutines* p_self, const char* p_valueType, const char* p_value,
+						   struct String* p_function) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char line[CORO_LINE_LENGTH];
+
+	// store T value, T* %coro.result
+	snprintf(line, sizeof(line), "  store %s %s, %s* %%coro.result\n", p_valueType, p_value,
+			 p_valueType);
+	string_append_str(p_function, line);
+
+	coroutines___emit_suspend(p_self, "yield", p_function);
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_await(struct Coroutines* p_self, const char* p_task, const char* p_valueType,
+						   const char* p_result, struct String* p_function) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char   promise[CORO_TYPE_LENGTH];
+	char   line[CORO_LINE_LENGTH];
+	size_t id = p_self->suspends;
+
+	coroutines___promise_type(p_valueType, promise);
+
+	// %await.N.promise = call i8* @llvm.coro.promise(i8* TASK, i32 8, i1 false)
+	// %await.N.task = bitcast i8* %await.N.promise to PROMISE*
+	// %await.N.done = call i1 @llvm.coro.done(i8* TASK)
+	// br i1 %await.N.done, label %await.N.ready, label %await.N.wait
+	snprintf(line, sizeof(line),
+			 "  %%await.%zu.promise = call i8* @llvm.coro.promise(i8* %s, i32 8, i1 false)\n"
+			 "  %%await.%zu.task = bitcast i8* %%await.%zu.promise to %s*\n"
+			 "  %%await.%zu.done = call i1 @llvm.coro.done(i8* %s)\n"
+			 "  br i1 %%await.%zu.done, label %%await.%zu.ready, label %%await.%zu.wait\n\n",
+			 id, p_task, id, id, promise, id, p_task, id, id, id);
+	string_append_str(p_function, line);
+
+	// The task wakes this coroutine once it completes
+	// await.N.wait:
+	// %await.N.waiter = getelementptr inbounds PROMISE, PROMISE* %await.N.task, i64 0, i32 0
+	// store i8* %coro.handle, i8** %await.N.waiter
+	snprintf(line, sizeof(line),
+			 "await.%zu.wait:\n"
+			 "  %%await.%zu.waiter = getelementptr inbounds %s, %s* %%await.%zu.task, i64 0, "
+			 "i32 0\n"
+			 "  store i8* %%coro.handle, i8** %%await.%zu.waiter\n",
+			 id, id, promise, promise, id, id);
+	string_append_str(p_function, line);
+
+	coroutines___emit_suspend(p_self, "await", p_function);
+
+	// br label %await.N.ready
+	// await.N.ready:
+	snprintf(line, sizeof(line), "  br label %%await.%zu.ready\n\nawait.%zu.ready:\n", id, id);
+	string_append_str(p_function, line);
+
+	if (strcmp(p_valueType, "void") != 0) {
+		// %await.N.result = getelementptr inbounds PROMISE, PROMISE* %await.N.task, i64 0, i32 1
+		// RESULT = load T, T* %await.N.result
+		snprintf(line, sizeof(line),
+				 "  %%await.%zu.result = getelementptr inbounds %s, %s* %%await.%zu.task, i64 0, "
+				 "i32 1\n  %s = load %s, %s* %%await.%zu.result\n",
+				 id, promise, promise, id, p_result, p_valueType, p_valueType, id);
+		string_append_str(p_function, line);
+	}
+
+	// call void @llvm.coro.destroy(i8* TASK)
+	snprintf(line, sizeof(line), "  call void @llvm.coro.destroy(i8* %s)\n", p_task);
+	string_append_str(p_function, line);
+}
+
+void coroutines_emit_end(const struct Coroutines* p_self, struct String* p_function) {
+	string_append_str(p_function, "\ncoro.final:\n");
+
+	if (p_self->kind == CORO_ASYNC) {
+		string_append_str(p_function, "  call void @io_SEP_complete(i8* %coro.handle)\n");
+	}
+
+	string_append_str(
+		p_function,
+		"  %coro.last = call i8 @llvm.coro.suspend(token none, i1 true)\n"
+		"  switch i8 %coro.last, label %coro.suspend [ i8 0, label %coro.unreachable i8 1, label "
+		"%coro.cleanup ]\n\n"
+		"coro.unreachable: ; complete coroutines are never resumed\n"
+		"  unreachable\n\n"
+		"coro.cleanup:\n"
+		"  %coro.memory.free = call i8* @llvm.coro.free(token %coro.id, i8* %coro.handle)\n"
+		"  call void @free(i8* %coro.memory.free)\n"
+		"  br label %coro.suspend\n\n"
+		"coro.suspend:\n"
+		"  %coro.ended = call i1 @llvm.coro.end(i8* %coro.handle, i1 false)\n"
+		"  ret i8* %coro.handle\n}\n");
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_next(struct Coroutines* p_self, const char* p_generator,
+						  const char* p_valueType, const char* p_done, const char* p_value,
+						  struct String* p_function, struct String* p_module) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char promise[CORO_TYPE_LENGTH];
+	char line[CORO_LINE_LENGTH];
+
+	coroutines___declare(p_self, p_module);
+	coroutines___promise_type(p_valueType, promise);
+
+	// call void @llvm.coro.resume(i8* GENERATOR)
+	// DONE = call i1 @llvm.coro.done(i8* GENERATOR)
+	// DONE.promise = call i8* @llvm.coro.promise(i8* GENERATOR, i32 8, i1 false)
+	// DONE.generator = bitcast i8* DONE.promise to PROMISE*
+	// DONE.value = getelementptr inbounds PROMISE, PROMISE* DONE.generator, i64 0, i32 1
+	// VALUE = load T, T* DONE.value
+	snprintf(line, sizeof(line),
+			 "  call void @llvm.coro.resume(i8* %s)\n  %s = call i1 @llvm.coro.done(i8* %s)\n"
+			 "  %s.promise = call i8* @llvm.coro.promise(i8* %s, i32 8, i1 false)\n"
+			 "  %s.generator = bitcast i8* %s.promise to %s*\n"
+			 "  %s.value = getelementptr inbounds %s, %s* %s.generator, i64 0, i32 1\n"
+			 "  %s = load %s, %s* %s.value\n",
+			 p_generator, p_done, p_generator, p_done, p_generator, p_done, p_done, promise,
+			 p_done, promise, promise, p_done, p_value, p_valueType, p_valueType, p_done);
+	string_append_str(p_function, line);
+}
+
+void coroutines_emit_destroy(struct Coroutines* p_self, const char* p_handle,
+							 struct String* p_function, struct String* p_module) {
+	char line[CORO_LINE_LENGTH];
+
+	coroutines___declare(p_self, p_module);
+
+	// call void @llvm.coro.destroy(i8* HANDLE)
+	snprintf(line, sizeof(line), "  call void @llvm.coro.destroy(i8* %s)\n", p_handle);
+	string_append_str(p_function, line);
+}
@@ -0,0 +1,179 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CORO_TASK_TYPE		"Task"		// Calling an '@async' function gives a 'Task<T>'.
+#define CORO_GENERATOR_TYPE "Generator" // Calling a '@generator' gives a 'Generator<T>'.
+#define CORO_YIELD_FUNCTION "yield"		// Called by generators with each value, 'yield(value)'.
+
+#define CORO_ATTRIBUTES "\"coroutine.presplit\"=\"0\"" // Marks the functions LLVM must split.
+
+/**
+ * Used to identify the kinds of coroutines.
+ */
+enum CoroKinds {
+	CORO_NONE,		// A normal function.
+	CORO_ASYNC,		// Runs until it first awaits something unfinished, completing a task later.
+	CORO_GENERATOR, // Runs up to its next 'yield' each time the generator is resumed.
+};
+
+/**
+ * Represents the lowering of coroutines onto LLVM's 'llvm.coro' intrinsics. LLVM splits each one
+ * into a frame holding the values live across suspensions, and functions resuming and destroying
+ * it, so a suspended coroutine costs its frame rather than a stack. The frame is allocated with
+ * 'llvm.coro.alloc', which LLVM elides when the coroutine never outlives its caller, e.g. a
+ * generator looped over, or a task awaited that completes without suspending.
+ *
+ * Both kinds return the frame's handle, whose promise holds the handle of the coroutine awaiting
+ * it ('io' in std.ll) and then the value: the task's result, or the generator's current value.
+ * '@await' calls of unfinished tasks suspend their caller until the event loop wakes it.
+ */
+struct Coroutines {
+	const char*				filePath; // For diagnostics.
+	const struct TypeTable* types;
+	const struct FlatAST*	ast;	  // The AST of the current function.
+	uint8_t					kind;	  // enum CoroKinds of the current function.
+	size_t					suspends; // Suspension points of the current function, for labels.
+	bool					declared; // Whether the intrinsics are declared.
+	size_t					asyncs, generators, awaits, yields; // For the time report.
+};
+
+#define COROUTINES_STRUCT_SIZE sizeof(struct Coroutines)
+
+/**
+ * Creates a new Coroutines struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_types    The module's type table.
+ *
+ * @return The created Coroutines struct.
+ */
+struct Coroutines* coroutines_new(const char* p_filePath, const struct TypeTable* p_types);
+
+/**
+ * Frees a Coroutines struct.
+ *
+ * @param p_self The current Coroutines struct.
+ */
+void coroutines_free(struct Coroutines** p_self);
+
+/**
+ * Decides whether a function is a coroutine. Errors if it is marked both '@async'
+ * and '@generator', or '@memo' or '@comptime' too, or if it awaits outside '@async' functions,
+ * yields outside generators, returns a value from a generator, or makes '@tailcall' calls.
+ *
+ * @param p_self   The current Coroutines struct.
+ * @param p_ast    The AST containing the function.
+ * @param function The function's node.
+ *
+ * @return The kind of coroutine the function is, CORO_NONE if it is not one.
+ */
+enum CoroKinds coroutines_analyse(struct Coroutines* p_self, const struct FlatAST* p_ast,
+								  flat_ast_index_t function);
+
+/**
+ * Emits the start of the last analysed coroutine, right after its 'entry:' label. The function
+ * must return 'i8*', the handle, and have CORO_ATTRIBUTES. Generators suspend straight away, so
+ * they only run once something asks for their first value.
+ *
+ * @param p_self      The current Coroutines struct.
+ * @param p_valueType The LLVM type of the task's result or generator's values, e.g. 'i32', or
+ *                    'void'.
+ * @param p_function  Where to append the IR of the function being generated.
+ * @param p_module    Where to append intrinsic declarations, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_begin(struct Coroutines* p_self, const char* p_valueType,
+						   struct String* p_function, struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits a return from the last analysed coroutine, which completes it.
+ *
+ * @param p_self      The current Coroutines struct.
+ * @param p_valueType The LLVM type of the task's result, or 'void'.
+ * @param p_value     The result, NULL for 'void' tasks and generators.
+ * @param p_function  Where to append the IR of the function being generated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_return(const struct Coroutines* p_self, const char* p_valueType,
+							const char* p_value, struct String* p_function);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits 'yield(value)' in the last analysed generator: the value is stored in the promise, and the
+ * generator suspends until the next value is asked for.
+ *
+ * @param p_self      The current Coroutines struct.
+ * @param p_valueType The LLVM type of the generator's values.
+ * @param p_value     The value.
+ * @param p_function  Where to append the IR of the function being generated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_yield(struct Coroutines* p_self, const char* p_valueType, const char* p_value,
+						   struct String* p_function);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits an '@await' call in the last analysed '@async' function. A task that already completed is
+ * used straight away. Otherwise the caller becomes the task's waiter and suspends, until the task
+ * completes and wakes it. Either way the result is read, and the task destroyed.
+ *
+ * @param p_self      The current Coroutines struct.
+ * @param p_task      The handle returned by the call, an 'i8*'.
+ * @param p_valueType The LLVM type of the task's result, or 'void'.
+ * @param p_result    The name of the result, unused for 'void' tasks.
+ * @param p_function  Where to append the IR of the function being generated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_await(struct Coroutines* p_self, const char* p_task, const char* p_valueType,
+						   const char* p_result, struct String* p_function);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the end of the last analysed coroutine, after its body, which must end with
+ * coroutines_emit_return: completing it (waking its waiter, for tasks), the final suspension, and
+ * freeing the frame once it is destroyed.
+ *
+ * @param p_self     The current Coroutines struct.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+void coroutines_emit_end(const struct Coroutines* p_self, struct String* p_function);
+
+/**
+ * Emits asking a generator for its next value, e.g. each iteration of 'for numbers(10) => n'.
+ *
+ * @param p_self      The current Coroutines struct.
+ * @param p_generator The generator's handle.
+ * @param p_valueType The LLVM type of the generator's values.
+ * @param p_done      The name of the 'i1' set once the generator has returned instead of yielding.
+ * @param p_value     The name of the value, only meaningful while the generator is not done.
+ * @param p_function  Where to append the IR of the function being generated.
+ * @param p_module    Where to append intrinsic declarations, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void coroutines_emit_next(struct Coroutines* p_self, const char* p_generator,
+						  const char* p_valueType, const char* p_done, const char* p_value,
+						  struct String* p_function, struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits destroying a coroutine, e.g. a generator once its loop is left, which frees its frame.
+ *
+ * @param p_self     The current Coroutines struct.
+ * @param p_handle   The coroutine's handle.
+ * @param p_function Where to append the IR of the function being generated.
+ * @param p_module   Where to append intrinsic declarations, at module level.
+ */
+void coroutines_emit_destroy(struct Coroutines* p_self, const char* p_handle,
+							 struct String* p_function, struct String* p_module);
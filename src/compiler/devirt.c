@@ -0,0 +1,231 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./devirt.h"
+#include "../globals.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEVIRT_REASON_LENGTH	256U
+
+// X-Macro to define dispatch names
+static char* const g_DEVIRT_DISPATCH_NAMES_INTERNAL[] = {
+#define DEVIRT_DISPATCH_TO_STRING(name) #name,
+	DEVIRT_DISPATCHES(DEVIRT_DISPATCH_TO_STRING)
+#undef DEVIRT_DISPATCH_TO_STRING
+};
+
+const struct Array g_DEVIRT_DISPATCH_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_DEVIRT_DISPATCH_NAMES_INTERNAL,
+						sizeof(g_DEVIRT_DISPATCH_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* devirt_dispatch_get_name(const enum DevirtDispatches DISPATCH) {
+	if ((size_t)DISPATCH + 1 > g_DEVIRT_DISPATCH_NAMES.length) {
+		PANIC("g_DEVIRT_DISPATCH_NAMES get index out of bounds");
+	}
+
+	return g_DEVIRT_DISPATCH_NAMES._values[DISPATCH];
+}
+
+struct Devirtualizer* devirt_new(const char* p_filePath, struct Interner* p_interner,
+								 struct SymbolTable* p_symbols, struct TypeTable* p_types,
+								 struct Report* p_report) {
+	struct Devirtualizer* lp_self = calloc(1, DEVIRTUALIZER_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Devirtualizer struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->interner = p_interner;
+	lp_self->symbols  = p_symbols;
+	lp_self->types	  = p_types;
+	lp_self->report	  = p_report;
+
+	return lp_self;
+}
+
+void devirt_free(struct Devirtualizer** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->implementations);
+		free((*p_self)->dispatches);
+		free((*p_self)->targets);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Devirtualizer struct has already been freed");
+	}
+}
+
+void devirt_add_implementation(struct Devirtualizer* p_self, intern_id_t trait, type_id_t type) {
+	p_self->implementations =
+		buffer_grow(p_self->implementations, &p_self->implementationCapacity,
+					p_self->implementationCount + 1, DEVIRT_IMPLEMENTATION_SIZE);
+
+	p_self->implementations[p_self->implementationCount].trait = trait;
+	p_self->implementations[p_self->implementationCount].type  = type;
+	p_self->implementationCount++;
+}
+
+/**
+ * Checks whether a named type refers to a trait, i.e. is a trait object.
+ *
+ * @param p_self The current Devirtualizer struct.
+ * @param p_type The type.
+ *
+ * @return Whether the type is a trait object.
+ */
+bool devirt___is_trait(struct Devirtualizer* p_self, const struct Type* p_type) {
+	if (p_type->kind != TYPE_NAMED) {
+		return false;
+	}
+
+	uint32_t binding = symbol_table_resolve(p_self->symbols, p_type->name);
+
+	return binding != SYMBOL_BINDING_NONE
+		   && symbol_table_get(p_self->symbols, binding)->kind == SYMBOL_TRAIT;
+}
+
+/**
+ * Classifies the dispatch of a call on a receiver of some type.
+ *
+ * @param p_self   The current Devirtualizer struct.
+ * @param receiver The receiver's type.
+ * @param params   Tuple of the type parameters declared by the function and its struct.
+ * @param p_target Where to write the concrete receiver type, if there is a single one.
+ * @param p_reason Where to write why the call stays dynamic (DEVIRT_REASON_LENGTH characters).
+ *
+ * @return The dispatch.
+ */
+enum DevirtDispatches devirt___classify(struct Devirtualizer* p_self, type_id_t receiver,
+										type_id_t params, type_id_t* p_target, char* p_reason) {
+	const struct Type* lp_receiver = type_table_get(p_self->types, receiver);
+
+	*p_target = TYPE_ID_NONE;
+
+	switch (lp_receiver->kind) {
+	case TYPE_NONE:
+	case TYPE_VARIABLE:
+		snprintf(p_reason, DEVIRT_REASON_LENGTH, "the receiver's type is not known statically");
+		return DEVIRT_DYNAMIC;
+	case TYPE_PARAMETER: // Only declared ones are instantiated with the receiver's concrete type
+		for (uint32_t index = 0; index < type_table_get(p_self->types, params)->argCount;
+			 index++) {
+			if (type_table_get_args(p_self->types, params)[index] == receiver) {
+				return DEVIRT_INSTANCE;
+			}
+		}
+
+		snprintf(p_reason, DEVIRT_REASON_LENGTH, "the receiver's type '%s' is not declared",
+				 interner_get(p_self->interner, lp_receiver->name));
+		return DEVIRT_DYNAMIC;
+	case TYPE_UNION:
+		for (uint32_t index = 0; index < lp_receiver->argCount; index++) {
+			type_id_t		   member	 = type_table_get_args(p_self->types, receiver)[index];
+			const struct Type* lp_member = type_table_get(p_self->types, member);
+
+			if (lp_member->kind == TYPE_PARAMETER || lp_member->kind == TYPE_VARIABLE
+				|| devirt___is_trait(p_self, lp_member)) {
+				char* lp_type = type_table_to_string(p_self->types, member);
+
+				snprintf(p_reason, DEVIRT_REASON_LENGTH, "union member '%s' is not concrete",
+						 lp_type);
+				free(lp_type);
+
+				return DEVIRT_DYNAMIC;
+			}
+		}
+
+		return DEVIRT_SWITCH;
+	default:
+		break;
+	}
+
+	if (!devirt___is_trait(p_self, lp_receiver)) {
+		*p_target = receiver;
+
+		return DEVIRT_STATIC;
+	}
+
+	size_t implementations = 0;
+
+	for (size_t index = 0; index < p_self->implementationCount; index++) {
+		if (p_self->implementations[index].trait == lp_receiver->name) {
+			*p_target = p_self->implementations[index].type;
+			implementations++;
+		}
+	}
+
+	if (implementations == 1) {
+		return DEVIRT_SOLE;
+	}
+
+	*p_target = TYPE_ID_NONE;
+	snprintf(p_reason, DEVIRT_REASON_LENGTH, "trait '%s' has %zu implementations",
+			 interner_get(p_self->interner, lp_receiver->name), implementations);
+
+	return DEVIRT_DYNAMIC;
+}
+
+void devirt_function(struct Devirtualizer* p_self, const struct FlatAST* p_ast,
+					 const struct Inference* p_inference, type_id_t params, const char* p_name) {
+	size_t nodeCapacity = p_self->nodeCapacity;
+
+	p_self->dispatches = buffer_grow(p_self->dispatches, &p_self->nodeCapacity, p_ast->nodeCount,
+									 sizeof(uint8_t));
+	p_self->targets =
+		buffer_grow(p_self->targets, &nodeCapacity, p_ast->nodeCount, sizeof(type_id_t));
+
+	for (size_t index = 0; index < p_inference->visitedCount; index++) {
+		flat_ast_index_t		  node	  = p_inference->visited[index];
+		const struct FlatASTNode* lp_node = flat_ast_get(p_ast, node);
+
+		p_self->dispatches[node] = DEVIRT_NONE;
+		p_self->targets[node]	 = TYPE_ID_NONE;
+
+		if (lp_node->kind != FLATAST_CALL
+			|| flat_ast_get(p_ast, lp_node->lhs)->kind != FLATAST_MEMBER) {
+			continue;
+		}
+
+		const struct FlatASTNode* lp_member = flat_ast_get(p_ast, lp_node->lhs);
+		type_id_t				  receiver	= inference_get_node_type(p_inference, lp_member->lhs);
+		char					  reason[DEVIRT_REASON_LENGTH];
+		enum DevirtDispatches	  dispatch =
+			devirt___classify(p_self, receiver, params, &p_self->targets[node], reason);
+
+		p_self->dispatches[node] = dispatch;
+		p_self->counts[dispatch]++;
+
+		if (dispatch == DEVIRT_DYNAMIC && report_enabled(p_self->report, REPORT_DEVIRT)) {
+			const struct FlatASTNode* lp_object		= flat_ast_get(p_ast, lp_member->lhs);
+			const char*				  lp_objectName = "<expression>";
+			char					  line[MAX_STRING_LENGTH];
+
+			if (lp_object->kind == FLATAST_VARIABLE) {
+				lp_objectName = flat_ast_get_string(p_ast, lp_object->value.string);
+			}
+
+			snprintf(line, sizeof(line), "%s:%u: '%s.%s()' in %s stays dynamic: %s",
+					 p_self->filePath, lp_node->line + 1, lp_objectName,
+					 flat_ast_get_string(p_ast, lp_member->value.string), p_name, reason);
+			report_add(p_self->report, REPORT_DEVIRT, line);
+		}
+	}
+}
+
+enum DevirtDispatches devirt_get_dispatch(const struct Devirtualizer* p_self,
+										  flat_ast_index_t node) {
+	return node < p_self->nodeCapacity ? (enum DevirtDispatches)p_self->dispatches[node]
+									   : DEVIRT_NONE;
+}
+
+type_id_t devirt_get_target(const struct Devirtualizer* p_self, flat_ast_index_t node) {
+	return node < p_self->nodeCapacity ? p_self->targets[node] : TYPE_ID_NONE;
+}
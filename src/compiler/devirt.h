@@ -0,0 +1,147 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./report.h"
+#include "./symbols.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/array.h"
+#include "../utils/intern.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// X-Macro to define how a method call is dispatched
+#define DEVIRT_DISPATCHES(X)                                                                       \
+	X(NONE)		/* Not a method call */                                                            \
+	X(STATIC)	/* The receiver's type is concrete, the method is called directly */               \
+	X(INSTANCE) /* The receiver's type is a declared type parameter, so monomorphized */           \
+	X(SOLE)		/* The receiver is a trait object, but the trait has a single implementation */    \
+	X(SWITCH)	/* The receiver is a union of concrete types, dispatched on its tag */             \
+	X(DYNAMIC)	/* Dispatched through the receiver's vtable */
+
+/**
+ * Used to identify how a method call is dispatched.
+ */
+enum DevirtDispatches {
+#define DEVIRT_DISPATCH_ENUM_ENTRY(name) DEVIRT_##name,
+	DEVIRT_DISPATCHES(DEVIRT_DISPATCH_ENUM_ENTRY)
+#undef DEVIRT_DISPATCH_ENUM_ENTRY
+};
+
+/**
+ * Contains the names of each of the dispatches.
+ */
+extern const struct Array g_DEVIRT_DISPATCH_NAMES;
+
+/**
+ * Gets the name of a dispatch.
+ *
+ * @param DISPATCH The dispatch.
+ *
+ * @return The name of the dispatch.
+ */
+const char* devirt_dispatch_get_name(
+	const enum DevirtDispatches DISPATCH); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Represents an implementation of a trait by a concrete type.
+ */
+struct DevirtImplementation {
+	intern_id_t trait;
+	type_id_t	type;
+};
+
+#define DEVIRT_IMPLEMENTATION_SIZE sizeof(struct DevirtImplementation)
+
+/**
+ * Represents the devirtualization pass. It runs on the typed AST of a function after inference,
+ * and decides for every method call whether the callee is known statically, so code generation
+ * only emits a vtable call where the receiver's type can really vary at runtime.
+ */
+struct Devirtualizer {
+	const char*					 filePath; // For the report.
+	struct Interner*			 interner;
+	struct SymbolTable*			 symbols;
+	struct TypeTable*			 types;
+	struct Report*				 report;
+	struct DevirtImplementation* implementations;
+	uint8_t*					 dispatches; // enum DevirtDispatches of each node.
+	type_id_t*					 targets;	 // The receiver type of each devirtualized call.
+	size_t implementationCount, implementationCapacity, nodeCapacity;
+	size_t counts[DEVIRT_DYNAMIC + 1]; // Call sites per dispatch, for the time report.
+};
+
+#define DEVIRTUALIZER_STRUCT_SIZE sizeof(struct Devirtualizer)
+
+/**
+ * Creates a new Devirtualizer struct.
+ *
+ * @param p_filePath The path of the module, for the report.
+ * @param p_interner The module's interner.
+ * @param p_symbols  The module's symbol table.
+ * @param p_types    The module's type table.
+ * @param p_report   The requested reports (can be NULL).
+ *
+ * @return The created Devirtualizer struct.
+ */
+struct Devirtualizer* devirt_new(const char* p_filePath, struct Interner* p_interner,
+								 struct SymbolTable* p_symbols, struct TypeTable* p_types,
+								 struct Report* p_report);
+
+/**
+ * Frees a Devirtualizer struct.
+ *
+ * @param p_self The current Devirtualizer struct.
+ */
+void devirt_free(struct Devirtualizer** p_self);
+
+/**
+ * Records that a concrete type implements a trait. Implementations of every module of the program
+ * must be added before any function is devirtualized.
+ *
+ * @param p_self The current Devirtualizer struct.
+ * @param trait  The interned name of the trait.
+ * @param type   The implementing type.
+ */
+void devirt_add_implementation(struct Devirtualizer* p_self, intern_id_t trait, type_id_t type);
+
+/**
+ * Decides how each method call of the last inferred function is dispatched. Calls that stay
+ * dynamic are added to the devirt report.
+ *
+ * @param p_self      The current Devirtualizer struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param params      Tuple of the type parameters declared by the function and its struct, e.g.
+ *                    'T' of 'process<T: Int>'. Calls on receivers of other type parameters, e.g.
+ *                    ones made up by inference for unannotated parameters, stay dynamic.
+ * @param p_name      The function's name, for the report.
+ */
+void devirt_function(struct Devirtualizer* p_self, const struct FlatAST* p_ast,
+					 const struct Inference* p_inference, type_id_t params, const char* p_name);
+
+/**
+ * Gets how a call is dispatched.
+ *
+ * @param p_self The current Devirtualizer struct.
+ * @param node   The call's node.
+ *
+ * @return The dispatch.
+ */
+enum DevirtDispatches devirt_get_dispatch(const struct Devirtualizer* p_self,
+										  flat_ast_index_t node);
+
+/**
+ * Gets the concrete receiver type of a devirtualized call, whose method is called directly.
+ *
+ * @param p_self The current Devirtualizer struct.
+ * @param node   The call's node.
+ *
+ * @return The receiver type, or TYPE_ID_NONE if the call is not devirtualized to a single type.
+ */
+type_id_t devirt_get_target(const struct Devirtualizer* p_self, flat_ast_index_t node);
@@ -0,0 +1,44 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./diagnostics.h"
+#include "../globals.h"
+#include "../utils/conversions.h"
+#include "../utils/str.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+__attribute__((noreturn)) void compiler_error(const char* p_filePath, size_t lineIndex,
+											  const enum ErrorIdentifiers ERROR,
+											  const char*				  p_errorMsg) {
+	FILE*		   lp_filePointer = fopen(p_filePath, "r");
+	struct String* lp_line		  = string_new("\0", true);
+	size_t		   currentIndex	  = 0;
+
+	while (lp_filePointer) {
+		int chr = fgetc(lp_filePointer);
+
+		if (chr == '\n' || chr == EOF) { // EOL (or EOF)
+			if (currentIndex++ == lineIndex || chr == EOF) {
+				break;
+			}
+		} else if (currentIndex == lineIndex) { // If this is the line we want
+			string_append_chr(lp_line, (char)chr);
+		}
+	}
+
+	if (lp_filePointer) {
+		fclose(lp_filePointer);
+	}
+
+	const char* lp_lineNumberString	   = ul_to_string(lineIndex + 1);
+	size_t		lineNumberStringLength = strlen_safe(lp_lineNumberString);
+
+	printf("-%s> %s\n%s | %s\n%s^ ", repeat_chr('-', lineNumberStringLength), p_filePath,
+		   lp_lineNumberString, lp_line->_value, repeat_chr(' ', lineNumberStringLength + 3));
+	printf("%serror[%s]:%s %s\n", gp_F_BRIGHT_RED, error_get(ERROR), gp_S_RESET, p_errorMsg);
+
+	exit(EXIT_FAILURE); // NOLINT(concurrency-mt-unsafe)
+}
@@ -0,0 +1,22 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../errors.h"
+#include <stddef.h>
+
+/**
+ * Prints an error found while compiling (after parsing) and exits.
+ *
+ * @param p_filePath The path of the file containing the error.
+ * @param lineIndex  The index of the line containing the error.
+ * @param ERROR      The error's identifier.
+ * @param p_errorMsg The error message.
+ */
+__attribute__((noreturn)) void
+compiler_error(const char* p_filePath, size_t lineIndex,
+			   const enum ErrorIdentifiers ERROR, // NOLINT(readability-avoid-const-params-in-decls)
+			   const char* p_errorMsg);
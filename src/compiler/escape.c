@@ -0,0 +1,689 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./escape.h"
+#include "../globals.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ESCAPE_SUMMARY_KNOWN	(1U << 31U) // Set in the summary of every analysed function.
+#define ESCAPE_SUMMARY_PARAMS	31U			// Parameters after this one always escape.
+
+// X-Macro to define escape reason explanations
+static char* const g_ESCAPE_REASON_NAMES_INTERNAL[] = {
+#define ESCAPE_REASON_TO_STRING(name, string) string,
+	ESCAPE_REASONS(ESCAPE_REASON_TO_STRING)
+#undef ESCAPE_REASON_TO_STRING
+};
+
+const struct Array g_ESCAPE_REASON_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_ESCAPE_REASON_NAMES_INTERNAL,
+						sizeof(g_ESCAPE_REASON_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* escape_reason_get_name(const enum EscapeReasons REASON) {
+	if ((size_t)REASON + 1 > g_ESCAPE_REASON_NAMES.length) {
+		PANIC("g_ESCAPE_REASON_NAMES get index out of bounds");
+	}
+
+	return g_ESCAPE_REASON_NAMES._values[REASON];
+}
+
+struct EscapeAnalysis* escape_analysis_new(const char* p_filePath, struct Interner* p_interner,
+										   struct TypeTable* p_types, struct Report* p_report) {
+	struct EscapeAnalysis* lp_self = calloc(1, ESCAPEANALYSIS_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc EscapeAnalysis struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->interner = p_interner;
+	lp_self->types	  = p_types;
+	lp_self->report	  = p_report;
+
+	return lp_self;
+}
+
+void escape_analysis_free(struct EscapeAnalysis** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->parents);
+		free((*p_self)->reasons);
+		free((*p_self)->causes);
+		free((*p_self)->loops);
+		free((*p_self)->parameters);
+		free((*p_self)->allocations);
+		free((*p_self)->locals);
+		free((*p_self)->summaries);
+		free((*p_self)->declared);
+		free((*p_self)->sites);
+		free((*p_self)->siteLoops);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("EscapeAnalysis struct has already been freed");
+	}
+}
+
+/**
+ * Finds the root of a node's alias class, halving the path on the way.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The node.
+ *
+ * @return The root of the class.
+ */
+flat_ast_index_t escape___find(struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	while (p_self->parents[node] != node) {
+		p_self->parents[node] = p_self->parents[p_self->parents[node]];
+		node				  = p_self->parents[node];
+	}
+
+	return node;
+}
+
+/**
+ * Merges the alias classes of two nodes. The merged class escapes if either of them did, holds a
+ * parameter if either of them does, and is as outer as the outermost of them.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param lhs    The first node (can be FLATAST_INDEX_NONE).
+ * @param rhs    The second node (can be FLATAST_INDEX_NONE).
+ */
+void escape___union(struct EscapeAnalysis* p_self, flat_ast_index_t lhs, flat_ast_index_t rhs) {
+	if (lhs == FLATAST_INDEX_NONE || rhs == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	flat_ast_index_t lhsRoot = escape___find(p_self, lhs);
+	flat_ast_index_t rhsRoot = escape___find(p_self, rhs);
+
+	if (lhsRoot == rhsRoot) {
+		return;
+	}
+
+	if (p_self->reasons[rhsRoot] == ESCAPE_NONE) {
+		p_self->reasons[rhsRoot] = p_self->reasons[lhsRoot];
+		p_self->causes[rhsRoot]	 = p_self->causes[lhsRoot];
+	}
+
+	if (p_self->loops[lhsRoot] < p_self->loops[rhsRoot]) {
+		p_self->loops[rhsRoot] = p_self->loops[lhsRoot];
+	}
+
+	p_self->parameters[rhsRoot] |= p_self->parameters[lhsRoot];
+	p_self->parents[lhsRoot] = rhsRoot;
+}
+
+/**
+ * Marks a node's alias class as escaping, unless it already escapes.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The node (can be FLATAST_INDEX_NONE).
+ * @param REASON Why it escapes.
+ * @param cause  The node it escapes at.
+ */
+void escape___escape(struct EscapeAnalysis* p_self, flat_ast_index_t node,
+					 const enum EscapeReasons REASON, flat_ast_index_t cause) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	flat_ast_index_t root = escape___find(p_self, node);
+
+	if (p_self->reasons[root] == ESCAPE_NONE) {
+		p_self->reasons[root] = (uint8_t)REASON;
+		p_self->causes[root]  = cause;
+	}
+}
+
+/**
+ * Resets the alias classes of a node and of its children.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The node.
+ */
+void escape___reset(struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	p_self->parents[node]	 = node;
+	p_self->reasons[node]	 = ESCAPE_NONE;
+	p_self->causes[node]	 = FLATAST_INDEX_NONE;
+	p_self->loops[node]		 = UINT32_MAX; // Only locals and literals are allocated in a loop
+	p_self->parameters[node] = false;
+
+	escape___reset(p_self, lp_node->lhs);
+	escape___reset(p_self, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_TYPE:
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_FOR:
+	case FLATAST_FUNCTION:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			escape___reset(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Gets the node standing for a local of the current function.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   A node holding the local's name.
+ * @param create Whether to declare the local (standing for it with this node) if it is new.
+ *
+ * @return The node standing for the local, or FLATAST_INDEX_NONE if it is not a local.
+ */
+flat_ast_index_t escape___local(struct EscapeAnalysis* p_self, flat_ast_index_t node, bool create) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	const char*				  lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+	intern_id_t				  name	  = interner_intern(p_self->interner, lp_name);
+
+	p_self->locals = buffer_grow(p_self->locals, &p_self->localCapacity, (size_t)name + 1,
+								 sizeof(uint32_t));
+
+	if (!p_self->locals[name] && create) {
+		p_self->declared = buffer_grow(p_self->declared, &p_self->declaredCapacity,
+									   p_self->declaredCount + 1, sizeof(intern_id_t));
+		p_self->declared[p_self->declaredCount++] = name;
+		p_self->locals[name]					  = node + 1;
+		p_self->loops[node]						  = p_self->depth;
+	}
+
+	return p_self->locals[name] ? p_self->locals[name] - 1 : FLATAST_INDEX_NONE;
+}
+
+/**
+ * Gets the summary of a callee, i.e. which of its parameters escape.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param callee The callee's node.
+ *
+ * @return The summary, 0 if the callee has not been analysed.
+ */
+uint32_t escape___summary(const struct EscapeAnalysis* p_self, flat_ast_index_t callee) {
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, callee);
+	intern_id_t				  name		= INTERN_ID_NONE;
+
+	if (lp_callee->kind == FLATAST_VARIABLE) {
+		name = interner_find(p_self->interner,
+							 flat_ast_get_string(p_self->ast, lp_callee->value.string));
+	} else if (lp_callee->kind == FLATAST_MEMBER) { // Methods are named after their type
+		type_id_t		   receiver	   = inference_get_node_type(p_self->inference, lp_callee->lhs);
+		const struct Type* lp_receiver = type_table_get(p_self->types, receiver);
+
+		if (lp_receiver->kind != TYPE_NAMED) {
+			return 0;
+		}
+
+		char* lp_symbol =
+			CONCATENATE_STRING(interner_get(p_self->interner, lp_receiver->name), ".",
+							   flat_ast_get_string(p_self->ast, lp_callee->value.string));
+
+		name = interner_find(p_self->interner, lp_symbol);
+		free(lp_symbol);
+	}
+
+	return name != INTERN_ID_NONE && name < p_self->summaryCapacity ? p_self->summaries[name] : 0;
+}
+
+flat_ast_index_t escape___value(struct EscapeAnalysis* p_self, flat_ast_index_t node);
+
+/**
+ * Walks a call. Arguments escape unless the callee is known not to keep them.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The call's node.
+ */
+void escape___call(struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+	uint32_t				  summary	= escape___summary(p_self, lp_node->lhs);
+	uint32_t				  param		= 0;
+
+	if (lp_callee->kind == FLATAST_MEMBER) { // The receiver is the first parameter
+		flat_ast_index_t receiver = escape___value(p_self, lp_callee->lhs);
+
+		if (!(summary & ESCAPE_SUMMARY_KNOWN) || (summary & 1U)) {
+			escape___escape(p_self, receiver, ESCAPE_PASSED, node);
+		}
+
+		param++;
+	} else if (lp_callee->kind != FLATAST_VARIABLE) {
+		escape___value(p_self, lp_node->lhs);
+	}
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++, param++) {
+		flat_ast_index_t arg =
+			escape___value(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+
+		if (!(summary & ESCAPE_SUMMARY_KNOWN) || param >= ESCAPE_SUMMARY_PARAMS
+			|| (summary & (1U << param))) {
+			escape___escape(p_self, arg, ESCAPE_PASSED, node);
+		}
+	}
+}
+
+/**
+ * Walks an assignment, merging the target with the assigned value.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The assignment's node.
+ *
+ * @return The node standing for the assigned value.
+ */
+flat_ast_index_t escape___assign(struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, lp_node->lhs);
+	flat_ast_index_t		  value		= escape___value(p_self, lp_node->rhs);
+
+	switch (lp_target->kind) {
+	case FLATAST_VARIABLE:
+	case FLATAST_FIELD: { // Including typed declarations, e.g. 'pair: Pair<i32> = ...'
+		flat_ast_index_t local = escape___local(p_self, lp_node->lhs, true);
+
+		if (p_self->closures > 0) { // Writing a local of the enclosing function
+			escape___escape(p_self, local, ESCAPE_CAPTURED, node);
+		}
+
+		escape___union(p_self, local, value);
+		break;
+	}
+	case FLATAST_MEMBER: { // 'object.field = value' lives as long as the object
+		flat_ast_index_t object = escape___value(p_self, lp_target->lhs);
+
+		// Objects reached through a parameter or a global are owned by someone else
+		if (object == FLATAST_INDEX_NONE || p_self->parameters[escape___find(p_self, object)]) {
+			escape___escape(p_self, value, ESCAPE_STORED, node);
+		} else {
+			escape___union(p_self, object, value);
+		}
+		break;
+	}
+	default:
+		escape___value(p_self, lp_node->lhs);
+		escape___escape(p_self, value, ESCAPE_STORED, node);
+		break;
+	}
+
+	return value;
+}
+
+/**
+ * Walks the items of a node's list.
+ *
+ * @param p_self    The current EscapeAnalysis struct.
+ * @param node      The node.
+ * @param container Whether the node contains its items, merging them with it.
+ */
+void escape___list(struct EscapeAnalysis* p_self, flat_ast_index_t node, bool container) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t item =
+			escape___value(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+
+		if (container) {
+			escape___union(p_self, node, item);
+		}
+	}
+}
+
+/**
+ * Binds the variables of a pattern of a match to the value matched against it.
+ *
+ * @param p_self  The current EscapeAnalysis struct.
+ * @param pattern The pattern's node.
+ * @param value   The local the value belongs to, FLATAST_INDEX_NONE if it is not a local.
+ */
+void escape___bind(struct EscapeAnalysis* p_self, flat_ast_index_t pattern,
+				   flat_ast_index_t value) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+
+	if (lp_pattern->kind == FLATAST_VARIABLE
+		&& strcmp(flat_ast_get_string(p_self->ast, lp_pattern->value.string), "_") != 0) {
+		escape___union(p_self, escape___local(p_self, pattern, true), value);
+	} else if (lp_pattern->kind == FLATAST_STRUCT_LITERAL) {
+		for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+			flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_pattern, index);
+
+			escape___bind(p_self, flat_ast_get(p_self->ast, field)->lhs, value);
+		}
+	}
+}
+
+/**
+ * Walks a node of the current function.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The node.
+ *
+ * @return The node standing for the node's value if it may be a pointer to a tracked value (a
+ *         literal, a local, or something reached through one), FLATAST_INDEX_NONE otherwise.
+ */
+flat_ast_index_t escape___value(struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return FLATAST_INDEX_NONE;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_VARIABLE: {
+		flat_ast_index_t local = escape___local(p_self, node, false);
+
+		if (p_self->closures > 0) {
+			escape___escape(p_self, local, ESCAPE_CAPTURED, node);
+		}
+
+		return local;
+	}
+	case FLATAST_UNARY:
+		escape___value(p_self, lp_node->lhs);
+		break;
+	case FLATAST_BINARY:
+		if (lp_node->operation != LEXERTOKENS_SCOPE_RESOLUTION) {
+			escape___value(p_self, lp_node->lhs);
+			escape___value(p_self, lp_node->rhs);
+		}
+		break;
+	case FLATAST_ASSIGNMENT:
+		return escape___assign(p_self, node);
+	case FLATAST_MEMBER: // What is read from a value lives as long as the value
+	case FLATAST_FIELD:
+		return escape___value(p_self, lp_node->lhs);
+	case FLATAST_CALL:
+		escape___call(p_self, node);
+		break;
+	case FLATAST_STRUCT_LITERAL: {
+		size_t capacity = p_self->siteCapacity;
+
+		p_self->sites	  = buffer_grow(p_self->sites, &p_self->siteCapacity, p_self->siteCount + 1,
+										sizeof(flat_ast_index_t));
+		p_self->siteLoops = buffer_grow(p_self->siteLoops, &capacity, p_self->siteCount + 1,
+										sizeof(uint32_t));
+		p_self->sites[p_self->siteCount]	 = node;
+		p_self->siteLoops[p_self->siteCount] = p_self->depth;
+		p_self->siteCount++;
+		p_self->loops[node] = p_self->depth;
+
+		escape___list(p_self, node, true);
+
+		return node;
+	}
+	case FLATAST_ARRAY_LITERAL:
+		p_self->loops[node] = p_self->depth;
+		escape___list(p_self, node, true);
+
+		return node;
+	case FLATAST_BLOCK:
+		escape___list(p_self, node, false);
+		break;
+	case FLATAST_IF:
+		escape___value(p_self, lp_node->lhs);
+		escape___value(p_self, lp_node->rhs);
+		escape___list(p_self, node, false);
+		break;
+	case FLATAST_WHILE:
+		p_self->depth++; // The condition runs every iteration too
+		escape___value(p_self, lp_node->lhs);
+		escape___value(p_self, lp_node->rhs);
+		p_self->depth--;
+		break;
+	case FLATAST_FOR: { // The bindings are elements of the iterable
+		flat_ast_index_t iterable = escape___value(p_self, lp_node->lhs);
+
+		p_self->depth++;
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			flat_ast_index_t binding = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+			escape___union(p_self, escape___local(p_self, binding, true), iterable);
+		}
+
+		escape___value(p_self, lp_node->rhs);
+		p_self->depth--;
+		break;
+	}
+	case FLATAST_MATCH: { // The bindings of the patterns are parts of the scrutinee
+		flat_ast_index_t scrutinee = escape___value(p_self, lp_node->lhs);
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			const struct FlatASTNode* lp_case =
+				flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_node, index));
+
+			escape___bind(p_self, lp_case->lhs, scrutinee);
+			escape___value(p_self, lp_case->rhs);
+		}
+		break;
+	}
+	case FLATAST_RETURN:
+		escape___escape(p_self, escape___value(p_self, lp_node->lhs), ESCAPE_RETURNED, node);
+		break;
+	case FLATAST_PARAMETER:
+		p_self->parameters[escape___local(p_self, node, true)] = true;
+		break;
+	case FLATAST_FUNCTION: // Nested function, anything of ours it touches escapes
+		p_self->closures++;
+		escape___value(p_self, lp_node->rhs);
+		p_self->closures--;
+		break;
+	default: // Literals and types
+		break;
+	}
+
+	return FLATAST_INDEX_NONE;
+}
+
+/**
+ * Gets the name of a struct literal's type, for the report.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The struct literal's node.
+ *
+ * @return The name of the type.
+ */
+const char* escape___type_name(const struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_type =
+		flat_ast_get(p_self->ast, flat_ast_get(p_self->ast, node)->lhs);
+
+	if (lp_type->kind == FLATAST_TYPE) {
+		lp_type = flat_ast_get(p_self->ast, lp_type->lhs);
+	}
+
+	if (lp_type->kind != FLATAST_VARIABLE) {
+		return "<struct>";
+	}
+
+	return flat_ast_get_string(p_self->ast, lp_type->value.string);
+}
+
+/**
+ * Adds a heap allocated struct literal to the escape report.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The struct literal's node.
+ * @param p_name The name of the function containing it.
+ */
+void escape___report(struct EscapeAnalysis* p_self, flat_ast_index_t node, const char* p_name) {
+	flat_ast_index_t		  root		= escape___find(p_self, node);
+	const struct FlatASTNode* lp_cause	= flat_ast_get(p_self->ast, p_self->causes[root]);
+	const char*				  lp_reason = escape_reason_get_name(p_self->reasons[root]);
+	const char*				  lp_object = "";
+	const char*				  lp_callee = "";
+	char					  detail[256];
+	char					  line[MAX_STRING_LENGTH];
+
+	if (lp_cause->kind == FLATAST_CALL) { // Name the callee, e.g. 'items.append'
+		const struct FlatASTNode* lp_function = flat_ast_get(p_self->ast, lp_cause->lhs);
+
+		if (lp_function->kind == FLATAST_MEMBER) {
+			const struct FlatASTNode* lp_receiver = flat_ast_get(p_self->ast, lp_function->lhs);
+
+			lp_object = lp_receiver->kind == FLATAST_VARIABLE
+							? flat_ast_get_string(p_self->ast, lp_receiver->value.string)
+							: "<expression>";
+		}
+
+		if (lp_function->kind == FLATAST_MEMBER || lp_function->kind == FLATAST_VARIABLE) {
+			lp_callee = flat_ast_get_string(p_self->ast, lp_function->value.string);
+		}
+	}
+
+	if (*lp_callee) {
+		snprintf(detail, sizeof(detail), "'%.100s%s%.100s' at line %u", lp_object,
+				 *lp_object ? "." : "", lp_callee, lp_cause->line + 1);
+	} else {
+		snprintf(detail, sizeof(detail), "at line %u", lp_cause->line + 1);
+	}
+
+	snprintf(line, sizeof(line), "%.200s:%u: '%.100s' literal in %.100s is heap allocated: %s (%s)",
+			 p_self->filePath, flat_ast_get(p_self->ast, node)->line + 1,
+			 escape___type_name(p_self, node), p_name, lp_reason, detail);
+	report_add(p_self->report, REPORT_ESCAPE, line);
+}
+
+void escape_function(struct EscapeAnalysis* p_self, const struct FlatAST* p_ast,
+					 const struct Inference* p_inference, flat_ast_index_t function,
+					 const char* p_name) {
+	const struct FlatASTNode* lp_function = flat_ast_get(p_ast, function);
+	size_t					  capacity	  = p_self->nodeCapacity;
+
+	p_self->parents = buffer_grow(p_self->parents, &capacity, p_ast->nodeCount, sizeof(uint32_t));
+	capacity = p_self->nodeCapacity;
+	p_self->reasons = buffer_grow(p_self->reasons, &capacity, p_ast->nodeCount, sizeof(uint8_t));
+	capacity = p_self->nodeCapacity;
+	p_self->causes =
+		buffer_grow(p_self->causes, &capacity, p_ast->nodeCount, sizeof(flat_ast_index_t));
+	capacity	 = p_self->nodeCapacity;
+	p_self->loops = buffer_grow(p_self->loops, &capacity, p_ast->nodeCount, sizeof(uint32_t));
+	capacity	 = p_self->nodeCapacity;
+	p_self->parameters =
+		buffer_grow(p_self->parameters, &capacity, p_ast->nodeCount, sizeof(uint8_t));
+	p_self->allocations = buffer_grow(p_self->allocations, &p_self->nodeCapacity, p_ast->nodeCount,
+									  sizeof(uint8_t));
+
+	p_self->ast		  = p_ast;
+	p_self->inference = p_inference;
+	p_self->closures  = 0;
+	p_self->depth	  = 0;
+	p_self->siteCount = 0;
+
+	for (size_t index = 0; index < p_self->declaredCount; index++) {
+		p_self->locals[p_self->declared[index]] = 0;
+	}
+
+	p_self->declaredCount = 0;
+
+	escape___reset(p_self, function);
+	escape___list(p_self, function, false); // Parameters
+	escape___value(p_self, lp_function->rhs);
+
+	// Summarise which parameters escape, for the callers analysed after this function
+	uint32_t summary = ESCAPE_SUMMARY_KNOWN;
+
+	for (size_t index = 0; index < lp_function->value.list.length && index < ESCAPE_SUMMARY_PARAMS;
+		 index++) {
+		flat_ast_index_t param =
+			escape___local(p_self, flat_ast_get_list_item(p_ast, lp_function, index), false);
+
+		if (p_self->reasons[escape___find(p_self, param)] != ESCAPE_NONE) {
+			summary |= 1U << index;
+		}
+	}
+
+	intern_id_t name = interner_intern(p_self->interner, p_name);
+
+	p_self->summaries = buffer_grow(p_self->summaries, &p_self->summaryCapacity, (size_t)name + 1,
+									sizeof(uint32_t));
+	p_self->summaries[name] = summary;
+
+	for (size_t index = 0; index < p_self->siteCount; index++) {
+		flat_ast_index_t site = p_self->sites[index];
+		flat_ast_index_t root = escape___find(p_self, site);
+
+		// Its 'alloca' would be overwritten by the next iteration while still in use
+		if (p_self->loops[root] < p_self->siteLoops[index]) {
+			escape___escape(p_self, root, ESCAPE_ITERATION, site);
+		}
+
+		p_self->allocations[site] = p_self->reasons[root];
+
+		if (p_self->allocations[site] == ESCAPE_NONE) {
+			p_self->stack++;
+		} else {
+			p_self->heap++;
+
+			if (report_enabled(p_self->report, REPORT_ESCAPE)) {
+				escape___report(p_self, site, p_name);
+			}
+		}
+	}
+}
+
+enum EscapeReasons escape_get_reason(const struct EscapeAnalysis* p_self, flat_ast_index_t node) {
+	return node < p_self->nodeCapacity ? (enum EscapeReasons)p_self->allocations[node]
+									   : ESCAPE_UNKNOWN;
+}
+
+void escape_emit_allocation(struct EscapeAnalysis* p_self, flat_ast_index_t node,
+							const char* p_llvmType, const char* p_result, struct String* p_entry,
+							struct String* p_output) {
+	if (escape_get_reason(p_self, node) == ESCAPE_NONE) {
+		// %p = alloca T (in the entry block, where SROA and mem2reg look for it)
+		string_append_str(p_entry, "  ");
+		string_append_str(p_entry, p_result);
+		string_append_str(p_entry, " = alloca ");
+		string_append_str(p_entry, p_llvmType);
+		string_append_chr(p_entry, '\n');
+
+		return;
+	}
+
+	p_self->allocated = true;
+
+	// %p.raw = call noalias i8* @malloc(i64 ptrtoint (T* getelementptr (T, T* null, i32 1) to i64))
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".raw = call noalias i8* " ESCAPE_ALLOCATOR "(i64 ptrtoint (");
+	string_append_str(p_output, p_llvmType);
+	string_append_str(p_output, "* getelementptr (");
+	string_append_str(p_output, p_llvmType);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_llvmType);
+	string_append_str(p_output, "* null, i32 1) to i64))\n");
+
+	// %p = bitcast i8* %p.raw to T*
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = bitcast i8* ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".raw to ");
+	string_append_str(p_output, p_llvmType);
+	string_append_str(p_output, "*\n");
+}
+
+void escape_emit_declarations(const struct EscapeAnalysis* p_self, struct String* p_module) {
+	if (p_self->allocated) {
+		string_append_str(p_module, "declare noalias i8* " ESCAPE_ALLOCATOR "(i64)\n");
+	}
+}
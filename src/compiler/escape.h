@@ -0,0 +1,163 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./report.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ESCAPE_ALLOCATOR "@malloc" // The runtime allocator escaping values are allocated with.
+
+// X-Macro to define why a value escapes the function allocating it, and how it is explained
+#define ESCAPE_REASONS(X)                                                                          \
+	X(UNKNOWN, "its function has not been analysed")                                               \
+	X(NONE, "it does not escape")                                                                  \
+	X(RETURNED, "it is returned")                                                                  \
+	X(PASSED, "it is passed to a function that may keep it")                                       \
+	X(STORED, "it is stored where it can outlive the function")                                    \
+	X(CAPTURED, "it is captured by a nested function")                                             \
+	X(ITERATION, "it is kept after the loop iteration creating it")
+
+/**
+ * Used to identify why a value escapes.
+ */
+enum EscapeReasons {
+#define ESCAPE_REASON_ENUM_ENTRY(name, string) ESCAPE_##name,
+	ESCAPE_REASONS(ESCAPE_REASON_ENUM_ENTRY)
+#undef ESCAPE_REASON_ENUM_ENTRY
+};
+
+/**
+ * Contains the explanations of each of the escape reasons.
+ */
+extern const struct Array g_ESCAPE_REASON_NAMES;
+
+/**
+ * Gets the explanation of an escape reason.
+ *
+ * @param REASON The escape reason.
+ *
+ * @return The explanation of the escape reason.
+ */
+const char* escape_reason_get_name(
+	const enum EscapeReasons REASON); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Represents the escape analysis pass. It decides for every struct literal of a function whether
+ * the value can outlive the call. Values that cannot are allocated with 'alloca' in the entry
+ * block, which LLVM's SROA then splits into SSA scalars, and only escaping values go through the
+ * runtime allocator.
+ *
+ * The analysis is flow insensitive: locals, literals and the values they contain are merged into
+ * alias classes with a union-find over node indexes, and a class escapes as a whole. Calls only
+ * keep the arguments their callee's summary says escape, so functions analysed first (callees
+ * before callers) give better results. A literal in a loop reuses the same 'alloca' in every
+ * iteration, so it escapes if its class holds something declared outside of the loop.
+ */
+struct EscapeAnalysis {
+	const char*		  filePath; // For the report.
+	struct Interner*  interner;
+	struct TypeTable* types;
+	struct Report*	  report;
+	uint32_t*		  parents;	   // Union-find parent of each node.
+	uint8_t*		  reasons;	   // enum EscapeReasons of each class, by its root node.
+	flat_ast_index_t* causes;	   // The node each class escapes at, by its root node.
+	uint32_t*		  loops;	   // The loop depth of each class' outermost member, by its root.
+	uint8_t*		  parameters;  // Whether each class holds a parameter, by its root node.
+	uint8_t*		  allocations; // enum EscapeReasons of each struct literal.
+	uint32_t*		  locals;	   // Node + 1 standing for each local, by interned name.
+	uint32_t*		  summaries;   // Escaping parameters of each function, by interned name.
+	intern_id_t*	  declared;	   // The locals of the current function, to reset them.
+	flat_ast_index_t* sites;	   // The struct literals of the current function.
+	uint32_t*		  siteLoops;   // The loop depth of each of the struct literals.
+	size_t nodeCapacity, localCapacity, summaryCapacity, declaredCount, declaredCapacity, siteCount,
+		siteCapacity;
+	const struct FlatAST*	ast;		// The AST of the current function.
+	const struct Inference* inference;	// The inference of the current function.
+	size_t					closures;	// Nested functions being walked.
+	uint32_t				depth;		// Loops being walked.
+	bool					allocated;	// Whether the runtime allocator has been called.
+	size_t					stack, heap; // For the time report.
+};
+
+#define ESCAPEANALYSIS_STRUCT_SIZE sizeof(struct EscapeAnalysis)
+
+/**
+ * Creates a new EscapeAnalysis struct.
+ *
+ * @param p_filePath The path of the module, for the report.
+ * @param p_interner The module's interner.
+ * @param p_types    The module's type table.
+ * @param p_report   The requested reports (can be NULL).
+ *
+ * @return The created EscapeAnalysis struct.
+ */
+struct EscapeAnalysis* escape_analysis_new(const char* p_filePath, struct Interner* p_interner,
+										   struct TypeTable* p_types, struct Report* p_report);
+
+/**
+ * Frees an EscapeAnalysis struct.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ */
+void escape_analysis_free(struct EscapeAnalysis** p_self);
+
+/**
+ * Decides where each struct literal of the last inferred function is allocated, and records which
+ * of the function's parameters escape for its callers. Heap allocations are added to the escape
+ * report.
+ *
+ * @param p_self      The current EscapeAnalysis struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param function    The function's node.
+ * @param p_name      The function's name, e.g. 'main' or 'Stack.push'.
+ */
+void escape_function(struct EscapeAnalysis* p_self, const struct FlatAST* p_ast,
+					 const struct Inference* p_inference, flat_ast_index_t function,
+					 const char* p_name);
+
+/**
+ * Gets why a struct literal escapes.
+ *
+ * @param p_self The current EscapeAnalysis struct.
+ * @param node   The struct literal's node.
+ *
+ * @return The reason, ESCAPE_NONE if it can be allocated on the stack, ESCAPE_UNKNOWN if its
+ *         function has not been analysed.
+ */
+enum EscapeReasons escape_get_reason(const struct EscapeAnalysis* p_self, flat_ast_index_t node);
+
+/**
+ * Emits the allocation of a struct literal: an 'alloca' at the end of the entry block if it does
+ * not escape, a call to the runtime allocator otherwise.
+ *
+ * @param p_self     The current EscapeAnalysis struct.
+ * @param node       The struct literal's node.
+ * @param p_llvmType The LLVM type of the struct, e.g. '%"Pair<i32>"'.
+ * @param p_result   The name of the pointer to the struct, e.g. '%my_pair'.
+ * @param p_entry    Where to append the entry block's allocas.
+ * @param p_output   Where to append the IR of the current block.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void escape_emit_allocation(struct EscapeAnalysis* p_self, flat_ast_index_t node,
+							const char* p_llvmType, const char* p_result, struct String* p_entry,
+							struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the declaration of the runtime allocator, if any allocation needed it.
+ *
+ * @param p_self   The current EscapeAnalysis struct.
+ * @param p_module Where to append the declaration, at module level.
+ */
+void escape_emit_declarations(const struct EscapeAnalysis* p_self, struct String* p_module);
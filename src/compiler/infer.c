@@ -0,0 +1,1901 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./infer.h"
+#include "./attributes.h"
+#include "./coro.h"
+#include "./diagnostics.h"
+#include "./loops.h"
+#include "./ownership.h"
+#include "./simd.h"
+#include "../globals.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include "../utils/str.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Declares a function of the runtime in the current scope.
+ *
+ * @param p_self   The current Inference struct.
+ * @param p_name   The function's name, e.g. 'range' or 'Array.append'.
+ * @param p_params The types of the function's parameters.
+ * @param count    The number of parameters.
+ * @param result   The function's return type.
+ */
+void inference___declare_builtin(struct Inference* p_self, const char* p_name,
+								 const type_id_t* p_params, size_t count, type_id_t result) {
+	uint32_t binding = symbol_table_declare(
+		p_self->symbols, interner_intern(p_self->interner, p_name), SYMBOL_FUNCTION, 0);
+
+	symbol_table_get(p_self->symbols, binding)->type =
+		type_table_function(p_self->types, p_params, count, result);
+}
+
+/**
+ * Declares the runtime's functions, and the methods of its 'Array<T>' and 'str'.
+ *
+ * @param p_self The current Inference struct.
+ */
+void inference___declare_builtins(struct Inference* p_self) {
+	type_id_t element = type_table_parameter(p_self->types, interner_intern(p_self->interner, "T"),
+											 TYPE_ID_NONE);
+	type_id_t index	  = type_table_parameter(p_self->types, interner_intern(p_self->interner, "I"),
+											 TYPE_ID_NONE);
+	type_id_t range =
+		type_table_named(p_self->types, interner_intern(p_self->interner, "Range"), &element, 1);
+	type_id_t array =
+		type_table_named(p_self->types, interner_intern(p_self->interner, "Array"), &element, 1);
+	type_id_t void_	 = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	type_id_t string = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_STR);
+
+	inference___declare_builtin(p_self, "range", (type_id_t[]){element, element}, 2, range);
+	inference___declare_builtin(p_self, "Array.append", (type_id_t[]){array, element}, 2, void_);
+	inference___declare_builtin(p_self, "Array.get", (type_id_t[]){array, index}, 2, element);
+	inference___declare_builtin(p_self, "Array.remove", (type_id_t[]){array, index}, 2, void_);
+	inference___declare_builtin(p_self, "Array.length", &array, 1,
+								TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64));
+	inference___declare_builtin(p_self, "Array.clone", &array, 1, array);
+	inference___declare_builtin(p_self, "str.from", &element, 1, string);
+	inference___declare_builtin(p_self, "str.length", &string, 1,
+								TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I64));
+}
+
+struct Inference* inference_new(const char* p_filePath, struct Interner* p_interner,
+								struct SymbolTable* p_symbols, struct TypeTable* p_types,
+								struct Report* p_report) {
+	struct Inference* lp_self = calloc(1, INFERENCE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Inference struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->interner = p_interner;
+	lp_self->symbols  = p_symbols;
+	lp_self->types	  = p_types;
+	lp_self->report	  = p_report;
+
+	inference___declare_builtins(lp_self);
+
+	return lp_self;
+}
+
+void inference_free(struct Inference** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->variables);
+		free((*p_self)->nodeTypes);
+		free((*p_self)->nodeDepths);
+		free((*p_self)->visited);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Inference struct has already been freed");
+	}
+}
+
+type_id_t inference_fresh(struct Inference* p_self, enum InferenceLiterals literal) {
+	p_self->variables = buffer_grow(p_self->variables, &p_self->variableCapacity,
+									p_self->variableCount + 1, INFERENCE_VARIABLE_SIZE);
+
+	uint32_t				  index		  = (uint32_t)p_self->variableCount++;
+	struct InferenceVariable* lp_variable = &p_self->variables[index];
+
+	lp_variable->parent	 = index;
+	lp_variable->rank	 = 0;
+	lp_variable->literal = (uint8_t)literal;
+	lp_variable->binding = TYPE_ID_NONE;
+
+	return type_table_variable(p_self->types, index);
+}
+
+/**
+ * Finds the representative of a variable's class, compressing the path to it.
+ *
+ * @param p_self The current Inference struct.
+ * @param index  The index of the variable.
+ *
+ * @return The index of the representative.
+ */
+uint32_t inference___find_root(struct Inference* p_self, uint32_t index) {
+	uint32_t root = index;
+
+	while (p_self->variables[root].parent != root) {
+		root = p_self->variables[root].parent;
+	}
+
+	while (p_self->variables[index].parent != root) { // Point the whole path at the root
+		uint32_t next = p_self->variables[index].parent;
+
+		p_self->variables[index].parent = root;
+		index							= next;
+	}
+
+	return root;
+}
+
+type_id_t inference_find(struct Inference* p_self, type_id_t type) {
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (lp_type->kind != TYPE_VARIABLE) {
+		return type;
+	}
+
+	uint32_t root = inference___find_root(p_self, lp_type->name);
+
+	if (p_self->variables[root].binding != TYPE_ID_NONE) { // Bindings are never variables
+		return p_self->variables[root].binding;
+	}
+
+	return root == lp_type->name ? type : type_table_variable(p_self->types, root);
+}
+
+/**
+ * Checks whether a variable occurs in a type, which would make binding it an infinite type.
+ *
+ * @param p_self The current Inference struct.
+ * @param root   The representative of the variable's class.
+ * @param type   The type.
+ *
+ * @return Whether the variable occurs in the type.
+ */
+bool inference___occurs(struct Inference* p_self, uint32_t root, type_id_t type) {
+	type = inference_find(p_self, type);
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (!(lp_type->flags & TYPE_FLAG_VARIABLE)) {
+		return false;
+	}
+
+	if (lp_type->kind == TYPE_VARIABLE) {
+		return lp_type->name == root;
+	}
+
+	uint32_t argCount = lp_type->argCount;
+	uint32_t args	  = lp_type->args;
+
+	for (uint32_t index = 0; index < argCount; index++) {
+		if (inference___occurs(p_self, root, p_self->types->args[args + index])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Checks whether a type can be the type of a literal.
+ *
+ * @param p_self  The current Inference struct.
+ * @param literal The kind of literal.
+ * @param type    The type.
+ *
+ * @return Whether the type can be the type of the literal.
+ */
+bool inference___accepts_literal(struct Inference* p_self, enum InferenceLiterals literal,
+								 type_id_t type) {
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	switch (literal) {
+	case INFERENCE_LITERAL_NONE:
+		return true;
+	case INFERENCE_LITERAL_INTEGER: // Integer literals can also initialise floats
+		return lp_type->kind == TYPE_PARAMETER
+			   || (lp_type->kind == TYPE_PRIMITIVE && lp_type->primitive >= TYPE_PRIMITIVE_I8
+				   && lp_type->primitive <= TYPE_PRIMITIVE_F64);
+	case INFERENCE_LITERAL_FLOAT:
+		return lp_type->kind == TYPE_PARAMETER
+			   || (lp_type->kind == TYPE_PRIMITIVE
+				   && (lp_type->primitive == TYPE_PRIMITIVE_F32
+					   || lp_type->primitive == TYPE_PRIMITIVE_F64));
+	default:
+		PANIC("unknown inference literal");
+	}
+}
+
+bool inference_unify(struct Inference* p_self, type_id_t a, type_id_t b) {
+	p_self->unifications++;
+
+	a = inference_find(p_self, a);
+	b = inference_find(p_self, b);
+
+	if (a == b) {
+		return true;
+	}
+
+	struct Type typeA = *type_table_get(p_self->types, a);
+	struct Type typeB = *type_table_get(p_self->types, b);
+
+	if (typeA.kind == TYPE_VARIABLE && typeB.kind == TYPE_VARIABLE) { // Merge the classes
+		struct InferenceVariable* lp_rootA = &p_self->variables[typeA.name];
+		struct InferenceVariable* lp_rootB = &p_self->variables[typeB.name];
+		uint8_t literal = lp_rootA->literal > lp_rootB->literal ? lp_rootA->literal
+																: lp_rootB->literal;
+
+		if (lp_rootA->rank < lp_rootB->rank) {
+			lp_rootA->parent  = typeB.name;
+			lp_rootB->literal = literal;
+		} else {
+			lp_rootB->parent  = typeA.name;
+			lp_rootA->literal = literal;
+			lp_rootA->rank += lp_rootA->rank == lp_rootB->rank;
+		}
+
+		return true;
+	}
+
+	if (typeB.kind == TYPE_VARIABLE) { // Make 'a' the variable, if either is
+		struct Type typeTemp = typeA;
+
+		typeA = typeB;
+		typeB = typeTemp;
+		b	  = a;
+	}
+
+	if (typeA.kind == TYPE_VARIABLE) { // Bind the class
+		struct InferenceVariable* lp_root = &p_self->variables[typeA.name];
+
+		if (!inference___accepts_literal(p_self, lp_root->literal, b)
+			|| inference___occurs(p_self, typeA.name, b)) {
+			return false;
+		}
+
+		lp_root->binding = b;
+
+		return true;
+	}
+
+	if (typeA.kind == TYPE_NAMED && typeB.kind == TYPE_NAMED && typeA.name != typeB.name) {
+		// A struct is accepted where a trait it implements is expected, as a trait object
+		type_id_t trait = inference_implementation(p_self, p_self->ast, b, typeA.name);
+
+		if (trait != TYPE_ID_NONE) {
+			return inference_unify(p_self, a, trait);
+		}
+
+		trait = inference_implementation(p_self, p_self->ast, a, typeB.name);
+
+		return trait != TYPE_ID_NONE && inference_unify(p_self, b, trait);
+	}
+
+	if (typeA.kind != typeB.kind || typeA.primitive != typeB.primitive
+		|| typeA.name != typeB.name || typeA.argCount != typeB.argCount) {
+		return false;
+	}
+
+	for (uint32_t index = 0; index < typeA.argCount; index++) {
+		if (!inference_unify(p_self, p_self->types->args[typeA.args + index],
+							 p_self->types->args[typeB.args + index])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+type_id_t inference_resolve(struct Inference* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE
+		|| !(type_table_get(p_self->types, type)->flags & TYPE_FLAG_VARIABLE)) {
+		return type;
+	}
+
+	type_id_t	found = inference_find(p_self, type);
+	struct Type original = *type_table_get(p_self->types, found);
+
+	if (original.kind == TYPE_VARIABLE) {
+		struct InferenceVariable* lp_root = &p_self->variables[original.name];
+
+		switch (lp_root->literal) { // Unconstrained literals get the default types
+		case INFERENCE_LITERAL_INTEGER:
+			lp_root->binding = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I32);
+			return lp_root->binding;
+		case INFERENCE_LITERAL_FLOAT:
+			lp_root->binding = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_F64);
+			return lp_root->binding;
+		default:
+			return found;
+		}
+	}
+
+	if (!(original.flags & TYPE_FLAG_VARIABLE)) {
+		return found;
+	}
+
+	type_id_t* lp_args = malloc(original.argCount * sizeof(type_id_t));
+
+	if (!lp_args) {
+		PANIC("failed to malloc resolved type arguments");
+	}
+
+	for (uint32_t index = 0; index < original.argCount; index++) {
+		lp_args[index] = inference_resolve(p_self, p_self->types->args[original.args + index]);
+	}
+
+	type_id_t result = type_table_rebuild(p_self->types, found, lp_args);
+
+	free(lp_args);
+
+	return result;
+}
+
+/**
+ * Binds every variable left unconstrained in a type to a new implicit type parameter.
+ *
+ * @param p_self The current Inference struct.
+ * @param type   The resolved type.
+ */
+void inference___generalise(struct Inference* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (!(lp_type->flags & TYPE_FLAG_VARIABLE)) {
+		return;
+	}
+
+	if (lp_type->kind == TYPE_VARIABLE) {
+		uint32_t root = inference___find_root(p_self, lp_type->name);
+
+		if (p_self->variables[root].binding == TYPE_ID_NONE) {
+			char* lp_index = ul_to_string(p_self->generalised++);
+			char* lp_name  = CONCATENATE_STRING("_T", lp_index);
+
+			p_self->variables[root].binding = type_table_parameter(
+				p_self->types, interner_intern(p_self->interner, lp_name), TYPE_ID_NONE);
+
+			free(lp_index);
+			free(lp_name);
+		}
+
+		return;
+	}
+
+	uint32_t argCount = lp_type->argCount;
+	uint32_t args	  = lp_type->args;
+
+	for (uint32_t index = 0; index < argCount; index++) {
+		inference___generalise(p_self, p_self->types->args[args + index]);
+	}
+}
+
+/**
+ * Reports a type error at a node.
+ *
+ * @param p_self     The current Inference struct.
+ * @param node       The node.
+ * @param ERROR      The error's identifier.
+ * @param p_errorMsg The error message.
+ */
+__attribute__((noreturn)) void inference___error(struct Inference* p_self, flat_ast_index_t node,
+												 const enum ErrorIdentifiers ERROR,
+												 const char*				 p_errorMsg) {
+	compiler_error(p_self->filePath, flat_ast_get(p_self->ast, node)->line, ERROR, p_errorMsg);
+}
+
+/**
+ * Constrains the type of a node, reporting a type mismatch if it cannot be satisfied.
+ *
+ * @param p_self   The current Inference struct.
+ * @param node     The node, for diagnostics.
+ * @param expected The expected type.
+ * @param found    The type of the node.
+ */
+void inference___expect(struct Inference* p_self, flat_ast_index_t node, type_id_t expected,
+						type_id_t found) {
+	if (!inference_unify(p_self, expected, found)) {
+		char* lp_expected =
+			type_table_to_string(p_self->types, inference_resolve(p_self, expected));
+		char* lp_found = type_table_to_string(p_self->types, inference_resolve(p_self, found));
+
+		inference___error(p_self, node, C0001,
+						  CONCATENATE_STRING("type mismatch: expected '", lp_expected,
+											 "', found '", lp_found, "'"));
+	}
+}
+
+/**
+ * Gets the interned name stored in a node.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The node.
+ *
+ * @return The interned name.
+ */
+intern_id_t inference___name(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	return interner_intern(p_self->interner,
+						   flat_ast_get_string(p_self->ast, lp_node->value.string));
+}
+
+/**
+ * Converts a SIMD vector annotation to a type, e.g. 'Vec<f32, 8>'. Errors unless the lanes are a
+ * numeric primitive or 'bool', and there are a power of two of them.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The annotation's node.
+ *
+ * @return The vector type.
+ */
+type_id_t inference___vector(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_element =
+		flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_node, 0));
+	const struct FlatASTNode* lp_lanes =
+		flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_node, 1));
+	type_id_t element = TYPE_ID_NONE;
+
+	if (lp_element->kind == FLATAST_VARIABLE) {
+		element = type_table_primitive_by_name(
+			p_self->types, flat_ast_get_string(p_self->ast, lp_element->value.string));
+	}
+
+	if (element < TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL)
+		|| element > TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_F64) || lp_lanes->kind != FLATAST_INTEGER
+		|| lp_lanes->value.integer < 1 || lp_lanes->value.integer > TYPE_VECTOR_MAX_LANES
+		|| (lp_lanes->value.integer & (lp_lanes->value.integer - 1)) != 0) {
+		inference___error(p_self, node, C0009,
+						  "'" TYPE_VECTOR_NAME "' takes a numeric type or 'bool', and a power of "
+						  "two number of lanes up to 64, e.g. '" TYPE_VECTOR_NAME "<f32, 8>'");
+	}
+
+	return type_table_vector(p_self->types, type_table_get(p_self->types, element)->primitive,
+							 (uint32_t)lp_lanes->value.integer);
+}
+
+/**
+ * Converts a type annotation to a type.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The annotation's node (a TYPE, or a VARIABLE for a bare name).
+ *
+ * @return The type.
+ */
+type_id_t inference___annotation(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_nameNode =
+		lp_node->kind == FLATAST_TYPE ? flat_ast_get(p_self->ast, lp_node->lhs) : lp_node;
+	size_t		argCount = lp_node->kind == FLATAST_TYPE ? lp_node->value.list.length : 0;
+	const char* lp_name	 = flat_ast_get_string(p_self->ast, lp_nameNode->value.string);
+
+	if (argCount == 2 && strcmp(lp_name, TYPE_VECTOR_NAME) == 0) {
+		return inference___vector(p_self, node);
+	}
+
+	if (argCount == 0) {
+		type_id_t primitive = type_table_primitive_by_name(p_self->types, lp_name);
+
+		if (primitive != TYPE_ID_NONE) {
+			return primitive;
+		}
+
+		uint32_t binding =
+			symbol_table_resolve(p_self->symbols, interner_intern(p_self->interner, lp_name));
+
+		if (binding != SYMBOL_BINDING_NONE
+			&& symbol_table_get(p_self->symbols, binding)->kind == SYMBOL_TYPE_PARAMETER) {
+			return symbol_table_get(p_self->symbols, binding)->type;
+		}
+	}
+
+	intern_id_t name	= interner_intern(p_self->interner, lp_name);
+	type_id_t*	lp_args = malloc((argCount ? argCount : 1) * sizeof(type_id_t));
+
+	if (!lp_args) {
+		PANIC("failed to malloc annotation type arguments");
+	}
+
+	for (size_t index = 0; index < argCount; index++) {
+		lp_args[index] =
+			inference___annotation(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+	}
+
+	type_id_t type = type_table_named(p_self->types, name, lp_args, argCount);
+
+	free(lp_args);
+
+	return type;
+}
+
+/**
+ * Collects the distinct type parameters mentioned in a type, and in their bounds.
+ *
+ * @param p_self   The current Inference struct.
+ * @param type     The type.
+ * @param p_params Where to collect the type parameters.
+ * @param p_count  The number of type parameters collected so far.
+ * @param capacity The capacity of p_params.
+ */
+void inference___collect_parameters(struct Inference* p_self, type_id_t type, type_id_t* p_params,
+									size_t* p_count, size_t capacity) {
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (!(lp_type->flags & TYPE_FLAG_GENERIC)) {
+		return;
+	}
+
+	if (lp_type->kind == TYPE_PARAMETER) {
+		for (size_t index = 0; index < *p_count; index++) {
+			if (p_params[index] == type) {
+				return;
+			}
+		}
+
+		if (*p_count < capacity) {
+			p_params[(*p_count)++] = type;
+		}
+
+		if (lp_type->argCount == 1) { // e.g. 'MU' of 'T: Geometry<MU>'
+			inference___collect_parameters(p_self, p_self->types->args[lp_type->args], p_params,
+										   p_count, capacity);
+		}
+
+		return;
+	}
+
+	for (uint32_t index = 0; index < lp_type->argCount; index++) {
+		inference___collect_parameters(p_self, p_self->types->args[lp_type->args + index], p_params,
+									   p_count, capacity);
+	}
+}
+
+/**
+ * Instantiates a generic type, replacing each of its type parameters with a new variable.
+ *
+ * @param p_self   The current Inference struct.
+ * @param type     The type.
+ * @param p_params Where to write the tuple of the type parameters replaced (can be NULL).
+ * @param p_args   Where to write the tuple of their variables (can be NULL).
+ *
+ * @return The instantiated type.
+ */
+type_id_t inference___instantiate(struct Inference* p_self, type_id_t type, type_id_t* p_params,
+								  type_id_t* p_args) {
+	if (!(type_table_get(p_self->types, type)->flags & TYPE_FLAG_GENERIC)) {
+		return type;
+	}
+
+	type_id_t params[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	type_id_t args[MAX_STRING_LENGTH / sizeof(type_id_t)];
+	size_t	  count = 0;
+
+	inference___collect_parameters(p_self, type, params, &count,
+								   sizeof(params) / sizeof(type_id_t));
+
+	for (size_t index = 0; index < count; index++) {
+		args[index] = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	}
+
+	type_id_t paramsTuple = type_table_tuple(p_self->types, params, count);
+	type_id_t argsTuple	  = type_table_tuple(p_self->types, args, count);
+
+	if (p_params && p_args) {
+		*p_params = paramsTuple;
+		*p_args	  = argsTuple;
+	}
+
+	return type_table_substitute(p_self->types, type, paramsTuple, argsTuple);
+}
+
+/**
+ * Constrains the type arguments of a generic call by the traits bounding its type parameters, so
+ * those only a bound mentions are inferred too, e.g. 'MU' as 'i32' from 'T: Geometry<MU>' for a
+ * 'Square<i32>'.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The call's node, for diagnostics.
+ * @param params The tuple of the callee's type parameters.
+ * @param args   The tuple of the call's type arguments.
+ */
+void inference___constrain_bounds(struct Inference* p_self, flat_ast_index_t node,
+								  type_id_t params, type_id_t args) {
+	uint32_t count = type_table_get(p_self->types, params)->argCount;
+
+	for (uint32_t index = 0; index < count; index++) {
+		const struct Type* lp_param =
+			type_table_get(p_self->types, type_table_get_args(p_self->types, params)[index]);
+		type_id_t arg = inference_resolve(p_self, type_table_get_args(p_self->types, args)[index]);
+
+		if (lp_param->argCount != 1
+			|| type_table_get(p_self->types, p_self->types->args[lp_param->args])->kind
+				   != TYPE_NAMED
+			|| type_table_get(p_self->types, arg)->kind != TYPE_NAMED) {
+			continue; // Unbounded, bound by primitives, or not known yet
+		}
+
+		inference___expect(
+			p_self, node,
+			type_table_substitute(p_self->types, p_self->types->args[lp_param->args], params, args),
+			arg);
+	}
+}
+
+/**
+ * Records the type of a node, to be resolved once the function has been inferred.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The node.
+ * @param type   The type of the node.
+ */
+void inference___record(struct Inference* p_self, flat_ast_index_t node, type_id_t type) {
+	p_self->visited = buffer_grow(p_self->visited, &p_self->visitedCapacity,
+								  p_self->visitedCount + 1, sizeof(flat_ast_index_t));
+	p_self->nodeTypes[node]					= type;
+	p_self->visited[p_self->visitedCount++] = node;
+}
+
+type_id_t inference___visit(struct Inference* p_self, flat_ast_index_t node);
+
+/**
+ * Visits each node of a node's list.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The node.
+ */
+void inference___visit_list(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		inference___visit(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+	}
+}
+
+/**
+ * Declares a variable in the innermost scope.
+ *
+ * @param p_self The current Inference struct.
+ * @param kind   The kind of the symbol.
+ * @param node   The declaring node (holding the name).
+ * @param type   The type of the variable.
+ */
+void inference___declare(struct Inference* p_self, enum SymbolKinds kind, flat_ast_index_t node,
+						 type_id_t type) {
+	uint32_t binding =
+		symbol_table_declare(p_self->symbols, inference___name(p_self, node), kind, node);
+
+	if (binding == SYMBOL_BINDING_NONE) { // Redeclared in the same scope, e.g. a parameter
+		binding = symbol_table_resolve(p_self->symbols, inference___name(p_self, node));
+		inference___expect(p_self, node, symbol_table_get(p_self->symbols, binding)->type, type);
+	} else {
+		symbol_table_get(p_self->symbols, binding)->type = type;
+	}
+}
+
+/**
+ * Infers the type of an array literal.
+ *
+ * @param p_self  The current Inference struct.
+ * @param node    The literal's node.
+ * @param element The type its elements are expected to have, or TYPE_ID_NONE to infer it from
+ *                them.
+ *
+ * @return The type of the array.
+ */
+type_id_t inference___visit_array(struct Inference* p_self, flat_ast_index_t node,
+								  type_id_t element) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (element == TYPE_ID_NONE) {
+		element = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	}
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t item = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+		inference___expect(p_self, item, element, inference___visit(p_self, item));
+	}
+
+	return type_table_named(p_self->types, interner_intern(p_self->interner, "Array"), &element,
+							1);
+}
+
+/**
+ * Infers the type of an assignment's value. A typed declaration's annotation is the element type
+ * its array literal is expected to have, so structs implementing a trait can be listed as its
+ * trait objects, e.g. 'shapes: Array<Shape> = [rectangle, square]'.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The assignment's node.
+ *
+ * @return The type of the value.
+ */
+type_id_t inference___visit_value(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, lp_node->lhs);
+
+	if (lp_target->kind != FLATAST_FIELD
+		|| flat_ast_get(p_self->ast, lp_node->rhs)->kind != FLATAST_ARRAY_LITERAL) {
+		return inference___visit(p_self, lp_node->rhs);
+	}
+
+	type_id_t	type	= inference___annotation(p_self, lp_target->lhs);
+	struct Type literal = *type_table_get(p_self->types, type);
+	type_id_t	element = TYPE_ID_NONE;
+
+	if (literal.kind == TYPE_NAMED && literal.argCount == 1
+		&& literal.name == interner_intern(p_self->interner, "Array")) {
+		element = type_table_get_args(p_self->types, type)[0];
+	}
+
+	type = inference___visit_array(p_self, lp_node->rhs, element);
+	inference___record(p_self, lp_node->rhs, type);
+
+	return type;
+}
+
+/**
+ * Infers the type of an assignment's target, declaring it if it is a new variable.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The assignment's node.
+ * @param value  The type of the assigned value.
+ */
+void inference___visit_assignment(struct Inference* p_self, flat_ast_index_t node,
+								  type_id_t value) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	flat_ast_index_t		  target	= lp_node->lhs;
+	uint8_t					  operation = lp_node->operation;
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, target);
+
+	switch (lp_target->kind) {
+	case FLATAST_VARIABLE: {
+		uint32_t binding = symbol_table_resolve(p_self->symbols, inference___name(p_self, target));
+
+		if (binding == SYMBOL_BINDING_NONE) {
+			if (operation != LEXERTOKENS_ASSIGNMENT) { // e.g. 'x += 1' on an undeclared 'x'
+				inference___error(
+					p_self, target, C0002,
+					CONCATENATE_STRING("unknown symbol '",
+									   flat_ast_get_string(p_self->ast, lp_target->value.string),
+									   "'"));
+			}
+
+			inference___declare(p_self, SYMBOL_VARIABLE, target, value);
+		} else {
+			inference___expect(p_self, node, inference___visit(p_self, target), value);
+		}
+
+		inference___record(p_self, target, value);
+		break;
+	}
+	case FLATAST_FIELD: { // Typed declaration, e.g. 'sum: T = 0'
+		type_id_t type = inference___annotation(p_self, lp_target->lhs);
+
+		inference___expect(p_self, node, type, value);
+		inference___declare(p_self, SYMBOL_VARIABLE, target, type);
+		inference___record(p_self, target, type);
+		break;
+	}
+	default:
+		inference___expect(p_self, node, inference___visit(p_self, target), value);
+	}
+}
+
+/**
+ * Infers the type of a binary operation.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The operation's node.
+ *
+ * @return The type of the operation.
+ */
+type_id_t inference___visit_binary(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (lp_node->operation == LEXERTOKENS_SCOPE_RESOLUTION) { // e.g. 'cf::range'
+		uint32_t module =
+			symbol_table_resolve(p_self->symbols, inference___name(p_self, lp_node->lhs));
+
+		if (module == SYMBOL_BINDING_NONE
+			|| symbol_table_get(p_self->symbols, module)->kind != SYMBOL_MODULE) {
+			const struct FlatASTNode* lp_module = flat_ast_get(p_self->ast, lp_node->lhs);
+
+			inference___error(p_self, lp_node->lhs, C0002,
+							  CONCATENATE_STRING("unknown module '",
+												 flat_ast_get_string(p_self->ast,
+																	 lp_module->value.string),
+												 "'"));
+		}
+
+		inference___record(p_self, lp_node->lhs, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID));
+
+		// The module's names are declared qualified, e.g. 'io::out', so they never clash
+		const char* lp_module =
+			flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, lp_node->lhs)->value.string);
+		const char* lp_name =
+			flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, lp_node->rhs)->value.string);
+		char*	 lp_qualified = CONCATENATE_STRING(lp_module, "::", lp_name);
+		uint32_t binding =
+			symbol_table_resolve(p_self->symbols, interner_intern(p_self->interner, lp_qualified));
+
+		if (binding == SYMBOL_BINDING_NONE) {
+			inference___error(p_self, lp_node->rhs, C0002,
+							  CONCATENATE_STRING("unknown symbol '", lp_qualified, "'"));
+		}
+
+		free(lp_qualified);
+
+		struct SymbolBinding* lp_binding = symbol_table_get(p_self->symbols, binding);
+
+		if (lp_binding->type == TYPE_ID_NONE) { // Imported, with a signature it cannot be typed by
+			inference___error(p_self, lp_node->rhs, C0014,
+							  CONCATENATE_STRING("uses of '", lp_module, "::", lp_name,
+												 "' are not supported yet, its signature mentions "
+												 "types declared by '",
+												 lp_module, "'"));
+		}
+
+		p_self->nodeDepths[lp_node->rhs] = lp_binding->depth;
+		inference___record(p_self, lp_node->rhs, lp_binding->type);
+
+		return lp_binding->type;
+	}
+
+	type_id_t lhs = inference___visit(p_self, lp_node->lhs);
+	type_id_t rhs = inference___visit(p_self, lp_node->rhs);
+
+	switch (lp_node->operation) {
+	case LEXERTOKENS_EQUAL_TO:
+	case LEXERTOKENS_NOT_EQUAL_TO:
+	case LEXERTOKENS_GREATER_THAN:
+	case LEXERTOKENS_LESS_THAN:
+	case LEXERTOKENS_GREATER_THAN_OR_EQUAL:
+	case LEXERTOKENS_LESS_THAN_OR_EQUAL: {
+		inference___expect(p_self, node, lhs, rhs);
+
+		// Vectors are compared lane by lane, into a mask
+		const struct Type* lp_lhs = type_table_get(p_self->types, inference_find(p_self, lhs));
+
+		return lp_lhs->kind == TYPE_VECTOR
+				   ? type_table_vector(p_self->types, TYPE_PRIMITIVE_BOOL, lp_lhs->name)
+				   : TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL);
+	}
+	case LEXERTOKENS_LOGICAL_AND:
+	case LEXERTOKENS_LOGICAL_OR:
+		inference___expect(p_self, node, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL), lhs);
+		inference___expect(p_self, node, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL), rhs);
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL);
+	case LEXERTOKENS_EXPONENT: // The exponent's type is independent, e.g. 'side ** 2'
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+		return lhs;
+	default:
+		inference___expect(p_self, node, lhs, rhs);
+		return lhs;
+	}
+}
+
+/**
+ * Infers the type of a call.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The call's node.
+ *
+ * @return The type of the call's result.
+ */
+type_id_t inference___visit_call(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+
+	if (lp_callee->kind == FLATAST_VARIABLE
+		&& strcmp(flat_ast_get_string(p_self->ast, lp_callee->value.string), CORO_YIELD_FUNCTION)
+			   == 0) {
+		if (p_self->yieldType == TYPE_ID_NONE || lp_node->value.list.length != 1) {
+			inference___error(p_self, node, C0011,
+							  "'" CORO_YIELD_FUNCTION "' takes one value, and can only be called "
+							  "in '@generator' functions");
+		}
+
+		flat_ast_index_t value = flat_ast_get_list_item(p_self->ast, lp_node, 0);
+
+		inference___expect(p_self, value, p_self->yieldType, inference___visit(p_self, value));
+
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	}
+
+	type_id_t  callee	= inference_resolve(p_self, inference___visit(p_self, lp_node->lhs));
+	size_t	   argCount = lp_node->value.list.length;
+	type_id_t* lp_args	= malloc((argCount ? argCount : 1) * sizeof(type_id_t));
+
+	if (!lp_args) {
+		PANIC("failed to malloc call argument types");
+	}
+
+	for (size_t index = 0; index < argCount; index++) {
+		lp_args[index] =
+			inference___visit(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+	}
+
+	type_id_t result = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	type_id_t params = TYPE_ID_NONE;
+	type_id_t args	 = TYPE_ID_NONE;
+
+	inference___expect(p_self, node, inference___instantiate(p_self, callee, &params, &args),
+					   type_table_function(p_self->types, lp_args, argCount, result));
+
+	if (params != TYPE_ID_NONE) {
+		inference___constrain_bounds(p_self, node, params, args);
+	}
+
+	free(lp_args);
+
+	if (attributes_has(p_self->ast, node, ATTRIBUTE_AWAIT)) { // Awaiting a 'Task<T>' gives a 'T'
+		type_id_t value = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+
+		inference___expect(p_self, node,
+						   type_table_named(p_self->types,
+											interner_intern(p_self->interner, CORO_TASK_TYPE),
+											&value, 1),
+						   result);
+
+		return value;
+	}
+
+	return result;
+}
+
+/**
+ * Declares the type parameters of a struct or trait in a new scope, bound to the type arguments of
+ * one of its instances, e.g. 'T' to 'i32' for 'Stack<i32>'. 'Self' is bound to the instance. The
+ * caller pops the scope.
+ *
+ * @param p_self      The current Inference struct.
+ * @param declaration The struct's or trait's generic type, e.g. 'Stack<T>'.
+ * @param instance    The instance, e.g. 'Stack<i32>'.
+ */
+void inference___bind_parameters(struct Inference* p_self, type_id_t declaration,
+								 type_id_t instance) {
+	uint32_t paramCount = type_table_get(p_self->types, declaration)->argCount;
+	uint32_t argCount	= type_table_get(p_self->types, instance)->argCount;
+
+	symbol_table_push_scope(p_self->symbols);
+
+	for (uint32_t index = 0; index < paramCount && index < argCount; index++) {
+		const struct Type* lp_param =
+			type_table_get(p_self->types, type_table_get_args(p_self->types, declaration)[index]);
+		uint32_t binding = symbol_table_declare(p_self->symbols, lp_param->name,
+												SYMBOL_TYPE_PARAMETER, FLATAST_INDEX_NONE);
+
+		if (binding != SYMBOL_BINDING_NONE) {
+			symbol_table_get(p_self->symbols, binding)->type =
+				type_table_get_args(p_self->types, instance)[index];
+		}
+	}
+
+	uint32_t self = symbol_table_declare(p_self->symbols, interner_intern(p_self->interner, "Self"),
+										 SYMBOL_TYPE_PARAMETER, FLATAST_INDEX_NONE);
+
+	if (self != SYMBOL_BINDING_NONE) {
+		symbol_table_get(p_self->symbols, self)->type = instance;
+	}
+}
+
+/**
+ * Gets the type of a method declared by a trait, without its receiver, e.g. '(T) -> void' for
+ * 'push = func(Self, T)' of 'Container<i32>'.
+ *
+ * @param p_self   The current Inference struct.
+ * @param trait    The trait's binding.
+ * @param receiver The trait's instance.
+ * @param method   The interned name of the method.
+ *
+ * @return The method's type, or TYPE_ID_NONE if the trait does not declare it.
+ */
+type_id_t inference___trait_method(struct Inference* p_self, uint32_t trait, type_id_t receiver,
+								   intern_id_t method) {
+	struct SymbolBinding	  binding  = *symbol_table_get(p_self->symbols, trait);
+	const struct FlatASTNode* lp_trait = flat_ast_get(p_self->ast, binding.declaration);
+
+	for (size_t index = 0; index < lp_trait->value.list.length; index++) {
+		flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_trait, index);
+
+		if (inference___name(p_self, field) != method) {
+			continue;
+		}
+
+		const struct FlatASTNode* lp_function =
+			flat_ast_get(p_self->ast, flat_ast_get(p_self->ast, field)->lhs);
+		size_t	   paramCount = lp_function->value.list.length;
+		type_id_t* lp_params  = malloc((paramCount ? paramCount : 1) * sizeof(type_id_t));
+		size_t	   count	  = 0;
+
+		if (!lp_params) {
+			PANIC("failed to malloc trait method parameter types");
+		}
+
+		inference___bind_parameters(p_self, binding.type, receiver);
+
+		for (size_t param = 0; param < paramCount; param++) { // The first one is 'Self'
+			flat_ast_index_t annotation =
+				flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_function, param))
+					->lhs;
+
+			if (param > 0) {
+				lp_params[count++] = inference___annotation(p_self, annotation);
+			}
+		}
+
+		type_id_t result = lp_function->lhs != FLATAST_INDEX_NONE
+							   ? inference___annotation(p_self, lp_function->lhs)
+							   : TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+		type_id_t type	 = type_table_function(p_self->types, lp_params, count, result);
+
+		symbol_table_pop_scope(p_self->symbols);
+		free(lp_params);
+
+		return type;
+	}
+
+	return TYPE_ID_NONE;
+}
+
+/**
+ * Gets the type of a field of a struct, e.g. 'i32' for 'count' of 'Stack<i32>'.
+ *
+ * @param p_self   The current Inference struct.
+ * @param record   The struct's binding.
+ * @param receiver The struct's instance.
+ * @param field    The interned name of the field.
+ *
+ * @return The field's type, or TYPE_ID_NONE if the struct does not declare it.
+ */
+type_id_t inference___struct_field(struct Inference* p_self, uint32_t record, type_id_t receiver,
+								   intern_id_t field) {
+	struct SymbolBinding	  binding	= *symbol_table_get(p_self->symbols, record);
+	const struct FlatASTNode* lp_record = flat_ast_get(p_self->ast, binding.declaration);
+
+	for (size_t index = 0; index < lp_record->value.list.length; index++) {
+		flat_ast_index_t item = flat_ast_get_list_item(p_self->ast, lp_record, index);
+
+		if (inference___name(p_self, item) == field) {
+			inference___bind_parameters(p_self, binding.type, receiver);
+
+			type_id_t type =
+				inference___annotation(p_self, flat_ast_get(p_self->ast, item)->lhs);
+
+			symbol_table_pop_scope(p_self->symbols);
+
+			return type;
+		}
+	}
+
+	return TYPE_ID_NONE;
+}
+
+/**
+ * Gets the type of a method declared as 'Type.method = func(...)', or by the runtime, with the
+ * declaring struct's type parameters replaced by the receiver's type arguments. A method accessed
+ * through a value is bound to it, so its type lacks the receiver's parameter.
+ *
+ * @param p_self   The current Inference struct.
+ * @param node     The member's node, for diagnostics.
+ * @param record   The struct's binding, or SYMBOL_BINDING_NONE for a type of the runtime.
+ * @param receiver The receiver's type.
+ * @param method   The binding of the method.
+ * @param bound    Whether the method is accessed through a value, rather than its type.
+ *
+ * @return The method's type.
+ */
+type_id_t inference___method(struct Inference* p_self, flat_ast_index_t node, uint32_t record,
+							 type_id_t receiver, uint32_t method, bool bound) {
+	if (symbol_table_get(p_self->symbols, method)->type == TYPE_ID_NONE) { // Not checked yet
+		symbol_table_get(p_self->symbols, method)->type =
+			inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	}
+
+	type_id_t type = inference_resolve(p_self, symbol_table_get(p_self->symbols, method)->type);
+
+	if (record != SYMBOL_BINDING_NONE) {
+		type_id_t declaration = symbol_table_get(p_self->symbols, record)->type;
+		uint32_t  argCount	  = type_table_get(p_self->types, receiver)->argCount;
+
+		if (argCount == type_table_get(p_self->types, declaration)->argCount) {
+			type = type_table_substitute(
+				p_self->types, type,
+				type_table_tuple(p_self->types, type_table_get_args(p_self->types, declaration),
+								 argCount),
+				type_table_tuple(p_self->types, type_table_get_args(p_self->types, receiver),
+								 argCount));
+		}
+	}
+
+	type = inference___instantiate(p_self, type, NULL, NULL);
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (!bound || lp_type->kind != TYPE_FUNCTION) {
+		return type;
+	}
+
+	if (lp_type->argCount < 2) { // Only the return type, e.g. 'Stack.new'
+		const char* lp_name =
+			flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, node)->value.string);
+
+		inference___error(
+			p_self, node, C0001,
+			CONCATENATE_STRING("'", lp_name, "' takes no receiver, call it on its type"));
+	}
+
+	uint32_t   argCount = lp_type->argCount;
+	type_id_t* lp_args	= malloc(argCount * sizeof(type_id_t));
+
+	if (!lp_args) {
+		PANIC("failed to malloc method parameter types");
+	}
+
+	memcpy(lp_args, type_table_get_args(p_self->types, type), argCount * sizeof(type_id_t));
+	inference___expect(p_self, node, lp_args[0], receiver);
+
+	type = type_table_function(p_self->types, lp_args + 1, argCount - 2, lp_args[argCount - 1]);
+
+	free(lp_args);
+
+	return type;
+}
+
+/**
+ * Infers the type of a method of a SIMD vector, e.g. 'Vec<f32, 8>.splat' or 'v.sum'. Masks,
+ * vectors of 'bool', have 'any', 'all' and 'select' instead of the numeric methods.
+ *
+ * @param p_self   The current Inference struct.
+ * @param node     The member's node, for diagnostics.
+ * @param receiver The vector type.
+ * @param member   The method's name.
+ * @param bound    Whether the method is accessed through a value, rather than its type.
+ *
+ * @return The method's type.
+ */
+type_id_t inference___vector_method(struct Inference* p_self, flat_ast_index_t node,
+									type_id_t receiver, intern_id_t member, bool bound) {
+	const struct Type* lp_vector = type_table_get(p_self->types, receiver);
+	const char*		   lp_member = interner_get(p_self->interner, member);
+	bool			   isMask	 = lp_vector->primitive == TYPE_PRIMITIVE_BOOL;
+	type_id_t		   lane		 = TYPE_ID_PRIMITIVE(lp_vector->primitive);
+	type_id_t mask	= type_table_vector(p_self->types, TYPE_PRIMITIVE_BOOL, lp_vector->name);
+	type_id_t index = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	type_id_t array =
+		type_table_named(p_self->types, interner_intern(p_self->interner, "Array"), &lane, 1);
+	type_id_t lanes = type_table_named(p_self->types, interner_intern(p_self->interner, "Array"),
+									   (type_id_t[]){TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_I32)}, 1);
+	type_id_t void_ = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+
+	if (!bound && strcmp(lp_member, "splat") == 0) {
+		return type_table_function(p_self->types, &lane, 1, receiver);
+	}
+
+	if (!bound && !isMask && strcmp(lp_member, "load") == 0) {
+		return type_table_function(p_self->types, (type_id_t[]){array, index}, 2, receiver);
+	}
+
+	if (!bound && !isMask && strcmp(lp_member, "load_masked") == 0) {
+		return type_table_function(p_self->types, (type_id_t[]){array, index, mask}, 3, receiver);
+	}
+
+	if (bound && !isMask && strcmp(lp_member, "store") == 0) {
+		return type_table_function(p_self->types, (type_id_t[]){array, index}, 2, void_);
+	}
+
+	if (bound && !isMask && strcmp(lp_member, "store_masked") == 0) {
+		return type_table_function(p_self->types, (type_id_t[]){array, index, mask}, 3, void_);
+	}
+
+	if (bound && !isMask && strcmp(lp_member, "shuffle") == 0) { // e.g. 'a.shuffle(b, [0, 4])'
+		return type_table_function(p_self->types, (type_id_t[]){receiver, lanes}, 2, receiver);
+	}
+
+	if (bound && isMask && strcmp(lp_member, "select") == 0) { // Between vectors of as many lanes
+		type_id_t selected = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+
+		return type_table_function(p_self->types, (type_id_t[]){selected, selected}, 2, selected);
+	}
+
+	for (uint32_t reduction = 0; bound && reduction <= SIMD_REDUCTION_ALL; reduction++) {
+		const char* lp_name	 = simd_reduction_get_name((enum SimdReductions)reduction);
+		bool		forMasks = reduction >= SIMD_REDUCTION_ANY; // 'any' and 'all'
+
+		if (forMasks == isMask && strcmp(lp_member, lp_name) == 0) {
+			return type_table_function(p_self->types, NULL, 0, lane);
+		}
+	}
+
+	char* lp_type = type_table_to_string(p_self->types, receiver);
+
+	inference___error(p_self, node, C0002,
+					  CONCATENATE_STRING("unknown member '", lp_member, "' of '", lp_type, "'"));
+}
+
+/**
+ * Infers the type of a method of the runtime's string, e.g. 'String.from' or 's.length'.
+ *
+ * @param p_self   The current Inference struct.
+ * @param node     The member's node, for diagnostics.
+ * @param receiver The string type.
+ * @param member   The method's name.
+ * @param bound    Whether the method is accessed through a value, rather than its type.
+ *
+ * @return The method's type.
+ */
+type_id_t inference___string_method(struct Inference* p_self, flat_ast_index_t node,
+									type_id_t receiver, intern_id_t member, bool bound) {
+	const char* lp_member = interner_get(p_self->interner, member);
+
+	if (bound && strcmp(lp_member, OWNERSHIP_CLONE_METHOD) == 0) {
+		return type_table_function(p_self->types, NULL, 0, receiver); // The explicit deep copy
+	}
+
+	char*	 lp_qualified = CONCATENATE_STRING("str.", lp_member);
+	uint32_t method =
+		symbol_table_resolve(p_self->symbols, interner_intern(p_self->interner, lp_qualified));
+
+	free(lp_qualified);
+
+	if (method == SYMBOL_BINDING_NONE) {
+		inference___error(p_self, node, C0002,
+						  CONCATENATE_STRING("unknown member '", lp_member, "' of 'str'"));
+	}
+
+	return inference___method(p_self, node, SYMBOL_BINDING_NONE, receiver, method, bound);
+}
+
+/**
+ * Infers the type of a member: a field of a struct, or a method of a struct, a trait or a type of
+ * the runtime. Members of a receiver whose type is not known yet, e.g. an unbounded type
+ * parameter, are left unconstrained.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The member's node.
+ *
+ * @return The member's type.
+ */
+type_id_t inference___visit_member(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_object = flat_ast_get(p_self->ast, lp_node->lhs);
+	type_id_t	receiver = TYPE_ID_NONE;
+	intern_id_t member	 = inference___name(p_self, node);
+	bool		bound	 = lp_object->kind != FLATAST_TYPE; // e.g. 'Stack<T>.new()'
+
+	if (lp_object->kind == FLATAST_VARIABLE) { // e.g. 'Stack.new()'
+		uint32_t object =
+			symbol_table_resolve(p_self->symbols, inference___name(p_self, lp_node->lhs));
+
+		if (object == SYMBOL_BINDING_NONE) { // A primitive type, e.g. 'String.from(42)'
+			receiver = type_table_primitive_by_name(
+				p_self->types, flat_ast_get_string(p_self->ast, lp_object->value.string));
+			bound	 = receiver == TYPE_ID_NONE;
+		} else {
+			uint32_t kind = symbol_table_get(p_self->symbols, object)->kind;
+
+			bound = kind != SYMBOL_STRUCT && kind != SYMBOL_TRAIT;
+		}
+	}
+
+	if (receiver != TYPE_ID_NONE) {
+		inference___record(p_self, lp_node->lhs, receiver);
+	} else { // An unknown symbol is reported visiting it
+		receiver = inference_resolve(p_self, inference___visit(p_self, lp_node->lhs));
+	}
+
+	const struct Type* lp_receiver = type_table_get(p_self->types, receiver);
+
+	if (lp_receiver->kind == TYPE_PARAMETER && lp_receiver->argCount == 1) { // e.g. 'T: Shape'
+		receiver	= type_table_get_args(p_self->types, receiver)[0];
+		lp_receiver = type_table_get(p_self->types, receiver);
+	}
+
+	if (lp_receiver->kind == TYPE_VECTOR) {
+		return inference___vector_method(p_self, node, receiver, member, bound);
+	}
+
+	if (lp_receiver->kind == TYPE_PRIMITIVE && lp_receiver->primitive == TYPE_PRIMITIVE_STR) {
+		return inference___string_method(p_self, node, receiver, member, bound);
+	}
+
+	if (lp_receiver->kind != TYPE_NAMED) {
+		return inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	}
+
+	const char* lp_typeName = interner_get(p_self->interner, lp_receiver->name);
+	const char* lp_member	= interner_get(p_self->interner, member);
+	uint32_t	record		= symbol_table_resolve(p_self->symbols, lp_receiver->name);
+	uint32_t	kind		= SYMBOL_VARIABLE; // Types of the runtime have no binding, e.g. 'Array'
+	type_id_t	type		= TYPE_ID_NONE;
+
+	if (record != SYMBOL_BINDING_NONE) {
+		kind = symbol_table_get(p_self->symbols, record)->kind;
+	}
+
+	if (kind == SYMBOL_TRAIT) {
+		type = inference___trait_method(p_self, record, receiver, member);
+	} else {
+		char* lp_qualified = CONCATENATE_STRING(lp_typeName, ".", lp_member);
+		uint32_t method =
+			symbol_table_resolve(p_self->symbols, interner_intern(p_self->interner, lp_qualified));
+
+		free(lp_qualified);
+
+		if (kind != SYMBOL_STRUCT) {
+			record = SYMBOL_BINDING_NONE;
+		} else if (bound) {
+			type = inference___struct_field(p_self, record, receiver, member);
+		}
+
+		if (type == TYPE_ID_NONE && method != SYMBOL_BINDING_NONE) {
+			type = inference___method(p_self, node, record, receiver, method, bound);
+		}
+	}
+
+	if (type == TYPE_ID_NONE) {
+		inference___error(
+			p_self, node, C0002,
+			CONCATENATE_STRING("unknown member '", lp_member, "' of '", lp_typeName, "'"));
+	}
+
+	return type;
+}
+
+/**
+ * Infers the type of a for loop, declaring its bindings.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The loop's node.
+ */
+void inference___visit_for(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	flat_ast_index_t source	  = loop_lowering_get_parallel_source(p_self->ast, lp_node->lhs);
+	type_id_t		 iterable = TYPE_ID_NONE;
+
+	if (source != FLATAST_INDEX_NONE) { // '.par()' iterates the elements of its receiver
+		iterable = inference_resolve(p_self, inference___visit(p_self, source));
+		inference___record(p_self, lp_node->lhs, iterable);
+	} else {
+		iterable = inference_resolve(p_self, inference___visit(p_self, lp_node->lhs));
+	}
+
+	const struct Type* lp_iterable = type_table_get(p_self->types, iterable);
+	type_id_t		   element	   = TYPE_ID_NONE;
+
+	if (lp_iterable->kind == TYPE_NAMED && lp_iterable->argCount == 1) { // e.g. 'Array<T>'
+		element = p_self->types->args[lp_iterable->args];
+	} else {
+		element = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+	}
+
+	symbol_table_push_scope(p_self->symbols);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t binding = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+		inference___declare(p_self, SYMBOL_VARIABLE, binding, element);
+		inference___record(p_self, binding, element);
+	}
+
+	inference___visit(p_self, lp_node->rhs);
+
+	symbol_table_pop_scope(p_self->symbols);
+}
+
+/**
+ * Infers the types of the fields of a struct literal, each of which must have the type its struct
+ * declares it with, e.g. 'i64' for 'count = 0' of 'Counter { count: i64 }'.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The struct literal's node.
+ * @param type   The struct's type.
+ */
+void inference___visit_fields(struct Inference* p_self, flat_ast_index_t node, type_id_t type) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct Type*		  lp_type	= type_table_get(p_self->types, type);
+	uint32_t				  record	= SYMBOL_BINDING_NONE;
+	const char*				  lp_record = interner_get(p_self->interner, lp_type->name);
+
+	if (lp_type->kind == TYPE_NAMED) {
+		record = symbol_table_resolve(p_self->symbols, lp_type->name);
+	}
+
+	if (record == SYMBOL_BINDING_NONE
+		|| symbol_table_get(p_self->symbols, record)->kind != SYMBOL_STRUCT) {
+		inference___error(p_self, node, C0002,
+						  CONCATENATE_STRING("unknown struct '", lp_record, "'"));
+	}
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_node, index);
+		type_id_t declared = inference___struct_field(p_self, record, type,
+													  inference___name(p_self, field));
+
+		if (declared == TYPE_ID_NONE) {
+			const char* lp_field =
+				flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, field)->value.string);
+
+			inference___error(p_self, field, C0002,
+							  CONCATENATE_STRING("unknown field '", lp_field, "' of '", lp_record,
+												 "'"));
+		}
+
+		inference___expect(p_self, field, declared, inference___visit(p_self, field));
+	}
+}
+
+/**
+ * Infers the types of a function's parameters, return type and body.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The function's node.
+ *
+ * @return The function's type, with variables not yet resolved.
+ */
+type_id_t inference___visit_function(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node		  = flat_ast_get(p_self->ast, node);
+	type_id_t				  outerReturnType = p_self->returnType;
+	type_id_t				  outerYieldType  = p_self->yieldType;
+	bool					  outerReturned	  = p_self->returned;
+	size_t					  paramCount	  = lp_node->value.list.length;
+	type_id_t* lp_params = malloc((paramCount ? paramCount : 1) * sizeof(type_id_t));
+
+	if (!lp_params) {
+		PANIC("failed to malloc parameter types");
+	}
+
+	type_id_t selfType = p_self->selfType; // Only for the method itself, not nested functions
+
+	p_self->selfType = TYPE_ID_NONE;
+	symbol_table_push_scope(p_self->symbols);
+
+	for (size_t index = 0; index < paramCount; index++) {
+		flat_ast_index_t param		= flat_ast_get_list_item(p_self->ast, lp_node, index);
+		flat_ast_index_t annotation = flat_ast_get(p_self->ast, param)->lhs;
+
+		if (annotation != FLATAST_INDEX_NONE) {
+			lp_params[index] = inference___annotation(p_self, annotation);
+		} else if (index == 0 && selfType != TYPE_ID_NONE) {
+			lp_params[index] = selfType;
+		} else {
+			lp_params[index] = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+		}
+
+		inference___declare(p_self, SYMBOL_PARAMETER, param, lp_params[index]);
+		inference___record(p_self, param, lp_params[index]);
+	}
+
+	p_self->returnType = lp_node->lhs != FLATAST_INDEX_NONE
+							 ? inference___annotation(p_self, lp_node->lhs)
+							 : inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+
+	p_self->returned  = false;
+	p_self->yieldType = TYPE_ID_NONE;
+
+	if (attributes_has(p_self->ast, node, ATTRIBUTE_GENERATOR)) { // Annotated with what it yields
+		p_self->yieldType  = p_self->returnType;
+		p_self->returnType = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	}
+
+	inference___visit(p_self, lp_node->rhs);
+
+	if (!p_self->returned) {
+		inference___expect(p_self, node, p_self->returnType,
+						   TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID));
+	}
+
+	symbol_table_pop_scope(p_self->symbols);
+
+	// Calling a coroutine gives its handle, a 'Task<T>' or a 'Generator<T>'
+	type_id_t returnType = p_self->returnType;
+
+	if (p_self->yieldType != TYPE_ID_NONE) {
+		returnType =
+			type_table_named(p_self->types, interner_intern(p_self->interner, CORO_GENERATOR_TYPE),
+							 &p_self->yieldType, 1);
+	} else if (attributes_has(p_self->ast, node, ATTRIBUTE_ASYNC)) {
+		returnType = type_table_named(
+			p_self->types, interner_intern(p_self->interner, CORO_TASK_TYPE), &returnType, 1);
+	}
+
+	type_id_t type = type_table_function(p_self->types, lp_params, paramCount, returnType);
+
+	free(lp_params);
+	p_self->returnType = outerReturnType;
+	p_self->yieldType  = outerYieldType;
+	p_self->returned   = outerReturned;
+
+	return type;
+}
+
+/**
+ * Infers the types of a pattern of a match, declaring the variables it binds.
+ *
+ * @param p_self   The current Inference struct.
+ * @param pattern  The pattern's node.
+ * @param expected The type of the value matched against the pattern.
+ */
+void inference___visit_pattern(struct Inference* p_self, flat_ast_index_t pattern,
+							   type_id_t expected) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+
+	switch (lp_pattern->kind) {
+	case FLATAST_VARIABLE: // '_' matches anything, other names bind the value
+		if (strcmp(flat_ast_get_string(p_self->ast, lp_pattern->value.string), "_") != 0) {
+			inference___declare(p_self, SYMBOL_VARIABLE, pattern, expected);
+		}
+
+		inference___record(p_self, pattern, expected);
+		break;
+	case FLATAST_STRUCT_LITERAL: // Fields are patterns, whose types come from the declaration
+		inference___expect(p_self, pattern, expected,
+						   inference___annotation(p_self, lp_pattern->lhs));
+		inference___record(p_self, pattern, expected);
+
+		for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+			flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_pattern, index);
+			type_id_t		 type  = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+
+			inference___visit_pattern(p_self, flat_ast_get(p_self->ast, field)->lhs, type);
+			inference___record(p_self, field, type);
+		}
+		break;
+	default: // Constants
+		inference___expect(p_self, pattern, expected, inference___visit(p_self, pattern));
+		break;
+	}
+}
+
+/**
+ * Infers the types of a match's scrutinee, and of each case's pattern and body.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The match's node.
+ */
+void inference___visit_match(struct Inference* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	type_id_t				  scrutinee = inference___visit(p_self, lp_node->lhs);
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t		  item	  = flat_ast_get_list_item(p_self->ast, lp_node, index);
+		const struct FlatASTNode* lp_case = flat_ast_get(p_self->ast, item);
+
+		symbol_table_push_scope(p_self->symbols); // Bindings only live in their case
+
+		inference___visit_pattern(p_self, lp_case->lhs, scrutinee);
+		inference___visit(p_self, lp_case->rhs);
+		inference___record(p_self, item, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID));
+
+		symbol_table_pop_scope(p_self->symbols);
+	}
+}
+
+/**
+ * Infers the type of a node, recording it.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The node.
+ *
+ * @return The node's type.
+ */
+type_id_t inference___visit(struct Inference* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	type_id_t				  type	  = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_VOID);
+
+	switch (lp_node->kind) {
+	case FLATAST_INTEGER:
+		type = inference_fresh(p_self, INFERENCE_LITERAL_INTEGER);
+		break;
+	case FLATAST_FLOAT:
+		type = inference_fresh(p_self, INFERENCE_LITERAL_FLOAT);
+		break;
+	case FLATAST_CHR:
+		type = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_CHR);
+		break;
+	case FLATAST_STRING:
+		type = TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_STR);
+		break;
+	case FLATAST_VARIABLE: {
+		uint32_t binding = symbol_table_resolve(p_self->symbols, inference___name(p_self, node));
+
+		if (binding == SYMBOL_BINDING_NONE) {
+			const char* lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+
+			inference___error(p_self, node, C0002,
+							  CONCATENATE_STRING("unknown symbol '", lp_name, "'"));
+		}
+
+		p_self->nodeDepths[node] = symbol_table_get(p_self->symbols, binding)->depth;
+
+		if (symbol_table_get(p_self->symbols, binding)->type == TYPE_ID_NONE) { // Not checked yet
+			type = inference_fresh(p_self, INFERENCE_LITERAL_NONE);
+			symbol_table_get(p_self->symbols, binding)->type = type;
+		}
+
+		type = symbol_table_get(p_self->symbols, binding)->type;
+		break;
+	}
+	case FLATAST_TYPE:
+		type = inference___annotation(p_self, node);
+		break;
+	case FLATAST_UNARY:
+		type = inference___visit(p_self, lp_node->lhs);
+
+		if (lp_node->operation == LEXERTOKENS_LOGICAL_NOT) {
+			inference___expect(p_self, node, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL), type);
+		}
+		break;
+	case FLATAST_BINARY:
+		type = inference___visit_binary(p_self, node);
+		break;
+	case FLATAST_ASSIGNMENT:
+		inference___visit_assignment(p_self, node, inference___visit_value(p_self, node));
+		break;
+	case FLATAST_MEMBER:
+		type = inference___visit_member(p_self, node);
+		break;
+	case FLATAST_CALL:
+		type = inference___visit_call(p_self, node);
+		break;
+	case FLATAST_STRUCT_LITERAL:
+		type = inference___annotation(p_self, lp_node->lhs);
+		inference___visit_fields(p_self, node, type);
+		break;
+	case FLATAST_ARRAY_LITERAL:
+		type = inference___visit_array(p_self, node, TYPE_ID_NONE);
+		break;
+	case FLATAST_FIELD:
+		type = inference___visit(p_self, lp_node->lhs);
+		break;
+	case FLATAST_BLOCK:
+		symbol_table_push_scope(p_self->symbols);
+		inference___visit_list(p_self, node);
+		symbol_table_pop_scope(p_self->symbols);
+		break;
+	case FLATAST_IF:
+	case FLATAST_WHILE: {
+		flat_ast_index_t condition = lp_node->lhs;
+
+		inference___expect(p_self, condition, TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_BOOL),
+						   inference___visit(p_self, condition));
+		inference___visit(p_self, lp_node->rhs);
+
+		if (lp_node->kind == FLATAST_IF) { // elif / else branches
+			inference___visit_list(p_self, node);
+		}
+		break;
+	}
+	case FLATAST_FOR:
+		inference___visit_for(p_self, node);
+		break;
+	case FLATAST_RETURN:
+		p_self->returned = true;
+		inference___expect(p_self, node, p_self->returnType,
+						   inference___visit(p_self, lp_node->lhs));
+		break;
+	case FLATAST_FUNCTION:
+		type = inference___visit_function(p_self, node);
+		break;
+	case FLATAST_MATCH:
+		inference___visit_match(p_self, node);
+		break;
+	default:
+		PANIC("unsupported flat AST node for inference");
+	}
+
+	inference___record(p_self, node, type);
+
+	return type;
+}
+
+/**
+ * Expects a method of a struct to have the signature the traits the struct implements declare
+ * for it, so parameters left unannotated take the trait's types, e.g. 'value' of
+ * 'IntPrinter.stringify = func(self, value)' for 'stringify = func(Self, Type) -> String'.
+ *
+ * @param p_self   The current Inference struct.
+ * @param function The method's node.
+ * @param selfType The type the method is declared on.
+ * @param type     The method's type, before it is generalised.
+ * @param p_name   The method's name, e.g. 'IntPrinter.stringify'.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void inference___conform(struct Inference* p_self, flat_ast_index_t function, type_id_t selfType,
+						 type_id_t type, const char* p_name) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	const struct Type* lp_self	 = type_table_get(p_self->types, selfType);
+	const char*		   lp_method = strrchr(p_name, '.');
+	uint32_t		   record	 = symbol_table_resolve(p_self->symbols, lp_self->name);
+
+	if (!lp_method || record == SYMBOL_BINDING_NONE
+		|| symbol_table_get(p_self->symbols, record)->kind != SYMBOL_STRUCT) {
+		return;
+	}
+
+	flat_ast_index_t impl =
+		flat_ast_get(p_self->ast, symbol_table_get(p_self->symbols, record)->declaration)->lhs;
+	intern_id_t method = interner_intern(p_self->interner, lp_method + 1);
+
+	if (impl == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_impl = flat_ast_get(p_self->ast, impl);
+
+	for (size_t index = 0; index < lp_impl->value.list.length; index++) { // e.g. 'Stringer<T>'
+		flat_ast_index_t		  item	  = flat_ast_get_list_item(p_self->ast, lp_impl, index);
+		const struct FlatASTNode* lp_item = flat_ast_get(p_self->ast, item);
+		intern_id_t name = inference___name(p_self, lp_item->kind == FLATAST_TYPE ? lp_item->lhs
+																				   : item);
+		uint32_t	trait = symbol_table_resolve(p_self->symbols, name);
+
+		if (trait == SYMBOL_BINDING_NONE
+			|| symbol_table_get(p_self->symbols, trait)->kind != SYMBOL_TRAIT) {
+			continue;
+		}
+
+		type_id_t declared = inference___trait_method(
+			p_self, trait, inference_implementation(p_self, p_self->ast, selfType, name), method);
+
+		if (declared == TYPE_ID_NONE) {
+			continue;
+		}
+
+		// The trait's signature leaves out the receiver
+		uint32_t argCount = type_table_get(p_self->types, declared)->argCount;
+
+		if (type_table_get(p_self->types, type)->argCount != argCount + 1) {
+			continue; // Reported calling it through the trait
+		}
+
+		for (uint32_t arg = 0; arg < argCount; arg++) {
+			inference___expect(p_self, function,
+							   type_table_get_args(p_self->types, declared)[arg],
+							   type_table_get_args(p_self->types, type)[arg + 1]);
+		}
+	}
+}
+
+type_id_t inference_infer_function(struct Inference* p_self, const struct FlatAST* p_ast,
+								   flat_ast_index_t function, type_id_t selfType,
+								   const char* p_name) {
+	uint64_t startTime	   = report_clock();
+	size_t	 firstVariable = p_self->variableCount;
+
+	p_self->ast			 = p_ast;
+	p_self->visitedCount = 0;
+	p_self->unifications = 0;
+	p_self->generalised	 = 0;
+	p_self->returnType	 = TYPE_ID_NONE;
+	p_self->yieldType	 = TYPE_ID_NONE;
+	p_self->selfType	 = selfType;
+	p_self->nodeTypes	 = buffer_grow(p_self->nodeTypes, &p_self->nodeTypeCapacity,
+									   p_ast->nodeCount, sizeof(type_id_t));
+	p_self->nodeDepths	 = buffer_grow(p_self->nodeDepths, &p_self->nodeDepthCapacity,
+									   p_ast->nodeCount, sizeof(uint32_t));
+
+	type_id_t type = inference_resolve(p_self, inference___visit(p_self, function));
+
+	if (selfType != TYPE_ID_NONE) {
+		inference___conform(p_self, function, selfType, type, p_name);
+		type = inference_resolve(p_self, type);
+	}
+
+	// Only the signature is generalised: what the body leaves unconstrained stays unknown
+	inference___generalise(p_self, type);
+	type = inference_resolve(p_self, type);
+
+	for (size_t index = 0; index < p_self->visitedCount; index++) {
+		flat_ast_index_t node = p_self->visited[index];
+
+		p_self->nodeTypes[node] = inference_resolve(p_self, p_self->nodeTypes[node]);
+	}
+
+	if (report_enabled(p_self->report, REPORT_TIME)) {
+		char line[MAX_STRING_LENGTH];
+
+		snprintf(line, sizeof(line), "infer %s: %.1fus, %zu nodes, %zu variables, %zu unifications",
+				 p_name, (double)(report_clock() - startTime) / 1000.0, p_self->visitedCount,
+				 p_self->variableCount - firstVariable, p_self->unifications);
+		report_add(p_self->report, REPORT_TIME, line);
+	}
+
+	return type;
+}
+
+type_id_t inference_get_node_type(const struct Inference* p_self, flat_ast_index_t node) {
+	return node < p_self->nodeTypeCapacity ? p_self->nodeTypes[node] : TYPE_ID_NONE;
+}
+
+size_t inference_get_node_depth(const struct Inference* p_self, flat_ast_index_t node) {
+	return node < p_self->nodeDepthCapacity ? p_self->nodeDepths[node] : 0;
+}
+
+type_id_t inference_annotation(struct Inference* p_self, const struct FlatAST* p_ast,
+							   flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_ast, node);
+
+	p_self->ast = p_ast;
+
+	if (lp_node->kind == FLATAST_BINARY) { // A bound, e.g. 'Int|Float'
+		type_id_t members[2] = {inference_annotation(p_self, p_ast, lp_node->lhs),
+								inference_annotation(p_self, p_ast, lp_node->rhs)};
+
+		return type_table_union(p_self->types, members, 2);
+	}
+
+	return inference___annotation(p_self, node);
+}
+
+type_id_t inference_implementation(struct Inference* p_self, const struct FlatAST* p_ast,
+								   type_id_t type, intern_id_t trait) {
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (!p_ast || lp_type->kind != TYPE_NAMED) {
+		return TYPE_ID_NONE;
+	}
+
+	uint32_t record = symbol_table_resolve(p_self->symbols, lp_type->name);
+
+	if (record == SYMBOL_BINDING_NONE
+		|| symbol_table_get(p_self->symbols, record)->kind != SYMBOL_STRUCT) {
+		return TYPE_ID_NONE;
+	}
+
+	struct SymbolBinding binding = *symbol_table_get(p_self->symbols, record);
+	flat_ast_index_t	 impl	 = flat_ast_get(p_ast, binding.declaration)->lhs;
+
+	if (impl == FLATAST_INDEX_NONE) {
+		return TYPE_ID_NONE;
+	}
+
+	const struct FlatASTNode* lp_impl = flat_ast_get(p_ast, impl);
+
+	p_self->ast = p_ast;
+
+	for (size_t index = 0; index < lp_impl->value.list.length; index++) { // e.g. 'Geometry<MU>'
+		flat_ast_index_t		  item	  = flat_ast_get_list_item(p_ast, lp_impl, index);
+		const struct FlatASTNode* lp_item = flat_ast_get(p_ast, item);
+
+		if (inference___name(p_self, lp_item->kind == FLATAST_TYPE ? lp_item->lhs : item)
+			!= trait) {
+			continue;
+		}
+
+		inference___bind_parameters(p_self, binding.type, type);
+
+		type_id_t result = inference___annotation(p_self, item);
+
+		symbol_table_pop_scope(p_self->symbols);
+
+		return result;
+	}
+
+	return TYPE_ID_NONE;
+}
@@ -0,0 +1,201 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./report.h"
+#include "./symbols.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Used to identify what kind of literal an inference variable was created for, so unconstrained
+ * literals can default to 'i32' / 'f64'.
+ */
+enum InferenceLiterals {
+	INFERENCE_LITERAL_NONE,
+	INFERENCE_LITERAL_INTEGER,
+	INFERENCE_LITERAL_FLOAT,
+};
+
+/**
+ * Represents an inference variable, as a node of the union-find forest.
+ */
+struct InferenceVariable {
+	uint32_t  parent;  // Itself if the variable is the representative of its class.
+	uint8_t	  rank;	   // Upper bound on the height of the class' tree.
+	uint8_t	  literal; // enum InferenceLiterals, only meaningful on representatives.
+	type_id_t binding; // The type the class is bound to, TYPE_ID_NONE if unbound.
+};
+
+#define INFERENCE_VARIABLE_SIZE sizeof(struct InferenceVariable)
+
+/**
+ * Represents local type inference. Each function is walked once, and every constraint is solved
+ * the moment it is found by merging classes of type variables in a union-find forest (union by
+ * rank, path compression). Solving a function is therefore near-linear in its size, with no
+ * re-walking of the AST until a fixpoint is reached.
+ */
+struct Inference {
+	const char*				  filePath; // For diagnostics.
+	const struct FlatAST*	  ast;		// The AST of the function being inferred.
+	struct Interner*		  interner;
+	struct SymbolTable*		  symbols;
+	struct TypeTable*		  types;
+	struct Report*			  report;
+	struct InferenceVariable* variables;
+	type_id_t*				  nodeTypes; // The inferred type of each node.
+	// The depth of the scope of the binding each variable resolved to.
+	uint32_t*				  nodeDepths;
+	flat_ast_index_t*		  visited;	 // The nodes visited in the current function.
+	type_id_t				  returnType;
+	type_id_t				  yieldType; // What the current generator yields, else TYPE_ID_NONE.
+	type_id_t				  selfType;	 // The receiver of the method being inferred, else none.
+	bool					  returned;	 // Whether the current function has a return statement.
+	// Variables are numbered for the whole module, as module-level bindings can hold them
+	size_t variableCount, variableCapacity, nodeTypeCapacity, nodeDepthCapacity, visitedCount,
+		visitedCapacity;
+	size_t unifications, generalised;
+};
+
+#define INFERENCE_STRUCT_SIZE sizeof(struct Inference)
+
+/**
+ * Creates a new Inference struct, declaring the runtime's functions and methods (e.g. 'range' and
+ * 'Array.append') in the current scope of the symbol table.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_interner The module's interner.
+ * @param p_symbols  The module's symbol table.
+ * @param p_types    The module's type table.
+ * @param p_report   The requested reports (can be NULL).
+ *
+ * @return The created Inference struct.
+ */
+struct Inference* inference_new(const char* p_filePath, struct Interner* p_interner,
+								struct SymbolTable* p_symbols, struct TypeTable* p_types,
+								struct Report* p_report);
+
+/**
+ * Frees an Inference struct.
+ *
+ * @param p_self The current Inference struct.
+ */
+void inference_free(struct Inference** p_self);
+
+/**
+ * Creates a new inference variable.
+ *
+ * @param p_self  The current Inference struct.
+ * @param literal The kind of literal the variable is for.
+ *
+ * @return The variable's type.
+ */
+type_id_t inference_fresh(struct Inference* p_self, enum InferenceLiterals literal);
+
+/**
+ * Finds what a type currently stands for: the binding of a variable's class, or the class'
+ * representative variable if it is unbound. Other types are returned as is.
+ *
+ * @param p_self The current Inference struct.
+ * @param type   The type.
+ *
+ * @return The type it stands for.
+ */
+type_id_t inference_find(struct Inference* p_self, type_id_t type);
+
+/**
+ * Constrains two types to be equal. A struct and a trait it implements are also accepted, as the
+ * struct is then used as a trait object.
+ *
+ * @param p_self The current Inference struct.
+ * @param a      The first type.
+ * @param b      The second type.
+ *
+ * @return Whether the types can be equal.
+ */
+bool inference_unify(struct Inference* p_self, type_id_t a, type_id_t b);
+
+/**
+ * Replaces every solved variable in a type with what it is bound to.
+ *
+ * @param p_self The current Inference struct.
+ * @param type   The type.
+ *
+ * @return The resolved type.
+ */
+type_id_t inference_resolve(struct Inference* p_self, type_id_t type);
+
+/**
+ * Infers the types of a function. Parameters and the return type without annotations are
+ * inferred from the body; anything left unconstrained in its signature is generalised into an
+ * implicit type parameter. The cost of inference is added to the time report. The type parameters
+ * of a method's struct must be declared in the current scope.
+ *
+ * @param p_self   The current Inference struct.
+ * @param p_ast    The AST containing the function.
+ * @param function The function's node.
+ * @param selfType The type of a method's unannotated first parameter, else TYPE_ID_NONE.
+ * @param p_name   The function's name, for the time report.
+ *
+ * @return The function's type.
+ */
+type_id_t inference_infer_function(struct Inference* p_self, const struct FlatAST* p_ast,
+								   flat_ast_index_t function, type_id_t selfType,
+								   const char* p_name);
+
+/**
+ * Gets the inferred type of a node of the last inferred function.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The node.
+ *
+ * @return The node's type, or TYPE_ID_NONE if it has not been inferred. Types the function leaves
+ *         unconstrained outside of its signature stay inference variables.
+ */
+type_id_t inference_get_node_type(const struct Inference* p_self, flat_ast_index_t node);
+
+/**
+ * Gets the depth of the scope a variable of the last inferred function resolved to, e.g. to tell a
+ * call of a module-level function from a call of a parameter or local shadowing it.
+ *
+ * @param p_self The current Inference struct.
+ * @param node   The VARIABLE node.
+ *
+ * @return The depth of the binding's scope (the module scope has depth 1), or 0 if the node has
+ *         not been inferred.
+ */
+size_t inference_get_node_depth(const struct Inference* p_self, flat_ast_index_t node);
+
+/**
+ * Converts a type annotation to a type, e.g. the type of a struct's field. Bounds of type
+ * parameters are unions, e.g. 'Int|Float'. Type parameters must be declared in the current scope.
+ *
+ * @param p_self The current Inference struct.
+ * @param p_ast  The AST containing the annotation.
+ * @param node   The annotation's node (a TYPE, a VARIABLE for a bare name, or a BINARY '|').
+ *
+ * @return The type.
+ */
+type_id_t inference_annotation(struct Inference* p_self, const struct FlatAST* p_ast,
+							   flat_ast_index_t node);
+
+/**
+ * Gets the trait a struct implements, as declared by its 'impl' list with its type parameters
+ * bound to the struct's type arguments, e.g. 'Geometry<i32>' for 'Rectangle<i32>'.
+ *
+ * @param p_self The current Inference struct.
+ * @param p_ast  The AST containing the struct's declaration.
+ * @param type   The struct's type, e.g. 'Rectangle<i32>'.
+ * @param trait  The interned name of the trait.
+ *
+ * @return The implemented trait, or TYPE_ID_NONE if the type is not a struct implementing it.
+ */
+type_id_t inference_implementation(struct Inference* p_self, const struct FlatAST* p_ast,
+								   type_id_t type, intern_id_t trait);
@@ -0,0 +1,409 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./interface.h"
+#include "../utils/files.h"
+#include "../utils/panic.h"
+#include "../utils/str.h"
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define INTERFACE_ALIGNMENT 8U // Every section starts 8 byte aligned, so it can be used in place.
+
+/**
+ * Rounds an offset up to the section alignment.
+ *
+ * @param offset The offset to align.
+ *
+ * @return The aligned offset.
+ */
+size_t interface___align(size_t offset) {
+	return (offset + INTERFACE_ALIGNMENT - 1) & ~(size_t)(INTERFACE_ALIGNMENT - 1);
+}
+
+uint32_t interface_hash_name(const char* p_name) {
+	return (uint32_t)hashmap_hash_djb2(p_name); // djb2 mod 2^32 is the same on any word size
+}
+
+char* interface_path(const char* p_sourcePath) {
+	const char* lp_separator = strrchr(p_sourcePath, '/');
+	const char* lp_name		 = lp_separator ? lp_separator + 1 : p_sourcePath;
+	const char* lp_extension = strrchr(lp_name, '.');
+	size_t		length		 = strlen(lp_name);
+
+	if (lp_extension && lp_extension > lp_name) {
+		length = (size_t)(lp_extension - lp_name);
+	}
+
+	char* lp_path = malloc(length + sizeof(INTERFACE_EXTENSION));
+
+	if (!lp_path) {
+		PANIC("failed to malloc interface path");
+	}
+
+	memcpy(lp_path, lp_name, length);
+	memcpy(lp_path + length, INTERFACE_EXTENSION, sizeof(INTERFACE_EXTENSION));
+
+	return lp_path;
+}
+
+/**
+ * Frees an exported symbol, for hashmap_free.
+ *
+ * @param p_symbol The symbol.
+ */
+void interface___free_symbol(const void* p_symbol) {
+	free((void*)p_symbol);
+}
+
+struct InterfaceWriter* interface_writer_new(struct FlatAST* p_ast) {
+	struct InterfaceWriter* lp_self = malloc(INTERFACEWRITER_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc InterfaceWriter struct");
+	}
+
+	lp_self->symbolCount = 0;
+	lp_self->ast		 = p_ast;
+	lp_self->symbols =
+		hashmap_new(hashmap_hash_djb2, DEFAULT_INITIAL_TABLE_COUNT, DEFAULT_LOAD_FACTOR);
+
+	return lp_self;
+}
+
+void interface_writer_free(struct InterfaceWriter** p_self) {
+	if (p_self && *p_self) {
+		struct Hashmap* lp_symbols = (*p_self)->symbols;
+
+		// The keys are owned by the writer, so they have to be freed along with the values
+		for (size_t index = 0; index < lp_symbols->table_length; index++) {
+			for (struct HashmapValue* lp_bucket = lp_symbols->buckets[index]; lp_bucket;
+				 lp_bucket						= lp_bucket->next) {
+				free((char*)lp_bucket->KEY);
+			}
+		}
+
+		hashmap_free(&(*p_self)->symbols, interface___free_symbol);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("InterfaceWriter struct has already been freed");
+	}
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void interface_writer_add(struct InterfaceWriter* p_self, const char* p_name,
+						  enum InterfaceSymbolKinds kind, const char* p_signature,
+						  const char* p_related, flat_ast_index_t declaration,
+						  flat_ast_index_t body) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	if (hashmap_get(p_self->symbols, p_name)) {
+		PANIC("symbol has already been exported");
+	}
+
+	struct InterfaceSymbol* lp_symbol = malloc(INTERFACE_SYMBOL_SIZE);
+
+	if (!lp_symbol) {
+		PANIC("failed to malloc InterfaceSymbol struct");
+	}
+
+	lp_symbol->name		   = flat_ast_add_string(p_self->ast, p_name);
+	lp_symbol->hash		   = interface_hash_name(p_name);
+	lp_symbol->kind		   = kind;
+	lp_symbol->signature   = p_signature ? flat_ast_add_string(p_self->ast, p_signature) : 0;
+	lp_symbol->related	   = p_related ? flat_ast_add_string(p_self->ast, p_related) : 0;
+	lp_symbol->declaration = declaration;
+	lp_symbol->body		   = body;
+
+	hashmap_set(p_self->symbols, duplicate_string(p_name), lp_symbol);
+	p_self->symbolCount++;
+}
+
+char* interface_writer_serialise(struct InterfaceWriter* p_self, size_t* p_length) {
+	const struct FlatAST* lp_ast = p_self->ast;
+
+	uint32_t slotCount = 1;
+
+	while (slotCount < p_self->symbolCount * 2) { // Keep the load factor at or below 0.5
+		slotCount *= 2;
+	}
+
+	struct InterfaceHeader header = {.magic			= INTERFACE_MAGIC,
+									 .version		= INTERFACE_FORMAT_VERSION,
+									 .byteOrderMark = INTERFACE_BYTE_ORDER_MARK,
+									 .symbolCount	= (uint32_t)p_self->symbolCount,
+									 .slotCount		= slotCount,
+									 .nodeCount		= (uint32_t)lp_ast->nodeCount,
+									 .extraCount	= (uint32_t)lp_ast->extraCount,
+									 .stringsLength = (uint32_t)lp_ast->stringsLength};
+
+	header.symbolsOffset = interface___align(sizeof(header));
+	header.slotsOffset =
+		interface___align(header.symbolsOffset + p_self->symbolCount * INTERFACE_SYMBOL_SIZE);
+	header.nodesOffset = interface___align(header.slotsOffset + slotCount * sizeof(uint32_t));
+	header.extraOffset =
+		interface___align(header.nodesOffset + lp_ast->nodeCount * FLATAST_NODE_SIZE);
+	header.stringsOffset =
+		interface___align(header.extraOffset + lp_ast->extraCount * sizeof(flat_ast_index_t));
+
+	size_t length = header.stringsOffset + lp_ast->stringsLength;
+	char*  lp_data = calloc(1, length); // Zeroed, so padding and empty slots are deterministic
+
+	if (!lp_data) {
+		PANIC("failed to malloc serialised interface");
+	}
+
+	memcpy(lp_data, &header, sizeof(header));
+
+	struct InterfaceSymbol* lp_symbols = (struct InterfaceSymbol*)(lp_data + header.symbolsOffset);
+	uint32_t*				lp_slots   = (uint32_t*)(lp_data + header.slotsOffset);
+	uint32_t				symbolIndex = 0;
+
+	for (size_t index = 0; index < p_self->symbols->table_length; index++) {
+		for (struct HashmapValue* lp_bucket = p_self->symbols->buckets[index]; lp_bucket;
+			 lp_bucket						= lp_bucket->next) {
+			const struct InterfaceSymbol* lp_symbol = lp_bucket->value;
+			uint32_t					  slot		= lp_symbol->hash & (slotCount - 1);
+
+			while (lp_slots[slot]) { // Linear probing
+				slot = (slot + 1) & (slotCount - 1);
+			}
+
+			lp_symbols[symbolIndex] = *lp_symbol;
+			lp_slots[slot]			= ++symbolIndex; // 0 marks an empty slot
+		}
+	}
+
+	if (lp_ast->nodeCount > 0) {
+		memcpy(lp_data + header.nodesOffset, lp_ast->nodes, lp_ast->nodeCount * FLATAST_NODE_SIZE);
+	}
+
+	if (lp_ast->extraCount > 0) {
+		memcpy(lp_data + header.extraOffset, lp_ast->extra,
+			   lp_ast->extraCount * sizeof(flat_ast_index_t));
+	}
+
+	if (lp_ast->stringsLength > 0) {
+		memcpy(lp_data + header.stringsOffset, lp_ast->strings, lp_ast->stringsLength);
+	}
+
+	*p_length = length;
+
+	return lp_data;
+}
+
+/**
+ * Checks that a section of an interface file lies within the file.
+ *
+ * @param p_self      The current Interface struct.
+ * @param offset      The offset of the section.
+ * @param count       The number of elements in the section.
+ * @param elementSize The size of an element.
+ *
+ * @return Whether the section lies within the file.
+ */
+bool interface___section_valid(const struct Interface* p_self, uint64_t offset, uint64_t count,
+							   size_t elementSize) {
+	return offset % INTERFACE_ALIGNMENT == 0 && offset <= p_self->length
+		   && count <= (p_self->length - offset) / elementSize;
+}
+
+/**
+ * Checks that every offset stored in an opened interface file's symbols and slots is in bounds, and
+ * that its FlatAST is well formed, so looking symbols up and walking their declarations can never
+ * read outside the file.
+ *
+ * @param p_self The current Interface struct.
+ *
+ * @return Whether every offset is in bounds.
+ */
+bool interface___offsets_valid(const struct Interface* p_self) {
+	const struct InterfaceHeader* lp_header = p_self->header;
+
+	if (!flat_ast_validate(p_self->ast)) {
+		return false;
+	}
+
+	for (uint32_t slot = 0; slot < lp_header->slotCount; slot++) {
+		if (p_self->slots[slot] > lp_header->symbolCount) {
+			return false;
+		}
+	}
+
+	for (uint32_t index = 0; index < lp_header->symbolCount; index++) {
+		const struct InterfaceSymbol* lp_symbol = &p_self->symbols[index];
+
+		if (lp_symbol->kind > INTERFACE_SYMBOL_IMPL || lp_symbol->name >= lp_header->stringsLength
+			|| lp_symbol->signature >= lp_header->stringsLength
+			|| lp_symbol->related >= lp_header->stringsLength
+			|| lp_symbol->declaration >= lp_header->nodeCount
+			|| lp_symbol->body >= lp_header->nodeCount) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Maps (or, where mapping is unsupported, reads) an interface file into memory.
+ *
+ * @param p_self     The current Interface struct.
+ * @param p_filePath The path of the interface file.
+ *
+ * @return Whether the file was loaded.
+ */
+bool interface___load(struct Interface* p_self, const char* p_filePath) {
+#ifdef _WIN32
+	p_self->mapped = false;
+	p_self->data   = file_read(p_filePath, &p_self->length);
+
+	return p_self->data;
+#else
+	int fileDescriptor = open(p_filePath, O_RDONLY); // NOLINT(hicpp-signed-bitwise)
+
+	if (fileDescriptor == -1) {
+		return false;
+	}
+
+	struct stat info;
+
+	if (fstat(fileDescriptor, &info) != 0 || info.st_size <= 0) {
+		close(fileDescriptor);
+
+		return false;
+	}
+
+	p_self->mapped = true;
+	p_self->length = (size_t)info.st_size;
+	p_self->data   = mmap(NULL, p_self->length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	close(fileDescriptor); // The mapping stays valid after the descriptor is closed
+
+	if (p_self->data == MAP_FAILED) {
+		p_self->data = NULL;
+
+		return false;
+	}
+
+	return true;
+#endif
+}
+
+struct Interface* interface_open(const char* p_filePath) {
+	struct Interface* lp_self = malloc(INTERFACE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Interface struct");
+	}
+
+	lp_self->ast = NULL;
+
+	if (!interface___load(lp_self, p_filePath)) {
+		free(lp_self);
+
+		return NULL;
+	}
+
+	const struct InterfaceHeader* lp_header = lp_self->data;
+
+	// Reject anything that is not an interface written by this version, on this byte order
+	if (lp_self->length < sizeof(struct InterfaceHeader)
+		|| memcmp(lp_header->magic, INTERFACE_MAGIC, INTERFACE_MAGIC_LENGTH) != 0
+		|| lp_header->version != INTERFACE_FORMAT_VERSION
+		|| lp_header->byteOrderMark != INTERFACE_BYTE_ORDER_MARK
+		|| (lp_header->slotCount & (lp_header->slotCount - 1)) != 0
+		|| !interface___section_valid(lp_self, lp_header->symbolsOffset, lp_header->symbolCount,
+									  INTERFACE_SYMBOL_SIZE)
+		|| !interface___section_valid(lp_self, lp_header->slotsOffset, lp_header->slotCount,
+									  sizeof(uint32_t))
+		|| !interface___section_valid(lp_self, lp_header->nodesOffset, lp_header->nodeCount,
+									  FLATAST_NODE_SIZE)
+		|| !interface___section_valid(lp_self, lp_header->extraOffset, lp_header->extraCount,
+									  sizeof(flat_ast_index_t))
+		|| !interface___section_valid(lp_self, lp_header->stringsOffset, lp_header->stringsLength,
+									  1)) {
+		interface_free(&lp_self);
+
+		return NULL;
+	}
+
+	const char* lp_data = lp_self->data;
+
+	lp_self->header	 = lp_header;
+	lp_self->symbols = (const struct InterfaceSymbol*)(lp_data + lp_header->symbolsOffset);
+	lp_self->slots	 = (const uint32_t*)(lp_data + lp_header->slotsOffset);
+	lp_self->ast	 = flat_ast_view((const struct FlatASTNode*)(lp_data + lp_header->nodesOffset),
+									 lp_header->nodeCount,
+									 (const flat_ast_index_t*)(lp_data + lp_header->extraOffset),
+									 lp_header->extraCount, lp_data + lp_header->stringsOffset,
+									 lp_header->stringsLength);
+
+	if (!interface___offsets_valid(lp_self)) {
+		interface_free(&lp_self);
+
+		return NULL;
+	}
+
+	return lp_self;
+}
+
+void interface_free(struct Interface** p_self) {
+	if (p_self && *p_self) {
+		if ((*p_self)->ast) {
+			flat_ast_free(&(*p_self)->ast);
+		}
+
+#ifndef _WIN32
+		if ((*p_self)->mapped) {
+			munmap((*p_self)->data, (*p_self)->length);
+		} else {
+			free((*p_self)->data);
+		}
+#else
+		free((*p_self)->data);
+#endif
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Interface struct has already been freed");
+	}
+}
+
+const struct InterfaceSymbol* interface_lookup(const struct Interface* p_self, const char* p_name) {
+	uint32_t slotCount = p_self->header->slotCount;
+
+	if (slotCount == 0 || p_self->header->symbolCount == 0) {
+		return NULL;
+	}
+
+	uint32_t hash = interface_hash_name(p_name);
+
+	for (uint32_t slot = hash & (slotCount - 1), probes = 0; probes < slotCount;
+		 slot = (slot + 1) & (slotCount - 1), probes++) {
+		uint32_t symbolIndex = p_self->slots[slot];
+
+		if (symbolIndex == 0 || symbolIndex > p_self->header->symbolCount) { // Empty slot
+			return NULL;
+		}
+
+		const struct InterfaceSymbol* lp_symbol = &p_self->symbols[symbolIndex - 1];
+
+		if (lp_symbol->hash == hash
+			&& strcmp(flat_ast_get_string(p_self->ast, lp_symbol->name), p_name) == 0) {
+			return lp_symbol;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,173 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../parser/flat.h"
+#include "../utils/hashmap.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define INTERFACE_MAGIC			  "EXMI"
+#define INTERFACE_MAGIC_LENGTH	  4U
+#define INTERFACE_FORMAT_VERSION  2U
+#define INTERFACE_BYTE_ORDER_MARK 0x01020304U // Interfaces are only valid on the same byte order.
+#define INTERFACE_EXTENSION		  ".exmi"	  // Written to the working directory.
+
+/**
+ * Used to identify the kinds of exported symbols.
+ */
+enum InterfaceSymbolKinds {
+	INTERFACE_SYMBOL_STRUCT,   // declaration = the STRUCT node, holding its fields
+	INTERFACE_SYMBOL_TRAIT,	   // declaration = the TRAIT node, holding its methods
+	INTERFACE_SYMBOL_FUNCTION, // declaration = function, body = inlinable body
+	INTERFACE_SYMBOL_METHOD,   // As above, related = the struct the method belongs to
+	INTERFACE_SYMBOL_IMPL,	   // Named '<struct> impl <trait>', related = the trait
+};
+
+/**
+ * Represents the header of an interface file. All offsets are from the start of the file.
+ */
+struct InterfaceHeader {
+	char	 magic[INTERFACE_MAGIC_LENGTH];
+	uint32_t version, byteOrderMark;
+	uint32_t symbolCount, slotCount, nodeCount, extraCount, stringsLength;
+	uint64_t symbolsOffset, slotsOffset, nodesOffset, extraOffset, stringsOffset;
+};
+
+/**
+ * Represents an exported symbol in an interface file. Strings are offsets into the string pool of
+ * the interface's FlatAST.
+ */
+struct InterfaceSymbol {
+	uint32_t		 name, hash, kind;
+	uint32_t		 signature;	  // The generic signature, e.g. '<T: Int>(T, T) -> T'.
+	uint32_t		 related;	  // The owning struct of a method, or the trait of an impl.
+	flat_ast_index_t declaration; // The declaration's node.
+	flat_ast_index_t body;		  // The inlinable body, or FLATAST_INDEX_NONE.
+};
+
+#define INTERFACE_SYMBOL_SIZE sizeof(struct InterfaceSymbol)
+
+/**
+ * Represents a writer for the interface of the module being compiled.
+ */
+struct InterfaceWriter {
+	size_t			symbolCount;
+	struct FlatAST* ast;	 // The module's AST, holding declarations, bodies and strings.
+	struct Hashmap* symbols; // The exported symbols, by name.
+};
+
+#define INTERFACEWRITER_STRUCT_SIZE sizeof(struct InterfaceWriter)
+
+/**
+ * Represents a loaded interface file. The file is memory-mapped and never decoded up front;
+ * symbols are found through the file's own hash table when they are looked up.
+ */
+struct Interface {
+	bool						  mapped; // Whether data is a mapping (else a malloced copy).
+	void*						  data;
+	size_t						  length;
+	const struct InterfaceHeader* header;
+	const struct InterfaceSymbol* symbols;
+	const uint32_t*				  slots; // Open addressing table of symbol indexes + 1.
+	struct FlatAST*				  ast;	 // A read-only view over the file's nodes and strings.
+};
+
+#define INTERFACE_STRUCT_SIZE sizeof(struct Interface)
+
+/**
+ * Hashes a symbol name for the interface hash table. Fixed to 32 bits so files are portable
+ * between 32 and 64 bit compilers.
+ *
+ * @param p_name The symbol name.
+ *
+ * @return The hash.
+ */
+uint32_t interface_hash_name(const char* p_name);
+
+/**
+ * Gets the path of a module's interface file, in the working directory, e.g. 'shapes.exmi' for
+ * 'geometry/shapes.exl'. Builds share it through the directory they are run from, so the sources
+ * are left untouched.
+ *
+ * @param p_sourcePath The path of the module's source file.
+ *
+ * @return The path of the interface file.
+ */
+char* interface_path(const char* p_sourcePath);
+
+/**
+ * Creates a new InterfaceWriter struct.
+ *
+ * @param p_ast The module's AST.
+ *
+ * @return The created InterfaceWriter struct.
+ */
+struct InterfaceWriter* interface_writer_new(struct FlatAST* p_ast);
+
+/**
+ * Frees an InterfaceWriter struct.
+ *
+ * @param p_self The current InterfaceWriter struct.
+ */
+void interface_writer_free(struct InterfaceWriter** p_self);
+
+/**
+ * Exports a symbol.
+ *
+ * @param p_self      The current InterfaceWriter struct.
+ * @param p_name      The name of the symbol.
+ * @param kind        The kind of the symbol.
+ * @param p_signature The generic signature of the symbol (can be NULL).
+ * @param p_related   The related struct / trait (can be NULL).
+ * @param declaration The declaration's node.
+ * @param body        The inlinable body, or FLATAST_INDEX_NONE.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void interface_writer_add(struct InterfaceWriter* p_self, const char* p_name,
+						  enum InterfaceSymbolKinds kind, const char* p_signature,
+						  const char* p_related, flat_ast_index_t declaration,
+						  flat_ast_index_t body);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Serialises the interface.
+ *
+ * @param p_self   The current InterfaceWriter struct.
+ * @param p_length Where to write the length of the serialised interface.
+ *
+ * @return The serialised interface.
+ */
+char* interface_writer_serialise(struct InterfaceWriter* p_self, size_t* p_length);
+
+/**
+ * Opens an interface file. Every offset in the file is checked when it is opened, so a corrupt or
+ * truncated file is rejected instead of being read out of bounds later.
+ *
+ * @param p_filePath The path of the interface file.
+ *
+ * @return The opened Interface struct, or NULL if the file is missing, or is not a valid interface
+ * for this compiler.
+ */
+struct Interface* interface_open(const char* p_filePath);
+
+/**
+ * Frees an Interface struct, unmapping the file.
+ *
+ * @param p_self The current Interface struct.
+ */
+void interface_free(struct Interface** p_self);
+
+/**
+ * Looks up an exported symbol.
+ *
+ * @param p_self The current Interface struct.
+ * @param p_name The name of the symbol.
+ *
+ * @return The symbol, or NULL if it is not exported.
+ */
+const struct InterfaceSymbol* interface_lookup(const struct Interface* p_self, const char* p_name);
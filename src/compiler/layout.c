@@ -0,0 +1,428 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./layout.h"
+#include "./attributes.h"
+#include "./diagnostics.h"
+#include "../globals.h"
+#include "../utils/buffer.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The size of each primitive type, which is also its alignment
+static const uint32_t g_LAYOUT_PRIMITIVE_SIZES[TYPE_PRIMITIVE_COUNT] = {
+	[TYPE_PRIMITIVE_VOID] = 0U, [TYPE_PRIMITIVE_BOOL] = 1U, [TYPE_PRIMITIVE_I8] = 1U,
+	[TYPE_PRIMITIVE_I16] = 2U,	[TYPE_PRIMITIVE_I32] = 4U,	[TYPE_PRIMITIVE_I64] = 8U,
+	[TYPE_PRIMITIVE_U8] = 1U,	[TYPE_PRIMITIVE_U16] = 2U,	[TYPE_PRIMITIVE_U32] = 4U,
+	[TYPE_PRIMITIVE_U64] = 8U,	[TYPE_PRIMITIVE_F32] = 4U,	[TYPE_PRIMITIVE_F64] = 8U,
+	[TYPE_PRIMITIVE_CHR] = 1U,	[TYPE_PRIMITIVE_STR] = 3U * LAYOUT_POINTER_SIZE, // %str
+};
+
+struct LayoutTable* layout_table_new(const char* p_filePath, struct TypeTable* p_types,
+									 struct Interner* p_interner, struct Report* p_report) {
+	struct LayoutTable* lp_self = calloc(1, LAYOUTTABLE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc LayoutTable struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->types	  = p_types;
+	lp_self->interner = p_interner;
+	lp_self->report	  = p_report;
+
+	return lp_self;
+}
+
+void layout_table_free(struct LayoutTable** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->layouts);
+		free((*p_self)->fields);
+		free((*p_self)->byType);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("LayoutTable struct has already been freed");
+	}
+}
+
+/**
+ * Rounds an offset up to a multiple of an alignment.
+ *
+ * @param offset    The offset.
+ * @param alignment The alignment, a power of two.
+ *
+ * @return The aligned offset.
+ */
+uint32_t layout___align(uint32_t offset, uint32_t alignment) {
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t layout_type_size(const struct LayoutTable* p_self, type_id_t type, uint32_t* p_alignment) {
+	const struct Type* lp_type	 = type_table_get(p_self->types, type);
+	uint32_t		   size		 = LAYOUT_POINTER_SIZE;
+	uint32_t		   alignment = LAYOUT_POINTER_SIZE;
+
+	if (lp_type->kind == TYPE_PRIMITIVE) {
+		size	  = g_LAYOUT_PRIMITIVE_SIZES[lp_type->primitive];
+		alignment = lp_type->primitive == TYPE_PRIMITIVE_STR ? LAYOUT_POINTER_SIZE : size;
+		alignment = alignment ? alignment : 1U; // void
+	} else if (lp_type->kind == TYPE_NAMED
+			   && strcmp(interner_get(p_self->interner, lp_type->name), "Array") == 0) {
+		size = 3U * LAYOUT_POINTER_SIZE; // %array, held by value
+	} else if (lp_type->kind == TYPE_NAMED && layout_find(p_self, type) != LAYOUT_NONE) {
+		const struct Layout* lp_layout = &p_self->layouts[layout_find(p_self, type)];
+
+		size	  = lp_layout->size;
+		alignment = lp_layout->alignment;
+	} else if (lp_type->kind == TYPE_VECTOR) { // Aligned to their size, like LLVM vectors
+		size	  = g_LAYOUT_PRIMITIVE_SIZES[lp_type->primitive] * lp_type->name;
+		alignment = size;
+	} else if (lp_type->kind == TYPE_TUPLE) { // Tuples are laid out in order, like LLVM structs
+		const type_id_t* lp_members = type_table_get_args(p_self->types, type);
+
+		size	  = 0;
+		alignment = 1U;
+
+		for (uint32_t index = 0; index < lp_type->argCount; index++) {
+			uint32_t memberAlignment = 0;
+			uint32_t memberSize = layout_type_size(p_self, lp_members[index], &memberAlignment);
+
+			size	  = layout___align(size, memberAlignment) + memberSize;
+			alignment = memberAlignment > alignment ? memberAlignment : alignment;
+		}
+
+		size = layout___align(size, alignment);
+	}
+
+	if (p_alignment) {
+		*p_alignment = alignment;
+	}
+
+	return size;
+}
+
+/**
+ * Gets the size and alignment of a field, from the LLVM type it is stored as: a pointer for values
+ * held by reference, two for trait objects, else the size of its type.
+ *
+ * @param p_self      The current LayoutTable struct.
+ * @param p_field     The field.
+ * @param p_alignment Where to write the alignment (can be NULL).
+ *
+ * @return The size of the field, in bytes.
+ */
+uint32_t layout___field_size(const struct LayoutTable* p_self, const struct LayoutField* p_field,
+							 uint32_t* p_alignment) {
+	const char* lp_llvmType = interner_get(p_self->interner, p_field->llvmType);
+	size_t		length		= strlen(lp_llvmType);
+
+	if (length && lp_llvmType[length - 1] == '*') {
+		if (p_alignment) {
+			*p_alignment = LAYOUT_POINTER_SIZE;
+		}
+
+		return LAYOUT_POINTER_SIZE;
+	}
+
+	if (length > 5 && strcmp(&lp_llvmType[length - 5], ".dyn\"") == 0) { // { i8*, vtable* }
+		if (p_alignment) {
+			*p_alignment = LAYOUT_POINTER_SIZE;
+		}
+
+		return 2U * LAYOUT_POINTER_SIZE;
+	}
+
+	return layout_type_size(p_self, p_field->type, p_alignment);
+}
+
+/**
+ * Computes the offsets of a struct's fields from their slots, and the size of the struct.
+ *
+ * @param p_self   The current LayoutTable struct.
+ * @param p_layout The layout, whose fields have their slots.
+ *
+ * @return The size of the struct, in bytes.
+ */
+uint32_t layout___place(struct LayoutTable* p_self, struct Layout* p_layout) {
+	struct LayoutField* lp_fields = &p_self->fields[p_layout->fieldStart];
+	uint32_t			offset	  = 0;
+
+	p_layout->alignment = 1U;
+
+	for (uint32_t slot = 0; slot < p_layout->fieldCount; slot++) {
+		for (uint32_t index = 0; index < p_layout->fieldCount; index++) {
+			if (lp_fields[index].slot != slot) {
+				continue;
+			}
+
+			uint32_t alignment = 0;
+			uint32_t size	   = layout___field_size(p_self, &lp_fields[index], &alignment);
+
+			lp_fields[index].offset = layout___align(offset, alignment);
+			offset					= lp_fields[index].offset + size;
+
+			if (alignment > p_layout->alignment) {
+				p_layout->alignment = alignment;
+			}
+		}
+	}
+
+	return layout___align(offset, p_layout->alignment);
+}
+
+/**
+ * Appends the LLVM name of a struct's type, e.g. '%"Stack<i32>"'.
+ *
+ * @param p_self   The current LayoutTable struct.
+ * @param layout   The index of the layout.
+ * @param p_output Where to append the name.
+ */
+void layout___append_type(const struct LayoutTable* p_self, uint32_t layout,
+						  struct String* p_output) {
+	char* lp_type = type_table_to_string(p_self->types, p_self->layouts[layout].type);
+
+	string_append_str(p_output, "%\"");
+	string_append_str(p_output, lp_type);
+	string_append_chr(p_output, '"');
+
+	free(lp_type);
+}
+
+/**
+ * Adds the layout of a struct to the layout report: a line with its size, then a line per field
+ * and per padding hole in memory order.
+ *
+ * @param p_self The current LayoutTable struct.
+ * @param layout The index of the layout.
+ * @param line   The line of the declaration.
+ */
+void layout___report(struct LayoutTable* p_self, uint32_t layout, uint32_t line) {
+	const struct Layout*	  lp_layout = &p_self->layouts[layout];
+	const struct LayoutField* lp_fields = &p_self->fields[lp_layout->fieldStart];
+	char*					  lp_type	= type_table_to_string(p_self->types, lp_layout->type);
+	char					  detail[128];
+	char					  output[MAX_STRING_LENGTH];
+	uint32_t				  offset = 0;
+
+	if (lp_layout->ordered) {
+		snprintf(detail, sizeof(detail), "declaration order, '@ordered'");
+	} else if (lp_layout->declaredSize > lp_layout->size) {
+		snprintf(detail, sizeof(detail), "reordered, %u bytes saved",
+				 lp_layout->declaredSize - lp_layout->size);
+	} else {
+		snprintf(detail, sizeof(detail), "declaration order is minimal");
+	}
+
+	snprintf(output, sizeof(output), "%.200s:%u: %.200s: %u bytes, align %u (%s)",
+			 p_self->filePath, line + 1, lp_type, lp_layout->size, lp_layout->alignment, detail);
+	report_add(p_self->report, REPORT_LAYOUT, output);
+
+	for (uint32_t slot = 0; slot < lp_layout->fieldCount; slot++) {
+		for (uint32_t index = 0; index < lp_layout->fieldCount; index++) {
+			if (lp_fields[index].slot != slot) {
+				continue;
+			}
+
+			char*	 lp_fieldType = type_table_to_string(p_self->types, lp_fields[index].type);
+			uint32_t size		  = layout___field_size(p_self, &lp_fields[index], NULL);
+
+			if (lp_fields[index].offset > offset) {
+				snprintf(output, sizeof(output), "  %4u padding (%u bytes)", offset,
+						 lp_fields[index].offset - offset);
+				report_add(p_self->report, REPORT_LAYOUT, output);
+			}
+
+			snprintf(output, sizeof(output), "  %4u %.200s: %.200s (%u bytes)",
+					 lp_fields[index].offset, interner_get(p_self->interner, lp_fields[index].name),
+					 lp_fieldType, size);
+			report_add(p_self->report, REPORT_LAYOUT, output);
+
+			offset = lp_fields[index].offset + size;
+
+			free(lp_fieldType);
+		}
+	}
+
+	if (lp_layout->size > offset) {
+		snprintf(output, sizeof(output), "  %4u padding (%u bytes)", offset,
+				 lp_layout->size - offset);
+		report_add(p_self->report, REPORT_LAYOUT, output);
+	}
+
+	free(lp_type);
+}
+
+/**
+ * Errors if a field holds a struct by value that has not been declared yet, as its size is unknown.
+ * Structs must be declared before the structs containing them, and imported structs are declared
+ * from their module's interface.
+ *
+ * @param p_self      The current LayoutTable struct.
+ * @param p_ast       The AST containing the declaration.
+ * @param declaration The STRUCT node being declared.
+ * @param type        The type of the struct.
+ * @param p_field     The field.
+ */
+void layout___check_field(const struct LayoutTable* p_self, const struct FlatAST* p_ast,
+						  flat_ast_index_t declaration, type_id_t type,
+						  const struct LayoutField* p_field) {
+	const struct Type* lp_type	   = type_table_get(p_self->types, p_field->type);
+	const char*		   lp_llvmType = interner_get(p_self->interner, p_field->llvmType);
+
+	if (lp_type->kind != TYPE_NAMED
+		|| strcmp(interner_get(p_self->interner, lp_type->name), "Array") == 0
+		|| layout_find(p_self, p_field->type) != LAYOUT_NONE
+		|| (*lp_llvmType && lp_llvmType[strlen(lp_llvmType) - 1] == '*')) { // Held by reference
+		return;
+	}
+
+	compiler_error(p_self->filePath, flat_ast_get(p_ast, declaration)->line, C0002,
+				   CONCATENATE_STRING("the field '", interner_get(p_self->interner, p_field->name),
+									  "' of '", type_table_to_string(p_self->types, type),
+									  "' holds a '",
+									  type_table_to_string(p_self->types, p_field->type),
+									  "', which has not been declared before it"));
+}
+
+uint32_t layout_declare(struct LayoutTable* p_self, const struct FlatAST* p_ast,
+						flat_ast_index_t declaration, type_id_t type,
+						const struct LayoutField* p_fields, size_t count, struct String* p_output) {
+	if (layout_find(p_self, type) != LAYOUT_NONE) {
+		PANIC("LayoutTable struct has already been declared");
+	}
+
+	for (size_t index = 0; index < count; index++) {
+		layout___check_field(p_self, p_ast, declaration, type, &p_fields[index]);
+	}
+
+	p_self->layouts = buffer_grow(p_self->layouts, &p_self->layoutCapacity, p_self->layoutCount + 1,
+								  LAYOUT_SIZE);
+	p_self->fields	= buffer_grow(p_self->fields, &p_self->fieldCapacity,
+								  p_self->fieldCount + count, LAYOUT_FIELD_SIZE);
+	p_self->byType	= buffer_grow(p_self->byType, &p_self->byTypeCapacity, (size_t)type + 1,
+								  sizeof(uint32_t));
+
+	uint32_t			layout	  = (uint32_t)p_self->layoutCount++;
+	struct Layout*		lp_layout = &p_self->layouts[layout];
+	struct LayoutField* lp_fields = &p_self->fields[p_self->fieldCount];
+
+	lp_layout->type		  = type;
+	lp_layout->fieldStart = (uint32_t)p_self->fieldCount;
+	lp_layout->fieldCount = (uint32_t)count;
+	lp_layout->ordered	  = attributes_has(p_ast, declaration, ATTRIBUTE_ORDERED);
+
+	memcpy(lp_fields, p_fields, count * LAYOUT_FIELD_SIZE);
+	p_self->fieldCount += count;
+
+	for (uint32_t index = 0; index < count; index++) {
+		lp_fields[index].slot = index;
+	}
+
+	lp_layout->declaredSize = layout___place(p_self, lp_layout);
+	lp_layout->size			= lp_layout->declaredSize;
+
+	if (!lp_layout->ordered) {
+		// Sort by decreasing alignment, stable so equally aligned fields keep declaration order
+		for (uint32_t index = 0; index < count; index++) {
+			uint32_t alignment = 0;
+			uint32_t slot	   = 0;
+
+			layout___field_size(p_self, &lp_fields[index], &alignment);
+
+			for (uint32_t other = 0; other < count; other++) {
+				uint32_t otherAlignment = 0;
+
+				layout___field_size(p_self, &lp_fields[other], &otherAlignment);
+
+				if (otherAlignment > alignment || (otherAlignment == alignment && other < index)) {
+					slot++;
+				}
+			}
+
+			lp_fields[index].slot = slot;
+		}
+
+		lp_layout->size = layout___place(p_self, lp_layout);
+
+		if (lp_layout->size < lp_layout->declaredSize) {
+			p_self->reordered++;
+			p_self->saved += lp_layout->declaredSize - lp_layout->size;
+		} else { // Nothing saved, so keep the order the user wrote
+			for (uint32_t index = 0; index < count; index++) {
+				lp_fields[index].slot = index;
+			}
+
+			lp_layout->size = layout___place(p_self, lp_layout);
+		}
+	}
+
+	p_self->byType[type] = layout + 1;
+
+	// %"Stack<i32>" = type { %"Array<i32>", i32 }
+	layout___append_type(p_self, layout, p_output);
+	string_append_str(p_output, " = type {");
+
+	for (uint32_t slot = 0; slot < count; slot++) {
+		for (uint32_t index = 0; index < count; index++) {
+			if (lp_fields[index].slot == slot) {
+				string_append_str(p_output, slot ? ", " : " ");
+				string_append_str(p_output,
+								  interner_get(p_self->interner, lp_fields[index].llvmType));
+			}
+		}
+	}
+
+	string_append_str(p_output, count ? " }\n" : "}\n");
+
+	if (report_enabled(p_self->report, REPORT_LAYOUT)) {
+		layout___report(p_self, layout, flat_ast_get(p_ast, declaration)->line);
+	}
+
+	return layout;
+}
+
+uint32_t layout_find(const struct LayoutTable* p_self, type_id_t type) {
+	return type < p_self->byTypeCapacity && p_self->byType[type] ? p_self->byType[type] - 1
+																   : LAYOUT_NONE;
+}
+
+const struct LayoutField* layout_get_field(const struct LayoutTable* p_self, uint32_t layout,
+										   intern_id_t name) {
+	const struct Layout* lp_layout = &p_self->layouts[layout];
+
+	for (uint32_t index = 0; index < lp_layout->fieldCount; index++) {
+		if (p_self->fields[lp_layout->fieldStart + index].name == name) {
+			return &p_self->fields[lp_layout->fieldStart + index];
+		}
+	}
+
+	return NULL;
+}
+
+void layout_emit_field(const struct LayoutTable* p_self, uint32_t layout,
+					   const struct LayoutField* p_field, const char* p_object,
+					   const char* p_result, struct String* p_output) {
+	char* lp_slot = ul_to_string(p_field->slot);
+
+	// %count = getelementptr inbounds %"Stack<i32>", %"Stack<i32>"* %stack, i32 0, i32 1
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = getelementptr inbounds ");
+	layout___append_type(p_self, layout, p_output);
+	string_append_str(p_output, ", ");
+	layout___append_type(p_self, layout, p_output);
+	string_append_str(p_output, "* ");
+	string_append_str(p_output, p_object);
+	string_append_str(p_output, ", i32 0, i32 ");
+	string_append_str(p_output, lp_slot);
+	string_append_chr(p_output, '\n');
+
+	free(lp_slot);
+}
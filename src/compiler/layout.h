@@ -0,0 +1,157 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./report.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LAYOUT_NONE			UINT32_MAX
+#define LAYOUT_POINTER_SIZE 8U // Size and alignment of pointers, and of values held by reference.
+
+/**
+ * Represents a field of a struct. The name, type and LLVM type are given when declaring the struct,
+ * the offset and slot are computed.
+ */
+struct LayoutField {
+	intern_id_t name;
+	type_id_t	type;
+	intern_id_t llvmType; // e.g. 'i32' or '%"Array<i32>"'.
+	uint32_t	offset;	  // In bytes, from the start of the struct.
+	uint32_t	slot;	  // The index of the field in the LLVM struct, for 'getelementptr'.
+};
+
+#define LAYOUT_FIELD_SIZE sizeof(struct LayoutField)
+
+/**
+ * Represents the layout of a struct, whose fields are a slice of the fields array in declaration
+ * order.
+ */
+struct Layout {
+	type_id_t type;
+	uint32_t  fieldStart, fieldCount;
+	uint32_t  size, alignment;
+	uint32_t  declaredSize; // The size the struct would have in declaration order.
+	bool	  ordered;		// Whether the struct is marked '@ordered', so is in declaration order.
+};
+
+#define LAYOUT_SIZE sizeof(struct Layout)
+
+/**
+ * Represents the struct layouts of a module. Fields are sorted by decreasing alignment (keeping
+ * declaration order between equal alignments), which leaves no padding between fields whose sizes
+ * are multiples of their alignment, so smaller structs fit more elements in a cache line. Structs
+ * marked '@ordered' keep declaration order, e.g. to match a C struct over FFI.
+ */
+struct LayoutTable {
+	const char*			filePath; // For the report.
+	struct TypeTable*	types;
+	struct Interner*	interner;
+	struct Report*		report;
+	struct Layout*		layouts;
+	struct LayoutField* fields;
+	uint32_t*			byType; // Layout indexes + 1, indexed by type id.
+	size_t layoutCount, layoutCapacity, fieldCount, fieldCapacity, byTypeCapacity;
+	size_t reordered, saved; // For the time report.
+};
+
+#define LAYOUTTABLE_STRUCT_SIZE sizeof(struct LayoutTable)
+
+/**
+ * Creates a new LayoutTable struct.
+ *
+ * @param p_filePath The path of the module, for the report.
+ * @param p_types    The module's type table.
+ * @param p_interner The module's interner.
+ * @param p_report   The requested reports (can be NULL).
+ *
+ * @return The created LayoutTable struct.
+ */
+struct LayoutTable* layout_table_new(const char* p_filePath, struct TypeTable* p_types,
+									 struct Interner* p_interner, struct Report* p_report);
+
+/**
+ * Frees a LayoutTable struct.
+ *
+ * @param p_self The current LayoutTable struct.
+ */
+void layout_table_free(struct LayoutTable** p_self);
+
+/**
+ * Gets the size and alignment of a type. Primitives and declared structs have their own layout,
+ * other types (functions, unions, trait objects) are held by reference. Structs held by value must
+ * have been declared, which layout_declare checks for the fields it is given.
+ *
+ * @param p_self      The current LayoutTable struct.
+ * @param type        The type, with no type parameters left.
+ * @param p_alignment Where to write the alignment (can be NULL).
+ *
+ * @return The size of the type, in bytes.
+ */
+uint32_t layout_type_size(const struct LayoutTable* p_self, type_id_t type, uint32_t* p_alignment);
+
+/**
+ * Declares a struct, or an instance of a generic struct, computing its layout and emitting its
+ * LLVM type. The layout is added to the layout report. Errors if a field holds a struct by value
+ * (its LLVM type is not a pointer) that has not been declared yet.
+ *
+ * @param p_self      The current LayoutTable struct.
+ * @param p_ast       The AST containing the declaration.
+ * @param declaration The declaration's node, for its attributes and line.
+ * @param type        The struct's type, e.g. 'Stack<i32>'.
+ * @param p_fields    The struct's fields, in declaration order.
+ * @param count       The number of fields.
+ * @param p_output    Where to append the IR.
+ *
+ * @return The index of the layout.
+ */
+uint32_t layout_declare(struct LayoutTable* p_self, const struct FlatAST* p_ast,
+						flat_ast_index_t declaration, type_id_t type,
+						const struct LayoutField* p_fields, size_t count, struct String* p_output);
+
+/**
+ * Finds the layout of a declared struct.
+ *
+ * @param p_self The current LayoutTable struct.
+ * @param type   The struct's type.
+ *
+ * @return The index of the layout, or LAYOUT_NONE if the struct has not been declared.
+ */
+uint32_t layout_find(const struct LayoutTable* p_self, type_id_t type);
+
+/**
+ * Finds a field of a declared struct.
+ *
+ * @param p_self The current LayoutTable struct.
+ * @param layout The index of the layout.
+ * @param name   The interned name of the field.
+ *
+ * @return The field, or NULL if the struct has no such field.
+ */
+const struct LayoutField* layout_get_field(const struct LayoutTable* p_self, uint32_t layout,
+										   intern_id_t name);
+
+/**
+ * Emits the address of a field of a struct, e.g.
+ * '%count = getelementptr inbounds %"Stack<i32>", %"Stack<i32>"* %stack, i32 0, i32 1'.
+ *
+ * @param p_self   The current LayoutTable struct.
+ * @param layout   The index of the layout.
+ * @param p_field  The field, from layout_get_field.
+ * @param p_object The pointer to the struct, e.g. '%stack'.
+ * @param p_result The name of the pointer to the field, e.g. '%count'.
+ * @param p_output Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void layout_emit_field(const struct LayoutTable* p_self, uint32_t layout,
+					   const struct LayoutField* p_field, const char* p_object,
+					   const char* p_result, struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
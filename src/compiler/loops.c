@@ -0,0 +1,682 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./loops.h"
+#include "../lexer/tokens.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct LoopLowering* loop_lowering_new(void) {
+	struct LoopLowering* lp_self = calloc(1, LOOPLOWERING_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc LoopLowering struct");
+	}
+
+	return lp_self;
+}
+
+void loop_lowering_free(struct LoopLowering** p_self) {
+	if (p_self && *p_self) {
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("LoopLowering struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether a callee is 'range' or 'cf::range'.
+ *
+ * @param p_ast  The AST containing the callee.
+ * @param callee The callee's node.
+ *
+ * @return Whether the callee is range.
+ */
+bool loop_lowering___is_range(const struct FlatAST* p_ast, flat_ast_index_t callee) {
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_ast, callee);
+
+	if (lp_callee->kind == FLATAST_BINARY && lp_callee->operation == LEXERTOKENS_SCOPE_RESOLUTION) {
+		const struct FlatASTNode* lp_module = flat_ast_get(p_ast, lp_callee->lhs);
+
+		if (lp_module->kind != FLATAST_VARIABLE
+			|| strcmp(flat_ast_get_string(p_ast, lp_module->value.string), "cf") != 0) {
+			return false;
+		}
+
+		lp_callee = flat_ast_get(p_ast, lp_callee->rhs);
+	}
+
+	return lp_callee->kind == FLATAST_VARIABLE
+		   && strcmp(flat_ast_get_string(p_ast, lp_callee->value.string), "range") == 0;
+}
+
+/**
+ * Checks whether a type is an integer, so it can be an induction variable.
+ *
+ * @param p_types  The module's type table.
+ * @param type     The type.
+ * @param p_signed Where to write whether the integer is signed.
+ *
+ * @return Whether the type is an integer.
+ */
+bool loop_lowering___is_integer(const struct TypeTable* p_types, type_id_t type, bool* p_signed) {
+	const struct Type* lp_type = type_table_get(p_types, type);
+
+	if (lp_type->kind != TYPE_PRIMITIVE || lp_type->primitive < TYPE_PRIMITIVE_I8
+		|| lp_type->primitive > TYPE_PRIMITIVE_U64) {
+		return false;
+	}
+
+	*p_signed = lp_type->primitive <= TYPE_PRIMITIVE_I64;
+
+	return true;
+}
+
+flat_ast_index_t loop_lowering_get_parallel_source(const struct FlatAST* p_ast,
+												   flat_ast_index_t iterable) {
+	const struct FlatASTNode* lp_iterable = flat_ast_get(p_ast, iterable);
+
+	if (lp_iterable->kind != FLATAST_CALL || lp_iterable->value.list.length != 0) {
+		return FLATAST_INDEX_NONE;
+	}
+
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_ast, lp_iterable->lhs);
+
+	if (lp_callee->kind != FLATAST_MEMBER
+		|| strcmp(flat_ast_get_string(p_ast, lp_callee->value.string), LOOP_PARALLEL_METHOD)
+			   != 0) {
+		return FLATAST_INDEX_NONE;
+	}
+
+	return lp_callee->lhs;
+}
+
+bool loop_lowering___invalidates(const struct FlatAST* p_ast, const struct Inference* p_inference,
+								 const struct TypeTable* p_types, flat_ast_index_t node,
+								 flat_ast_index_t binding, flat_ast_index_t array);
+
+enum LoopKinds loop_lowering_analyse(struct LoopLowering* p_self, const struct FlatAST* p_ast,
+									 const struct Inference* p_inference,
+									 const struct TypeTable* p_types, flat_ast_index_t node,
+									 struct CountedLoop* p_loop) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_ast, node);
+
+	if (lp_node->kind != FLATAST_FOR) {
+		PANIC("LoopLowering can only analyse for loops");
+	}
+
+	p_self->loops++;
+
+	memset(p_loop, 0, COUNTED_LOOP_SIZE);
+	p_loop->kind = LOOP_GENERIC;
+	p_loop->node = node;
+
+	if (lp_node->value.list.length != 1) { // Destructuring bindings go through the iterator
+		return LOOP_GENERIC;
+	}
+
+	p_loop->binding = flat_ast_get_list_item(p_ast, lp_node, 0);
+
+	flat_ast_index_t iterable = loop_lowering_get_parallel_source(p_ast, lp_node->lhs);
+
+	p_loop->parallel = iterable != FLATAST_INDEX_NONE;
+
+	if (!p_loop->parallel) {
+		iterable = lp_node->lhs;
+	}
+
+	const struct FlatASTNode* lp_iterable = flat_ast_get(p_ast, iterable);
+
+	if (lp_iterable->kind == FLATAST_CALL && loop_lowering___is_range(p_ast, lp_iterable->lhs)) {
+		size_t argCount = lp_iterable->value.list.length;
+
+		p_loop->type = inference_get_node_type(p_inference, p_loop->binding);
+
+		if ((argCount != 1 && argCount != 2)
+			|| !loop_lowering___is_integer(p_types, p_loop->type, &p_loop->isSigned)) {
+			return LOOP_GENERIC;
+		}
+
+		p_loop->kind  = LOOP_RANGE;
+		p_loop->start = argCount == 2 ? flat_ast_get_list_item(p_ast, lp_iterable, 0)
+									  : FLATAST_INDEX_NONE;
+		p_loop->end	  = flat_ast_get_list_item(p_ast, lp_iterable, argCount - 1);
+	} else {
+		type_id_t		   type	   = inference_get_node_type(p_inference, iterable);
+		const struct Type* lp_type = type_table_get(p_types, type);
+
+		if (lp_type->kind != TYPE_NAMED || lp_type->argCount != 1
+			|| strcmp(interner_get(p_types->interner, lp_type->name), "Array") != 0) {
+			return LOOP_GENERIC;
+		}
+
+		p_loop->kind	 = LOOP_ARRAY;
+		p_loop->iterable = iterable;
+		p_loop->type	 = type_table_get_args(p_types, type)[0];
+		p_loop->isSigned = true; // Indexes are i64, and lengths never reach 2^63
+
+		// A place the body can change, rather than a temporary, e.g. 'numbers' or 'self.items'
+		p_loop->checked =
+			(lp_iterable->kind == FLATAST_VARIABLE || lp_iterable->kind == FLATAST_MEMBER)
+			&& loop_lowering___invalidates(p_ast, p_inference, p_types, lp_node->rhs,
+										   p_loop->binding, iterable);
+	}
+
+	p_self->counted++;
+
+	return p_loop->kind;
+}
+
+/**
+ * Checks whether two expressions name the same place, i.e. the same local or the same member of
+ * the same place, e.g. 'self.items'. A typed declaration, e.g. 'items: Array<i32>', names the local
+ * it declares, which can shadow the other.
+ *
+ * @param p_ast The AST containing the expressions.
+ * @param lhs   The first expression.
+ * @param rhs   The second expression.
+ *
+ * @return Whether the expressions name the same place.
+ */
+bool loop_lowering___same_place(const struct FlatAST* p_ast, flat_ast_index_t lhs,
+								flat_ast_index_t rhs) {
+	const struct FlatASTNode* lp_lhs = flat_ast_get(p_ast, lhs);
+	const struct FlatASTNode* lp_rhs = flat_ast_get(p_ast, rhs);
+
+	enum FlatASTKinds lhsKind = lp_lhs->kind == FLATAST_FIELD ? FLATAST_VARIABLE : lp_lhs->kind;
+	enum FlatASTKinds rhsKind = lp_rhs->kind == FLATAST_FIELD ? FLATAST_VARIABLE : lp_rhs->kind;
+
+	if (lhsKind != rhsKind || (lhsKind != FLATAST_VARIABLE && lhsKind != FLATAST_MEMBER)
+		|| strcmp(flat_ast_get_string(p_ast, lp_lhs->value.string),
+				  flat_ast_get_string(p_ast, lp_rhs->value.string))
+			   != 0) {
+		return false;
+	}
+
+	return lhsKind == FLATAST_VARIABLE
+		   || loop_lowering___same_place(p_ast, lp_lhs->lhs, lp_rhs->lhs);
+}
+
+/**
+ * Checks whether writing to an expression can change a place, i.e. it is the place or one of the
+ * places containing it, e.g. 'self' for 'self.items'.
+ *
+ * @param p_ast  The AST containing the expressions.
+ * @param target The expression written to.
+ * @param place  The place.
+ *
+ * @return Whether the write can change the place.
+ */
+bool loop_lowering___overlaps(const struct FlatAST* p_ast, flat_ast_index_t target,
+							  flat_ast_index_t place) {
+	while (true) {
+		if (loop_lowering___same_place(p_ast, target, place)) {
+			return true;
+		}
+
+		const struct FlatASTNode* lp_place = flat_ast_get(p_ast, place);
+
+		if (lp_place->kind != FLATAST_MEMBER) {
+			return false;
+		}
+
+		place = lp_place->lhs;
+	}
+}
+
+/**
+ * Checks whether a value may be an array, i.e. its type is an 'Array<T>' or was not inferred.
+ *
+ * @param p_types The module's type table.
+ * @param type    The type of the value.
+ *
+ * @return Whether the value may be an array.
+ */
+bool loop_lowering___may_be_array(const struct TypeTable* p_types, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return true;
+	}
+
+	const struct Type* lp_type = type_table_get(p_types, type);
+
+	return lp_type->kind == TYPE_NAMED
+		   && strcmp(interner_get(p_types->interner, lp_type->name), "Array") == 0;
+}
+
+/**
+ * Checks whether a value given to a call may reach an array: it is the array or one of the places
+ * containing it, e.g. 'self' for 'self.items', or it may refer to one of them through another name.
+ * Only primitives and vectors are known not to.
+ *
+ * @param p_ast       The AST containing the value.
+ * @param p_inference The inference the loop's function was inferred with.
+ * @param p_types     The module's type table.
+ * @param value       The value.
+ * @param array       The array.
+ *
+ * @return Whether the value may reach the array.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+bool loop_lowering___may_reach(const struct FlatAST* p_ast, const struct Inference* p_inference,
+							   const struct TypeTable* p_types, flat_ast_index_t value,
+							   flat_ast_index_t array) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	if (loop_lowering___overlaps(p_ast, value, array)) {
+		return true;
+	}
+
+	type_id_t type = inference_get_node_type(p_inference, value);
+
+	if (type == TYPE_ID_NONE) {
+		return true;
+	}
+
+	const struct Type* lp_type = type_table_get(p_types, type);
+
+	return lp_type->kind != TYPE_PRIMITIVE && lp_type->kind != TYPE_VECTOR;
+}
+
+/**
+ * Checks whether a node of a loop's body can invalidate an in bounds index: by writing to the
+ * index or to the array, or by a call that may reach the array (through its receiver or its
+ * arguments), other than reading or appending to an array.
+ *
+ * @param p_ast       The AST containing the body.
+ * @param p_inference The inference the loop's function was inferred with.
+ * @param p_types     The module's type table.
+ * @param node        The node.
+ * @param binding     The loop's binding.
+ * @param array       The array indexed.
+ *
+ * @return Whether the node can invalidate the index.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+bool loop_lowering___invalidates(const struct FlatAST* p_ast, const struct Inference* p_inference,
+								 const struct TypeTable* p_types, flat_ast_index_t node,
+								 flat_ast_index_t binding, flat_ast_index_t array) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	if (node == FLATAST_INDEX_NONE) {
+		return false;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_ASSIGNMENT: {
+		if (loop_lowering___overlaps(p_ast, lp_node->lhs, array)
+			|| loop_lowering___same_place(p_ast, lp_node->lhs, binding)) {
+			return true;
+		}
+
+		break;
+	}
+	case FLATAST_CALL: {
+		const struct FlatASTNode* lp_callee = flat_ast_get(p_ast, lp_node->lhs);
+
+		if (lp_callee->kind == FLATAST_MEMBER) { // e.g. 'self.pop()' for 'self.items'
+			const char* lp_method = flat_ast_get_string(p_ast, lp_callee->value.string);
+			bool		keeps	  = loop_lowering___may_be_array(
+							 p_types, inference_get_node_type(p_inference, lp_callee->lhs))
+						 && (strcmp(lp_method, "get") == 0 || strcmp(lp_method, "length") == 0
+							 || strcmp(lp_method, "append") == 0);
+
+			if (!keeps
+				&& loop_lowering___may_reach(p_ast, p_inference, p_types, lp_callee->lhs, array)) {
+				return true;
+			}
+		}
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			if (loop_lowering___may_reach(p_ast, p_inference, p_types,
+										  flat_ast_get_list_item(p_ast, lp_node, index), array)) {
+				return true;
+			}
+		}
+
+		break;
+	}
+	case FLATAST_FUNCTION: // May be called from anywhere
+		return true;
+	default:
+		break;
+	}
+
+	if (loop_lowering___invalidates(p_ast, p_inference, p_types, lp_node->lhs, binding, array)
+		|| loop_lowering___invalidates(p_ast, p_inference, p_types, lp_node->rhs, binding,
+									   array)) {
+		return true;
+	}
+
+	switch (lp_node->kind) {
+	case FLATAST_TYPE:
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_FOR:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			if (loop_lowering___invalidates(p_ast, p_inference, p_types,
+											flat_ast_get_list_item(p_ast, lp_node, index), binding,
+											array)) {
+				return true;
+			}
+		}
+
+		return false;
+	default:
+		return false;
+	}
+}
+
+bool loop_lowering_is_in_bounds(struct LoopLowering* p_self, const struct FlatAST* p_ast,
+								const struct Inference* p_inference,
+								const struct TypeTable* p_types, const struct CountedLoop* p_loop,
+								flat_ast_index_t call) {
+	const struct FlatASTNode* lp_call	= flat_ast_get(p_ast, call);
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_ast, lp_call->lhs);
+
+	if (lp_call->kind != FLATAST_CALL || lp_callee->kind != FLATAST_MEMBER
+		|| lp_call->value.list.length != 1
+		|| strcmp(flat_ast_get_string(p_ast, lp_callee->value.string), "get") != 0) {
+		PANIC("LoopLowering can only check the bounds of 'array.get(index)' calls");
+	}
+
+	p_self->accesses++;
+
+	if (p_loop->kind != LOOP_RANGE) {
+		return false;
+	}
+
+	// The index is the induction variable
+	const struct FlatASTNode* lp_index =
+		flat_ast_get(p_ast, flat_ast_get_list_item(p_ast, lp_call, 0));
+
+	if (lp_index->kind != FLATAST_VARIABLE
+		|| strcmp(flat_ast_get_string(p_ast, lp_index->value.string),
+				  flat_ast_get_string(p_ast, flat_ast_get(p_ast, p_loop->binding)->value.string))
+			   != 0) {
+		return false;
+	}
+
+	// Which starts at a non-negative constant
+	if (p_loop->start != FLATAST_INDEX_NONE
+		&& (flat_ast_get(p_ast, p_loop->start)->kind != FLATAST_INTEGER
+			|| flat_ast_get(p_ast, p_loop->start)->value.integer < 0)) {
+		return false;
+	}
+
+	// And stops at 'array.length()' or 'array.length'
+	const struct FlatASTNode* lp_end = flat_ast_get(p_ast, p_loop->end);
+
+	if (lp_end->kind == FLATAST_CALL && lp_end->value.list.length == 0) {
+		lp_end = flat_ast_get(p_ast, lp_end->lhs);
+	}
+
+	if (lp_end->kind != FLATAST_MEMBER
+		|| strcmp(flat_ast_get_string(p_ast, lp_end->value.string), "length") != 0
+		|| !loop_lowering___same_place(p_ast, lp_end->lhs, lp_callee->lhs)) {
+		return false;
+	}
+
+	// Which the body cannot shrink
+	if (loop_lowering___invalidates(p_ast, p_inference, p_types,
+									flat_ast_get(p_ast, p_loop->node)->rhs, p_loop->binding,
+									lp_callee->lhs)) {
+		return false;
+	}
+
+	p_self->inBoundsAccesses++;
+
+	return true;
+}
+
+void loop_lowering_emit_access(bool inBounds, const char* p_elementType, const char* p_array,
+							   const char* p_index, const char* p_result, struct String* p_output) {
+	if (!inBounds) {
+		// %x.raw = call i8* @array_SEP_get(%array* %a, i64 %i, i64 SIZE)
+		string_append_str(p_output, "  ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, ".raw = call i8* @array_SEP_get(%array* ");
+		string_append_str(p_output, p_array);
+		string_append_str(p_output, ", i64 ");
+		string_append_str(p_output, p_index);
+		string_append_str(p_output, ", i64 ptrtoint (");
+		string_append_str(p_output, p_elementType);
+		string_append_str(p_output, "* getelementptr (");
+		string_append_str(p_output, p_elementType);
+		string_append_str(p_output, ", ");
+		string_append_str(p_output, p_elementType);
+		string_append_str(p_output, "* null, i32 1) to i64))\n");
+
+		// %x = bitcast i8* %x.raw to T*
+		string_append_str(p_output, "  ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, " = bitcast i8* ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, ".raw to ");
+		string_append_str(p_output, p_elementType);
+		string_append_str(p_output, "*\n");
+
+		return;
+	}
+
+	// %x.data.ptr = getelementptr inbounds %array, %array* %a, i64 0, i32 0
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".data.ptr = getelementptr inbounds %array, %array* ");
+	string_append_str(p_output, p_array);
+	string_append_str(p_output, ", i64 0, i32 0\n");
+
+	// %x.data = load i8*, i8** %x.data.ptr
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".data = load i8*, i8** ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".data.ptr\n");
+
+	// %x.elements = bitcast i8* %x.data to T*
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".elements = bitcast i8* ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".data to ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, "*\n");
+
+	// %x = getelementptr inbounds T, T* %x.elements, i64 %i
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = getelementptr inbounds ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, "* ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, ".elements, i64 ");
+	string_append_str(p_output, p_index);
+	string_append_chr(p_output, '\n');
+}
+
+char* loop_lowering_get_label(const struct CountedLoop* p_loop, const char* p_block) {
+	char* lp_id	   = ul_to_string(p_loop->id);
+	char* lp_label = CONCATENATE_STRING("loop.", lp_id, ".", p_block);
+
+	free(lp_id);
+
+	return lp_label;
+}
+
+/**
+ * Appends one of a counted loop's labels or values, e.g. '%loop.3.next'.
+ *
+ * @param p_loop   The loop.
+ * @param p_prefix What to prefix the name with, e.g. '%' or 'label %'.
+ * @param p_name   The name within the loop, e.g. 'next'.
+ * @param p_output Where to append the name.
+ */
+void loop_lowering___append(const struct CountedLoop* p_loop, const char* p_prefix,
+							const char* p_name, struct String* p_output) {
+	char* lp_label = loop_lowering_get_label(p_loop, p_name);
+
+	string_append_str(p_output, p_prefix);
+	string_append_str(p_output, lp_label);
+
+	free(lp_label);
+}
+
+void loop_lowering_emit_begin(struct LoopLowering* p_self, struct CountedLoop* p_loop,
+							  const char* p_llvmType, const char* p_start, const char* p_end,
+							  const char* p_index, struct String* p_output) {
+	p_loop->id		 = p_self->emitted++;
+	p_loop->llvmType = p_llvmType;
+	p_loop->index	 = p_index;
+	p_loop->bound	 = p_end;
+
+	// br label %loop.N.preheader
+	loop_lowering___append(p_loop, "  br label %", "preheader", p_output);
+	string_append_chr(p_output, '\n');
+
+	// loop.N.preheader:
+	loop_lowering___append(p_loop, "", "preheader", p_output);
+	string_append_str(p_output, ":\n");
+
+	// %loop.N.empty = icmp sge TYPE start, end
+	loop_lowering___append(p_loop, "  %", "empty", p_output);
+	string_append_str(p_output, p_loop->isSigned ? " = icmp sge " : " = icmp uge ");
+	string_append_str(p_output, p_llvmType);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, p_start);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_end);
+	string_append_chr(p_output, '\n');
+
+	// br i1 %loop.N.empty, label %loop.N.exit, label %loop.N.body
+	loop_lowering___append(p_loop, "  br i1 %", "empty", p_output);
+	loop_lowering___append(p_loop, ", label %", "exit", p_output);
+	loop_lowering___append(p_loop, ", label %", "body", p_output);
+	string_append_chr(p_output, '\n');
+
+	// loop.N.body:
+	loop_lowering___append(p_loop, "", "body", p_output);
+	string_append_str(p_output, ":\n");
+
+	// %i = phi TYPE [ start, %loop.N.preheader ], [ %loop.N.next, %loop.N.latch ]
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_index);
+	string_append_str(p_output, " = phi ");
+	string_append_str(p_output, p_llvmType);
+	string_append_str(p_output, " [ ");
+	string_append_str(p_output, p_start);
+	loop_lowering___append(p_loop, ", %", "preheader", p_output);
+	loop_lowering___append(p_loop, " ], [ %", "next", p_output);
+	loop_lowering___append(p_loop, ", %", "latch", p_output);
+	string_append_str(p_output, " ]\n");
+}
+
+void loop_lowering_emit_check(const struct CountedLoop* p_loop, const char* p_array,
+							  struct String* p_output) {
+	if (p_loop->kind != LOOP_ARRAY || !p_loop->checked) {
+		PANIC("LoopLowering can only emit the checks of checked array loops");
+	}
+
+	// %loop.N.length = call i64 @array_SEP_length(%array* ARRAY)
+	loop_lowering___append(p_loop, "  %", "length", p_output);
+	string_append_str(p_output, " = call i64 @array_SEP_length(%array* ");
+	string_append_str(p_output, p_array);
+	string_append_str(p_output, ")\n");
+
+	// %loop.N.inside = icmp slt i64 %i, %loop.N.length
+	loop_lowering___append(p_loop, "  %", "inside", p_output);
+	string_append_str(p_output, " = icmp slt i64 ");
+	string_append_str(p_output, p_loop->index);
+	loop_lowering___append(p_loop, ", %", "length", p_output);
+	string_append_chr(p_output, '\n');
+
+	// br i1 %loop.N.inside, label %loop.N.element, label %loop.N.exit
+	loop_lowering___append(p_loop, "  br i1 %", "inside", p_output);
+	loop_lowering___append(p_loop, ", label %", "element", p_output);
+	loop_lowering___append(p_loop, ", label %", "exit", p_output);
+	string_append_chr(p_output, '\n');
+
+	// loop.N.element:
+	loop_lowering___append(p_loop, "", "element", p_output);
+	string_append_str(p_output, ":\n");
+}
+
+void loop_lowering_emit_element(const struct CountedLoop* p_loop, const char* p_elementType,
+								const char* p_data, const char* p_binding,
+								struct String* p_output) {
+	if (p_loop->kind != LOOP_ARRAY) {
+		PANIC("LoopLowering can only emit elements of array loops");
+	}
+
+	// %x.ptr = getelementptr inbounds T, T* %data, TYPE %i
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_binding);
+	string_append_str(p_output, ".ptr = getelementptr inbounds ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, "* ");
+	string_append_str(p_output, p_data);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_loop->llvmType);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, p_loop->index);
+	string_append_chr(p_output, '\n');
+
+	// %x = load T, T* %x.ptr
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_binding);
+	string_append_str(p_output, " = load ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_elementType);
+	string_append_str(p_output, "* ");
+	string_append_str(p_output, p_binding);
+	string_append_str(p_output, ".ptr\n");
+}
+
+void loop_lowering_emit_end(const struct CountedLoop* p_loop, struct String* p_output) {
+	// br label %loop.N.latch
+	loop_lowering___append(p_loop, "  br label %", "latch", p_output);
+	string_append_chr(p_output, '\n');
+
+	// loop.N.latch:
+	loop_lowering___append(p_loop, "", "latch", p_output);
+	string_append_str(p_output, ":\n");
+
+	// %loop.N.next = add nsw TYPE %i, 1 (the range test below means it cannot overflow)
+	loop_lowering___append(p_loop, "  %", "next", p_output);
+	string_append_str(p_output, p_loop->isSigned ? " = add nsw " : " = add nuw ");
+	string_append_str(p_output, p_loop->llvmType);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, p_loop->index);
+	string_append_str(p_output, ", 1\n");
+
+	// %loop.N.done = icmp eq TYPE %loop.N.next, end (exact, so the trip count is end - start)
+	loop_lowering___append(p_loop, "  %", "done", p_output);
+	string_append_str(p_output, " = icmp eq ");
+	string_append_str(p_output, p_loop->llvmType);
+	loop_lowering___append(p_loop, " %", "next", p_output);
+	string_append_str(p_output, ", ");
+	string_append_str(p_output, p_loop->bound);
+	string_append_chr(p_output, '\n');
+
+	// br i1 %loop.N.done, label %loop.N.exit, label %loop.N.body
+	loop_lowering___append(p_loop, "  br i1 %", "done", p_output);
+	loop_lowering___append(p_loop, ", label %", "exit", p_output);
+	loop_lowering___append(p_loop, ", label %", "body", p_output);
+	string_append_chr(p_output, '\n');
+
+	// loop.N.exit:
+	loop_lowering___append(p_loop, "", "exit", p_output);
+	string_append_str(p_output, ":\n");
+}
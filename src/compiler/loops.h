@@ -0,0 +1,204 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOOP_PARALLEL_METHOD "par" // 'for numbers.par() => n' runs the iterations in parallel.
+
+/**
+ * Used to identify the kinds of for loops.
+ */
+enum LoopKinds {
+	LOOP_GENERIC, // Iterates anything else, through its iterator.
+	LOOP_RANGE,	  // 'for range(a, b) => i', counts from a to b.
+	LOOP_ARRAY,	  // 'for array => x', counts over the indexes of an 'Array<T>'.
+};
+
+/**
+ * Represents a for loop that can be lowered to a counted loop, i.e. a single integer induction
+ * variable stepping by one towards a bound computed once, which LLVM can unroll and vectorize.
+ */
+struct CountedLoop {
+	uint8_t			 kind;	   // enum LoopKinds
+	flat_ast_index_t node;	   // The for loop.
+	flat_ast_index_t binding;  // The loop's binding.
+	flat_ast_index_t start;	   // The first index, FLATAST_INDEX_NONE for 0.
+	flat_ast_index_t end;	   // The index to stop at, FLATAST_INDEX_NONE for the array length.
+	flat_ast_index_t iterable; // The array, for array loops.
+	type_id_t		 type;	   // The type of the induction variable, or of the array's elements.
+	bool			 isSigned; // Whether the induction variable is signed.
+	bool			 parallel; // Whether the loop iterates '.par()', see parallel.h.
+	bool			 checked;  // Whether the body may shrink or replace the array, see below.
+	size_t			 id;	   // Unique id of the loop, for its labels.
+	const char*		 llvmType; // The LLVM type of the induction variable.
+	const char*		 index;	   // The induction variable.
+	const char*		 bound;	   // The value of the end index.
+};
+
+#define COUNTED_LOOP_SIZE sizeof(struct CountedLoop)
+
+/**
+ * Represents the lowering of for loops.
+ */
+struct LoopLowering {
+	size_t emitted; // Counted loops emitted, for unique labels.
+	size_t loops, counted, accesses, inBoundsAccesses; // For the time report.
+};
+
+#define LOOPLOWERING_STRUCT_SIZE sizeof(struct LoopLowering)
+
+/**
+ * Creates a new LoopLowering struct.
+ *
+ * @return The created LoopLowering struct.
+ */
+struct LoopLowering* loop_lowering_new(void);
+
+/**
+ * Frees a LoopLowering struct.
+ *
+ * @param p_self The current LoopLowering struct.
+ */
+void loop_lowering_free(struct LoopLowering** p_self);
+
+/**
+ * Gets what a parallel loop iterates, i.e. the receiver of its '.par()' call, e.g. 'numbers' for
+ * 'for numbers.par() => n'.
+ *
+ * @param p_ast    The AST containing the loop.
+ * @param iterable The loop's iterable.
+ *
+ * @return The receiver, FLATAST_INDEX_NONE if the iterable is not a '.par()' call.
+ */
+flat_ast_index_t loop_lowering_get_parallel_source(const struct FlatAST* p_ast,
+												   flat_ast_index_t iterable);
+
+/**
+ * Recognises a for loop of the last inferred function that can be lowered to a counted loop. The
+ * iterable of a parallel loop is analysed through its '.par()' call. An array loop is checked when
+ * its body may shrink or replace the array, e.g. 'numbers.remove(0)' or 'numbers = [9]'.
+ *
+ * @param p_self      The current LoopLowering struct.
+ * @param p_ast       The AST containing the loop.
+ * @param p_inference The inference the loop's function was inferred with.
+ * @param p_types     The module's type table.
+ * @param node        The loop's node.
+ * @param p_loop      Where to write the loop.
+ *
+ * @return The kind of the loop, LOOP_GENERIC if it cannot be lowered to a counted loop.
+ */
+enum LoopKinds loop_lowering_analyse(struct LoopLowering* p_self, const struct FlatAST* p_ast,
+									 const struct Inference* p_inference,
+									 const struct TypeTable* p_types, flat_ast_index_t node,
+									 struct CountedLoop* p_loop);
+
+/**
+ * Checks whether an 'array.get(index)' call in the body of a counted loop is always in bounds, so
+ * it can skip its bounds check. That is the case when the index is the loop's induction variable,
+ * the loop starts at a non-negative constant and stops at the length of the same array, and the
+ * body cannot reassign the index or the array, nor make a call that may reach the array (e.g.
+ * 'self.pop()' for 'self.items') other than reading or appending to it.
+ *
+ * @param p_self      The current LoopLowering struct.
+ * @param p_ast       The AST containing the loop.
+ * @param p_inference The inference the loop's function was inferred with.
+ * @param p_types     The module's type table.
+ * @param p_loop      The innermost counted loop containing the call.
+ * @param call        The call's node.
+ *
+ * @return Whether the call is always in bounds.
+ */
+bool loop_lowering_is_in_bounds(struct LoopLowering* p_self, const struct FlatAST* p_ast,
+								const struct Inference* p_inference,
+								const struct TypeTable* p_types, const struct CountedLoop* p_loop,
+								flat_ast_index_t call);
+
+/**
+ * Emits the address of an element of an array: a direct index into its elements if the access is
+ * in bounds, a call to the runtime's checked 'array.get' otherwise.
+ *
+ * @param inBounds      Whether the access is in bounds, from loop_lowering_is_in_bounds.
+ * @param p_elementType The LLVM type of the array's elements, e.g. 'i32'.
+ * @param p_array       The pointer to the array, e.g. '%numbers'.
+ * @param p_index       The 'i64' index, e.g. '%i'.
+ * @param p_result      The name of the pointer to the element, e.g. '%number.ptr'.
+ * @param p_output      Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void loop_lowering_emit_access(bool inBounds, const char* p_elementType, const char* p_array,
+							   const char* p_index, const char* p_result, struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the start of a counted loop, up to the start of its body. The current block is ended with
+ * a branch to the loop, and the body is skipped entirely if the range is empty.
+ *
+ * @param p_self     The current LoopLowering struct.
+ * @param p_loop     The loop.
+ * @param p_llvmType The LLVM type of the induction variable, e.g. 'i64'.
+ * @param p_start    The value of the first index, e.g. '0'.
+ * @param p_end      The value of the index to stop at. It is only evaluated once.
+ * @param p_index    The name of the induction variable, e.g. '%i'.
+ * @param p_output   Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void loop_lowering_emit_begin(struct LoopLowering* p_self, struct CountedLoop* p_loop,
+							  const char* p_llvmType, const char* p_start, const char* p_end,
+							  const char* p_index, struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the check of a checked array loop, at the start of its body: the loop exits once the index
+ * reaches the length the array has now, rather than when the loop started.
+ *
+ * @param p_loop   The loop.
+ * @param p_array  The array, evaluated again for this iteration, e.g. '%numbers'.
+ * @param p_output Where to append the IR.
+ */
+void loop_lowering_emit_check(const struct CountedLoop* p_loop, const char* p_array,
+							  struct String* p_output);
+
+/**
+ * Emits the load of the current element of an array loop, at the start of its body.
+ *
+ * @param p_loop        The loop.
+ * @param p_elementType The LLVM type of the array's elements, e.g. 'i32'.
+ * @param p_data        The pointer to the array's elements, e.g. '%data'.
+ * @param p_binding     The name of the loop's binding, e.g. '%x'.
+ * @param p_output      Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void loop_lowering_emit_element(const struct CountedLoop* p_loop, const char* p_elementType,
+								const char* p_data, const char* p_binding,
+								struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the end of a counted loop after its body: the increment of the induction variable and the
+ * exit test. 'continue' branches to the label returned by loop_lowering_get_label with "latch",
+ * 'break' to the one with "exit".
+ *
+ * @param p_loop   The loop.
+ * @param p_output Where to append the IR.
+ */
+void loop_lowering_emit_end(const struct CountedLoop* p_loop, struct String* p_output);
+
+/**
+ * Gets the name of one of a counted loop's blocks.
+ *
+ * @param p_loop  The loop.
+ * @param p_block The block, "preheader", "body", "latch" or "exit".
+ *
+ * @return The label, e.g. 'loop.3.exit'.
+ */
+char* loop_lowering_get_label(const struct CountedLoop* p_loop, const char* p_block);
@@ -0,0 +1,642 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./lto.h"
+#include "./compiler.h"
+#include "../utils/conversions.h"
+#include "../utils/files.h"
+#include "../utils/panic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#define LTO_PATH_SEPARATOR "\\"
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define LTO_PATH_SEPARATOR "/"
+
+extern char** environ; // Passed on to the driver.
+#endif
+
+#define LTO_COMPILE_ARGUMENTS 9U // The driver's arguments to compile a module, with the NULL.
+#define LTO_LINE_LENGTH		  1024U
+
+// X-Macro to define mode names
+static char* const g_LTO_MODE_NAMES_INTERNAL[] = {
+#define LTO_MODE_TO_STRING(name, string) string,
+	LTO_MODES(LTO_MODE_TO_STRING)
+#undef LTO_MODE_TO_STRING
+};
+
+const struct Array g_LTO_MODE_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_LTO_MODE_NAMES_INTERNAL,
+						sizeof(g_LTO_MODE_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* lto_mode_get_name(const enum LtoModes MODE) {
+	if ((size_t)MODE + 1 > g_LTO_MODE_NAMES.length) {
+		PANIC("g_LTO_MODE_NAMES get index out of bounds");
+	}
+
+	return g_LTO_MODE_NAMES._values[MODE];
+}
+
+bool lto_mode_parse(const char* p_name, enum LtoModes* p_mode) {
+	if (!*p_name) {
+		*p_mode = LTO_NONE;
+
+		return true;
+	}
+
+	for (size_t index = 0; index < g_LTO_MODE_NAMES.length; index++) {
+		if (strcmp(p_name, g_LTO_MODE_NAMES._values[index]) == 0) {
+			*p_mode = (enum LtoModes)index;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Gets how many modules can be compiled, and optimised, at once: one per online processor.
+ *
+ * @return The number of jobs, at least one.
+ */
+size_t lto___jobs(void) {
+#ifdef _WIN32
+	const char* lp_processors = getenv("NUMBER_OF_PROCESSORS"); // NOLINT(concurrency-mt-unsafe)
+	long		processors	  = lp_processors ? strtol(lp_processors, NULL, 10) : 1;
+#else
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	return processors > 0 ? (size_t)processors : 1;
+}
+
+struct Lto* lto_new(const enum LtoModes MODE, struct Cache* p_cache, struct Report* p_report,
+					const char* p_outputPath, const char* p_targetFeatures) {
+	struct Lto* lp_self = calloc(1, LTO_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Lto struct");
+	}
+
+	lp_self->mode		= MODE;
+	lp_self->cache		= p_cache;
+	lp_self->report		= p_report;
+	lp_self->outputPath = duplicate_string(p_outputPath);
+	lp_self->features	= duplicate_string(p_targetFeatures);
+	lp_self->inputs		= array_new();
+	lp_self->outputs	= array_new();
+	lp_self->bitcodes	= array_new();
+	lp_self->temporary	= array_new();
+	lp_self->jobs		= lto___jobs();
+
+	return lp_self;
+}
+
+/**
+ * Frees an array of paths, and the paths.
+ *
+ * @param p_paths The array to free.
+ */
+void lto___free_paths(struct Array** p_paths) {
+	for (size_t index = 0; index < (*p_paths)->length; index++) {
+		free((void*)(*p_paths)->_values[index]); // NOLINT(clang-diagnostic-cast-qual)
+	}
+
+	array_free(p_paths);
+}
+
+/**
+ * Removes the intermediate files written next to the program, e.g. before exiting with an error.
+ *
+ * @param p_self The current Lto struct.
+ */
+void lto___remove_temporary(const struct Lto* p_self) {
+	for (size_t index = 0; index < p_self->temporary->length; index++) {
+		remove(p_self->temporary->_values[index]);
+	}
+}
+
+void lto_free(struct Lto** p_self) {
+	if (p_self && *p_self) {
+		lto___remove_temporary(*p_self);
+
+		free((*p_self)->outputPath);
+		free((*p_self)->features);
+		lto___free_paths(&(*p_self)->inputs);
+		array_free(&(*p_self)->outputs); // Its paths belong to 'bitcodes'
+		lto___free_paths(&(*p_self)->bitcodes);
+		lto___free_paths(&(*p_self)->temporary);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Lto struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether a file exists.
+ *
+ * @param p_filePath The path of the file.
+ *
+ * @return Whether the file exists.
+ */
+bool lto___exists(const char* p_filePath) {
+	FILE* lp_filePointer = fopen(p_filePath, "rb");
+
+	if (!lp_filePointer) {
+		return false;
+	}
+
+	fclose_safe(lp_filePointer);
+
+	return true;
+}
+
+/**
+ * Gets the name of the bitcode artifact of a mode, in a compilation cache entry.
+ *
+ * @param MODE The mode.
+ *
+ * @return The name of the artifact.
+ */
+const char* lto___artifact(const enum LtoModes MODE) {
+	switch (MODE) {
+	case LTO_THIN:
+		return CACHE_ARTIFACT_THIN_BITCODE;
+	case LTO_FULL:
+		return CACHE_ARTIFACT_FULL_BITCODE;
+	default:
+		return CACHE_ARTIFACT_OBJECT;
+	}
+}
+
+/**
+ * Gets the extension of the files modules are compiled to in a mode: objects without LTO, else
+ * bitcode.
+ *
+ * @param MODE The mode.
+ *
+ * @return The extension.
+ */
+const char* lto___extension(const enum LtoModes MODE) {
+	return MODE == LTO_NONE ? ".o" : ".bc";
+}
+
+/**
+ * Gets the driver's flag selecting a mode.
+ *
+ * @param MODE The mode.
+ *
+ * @return The flag.
+ */
+char* lto___flag(const enum LtoModes MODE) {
+	return MODE == LTO_NONE ? duplicate_string("-fno-lto")
+							: CONCATENATE_STRING("-flto=", lto_mode_get_name(MODE));
+}
+
+/**
+ * Adds a module's bitcode to the program, compiling it first if it does not exist yet.
+ *
+ * @param p_self      The current Lto struct.
+ * @param p_input     The module's IR or bitcode, taken over by the Lto struct.
+ * @param p_bitcode   The path of the module's bitcode, taken over by the Lto struct.
+ * @param temporary   Whether the bitcode is removed once linked.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void lto___add(struct Lto* p_self, char* p_input, char* p_bitcode, bool temporary) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	array_append(p_self->bitcodes, p_bitcode);
+
+	if (temporary) {
+		array_append(p_self->temporary, duplicate_string(p_bitcode));
+	}
+
+	if (!temporary && lto___exists(p_bitcode)) {
+		p_self->reused++;
+		free(p_input);
+
+		return;
+	}
+
+	array_append(p_self->inputs, p_input);
+	array_append(p_self->outputs, p_bitcode);
+}
+
+/**
+ * Gets the path of a temporary file next to the program, e.g. 'main.1234.1.thin.bc' for 'main'
+ * linked by process 1234, so builds of the same program at once do not share it.
+ *
+ * @param p_self      The current Lto struct.
+ * @param p_name      What the file holds, e.g. a module's index or 'std'.
+ * @param p_extension The file's extension, e.g. '.ll'.
+ *
+ * @return The path of the file.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+char* lto___temporary_path(const struct Lto* p_self, const char* p_name, const char* p_extension) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char* lp_pid  = ul_to_string((size_t)getpid());
+	char* lp_path = CONCATENATE_STRING(p_self->outputPath, ".", lp_pid, ".", p_name, ".",
+									   lto_mode_get_name(p_self->mode), p_extension);
+
+	free(lp_pid);
+
+	return lp_path;
+}
+
+char* lto_program_path(const char* p_filePath) {
+	const char* lp_separator   = strrchr(p_filePath, *LTO_PATH_SEPARATOR);
+	char*		lp_programPath = duplicate_string(lp_separator ? lp_separator + 1 : p_filePath);
+	char*		lp_extension   = strrchr(lp_programPath, '.');
+
+	if (lp_extension && lp_extension > lp_programPath) {
+		*lp_extension = '\0';
+	}
+
+	return lp_programPath;
+}
+
+void lto_add_module(struct Lto* p_self, const char* p_cacheKey, const struct String* p_output) {
+	if (p_output->length == 0) { // Every link would fail on the missing 'main'
+		lto___remove_temporary(p_self);
+		error("linking needs the module's LLVM IR, but code generation did not emit any");
+	}
+
+	if (p_self->cache && p_cacheKey) {
+		char* lp_input = cache_artifact_path(p_self->cache, p_cacheKey, CACHE_ARTIFACT_IR);
+
+		if (lto___exists(lp_input)) { // Stored by compiler_finish, unless storing it failed
+			lto___add(p_self, lp_input,
+					  cache_artifact_path(p_self->cache, p_cacheKey, lto___artifact(p_self->mode)),
+					  false);
+
+			return;
+		}
+
+		free(lp_input);
+	}
+
+	char* lp_index = ul_to_string(p_self->bitcodes->length);
+	char* lp_input = lto___temporary_path(p_self, lp_index, ".ll");
+
+	if (!file_write_atomic(lp_input, p_output->_value, p_output->length)) {
+		lto___remove_temporary(p_self);
+		error(CONCATENATE_STRING("failed to write '", lp_input, "' for linking"));
+	}
+
+	array_append(p_self->temporary, duplicate_string(lp_input));
+	lto___add(p_self, lp_input,
+			  lto___temporary_path(p_self, lp_index, lto___extension(p_self->mode)), true);
+
+	free(lp_index);
+}
+
+/**
+ * Adds IR or bitcode generated outside the module to the program, e.g. the runtime. It is compiled
+ * once for each mode into the compilation cache, keyed on its contents like a module, so it is
+ * compiled again whenever it changes.
+ *
+ * @param p_self            The current Lto struct.
+ * @param p_input           The path of the IR or bitcode, taken over by the Lto struct.
+ * @param p_name            What it holds, naming its temporary bitcode without a cache, e.g. 'std'.
+ * @param p_compilerVersion The version of the compiler.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void lto___add_file(struct Lto* p_self, char* p_input, const char* p_name,
+					const char* p_compilerVersion) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char* lp_cacheKey =
+		p_self->cache ? cache_module_key(p_input, p_compilerVersion, LTO_FILE_FLAGS, NULL) : NULL;
+
+	if (lp_cacheKey) {
+		char* lp_bitcode =
+			cache_artifact_path(p_self->cache, lp_cacheKey, lto___artifact(p_self->mode));
+		char* lp_entry = duplicate_string(lp_bitcode);
+
+		*strrchr(lp_entry, *LTO_PATH_SEPARATOR) = '\0';
+
+		if (directory_create(lp_entry)) {
+			lto___add(p_self, p_input, lp_bitcode, false);
+			p_input = NULL;
+		} else {
+			free(lp_bitcode);
+		}
+
+		free(lp_entry);
+		free(lp_cacheKey);
+	}
+
+	if (p_input) {
+		lto___add(p_self, p_input,
+				  lto___temporary_path(p_self, p_name, lto___extension(p_self->mode)), true);
+	}
+}
+
+void lto_add_imports(struct Lto* p_self, const struct Array* p_paths,
+					 const char* p_compilerVersion) {
+	for (size_t index = 0; index < p_paths->length; index++) {
+		const char* lp_path = p_paths->_values[index];
+
+		if (!lto___exists(lp_path)) { // Written with its interface, so it was removed since
+			lto___remove_temporary(p_self);
+			error(CONCATENATE_STRING("imported module's LLVM IR '", lp_path,
+									 "' not found, compile the module again"));
+		}
+
+		char* lp_index = ul_to_string(index);
+		char* lp_name  = CONCATENATE_STRING("import.", lp_index);
+
+		lto___add_file(p_self, duplicate_string(lp_path), lp_name, p_compilerVersion);
+		free(lp_name);
+		free(lp_index);
+	}
+}
+
+void lto_add_entry(struct Lto* p_self, const struct String* p_entry,
+				   const char* p_compilerVersion) {
+	if (p_entry->length == 0) { // The module has no 'main', which the link reports
+		return;
+	}
+
+	char* lp_input = lto___temporary_path(p_self, "main", ".ll");
+
+	if (!file_write_atomic(lp_input, p_entry->_value, p_entry->length)) {
+		lto___remove_temporary(p_self);
+		error(CONCATENATE_STRING("failed to write '", lp_input, "' for linking"));
+	}
+
+	array_append(p_self->temporary, duplicate_string(lp_input));
+	lto___add_file(p_self, lp_input, "main", p_compilerVersion);
+}
+
+void lto_add_runtime(struct Lto* p_self, const char* p_stdlib, const char* p_compilerVersion) {
+	char* lp_runtime =
+		CONCATENATE_STRING(p_stdlib, LTO_PATH_SEPARATOR, COMPILER_RUNTIME_BITCODE);
+
+	if (!lto___exists(lp_runtime)) {
+		lto___remove_temporary(p_self);
+		error(CONCATENATE_STRING("runtime bitcode '", lp_runtime,
+								 "' not found (see '--stdlib', it is built with the compiler)"));
+	}
+
+	lto___add_file(p_self, lp_runtime, "std", p_compilerVersion);
+}
+
+/**
+ * Starts a process, searching the PATH for its program.
+ *
+ * @param p_arguments The program and its arguments, ending with NULL.
+ *
+ * @return The process, or -1 if it could not be started.
+ */
+intptr_t lto___spawn(char* const* p_arguments) {
+#ifdef _WIN32
+	return _spawnvp(_P_NOWAIT, p_arguments[0], (const char* const*)p_arguments);
+#else
+	pid_t process = 0;
+
+	return posix_spawnp(&process, p_arguments[0], NULL, NULL, p_arguments, environ) == 0
+			   ? (intptr_t)process
+			   : -1;
+#endif
+}
+
+/**
+ * Waits for a process to exit.
+ *
+ * @param process  The process, from lto___spawn.
+ * @param p_signal Where to write the signal that terminated it, else 0 (can be NULL).
+ *
+ * @return Whether it succeeded.
+ */
+bool lto___wait(intptr_t process, int* p_signal) {
+	if (p_signal) {
+		*p_signal = 0;
+	}
+
+	if (process == -1) {
+		return false;
+	}
+
+	int status = 0;
+
+#ifdef _WIN32
+	return _cwait(&status, process, 0) != -1 && status == 0;
+#else
+	if (waitpid((pid_t)process, &status, 0) == -1) {
+		return false;
+	}
+
+	if (WIFSIGNALED(status) && p_signal) {
+		*p_signal = WTERMSIG(status);
+	}
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+}
+
+/**
+ * Compiles the modules not compiled yet, at most one per job at once. Each is written next to its
+ * bitcode, then renamed over it, so builds sharing the cache never link a partial module.
+ *
+ * @param p_self The current Lto struct.
+ */
+void lto___compile(struct Lto* p_self) {
+	size_t	  count		   = p_self->inputs->length;
+	intptr_t* lp_processes = calloc(count ? count : 1, sizeof(intptr_t));
+	char**	  lp_temporary = calloc(count ? count : 1, sizeof(char*));
+
+	if (!lp_processes || !lp_temporary) {
+		PANIC("failed to malloc Lto processes");
+	}
+
+	char* lp_pid = ul_to_string((size_t)getpid());
+	char* lp_lto = lto___flag(p_self->mode);
+
+	for (size_t started = 0, waited = 0; waited < count;) {
+		if (started < count && started - waited < p_self->jobs) {
+			lp_temporary[started] =
+				CONCATENATE_STRING(p_self->outputs->_values[started], ".", lp_pid, ".tmp");
+
+			char* const lp_arguments[LTO_COMPILE_ARGUMENTS] = {
+				LTO_DRIVER,
+				lp_lto,
+				"-O2",
+				"-Wno-override-module",
+				"-c",
+				(char*)p_self->inputs->_values[started], // NOLINT(clang-diagnostic-cast-qual)
+				"-o",
+				lp_temporary[started],
+				NULL};
+
+			lp_processes[started] = lto___spawn(lp_arguments);
+			started++;
+
+			continue;
+		}
+
+		bool compiled = lto___wait(lp_processes[waited], NULL);
+
+		if (compiled && rename(lp_temporary[waited], p_self->outputs->_values[waited]) != 0) {
+#ifdef _WIN32
+			remove(p_self->outputs->_values[waited]); // Windows' rename does not replace a file
+			compiled = rename(lp_temporary[waited], p_self->outputs->_values[waited]) == 0;
+#else
+			compiled = false;
+#endif
+		}
+
+		if (!compiled) { // Reaps the modules still compiling, so none writes after the exit
+			for (size_t other = waited; other < started; other++) {
+				if (other != waited) {
+					lto___wait(lp_processes[other], NULL);
+				}
+
+				remove(lp_temporary[other]);
+			}
+
+			lto___remove_temporary(p_self);
+			error(CONCATENATE_STRING("'" LTO_DRIVER "' failed to compile '",
+									 p_self->inputs->_values[waited], "' to bitcode"));
+		}
+
+		free(lp_temporary[waited]);
+		waited++;
+	}
+
+	p_self->compiled += count;
+
+	free(lp_lto);
+	free(lp_pid);
+	free(lp_temporary);
+	free(lp_processes);
+}
+
+/**
+ * Appends an argument to the linker's command line, keeping it to free it once linked.
+ *
+ * @param p_arguments The command line.
+ * @param p_owned     The arguments to free.
+ * @param p_argument  The argument, taken over.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void lto___argument(struct Array* p_arguments, struct Array* p_owned, char* p_argument) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	array_append(p_arguments, p_argument);
+	array_append(p_owned, p_argument);
+}
+
+void lto_link(struct Lto* p_self) {
+	uint64_t startTime = report_clock();
+
+	lto___compile(p_self);
+
+	struct Array* lp_arguments = array_new();
+	struct Array* lp_owned	   = array_new();
+	char*		  lp_jobs	   = ul_to_string(p_self->jobs);
+
+	array_append(lp_arguments, LTO_DRIVER);
+	lto___argument(lp_arguments, lp_owned, lto___flag(p_self->mode));
+	array_append(lp_arguments, "-O2");
+
+	if (p_self->mode != LTO_NONE) { // Only lld reads both kinds of summaries
+		array_append(lp_arguments, "-fuse-ld=lld");
+	}
+
+	for (size_t index = 0; index < p_self->bitcodes->length; index++) {
+		array_append(lp_arguments, p_self->bitcodes->_values[index]);
+	}
+
+	array_append(lp_arguments, "-o");
+	array_append(lp_arguments, p_self->outputPath);
+
+	if (p_self->mode == LTO_THIN) {
+#ifdef _WIN32
+		lto___argument(lp_arguments, lp_owned, CONCATENATE_STRING("-Wl,/opt:lldltojobs=", lp_jobs));
+#else
+		lto___argument(lp_arguments, lp_owned, CONCATENATE_STRING("-Wl,--thinlto-jobs=", lp_jobs));
+#endif
+
+		if (p_self->cache) { // Modules whose imports did not change are not optimised again
+			char* lp_cache =
+				CONCATENATE_STRING(p_self->cache->directory, LTO_PATH_SEPARATOR LTO_CACHE);
+
+#ifdef _WIN32
+			lto___argument(lp_arguments, lp_owned,
+						   CONCATENATE_STRING("-Wl,/lldltocache:", lp_cache));
+			array_append(lp_arguments, "-Wl,/lldltocachepolicy:" LTO_CACHE_POLICY);
+#else
+			lto___argument(lp_arguments, lp_owned,
+						   CONCATENATE_STRING("-Wl,--thinlto-cache-dir=", lp_cache));
+			array_append(lp_arguments, "-Wl,--thinlto-cache-policy=" LTO_CACHE_POLICY);
+#endif
+
+			free(lp_cache);
+		}
+	}
+
+	if (p_self->mode != LTO_NONE && *p_self->features) { // Objects were compiled without them
+		lto___argument(lp_arguments, lp_owned,
+					   CONCATENATE_STRING("-Wl,-mllvm,-mattr=", p_self->features));
+	}
+
+#ifndef _WIN32
+	array_append(lp_arguments, "-lm");
+	array_append(lp_arguments, "-lpthread");
+#endif
+	array_append(lp_arguments, NULL);
+
+	bool linked = lto___wait(lto___spawn((char* const*)lp_arguments->_values), NULL);
+
+	free(lp_jobs);
+	lto___free_paths(&lp_owned);
+	array_free(&lp_arguments);
+
+	if (!linked) {
+		lto___remove_temporary(p_self);
+		error(CONCATENATE_STRING("'" LTO_DRIVER "' failed to link '", p_self->outputPath, "'"));
+	}
+
+	if (report_enabled(p_self->report, REPORT_TIME)) {
+		char line[LTO_LINE_LENGTH];
+
+		snprintf(line, sizeof(line), "lto %s: %s, %zu modules, %zu compiled, %zu reused, %.3fms",
+				 p_self->outputPath, lto_mode_get_name(p_self->mode), p_self->bitcodes->length,
+				 p_self->compiled, p_self->reused,
+				 (double)(report_clock() - startTime) / 1000000.0);
+		report_add(p_self->report, REPORT_TIME, line);
+	}
+}
+
+bool lto_run(const char* p_programPath) {
+	// Without a separator, the program would be searched for in the PATH
+	char* lp_program = strchr(p_programPath, *LTO_PATH_SEPARATOR)
+						   ? duplicate_string(p_programPath)
+						   : CONCATENATE_STRING("." LTO_PATH_SEPARATOR, p_programPath);
+	char* const lp_arguments[] = {lp_program, NULL};
+	int			signal		   = 0;
+	bool		ran			   = lto___wait(lto___spawn(lp_arguments), &signal);
+
+	if (signal != 0) { // e.g. a segmentation fault, which the program cannot report itself
+		char* lp_signal = ul_to_string((size_t)signal);
+
+		error(CONCATENATE_STRING("'", lp_program, "' was terminated by signal ", lp_signal));
+	}
+
+	free(lp_program);
+
+	return ran;
+}
@@ -0,0 +1,189 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./cache.h"
+#include "./report.h"
+#include "../utils/array.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LTO_DRIVER		  "clang"		// Compiles modules to bitcode, and links with lld.
+#define LTO_CACHE		  "lto"			// The ThinLTO cache, in the compilation cache directory.
+#define LTO_FILE_FLAGS	  "lto-file" // The flags of the cache entries of the runtime, imports, etc.
+
+// ThinLTO cache entries are pruned after a week unused, or when the cache outgrows 10% of the disk
+#define LTO_CACHE_POLICY "prune_after=168h:cache_size=10%"
+
+// X-Macro to define the link time optimisation modes and their names
+#define LTO_MODES(X)                                                                               \
+	X(NONE, "none")                                                                                \
+	X(THIN, "thin")                                                                                \
+	X(FULL, "full")
+
+/**
+ * Used to identify how a program is optimised when it is linked.
+ */
+enum LtoModes {
+#define LTO_MODE_ENUM_ENTRY(name, string) LTO_##name,
+	LTO_MODES(LTO_MODE_ENUM_ENTRY)
+#undef LTO_MODE_ENUM_ENTRY
+};
+
+/**
+ * Contains the names of each of the modes, as given to '--lto'.
+ */
+extern const struct Array g_LTO_MODE_NAMES;
+
+/**
+ * Gets the name of a mode.
+ *
+ * @param MODE The mode.
+ *
+ * @return The name of the mode.
+ */
+const char*
+lto_mode_get_name(const enum LtoModes MODE); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Parses the name of a mode.
+ *
+ * @param p_name The name, e.g. 'thin'. An empty name is LTO_NONE.
+ * @param p_mode Where to write the mode.
+ *
+ * @return Whether the name is a mode.
+ */
+bool lto_mode_parse(const char* p_name, enum LtoModes* p_mode);
+
+/**
+ * Represents linking a program with link time optimisation. Modules compile separately, so calls
+ * between them, and to the runtime, cannot be inlined before linking. Each module - the one the
+ * program is built from, the modules it imports and its entry point - and the runtime bitcode, is
+ * compiled by the driver to bitcode - with a summary of its functions for ThinLTO - and
+ * the linker then optimises them together: ThinLTO imports the functions each module calls from
+ * the others, e.g. 'Stack.size' or 'str_SEP_length', and optimises the modules in parallel, while
+ * full LTO merges them into one module.
+ *
+ * The bitcode of each module is stored in its compilation cache entry, so unchanged modules are not
+ * compiled again, and ThinLTO keeps the optimised modules in the cache's 'lto' directory, so
+ * relinking only optimises the modules whose imports changed. Without LTO, each module and the
+ * runtime are compiled to objects instead, stored and reused the same way, and linked as usual.
+ */
+struct Lto {
+	enum LtoModes  mode;
+	struct Cache*  cache;	   // The compilation cache (can be NULL).
+	struct Report* report;	   // The requested reports (can be NULL).
+	char*		   outputPath; // The program to link.
+	char*		   features;   // The target features, passed to the linker's code generator.
+	struct Array*  inputs;	   // The IR or bitcode each module still to compile is read from.
+	struct Array*  outputs;	   // Where each module still to compile writes its bitcode.
+	struct Array*  bitcodes;   // The bitcode of each module, linked in order.
+	struct Array*  temporary;  // The files to remove once linked, without a cache.
+	size_t		   jobs;	   // How many modules are compiled, and optimised, at once.
+	size_t		   compiled, reused; // For the time report.
+};
+
+#define LTO_STRUCT_SIZE sizeof(struct Lto)
+
+/**
+ * Creates a new Lto struct.
+ *
+ * @param MODE             The mode, LTO_NONE to link objects without LTO.
+ * @param p_cache          The compilation cache (can be NULL).
+ * @param p_report         The requested reports (can be NULL).
+ * @param p_outputPath     The path of the program to link.
+ * @param p_targetFeatures The target features, comma separated like LLVM's, e.g. '+avx2'.
+ *
+ * @return The created Lto struct.
+ */
+struct Lto* lto_new(const enum LtoModes MODE, // NOLINT(readability-avoid-const-params-in-decls)
+					struct Cache* p_cache, struct Report* p_report, const char* p_outputPath,
+					const char* p_targetFeatures);
+
+/**
+ * Frees an Lto struct, removing the temporary files it wrote.
+ *
+ * @param p_self The current Lto struct.
+ */
+void lto_free(struct Lto** p_self);
+
+/**
+ * Gets the path of the program built from a module, in the working directory, e.g. 'stack' for
+ * 'programs/stack.exl'.
+ *
+ * @param p_filePath The path of the module.
+ *
+ * @return The path of the program.
+ */
+char* lto_program_path(const char* p_filePath);
+
+/**
+ * Adds a compiled module to the program. Its bitcode is reused from its cache entry if it was
+ * already compiled in this mode, otherwise it is compiled when the program is linked. Errors if no
+ * IR was generated for it.
+ *
+ * @param p_self     The current Lto struct.
+ * @param p_cacheKey The module's cache key (can be NULL).
+ * @param p_output   The LLVM IR generated for the module, written out if it has no cache key.
+ */
+void lto_add_module(struct Lto* p_self, const char* p_cacheKey, const struct String* p_output);
+
+/**
+ * Adds the modules the program's module imports to the program, from the LLVM IR they wrote next
+ * to their interfaces. Each is compiled once for each mode into the compilation cache, keyed on
+ * its contents. Errors if the IR of a module is missing.
+ *
+ * @param p_self            The current Lto struct.
+ * @param p_paths           The paths of the LLVM IR of each module, e.g. 'shapes.ll'.
+ * @param p_compilerVersion The version of the compiler.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void lto_add_imports(struct Lto* p_self, const struct Array* p_paths,
+					 const char* p_compilerVersion);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Adds the program's entry point to the program, cached like the runtime. Nothing is added if the
+ * module has none.
+ *
+ * @param p_self            The current Lto struct.
+ * @param p_entry           The entry point's LLVM IR, from codegen_entry.
+ * @param p_compilerVersion The version of the compiler.
+ */
+void lto_add_entry(struct Lto* p_self, const struct String* p_entry,
+				   const char* p_compilerVersion);
+
+/**
+ * Adds the runtime to the program. Its bitcode has no summary, so it is compiled once for each mode
+ * into the compilation cache, keyed on its contents.
+ *
+ * @param p_self            The current Lto struct.
+ * @param p_stdlib          The path to the folder containing the standard library.
+ * @param p_compilerVersion The version of the compiler.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void lto_add_runtime(struct Lto* p_self, const char* p_stdlib, const char* p_compilerVersion);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Compiles the modules not compiled yet, in parallel, and links the program. Errors if the driver
+ * or the linker fails, once the compiles still running have exited and the intermediate files
+ * have been removed.
+ *
+ * @param p_self The current Lto struct.
+ */
+void lto_link(struct Lto* p_self);
+
+/**
+ * Runs a linked program, waiting for it to exit. Errors if it was terminated by a signal, e.g. on a
+ * segmentation fault.
+ *
+ * @param p_programPath The path of the program.
+ *
+ * @return Whether the program exited successfully.
+ */
+bool lto_run(const char* p_programPath);
@@ -0,0 +1,803 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./match.h"
+#include "./diagnostics.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MATCH_LABEL_LENGTH	   48U
+#define MATCH_LINE_LENGTH	   192U
+
+struct MatchLowering* match_lowering_new(const char* p_filePath) {
+	struct MatchLowering* lp_self = calloc(1, MATCHLOWERING_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc MatchLowering struct");
+	}
+
+	lp_self->filePath = p_filePath;
+
+	return lp_self;
+}
+
+void match_lowering_free(struct MatchLowering** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->columns);
+		free((*p_self)->cells);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("MatchLowering struct has already been freed");
+	}
+}
+
+/**
+ * Gets the constant a pattern compares against, if it is one.
+ *
+ * @param p_self     The current MatchLowering struct.
+ * @param pattern    The pattern's node.
+ * @param p_constant Where to write the constant.
+ *
+ * @return Whether the pattern is a constant.
+ */
+bool match___constant(const struct MatchLowering* p_self, flat_ast_index_t pattern,
+					  int64_t* p_constant) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+
+	switch (lp_pattern->kind) {
+	case FLATAST_INTEGER:
+	case FLATAST_CHR:
+		*p_constant = lp_pattern->value.integer;
+		return true;
+	case FLATAST_UNARY: // Negative integers
+		if (lp_pattern->operation == LEXERTOKENS_SUBTRACTION
+			&& flat_ast_get(p_self->ast, lp_pattern->lhs)->kind == FLATAST_INTEGER) {
+			*p_constant = (int64_t)(0U - (uint64_t)flat_ast_get(p_self->ast, lp_pattern->lhs)
+											 ->value.integer);
+			return true;
+		}
+
+		return false;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Gets the column of a struct field, adding it if no pattern has mentioned it yet.
+ *
+ * @param p_self The current MatchLowering struct.
+ * @param parent The column of the struct.
+ * @param p_name The field's name.
+ *
+ * @return The field's column.
+ */
+size_t match___column(struct MatchLowering* p_self, size_t parent, const char* p_name) {
+	for (size_t index = 0; index < p_self->columnCount; index++) {
+		const struct MatchColumn* lp_column = &p_self->columns[index];
+
+		if (lp_column->parent == parent && lp_column->field
+			&& strcmp(lp_column->field, p_name) == 0) {
+			return index;
+		}
+	}
+
+	p_self->columns = buffer_grow(p_self->columns, &p_self->columnCapacity, p_self->columnCount + 1,
+								  MATCH_COLUMN_SIZE);
+	p_self->columns[p_self->columnCount] =
+		(struct MatchColumn){.parent = parent, .field = p_name, .layout = LAYOUT_NONE};
+
+	return p_self->columnCount++;
+}
+
+/**
+ * Finds the columns a pattern tests. Errors on unsupported patterns.
+ *
+ * @param p_self  The current MatchLowering struct.
+ * @param pattern The pattern's node.
+ * @param column  The column the pattern is matched against.
+ */
+void match___columns(struct MatchLowering* p_self, flat_ast_index_t pattern, size_t column) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+	int64_t					  constant	 = 0;
+
+	if (match___constant(p_self, pattern, &constant)) {
+		p_self->columns[column].tested = true;
+		return;
+	}
+
+	switch (lp_pattern->kind) {
+	case FLATAST_VARIABLE: // '_' or a binding, which test nothing
+		break;
+	case FLATAST_STRUCT_LITERAL:
+		for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+			const struct FlatASTNode* lp_field =
+				flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_pattern, index));
+
+			match___columns(
+				p_self, lp_field->lhs,
+				match___column(p_self, column,
+							   flat_ast_get_string(p_self->ast, lp_field->value.string)));
+		}
+		break;
+	default:
+		compiler_error(p_self->filePath, lp_pattern->line, C0008,
+					   CONCATENATE_STRING("cannot match against a '",
+										  flat_ast_kind_get_name(lp_pattern->kind),
+										  "' pattern: only integers, chars, '_', bindings and "
+										  "struct patterns of those are supported"));
+	}
+}
+
+/**
+ * Gets the width of the integers a primitive is matched as.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return The width, in bits, 0 if constants cannot be compared to the primitive.
+ */
+uint8_t match___width(const enum TypePrimitives PRIMITIVE) {
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_U8:
+	case TYPE_PRIMITIVE_CHR:
+		return 8;
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_U16:
+		return 16;
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_U32:
+		return 32;
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+		return 64;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Types the columns of the current match, and names their values. The scrutinee is the value
+ * given, the fields are loaded by match_lowering_emit. Errors if a pattern destructures anything
+ * but a struct of the module, names a field its struct does not have, or compares a column to a
+ * constant that is not an integer or a char.
+ *
+ * @param p_self      The current MatchLowering struct.
+ * @param p_inference The inference the match's function was inferred with.
+ * @param p_scrutinee The scrutinee's value.
+ */
+void match___type_columns(struct MatchLowering* p_self, const struct Inference* p_inference,
+						  const char* p_scrutinee) {
+	const struct FlatASTNode* lp_match = flat_ast_get(p_self->ast, p_self->match);
+	const struct TypeTable*	  lp_types = p_self->layouts->types;
+
+	for (size_t index = 0; index < p_self->columnCount; index++) {
+		struct MatchColumn* lp_column = &p_self->columns[index];
+
+		if (lp_column->parent == SIZE_MAX) {
+			lp_column->type	 = inference_get_node_type(p_inference, lp_match->lhs);
+			lp_column->value = p_scrutinee;
+		} else {
+			const struct MatchColumn* lp_parent = &p_self->columns[lp_column->parent];
+
+			if (lp_parent->layout == LAYOUT_NONE) {
+				compiler_error(p_self->filePath, lp_match->line, C0008,
+							   CONCATENATE_STRING("cannot match the fields of a '",
+												  type_table_to_string(lp_types, lp_parent->type),
+												  "', which is not a struct of the module"));
+			}
+
+			lp_column->layoutField =
+				layout_get_field(p_self->layouts, lp_parent->layout,
+								 interner_find(p_self->layouts->interner, lp_column->field));
+
+			if (!lp_column->layoutField) {
+				compiler_error(p_self->filePath, lp_match->line, C0008,
+							   CONCATENATE_STRING("'",
+												  type_table_to_string(lp_types, lp_parent->type),
+												  "' has no field '", lp_column->field, "'"));
+			}
+
+			lp_column->type = lp_column->layoutField->type;
+
+			// %match.<id>.field.<column>
+			snprintf(lp_column->name, sizeof(lp_column->name), "%%match.%zu.field.%zu",
+					 p_self->emitted, index);
+			lp_column->value = lp_column->name;
+		}
+
+		lp_column->layout =
+			lp_column->type != TYPE_ID_NONE ? layout_find(p_self->layouts, lp_column->type)
+											: LAYOUT_NONE;
+
+		if (!lp_column->tested) {
+			continue;
+		}
+
+		const struct Type* lp_type =
+			lp_column->type != TYPE_ID_NONE ? type_table_get(lp_types, lp_column->type) : NULL;
+
+		lp_column->width = lp_type && lp_type->kind == TYPE_PRIMITIVE
+							   ? match___width((enum TypePrimitives)lp_type->primitive)
+							   : 0;
+
+		if (!lp_column->width) {
+			compiler_error(p_self->filePath, lp_match->line, C0008,
+						   CONCATENATE_STRING("cannot match a '",
+											  type_table_to_string(lp_types, lp_column->type),
+											  "' against integers or chars"));
+		}
+
+		lp_column->llvmType = lp_column->width == 8	   ? "i8"
+							  : lp_column->width == 16 ? "i16"
+							  : lp_column->width == 32 ? "i32"
+													   : "i64";
+		lp_column->isSigned = lp_type->primitive < TYPE_PRIMITIVE_U8
+							  || lp_type->primitive == TYPE_PRIMITIVE_CHR;
+	}
+}
+
+/**
+ * Wraps a constant to the width of the column it is compared to, e.g. 255 to -1 for a 'chr', so
+ * equal values have equal constants. Constants out of the column's range are rejected beforehand.
+ *
+ * @param p_column The column.
+ * @param constant The constant.
+ *
+ * @return The wrapped constant.
+ */
+int64_t match___normalise(const struct MatchColumn* p_column, int64_t constant) {
+	if (p_column->width >= 64) {
+		return constant;
+	}
+
+	uint64_t mask = (UINT64_C(1) << p_column->width) - 1;
+	uint64_t bits = (uint64_t)constant & mask;
+
+	if (p_column->isSigned && (bits >> (p_column->width - 1))) { // Sign extend
+		bits |= ~mask;
+	}
+
+	return (int64_t)bits;
+}
+
+/**
+ * Checks that a constant is a value of the column it is compared to, e.g. not 300 for a 'u8',
+ * which would otherwise be wrapped to a value the case was not written for. Chars may be written
+ * as signed or unsigned bytes.
+ *
+ * @param p_self   The current MatchLowering struct.
+ * @param pattern  The constant's pattern, for diagnostics.
+ * @param column   The column.
+ * @param constant The constant.
+ */
+void match___check_range(const struct MatchLowering* p_self, flat_ast_index_t pattern,
+						 size_t column, int64_t constant) {
+	const struct MatchColumn* lp_column	 = &p_self->columns[column];
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+	const struct TypeTable*	  lp_types	 = p_self->layouts->types;
+	const struct Type*		  lp_type	 = type_table_get(lp_types, lp_column->type);
+	bool					  isChr		 = lp_type->primitive == TYPE_PRIMITIVE_CHR;
+	bool					  inRange	 = true;
+
+	if (lp_column->width >= 64) { // Only a negated constant can be out of range of a 'u64'
+		inRange = lp_column->isSigned || lp_pattern->kind != FLATAST_UNARY || constant == 0;
+	} else {
+		int64_t minimum = lp_column->isSigned ? -(INT64_C(1) << (lp_column->width - 1)) : 0;
+		int64_t maximum = (INT64_C(1) << (lp_column->width - (lp_column->isSigned && !isChr))) - 1;
+
+		inRange = constant >= minimum && constant <= maximum;
+	}
+
+	if (inRange) {
+		return;
+	}
+
+	char value[MATCH_LABEL_LENGTH];
+
+	snprintf(value, sizeof(value), "%" PRId64, constant);
+	compiler_error(p_self->filePath, lp_pattern->line, C0008,
+				   CONCATENATE_STRING("this case never matches, as ", value,
+									  " is out of the range of '",
+									  type_table_to_string(lp_types, lp_column->type), "'"));
+}
+
+/**
+ * Fills in the cells of a case's row from its pattern.
+ *
+ * @param p_self  The current MatchLowering struct.
+ * @param row     The case's row.
+ * @param pattern The pattern's node.
+ * @param column  The column the pattern is matched against.
+ */
+void match___cells(struct MatchLowering* p_self, size_t row, flat_ast_index_t pattern,
+				   size_t column) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+	int64_t					  constant	 = 0;
+
+	if (match___constant(p_self, pattern, &constant)) {
+		match___check_range(p_self, pattern, column, constant);
+		p_self->cells[row * p_self->columnCount + column] = (struct MatchCell){
+			.constant = match___normalise(&p_self->columns[column], constant), .wildcard = false};
+		return;
+	}
+
+	if (lp_pattern->kind == FLATAST_STRUCT_LITERAL) {
+		for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+			const struct FlatASTNode* lp_field =
+				flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_pattern, index));
+
+			match___cells(p_self, row, lp_field->lhs,
+						  match___column(p_self, column,
+										 flat_ast_get_string(p_self->ast, lp_field->value.string)));
+		}
+	}
+}
+
+/**
+ * Errors if a case of the current match has the same pattern as an earlier one, so it never runs.
+ *
+ * @param p_self The current MatchLowering struct.
+ * @param row    The case's row.
+ */
+void match___check_duplicate(const struct MatchLowering* p_self, size_t row) {
+	const struct FlatASTNode* lp_match = flat_ast_get(p_self->ast, p_self->match);
+	const struct MatchCell*	  lp_row   = &p_self->cells[row * p_self->columnCount];
+
+	for (size_t earlier = 0; earlier < row; earlier++) {
+		const struct MatchCell* lp_earlier = &p_self->cells[earlier * p_self->columnCount];
+		bool					same	   = true;
+
+		for (size_t column = 0; column < p_self->columnCount && same; column++) {
+			same = lp_row[column].wildcard == lp_earlier[column].wildcard
+				   && (lp_row[column].wildcard
+					   || lp_row[column].constant == lp_earlier[column].constant);
+		}
+
+		if (!same) {
+			continue;
+		}
+
+		const struct FlatASTNode* lp_case =
+			flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_match, row));
+		const struct FlatASTNode* lp_earlierCase =
+			flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_match, earlier));
+		char line[MATCH_LABEL_LENGTH];
+
+		snprintf(line, sizeof(line), "%" PRIu32, lp_earlierCase->line + 1);
+		compiler_error(p_self->filePath, lp_case->line, C0008,
+					   CONCATENATE_STRING("this case never matches, as the case on line ", line,
+										  " matches the same values"));
+	}
+}
+
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+size_t match_lowering_analyse(struct MatchLowering* p_self, const struct FlatAST* p_ast,
+							  const struct Inference* p_inference,
+							  const struct LayoutTable* p_layouts, flat_ast_index_t match,
+							  const char* p_scrutinee) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	const struct FlatASTNode* lp_match = flat_ast_get(p_ast, match);
+
+	p_self->ast			= p_ast;
+	p_self->layouts		= p_layouts;
+	p_self->match		= match;
+	p_self->columnCount = 0;
+	p_self->rowCount	= lp_match->value.list.length;
+
+	// The scrutinee is the first column, the fields its patterns mention follow
+	p_self->columns = buffer_grow(p_self->columns, &p_self->columnCapacity, 1, MATCH_COLUMN_SIZE);
+	p_self->columns[p_self->columnCount++] =
+		(struct MatchColumn){.parent = SIZE_MAX, .layout = LAYOUT_NONE};
+
+	for (size_t row = 0; row < p_self->rowCount; row++) {
+		match___columns(p_self,
+						flat_ast_get(p_ast, flat_ast_get_list_item(p_ast, lp_match, row))->lhs, 0);
+	}
+
+	match___type_columns(p_self, p_inference, p_scrutinee);
+
+	size_t cellCount = p_self->rowCount * p_self->columnCount;
+
+	p_self->cells = buffer_grow(p_self->cells, &p_self->cellCapacity, cellCount, MATCH_CELL_SIZE);
+
+	for (size_t index = 0; index < cellCount; index++) {
+		p_self->cells[index] = (struct MatchCell){.constant = 0, .wildcard = true};
+	}
+
+	for (size_t row = 0; row < p_self->rowCount; row++) {
+		match___cells(p_self, row,
+					  flat_ast_get(p_ast, flat_ast_get_list_item(p_ast, lp_match, row))->lhs, 0);
+		match___check_duplicate(p_self, row);
+	}
+
+	return p_self->columnCount;
+}
+
+/**
+ * Compares two branches by their constants as signed integers, for qsort.
+ *
+ * @param p_lhs The first branch.
+ * @param p_rhs The second branch.
+ *
+ * @return Less than, equal to or greater than zero, as the first constant is less than, equal to or
+ * greater than the second.
+ */
+int match___compare_signed(const void* p_lhs, const void* p_rhs) {
+	int64_t lhs = ((const struct MatchBranch*)p_lhs)->constant;
+	int64_t rhs = ((const struct MatchBranch*)p_rhs)->constant;
+
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * Compares two branches by their constants as unsigned integers, for qsort.
+ *
+ * @param p_lhs The first branch.
+ * @param p_rhs The second branch.
+ *
+ * @return Less than, equal to or greater than zero, as the first constant is less than, equal to or
+ * greater than the second.
+ */
+int match___compare_unsigned(const void* p_lhs, const void* p_rhs) {
+	uint64_t lhs = (uint64_t)((const struct MatchBranch*)p_lhs)->constant;
+	uint64_t rhs = (uint64_t)((const struct MatchBranch*)p_rhs)->constant;
+
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * Emits the start of one of the blocks of the current match.
+ *
+ * @param p_self   The current MatchLowering struct.
+ * @param block    The block.
+ * @param p_output Where to append the IR.
+ */
+void match___emit_block(const struct MatchLowering* p_self, size_t block, struct String* p_output) {
+	char line[MATCH_LABEL_LENGTH];
+
+	// match.<id>.<block>:
+	snprintf(line, sizeof(line), "\nmatch.%zu.%zu:\n", p_self->emitted, block);
+	string_append_str(p_output, line);
+}
+
+/**
+ * Writes the label of one of the blocks of the current match.
+ *
+ * @param p_self  The current MatchLowering struct.
+ * @param block   The block.
+ * @param p_label Where to write the label, of MATCH_LABEL_LENGTH bytes.
+ */
+void match___label(const struct MatchLowering* p_self, size_t block, char* p_label) {
+	snprintf(p_label, MATCH_LABEL_LENGTH, "%%match.%zu.%zu", p_self->emitted, block);
+}
+
+/**
+ * Emits a balanced binary search over clusters of a column's sorted constants: each cluster is a
+ * single comparison, or a 'switch' when it is dense enough for LLVM to lower it to a jump table.
+ *
+ * @param p_self      The current MatchLowering struct.
+ * @param p_column    The column tested.
+ * @param p_branches  The column's constants, sorted.
+ * @param p_clusters  The index of the first branch of each cluster, then the number of branches.
+ * @param first       The first cluster searched.
+ * @param last        The last cluster searched.
+ * @param p_default   The label of the block for constants no branch has.
+ * @param p_output    Where to append the IR.
+ */
+void match___emit_search(struct MatchLowering* p_self, const struct MatchColumn* p_column,
+						 const struct MatchBranch* p_branches, const size_t* p_clusters,
+						 size_t first, size_t last, const char* p_default,
+						 struct String* p_output) {
+	char line[MATCH_LINE_LENGTH];
+	char label[MATCH_LABEL_LENGTH];
+
+	if (first == last) {
+		size_t start = p_clusters[first];
+		size_t count = p_clusters[first + 1] - start;
+
+		if (count == 1) {
+			size_t test = p_self->blocks++;
+
+			// %match.<id>.<test> = icmp eq T %value, C
+			// br i1 %match.<id>.<test>, label %match.<id>.<block>, label %default
+			match___label(p_self, p_branches[start].block, label);
+			snprintf(line, sizeof(line),
+					 "  %%match.%zu.%zu = icmp eq %s %s, %" PRId64
+					 "\n  br i1 %%match.%zu.%zu, label %s, label %s\n",
+					 p_self->emitted, test, p_column->llvmType, p_column->value,
+					 p_branches[start].constant, p_self->emitted, test, label, p_default);
+			string_append_str(p_output, line);
+
+			return;
+		}
+
+		// switch T %value, label %default [ T C, label %match.<id>.<block> ... ]
+		snprintf(line, sizeof(line), "  switch %s %s, label %s [\n", p_column->llvmType,
+				 p_column->value, p_default);
+		string_append_str(p_output, line);
+
+		for (size_t index = start; index < start + count; index++) {
+			match___label(p_self, p_branches[index].block, label);
+			snprintf(line, sizeof(line), "    %s %" PRId64 ", label %s\n", p_column->llvmType,
+					 p_branches[index].constant, label);
+			string_append_str(p_output, line);
+		}
+
+		string_append_str(p_output, "  ]\n");
+		p_self->tables++;
+
+		return;
+	}
+
+	size_t middle = first + (last - first + 1) / 2;
+	size_t test	  = p_self->blocks++;
+	size_t lower  = p_self->blocks++;
+	size_t upper  = p_self->blocks++;
+
+	// %match.<id>.<test> = icmp slt T %value, C
+	// br i1 %match.<id>.<test>, label %match.<id>.<lower>, label %match.<id>.<upper>
+	snprintf(line, sizeof(line),
+			 "  %%match.%zu.%zu = icmp %s %s %s, %" PRId64
+			 "\n  br i1 %%match.%zu.%zu, label %%match.%zu.%zu, label %%match.%zu.%zu\n",
+			 p_self->emitted, test, p_column->isSigned ? "slt" : "ult", p_column->llvmType,
+			 p_column->value, p_branches[p_clusters[middle]].constant, p_self->emitted, test,
+			 p_self->emitted, lower, p_self->emitted, upper);
+	string_append_str(p_output, line);
+	p_self->searches++;
+
+	match___emit_block(p_self, lower, p_output);
+	match___emit_search(p_self, p_column, p_branches, p_clusters, first, middle - 1, p_default,
+						p_output);
+	match___emit_block(p_self, upper, p_output);
+	match___emit_search(p_self, p_column, p_branches, p_clusters, middle, last, p_default,
+						p_output);
+}
+
+/**
+ * Emits the dispatch on a column's constants, splitting them greedily into clusters: the longest
+ * run of at least MATCH_TABLE_MIN_CASES constants spanning under 2.5 times as many values is
+ * dense, anything else is compared on its own.
+ *
+ * @param p_self     The current MatchLowering struct.
+ * @param column     The column tested.
+ * @param p_branches The column's constants.
+ * @param count      The number of constants.
+ * @param p_default  The label of the block for constants no branch has.
+ * @param p_output   Where to append the IR.
+ */
+void match___emit_dispatch(struct MatchLowering* p_self, size_t column,
+						   struct MatchBranch* p_branches, size_t count, const char* p_default,
+						   struct String* p_output) {
+	const struct MatchColumn* lp_column	  = &p_self->columns[column];
+	size_t*					  lp_clusters = malloc((count + 1) * sizeof(size_t));
+	size_t					  clusterCount = 0;
+
+	if (!lp_clusters) {
+		PANIC("failed to malloc MatchLowering clusters");
+	}
+
+	if (!lp_column->value || !lp_column->llvmType) {
+		PANIC("MatchLowering column has no value");
+	}
+
+	qsort(p_branches, count, MATCH_BRANCH_SIZE,
+		  lp_column->isSigned ? match___compare_signed : match___compare_unsigned);
+
+	for (size_t start = 0; start < count;) {
+		size_t end = start + 1;
+
+		for (size_t candidate = count; candidate >= start + MATCH_TABLE_MIN_CASES; candidate--) {
+			// The distance is the same whether the constants are signed or not, as they are sorted
+			uint64_t span = (uint64_t)p_branches[candidate - 1].constant
+						  - (uint64_t)p_branches[start].constant;
+
+			if (span < (candidate - start) * 5 / 2) {
+				end = candidate;
+				break;
+			}
+		}
+
+		lp_clusters[clusterCount++] = start;
+		start						= end;
+	}
+
+	lp_clusters[clusterCount] = count;
+
+	match___emit_search(p_self, lp_column, p_branches, lp_clusters, 0, clusterCount - 1, p_default,
+						p_output);
+
+	free(lp_clusters);
+}
+
+/**
+ * Emits the decision tree of the rows left: the first row matches once its constants have all been
+ * tested, otherwise one of its columns is tested and the rows are split by its constant.
+ *
+ * @param p_self    The current MatchLowering struct.
+ * @param p_rows    The rows left, in order.
+ * @param rowCount  The number of rows left.
+ * @param p_tested  Whether each column has been tested above.
+ * @param p_labels  The label of each case.
+ * @param p_default The label branched to if no case matches.
+ * @param p_output  Where to append the IR.
+ */
+void match___emit_tree(struct MatchLowering* p_self, const size_t* p_rows, size_t rowCount,
+					   bool* p_tested, const char* const* p_labels, const char* p_default,
+					   struct String* p_output) {
+	if (rowCount == 0) {
+		string_append_str(p_output, "  br label %");
+		string_append_str(p_output, p_default);
+		string_append_chr(p_output, '\n');
+		return;
+	}
+
+	// The column the first row tests that the most rows test, so the split narrows them the most
+	const struct MatchCell* lp_first  = &p_self->cells[p_rows[0] * p_self->columnCount];
+	size_t					column	  = SIZE_MAX;
+	size_t					bestCount = 0;
+
+	for (size_t index = 0; index < p_self->columnCount; index++) {
+		if (p_tested[index] || lp_first[index].wildcard) {
+			continue;
+		}
+
+		size_t count = 0;
+
+		for (size_t row = 0; row < rowCount; row++) {
+			count += !p_self->cells[p_rows[row] * p_self->columnCount + index].wildcard;
+		}
+
+		if (count > bestCount) {
+			column	  = index;
+			bestCount = count;
+		}
+	}
+
+	if (column == SIZE_MAX) {
+		string_append_str(p_output, "  br label %");
+		string_append_str(p_output, p_labels[p_rows[0]]);
+		string_append_chr(p_output, '\n');
+		return;
+	}
+
+	struct MatchBranch* lp_branches = malloc(bestCount * MATCH_BRANCH_SIZE);
+	size_t*				lp_subrows	= malloc(rowCount * sizeof(size_t));
+	size_t				branchCount = 0;
+
+	if (!lp_branches || !lp_subrows) {
+		PANIC("failed to malloc MatchLowering branches");
+	}
+
+	for (size_t row = 0; row < rowCount; row++) {
+		const struct MatchCell* lp_cell =
+			&p_self->cells[p_rows[row] * p_self->columnCount + column];
+		bool seen = lp_cell->wildcard;
+
+		for (size_t index = 0; index < branchCount && !seen; index++) {
+			seen = lp_branches[index].constant == lp_cell->constant;
+		}
+
+		if (!seen) {
+			lp_branches[branchCount++] =
+				(struct MatchBranch){.constant = lp_cell->constant, .block = p_self->blocks++};
+		}
+	}
+
+	size_t defaultBlock = p_self->blocks++;
+	char   label[MATCH_LABEL_LENGTH];
+
+	match___label(p_self, defaultBlock, label);
+	match___emit_dispatch(p_self, column, lp_branches, branchCount, label, p_output);
+
+	p_tested[column] = true;
+
+	// Each constant keeps the rows that have it or accept anything, in order
+	for (size_t index = 0; index < branchCount; index++) {
+		size_t subrowCount = 0;
+
+		for (size_t row = 0; row < rowCount; row++) {
+			const struct MatchCell* lp_cell =
+				&p_self->cells[p_rows[row] * p_self->columnCount + column];
+
+			if (lp_cell->wildcard || lp_cell->constant == lp_branches[index].constant) {
+				lp_subrows[subrowCount++] = p_rows[row];
+			}
+		}
+
+		match___emit_block(p_self, lp_branches[index].block, p_output);
+		match___emit_tree(p_self, lp_subrows, subrowCount, p_tested, p_labels, p_default,
+						  p_output);
+	}
+
+	size_t subrowCount = 0;
+
+	for (size_t row = 0; row < rowCount; row++) {
+		if (p_self->cells[p_rows[row] * p_self->columnCount + column].wildcard) {
+			lp_subrows[subrowCount++] = p_rows[row];
+		}
+	}
+
+	match___emit_block(p_self, defaultBlock, p_output);
+	match___emit_tree(p_self, lp_subrows, subrowCount, p_tested, p_labels, p_default, p_output);
+
+	p_tested[column] = false;
+
+	free(lp_branches);
+	free(lp_subrows);
+}
+
+/**
+ * Emits the loads of the fields the current match tests, and the addresses of the structs they
+ * are in.
+ *
+ * @param p_self   The current MatchLowering struct.
+ * @param p_output Where to append the IR.
+ */
+void match___emit_fields(const struct MatchLowering* p_self, struct String* p_output) {
+	char line[MATCH_LINE_LENGTH];
+	char address[MATCH_VALUE_LENGTH + sizeof(".address")];
+
+	for (size_t index = 0; index < p_self->columnCount; index++) {
+		const struct MatchColumn* lp_column = &p_self->columns[index];
+
+		if (lp_column->parent == SIZE_MAX) {
+			continue;
+		}
+
+		const struct MatchColumn* lp_parent = &p_self->columns[lp_column->parent];
+
+		if (!lp_column->tested) { // Bindings and '_' read nothing, nested structs are addresses
+			if (lp_column->layout != LAYOUT_NONE) {
+				layout_emit_field(p_self->layouts, lp_parent->layout, lp_column->layoutField,
+								  lp_parent->value, lp_column->value, p_output);
+			}
+
+			continue;
+		}
+
+		snprintf(address, sizeof(address), "%s.address", lp_column->value);
+		layout_emit_field(p_self->layouts, lp_parent->layout, lp_column->layoutField,
+						  lp_parent->value, address, p_output);
+
+		// %match.<id>.field.<column> = load T, T* %match.<id>.field.<column>.address
+		snprintf(line, sizeof(line), "  %s = load %s, %s* %s\n", lp_column->value,
+				 lp_column->llvmType, lp_column->llvmType, address);
+		string_append_str(p_output, line);
+	}
+}
+
+void match_lowering_emit(struct MatchLowering* p_self, const char* const* p_labels,
+						 const char* p_default, struct String* p_output) {
+	size_t* lp_rows	  = malloc((p_self->rowCount ? p_self->rowCount : 1) * sizeof(size_t));
+	bool*	lp_tested = calloc(p_self->columnCount, sizeof(bool));
+
+	if (!lp_rows || !lp_tested) {
+		PANIC("failed to malloc MatchLowering rows");
+	}
+
+	for (size_t row = 0; row < p_self->rowCount; row++) {
+		lp_rows[row] = row;
+	}
+
+	p_self->blocks = 0;
+	p_self->matches++;
+
+	match___emit_fields(p_self, p_output);
+	match___emit_tree(p_self, lp_rows, p_self->rowCount, lp_tested, p_labels, p_default,
+					  p_output);
+
+	p_self->emitted++;
+
+	free(lp_rows);
+	free(lp_tested);
+}
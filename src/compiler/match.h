@@ -0,0 +1,131 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./layout.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MATCH_TABLE_MIN_CASES 4U  // Fewer values are tested one by one.
+#define MATCH_VALUE_LENGTH	  48U // The length of the names of the values of fields.
+
+/**
+ * Represents a value a match tests: the scrutinee, or a field of another column's struct.
+ */
+struct MatchColumn {
+	size_t					  parent; // The column the field is read from, else SIZE_MAX.
+	const char*				  field;  // The field's name, NULL for the scrutinee.
+	bool					  tested; // Whether any pattern compares the column to a constant.
+	type_id_t				  type;
+	uint32_t				  layout;	   // The layout of the column's struct, else LAYOUT_NONE.
+	const struct LayoutField* layoutField; // The field read, NULL for the scrutinee.
+	const char*				  value;	   // The value, a pointer for structs, e.g. '%point'.
+	const char*				  llvmType;	   // The LLVM type of the tested columns, e.g. 'i32'.
+	uint8_t					  width;	   // The width of the tested columns, in bits.
+	bool					  isSigned;	   // Whether the value is compared as a signed integer.
+	// The value of the columns of fields, e.g. '%match.0.field.1'.
+	char name[MATCH_VALUE_LENGTH];
+};
+
+#define MATCH_COLUMN_SIZE sizeof(struct MatchColumn)
+
+/**
+ * Represents what a pattern requires of a column: a constant, or nothing.
+ */
+struct MatchCell {
+	int64_t constant; // Wrapped to the width of the column, like the value it is compared to.
+	bool	wildcard; // Whether any value matches, e.g. '_', a binding or a field not mentioned.
+};
+
+#define MATCH_CELL_SIZE sizeof(struct MatchCell)
+
+/**
+ * Represents one of the constants a column is tested against, and the block testing the rest of
+ * the cases it leads to.
+ */
+struct MatchBranch {
+	int64_t constant;
+	size_t	block;
+};
+
+#define MATCH_BRANCH_SIZE sizeof(struct MatchBranch)
+
+/**
+ * Represents the lowering of 'match'. Each case's pattern is flattened into a row of the columns
+ * it tests, and the rows are compiled into a decision tree: a column is picked, the cases are
+ * split by its constant, and the column is never tested again below. Testing a column against its
+ * constants splits them into dense clusters, each emitted as a 'switch' LLVM lowers to a jump
+ * table, found by a balanced binary search when there are several, instead of comparing against
+ * each case in turn.
+ */
+struct MatchLowering {
+	const char*				  filePath; // For diagnostics.
+	const struct FlatAST*	  ast;		// The AST of the current match.
+	const struct LayoutTable* layouts;	// The module's struct layouts, for the fields matched.
+	flat_ast_index_t		  match;	// The current match.
+	struct MatchColumn*	  columns;	// The columns of the current match.
+	struct MatchCell*	  cells;	// The cells of each case of the current match, row by row.
+	size_t columnCount, columnCapacity, rowCount, cellCapacity;
+	size_t emitted, blocks;			  // Matches emitted and blocks of the current one, for labels.
+	size_t matches, tables, searches; // For the time report.
+};
+
+#define MATCHLOWERING_STRUCT_SIZE sizeof(struct MatchLowering)
+
+/**
+ * Creates a new MatchLowering struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ *
+ * @return The created MatchLowering struct.
+ */
+struct MatchLowering* match_lowering_new(const char* p_filePath);
+
+/**
+ * Frees a MatchLowering struct.
+ *
+ * @param p_self The current MatchLowering struct.
+ */
+void match_lowering_free(struct MatchLowering** p_self);
+
+/**
+ * Flattens the patterns of a match into its columns and rows, typing each column from the inferred
+ * type of the scrutinee and the layouts of the structs its patterns destructure. Errors on patterns
+ * other than integers, chars, '_', bindings and struct patterns of those, on constants compared to
+ * anything but an integer or a char, and on a case matching the same values as an earlier one.
+ *
+ * @param p_self      The current MatchLowering struct.
+ * @param p_ast       The AST containing the match.
+ * @param p_inference The inference the match's function was inferred with.
+ * @param p_layouts   The module's struct layouts.
+ * @param match       The match's node.
+ * @param p_scrutinee The scrutinee's value, a pointer for a struct, e.g. '%point'.
+ *
+ * @return The number of columns.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+size_t match_lowering_analyse(struct MatchLowering* p_self, const struct FlatAST* p_ast,
+							  const struct Inference* p_inference,
+							  const struct LayoutTable* p_layouts, flat_ast_index_t match,
+							  const char* p_scrutinee);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the decision tree of the last analysed match, which ends the current block. The fields its
+ * patterns test are loaded first, then it branches to the label of the first case whose pattern
+ * matches, or to the default label if none does.
+ *
+ * @param p_self    The current MatchLowering struct.
+ * @param p_labels  The label of each case, without the '%', e.g. 'case.0'.
+ * @param p_default The label branched to if no case matches.
+ * @param p_output  Where to append the IR.
+ */
+void match_lowering_emit(struct MatchLowering* p_self, const char* const* p_labels,
+						 const char* p_default, struct String* p_output);
@@ -0,0 +1,410 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./memo.h"
+#include "./attributes.h"
+#include "./diagnostics.h"
+#include "../utils/panic.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MEMO_NAME_LENGTH 32U
+#define MEMO_LINE_LENGTH 256U
+
+struct Memo* memo_new(const char* p_filePath, const struct TypeTable* p_types,
+					  struct Comptime* p_comptime) {
+	struct Memo* lp_self = calloc(1, MEMO_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Memo struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->types	  = p_types;
+	lp_self->comptime = p_comptime;
+
+	return lp_self;
+}
+
+void memo_free(struct Memo** p_self) {
+	if (p_self && *p_self) {
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Memo struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether a type can be packed into a key or a cached result, i.e. it is a primitive held
+ * in at most 64 bits.
+ *
+ * @param p_self The current Memo struct.
+ * @param type   The type.
+ *
+ * @return Whether the type can be packed.
+ */
+bool memo___is_packable(const struct Memo* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return false;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	return lp_type->kind == TYPE_PRIMITIVE && lp_type->primitive != TYPE_PRIMITIVE_VOID
+		   && lp_type->primitive != TYPE_PRIMITIVE_STR;
+}
+
+/**
+ * Errors because a function marked '@memo' or '@memo_lru' cannot be memoized.
+ *
+ * @param p_self   The current Memo struct.
+ * @param p_ast    The AST containing the function.
+ * @param function The function's node.
+ * @param p_name   The function's name.
+ * @param p_reason Why the function cannot be memoized.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+__attribute__((noreturn)) void memo___error(const struct Memo* p_self, const struct FlatAST* p_ast,
+											flat_ast_index_t function, const char* p_name,
+											const char* p_reason) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	compiler_error(p_self->filePath, flat_ast_get(p_ast, function)->line, C0007,
+				   CONCATENATE_STRING("cannot memoize '", p_name, "': ", p_reason));
+}
+
+enum MemoStrategies memo_analyse(struct Memo* p_self, const struct FlatAST* p_ast,
+								 const struct Inference* p_inference, flat_ast_index_t function,
+								 uint32_t declared, const char* p_name, struct MemoPlan* p_plan) {
+	p_plan->strategy = MEMO_NONE;
+	p_plan->bounded	 = attributes_has(p_ast, function, ATTRIBUTE_MEMO_LRU);
+	p_plan->type	 = inference_get_node_type(p_inference, function);
+
+	if (!p_plan->bounded && !attributes_has(p_ast, function, ATTRIBUTE_MEMO)) {
+		return MEMO_NONE;
+	}
+
+	if (!comptime_is_pure(p_self->comptime, declared)) {
+		memo___error(p_self, p_ast, function, p_name,
+					 "it is not pure, so its result may depend on more than its arguments");
+	}
+
+	if (p_plan->type == TYPE_ID_NONE
+		|| type_table_get(p_self->types, p_plan->type)->kind != TYPE_FUNCTION) {
+		memo___error(p_self, p_ast, function, p_name, "its type is unknown");
+	}
+
+	const type_id_t* lp_args   = type_table_get_args(p_self->types, p_plan->type);
+	uint32_t		 paramCount = type_table_get(p_self->types, p_plan->type)->argCount - 1;
+
+	if (paramCount == 0) {
+		memo___error(p_self, p_ast, function, p_name, "it has no parameters to key its cache on");
+	}
+
+	for (uint32_t index = 0; index < paramCount; index++) {
+		if (!memo___is_packable(p_self, lp_args[index])) {
+			memo___error(p_self, p_ast, function, p_name,
+						 "its parameters must be primitives other than 'str'");
+		}
+	}
+
+	if (!memo___is_packable(p_self, lp_args[paramCount])) {
+		memo___error(p_self, p_ast, function, p_name,
+					 "its result must be a primitive other than 'str'");
+	}
+
+	uint8_t primitive = type_table_get(p_self->types, lp_args[0])->primitive;
+
+	p_plan->strategy = MEMO_HASH;
+
+	// Bounded caches only hash, so their limit covers every result
+	if (paramCount == 1 && !p_plan->bounded && primitive != TYPE_PRIMITIVE_F32
+		&& primitive != TYPE_PRIMITIVE_F64) {
+		p_plan->strategy = MEMO_DIRECT;
+	}
+
+	p_self->memoized++;
+	p_self->direct += p_plan->strategy == MEMO_DIRECT;
+	p_self->bounded += p_plan->bounded;
+
+	return p_plan->strategy;
+}
+
+/**
+ * Gets the LLVM type of a packable primitive.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return The LLVM type.
+ */
+const char* memo___llvm_type(const enum TypePrimitives PRIMITIVE) {
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_BOOL:
+		return "i1";
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_U8:
+	case TYPE_PRIMITIVE_CHR:
+		return "i8";
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_U16:
+		return "i16";
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_U32:
+		return "i32";
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+		return "i64";
+	case TYPE_PRIMITIVE_F32:
+		return "float";
+	case TYPE_PRIMITIVE_F64:
+		return "double";
+	default:
+		PANIC("unsupported primitive for '@memo'");
+	}
+}
+
+/**
+ * Emits the packing of a value into an i64, e.g. '%key.0 = sext i32 %arg.0 to i64'. Signed
+ * integers are sign extended, so negative keys never index the direct table.
+ *
+ * @param PRIMITIVE The primitive of the value.
+ * @param p_value   The value.
+ * @param p_result  The name of the packed value.
+ * @param p_output  Where to append the IR.
+ */
+void memo___emit_pack(const enum TypePrimitives PRIMITIVE, const char* p_value,
+					  const char* p_result, struct String* p_output) {
+	const char* lp_from = memo___llvm_type(PRIMITIVE);
+	const char* lp_cast = NULL;
+
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_I32:
+		lp_cast = "sext";
+		break;
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+	case TYPE_PRIMITIVE_F64:
+		lp_cast = "bitcast";
+		break;
+	case TYPE_PRIMITIVE_F32: // Through its bits, as a float cannot be extended to an integer
+		// %result.bits = bitcast float %value to i32
+		string_append_str(p_output, "  ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, ".bits = bitcast float ");
+		string_append_str(p_output, p_value);
+		string_append_str(p_output, " to i32\n");
+
+		// %result = zext i32 %result.bits to i64
+		string_append_str(p_output, "  ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, " = zext i32 ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, ".bits to i64\n");
+		return;
+	default:
+		lp_cast = "zext";
+		break;
+	}
+
+	// %result = cast T %value to i64
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = ");
+	string_append_str(p_output, lp_cast);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, lp_from);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, p_value);
+	string_append_str(p_output, " to i64\n");
+}
+
+/**
+ * Emits the unpacking of a value from an i64, e.g. '%result = trunc i64 %result.key to i32'.
+ *
+ * @param PRIMITIVE The primitive of the value.
+ * @param p_value   The packed value.
+ * @param p_result  The name of the value.
+ * @param p_output  Where to append the IR.
+ */
+void memo___emit_unpack(const enum TypePrimitives PRIMITIVE, const char* p_value,
+						const char* p_result, struct String* p_output) {
+	const char* lp_to	= memo___llvm_type(PRIMITIVE);
+	const char* lp_cast = NULL;
+
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+	case TYPE_PRIMITIVE_F64:
+		lp_cast = "bitcast";
+		break;
+	case TYPE_PRIMITIVE_F32:
+		// %result.bits = trunc i64 %value to i32
+		string_append_str(p_output, "  ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, ".bits = trunc i64 ");
+		string_append_str(p_output, p_value);
+		string_append_str(p_output, " to i32\n");
+
+		// %result = bitcast i32 %result.bits to float
+		string_append_str(p_output, "  ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, " = bitcast i32 ");
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, ".bits to float\n");
+		return;
+	default:
+		lp_cast = "trunc";
+		break;
+	}
+
+	// %result = cast i64 %value to T
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = ");
+	string_append_str(p_output, lp_cast);
+	string_append_str(p_output, " i64 ");
+	string_append_str(p_output, p_value);
+	string_append_str(p_output, " to ");
+	string_append_str(p_output, lp_to);
+	string_append_chr(p_output, '\n');
+}
+
+/**
+ * Emits the parameters or arguments of a memoized function, e.g. 'i32 %arg.0, i1 %arg.1'.
+ *
+ * @param p_self     The current Memo struct.
+ * @param p_args     The function type's arguments.
+ * @param paramCount The number of parameters.
+ * @param p_output   Where to append the IR.
+ */
+void memo___emit_arguments(const struct Memo* p_self, const type_id_t* p_args, uint32_t paramCount,
+						   struct String* p_output) {
+	char argument[MEMO_NAME_LENGTH];
+
+	for (uint32_t index = 0; index < paramCount; index++) {
+		if (index) {
+			string_append_str(p_output, ", ");
+		}
+
+		const struct Type* lp_param = type_table_get(p_self->types, p_args[index]);
+
+		snprintf(argument, sizeof(argument), " %%arg.%" PRIu32, index);
+		string_append_str(p_output, memo___llvm_type(lp_param->primitive));
+		string_append_str(p_output, argument);
+	}
+}
+
+/**
+ * Emits a call to the runtime's cache of a memoized function, keyed on the packed arguments.
+ *
+ * @param p_function The runtime function, e.g. '@memo_SEP_find'.
+ * @param p_name     The memoized function's LLVM name.
+ * @param p_last     The last argument, e.g. 'i64* %cached'.
+ * @param p_output   Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void memo___emit_cache_call(const char* p_function, const char* p_name, const char* p_last,
+							struct String* p_output) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	// FUNCTION(%memo* @"name.memo", i64* %key.0, LAST)
+	string_append_str(p_output, p_function);
+	string_append_str(p_output, "(%memo* @\"");
+	string_append_str(p_output, p_name);
+	string_append_str(p_output, ".memo\", i64* %key.0, ");
+	string_append_str(p_output, p_last);
+	string_append_str(p_output, ")\n");
+}
+
+void memo_emit(const struct Memo* p_self, const struct MemoPlan* p_plan, const char* p_name,
+			   struct String* p_output) {
+	const type_id_t* lp_args	= type_table_get_args(p_self->types, p_plan->type);
+	uint32_t		 paramCount = type_table_get(p_self->types, p_plan->type)->argCount - 1;
+	const char*		 lp_result =
+		memo___llvm_type(type_table_get(p_self->types, lp_args[paramCount])->primitive);
+	char line[MEMO_LINE_LENGTH];
+
+	// @"name.memo" = internal thread_local global %memo { ... }, so caches need no locking
+	snprintf(line, sizeof(line),
+			 ".memo\" = internal thread_local global %%memo { i64* null, i8* null, i64 0, "
+			 "i64 %u, i64* null, i64 0, i64 0, i64 %" PRIu32 ", i64 %u, i64 0 }\n\n",
+			 p_plan->strategy == MEMO_DIRECT ? MEMO_DIRECT_LIMIT : 0U, paramCount,
+			 p_plan->bounded ? MEMO_LRU_LIMIT : 0U);
+	string_append_str(p_output, "@\"");
+	string_append_str(p_output, p_name);
+	string_append_str(p_output, line);
+
+	// define R @"name"(T0 %arg.0, ...) {
+	//   %keys = alloca [N x i64]
+	string_append_str(p_output, "define ");
+	string_append_str(p_output, lp_result);
+	string_append_str(p_output, " @\"");
+	string_append_str(p_output, p_name);
+	string_append_str(p_output, "\"(");
+	memo___emit_arguments(p_self, lp_args, paramCount, p_output);
+	snprintf(line, sizeof(line), ") {\n  %%keys = alloca [%" PRIu32 " x i64]\n", paramCount);
+	string_append_str(p_output, line);
+
+	for (uint32_t index = 0; index < paramCount; index++) {
+		char argument[MEMO_NAME_LENGTH];
+		char key[MEMO_NAME_LENGTH];
+
+		snprintf(argument, sizeof(argument), "%%arg.%" PRIu32, index);
+		snprintf(key, sizeof(key), "%%key.%" PRIu32 ".value", index);
+
+		// %key.i.value = cast Ti %arg.i to i64
+		memo___emit_pack(type_table_get(p_self->types, lp_args[index])->primitive, argument, key,
+						 p_output);
+
+		// %key.i = getelementptr inbounds [N x i64], [N x i64]* %keys, i64 0, i64 i
+		// store i64 %key.i.value, i64* %key.i
+		snprintf(line, sizeof(line),
+				 "  %%key.%" PRIu32 " = getelementptr inbounds [%" PRIu32 " x i64], [%" PRIu32
+				 " x i64]* %%keys, i64 0, i64 %" PRIu32 "\n  store i64 %s, i64* %%key.%" PRIu32
+				 "\n",
+				 index, paramCount, paramCount, index, key, index);
+		string_append_str(p_output, line);
+	}
+
+	// %cached = alloca i64
+	// %found = call i1 @memo_SEP_find(%memo* @"name.memo", i64* %key.0, i64* %cached)
+	// br i1 %found, label %hit, label %miss
+	string_append_str(p_output, "  %cached = alloca i64\n  %found = call i1 ");
+	memo___emit_cache_call("@memo_SEP_find", p_name, "i64* %cached", p_output);
+	string_append_str(p_output, "  br i1 %found, label %hit, label %miss\n\n");
+
+	// hit:
+	//   %result.key = load i64, i64* %cached
+	//   %result = cast i64 %result.key to R
+	//   ret R %result
+	string_append_str(p_output, "hit:\n  %result.key = load i64, i64* %cached\n");
+	memo___emit_unpack(type_table_get(p_self->types, lp_args[paramCount])->primitive,
+					   "%result.key", "%result", p_output);
+	string_append_str(p_output, "  ret ");
+	string_append_str(p_output, lp_result);
+	string_append_str(p_output, " %result\n\nmiss:\n");
+
+	// miss:
+	//   %computed = call R @"name.uncached"(T0 %arg.0, ...)
+	//   %computed.key = cast R %computed to i64
+	//   call void @memo_SEP_insert(%memo* @"name.memo", i64* %key.0, i64 %computed.key)
+	//   ret R %computed
+	string_append_str(p_output, "  %computed = call ");
+	string_append_str(p_output, lp_result);
+	string_append_str(p_output, " @\"");
+	string_append_str(p_output, p_name);
+	string_append_str(p_output, MEMO_UNCACHED_SUFFIX "\"(");
+	memo___emit_arguments(p_self, lp_args, paramCount, p_output);
+	string_append_str(p_output, ")\n");
+	memo___emit_pack(type_table_get(p_self->types, lp_args[paramCount])->primitive, "%computed",
+					 "%computed.key", p_output);
+	string_append_str(p_output, "  call void ");
+	memo___emit_cache_call("@memo_SEP_insert", p_name, "i64 %computed.key", p_output);
+	string_append_str(p_output, "  ret ");
+	string_append_str(p_output, lp_result);
+	string_append_str(p_output, " %computed\n}\n");
+}
@@ -0,0 +1,101 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./comptime.h"
+#include "./infer.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MEMO_DIRECT_LIMIT	 65536U		 // Keys of single integer functions indexed directly.
+#define MEMO_LRU_LIMIT		 4096U		 // Results kept per thread by '@memo_lru' functions.
+#define MEMO_UNCACHED_SUFFIX ".uncached" // Appended to the name of a memoized function's body.
+
+/**
+ * Used to identify how the results of a function are cached.
+ */
+enum MemoStrategies {
+	MEMO_NONE,	 // Not memoized.
+	MEMO_DIRECT, // A single integer parameter, which indexes a table directly while it is small.
+	MEMO_HASH,	 // Anything else, whose arguments are hashed.
+};
+
+/**
+ * Represents how a memoized function is cached.
+ */
+struct MemoPlan {
+	uint8_t	  strategy; // enum MemoStrategies
+	bool	  bounded;	// Whether the least recently used results are evicted past MEMO_LRU_LIMIT.
+	type_id_t type;		// The function's type.
+};
+
+/**
+ * Represents the memoization of functions marked '@memo' or '@memo_lru'. Each function gets a
+ * cache per thread in the runtime, keyed on its arguments, and its body is emitted under another
+ * name behind a wrapper that looks calls up before computing them. Recursive calls go through the
+ * wrapper too, so e.g. a naive 'fibonacci' takes linear instead of exponential time.
+ */
+struct Memo {
+	const char*				filePath; // For diagnostics.
+	const struct TypeTable* types;
+	struct Comptime*		comptime;				 // For the purity of functions.
+	size_t					memoized, direct, bounded; // For the time report.
+};
+
+#define MEMO_STRUCT_SIZE sizeof(struct Memo)
+
+/**
+ * Creates a new Memo struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_types    The module's type table.
+ * @param p_comptime The module's compile time evaluator, which knows which functions are pure.
+ *
+ * @return The created Memo struct.
+ */
+struct Memo* memo_new(const char* p_filePath, const struct TypeTable* p_types,
+					  struct Comptime* p_comptime);
+
+/**
+ * Frees a Memo struct.
+ *
+ * @param p_self The current Memo struct.
+ */
+void memo_free(struct Memo** p_self);
+
+/**
+ * Decides how the last inferred function is cached, if it is marked '@memo' or '@memo_lru'. Errors
+ * if it cannot be memoized: it must be pure, and take and return primitives other than 'str'.
+ *
+ * @param p_self      The current Memo struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param function    The function's node.
+ * @param declared    The index of the function in the Comptime struct, for its purity.
+ * @param p_name      The function's name, for diagnostics.
+ * @param p_plan      Where to write how the function is cached.
+ *
+ * @return How the function is cached, MEMO_NONE if it is not memoized.
+ */
+enum MemoStrategies memo_analyse(struct Memo* p_self, const struct FlatAST* p_ast,
+								 const struct Inference* p_inference, flat_ast_index_t function,
+								 uint32_t declared, const char* p_name, struct MemoPlan* p_plan);
+
+/**
+ * Emits the cache of a memoized function and the wrapper called in its place. The function's body
+ * must be emitted as '@"<name>.uncached"', with its recursive calls still calling '@"<name>"'.
+ *
+ * @param p_self   The current Memo struct.
+ * @param p_plan   How the function is cached, from memo_analyse.
+ * @param p_name   The function's LLVM name, unquoted, e.g. 'memo::fibonacci'.
+ * @param p_output Where to append the IR, at module level.
+ */
+void memo_emit(const struct Memo* p_self, const struct MemoPlan* p_plan, const char* p_name,
+			   struct String* p_output);
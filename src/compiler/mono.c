@@ -0,0 +1,327 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./mono.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MONO_INITIAL_CAPACITY 64U
+
+/**
+ * Hashes an instance key.
+ *
+ * @param declaration The generic declaration's node.
+ * @param args        Tuple of the type arguments.
+ *
+ * @return The hash.
+ */
+uint32_t mono___hash_key(flat_ast_index_t declaration, type_id_t args) {
+	return ((declaration * 16777619U) ^ args) * 2654435761U;
+}
+
+/**
+ * Hashes a body (FNV-1a).
+ *
+ * @param p_ir The body's IR.
+ *
+ * @return The hash.
+ */
+uint64_t mono___hash_body(const char* p_ir) {
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (; *p_ir; p_ir++) {
+		hash = (hash ^ (unsigned char)*p_ir) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * Rebuilds the instance table with double the slots.
+ *
+ * @param p_self The current Monomorphizer struct.
+ */
+void mono___grow_slots(struct Monomorphizer* p_self) {
+	free(p_self->slots);
+
+	p_self->slotCount = p_self->slotCount ? p_self->slotCount * 2 : MONO_INITIAL_CAPACITY;
+	p_self->slots	  = calloc(p_self->slotCount, sizeof(uint32_t));
+
+	if (!p_self->slots) {
+		PANIC("failed to calloc Monomorphizer slots");
+	}
+
+	for (uint32_t index = 0; index < p_self->instanceCount; index++) {
+		const struct MonoInstance* lp_instance = &p_self->instances[index];
+		size_t slot = mono___hash_key(lp_instance->declaration, lp_instance->args)
+					  & (p_self->slotCount - 1);
+
+		while (p_self->slots[slot]) {
+			slot = (slot + 1) & (p_self->slotCount - 1);
+		}
+
+		p_self->slots[slot] = index + 1;
+	}
+}
+
+/**
+ * Finds the slot of a body, or the empty slot it would be inserted into.
+ *
+ * @param p_self The current Monomorphizer struct.
+ * @param hash   The body's hash.
+ * @param p_ir   The body's IR.
+ *
+ * @return The slot.
+ */
+struct MonoBody* mono___find_body(struct Monomorphizer* p_self, uint64_t hash, const char* p_ir) {
+	size_t slot = (size_t)hash & (p_self->bodySlotCount - 1);
+
+	while (p_self->bodies[slot].instance != MONO_INSTANCE_NONE) {
+		if (p_self->bodies[slot].hash == hash && strcmp(p_self->bodies[slot].ir, p_ir) == 0) {
+			break;
+		}
+
+		slot = (slot + 1) & (p_self->bodySlotCount - 1);
+	}
+
+	return &p_self->bodies[slot];
+}
+
+/**
+ * Rebuilds the body table with double the slots.
+ *
+ * @param p_self The current Monomorphizer struct.
+ */
+void mono___grow_bodies(struct Monomorphizer* p_self) {
+	struct MonoBody* lp_old		  = p_self->bodies;
+	size_t			 oldSlotCount = p_self->bodySlotCount;
+
+	p_self->bodySlotCount = oldSlotCount ? oldSlotCount * 2 : MONO_INITIAL_CAPACITY;
+	p_self->bodies		  = malloc(p_self->bodySlotCount * sizeof(struct MonoBody));
+
+	if (!p_self->bodies) {
+		PANIC("failed to malloc Monomorphizer bodies");
+	}
+
+	for (size_t slot = 0; slot < p_self->bodySlotCount; slot++) {
+		p_self->bodies[slot].instance = MONO_INSTANCE_NONE;
+	}
+
+	for (size_t slot = 0; slot < oldSlotCount; slot++) {
+		if (lp_old[slot].instance != MONO_INSTANCE_NONE) {
+			*mono___find_body(p_self, lp_old[slot].hash, lp_old[slot].ir) = lp_old[slot];
+		}
+	}
+
+	free(lp_old);
+}
+
+struct Monomorphizer* mono_new(struct TypeTable* p_types, struct Interner* p_interner) {
+	struct Monomorphizer* lp_self = calloc(1, MONOMORPHIZER_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Monomorphizer struct");
+	}
+
+	lp_self->types	  = p_types;
+	lp_self->interner = p_interner;
+
+	mono___grow_slots(lp_self);
+	mono___grow_bodies(lp_self);
+
+	return lp_self;
+}
+
+void mono_free(struct Monomorphizer** p_self) {
+	if (p_self && *p_self) {
+		for (size_t slot = 0; slot < (*p_self)->bodySlotCount; slot++) {
+			if ((*p_self)->bodies[slot].instance != MONO_INSTANCE_NONE) {
+				free((*p_self)->bodies[slot].ir);
+			}
+		}
+
+		free((*p_self)->instances);
+		free((*p_self)->slots);
+		free((*p_self)->bodies);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Monomorphizer struct has already been freed");
+	}
+}
+
+/**
+ * Mangles the symbol of an instance, e.g. 'max<f64>'.
+ *
+ * @param p_self The current Monomorphizer struct.
+ * @param name   The interned name of the declaration.
+ * @param args   Tuple of the type arguments.
+ *
+ * @return The interned symbol.
+ */
+intern_id_t mono___mangle(struct Monomorphizer* p_self, intern_id_t name, type_id_t args) {
+	struct String* lp_symbol = string_new("\0", true);
+	uint32_t	   argCount	 = type_table_get(p_self->types, args)->argCount;
+
+	string_append_str(lp_symbol, interner_get(p_self->interner, name));
+	string_append_chr(lp_symbol, '<');
+
+	for (uint32_t index = 0; index < argCount; index++) {
+		type_id_t arg	 = type_table_get_args(p_self->types, args)[index];
+		char*	  lp_arg = type_table_to_string(p_self->types, arg);
+
+		if (index) {
+			string_append_str(lp_symbol, ", ");
+		}
+
+		string_append_str(lp_symbol, lp_arg);
+		free(lp_arg);
+	}
+
+	string_append_chr(lp_symbol, '>');
+
+	intern_id_t symbol = interner_intern(p_self->interner, lp_symbol->_value);
+
+	string_free(&lp_symbol);
+
+	return symbol;
+}
+
+uint32_t mono_instantiate(struct Monomorphizer* p_self, flat_ast_index_t declaration,
+						  intern_id_t name, type_id_t type, type_id_t params, type_id_t args) {
+	p_self->requests++;
+
+	size_t slot = mono___hash_key(declaration, args) & (p_self->slotCount - 1);
+
+	while (p_self->slots[slot]) {
+		const struct MonoInstance* lp_instance = &p_self->instances[p_self->slots[slot] - 1];
+
+		if (lp_instance->declaration == declaration && lp_instance->args == args) {
+			return p_self->slots[slot] - 1;
+		}
+
+		slot = (slot + 1) & (p_self->slotCount - 1);
+	}
+
+	p_self->instances = buffer_grow(p_self->instances, &p_self->instanceCapacity,
+									p_self->instanceCount + 1, MONO_INSTANCE_SIZE);
+
+	uint32_t			 index		 = (uint32_t)p_self->instanceCount++;
+	struct MonoInstance* lp_instance = &p_self->instances[index];
+
+	lp_instance->declaration = declaration;
+	lp_instance->params		 = params;
+	lp_instance->args		 = args;
+	lp_instance->type		 = type_table_substitute(p_self->types, type, params, args);
+	lp_instance->symbol		 = mono___mangle(p_self, name, args);
+	lp_instance->canonical	 = index;
+	lp_instance->emitted	 = false;
+
+	p_self->slots[slot] = index + 1;
+
+	if (p_self->instanceCount * 2 > p_self->slotCount) { // Keep the load factor at or below 0.5
+		mono___grow_slots(p_self);
+	}
+
+	return index;
+}
+
+bool mono_next(struct Monomorphizer* p_self, uint32_t* p_instance) {
+	if (p_self->pending >= p_self->instanceCount) {
+		return false;
+	}
+
+	*p_instance = (uint32_t)p_self->pending++;
+
+	return true;
+}
+
+const struct MonoInstance* mono_get(const struct Monomorphizer* p_self, uint32_t instance) {
+	if (instance >= p_self->instanceCount) {
+		PANIC("Monomorphizer get index out of bounds");
+	}
+
+	return &p_self->instances[instance];
+}
+
+/**
+ * Appends a quoted LLVM symbol, e.g. '@"max<f64>"'.
+ *
+ * @param p_self   The current Monomorphizer struct.
+ * @param symbol   The interned symbol.
+ * @param p_output Where to append the symbol.
+ */
+void mono___append_symbol(struct Monomorphizer* p_self, intern_id_t symbol,
+						  struct String* p_output) {
+	string_append_str(p_output, "@\"");
+	string_append_str(p_output, interner_get(p_self->interner, symbol));
+	string_append_chr(p_output, '"');
+}
+
+void mono_emit(struct Monomorphizer* p_self, uint32_t instance, const char* p_llvmType,
+			   const char* p_ir, struct String* p_output) {
+	if (instance >= p_self->instanceCount) {
+		PANIC("Monomorphizer emit index out of bounds");
+	}
+
+	struct MonoInstance* lp_instance = &p_self->instances[instance];
+
+	if (lp_instance->emitted) {
+		PANIC("Monomorphizer instance has already been emitted");
+	}
+
+	lp_instance->emitted = true;
+
+	uint64_t		 hash	 = mono___hash_body(p_ir);
+	struct MonoBody* lp_body = mono___find_body(p_self, hash, p_ir);
+
+	if (lp_body->instance != MONO_INSTANCE_NONE) { // Identical code, alias the first instance
+		lp_instance->canonical = lp_body->instance;
+		p_self->merged++;
+
+		mono___append_symbol(p_self, lp_instance->symbol, p_output);
+		string_append_str(p_output, " = internal alias ");
+		string_append_str(p_output, p_llvmType);
+		string_append_str(p_output, ", ");
+		string_append_str(p_output, p_llvmType);
+		string_append_str(p_output, "* ");
+		mono___append_symbol(p_self, p_self->instances[lp_body->instance].symbol, p_output);
+		string_append_chr(p_output, '\n');
+
+		return;
+	}
+
+	lp_body->hash	  = hash;
+	lp_body->instance = instance;
+	lp_body->ir		  = malloc(strlen(p_ir) + 1);
+
+	if (!lp_body->ir) {
+		PANIC("failed to malloc Monomorphizer body");
+	}
+
+	strcpy(lp_body->ir, p_ir); // NOLINT(clang-analyzer-security.insecureAPI.strcpy)
+
+	if (++p_self->bodyCount * 2 > p_self->bodySlotCount) {
+		mono___grow_bodies(p_self);
+	}
+
+	size_t		placeholderLength = strlen(MONO_SELF_PLACEHOLDER);
+	const char* lp_cursor		  = p_ir;
+	const char* lp_match		  = NULL;
+
+	while ((lp_match = strstr(lp_cursor, MONO_SELF_PLACEHOLDER))) { // Give the body its symbol
+		for (; lp_cursor < lp_match; lp_cursor++) {
+			string_append_chr(p_output, *lp_cursor);
+		}
+
+		mono___append_symbol(p_self, lp_instance->symbol, p_output);
+		lp_cursor += placeholderLength;
+	}
+
+	string_append_bytes(p_output, lp_cursor, strlen(lp_cursor));
+}
@@ -0,0 +1,132 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MONO_INSTANCE_NONE UINT32_MAX
+
+// Stands in for an instance's own symbol in its IR, so instances differing only in name compare
+// equal.
+#define MONO_SELF_PLACEHOLDER "@__mono_self"
+
+/**
+ * Represents an instantiation of a generic declaration with concrete type arguments.
+ */
+struct MonoInstance {
+	flat_ast_index_t declaration; // The generic declaration's node.
+	type_id_t		 params;	  // Tuple of the declaration's type parameters.
+	type_id_t		 args;		  // Tuple of the type arguments, interned so equal args share ids.
+	type_id_t		 type;		  // The declaration's type with the arguments substituted.
+	intern_id_t		 symbol;	  // The mangled symbol, e.g. 'add<i32>'.
+	uint32_t		 canonical;	  // The instance whose code this one reuses, or itself.
+	bool			 emitted;
+};
+
+#define MONO_INSTANCE_SIZE sizeof(struct MonoInstance)
+
+/**
+ * Represents the canonical instance emitted for a given body, used to merge instances whose IR is
+ * identical (e.g. 'add<i32>' and 'add<u32>').
+ */
+struct MonoBody {
+	uint64_t hash;
+	uint32_t instance;
+	char*	 ir; // The IR, with MONO_SELF_PLACEHOLDER as the function's own symbol.
+};
+
+/**
+ * Represents the monomorphizer of a module. Every (generic declaration, type arguments) pair is
+ * instantiated once per build and queued for code generation; instances whose generated IR turns
+ * out identical are emitted once, and the others become aliases of it.
+ */
+struct Monomorphizer {
+	struct TypeTable*	 types;
+	struct Interner*	 interner;
+	struct MonoInstance* instances;
+	uint32_t*			 slots;	 // Open addressing table of instance indexes + 1.
+	struct MonoBody*	 bodies; // Open addressing table of canonical bodies.
+	size_t instanceCount, instanceCapacity, slotCount, bodyCount, bodySlotCount;
+	size_t pending;			 // Instances before this index have been handed out.
+	size_t requests, merged; // For the time report.
+};
+
+#define MONOMORPHIZER_STRUCT_SIZE sizeof(struct Monomorphizer)
+
+/**
+ * Creates a new Monomorphizer struct.
+ *
+ * @param p_types    The module's type table.
+ * @param p_interner The module's interner.
+ *
+ * @return The created Monomorphizer struct.
+ */
+struct Monomorphizer* mono_new(struct TypeTable* p_types, struct Interner* p_interner);
+
+/**
+ * Frees a Monomorphizer struct.
+ *
+ * @param p_self The current Monomorphizer struct.
+ */
+void mono_free(struct Monomorphizer** p_self);
+
+/**
+ * Gets the instance of a generic declaration for some type arguments, creating and queueing it
+ * for code generation the first time it is requested.
+ *
+ * @param p_self      The current Monomorphizer struct.
+ * @param declaration The generic declaration's node.
+ * @param name        The interned name of the declaration.
+ * @param type        The declaration's generic type.
+ * @param params      Tuple of the declaration's type parameters.
+ * @param args        Tuple of the type arguments.
+ *
+ * @return The index of the instance.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+uint32_t mono_instantiate(struct Monomorphizer* p_self, flat_ast_index_t declaration,
+						  intern_id_t name, type_id_t type, type_id_t params, type_id_t args);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Gets the next instance waiting for code generation. Generating an instance can request more
+ * instances, which are handed out by later calls.
+ *
+ * @param p_self     The current Monomorphizer struct.
+ * @param p_instance Where to write the index of the instance.
+ *
+ * @return Whether there was an instance waiting.
+ */
+bool mono_next(struct Monomorphizer* p_self, uint32_t* p_instance);
+
+/**
+ * Gets an instance. The pointer is invalidated by the next instantiation.
+ *
+ * @param p_self   The current Monomorphizer struct.
+ * @param instance The index of the instance.
+ *
+ * @return The instance.
+ */
+const struct MonoInstance* mono_get(const struct Monomorphizer* p_self, uint32_t instance);
+
+/**
+ * Emits the generated IR of an instance. If an instance with identical IR has already been
+ * emitted, an alias to it is emitted instead.
+ *
+ * @param p_self     The current Monomorphizer struct.
+ * @param instance   The index of the instance.
+ * @param p_llvmType The LLVM type of the function, e.g. 'i32 (i32, i32)'.
+ * @param p_ir       The function's IR, using MONO_SELF_PLACEHOLDER as its own symbol.
+ * @param p_output   Where to append the IR to emit.
+ */
+void mono_emit(struct Monomorphizer* p_self, uint32_t instance, const char* p_llvmType,
+			   const char* p_ir, struct String* p_output);
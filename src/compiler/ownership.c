@@ -0,0 +1,1200 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./ownership.h"
+#include "./diagnostics.h"
+#include "../globals.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OWNERSHIP_LINE_LENGTH	   1024U
+#define OWNERSHIP_NO_SLOT		   UINT32_MAX
+#define OWNERSHIP_SUMMARY_KNOWN	   (1U << 31U) // Set in the summary of every analysed function.
+#define OWNERSHIP_SUMMARY_PARAMS   31U		   // Parameters after this one are always kept.
+
+#define OWNERSHIP_RUNTIME_MODULE "io"	  // The runtime's module whose functions only read.
+#define OWNERSHIP_APPEND_METHOD	 "append" // The only runtime method keeping an argument.
+#define OWNERSHIP_GET_METHOD	 "get"	  // Reads an element of an array.
+
+// X-Macro to define transfer explanations
+static char* const g_OWNERSHIP_TRANSFER_NAMES_INTERNAL[] = {
+#define OWNERSHIP_TRANSFER_TO_STRING(name, string) string,
+	OWNERSHIP_TRANSFERS(OWNERSHIP_TRANSFER_TO_STRING)
+#undef OWNERSHIP_TRANSFER_TO_STRING
+};
+
+const struct Array g_OWNERSHIP_TRANSFER_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_OWNERSHIP_TRANSFER_NAMES_INTERNAL,
+						sizeof(g_OWNERSHIP_TRANSFER_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* ownership_transfer_get_name(const enum OwnershipTransfers TRANSFER) {
+	if ((size_t)TRANSFER + 1 > g_OWNERSHIP_TRANSFER_NAMES.length) {
+		PANIC("g_OWNERSHIP_TRANSFER_NAMES get index out of bounds");
+	}
+
+	return g_OWNERSHIP_TRANSFER_NAMES._values[TRANSFER];
+}
+
+struct Ownership* ownership_new(const char* p_filePath, struct Interner* p_interner,
+								const struct TypeTable*	  p_types,
+								const struct LayoutTable* p_layouts, struct Report* p_report) {
+	struct Ownership* lp_self = calloc(1, OWNERSHIP_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Ownership struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->interner = p_interner;
+	lp_self->types	  = p_types;
+	lp_self->layouts  = p_layouts;
+	lp_self->report	  = p_report;
+
+	return lp_self;
+}
+
+void ownership_free(struct Ownership** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->transfers);
+		free((*p_self)->slots);
+		free((*p_self)->declared);
+		free((*p_self)->moved);
+		free((*p_self)->summaries);
+		free((*p_self)->cloners);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Ownership struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether a type is an array, 'Array<T>'.
+ *
+ * @param p_self The current Ownership struct.
+ * @param type   The type.
+ *
+ * @return Whether the type is an array.
+ */
+bool ownership___is_array(const struct Ownership* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return false;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	return lp_type->kind == TYPE_NAMED && lp_type->argCount == 1
+		   && strcmp(interner_get(p_self->types->interner, lp_type->name), "Array") == 0;
+}
+
+/**
+ * Checks whether values of a type own a buffer, i.e. are strings or arrays. Other types, including
+ * the ones not known yet, are never moved.
+ *
+ * @param p_self The current Ownership struct.
+ * @param type   The type.
+ *
+ * @return Whether values of the type own a buffer.
+ */
+bool ownership___owns(const struct Ownership* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return false;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (lp_type->kind == TYPE_PRIMITIVE) {
+		return lp_type->primitive == TYPE_PRIMITIVE_STR;
+	}
+
+	return ownership___is_array(p_self, type);
+}
+
+/**
+ * Checks whether a node's value owns a buffer.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The node.
+ *
+ * @return Whether the value owns a buffer.
+ */
+bool ownership___owning(const struct Ownership* p_self, flat_ast_index_t node) {
+	return ownership___owns(p_self, inference_get_node_type(p_self->inference, node));
+}
+
+/**
+ * Gets the name of a node, for the report and diagnostics.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The node.
+ *
+ * @return The name of locals and members, '<expression>' for anything else.
+ */
+const char* ownership___name(const struct Ownership* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (lp_node->kind != FLATAST_VARIABLE && lp_node->kind != FLATAST_MEMBER) {
+		return "<expression>";
+	}
+
+	return flat_ast_get_string(p_self->ast, lp_node->value.string);
+}
+
+/**
+ * Gets the slot of a local of the current function in 'moved'.
+ *
+ * @param p_self  The current Ownership struct.
+ * @param node    A node holding the local's name.
+ * @param declare Whether to declare the local if it is new.
+ *
+ * @return The local's slot, OWNERSHIP_NO_SLOT if it is not a local.
+ */
+uint32_t ownership___slot(struct Ownership* p_self, flat_ast_index_t node, bool declare) {
+	const char* lp_name =
+		flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, node)->value.string);
+	intern_id_t name = declare ? interner_intern(p_self->interner, lp_name)
+							   : interner_find(p_self->interner, lp_name);
+
+	if (name == INTERN_ID_NONE || (!declare && name >= p_self->slotCapacity)) {
+		return OWNERSHIP_NO_SLOT;
+	}
+
+	p_self->slots = buffer_grow(p_self->slots, &p_self->slotCapacity, (size_t)name + 1,
+								sizeof(uint32_t));
+
+	if (!p_self->slots[name] && declare) {
+		size_t capacity = p_self->declaredCapacity;
+
+		p_self->moved	 = buffer_grow(p_self->moved, &capacity, p_self->declaredCount + 1,
+									   sizeof(flat_ast_index_t));
+		p_self->declared = buffer_grow(p_self->declared, &p_self->declaredCapacity,
+									   p_self->declaredCount + 1, sizeof(intern_id_t));
+		p_self->declared[p_self->declaredCount] = name;
+		p_self->moved[p_self->declaredCount]	= FLATAST_INDEX_NONE;
+		p_self->slots[name]						= (uint32_t)++p_self->declaredCount;
+	}
+
+	return p_self->slots[name] ? p_self->slots[name] - 1 : OWNERSHIP_NO_SLOT;
+}
+
+/**
+ * Declares a local, or a local again, e.g. when it is assigned, as not moved. The slot is got
+ * first, as declaring it may move 'moved'.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   A node holding the local's name.
+ */
+void ownership___declare(struct Ownership* p_self, flat_ast_index_t node) {
+	uint32_t slot = ownership___slot(p_self, node, true);
+
+	p_self->moved[slot] = FLATAST_INDEX_NONE;
+}
+
+/**
+ * Forgets the locals declared after some point, once their function ends.
+ *
+ * @param p_self The current Ownership struct.
+ * @param count  The number of locals declared before that point.
+ */
+void ownership___forget(struct Ownership* p_self, size_t count) {
+	while (p_self->declaredCount > count) {
+		p_self->slots[p_self->declared[--p_self->declaredCount]] = 0;
+	}
+}
+
+/**
+ * Gets the interned name of the function a call calls, e.g. 'Stack.push' for 'stack.push()'.
+ *
+ * @param p_self The current Ownership struct.
+ * @param callee The callee's node.
+ *
+ * @return The name, INTERN_ID_NONE if the callee is not a named function or method.
+ */
+intern_id_t ownership___callee(const struct Ownership* p_self, flat_ast_index_t callee) {
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, callee);
+
+	if (lp_callee->kind == FLATAST_VARIABLE) {
+		return interner_find(p_self->interner,
+							 flat_ast_get_string(p_self->ast, lp_callee->value.string));
+	}
+
+	if (lp_callee->kind != FLATAST_MEMBER) {
+		return INTERN_ID_NONE;
+	}
+
+	// Methods are named after their type
+	type_id_t receiver = inference_get_node_type(p_self->inference, lp_callee->lhs);
+
+	if (receiver == TYPE_ID_NONE || type_table_get(p_self->types, receiver)->kind != TYPE_NAMED) {
+		return INTERN_ID_NONE;
+	}
+
+	char* lp_symbol = CONCATENATE_STRING(
+		interner_get(p_self->interner, type_table_get(p_self->types, receiver)->name), ".",
+		flat_ast_get_string(p_self->ast, lp_callee->value.string));
+	intern_id_t name = interner_find(p_self->interner, lp_symbol);
+
+	free(lp_symbol);
+
+	return name;
+}
+
+/**
+ * Gets the summary of a callee, i.e. which of its parameters it keeps.
+ *
+ * @param p_self The current Ownership struct.
+ * @param callee The callee's node.
+ *
+ * @return The summary, 0 if the callee has not been summarised.
+ */
+uint32_t ownership___summary(const struct Ownership* p_self, flat_ast_index_t callee) {
+	intern_id_t name = ownership___callee(p_self, callee);
+
+	return name != INTERN_ID_NONE && name < p_self->summaryCapacity ? p_self->summaries[name] : 0;
+}
+
+/**
+ * Adds a deep copy to the copies report.
+ *
+ * @param p_self   The current Ownership struct.
+ * @param node     The copied value's node.
+ * @param TRANSFER Why it is copied.
+ */
+void ownership___report(const struct Ownership* p_self, flat_ast_index_t node,
+						const enum OwnershipTransfers TRANSFER) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	char*					  lp_type =
+		type_table_to_string(p_self->types, inference_get_node_type(p_self->inference, node));
+	char value[256];
+	char line[OWNERSHIP_LINE_LENGTH];
+
+	if (lp_node->kind == FLATAST_CALL) { // e.g. 'lines.clone()' or 'lines.get(0)'
+		const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+
+		snprintf(value, sizeof(value), "%.100s.%.100s()", ownership___name(p_self, lp_callee->lhs),
+				 ownership___name(p_self, lp_node->lhs));
+	} else if (lp_node->kind == FLATAST_MEMBER) { // e.g. 'request.lines'
+		snprintf(value, sizeof(value), "%.100s.%.100s", ownership___name(p_self, lp_node->lhs),
+				 ownership___name(p_self, node));
+	} else {
+		snprintf(value, sizeof(value), "%.100s", ownership___name(p_self, node));
+	}
+
+	snprintf(line, sizeof(line), "%.200s:%u: '%s' (%.100s) in %.100s is deep copied: %s",
+			 p_self->filePath, lp_node->line + 1, value, lp_type, p_self->name,
+			 ownership_transfer_get_name(TRANSFER));
+	report_add(p_self->report, REPORT_COPIES, line);
+	free(lp_type);
+}
+
+/**
+ * Records how a value gets where it is used. Nothing is recorded while a loop is walked again.
+ *
+ * @param p_self   The current Ownership struct.
+ * @param node     The value's node.
+ * @param TRANSFER The transfer.
+ */
+void ownership___record(struct Ownership* p_self, flat_ast_index_t node,
+						const enum OwnershipTransfers TRANSFER) {
+	if (p_self->replaying) {
+		return;
+	}
+
+	p_self->transfers[node] = (uint8_t)TRANSFER;
+
+	switch (TRANSFER) {
+	case OWNERSHIP_NONE:
+		break;
+	case OWNERSHIP_BORROW:
+		p_self->borrows++;
+		break;
+	case OWNERSHIP_MOVE:
+		p_self->moves++;
+		break;
+	default:
+		p_self->copies++;
+
+		if (report_enabled(p_self->report, REPORT_COPIES)) {
+			ownership___report(p_self, node, TRANSFER);
+		}
+		break;
+	}
+}
+
+/**
+ * Checks a use of a local, erroring if it was moved.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   A node holding the local's name.
+ */
+void ownership___use(struct Ownership* p_self, flat_ast_index_t node) {
+	uint32_t slot = ownership___slot(p_self, node, false);
+
+	if (slot == OWNERSHIP_NO_SLOT || p_self->moved[slot] == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const char* lp_name = ownership___name(p_self, node);
+	char		message[OWNERSHIP_LINE_LENGTH];
+
+	snprintf(message, sizeof(message),
+			 "'%.100s' is used after being moved on line %u, pass '%.100s.clone()' there to keep "
+			 "using it",
+			 lp_name, flat_ast_get(p_self->ast, p_self->moved[slot])->line + 1, lp_name);
+	compiler_error(p_self->filePath, flat_ast_get(p_self->ast, node)->line, C0013, message);
+}
+
+void ownership___walk(struct Ownership* p_self, flat_ast_index_t node);
+
+/**
+ * Walks a value the current function only lends.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The value's node.
+ */
+void ownership___borrow(struct Ownership* p_self, flat_ast_index_t node) {
+	ownership___walk(p_self, node);
+
+	if (ownership___owning(p_self, node)) {
+		ownership___record(p_self, node, OWNERSHIP_BORROW);
+	}
+}
+
+/**
+ * Walks a value that goes somewhere keeping it: moved if it can be, copied otherwise.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The value's node (can be FLATAST_INDEX_NONE).
+ */
+void ownership___sink(struct Ownership* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	ownership___walk(p_self, node);
+
+	if (!ownership___owning(p_self, node)) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_VARIABLE: {
+		uint32_t slot = ownership___slot(p_self, node, false);
+
+		if (slot == OWNERSHIP_NO_SLOT) {
+			ownership___record(p_self, node, OWNERSHIP_GLOBAL);
+		} else if (slot < p_self->outer) {
+			ownership___record(p_self, node, OWNERSHIP_CAPTURED);
+		} else {
+			ownership___record(p_self, node, OWNERSHIP_MOVE);
+			p_self->moved[slot] = node;
+
+			if (slot < p_self->params && slot < OWNERSHIP_SUMMARY_PARAMS) {
+				p_self->kept |= 1U << slot;
+			}
+		}
+		break;
+	}
+	case FLATAST_MEMBER:
+		ownership___record(p_self, node, OWNERSHIP_FIELD);
+		break;
+	case FLATAST_CALL: {
+		const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+		bool					  element =
+			lp_callee->kind == FLATAST_MEMBER && ownership___owning(p_self, lp_callee->lhs)
+			&& strcmp(ownership___name(p_self, lp_node->lhs), OWNERSHIP_GET_METHOD) == 0;
+
+		if (p_self->transfers[node] == OWNERSHIP_CLONE) {
+			break;
+		}
+
+		// The result of a call is a temporary, unless it is an element still in its array
+		ownership___record(p_self, node, element ? OWNERSHIP_ELEMENT : OWNERSHIP_MOVE);
+		break;
+	}
+	default: // Literals, and the temporaries operators make
+		ownership___record(p_self, node, OWNERSHIP_MOVE);
+		break;
+	}
+}
+
+/**
+ * Walks a call. Receivers are borrowed, and arguments moved to the parameters the callee keeps.
+ * Methods of strings, arrays and SIMD vectors, and the functions of OWNERSHIP_RUNTIME_MODULE, are
+ * the runtime's, which only keeps the elements appended to arrays.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The call's node.
+ */
+void ownership___call(struct Ownership* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+	uint32_t				  summary	= ownership___summary(p_self, lp_node->lhs);
+	uint32_t				  param		= 0;
+
+	if (lp_callee->kind == FLATAST_MEMBER) { // The receiver is the first parameter
+		const char* lp_method = ownership___name(p_self, lp_node->lhs);
+
+		if (ownership___owning(p_self, lp_callee->lhs)) {
+			if (strcmp(lp_method, OWNERSHIP_CLONE_METHOD) == 0) {
+				ownership___borrow(p_self, lp_callee->lhs);
+				ownership___record(p_self, node, OWNERSHIP_CLONE);
+				return;
+			}
+
+			bool append = strcmp(lp_method, OWNERSHIP_APPEND_METHOD) == 0
+						  && ownership___is_array(p_self, inference_get_node_type(
+															  p_self->inference, lp_callee->lhs));
+
+			summary = OWNERSHIP_SUMMARY_KNOWN | (append ? 2U : 0U);
+		}
+
+		type_id_t receiver = inference_get_node_type(p_self->inference, lp_callee->lhs);
+
+		if (receiver != TYPE_ID_NONE
+			&& type_table_get(p_self->types, receiver)->kind == TYPE_VECTOR) { // Intrinsics
+			summary = OWNERSHIP_SUMMARY_KNOWN;
+		}
+
+		ownership___borrow(p_self, lp_callee->lhs);
+		param++;
+	} else if (lp_callee->kind == FLATAST_BINARY
+			   && lp_callee->operation == LEXERTOKENS_SCOPE_RESOLUTION) { // e.g. 'io::out'
+		const struct FlatASTNode* lp_module = flat_ast_get(p_self->ast, lp_callee->lhs);
+
+		if (lp_module->kind == FLATAST_VARIABLE
+			&& strcmp(flat_ast_get_string(p_self->ast, lp_module->value.string),
+					  OWNERSHIP_RUNTIME_MODULE)
+				   == 0) {
+			summary = OWNERSHIP_SUMMARY_KNOWN;
+		}
+	} else if (lp_callee->kind != FLATAST_VARIABLE) {
+		ownership___walk(p_self, lp_node->lhs);
+	}
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++, param++) {
+		flat_ast_index_t arg = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+		if (!(summary & OWNERSHIP_SUMMARY_KNOWN) || param >= OWNERSHIP_SUMMARY_PARAMS
+			|| (summary & (1U << param))) {
+			ownership___sink(p_self, arg);
+		} else {
+			ownership___borrow(p_self, arg);
+		}
+	}
+}
+
+/**
+ * Walks a path of a branch from the state before the branch, and merges the locals it moves into
+ * the ones moved by the other paths. Paths that return are left out.
+ *
+ * @param p_self      The current Ownership struct.
+ * @param path        The path's node (FLATAST_INDEX_NONE for a path doing nothing).
+ * @param p_start     The moved locals before the branch.
+ * @param p_merged    The moved locals after the paths walked so far.
+ * @param count       The number of locals declared before the branch.
+ * @param p_reachable Whether any path walked so far does not return.
+ */
+void ownership___path(struct Ownership* p_self, flat_ast_index_t path,
+					  const flat_ast_index_t* p_start, flat_ast_index_t* p_merged, size_t count,
+					  bool* p_reachable) {
+	memcpy(p_self->moved, p_start, count * sizeof(flat_ast_index_t));
+	memset(p_self->moved + count, 0, (p_self->declaredCount - count) * sizeof(flat_ast_index_t));
+	p_self->returned = false;
+
+	ownership___walk(p_self, path);
+
+	if (p_self->returned) {
+		return;
+	}
+
+	for (size_t slot = 0; slot < count; slot++) {
+		if (p_merged[slot] == FLATAST_INDEX_NONE) {
+			p_merged[slot] = p_self->moved[slot];
+		}
+	}
+
+	*p_reachable = true;
+}
+
+/**
+ * Copies the moved locals, to walk the paths of a branch or a loop from them.
+ *
+ * @param p_self The current Ownership struct.
+ *
+ * @return The copy.
+ */
+flat_ast_index_t* ownership___save(const struct Ownership* p_self) {
+	flat_ast_index_t* lp_state = calloc(p_self->declaredCount + 1, sizeof(flat_ast_index_t));
+
+	if (!lp_state) {
+		PANIC("failed to malloc Ownership state");
+	}
+
+	memcpy(lp_state, p_self->moved, p_self->declaredCount * sizeof(flat_ast_index_t));
+
+	return lp_state;
+}
+
+/**
+ * Walks the branches of an 'if' (with its 'elif' and 'else' branches) or of a match. A local is
+ * moved after them if any path that does not return moves it.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The 'if' or match's node.
+ */
+void ownership___branches(struct Ownership* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	   = flat_ast_get(p_self->ast, node);
+	size_t					  count		   = p_self->declaredCount;
+	flat_ast_index_t*		  lp_start	   = ownership___save(p_self);
+	flat_ast_index_t*		  lp_merged	   = calloc(count + 1, sizeof(flat_ast_index_t));
+	bool					  reachable	   = false;
+	bool					  exhaustive   = lp_node->kind == FLATAST_MATCH;
+
+	if (!lp_merged) {
+		PANIC("failed to malloc Ownership state");
+	}
+
+	if (lp_node->kind == FLATAST_IF) {
+		ownership___path(p_self, lp_node->rhs, lp_start, lp_merged, count, &reachable);
+	}
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		flat_ast_index_t branch = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+		if (flat_ast_get(p_self->ast, branch)->kind == FLATAST_BLOCK) { // else
+			exhaustive = true;
+		}
+
+		ownership___path(p_self, branch, lp_start, lp_merged, count, &reachable);
+	}
+
+	if (!exhaustive) { // None of the branches is taken
+		ownership___path(p_self, FLATAST_INDEX_NONE, lp_start, lp_merged, count, &reachable);
+	}
+
+	memcpy(p_self->moved, lp_merged, count * sizeof(flat_ast_index_t));
+	memset(p_self->moved + count, 0, (p_self->declaredCount - count) * sizeof(flat_ast_index_t));
+	p_self->returned = !reachable;
+
+	free(lp_start);
+	free(lp_merged);
+}
+
+/**
+ * Walks a loop. If its body moves locals declared before it, it is walked again as its next
+ * iteration would run, so using them before they are assigned again errors. A local is moved
+ * after the loop if an iteration moves it.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The loop's node.
+ */
+void ownership___loop(struct Ownership* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	size_t					  count		= p_self->declaredCount;
+	flat_ast_index_t*		  lp_start	= ownership___save(p_self);
+	bool					  replaying = p_self->replaying;
+
+	for (size_t pass = 0; pass < 2; pass++) {
+		if (lp_node->kind == FLATAST_FOR) { // The bindings are new elements each iteration
+			ownership___borrow(p_self, lp_node->lhs);
+
+			for (size_t index = 0; index < lp_node->value.list.length; index++) {
+				ownership___declare(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+			}
+		} else {
+			ownership___walk(p_self, lp_node->lhs);
+		}
+
+		ownership___walk(p_self, lp_node->rhs);
+
+		bool moved = false;
+
+		for (size_t slot = 0; slot < count && !p_self->returned; slot++) {
+			moved |= lp_start[slot] == FLATAST_INDEX_NONE && p_self->moved[slot] != lp_start[slot];
+		}
+
+		if (!moved) {
+			break;
+		}
+
+		p_self->replaying = true;
+	}
+
+	p_self->replaying = replaying;
+
+	for (size_t slot = 0; slot < count; slot++) { // Merged with running no iterations
+		if (p_self->returned || p_self->moved[slot] == FLATAST_INDEX_NONE) {
+			p_self->moved[slot] = lp_start[slot];
+		}
+	}
+
+	p_self->returned = false;
+	free(lp_start);
+}
+
+/**
+ * Declares the variables of a pattern of a match.
+ *
+ * @param p_self  The current Ownership struct.
+ * @param pattern The pattern's node.
+ */
+void ownership___bind(struct Ownership* p_self, flat_ast_index_t pattern) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+
+	if (lp_pattern->kind == FLATAST_VARIABLE
+		&& strcmp(flat_ast_get_string(p_self->ast, lp_pattern->value.string), "_") != 0) {
+		ownership___declare(p_self, pattern);
+	} else if (lp_pattern->kind == FLATAST_STRUCT_LITERAL) {
+		for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+			flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_pattern, index);
+
+			ownership___bind(p_self, flat_ast_get(p_self->ast, field)->lhs);
+		}
+	}
+}
+
+/**
+ * Walks an assignment. The value is moved to the target, and a local assigned can be used again.
+ * Compound assignments, e.g. 'text += line', only read the value.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The assignment's node.
+ */
+void ownership___assign(struct Ownership* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, lp_node->lhs);
+
+	if (lp_node->operation != LEXERTOKENS_ASSIGNMENT) {
+		ownership___borrow(p_self, lp_node->rhs);
+		ownership___walk(p_self, lp_node->lhs);
+		return;
+	}
+
+	ownership___sink(p_self, lp_node->rhs);
+
+	switch (lp_target->kind) {
+	case FLATAST_VARIABLE:
+	case FLATAST_FIELD: // Including typed declarations, e.g. 'lines: Array<str> = ...'
+		ownership___declare(p_self, lp_node->lhs);
+		break;
+	case FLATAST_MEMBER: // 'object.field = value' uses the object
+		ownership___walk(p_self, lp_target->lhs);
+		break;
+	default:
+		ownership___walk(p_self, lp_node->lhs);
+		break;
+	}
+}
+
+/**
+ * Walks a nested function. The locals of the enclosing functions it uses are only copied into it,
+ * as it may run more than once.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The function's node.
+ */
+void ownership___closure(struct Ownership* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node  = flat_ast_get(p_self->ast, node);
+	size_t					  count	   = p_self->declaredCount;
+	size_t					  outer	   = p_self->outer;
+	size_t					  params   = p_self->params;
+	uint32_t				  kept	   = p_self->kept;
+	bool					  returned = p_self->returned;
+
+	p_self->outer  = count;
+	p_self->params = 0;
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		ownership___declare(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+	}
+
+	ownership___walk(p_self, lp_node->rhs);
+	ownership___forget(p_self, count);
+
+	p_self->outer	 = outer;
+	p_self->params	 = params;
+	p_self->kept	 = kept;
+	p_self->returned = returned;
+}
+
+/**
+ * Walks a node of the current function, in the order it runs.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The node (can be FLATAST_INDEX_NONE).
+ */
+void ownership___walk(struct Ownership* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_VARIABLE:
+		ownership___use(p_self, node);
+		break;
+	case FLATAST_UNARY:
+	case FLATAST_MEMBER: // What is read from a value uses the value
+		ownership___walk(p_self, lp_node->lhs);
+		break;
+	case FLATAST_BINARY:
+		if (lp_node->operation != LEXERTOKENS_SCOPE_RESOLUTION) {
+			ownership___walk(p_self, lp_node->lhs);
+			ownership___walk(p_self, lp_node->rhs);
+		}
+		break;
+	case FLATAST_ASSIGNMENT:
+		ownership___assign(p_self, node);
+		break;
+	case FLATAST_CALL:
+		ownership___call(p_self, node);
+		break;
+	case FLATAST_STRUCT_LITERAL: // The fields keep their values
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_node, index);
+
+			ownership___sink(p_self, flat_ast_get(p_self->ast, field)->lhs);
+		}
+		break;
+	case FLATAST_ARRAY_LITERAL: // The elements too
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			ownership___sink(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	case FLATAST_BLOCK:
+		for (size_t index = 0; index < lp_node->value.list.length && !p_self->returned; index++) {
+			ownership___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	case FLATAST_IF:
+		ownership___walk(p_self, lp_node->lhs);
+		ownership___branches(p_self, node);
+		break;
+	case FLATAST_MATCH:
+		ownership___borrow(p_self, lp_node->lhs);
+		ownership___branches(p_self, node);
+		break;
+	case FLATAST_CASE:
+		ownership___bind(p_self, lp_node->lhs);
+		ownership___walk(p_self, lp_node->rhs);
+		break;
+	case FLATAST_WHILE:
+	case FLATAST_FOR:
+		ownership___loop(p_self, node);
+		break;
+	case FLATAST_RETURN:
+		ownership___sink(p_self, lp_node->lhs);
+		p_self->returned = true;
+		break;
+	case FLATAST_FUNCTION:
+		ownership___closure(p_self, node);
+		break;
+	default: // Literals, types and declarations without a value
+		break;
+	}
+}
+
+/**
+ * Walks a function, deciding how its owning values get where they are used.
+ *
+ * @param p_self      The current Ownership struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was inferred with.
+ * @param function    The function's node.
+ * @param p_name      The function's name.
+ * @param summarising Whether only its summary is wanted, so nothing is recorded.
+ *
+ * @return The parameters the function keeps.
+ */
+uint32_t ownership___analyse(struct Ownership* p_self, const struct FlatAST* p_ast,
+							 const struct Inference* p_inference, flat_ast_index_t function,
+							 const char* p_name, bool summarising) {
+	const struct FlatASTNode* lp_function = flat_ast_get(p_ast, function);
+
+	p_self->transfers = buffer_grow(p_self->transfers, &p_self->nodeCapacity, p_ast->nodeCount,
+									sizeof(uint8_t));
+
+	p_self->ast		  = p_ast;
+	p_self->inference = p_inference;
+	p_self->name	  = p_name;
+	p_self->outer	  = 0;
+	p_self->kept	  = 0;
+	p_self->replaying = summarising;
+	p_self->returned  = false;
+
+	ownership___forget(p_self, 0);
+
+	for (size_t index = 0; index < lp_function->value.list.length; index++) {
+		ownership___slot(p_self, flat_ast_get_list_item(p_ast, lp_function, index), true);
+	}
+
+	p_self->params = p_self->declaredCount;
+	ownership___walk(p_self, lp_function->rhs);
+
+	p_self->replaying = false;
+
+	return p_self->kept;
+}
+
+/**
+ * Stores the summary of a function, for its callers.
+ *
+ * @param p_self The current Ownership struct.
+ * @param p_name The function's name.
+ * @param kept   The parameters it keeps.
+ *
+ * @return Whether the summary changed.
+ */
+bool ownership___store(struct Ownership* p_self, const char* p_name, uint32_t kept) {
+	intern_id_t name = interner_intern(p_self->interner, p_name);
+
+	p_self->summaries = buffer_grow(p_self->summaries, &p_self->summaryCapacity, (size_t)name + 1,
+									sizeof(uint32_t));
+
+	if (p_self->summaries[name] == (OWNERSHIP_SUMMARY_KNOWN | kept)) {
+		return false;
+	}
+
+	p_self->summaries[name] = OWNERSHIP_SUMMARY_KNOWN | kept;
+
+	return true;
+}
+
+/**
+ * Adds the functions of the module a node calls to the call graph, including from its nested
+ * functions.
+ *
+ * @param p_self  The current Ownership struct.
+ * @param p_graph The call graph.
+ * @param node    The node (can be FLATAST_INDEX_NONE).
+ */
+void ownership___collect(struct Ownership* p_self, struct OwnershipGraph* p_graph,
+						 flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (lp_node->kind == FLATAST_CALL) {
+		intern_id_t name = ownership___callee(p_self, lp_node->lhs);
+
+		if (name != INTERN_ID_NONE && name < p_graph->nameCount && p_graph->functionOf[name]) {
+			p_graph->edges = buffer_grow(p_graph->edges, &p_graph->edgeCapacity,
+										 p_graph->edgeCount + 1, sizeof(uint32_t));
+			p_graph->edges[p_graph->edgeCount++] = p_graph->functionOf[name] - 1;
+		}
+	}
+
+	ownership___collect(p_self, p_graph, lp_node->lhs);
+	ownership___collect(p_self, p_graph, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_FOR:
+	case FLATAST_FUNCTION:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			ownership___collect(p_self, p_graph,
+								flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Summarises a strongly connected component of the call graph, whose callees outside it have all
+ * been summarised. A recursive component starts out keeping nothing, and is walked again until
+ * its summaries stop growing. Summaries only grow, as keeping more makes more arguments moves.
+ *
+ * @param p_self  The current Ownership struct.
+ * @param p_graph The call graph.
+ * @param start   Where the component starts on the graph's stack, up to its top.
+ */
+void ownership___summarise_component(struct Ownership* p_self, struct OwnershipGraph* p_graph,
+									 size_t start) {
+	bool recursive = p_graph->stackCount - start > 1;
+
+	for (size_t index = start; index < p_graph->stackCount; index++) {
+		uint32_t function = p_graph->stack[index];
+
+		for (uint32_t edge = function ? p_graph->edgeEnds[function - 1] : 0;
+			 edge < p_graph->edgeEnds[function]; edge++) {
+			recursive |= p_graph->edges[edge] == function;
+		}
+
+		ownership___store(p_self, p_graph->names[function], 0);
+	}
+
+	for (bool changed = true; changed;) {
+		changed = false;
+
+		for (size_t index = start; index < p_graph->stackCount; index++) {
+			uint32_t function = p_graph->stack[index];
+			uint32_t kept	  = ownership___analyse(p_self, p_self->ast, p_self->inference,
+													p_graph->functions[function],
+													p_graph->names[function], true);
+
+			changed |= ownership___store(p_self, p_graph->names[function], kept);
+		}
+
+		changed &= recursive;
+	}
+}
+
+/**
+ * Reaches a function of the call graph, and summarises the components completed by it (Tarjan's
+ * algorithm). Components are completed after every component they call.
+ *
+ * @param p_self   The current Ownership struct.
+ * @param p_graph  The call graph.
+ * @param function The function.
+ */
+void ownership___connect(struct Ownership* p_self, struct OwnershipGraph* p_graph,
+						 uint32_t function) {
+	p_graph->order[function]	= (uint32_t)++p_graph->reached;
+	p_graph->lowLinks[function] = p_graph->order[function];
+	p_graph->stack[p_graph->stackCount++] = function;
+	p_graph->onStack[function]			  = true;
+
+	for (uint32_t edge = function ? p_graph->edgeEnds[function - 1] : 0;
+		 edge < p_graph->edgeEnds[function]; edge++) {
+		uint32_t callee = p_graph->edges[edge];
+
+		if (!p_graph->order[callee]) {
+			ownership___connect(p_self, p_graph, callee);
+
+			if (p_graph->lowLinks[callee] < p_graph->lowLinks[function]) {
+				p_graph->lowLinks[function] = p_graph->lowLinks[callee];
+			}
+		} else if (p_graph->onStack[callee]
+				   && p_graph->order[callee] < p_graph->lowLinks[function]) {
+			p_graph->lowLinks[function] = p_graph->order[callee];
+		}
+	}
+
+	if (p_graph->lowLinks[function] != p_graph->order[function]) { // Part of a caller's component
+		return;
+	}
+
+	size_t start = p_graph->stackCount;
+
+	do {
+		start--;
+	} while (p_graph->stack[start] != function);
+
+	ownership___summarise_component(p_self, p_graph, start);
+
+	for (size_t index = start; index < p_graph->stackCount; index++) {
+		p_graph->onStack[p_graph->stack[index]] = false;
+	}
+
+	p_graph->stackCount = start;
+}
+
+void ownership_summarise(struct Ownership* p_self, const struct FlatAST* p_ast,
+						 const struct Inference* p_inference, const flat_ast_index_t* p_functions,
+						 const char* const* p_names, size_t count) {
+	struct OwnershipGraph graph = {0};
+
+	graph.functions = p_functions;
+	graph.names		= p_names;
+	graph.count		= count;
+	graph.edgeEnds	= calloc(count ? count : 1, sizeof(uint32_t));
+	graph.order		= calloc(count ? count : 1, sizeof(uint32_t));
+	graph.lowLinks	= calloc(count ? count : 1, sizeof(uint32_t));
+	graph.stack		= calloc(count ? count : 1, sizeof(uint32_t));
+	graph.onStack	= calloc(count ? count : 1, sizeof(uint8_t));
+
+	if (!graph.edgeEnds || !graph.order || !graph.lowLinks || !graph.stack || !graph.onStack) {
+		PANIC("failed to malloc OwnershipGraph");
+	}
+
+	for (uint32_t function = 0; function < count; function++) {
+		intern_id_t name = interner_intern(p_self->interner, p_names[function]);
+
+		graph.functionOf = buffer_grow(graph.functionOf, &graph.nameCount, (size_t)name + 1,
+									   sizeof(uint32_t));
+		graph.functionOf[name] = function + 1;
+	}
+
+	p_self->ast		  = p_ast;
+	p_self->inference = p_inference;
+
+	for (uint32_t function = 0; function < count; function++) {
+		ownership___collect(p_self, &graph, flat_ast_get(p_ast, p_functions[function])->rhs);
+		graph.edgeEnds[function] = (uint32_t)graph.edgeCount;
+	}
+
+	for (uint32_t function = 0; function < count; function++) {
+		if (!graph.order[function]) {
+			ownership___connect(p_self, &graph, function);
+		}
+	}
+
+	free(graph.functionOf);
+	free(graph.edges);
+	free(graph.edgeEnds);
+	free(graph.order);
+	free(graph.lowLinks);
+	free(graph.stack);
+	free(graph.onStack);
+}
+
+void ownership_function(struct Ownership* p_self, const struct FlatAST* p_ast,
+						const struct Inference* p_inference, flat_ast_index_t function,
+						const char* p_name) {
+	ownership___store(p_self, p_name,
+					  ownership___analyse(p_self, p_ast, p_inference, function, p_name, false));
+}
+
+enum OwnershipTransfers ownership_get_transfer(const struct Ownership* p_self,
+											   flat_ast_index_t node) {
+	return node < p_self->nodeCapacity ? (enum OwnershipTransfers)p_self->transfers[node]
+									   : OWNERSHIP_NONE;
+}
+
+bool ownership_keeps(const struct Ownership* p_self, const char* p_name, size_t index) {
+	intern_id_t name = interner_find(p_self->interner, p_name);
+
+	if (name == INTERN_ID_NONE || name >= p_self->summaryCapacity
+		|| !(p_self->summaries[name] & OWNERSHIP_SUMMARY_KNOWN)
+		|| index >= OWNERSHIP_SUMMARY_PARAMS) {
+		return true;
+	}
+
+	return p_self->summaries[name] & (1U << index);
+}
+
+/**
+ * Gets the function initialising an element of an array of some type as a copy of another, for
+ * '@array_SEP_clone', emitting it the first time for nested arrays.
+ *
+ * @param p_self   The current Ownership struct.
+ * @param element  The type of the elements.
+ * @param p_name   Where to write the function, 'null' for elements copied byte for byte.
+ * @param size     The size of p_name.
+ * @param p_module Where to append the function, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void ownership___cloner(struct Ownership* p_self, type_id_t element, char* p_name, size_t size,
+						struct String* p_module) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	if (!ownership___owns(p_self, element)) {
+		snprintf(p_name, size, "null");
+		return;
+	}
+
+	if (!ownership___is_array(p_self, element)) {
+		snprintf(p_name, size,
+				 "bitcast (void (%%str*, %%str*)* @str_SEP_clone to void (i8*, i8*)*)");
+		return;
+	}
+
+	snprintf(p_name, size, "@ownership.clone.%u", element);
+
+	p_self->cloners = buffer_grow(p_self->cloners, &p_self->clonerCapacity, (size_t)element + 1,
+								  sizeof(uint8_t));
+
+	if (p_self->cloners[element]) {
+		return;
+	}
+
+	type_id_t inner		 = type_table_get_args(p_self->types, element)[0];
+	uint32_t  innerSize	 = layout_type_size(p_self->layouts, inner, NULL);
+	char	  cloner[OWNERSHIP_LINE_LENGTH / 2];
+	char	  line[OWNERSHIP_LINE_LENGTH];
+
+	p_self->cloners[element] = 1;
+	ownership___cloner(p_self, inner, cloner, sizeof(cloner), p_module);
+
+	// define private void @ownership.clone.N(i8* %self, i8* %other) nounwind {
+	// entry:
+	//   %0 = bitcast i8* %self to %array*
+	//   %1 = bitcast i8* %other to %array*
+	//   call void @array_SEP_clone(%array* %0, %array* %1, i64 <size>, void (i8*, i8*)* <cloner>)
+	//   ret void
+	// }
+	snprintf(line, sizeof(line),
+			 "define private void @ownership.clone.%u(i8* %%self, i8* %%other) nounwind {\n"
+			 "entry:\n"
+			 "  %%0 = bitcast i8* %%self to %%array*\n"
+			 "  %%1 = bitcast i8* %%other to %%array*\n"
+			 "  call void @array_SEP_clone(%%array* %%0, %%array* %%1, i64 %u, "
+			 "void (i8*, i8*)* %s)\n"
+			 "  ret void\n"
+			 "}\n",
+			 element, innerSize, cloner);
+	string_append_str(p_module, line);
+}
+
+void ownership_emit_transfer(struct Ownership* p_self, flat_ast_index_t node, const char* p_source,
+							 const char* p_result, struct String* p_output,
+							 struct String* p_module) {
+	enum OwnershipTransfers transfer = ownership_get_transfer(p_self, node);
+	type_id_t				type	 = inference_get_node_type(p_self->inference, node);
+	bool					array	 = ownership___is_array(p_self, type);
+	const char*				lp_type	 = array ? "%array" : "%str";
+	char					line[OWNERSHIP_LINE_LENGTH];
+
+	switch (transfer) {
+	case OWNERSHIP_BORROW:
+		return;
+	case OWNERSHIP_NONE:
+	case OWNERSHIP_MOVE:
+		// %move.N = load %str, %str* %source
+		// store %str %move.N, %str* %result
+		// store %str zeroinitializer, %str* %source
+		snprintf(line, sizeof(line),
+				 "  %%move.%u = load %s, %s* %s\n"
+				 "  store %s %%move.%u, %s* %s\n",
+				 node, lp_type, lp_type, p_source, lp_type, node, lp_type, p_result);
+		string_append_str(p_output, line);
+
+		if (transfer == OWNERSHIP_MOVE) {
+			snprintf(line, sizeof(line), "  store %s zeroinitializer, %s* %s\n", lp_type, lp_type,
+					 p_source);
+			string_append_str(p_output, line);
+		}
+		return;
+	default:
+		break;
+	}
+
+	if (!array) {
+		// call void @str_SEP_clone(%str* %result, %str* %source)
+		snprintf(line, sizeof(line), "  call void @str_SEP_clone(%%str* %s, %%str* %s)\n",
+				 p_result, p_source);
+		string_append_str(p_output, line);
+		return;
+	}
+
+	type_id_t element = type_table_get_args(p_self->types, type)[0];
+	char	  cloner[OWNERSHIP_LINE_LENGTH / 2];
+
+	ownership___cloner(p_self, element, cloner, sizeof(cloner), p_module);
+
+	// call void @array_SEP_clone(%array* %result, %array* %source, i64 <size>, <cloner>)
+	snprintf(line, sizeof(line),
+			 "  call void @array_SEP_clone(%%array* %s, %%array* %s, i64 %u, "
+			 "void (i8*, i8*)* %s)\n",
+			 p_result, p_source, layout_type_size(p_self->layouts, element, NULL), cloner);
+	string_append_str(p_output, line);
+}
@@ -0,0 +1,211 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./layout.h"
+#include "./report.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define OWNERSHIP_CLONE_METHOD "clone" // 'value.clone()' is the explicit deep copy of a value.
+
+// X-Macro to define how an owning value gets where it is used, and how it is explained
+#define OWNERSHIP_TRANSFERS(X)                                                                     \
+	X(NONE, "it does not own a buffer")                                                            \
+	X(BORROW, "it is borrowed")                                                                    \
+	X(MOVE, "it is moved")                                                                         \
+	X(CLONE, "it is cloned explicitly")                                                            \
+	X(FIELD, "it is read from a field, which keeps its own value")                                 \
+	X(ELEMENT, "it is read from an element of an array, which keeps its own value")                \
+	X(GLOBAL, "it belongs to the module, which keeps its own value")                               \
+	X(CAPTURED, "it belongs to the enclosing function, and the nested one may run more than once")
+
+/**
+ * Used to identify how an owning value gets where it is used. The transfers after CLONE are the
+ * implicit deep copies that remain.
+ */
+enum OwnershipTransfers {
+#define OWNERSHIP_TRANSFER_ENUM_ENTRY(name, string) OWNERSHIP_##name,
+	OWNERSHIP_TRANSFERS(OWNERSHIP_TRANSFER_ENUM_ENTRY)
+#undef OWNERSHIP_TRANSFER_ENUM_ENTRY
+};
+
+/**
+ * Contains the explanations of each of the transfers.
+ */
+extern const struct Array g_OWNERSHIP_TRANSFER_NAMES;
+
+/**
+ * Gets the explanation of a transfer.
+ *
+ * @param TRANSFER The transfer.
+ *
+ * @return The explanation of the transfer.
+ */
+const char* ownership_transfer_get_name(
+	const enum OwnershipTransfers TRANSFER); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Represents the ownership pass. Strings and arrays own their buffers (structs are held by
+ * reference, so they are shared rather than copied), and they are moved by default: assigning,
+ * returning or storing one, or passing it to a parameter its function may keep, hands the buffer
+ * over with a 24 byte copy. The local it was read from is then moved, and using it again before
+ * it is assigned is an error, so a move is only allowed at the local's last use, including in
+ * loops and across branches. '.clone()' is the explicit deep copy.
+ *
+ * Receivers, and parameters their function only reads, are borrowed: the caller keeps the value.
+ * Values read from fields, elements of arrays, or locals of an enclosing function cannot be moved
+ * out, as their owner keeps them, so they are the implicit deep copies that remain, listed by the
+ * copies report. Calls rely on summaries of their callees' parameters, computed for the whole
+ * module by ownership_summarise before any function is analysed. Parameters of callees outside the
+ * module count as kept.
+ */
+struct Ownership {
+	const char*				  filePath; // For diagnostics and the report.
+	struct Interner*		  interner;
+	const struct TypeTable*	  types;
+	const struct LayoutTable* layouts;
+	struct Report*			  report;
+	uint8_t*				  transfers; // enum OwnershipTransfers of each node.
+	uint32_t*				  slots;	 // Index + 1 of each local in 'moved', by interned name.
+	intern_id_t*			  declared;	 // The locals of the current function, by slot.
+	flat_ast_index_t*		  moved;	 // The node each local was moved at, by slot.
+	uint32_t*				  summaries; // Kept parameters of each function, by interned name.
+	uint8_t*				  cloners;	 // Whether each array type's clone function was emitted.
+	size_t nodeCapacity, slotCapacity, declaredCount, declaredCapacity, summaryCapacity,
+		clonerCapacity;
+	const struct FlatAST*	ast;		// The AST of the current function.
+	const struct Inference* inference;	// The inference of the current function.
+	const char*				name;		// The name of the current function, for the report.
+	size_t					outer;		// Slots of the enclosing functions of a nested one.
+	size_t					params;		// Slots of the current function's parameters.
+	uint32_t				kept;		// The parameters of the current function it moves.
+	bool					replaying;	// Whether a loop is walked again, for its next iteration.
+	bool					returned;	// Whether the current path has returned.
+	size_t					moves, borrows, copies; // For the time report.
+};
+
+#define OWNERSHIP_STRUCT_SIZE sizeof(struct Ownership)
+
+/**
+ * Represents the call graph of a module's functions, walked by its strongly connected components
+ * (Tarjan's algorithm) so every function is summarised after the functions it calls.
+ */
+struct OwnershipGraph {
+	const flat_ast_index_t* functions;
+	const char* const*		names;
+	uint32_t*				functionOf; // Index + 1 of each function, by interned name.
+	uint32_t*				edges;		// The functions each function calls, by function.
+	uint32_t*				edgeEnds;	// Where the calls of each function end in 'edges'.
+	uint32_t*				order;		// When each function was reached + 1, 0 if not yet.
+	uint32_t*				lowLinks;	// The earliest function each one reaches in its component.
+	uint32_t*				stack;		// The functions of the components being built.
+	uint8_t*				onStack;
+	size_t					count, nameCount, edgeCount, edgeCapacity, stackCount, reached;
+};
+
+/**
+ * Creates a new Ownership struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics and the report.
+ * @param p_interner The module's interner.
+ * @param p_types    The module's type table.
+ * @param p_layouts  The module's struct layouts, for the size of elements.
+ * @param p_report   The requested reports (can be NULL).
+ *
+ * @return The created Ownership struct.
+ */
+struct Ownership* ownership_new(const char* p_filePath, struct Interner* p_interner,
+								const struct TypeTable*	  p_types,
+								const struct LayoutTable* p_layouts, struct Report* p_report);
+
+/**
+ * Frees an Ownership struct.
+ *
+ * @param p_self The current Ownership struct.
+ */
+void ownership_free(struct Ownership** p_self);
+
+/**
+ * Summarises which parameters each function of a module keeps, before any of them is analysed.
+ * Functions are summarised after their callees. Those calling each other (or themselves) start
+ * out keeping nothing, and are walked again until their summaries stop growing, so recursion does
+ * not make every argument a move. The module must have been inferred.
+ *
+ * @param p_self      The current Ownership struct.
+ * @param p_ast       The AST containing the functions.
+ * @param p_inference The inference the module was inferred with.
+ * @param p_functions The functions' nodes.
+ * @param p_names     The functions' names, e.g. 'main' or 'Stack.push'.
+ * @param count       The number of functions.
+ */
+void ownership_summarise(struct Ownership* p_self, const struct FlatAST* p_ast,
+						 const struct Inference* p_inference, const flat_ast_index_t* p_functions,
+						 const char* const* p_names, size_t count);
+
+/**
+ * Decides how every owning value of the last inferred function gets where it is used, and records
+ * which of the function's parameters it keeps for its callers. Errors on the use of a local after
+ * it was moved. Deep copies are added to the copies report.
+ *
+ * @param p_self      The current Ownership struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param function    The function's node.
+ * @param p_name      The function's name, e.g. 'main' or 'Stack.push'.
+ */
+void ownership_function(struct Ownership* p_self, const struct FlatAST* p_ast,
+						const struct Inference* p_inference, flat_ast_index_t function,
+						const char* p_name);
+
+/**
+ * Gets how a value gets where it is used: an argument, a receiver, a returned, assigned or stored
+ * value, or a '.clone()' call.
+ *
+ * @param p_self The current Ownership struct.
+ * @param node   The value's node.
+ *
+ * @return The transfer, OWNERSHIP_NONE if the value owns nothing or its function has not been
+ *         analysed.
+ */
+enum OwnershipTransfers ownership_get_transfer(const struct Ownership* p_self,
+											   flat_ast_index_t node);
+
+/**
+ * Checks whether a function keeps one of its parameters, so it is moved to it rather than borrowed.
+ * The function drops the parameters it keeps, and its callers the ones they lend it.
+ *
+ * @param p_self The current Ownership struct.
+ * @param p_name The function's name, e.g. 'main' or 'Stack.push'.
+ * @param index  The parameter's index.
+ *
+ * @return Whether the parameter is kept, true for functions that have not been summarised.
+ */
+bool ownership_keeps(const struct Ownership* p_self, const char* p_name, size_t index);
+
+/**
+ * Emits a value getting where it is used, from a string or an array to another. Moves copy its 24
+ * bytes and zero the source, which its owner then drops as an empty value. Deep copies clone it.
+ * Nothing is emitted for borrows, the callee gets the source itself.
+ *
+ * @param p_self   The current Ownership struct.
+ * @param node     The value's node.
+ * @param p_source The pointer to the value, e.g. '%lines'.
+ * @param p_result The pointer to where the value goes, e.g. '%arg.0'.
+ * @param p_output Where to append the IR of the current block.
+ * @param p_module Where to append the clone functions of nested arrays, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void ownership_emit_transfer(struct Ownership* p_self, flat_ast_index_t node, const char* p_source,
+							 const char* p_result, struct String* p_output,
+							 struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
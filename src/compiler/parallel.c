@@ -0,0 +1,1073 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./parallel.h"
+#include "./diagnostics.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARALLEL_NAME_LENGTH	  48U
+#define PARALLEL_LINE_LENGTH	  512U
+
+struct ParallelLowering* parallel_lowering_new(const char* p_filePath, struct TypeTable* p_types) {
+	struct ParallelLowering* lp_self = calloc(1, PARALLELLOWERING_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc ParallelLowering struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->types	  = p_types;
+
+	return lp_self;
+}
+
+void parallel_lowering_free(struct ParallelLowering** p_self) {
+	if (p_self && *p_self) {
+		free((void*)(*p_self)->locals);
+		free((void*)(*p_self)->captures);
+		free((*p_self)->reductions);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("ParallelLowering struct has already been freed");
+	}
+}
+
+/**
+ * Finds a name in a list of names.
+ *
+ * @param p_names The names.
+ * @param count   The number of names.
+ * @param p_name  The name.
+ *
+ * @return Whether the list contains the name.
+ */
+bool parallel___contains(const char* const* p_names, size_t count, const char* p_name) {
+	for (size_t index = 0; index < count; index++) {
+		if (strcmp(p_names[index], p_name) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Adds a variable to the variables of the function declared outside the current loop, once.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The node holding the variable's name.
+ */
+void parallel___add_local(struct ParallelLowering* p_self, flat_ast_index_t node) {
+	const char* lp_name =
+		flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, node)->value.string);
+
+	if (parallel___contains(p_self->locals, p_self->localCount, lp_name)) {
+		return;
+	}
+
+	p_self->locals = buffer_grow((void*)p_self->locals, &p_self->localCapacity,
+								 p_self->localCount + 1, sizeof(const char*));
+	p_self->locals[p_self->localCount++] = lp_name;
+}
+
+/**
+ * Collects the variables of a function declared outside the current loop: its parameters, the
+ * variables it assigns, and the bindings of the loops containing the current loop. Nested
+ * functions have variables of their own.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   A node of the function.
+ *
+ * @return Whether the node contains the current loop.
+ */
+bool parallel___collect_locals(struct ParallelLowering* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return false;
+	}
+
+	if (node == p_self->loop->node) {
+		return true;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_PARAMETER:
+		parallel___add_local(p_self, node);
+		return false;
+	case FLATAST_ASSIGNMENT: {
+		uint8_t targetKind = flat_ast_get(p_self->ast, lp_node->lhs)->kind;
+
+		if (targetKind == FLATAST_VARIABLE || targetKind == FLATAST_FIELD) {
+			parallel___add_local(p_self, lp_node->lhs);
+		}
+		break;
+	}
+	case FLATAST_FUNCTION:
+		return false;
+	default:
+		break;
+	}
+
+	bool contains = parallel___collect_locals(p_self, lp_node->lhs);
+
+	contains = parallel___collect_locals(p_self, lp_node->rhs) || contains;
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			contains = parallel___collect_locals(
+						   p_self, flat_ast_get_list_item(p_self->ast, lp_node, index))
+					   || contains;
+		}
+		break;
+	case FLATAST_FOR:
+		for (size_t index = 0; contains && index < lp_node->value.list.length; index++) {
+			parallel___add_local(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+
+	return contains;
+}
+
+/**
+ * Gets the variable of the function an expression names or is a member of, e.g. 'self' for
+ * 'self.items'.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The expression.
+ *
+ * @return The variable's name, NULL if it is not a variable of the function.
+ */
+const char* parallel___root(const struct ParallelLowering* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	while (lp_node->kind == FLATAST_MEMBER) {
+		lp_node = flat_ast_get(p_self->ast, lp_node->lhs);
+	}
+
+	if (lp_node->kind != FLATAST_VARIABLE) {
+		return NULL;
+	}
+
+	const char* lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+
+	return parallel___contains(p_self->locals, p_self->localCount, lp_name) ? lp_name : NULL;
+}
+
+/**
+ * Gets the variable of the module an expression names or is a member of, e.g. 'log' for
+ * 'log.lines', unless a variable of the function shadows it.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The expression.
+ *
+ * @return The variable's name, NULL if it is not a variable of the module.
+ */
+const char* parallel___global(const struct ParallelLowering* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	while (lp_node->kind == FLATAST_MEMBER) {
+		lp_node = flat_ast_get(p_self->ast, lp_node->lhs);
+	}
+
+	if (lp_node->kind != FLATAST_VARIABLE) {
+		return NULL;
+	}
+
+	const char* lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+	intern_id_t name	= interner_find(p_self->inference->interner, lp_name);
+
+	if (name == INTERN_ID_NONE
+		|| parallel___contains(p_self->locals, p_self->localCount, lp_name)) {
+		return NULL;
+	}
+
+	// Only the module's scope is open once its functions have been inferred
+	uint32_t binding = symbol_table_resolve(p_self->inference->symbols, name);
+
+	return binding != SYMBOL_BINDING_NONE
+				   && symbol_table_get(p_self->inference->symbols, binding)->kind
+						  == SYMBOL_VARIABLE
+			   ? lp_name
+			   : NULL;
+}
+
+/**
+ * Gets the variable of the function or the module an expression names or is a member of.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The expression.
+ *
+ * @return The variable's name, NULL if it is neither.
+ */
+const char* parallel___shared(const struct ParallelLowering* p_self, flat_ast_index_t node) {
+	const char* lp_root = parallel___root(p_self, node);
+
+	return lp_root ? lp_root : parallel___global(p_self, node);
+}
+
+/**
+ * Checks whether an expression reads a variable.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The expression.
+ * @param p_name The variable's name.
+ *
+ * @return Whether the expression reads the variable.
+ */
+bool parallel___mentions(const struct ParallelLowering* p_self, flat_ast_index_t node,
+						 const char* p_name) {
+	if (node == FLATAST_INDEX_NONE) {
+		return false;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_VARIABLE:
+		return strcmp(flat_ast_get_string(p_self->ast, lp_node->value.string), p_name) == 0;
+	case FLATAST_MEMBER:
+	case FLATAST_UNARY:
+		return parallel___mentions(p_self, lp_node->lhs, p_name);
+	case FLATAST_BINARY:
+		return parallel___mentions(p_self, lp_node->lhs, p_name)
+			   || (lp_node->operation != LEXERTOKENS_SCOPE_RESOLUTION
+				   && parallel___mentions(p_self, lp_node->rhs, p_name));
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			if (parallel___mentions(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index),
+									p_name)) {
+				return true;
+			}
+		}
+
+		return lp_node->kind == FLATAST_CALL && parallel___mentions(p_self, lp_node->lhs, p_name);
+	case FLATAST_FIELD:
+		return parallel___mentions(p_self, lp_node->lhs, p_name);
+	default:
+		return false;
+	}
+}
+
+/**
+ * Recognises an assignment reducing into a variable: 'x += value' for the operators reductions
+ * support, or 'x = x + value' (also 'value + x' for commutative operators), where the value does
+ * not read x.
+ *
+ * @param p_self      The current ParallelLowering struct.
+ * @param assignment  The assignment's node.
+ * @param p_operation Where to write the binary operator folding the value in.
+ *
+ * @return The value folded in, FLATAST_INDEX_NONE if the assignment is not a reduction.
+ */
+flat_ast_index_t parallel___reduced_value(const struct ParallelLowering* p_self,
+										  flat_ast_index_t assignment, uint8_t* p_operation) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, assignment);
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, lp_node->lhs);
+
+	if (lp_target->kind != FLATAST_VARIABLE) {
+		return FLATAST_INDEX_NONE;
+	}
+
+	const char*		 lp_name = flat_ast_get_string(p_self->ast, lp_target->value.string);
+	flat_ast_index_t value	 = lp_node->rhs;
+
+	switch (lp_node->operation) {
+	case LEXERTOKENS_ADDITION_ASSIGNMENT:
+		*p_operation = LEXERTOKENS_ADDITION;
+		break;
+	case LEXERTOKENS_SUBTRACTION_ASSIGNMENT:
+		*p_operation = LEXERTOKENS_SUBTRACTION;
+		break;
+	case LEXERTOKENS_MULTIPLICATION_ASSIGNMENT:
+		*p_operation = LEXERTOKENS_MULTIPLICATION;
+		break;
+	case LEXERTOKENS_BITWISE_AND_ASSIGNMENT:
+		*p_operation = LEXERTOKENS_BITWISE_AND;
+		break;
+	case LEXERTOKENS_BITWISE_OR_ASSIGNMENT:
+		*p_operation = LEXERTOKENS_BITWISE_OR;
+		break;
+	case LEXERTOKENS_BITWISE_XOR_ASSIGNMENT:
+		*p_operation = LEXERTOKENS_BITWISE_XOR;
+		break;
+	case LEXERTOKENS_ASSIGNMENT: { // e.g. 'x = x + value'
+		const struct FlatASTNode* lp_value = flat_ast_get(p_self->ast, lp_node->rhs);
+
+		if (lp_value->kind != FLATAST_BINARY
+			|| (lp_value->operation != LEXERTOKENS_ADDITION
+				&& lp_value->operation != LEXERTOKENS_SUBTRACTION
+				&& lp_value->operation != LEXERTOKENS_MULTIPLICATION
+				&& lp_value->operation != LEXERTOKENS_BITWISE_AND
+				&& lp_value->operation != LEXERTOKENS_BITWISE_OR
+				&& lp_value->operation != LEXERTOKENS_BITWISE_XOR)) {
+			return FLATAST_INDEX_NONE;
+		}
+
+		const struct FlatASTNode* lp_lhs = flat_ast_get(p_self->ast, lp_value->lhs);
+		const struct FlatASTNode* lp_rhs = flat_ast_get(p_self->ast, lp_value->rhs);
+
+		*p_operation = lp_value->operation;
+
+		if (lp_lhs->kind == FLATAST_VARIABLE
+			&& strcmp(flat_ast_get_string(p_self->ast, lp_lhs->value.string), lp_name) == 0) {
+			value = lp_value->rhs;
+		} else if (lp_value->operation != LEXERTOKENS_SUBTRACTION
+				   && lp_rhs->kind == FLATAST_VARIABLE
+				   && strcmp(flat_ast_get_string(p_self->ast, lp_rhs->value.string), lp_name)
+						  == 0) {
+			value = lp_value->lhs;
+		} else {
+			return FLATAST_INDEX_NONE;
+		}
+		break;
+	}
+	default:
+		return FLATAST_INDEX_NONE;
+	}
+
+	return parallel___mentions(p_self, value, lp_name) ? FLATAST_INDEX_NONE : value;
+}
+
+/**
+ * Errors on a node of the current loop's body that cannot run in parallel.
+ *
+ * @param p_self    The current ParallelLowering struct.
+ * @param node      The node.
+ * @param p_message The error message.
+ */
+void parallel___error(const struct ParallelLowering* p_self, flat_ast_index_t node,
+					  const char* p_message) {
+	compiler_error(p_self->filePath, flat_ast_get(p_self->ast, node)->line, C0010, p_message);
+}
+
+/**
+ * Gets the inferred type of a node of the current loop, with the type arguments of its instance
+ * substituted.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The node.
+ *
+ * @return The node's type, TYPE_ID_NONE if it has none.
+ */
+type_id_t parallel___node_type(const struct ParallelLowering* p_self, flat_ast_index_t node) {
+	type_id_t type = inference_get_node_type(p_self->inference, node);
+
+	if (type == TYPE_ID_NONE || p_self->params == TYPE_ID_NONE) {
+		return type;
+	}
+
+	return type_table_substitute(p_self->types, type, p_self->params, p_self->args);
+}
+
+/**
+ * Records a reduction into a variable, erroring if the variable cannot be reduced into.
+ *
+ * @param p_self    The current ParallelLowering struct.
+ * @param target    The variable's node, in the reducing assignment.
+ * @param OPERATION The binary operator folding values in.
+ */
+void parallel___add_reduction(struct ParallelLowering* p_self, flat_ast_index_t target,
+							  const enum LexerTokenIdentifiers OPERATION) {
+	const char* lp_name =
+		flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, target)->value.string);
+	type_id_t		   type	   = parallel___node_type(p_self, target);
+	const struct Type* lp_type = type != TYPE_ID_NONE ? type_table_get(p_self->types, type) : NULL;
+
+	bool isBitwise = OPERATION == LEXERTOKENS_BITWISE_AND || OPERATION == LEXERTOKENS_BITWISE_OR
+					 || OPERATION == LEXERTOKENS_BITWISE_XOR;
+
+	if (!lp_type || lp_type->kind != TYPE_PRIMITIVE || lp_type->primitive < TYPE_PRIMITIVE_BOOL
+		|| lp_type->primitive > TYPE_PRIMITIVE_F64
+		|| (lp_type->primitive == TYPE_PRIMITIVE_BOOL && !isBitwise)
+		|| (lp_type->primitive >= TYPE_PRIMITIVE_F32 && isBitwise)) {
+		parallel___error(p_self, target,
+						 CONCATENATE_STRING("cannot reduce into '", lp_name,
+											"' in a parallel loop, as the operator does not "
+											"apply to its type"));
+	}
+
+	// '-=' folds its partial results in with '+'
+	uint8_t family = OPERATION == LEXERTOKENS_SUBTRACTION ? LEXERTOKENS_ADDITION : OPERATION;
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		struct ParallelReduction* lp_reduction = &p_self->reductions[index];
+
+		if (strcmp(lp_reduction->name, lp_name) == 0) {
+			if (lp_reduction->operation != family) {
+				parallel___error(p_self, target,
+								 CONCATENATE_STRING("cannot reduce into '", lp_name,
+													"' with different operators in a parallel "
+													"loop"));
+			}
+
+			return;
+		}
+	}
+
+	p_self->reductions = buffer_grow(p_self->reductions, &p_self->reductionCapacity,
+									 p_self->reductionCount + 1, PARALLEL_REDUCTION_SIZE);
+	p_self->reductions[p_self->reductionCount++] = (struct ParallelReduction){
+		.name = lp_name, .operation = family, .primitive = lp_type->primitive};
+}
+
+/**
+ * Errors if a call of the current loop's body receives a variable of the function or the module
+ * it may keep or change, which every iteration would race to do. Numbers and bools are copied, and
+ * the ownership of the loop's function tells which strings and arrays the callee only borrows, and
+ * which it gets a deep copy of.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param call   The call's node.
+ */
+void parallel___check_arguments(const struct ParallelLowering* p_self, flat_ast_index_t call) {
+	const struct FlatASTNode* lp_call = flat_ast_get(p_self->ast, call);
+
+	for (size_t index = 0; index < lp_call->value.list.length; index++) {
+		flat_ast_index_t		arg		 = flat_ast_get_list_item(p_self->ast, lp_call, index);
+		const char*				lp_root	 = parallel___shared(p_self, arg);
+		enum OwnershipTransfers transfer = ownership_get_transfer(p_self->ownership, arg);
+		type_id_t				type	 = parallel___node_type(p_self, arg);
+
+		// The implicit deep copies are the callee's own
+		if (!lp_root || transfer == OWNERSHIP_BORROW || transfer > OWNERSHIP_CLONE) {
+			continue;
+		}
+
+		if (type != TYPE_ID_NONE) {
+			const struct Type* lp_type = type_table_get(p_self->types, type);
+
+			if (lp_type->kind == TYPE_PRIMITIVE && lp_type->primitive != TYPE_PRIMITIVE_STR) {
+				continue;
+			}
+		}
+
+		parallel___error(p_self, arg,
+						 CONCATENATE_STRING("the iterations of a parallel loop race to pass '",
+											lp_root,
+											"' to a call that may keep or change it, pass "
+											"a '.clone()' instead"));
+	}
+}
+
+/**
+ * Walks a node of a parallel loop's body, recording its reductions and erroring on returns and on
+ * writes to variables of the function. Nested functions are analysed on their own.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The node.
+ */
+void parallel___walk_writes(struct ParallelLowering* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_FUNCTION:
+		return;
+	case FLATAST_RETURN:
+		parallel___error(p_self, node, "cannot return from the body of a parallel loop");
+		return;
+	case FLATAST_ASSIGNMENT: {
+		const char* lp_root	  = parallel___root(p_self, lp_node->lhs);
+		const char* lp_global = parallel___global(p_self, lp_node->lhs);
+		uint8_t		operation = LEXERTOKENS_NONE;
+
+		if (lp_global) {
+			parallel___error(p_self, node,
+							 CONCATENATE_STRING("the iterations of a parallel loop race to "
+												"write to '",
+												lp_global,
+												"', which belongs to the module, reduce into a "
+												"variable of the function instead"));
+		}
+
+		if (lp_root) {
+			if (parallel___reduced_value(p_self, node, &operation) == FLATAST_INDEX_NONE) {
+				parallel___error(p_self, node,
+								 CONCATENATE_STRING("the iterations of a parallel loop race to "
+													"write to '",
+													lp_root,
+													"', reduce into it with '+=', '-=', '*=', "
+													"'&=', '|=' or '^=' instead"));
+			}
+
+			parallel___add_reduction(p_self, lp_node->lhs, operation);
+		}
+		break;
+	}
+	case FLATAST_CALL: { // Methods other than these may change their receiver
+		const struct FlatASTNode* lp_callee = flat_ast_get(p_self->ast, lp_node->lhs);
+
+		if (lp_callee->kind == FLATAST_MEMBER) {
+			const char* lp_root	  = parallel___shared(p_self, lp_callee->lhs);
+			const char* lp_method = flat_ast_get_string(p_self->ast, lp_callee->value.string);
+
+			if (lp_root && strcmp(lp_method, "get") != 0 && strcmp(lp_method, "length") != 0
+				&& strcmp(lp_method, LOOP_PARALLEL_METHOD) != 0) {
+				parallel___error(p_self, node,
+								 CONCATENATE_STRING("the iterations of a parallel loop race to "
+													"call '",
+													lp_method, "' on '", lp_root,
+													"', which may change it"));
+			}
+		}
+
+		parallel___check_arguments(p_self, node);
+		break;
+	}
+	default:
+		break;
+	}
+
+	parallel___walk_writes(p_self, lp_node->lhs);
+	parallel___walk_writes(p_self, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			parallel___walk_writes(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Walks a node of a parallel loop's body, recording the variables of the function it reads and
+ * erroring if it reads one it reduces into, whose value is only partial.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param node   The node.
+ */
+void parallel___walk_reads(struct ParallelLowering* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_FUNCTION:
+		return;
+	case FLATAST_VARIABLE: {
+		const char* lp_name = parallel___root(p_self, node);
+
+		if (!lp_name) {
+			return;
+		}
+
+		if (parallel_lowering_get_reduction(p_self, lp_name)) {
+			parallel___error(p_self, node,
+							 CONCATENATE_STRING("the body of a parallel loop reads '", lp_name,
+												"', which it reduces into, while its value is "
+												"partial"));
+		}
+
+		if (!parallel___contains(p_self->captures, p_self->captureCount, lp_name)) {
+			p_self->captures = buffer_grow((void*)p_self->captures, &p_self->captureCapacity,
+										   p_self->captureCount + 1, sizeof(const char*));
+			p_self->captures[p_self->captureCount++] = lp_name;
+		}
+
+		return;
+	}
+	case FLATAST_ASSIGNMENT: {
+		uint8_t operation = LEXERTOKENS_NONE;
+
+		if (parallel___root(p_self, lp_node->lhs)) { // Reductions only read the value folded in
+			parallel___walk_reads(p_self, parallel___reduced_value(p_self, node, &operation));
+			return;
+		}
+
+		uint8_t targetKind = flat_ast_get(p_self->ast, lp_node->lhs)->kind;
+
+		if (targetKind != FLATAST_VARIABLE && targetKind != FLATAST_FIELD) { // e.g. 'point.x'
+			parallel___walk_reads(p_self, lp_node->lhs);
+		}
+
+		parallel___walk_reads(p_self, lp_node->rhs);
+		return;
+	}
+	case FLATAST_BINARY:
+		parallel___walk_reads(p_self, lp_node->lhs);
+
+		if (lp_node->operation != LEXERTOKENS_SCOPE_RESOLUTION) { // e.g. 'io::out'
+			parallel___walk_reads(p_self, lp_node->rhs);
+		}
+
+		return;
+	case FLATAST_TYPE:
+	case FLATAST_PARAMETER:
+		return;
+	default:
+		break;
+	}
+
+	parallel___walk_reads(p_self, lp_node->lhs);
+	parallel___walk_reads(p_self, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			parallel___walk_reads(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void parallel_lowering_analyse(struct ParallelLowering* p_self, const struct FlatAST* p_ast,
+							   const struct Inference* p_inference,
+							   const struct Ownership* p_ownership, flat_ast_index_t function,
+							   type_id_t params, type_id_t args, const struct CountedLoop* p_loop) {
+	if (!p_loop->parallel) {
+		PANIC("ParallelLowering can only analyse parallel loops");
+	}
+
+	p_self->ast			   = p_ast;
+	p_self->inference	   = p_inference;
+	p_self->ownership	   = p_ownership;
+	p_self->loop		   = p_loop;
+	p_self->params		   = params;
+	p_self->args		   = args;
+	p_self->localCount	   = 0;
+	p_self->captureCount   = 0;
+	p_self->reductionCount = 0;
+
+	if (p_loop->kind == LOOP_GENERIC) {
+		compiler_error(p_self->filePath, flat_ast_get(p_ast, p_loop->node)->line, C0010,
+					   "'." LOOP_PARALLEL_METHOD "()' can only run the iterations of a range or an "
+					   "array in parallel");
+	}
+
+	const struct FlatASTNode* lp_function = flat_ast_get(p_ast, function);
+
+	for (size_t index = 0; index < lp_function->value.list.length; index++) {
+		parallel___collect_locals(p_self, flat_ast_get_list_item(p_ast, lp_function, index));
+	}
+
+	parallel___collect_locals(p_self, lp_function->rhs);
+
+	flat_ast_index_t body = flat_ast_get(p_ast, p_loop->node)->rhs;
+
+	parallel___walk_writes(p_self, body);
+	parallel___walk_reads(p_self, body);
+
+	p_self->loops++;
+	p_self->reduced += p_self->reductionCount;
+}
+
+const struct ParallelReduction* parallel_lowering_get_reduction(
+	const struct ParallelLowering* p_self, const char* p_name) {
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		if (strcmp(p_self->reductions[index].name, p_name) == 0) {
+			return &p_self->reductions[index];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Gets the LLVM type of a reduction's variable.
+ *
+ * @param PRIMITIVE The primitive of the variable.
+ *
+ * @return The LLVM type.
+ */
+const char* parallel___llvm_type(const enum TypePrimitives PRIMITIVE) {
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_BOOL:
+		return "i1";
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_U8:
+		return "i8";
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_U16:
+		return "i16";
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_U32:
+		return "i32";
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+		return "i64";
+	case TYPE_PRIMITIVE_F32:
+		return "float";
+	case TYPE_PRIMITIVE_F64:
+		return "double";
+	default:
+		PANIC("unsupported primitive for a reduction");
+	}
+}
+
+/**
+ * Appends the LLVM type of the partial results of the current loop, e.g. '{ i64, double }'.
+ *
+ * @param p_self   The current ParallelLowering struct.
+ * @param p_output Where to append the type.
+ */
+void parallel___append_partials_type(const struct ParallelLowering* p_self,
+									 struct String* p_output) {
+	string_append_str(p_output, "{ ");
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		string_append_str(p_output, index ? ", " : "");
+		string_append_str(p_output,
+						  parallel___llvm_type(p_self->reductions[index].primitive));
+	}
+
+	string_append_str(p_output, " }");
+}
+
+/**
+ * Appends a pointer to a partial result, e.g.
+ * '%sum.partial.ptr = getelementptr inbounds { i64 }, { i64 }* %par.accumulator, i32 0, i32 0'.
+ *
+ * @param p_self     The current ParallelLowering struct.
+ * @param index      The index of the reduction.
+ * @param p_result   The name of the pointer.
+ * @param p_partials The pointer to the partial results, of their struct type.
+ * @param p_output   Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void parallel___append_partial(const struct ParallelLowering* p_self, size_t index,
+							   const char* p_result, const char* p_partials,
+							   struct String* p_output) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	char line[PARALLEL_LINE_LENGTH];
+
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = getelementptr inbounds ");
+	parallel___append_partials_type(p_self, p_output);
+	string_append_str(p_output, ", ");
+	parallel___append_partials_type(p_self, p_output);
+	snprintf(line, sizeof(line), "* %s, i32 0, i32 %zu\n", p_partials, index);
+	string_append_str(p_output, line);
+}
+
+void parallel_lowering_emit_begin(struct ParallelLowering* p_self, struct LoopLowering* p_loops,
+								  struct CountedLoop* p_loop, const char* p_binding,
+								  const char* p_bindingType, struct String* p_module) {
+	char line[PARALLEL_LINE_LENGTH];
+
+	p_self->id = p_self->emitted++;
+
+	// define internal void @par.N(i8* %par.context, i64 %par.begin, i64 %par.end,
+	//                             i8* %par.partials)
+	snprintf(line, sizeof(line),
+			 "\ndefine internal void @" PARALLEL_BODY_PREFIX
+			 "%zu(i8* %%par.context, i64 %%par.begin, i64 %%par.end, i8* %%par.partials) "
+			 "nounwind {\nentry:\n",
+			 p_self->id);
+	string_append_str(p_module, line);
+
+	if (p_self->reductionCount) {
+		// %par.accumulator = bitcast i8* %par.partials to { T... }*
+		string_append_str(p_module, "  %par.accumulator = bitcast i8* %par.partials to ");
+		parallel___append_partials_type(p_self, p_module);
+		string_append_str(p_module, "*\n");
+	}
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		const char* lp_name = p_self->reductions[index].name;
+		const char* lp_type = parallel___llvm_type(p_self->reductions[index].primitive);
+		char		pointer[PARALLEL_NAME_LENGTH];
+
+		snprintf(pointer, sizeof(pointer), "%%par.partial.%zu", index);
+		parallel___append_partial(p_self, index, pointer, "%par.accumulator", p_module);
+
+		// %x.partial = alloca T, kept in a register across the loop once LLVM promotes it
+		// %par.start.N = load T, T* %par.partial.N
+		// store T %par.start.N, T* %x.partial
+		snprintf(line, sizeof(line),
+				 "  %%%s.partial = alloca %s\n  %%par.start.%zu = load %s, %s* %s\n"
+				 "  store %s %%par.start.%zu, %s* %%%s.partial\n",
+				 lp_name, lp_type, index, lp_type, lp_type, pointer, lp_type, index, lp_type,
+				 lp_name);
+		string_append_str(p_module, line);
+	}
+
+	// The runtime's ranges are never empty and always fit an i64
+	p_loop->isSigned = true;
+	loop_lowering_emit_begin(p_loops, p_loop, "i64", "%par.begin", "%par.end", "%par.index",
+							 p_module);
+
+	if (p_loop->kind == LOOP_RANGE) {
+		// %i = trunc i64 %par.index to T, or a no-op bitcast for an i64
+		snprintf(line, sizeof(line), "  %s = %s i64 %%par.index to %s\n", p_binding,
+				 strcmp(p_bindingType, "i64") == 0 ? "bitcast" : "trunc", p_bindingType);
+		string_append_str(p_module, line);
+	}
+}
+
+/**
+ * Appends the identity of a reduction, the value its partial results start from.
+ *
+ * @param p_reduction The reduction.
+ * @param p_output    Where to append the value.
+ */
+void parallel___append_identity(const struct ParallelReduction* p_reduction,
+								struct String* p_output) {
+	bool isFloat = p_reduction->primitive == TYPE_PRIMITIVE_F32
+				   || p_reduction->primitive == TYPE_PRIMITIVE_F64;
+
+	switch (p_reduction->operation) {
+	case LEXERTOKENS_MULTIPLICATION:
+		string_append_str(p_output, isFloat ? "1.0" : "1");
+		break;
+	case LEXERTOKENS_BITWISE_AND:
+		string_append_str(p_output, p_reduction->primitive == TYPE_PRIMITIVE_BOOL ? "true" : "-1");
+		break;
+	case LEXERTOKENS_ADDITION: // -0.0, as 0.0 + -0.0 would lose the sign of an all -0.0 sum
+		string_append_str(p_output, isFloat ? "-0.0" : "0");
+		break;
+	default: // '|' and '^'
+		string_append_str(p_output, p_reduction->primitive == TYPE_PRIMITIVE_BOOL ? "false" : "0");
+		break;
+	}
+}
+
+/**
+ * Gets the instruction combining two partial results of a reduction.
+ *
+ * @param p_reduction The reduction.
+ *
+ * @return The instruction, e.g. 'fadd'.
+ */
+const char* parallel___combine_instruction(const struct ParallelReduction* p_reduction) {
+	bool isFloat = p_reduction->primitive == TYPE_PRIMITIVE_F32
+				   || p_reduction->primitive == TYPE_PRIMITIVE_F64;
+
+	switch (p_reduction->operation) {
+	case LEXERTOKENS_ADDITION:
+		return isFloat ? "fadd" : "add";
+	case LEXERTOKENS_MULTIPLICATION:
+		return isFloat ? "fmul" : "mul";
+	case LEXERTOKENS_BITWISE_AND:
+		return "and";
+	case LEXERTOKENS_BITWISE_OR:
+		return "or";
+	default:
+		return "xor";
+	}
+}
+
+void parallel_lowering_emit_end(const struct ParallelLowering* p_self,
+								const struct CountedLoop* p_loop, struct String* p_module) {
+	char line[PARALLEL_LINE_LENGTH];
+
+	loop_lowering_emit_end(p_loop, p_module);
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		const char* lp_name = p_self->reductions[index].name;
+		const char* lp_type = parallel___llvm_type(p_self->reductions[index].primitive);
+
+		// %par.final.N = load T, T* %x.partial
+		// store T %par.final.N, T* %par.partial.N
+		snprintf(line, sizeof(line),
+				 "  %%par.final.%zu = load %s, %s* %%%s.partial\n"
+				 "  store %s %%par.final.%zu, %s* %%par.partial.%zu\n",
+				 index, lp_type, lp_type, lp_name, lp_type, index, lp_type, index);
+		string_append_str(p_module, line);
+	}
+
+	string_append_str(p_module, "  ret void\n}\n");
+
+	if (!p_self->reductionCount) {
+		return;
+	}
+
+	// @par.N.identity = private unnamed_addr constant { T... } { T identity, ... }
+	snprintf(line, sizeof(line),
+			 "\n@" PARALLEL_BODY_PREFIX "%zu.identity = private unnamed_addr constant ",
+			 p_self->id);
+	string_append_str(p_module, line);
+	parallel___append_partials_type(p_self, p_module);
+	string_append_str(p_module, " { ");
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		string_append_str(p_module, index ? ", " : "");
+		string_append_str(p_module, parallel___llvm_type(p_self->reductions[index].primitive));
+		string_append_chr(p_module, ' ');
+		parallel___append_identity(&p_self->reductions[index], p_module);
+	}
+
+	string_append_str(p_module, " }\n");
+
+	// define internal void @par.N.combine(i8* %into, i8* %from)
+	snprintf(line, sizeof(line),
+			 "\ndefine internal void @" PARALLEL_BODY_PREFIX
+			 "%zu.combine(i8* %%into, i8* %%from) nounwind {\n",
+			 p_self->id);
+	string_append_str(p_module, line);
+	string_append_str(p_module, "  %into.partials = bitcast i8* %into to ");
+	parallel___append_partials_type(p_self, p_module);
+	string_append_str(p_module, "*\n  %from.partials = bitcast i8* %from to ");
+	parallel___append_partials_type(p_self, p_module);
+	string_append_str(p_module, "*\n");
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		const char* lp_type = parallel___llvm_type(p_self->reductions[index].primitive);
+		char		into[PARALLEL_NAME_LENGTH];
+		char		from[PARALLEL_NAME_LENGTH];
+
+		snprintf(into, sizeof(into), "%%into.%zu", index);
+		snprintf(from, sizeof(from), "%%from.%zu", index);
+		parallel___append_partial(p_self, index, into, "%into.partials", p_module);
+		parallel___append_partial(p_self, index, from, "%from.partials", p_module);
+
+		// %into.N.value = load T, T* %into.N
+		// %from.N.value = load T, T* %from.N
+		// %combined.N = OP T %into.N.value, %from.N.value
+		// store T %combined.N, T* %into.N
+		snprintf(line, sizeof(line),
+				 "  %s.value = load %s, %s* %s\n  %s.value = load %s, %s* %s\n"
+				 "  %%combined.%zu = %s %s %s.value, %s.value\n  store %s %%combined.%zu, %s* %s\n",
+				 into, lp_type, lp_type, into, from, lp_type, lp_type, from, index,
+				 parallel___combine_instruction(&p_self->reductions[index]), lp_type, into, from,
+				 lp_type, index, lp_type, into);
+		string_append_str(p_module, line);
+	}
+
+	string_append_str(p_module, "  ret void\n}\n");
+}
+
+void parallel_lowering_emit_run(struct ParallelLowering* p_self, const char* p_begin,
+								const char* p_end, const char* p_context,
+								const char* const* p_variables, struct String* p_function,
+								struct String* p_module) {
+	char line[PARALLEL_LINE_LENGTH];
+
+	if (!p_self->reductionCount) {
+		// call void @task_SEP_for(i64 begin, i64 end, BODY, i8* context)
+		snprintf(line, sizeof(line),
+				 "  call void @task_SEP_for(i64 %s, i64 %s, void (i8*, i64, i64, i8*)* "
+				 "@" PARALLEL_BODY_PREFIX "%zu, i8* %s)\n",
+				 p_begin, p_end, p_self->id, p_context);
+		string_append_str(p_function, line);
+
+		return;
+	}
+
+	if (!p_self->stackDeclared) {
+		string_append_str(p_module, "declare i8* @llvm.stacksave()\n"
+									"declare void @llvm.stackrestore(i8*)\n");
+		p_self->stackDeclared = true;
+	}
+
+	char results[PARALLEL_NAME_LENGTH];
+
+	snprintf(results, sizeof(results), "%%" PARALLEL_BODY_PREFIX "%zu.results", p_self->id);
+
+	// The results are allocated in place, so the stack is restored in case the run is in a loop
+	// %par.N.stack = call i8* @llvm.stacksave()
+	// %par.N.results = alloca { T... }
+	snprintf(line, sizeof(line),
+			 "  %%" PARALLEL_BODY_PREFIX "%zu.stack = call i8* @llvm.stacksave()\n  %s = alloca ",
+			 p_self->id, results);
+	string_append_str(p_function, line);
+	parallel___append_partials_type(p_self, p_function);
+	string_append_chr(p_function, '\n');
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		const char* lp_type = parallel___llvm_type(p_self->reductions[index].primitive);
+		char		pointer[PARALLEL_NAME_LENGTH];
+
+		snprintf(pointer, sizeof(pointer), "%%" PARALLEL_BODY_PREFIX "%zu.result.%zu", p_self->id,
+				 index);
+		parallel___append_partial(p_self, index, pointer, results, p_function);
+
+		// %par.N.result.M.start = load T, T* VARIABLE
+		// store T %par.N.result.M.start, T* %par.N.result.M
+		snprintf(line, sizeof(line),
+				 "  %s.start = load %s, %s* %s\n  store %s %s.start, %s* %s\n", pointer, lp_type,
+				 lp_type, p_variables[index], lp_type, pointer, lp_type, pointer);
+		string_append_str(p_function, line);
+	}
+
+	// %par.N.results.raw = bitcast { T... }* %par.N.results to i8*
+	snprintf(line, sizeof(line), "  %s.raw = bitcast ", results);
+	string_append_str(p_function, line);
+	parallel___append_partials_type(p_self, p_function);
+	snprintf(line, sizeof(line), "* %s to i8*\n", results);
+	string_append_str(p_function, line);
+
+	// call void @task_SEP_reduce(i64 begin, i64 end, BODY, i8* context, i8* IDENTITY, i64 SIZE,
+	//                            COMBINE, i8* %par.N.results.raw)
+	snprintf(line, sizeof(line),
+			 "  call void @task_SEP_reduce(i64 %s, i64 %s, void (i8*, i64, i64, i8*)* "
+			 "@" PARALLEL_BODY_PREFIX "%zu, i8* %s, i8* bitcast (",
+			 p_begin, p_end, p_self->id, p_context);
+	string_append_str(p_function, line);
+	parallel___append_partials_type(p_self, p_function);
+	snprintf(line, sizeof(line), "* @" PARALLEL_BODY_PREFIX "%zu.identity to i8*), i64 ptrtoint (",
+			 p_self->id);
+	string_append_str(p_function, line);
+	parallel___append_partials_type(p_self, p_function);
+	string_append_str(p_function, "* getelementptr (");
+	parallel___append_partials_type(p_self, p_function);
+	string_append_str(p_function, ", ");
+	parallel___append_partials_type(p_self, p_function);
+	snprintf(line, sizeof(line),
+			 "* null, i32 1) to i64), void (i8*, i8*)* @" PARALLEL_BODY_PREFIX
+			 "%zu.combine, i8* %s.raw)\n",
+			 p_self->id, results);
+	string_append_str(p_function, line);
+
+	for (size_t index = 0; index < p_self->reductionCount; index++) {
+		const char* lp_type = parallel___llvm_type(p_self->reductions[index].primitive);
+
+		// %par.N.result.M.end = load T, T* %par.N.result.M
+		// store T %par.N.result.M.end, T* VARIABLE
+		snprintf(line, sizeof(line),
+				 "  %%" PARALLEL_BODY_PREFIX "%zu.result.%zu.end = load %s, %s* "
+				 "%%" PARALLEL_BODY_PREFIX "%zu.result.%zu\n"
+				 "  store %s %%" PARALLEL_BODY_PREFIX "%zu.result.%zu.end, %s* %s\n",
+				 p_self->id, index, lp_type, lp_type, p_self->id, index, lp_type, p_self->id,
+				 index, lp_type, p_variables[index]);
+		string_append_str(p_function, line);
+	}
+
+	// call void @llvm.stackrestore(i8* %par.N.stack)
+	snprintf(line, sizeof(line),
+			 "  call void @llvm.stackrestore(i8* %%" PARALLEL_BODY_PREFIX "%zu.stack)\n",
+			 p_self->id);
+	string_append_str(p_function, line);
+}
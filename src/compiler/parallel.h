@@ -0,0 +1,164 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./loops.h"
+#include "./ownership.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PARALLEL_BODY_PREFIX "par." // Outlined bodies are named '@par.<N>'.
+
+/**
+ * Represents a variable of a parallel loop's function the loop's body reduces into, e.g. 'sum' for
+ * 'sum += n'.
+ */
+struct ParallelReduction {
+	const char* name;
+	uint8_t		operation; // enum LexerTokenIdentifiers, the binary operator folding values in.
+	uint8_t		primitive; // enum TypePrimitives of the variable.
+};
+
+#define PARALLEL_REDUCTION_SIZE sizeof(struct ParallelReduction)
+
+/**
+ * Represents the lowering of parallel loops, 'for numbers.par() => n', onto the runtime's work
+ * stealing scheduler ('task' in std.ll). The body is outlined into a function running a counted
+ * loop over a range of the iterations, which the runtime splits across one worker per core. The
+ * body may read the variables of its function and the module, but the only ones it may write are
+ * reductions into variables of its function (e.g. 'sum += n'), for which each worker folds into
+ * its own partial result, combined once every iteration has run. Anything else would be a data
+ * race, and is an error, including passing a variable to a call that may keep it.
+ */
+struct ParallelLowering {
+	const char*				  filePath;  // For diagnostics.
+	struct TypeTable*		  types;	 // Not const, to substitute the types of instances.
+	const struct FlatAST*	  ast;		 // The AST of the current loop.
+	const struct Inference*	  inference; // The inference of the current loop's function.
+	const struct Ownership*	  ownership; // The ownership of the current loop's function.
+	const struct CountedLoop* loop;		 // The current loop.
+	type_id_t				  params;	 // Tuple of the type parameters of the loop's instance.
+	type_id_t				  args;		 // Tuple of their type arguments.
+	const char**			  locals;	 // The variables of the function declared outside the loop.
+	const char**			  captures;	 // The variables of the function the loop's body reads.
+	struct ParallelReduction* reductions; // The variables of the function the loop reduces into.
+	size_t localCount, localCapacity, captureCount, captureCapacity, reductionCount,
+		reductionCapacity;
+	size_t id;			   // The id of the current loop's outlined body.
+	size_t emitted;		   // Bodies emitted, for unique names.
+	bool   stackDeclared;  // Whether 'llvm.stacksave' and 'llvm.stackrestore' are declared.
+	size_t loops, reduced; // For the time report.
+};
+
+#define PARALLELLOWERING_STRUCT_SIZE sizeof(struct ParallelLowering)
+
+/**
+ * Creates a new ParallelLowering struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_types    The module's type table.
+ *
+ * @return The created ParallelLowering struct.
+ */
+struct ParallelLowering* parallel_lowering_new(const char* p_filePath, struct TypeTable* p_types);
+
+/**
+ * Frees a ParallelLowering struct.
+ *
+ * @param p_self The current ParallelLowering struct.
+ */
+void parallel_lowering_free(struct ParallelLowering** p_self);
+
+/**
+ * Finds the variables a parallel loop's body reads and reduces into. Errors if the loop does not
+ * iterate a range or an array, returns from its body, writes to a variable of the module, writes
+ * to a variable of its function other than through a reduction ('+=', '-=', '*=', '&=', '|=',
+ * '^=', or e.g. 'x = x + n') that the body never otherwise reads, or passes a variable of its
+ * function or the module other than a number or a bool to a call that does not borrow it.
+ *
+ * @param p_self      The current ParallelLowering struct.
+ * @param p_ast       The AST containing the loop.
+ * @param p_inference The inference the loop's function was inferred with.
+ * @param p_ownership The ownership the loop's function was analysed with, by ownership_function.
+ * @param function    The function containing the loop.
+ * @param params      Tuple of the type parameters of the function's instance, else TYPE_ID_NONE.
+ * @param args        Tuple of their type arguments.
+ * @param p_loop      The loop, as analysed by loop_lowering_analyse.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void parallel_lowering_analyse(struct ParallelLowering* p_self, const struct FlatAST* p_ast,
+							   const struct Inference* p_inference,
+							   const struct Ownership* p_ownership, flat_ast_index_t function,
+							   type_id_t params, type_id_t args, const struct CountedLoop* p_loop);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Gets the reduction of a variable of the last analysed loop.
+ *
+ * @param p_self The current ParallelLowering struct.
+ * @param p_name The variable's name.
+ *
+ * @return The reduction, NULL if the loop does not reduce into the variable.
+ */
+const struct ParallelReduction* parallel_lowering_get_reduction(
+	const struct ParallelLowering* p_self, const char* p_name);
+
+/**
+ * Emits the start of the last analysed loop's outlined body, up to the start of the loop's body:
+ * 'void @par.<N>(i8* %par.context, i64 %par.begin, i64 %par.end, i8* %par.partials)', which
+ * loads the partial result of each reduction into the alloca '%<name>.partial' and runs a counted
+ * loop from '%par.begin' to '%par.end'. The body reads its function's variables through the
+ * context, and reduces into the allocas. A range loop's binding is the induction variable; an
+ * array loop's is loaded with loop_lowering_emit_element, from the data pointer in the context.
+ *
+ * @param p_self        The current ParallelLowering struct.
+ * @param p_loops       The module's LoopLowering struct.
+ * @param p_loop        The loop, whose induction variable is set to '%par.index'.
+ * @param p_binding     The name of the loop's binding, e.g. '%i'.
+ * @param p_bindingType The LLVM type of the binding of a range loop, e.g. 'i32'.
+ * @param p_module      Where to append the IR, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void parallel_lowering_emit_begin(struct ParallelLowering* p_self, struct LoopLowering* p_loops,
+								  struct CountedLoop* p_loop, const char* p_binding,
+								  const char* p_bindingType, struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the end of the last analysed loop's outlined body after the loop's body, storing the
+ * partial results back, and the identity and combining function of its reductions.
+ *
+ * @param p_self   The current ParallelLowering struct.
+ * @param p_loop   The loop.
+ * @param p_module Where to append the IR, at module level.
+ */
+void parallel_lowering_emit_end(const struct ParallelLowering* p_self,
+								const struct CountedLoop* p_loop, struct String* p_module);
+
+/**
+ * Emits the run of the last analysed loop, in place of the loop, which returns once every
+ * iteration has run. The reductions start from the current values of their variables, and the
+ * results are stored back into them.
+ *
+ * @param p_self      The current ParallelLowering struct.
+ * @param p_begin     The 'i64' first iteration, e.g. '0'.
+ * @param p_end       The 'i64' iteration to stop at, e.g. the array's length.
+ * @param p_context   The 'i8*' context passed to the body.
+ * @param p_variables The pointer to each reduction's variable, in the order of the reductions.
+ * @param p_function  Where to append the IR of the function being generated.
+ * @param p_module    Where to append intrinsic declarations, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void parallel_lowering_emit_run(struct ParallelLowering* p_self, const char* p_begin,
+								const char* p_end, const char* p_context,
+								const char* const* p_variables, struct String* p_function,
+								struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
@@ -0,0 +1,659 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./power.h"
+#include "../utils/panic.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POWER_TEMPORARY_LENGTH 32U
+
+// The intrinsics. Each has a bit of PowerLowering.intrinsics per float type, 'f32' then 'f64'
+#define POWER_INTRINSIC_POWI 0U // (float, i32)
+#define POWER_INTRINSIC_POW	 1U // (float, float)
+#define POWER_INTRINSIC_FABS 2U // (float)
+
+#define POWER_I32_MIN "-2147483648"
+#define POWER_I32_MAX "2147483647"
+
+struct PowerLowering* power_lowering_new(void) {
+	struct PowerLowering* lp_self = calloc(1, POWERLOWERING_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc PowerLowering struct");
+	}
+
+	return lp_self;
+}
+
+void power_lowering_free(struct PowerLowering** p_self) {
+	if (p_self && *p_self) {
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("PowerLowering struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether a primitive is a float.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return Whether the primitive is a float.
+ */
+bool power___is_float(const enum TypePrimitives PRIMITIVE) {
+	return PRIMITIVE == TYPE_PRIMITIVE_F32 || PRIMITIVE == TYPE_PRIMITIVE_F64;
+}
+
+/**
+ * Checks whether a primitive is a signed integer.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return Whether the primitive is a signed integer.
+ */
+bool power___is_signed(const enum TypePrimitives PRIMITIVE) {
+	return PRIMITIVE >= TYPE_PRIMITIVE_I8 && PRIMITIVE <= TYPE_PRIMITIVE_I64;
+}
+
+/**
+ * Gets the width of a numeric primitive.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return The width in bits.
+ */
+size_t power___bits(const enum TypePrimitives PRIMITIVE) {
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_U8:
+		return 8;
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_U16:
+		return 16;
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_U32:
+	case TYPE_PRIMITIVE_F32:
+		return 32;
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+	case TYPE_PRIMITIVE_F64:
+		return 64;
+	default:
+		PANIC("unsupported primitive for '**'");
+	}
+}
+
+/**
+ * Checks whether every value of an integer primitive is an 'i32', as 'llvm.powi' takes.
+ *
+ * @param PRIMITIVE The integer primitive.
+ *
+ * @return Whether the primitive fits an 'i32'.
+ */
+bool power___fits_i32(const enum TypePrimitives PRIMITIVE) {
+	size_t bits = power___bits(PRIMITIVE);
+
+	return bits < 32 || (bits == 32 && power___is_signed(PRIMITIVE));
+}
+
+/**
+ * Gets the LLVM type of a numeric primitive.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return The LLVM type.
+ */
+const char* power___llvm_type(const enum TypePrimitives PRIMITIVE) {
+	if (power___is_float(PRIMITIVE)) {
+		return PRIMITIVE == TYPE_PRIMITIVE_F32 ? "float" : "double";
+	}
+
+	switch (power___bits(PRIMITIVE)) {
+	case 8:
+		return "i8";
+	case 16:
+		return "i16";
+	case 32:
+		return "i32";
+	default:
+		return "i64";
+	}
+}
+
+/**
+ * Creates the name of a new temporary.
+ *
+ * @param p_self      The current PowerLowering struct.
+ * @param p_temporary Where to write the name (POWER_TEMPORARY_LENGTH characters).
+ */
+void power___temporary(struct PowerLowering* p_self, char* p_temporary) {
+	snprintf(p_temporary, POWER_TEMPORARY_LENGTH, "%%pow.%zu", p_self->temporaries++);
+}
+
+/**
+ * Emits the conversion of a value between numeric primitives.
+ *
+ * @param p_self     The current PowerLowering struct.
+ * @param FROM       The primitive of the value.
+ * @param p_value    The value.
+ * @param TO         The primitive to convert to.
+ * @param p_function Where to append the IR.
+ * @param p_result   Where to write the converted value (POWER_TEMPORARY_LENGTH characters).
+ *
+ * @return The converted value, either p_value or p_result.
+ */
+const char* power___convert(struct PowerLowering* p_self, const enum TypePrimitives FROM,
+							const char* p_value, const enum TypePrimitives TO,
+							struct String* p_function, char* p_result) {
+	const char* lp_instruction = NULL;
+
+	if (power___is_float(FROM) && power___is_float(TO)) {
+		if (FROM != TO) {
+			lp_instruction = FROM == TYPE_PRIMITIVE_F32 ? "fpext" : "fptrunc";
+		}
+	} else if (power___is_float(TO)) {
+		lp_instruction = power___is_signed(FROM) ? "sitofp" : "uitofp";
+	} else if (power___bits(FROM) < power___bits(TO)) {
+		lp_instruction = power___is_signed(FROM) ? "sext" : "zext";
+	} else if (power___bits(FROM) > power___bits(TO)) {
+		lp_instruction = "trunc";
+	}
+
+	if (!lp_instruction) { // Same LLVM type
+		return p_value;
+	}
+
+	power___temporary(p_self, p_result);
+
+	string_append_str(p_function, "  ");
+	string_append_str(p_function, p_result);
+	string_append_str(p_function, " = ");
+	string_append_str(p_function, lp_instruction);
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, power___llvm_type(FROM));
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_value);
+	string_append_str(p_function, " to ");
+	string_append_str(p_function, power___llvm_type(TO));
+	string_append_chr(p_function, '\n');
+
+	return p_result;
+}
+
+/**
+ * Emits a binary instruction.
+ *
+ * @param p_function    Where to append the IR.
+ * @param p_result      The name of the result.
+ * @param p_instruction The instruction, e.g. 'mul'.
+ * @param p_type        The LLVM type of the operands.
+ * @param p_lhs         The left operand.
+ * @param p_rhs         The right operand.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void power___binary(struct String* p_function, const char* p_result, const char* p_instruction,
+					const char* p_type, const char* p_lhs, const char* p_rhs) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	string_append_str(p_function, "  ");
+	string_append_str(p_function, p_result);
+	string_append_str(p_function, " = ");
+	string_append_str(p_function, p_instruction);
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_type);
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_lhs);
+	string_append_str(p_function, ", ");
+	string_append_str(p_function, p_rhs);
+	string_append_chr(p_function, '\n');
+}
+
+/**
+ * Emits an integer power with a constant exponent as a chain of multiplications, squaring for
+ * each bit of the exponent and multiplying by the base for each set bit, e.g. 'x ** 5' is
+ * '((x * x) * (x * x)) * x'.
+ *
+ * @param p_self     The current PowerLowering struct.
+ * @param p_type     The LLVM type of the base.
+ * @param p_base     The base.
+ * @param exponent   The exponent.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the IR.
+ */
+void power___emit_chain(struct PowerLowering* p_self, const char* p_type, const char* p_base,
+						uint64_t exponent, const char* p_result, struct String* p_function) {
+	char		temporaries[2][POWER_TEMPORARY_LENGTH];
+	const char* lp_accumulator = p_base;
+	const char* lp_next		   = NULL;
+	size_t		current		   = 0;
+	int			bit			   = 63;
+
+	p_self->chains++;
+
+	if (exponent <= 1) { // 'x ** 0' is 1 (even for 0), 'x ** 1' is x
+		power___binary(p_function, p_result, "add", p_type, exponent ? p_base : "1", "0");
+		return;
+	}
+
+	while (!(exponent & (1ULL << bit))) {
+		bit--;
+	}
+
+	for (bit--; bit >= 0; bit--) {
+		bool set = exponent & (1ULL << bit);
+
+		// Square, the last instruction of the chain being named after the result
+		if (bit == 0 && !set) {
+			lp_next = p_result;
+		} else {
+			power___temporary(p_self, temporaries[current]);
+			lp_next = temporaries[current];
+			current ^= 1;
+		}
+
+		power___binary(p_function, lp_next, "mul", p_type, lp_accumulator, lp_accumulator);
+		lp_accumulator = lp_next;
+
+		if (set) { // Multiply by the base
+			if (bit == 0) {
+				lp_next = p_result;
+			} else {
+				power___temporary(p_self, temporaries[current]);
+				lp_next = temporaries[current];
+				current ^= 1;
+			}
+
+			power___binary(p_function, lp_next, "mul", p_type, lp_accumulator, p_base);
+			lp_accumulator = lp_next;
+		}
+	}
+}
+
+/**
+ * Appends IR from a template, replacing each '$' with the base's type and each '#' with the
+ * exponent's type.
+ *
+ * @param p_output   Where to append the IR.
+ * @param p_template The template.
+ * @param p_base     The LLVM type of the base.
+ * @param p_exponent The LLVM type of the exponent.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void power___append_template(struct String* p_output, const char* p_template, const char* p_base,
+							 const char* p_exponent) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	for (; *p_template; p_template++) {
+		if (*p_template == '$') {
+			string_append_str(p_output, p_base);
+		} else if (*p_template == '#') {
+			string_append_str(p_output, p_exponent);
+		} else {
+			string_append_chr(p_output, *p_template);
+		}
+	}
+}
+
+/**
+ * Appends the name of the helper of a (base, exponent) pair, e.g. '@"exeme.ipow.i32.u64"'.
+ *
+ * @param BASE     The primitive type of the base.
+ * @param EXPONENT The primitive type of the exponent.
+ * @param p_output Where to append the name.
+ */
+void power___append_helper(const enum TypePrimitives BASE, const enum TypePrimitives EXPONENT,
+						   struct String* p_output) {
+	string_append_str(p_output, power___is_float(BASE) ? "@\"exeme.fpow." : "@\"exeme.ipow.");
+	string_append_str(p_output, type_primitive_get_name(BASE));
+	string_append_chr(p_output, '.');
+	string_append_str(p_output, type_primitive_get_name(EXPONENT));
+	string_append_chr(p_output, '"');
+}
+
+/**
+ * Starts the helper of a (base, exponent) pair, unless it has already been emitted.
+ *
+ * @param p_self   The current PowerLowering struct.
+ * @param BASE     The primitive type of the base.
+ * @param EXPONENT The primitive type of the exponent.
+ * @param p_module Where to append the helper.
+ *
+ * @return Whether the helper has to be emitted.
+ */
+bool power___begin_helper(struct PowerLowering* p_self, const enum TypePrimitives BASE,
+						  const enum TypePrimitives EXPONENT, struct String* p_module) {
+	if (p_self->helpers[BASE] & (1U << EXPONENT)) {
+		return false;
+	}
+
+	p_self->helpers[BASE] |= 1U << EXPONENT;
+
+	// define internal i32 @"exeme.ipow.i32.u64"(i32 %base, i64 %exponent) {
+	string_append_str(p_module, "define internal ");
+	string_append_str(p_module, power___llvm_type(BASE));
+	string_append_chr(p_module, ' ');
+	power___append_helper(BASE, EXPONENT, p_module);
+	power___append_template(p_module, "($ %base, # %exponent) {\nentry:\n",
+							power___llvm_type(BASE), power___llvm_type(EXPONENT));
+
+	return true;
+}
+
+/**
+ * Emits the exponentiation by squaring helper of an integer (base, exponent) pair, unless it has
+ * already been emitted. The exponent keeps its own width and signedness, so wide exponents are not
+ * truncated and negative ones are not taken for large unsigned ones.
+ *
+ * @param p_self   The current PowerLowering struct.
+ * @param BASE     The integer type of the base.
+ * @param EXPONENT The integer type of the exponent.
+ * @param p_module Where to append the helper.
+ */
+void power___emit_integer_helper(struct PowerLowering* p_self, const enum TypePrimitives BASE,
+								 const enum TypePrimitives EXPONENT, struct String* p_module) {
+	if (!power___begin_helper(p_self, BASE, EXPONENT, p_module)) {
+		return;
+	}
+
+	const char* lp_base		= power___llvm_type(BASE);
+	const char* lp_exponent = power___llvm_type(EXPONENT);
+
+	if (power___is_signed(EXPONENT)) { // Negative exponents give 1 / base ** -exponent, truncated
+		power___append_template(p_module,
+								"  %is.negative = icmp slt # %exponent, 0\n"
+								"  br i1 %is.negative, label %negative, label %head\n"
+								"negative:\n"
+								"  %is.one = icmp eq $ %base, 1\n",
+								lp_base, lp_exponent);
+
+		if (power___is_signed(BASE)) { // Only 1 and -1 have integer reciprocals
+			power___append_template(p_module,
+									"  %is.minus.one = icmp eq $ %base, -1\n"
+									"  %parity = and # %exponent, 1\n"
+									"  %is.odd = icmp ne # %parity, 0\n"
+									"  %minus.one.power = select i1 %is.odd, $ -1, $ 1\n"
+									"  %unit.power = select i1 %is.minus.one, $ %minus.one.power, "
+									"$ 0\n",
+									lp_base, lp_exponent);
+		} else {
+			string_append_str(p_module, "  %unit.power = add ");
+			string_append_str(p_module, lp_base);
+			string_append_str(p_module, " 0, 0\n");
+		}
+
+		power___append_template(p_module,
+								"  %negative.power = select i1 %is.one, $ 1, $ %unit.power\n"
+								"  ret $ %negative.power\n",
+								lp_base, lp_exponent);
+	} else {
+		string_append_str(p_module, "  br label %head\n");
+	}
+
+	power___append_template(p_module,
+							"head:\n"
+							"  %result = phi $ [ 1, %entry ], [ %result.next, %body ]\n"
+							"  %square = phi $ [ %base, %entry ], [ %square.next, %body ]\n"
+							"  %bits = phi # [ %exponent, %entry ], [ %bits.next, %body ]\n"
+							"  %is.done = icmp eq # %bits, 0\n"
+							"  br i1 %is.done, label %exit, label %body\n"
+							"body:\n"
+							"  %bit = and # %bits, 1\n"
+							"  %is.set = icmp ne # %bit, 0\n"
+							"  %product = mul $ %result, %square\n"
+							"  %result.next = select i1 %is.set, $ %product, $ %result\n"
+							"  %square.next = mul $ %square, %square\n"
+							"  %bits.next = lshr # %bits, 1\n"
+							"  br label %head\n"
+							"exit:\n"
+							"  ret $ %result\n"
+							"}\n",
+							lp_base, lp_exponent);
+}
+
+/**
+ * Appends the name of a float intrinsic, e.g. 'llvm.powi.f64.i32'.
+ *
+ * @param TYPE      The float type.
+ * @param intrinsic The intrinsic, e.g. POWER_INTRINSIC_POWI.
+ * @param p_output  Where to append the name.
+ */
+void power___append_intrinsic(const enum TypePrimitives TYPE, uint32_t intrinsic,
+							  struct String* p_output) {
+	static const char* const s_NAMES[] = {"@llvm.powi.", "@llvm.pow.", "@llvm.fabs."};
+
+	string_append_str(p_output, s_NAMES[intrinsic]);
+	string_append_str(p_output, TYPE == TYPE_PRIMITIVE_F32 ? "f32" : "f64");
+	string_append_str(p_output, intrinsic == POWER_INTRINSIC_POWI ? ".i32" : "");
+}
+
+/**
+ * Declares a float intrinsic, unless it has already been declared.
+ *
+ * @param p_self    The current PowerLowering struct.
+ * @param TYPE      The float type.
+ * @param intrinsic The intrinsic, e.g. POWER_INTRINSIC_POWI.
+ * @param p_module  Where to append the declaration.
+ */
+void power___declare_intrinsic(struct PowerLowering* p_self, const enum TypePrimitives TYPE,
+							   uint32_t intrinsic, struct String* p_module) {
+	uint32_t bit = 1U << ((intrinsic * 2) + (TYPE == TYPE_PRIMITIVE_F64));
+
+	if (p_self->intrinsics & bit) {
+		return;
+	}
+
+	p_self->intrinsics |= bit;
+
+	// declare double @llvm.powi.f64.i32(double, i32)
+	string_append_str(p_module, "declare ");
+	string_append_str(p_module, power___llvm_type(TYPE));
+	string_append_chr(p_module, ' ');
+	power___append_intrinsic(TYPE, intrinsic, p_module);
+	string_append_chr(p_module, '(');
+	string_append_str(p_module, power___llvm_type(TYPE));
+
+	if (intrinsic != POWER_INTRINSIC_FABS) {
+		string_append_str(p_module, ", ");
+		string_append_str(p_module,
+						  intrinsic == POWER_INTRINSIC_POWI ? "i32" : power___llvm_type(TYPE));
+	}
+
+	string_append_str(p_module, ")\n");
+}
+
+/**
+ * Emits the helper of a float base with an integer exponent wider than an 'i32', unless it has
+ * already been emitted. Exponents in the range of an 'i32' use 'llvm.powi', the others 'llvm.pow'
+ * on the magnitude of the base, negated for a negative base and an odd exponent, as a float
+ * exponent that large is always even.
+ *
+ * @param p_self   The current PowerLowering struct.
+ * @param BASE     The float type of the base.
+ * @param EXPONENT The integer type of the exponent.
+ * @param p_module Where to append the helper.
+ */
+void power___emit_float_helper(struct PowerLowering* p_self, const enum TypePrimitives BASE,
+							   const enum TypePrimitives EXPONENT, struct String* p_module) {
+	if (!power___begin_helper(p_self, BASE, EXPONENT, p_module)) {
+		return;
+	}
+
+	const char* lp_base		= power___llvm_type(BASE);
+	const char* lp_exponent = power___llvm_type(EXPONENT);
+
+	if (power___is_signed(EXPONENT)) {
+		power___append_template(p_module,
+								"  %is.low = icmp slt # %exponent, " POWER_I32_MIN "\n"
+								"  %is.high = icmp sgt # %exponent, " POWER_I32_MAX "\n"
+								"  %is.wide = or i1 %is.low, %is.high\n",
+								lp_base, lp_exponent);
+	} else {
+		power___append_template(p_module, "  %is.wide = icmp ugt # %exponent, " POWER_I32_MAX "\n",
+								lp_base, lp_exponent);
+	}
+
+	string_append_str(p_module, "  br i1 %is.wide, label %wide, label %narrow\nnarrow:\n");
+
+	if (power___bits(EXPONENT) > 32) {
+		power___append_template(p_module, "  %narrow.exponent = trunc # %exponent to i32\n",
+								lp_base, lp_exponent);
+	} else {
+		string_append_str(p_module, "  %narrow.exponent = add i32 %exponent, 0\n");
+	}
+
+	// %power = call double @llvm.powi.f64.i32(double %base, i32 %narrow.exponent)
+	string_append_str(p_module, "  %power = call ");
+	string_append_str(p_module, lp_base);
+	string_append_chr(p_module, ' ');
+	power___append_intrinsic(BASE, POWER_INTRINSIC_POWI, p_module);
+	power___append_template(p_module,
+							"($ %base, i32 %narrow.exponent)\n"
+							"  ret $ %power\n"
+							"wide:\n"
+							"  %magnitude.base = call $ ",
+							lp_base, lp_exponent);
+	power___append_intrinsic(BASE, POWER_INTRINSIC_FABS, p_module);
+	power___append_template(p_module, "($ %base)\n", lp_base, lp_exponent);
+	string_append_str(p_module,
+					  power___is_signed(EXPONENT) ? "  %float.exponent = sitofp "
+												  : "  %float.exponent = uitofp ");
+	power___append_template(p_module, "# %exponent to $\n  %magnitude = call $ ", lp_base,
+							lp_exponent);
+	power___append_intrinsic(BASE, POWER_INTRINSIC_POW, p_module);
+	power___append_template(p_module,
+							"($ %magnitude.base, $ %float.exponent)\n"
+							"  %parity = and # %exponent, 1\n"
+							"  %is.odd = icmp ne # %parity, 0\n"
+							"  %is.negative = fcmp olt $ %base, 0.0\n"
+							"  %flips = and i1 %is.odd, %is.negative\n"
+							"  %negated = fneg $ %magnitude\n"
+							"  %wide.power = select i1 %flips, $ %negated, $ %magnitude\n"
+							"  ret $ %wide.power\n"
+							"}\n",
+							lp_base, lp_exponent);
+
+	power___declare_intrinsic(p_self, BASE, POWER_INTRINSIC_POWI, p_module);
+	power___declare_intrinsic(p_self, BASE, POWER_INTRINSIC_POW, p_module);
+	power___declare_intrinsic(p_self, BASE, POWER_INTRINSIC_FABS, p_module);
+}
+
+/**
+ * Emits a call to a float power intrinsic, declaring it unless it has already been declared.
+ *
+ * @param p_self     The current PowerLowering struct.
+ * @param TYPE       The float type.
+ * @param intrinsic  POWER_INTRINSIC_POWI for an 'i32' exponent, POWER_INTRINSIC_POW for a float.
+ * @param p_base     The base.
+ * @param p_exponent The exponent.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the call.
+ * @param p_module   Where to append the declaration.
+ */
+void power___emit_intrinsic(struct PowerLowering* p_self, const enum TypePrimitives TYPE,
+							uint32_t intrinsic, const char* p_base, const char* p_exponent,
+							const char* p_result, struct String* p_function,
+							struct String* p_module) {
+	const char* lp_type = power___llvm_type(TYPE);
+
+	p_self->intrinsicCalls++;
+	power___declare_intrinsic(p_self, TYPE, intrinsic, p_module);
+
+	// %result = call double @llvm.powi.f64.i32(double %base, i32 %exponent)
+	string_append_str(p_function, "  ");
+	string_append_str(p_function, p_result);
+	string_append_str(p_function, " = call ");
+	string_append_str(p_function, lp_type);
+	string_append_chr(p_function, ' ');
+	power___append_intrinsic(TYPE, intrinsic, p_function);
+	string_append_chr(p_function, '(');
+	string_append_str(p_function, lp_type);
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_base);
+	string_append_str(p_function, ", ");
+	string_append_str(p_function, intrinsic == POWER_INTRINSIC_POWI ? "i32" : lp_type);
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_exponent);
+	string_append_str(p_function, ")\n");
+}
+
+/**
+ * Emits a call to the helper of a (base, exponent) pair.
+ *
+ * @param BASE       The primitive type of the base.
+ * @param p_base     The base.
+ * @param EXPONENT   The primitive type of the exponent.
+ * @param p_exponent The exponent.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the call.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void power___emit_helper_call(const enum TypePrimitives BASE, const char* p_base,
+							  const enum TypePrimitives EXPONENT, const char* p_exponent,
+							  const char* p_result, struct String* p_function) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	// %result = call i32 @"exeme.ipow.i32.u64"(i32 %base, i64 %exponent)
+	string_append_str(p_function, "  ");
+	string_append_str(p_function, p_result);
+	string_append_str(p_function, " = call ");
+	string_append_str(p_function, power___llvm_type(BASE));
+	string_append_chr(p_function, ' ');
+	power___append_helper(BASE, EXPONENT, p_function);
+	string_append_chr(p_function, '(');
+	string_append_str(p_function, power___llvm_type(BASE));
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_base);
+	string_append_str(p_function, ", ");
+	string_append_str(p_function, power___llvm_type(EXPONENT));
+	string_append_chr(p_function, ' ');
+	string_append_str(p_function, p_exponent);
+	string_append_str(p_function, ")\n");
+}
+
+void power_lowering_emit(struct PowerLowering* p_self, const enum TypePrimitives BASE,
+						 const char* p_base, const enum TypePrimitives EXPONENT,
+						 const char* p_exponent, const int64_t* p_constant, const char* p_result,
+						 struct String* p_function, struct String* p_module) {
+	char base[POWER_TEMPORARY_LENGTH];
+	char exponent[POWER_TEMPORARY_LENGTH];
+
+	if (power___is_float(EXPONENT)) {
+		enum TypePrimitives type	= power___is_float(BASE) ? BASE : EXPONENT;
+		const char*			lp_base = power___convert(p_self, BASE, p_base, type, p_function, base);
+		const char*			lp_exponent =
+			power___convert(p_self, EXPONENT, p_exponent, type, p_function, exponent);
+
+		power___emit_intrinsic(p_self, type, POWER_INTRINSIC_POW, lp_base, lp_exponent, p_result,
+							   p_function, p_module);
+		return;
+	}
+
+	if (power___is_float(BASE)) {
+		if (!power___fits_i32(EXPONENT)) { // Range checked by the helper, never truncated
+			p_self->intrinsicCalls++;
+			power___emit_float_helper(p_self, BASE, EXPONENT, p_module);
+			power___emit_helper_call(BASE, p_base, EXPONENT, p_exponent, p_result, p_function);
+			return;
+		}
+
+		const char* lp_exponent =
+			power___convert(p_self, EXPONENT, p_exponent, TYPE_PRIMITIVE_I32, p_function, exponent);
+
+		power___emit_intrinsic(p_self, BASE, POWER_INTRINSIC_POWI, p_base, lp_exponent, p_result,
+							   p_function, p_module);
+		return;
+	}
+
+	if (p_constant && (*p_constant >= 0 || !power___is_signed(EXPONENT))) {
+		power___emit_chain(p_self, power___llvm_type(BASE), p_base, (uint64_t)*p_constant, p_result,
+						   p_function);
+		return;
+	}
+
+	p_self->squarings++;
+	power___emit_integer_helper(p_self, BASE, EXPONENT, p_module);
+	power___emit_helper_call(BASE, p_base, EXPONENT, p_exponent, p_result, p_function);
+}
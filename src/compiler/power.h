@@ -0,0 +1,67 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./types.h"
+#include "../utils/str.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Represents the lowering of the '**' operator. No call to a generic runtime 'pow' is ever made:
+ * - integer bases with a constant exponent become a chain of multiplications,
+ * - integer bases with a variable exponent call an internal exponentiation by squaring helper,
+ *   emitted once per (base, exponent) pair so the exponent keeps its own width and signedness,
+ * - float bases use the 'llvm.powi' intrinsic for exponents in the range of an 'i32', and
+ *   'llvm.pow' for float exponents, which LLVM expands or maps to the target's fastest
+ *   implementation. Wider integer exponents call a helper choosing between the two at runtime.
+ */
+struct PowerLowering {
+	uint32_t helpers[TYPE_PRIMITIVE_COUNT]; // Bitsets of the helpers emitted, by base and exponent.
+	uint32_t intrinsics; // Bitset of the intrinsics declared.
+	size_t	 temporaries;
+	size_t	 chains, squarings, intrinsicCalls; // For the time report.
+};
+
+#define POWERLOWERING_STRUCT_SIZE sizeof(struct PowerLowering)
+
+/**
+ * Creates a new PowerLowering struct.
+ *
+ * @return The created PowerLowering struct.
+ */
+struct PowerLowering* power_lowering_new(void);
+
+/**
+ * Frees a PowerLowering struct.
+ *
+ * @param p_self The current PowerLowering struct.
+ */
+void power_lowering_free(struct PowerLowering** p_self);
+
+/**
+ * Emits 'base ** exponent'. The result has the base's type, or the exponent's if only the
+ * exponent is a float. Integer results wrap around like multiplication, and negative integer
+ * exponents truncate towards zero (e.g. '2 ** -1' is 0). The exponent is never converted to the
+ * base's type, so a wider exponent is not truncated, and a negative one stays negative.
+ *
+ * @param p_self       The current PowerLowering struct.
+ * @param BASE         The primitive type of the base.
+ * @param p_base       The base, e.g. '%side'.
+ * @param EXPONENT     The primitive type of the exponent.
+ * @param p_exponent   The exponent, e.g. '%n'.
+ * @param p_constant   The value of the exponent if it is an integer constant, NULL otherwise.
+ * @param p_result     The name of the result, e.g. '%area'.
+ * @param p_function   Where to append the IR of the function being generated.
+ * @param p_module     Where to append helpers and intrinsic declarations, at module level.
+ */
+void power_lowering_emit(
+	struct PowerLowering* p_self,
+	const enum TypePrimitives BASE, // NOLINT(readability-avoid-const-params-in-decls)
+	const char*				  p_base,
+	const enum TypePrimitives EXPONENT, // NOLINT(readability-avoid-const-params-in-decls)
+	const char* p_exponent, const int64_t* p_constant, const char* p_result,
+	struct String* p_function, struct String* p_module);
@@ -0,0 +1,563 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./regions.h"
+#include "./attributes.h"
+#include "./coro.h"
+#include "./diagnostics.h"
+#include "../lexer/tokens.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REGIONS_LINE_LENGTH		 256U
+
+struct Regions* regions_new(const char* p_filePath, struct Interner* p_interner,
+							const struct TypeTable* p_types) {
+	struct Regions* lp_self = calloc(1, REGIONS_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Regions struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->interner = p_interner;
+	lp_self->types	  = p_types;
+
+	return lp_self;
+}
+
+void regions_free(struct Regions** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->depths);
+		free((*p_self)->declared);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Regions struct has already been freed");
+	}
+}
+
+/**
+ * Errors on a node of an '@arena' block.
+ *
+ * @param p_self    The current Regions struct.
+ * @param node      The node.
+ * @param p_message The error message.
+ */
+void regions___error(const struct Regions* p_self, flat_ast_index_t node, const char* p_message) {
+	compiler_error(p_self->filePath, flat_ast_get(p_self->ast, node)->line, C0012, p_message);
+}
+
+/**
+ * Checks whether values of a type may hold memory of an arena: strings, arrays, and anything that
+ * may contain them. Types that are not known count as such.
+ *
+ * @param p_self The current Regions struct.
+ * @param type   The type.
+ *
+ * @return Whether the values may hold memory of an arena.
+ */
+bool regions___may_allocate(const struct Regions* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return true;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+	const type_id_t*   lp_args = type_table_get_args(p_self->types, type);
+
+	switch (lp_type->kind) {
+	case TYPE_PRIMITIVE:
+		return lp_type->primitive == TYPE_PRIMITIVE_STR;
+	case TYPE_VECTOR:
+		return false;
+	case TYPE_TUPLE:
+	case TYPE_UNION:
+		for (uint32_t index = 0; index < lp_type->argCount; index++) {
+			if (regions___may_allocate(p_self, lp_args[index])) {
+				return true;
+			}
+		}
+
+		return false;
+	default: // Arrays, structs, closures, and types not known yet
+		return true;
+	}
+}
+
+/**
+ * Checks whether values of a type may keep other values that hold memory of an arena, e.g. an
+ * 'Array<str>' appended to. Strings copy what is appended to them, so they keep nothing.
+ *
+ * @param p_self The current Regions struct.
+ * @param type   The type.
+ *
+ * @return Whether the values may keep such values.
+ */
+bool regions___may_keep(const struct Regions* p_self, type_id_t type) {
+	if (type == TYPE_ID_NONE) {
+		return true;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+	const type_id_t*   lp_args = type_table_get_args(p_self->types, type);
+
+	switch (lp_type->kind) {
+	case TYPE_PRIMITIVE:
+	case TYPE_VECTOR:
+	case TYPE_FUNCTION:
+		return false;
+	case TYPE_NAMED:
+		if (lp_type->argCount == 1
+			&& strcmp(interner_get(p_self->types->interner, lp_type->name), "Array") == 0) {
+			return regions___may_allocate(p_self, lp_args[0]);
+		}
+
+		return true; // Structs, whose fields are not known here
+	case TYPE_TUPLE:
+	case TYPE_UNION:
+		for (uint32_t index = 0; index < lp_type->argCount; index++) {
+			if (regions___may_keep(p_self, lp_args[index])) {
+				return true;
+			}
+		}
+
+		return false;
+	default:
+		return true;
+	}
+}
+
+/**
+ * Gets the interned name of a node holding a local's name.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   The node.
+ *
+ * @return The interned name.
+ */
+intern_id_t regions___name(const struct Regions* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	const char*				  lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+
+	return interner_intern(p_self->interner, lp_name);
+}
+
+/**
+ * Declares a local in the current '@arena' block, unless it is already in scope.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   A node holding the local's name.
+ */
+void regions___declare(struct Regions* p_self, flat_ast_index_t node) {
+	intern_id_t name = regions___name(p_self, node);
+
+	p_self->depths =
+		buffer_grow(p_self->depths, &p_self->depthCapacity, (size_t)name + 1, sizeof(uint32_t));
+
+	if (p_self->depths[name]) {
+		return;
+	}
+
+	p_self->declared = buffer_grow(p_self->declared, &p_self->declaredCapacity,
+								   p_self->declaredCount + 1, sizeof(intern_id_t));
+	p_self->declared[p_self->declaredCount++] = name;
+	p_self->depths[name]					  = (uint32_t)p_self->depth + 1;
+}
+
+/**
+ * Gets the '@arena' blocks around the declaration of a local, 0 for names that are not locals.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   A node holding the local's name.
+ *
+ * @return The number of blocks.
+ */
+size_t regions___local_depth(const struct Regions* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	const char*				  lp_name = flat_ast_get_string(p_self->ast, lp_node->value.string);
+	intern_id_t				  name	  = interner_find(p_self->interner, lp_name);
+
+	return name != INTERN_ID_NONE && name < p_self->depthCapacity && p_self->depths[name]
+			   ? p_self->depths[name] - 1
+			   : 0;
+}
+
+/**
+ * Forgets the locals declared after some point, once their scope ends.
+ *
+ * @param p_self The current Regions struct.
+ * @param count  The number of locals declared before that point.
+ */
+void regions___forget(struct Regions* p_self, size_t count) {
+	while (p_self->declaredCount > count) {
+		p_self->depths[p_self->declared[--p_self->declaredCount]] = 0;
+	}
+}
+
+/**
+ * Gets the local a value is read from, following members, e.g. 'request' for 'request.lines'.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   The value's node.
+ *
+ * @return The local's node, FLATAST_INDEX_NONE if the value is not read from one.
+ */
+flat_ast_index_t regions___root(const struct Regions* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	while (lp_node->kind == FLATAST_MEMBER) {
+		node	= lp_node->lhs;
+		lp_node = flat_ast_get(p_self->ast, node);
+	}
+
+	if (lp_node->kind != FLATAST_VARIABLE && lp_node->kind != FLATAST_FIELD) {
+		return FLATAST_INDEX_NONE;
+	}
+
+	return node;
+}
+
+/**
+ * Gets the innermost '@arena' block whose memory a value may hold, by the number of blocks around
+ * it: the block its local was declared in, or the current block for values made by the node.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   The value's node (can be FLATAST_INDEX_NONE).
+ *
+ * @return The number of blocks, 0 if the value holds no arena memory.
+ */
+size_t regions___depth(const struct Regions* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE
+		|| !regions___may_allocate(p_self, inference_get_node_type(p_self->inference, node))) {
+		return 0;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_VARIABLE:
+		return regions___local_depth(p_self, node);
+	case FLATAST_MEMBER: // What is read from a value lives as long as the value
+		return regions___depth(p_self, lp_node->lhs);
+	case FLATAST_BINARY:
+		return lp_node->operation == LEXERTOKENS_SCOPE_RESOLUTION ? 0 : p_self->depth;
+	case FLATAST_INTEGER:
+	case FLATAST_FLOAT:
+	case FLATAST_CHR:
+	case FLATAST_TYPE:
+		return 0;
+	default: // Strings, calls, literals and closures are made in the current block
+		return p_self->depth;
+	}
+}
+
+/**
+ * Checks an assignment in an '@arena' block, and declares its target if it is a new local.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   The assignment's node.
+ */
+void regions___assign(struct Regions* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	= flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_target = flat_ast_get(p_self->ast, lp_node->lhs);
+	size_t					  value		= regions___depth(p_self, lp_node->rhs);
+	flat_ast_index_t		  root		= regions___root(p_self, lp_node->lhs);
+
+	if (lp_target->kind == FLATAST_VARIABLE || lp_target->kind == FLATAST_FIELD) {
+		regions___declare(p_self, lp_node->lhs); // Including typed declarations
+	}
+
+	if (p_self->depth == 0 || value == 0) {
+		return;
+	}
+
+	// 'lines += line' only keeps the value if the target can, e.g. not when appending to a string
+	if (lp_node->operation != LEXERTOKENS_ASSIGNMENT
+		&& !regions___may_keep(p_self, inference_get_node_type(p_self->inference, lp_node->lhs))) {
+		return;
+	}
+
+	p_self->checks++;
+
+	if (root == FLATAST_INDEX_NONE) {
+		regions___error(p_self, node,
+						"values allocated in an '@arena' block cannot be stored where they can "
+						"outlive it");
+	} else if (value > regions___local_depth(p_self, root)) {
+		const char* lp_name =
+			flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, root)->value.string);
+
+		regions___error(p_self, node,
+						CONCATENATE_STRING("values allocated in an '@arena' block cannot be ",
+										   root == lp_node->lhs ? "assigned to '" : "stored in '",
+										   lp_name, "', which outlives it"));
+	}
+}
+
+/**
+ * Takes an argument of a call into account: the deepest '@arena' block whose memory is passed, and
+ * the outermost local passed that could keep it.
+ *
+ * @param p_self        The current Regions struct.
+ * @param arg           The argument's node.
+ * @param p_keeper      The outermost local that could keep a value, FLATAST_INDEX_NONE if none.
+ * @param p_keeperDepth The '@arena' blocks around the keeper's declaration.
+ * @param p_deepest     The deepest block whose memory is passed.
+ */
+void regions___argument(const struct Regions* p_self, flat_ast_index_t arg,
+						flat_ast_index_t* p_keeper, size_t* p_keeperDepth, size_t* p_deepest) {
+	size_t			 depth = regions___depth(p_self, arg);
+	flat_ast_index_t root  = regions___root(p_self, arg);
+
+	*p_deepest = depth > *p_deepest ? depth : *p_deepest;
+
+	if (root != FLATAST_INDEX_NONE && depth < *p_keeperDepth
+		&& regions___may_keep(p_self, inference_get_node_type(p_self->inference, arg))) {
+		*p_keeper	   = root;
+		*p_keeperDepth = depth;
+	}
+}
+
+/**
+ * Checks a call in an '@arena' block. Its arguments, and the receiver of methods, must not include
+ * both a value allocated in the block and an outer value that could keep it.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   The call's node.
+ */
+void regions___call(struct Regions* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node	  = flat_ast_get(p_self->ast, node);
+	const struct FlatASTNode* lp_callee	  = flat_ast_get(p_self->ast, lp_node->lhs);
+	flat_ast_index_t		  keeper	  = FLATAST_INDEX_NONE;
+	size_t					  keeperDepth = p_self->depth;
+	size_t					  deepest	  = 0;
+
+	if (attributes_has(p_self->ast, node, ATTRIBUTE_AWAIT)) {
+		regions___error(p_self, node,
+						"'@await' cannot be used in '@arena' blocks, as the tasks run while it "
+						"waits would allocate from the block's arena");
+	}
+
+	if (lp_callee->kind == FLATAST_VARIABLE
+		&& strcmp(flat_ast_get_string(p_self->ast, lp_callee->value.string), CORO_YIELD_FUNCTION)
+			   == 0) {
+		regions___error(p_self, node,
+						"'" CORO_YIELD_FUNCTION "' cannot be called in '@arena' blocks, as the "
+						"generator's consumer would allocate from the block's arena");
+	}
+
+	if (lp_callee->kind == FLATAST_MEMBER) { // The receiver, e.g. 'lines' of 'lines.append(line)'
+		regions___argument(p_self, lp_callee->lhs, &keeper, &keeperDepth, &deepest);
+	}
+
+	for (size_t index = 0; index < lp_node->value.list.length; index++) {
+		regions___argument(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index), &keeper,
+						   &keeperDepth, &deepest);
+	}
+
+	if (keeper == FLATAST_INDEX_NONE || deepest <= keeperDepth) {
+		return;
+	}
+
+	p_self->checks++;
+
+	const char* lp_callName = "<expression>";
+
+	if (lp_callee->kind == FLATAST_VARIABLE || lp_callee->kind == FLATAST_MEMBER) {
+		lp_callName = flat_ast_get_string(p_self->ast, lp_callee->value.string);
+	}
+
+	const char* lp_keeperName =
+		flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, keeper)->value.string);
+	char message[REGIONS_LINE_LENGTH];
+
+	snprintf(message, sizeof(message),
+			 "values allocated in an '@arena' block cannot be passed to '%.64s' with '%.64s', "
+			 "which outlives the block and could keep them",
+			 lp_callName, lp_keeperName);
+	regions___error(p_self, node, message);
+}
+
+/**
+ * Declares the variables of a pattern of a match.
+ *
+ * @param p_self  The current Regions struct.
+ * @param pattern The pattern's node.
+ */
+void regions___bind(struct Regions* p_self, flat_ast_index_t pattern) {
+	const struct FlatASTNode* lp_pattern = flat_ast_get(p_self->ast, pattern);
+
+	if (lp_pattern->kind == FLATAST_VARIABLE
+		&& strcmp(flat_ast_get_string(p_self->ast, lp_pattern->value.string), "_") != 0) {
+		regions___declare(p_self, pattern);
+	} else if (lp_pattern->kind == FLATAST_STRUCT_LITERAL) {
+		for (size_t index = 0; index < lp_pattern->value.list.length; index++) {
+			flat_ast_index_t field = flat_ast_get_list_item(p_self->ast, lp_pattern, index);
+
+			regions___bind(p_self, flat_ast_get(p_self->ast, field)->lhs);
+		}
+	}
+}
+
+/**
+ * Walks a node of the current function, in order, declaring its locals and checking the nodes of
+ * '@arena' blocks.
+ *
+ * @param p_self The current Regions struct.
+ * @param node   The node (can be FLATAST_INDEX_NONE).
+ */
+void regions___walk(struct Regions* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+	size_t					  scope	  = p_self->declaredCount;
+
+	switch (lp_node->kind) {
+	case FLATAST_ASSIGNMENT:
+		regions___walk(p_self, lp_node->rhs);
+		regions___walk(p_self, lp_node->lhs);
+		regions___assign(p_self, node);
+		return;
+	case FLATAST_RETURN:
+		regions___walk(p_self, lp_node->lhs);
+
+		if (p_self->depth > 0 && regions___depth(p_self, lp_node->lhs) > 0) {
+			p_self->checks++;
+			regions___error(p_self, node,
+							"values allocated in an '@arena' block cannot be returned from it");
+		}
+		return;
+	case FLATAST_CALL:
+		if (p_self->depth > 0) {
+			regions___call(p_self, node);
+		}
+		break;
+	case FLATAST_PARAMETER:
+		regions___declare(p_self, node);
+		return;
+	case FLATAST_FOR: // The bindings are elements of the iterable, declared by the loop
+		regions___walk(p_self, lp_node->lhs);
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			regions___declare(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+
+		regions___walk(p_self, lp_node->rhs);
+		return;
+	case FLATAST_MATCH:
+		regions___walk(p_self, lp_node->lhs);
+
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			const struct FlatASTNode* lp_case =
+				flat_ast_get(p_self->ast, flat_ast_get_list_item(p_self->ast, lp_node, index));
+
+			regions___bind(p_self, lp_case->lhs);
+			regions___walk(p_self, lp_case->rhs);
+		}
+		return;
+	case FLATAST_FUNCTION: // Its parameters are declared before its body
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			regions___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+
+		regions___walk(p_self, lp_node->rhs);
+		regions___forget(p_self, scope);
+		return;
+	case FLATAST_BLOCK: // Locals live until the end of their function, or of their '@arena' block
+		if (attributes_has(p_self->ast, node, ATTRIBUTE_ARENA)) {
+			p_self->depth++;
+			p_self->blocks++;
+
+			for (size_t index = 0; index < lp_node->value.list.length; index++) {
+				regions___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+			}
+
+			regions___forget(p_self, scope);
+			p_self->depth--;
+			return;
+		}
+		break;
+	case FLATAST_TYPE:
+		return;
+	default:
+		break;
+	}
+
+	regions___walk(p_self, lp_node->lhs);
+	regions___walk(p_self, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			regions___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+bool regions_analyse(struct Regions* p_self, const struct FlatAST* p_ast,
+					 const struct Inference* p_inference, flat_ast_index_t function) {
+	size_t blocks = p_self->blocks;
+
+	p_self->ast		  = p_ast;
+	p_self->inference = p_inference;
+	p_self->depth	  = 0;
+
+	regions___forget(p_self, 0);
+	regions___walk(p_self, function);
+	regions___forget(p_self, 0);
+
+	return p_self->blocks > blocks;
+}
+
+void regions_emit_enter(const struct Regions* p_self, flat_ast_index_t block,
+						struct String* p_entry, struct String* p_output) {
+	if (!attributes_has(p_self->ast, block, ATTRIBUTE_ARENA)) {
+		PANIC("Regions can only emit '@arena' blocks");
+	}
+
+	char line[REGIONS_LINE_LENGTH];
+
+	// %arena.N = alloca %mem.arena
+	snprintf(line, sizeof(line), "  %%arena.%u = alloca %s\n", block, REGIONS_ARENA_TYPE);
+	string_append_str(p_entry, line);
+
+	// call void @mem_SEP_Arena___init__(%mem.arena* %arena.N)
+	// call void @mem_SEP_Arena_SEP_enter(%mem.arena* %arena.N)
+	snprintf(line, sizeof(line),
+			 "  call void @mem_SEP_Arena___init__(%s* %%arena.%u)\n"
+			 "  call void @mem_SEP_Arena_SEP_enter(%s* %%arena.%u)\n",
+			 REGIONS_ARENA_TYPE, block, REGIONS_ARENA_TYPE, block);
+	string_append_str(p_output, line);
+}
+
+void regions_emit_leave(const struct Regions* p_self, flat_ast_index_t block,
+						struct String* p_output) {
+	if (!attributes_has(p_self->ast, block, ATTRIBUTE_ARENA)) {
+		PANIC("Regions can only emit '@arena' blocks");
+	}
+
+	char line[REGIONS_LINE_LENGTH];
+
+	// call void @mem_SEP_Arena_SEP_leave(%mem.arena* %arena.N)
+	// call void @mem_SEP_Arena___del__(%mem.arena* %arena.N)
+	snprintf(line, sizeof(line),
+			 "  call void @mem_SEP_Arena_SEP_leave(%s* %%arena.%u)\n"
+			 "  call void @mem_SEP_Arena___del__(%s* %%arena.%u)\n",
+			 REGIONS_ARENA_TYPE, block, REGIONS_ARENA_TYPE, block);
+	string_append_str(p_output, line);
+}
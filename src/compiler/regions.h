@@ -0,0 +1,101 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define REGIONS_ARENA_TYPE "%mem.arena" // The runtime's 'mem::Arena', as an LLVM type.
+
+/**
+ * Represents the checking and lowering of '@arena' blocks. Each one gets an arena of the runtime
+ * ('mem' in std.ll), entered as the thread's default allocator for the block's duration: the arrays
+ * and strings initialised meanwhile, including by the functions it calls, allocate from it with a
+ * bump of a pointer, and they are all released at once when the block is left.
+ *
+ * As nothing allocated in the block may be used once it is left, values that may hold its memory
+ * cannot be returned, assigned to locals declared outside the block, stored in them, or passed to a
+ * call together with an outer value that could keep them. The check is lexical and conservative,
+ * e.g. a local assigned an outer array inside the block counts as allocated in it.
+ */
+struct Regions {
+	const char*				filePath; // For diagnostics.
+	struct Interner*		interner;
+	const struct TypeTable* types;
+	const struct FlatAST*	ast;	   // The AST of the current function.
+	const struct Inference* inference; // The inference of the current function.
+	uint32_t*				depths;	   // '@arena' blocks around each local in scope, + 1, by name.
+	intern_id_t*			declared;  // The locals in scope, in the order they were declared.
+	size_t					depthCapacity, declaredCount, declaredCapacity;
+	size_t					depth;			// '@arena' blocks around the current node.
+	size_t					blocks, checks; // For the time report.
+};
+
+#define REGIONS_STRUCT_SIZE sizeof(struct Regions)
+
+/**
+ * Creates a new Regions struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_interner The module's interner.
+ * @param p_types    The module's type table.
+ *
+ * @return The created Regions struct.
+ */
+struct Regions* regions_new(const char* p_filePath, struct Interner* p_interner,
+							const struct TypeTable* p_types);
+
+/**
+ * Frees a Regions struct.
+ *
+ * @param p_self The current Regions struct.
+ */
+void regions_free(struct Regions** p_self);
+
+/**
+ * Checks the '@arena' blocks of the last inferred function. Errors if a value that may hold the
+ * memory of one can outlive it, or if one suspends its function with '@await' or 'yield', which
+ * would leave other code allocating from its arena.
+ *
+ * @param p_self      The current Regions struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param function    The function's node.
+ *
+ * @return Whether the function has '@arena' blocks.
+ */
+bool regions_analyse(struct Regions* p_self, const struct FlatAST* p_ast,
+					 const struct Inference* p_inference, flat_ast_index_t function);
+
+/**
+ * Emits the start of an '@arena' block: its arena, in the entry block, is initialised and entered.
+ * The block must be one of the last analysed function.
+ *
+ * @param p_self   The current Regions struct.
+ * @param block    The block's node.
+ * @param p_entry  Where to append the entry block's allocas.
+ * @param p_output Where to append the IR of the current block.
+ */
+void regions_emit_enter(const struct Regions* p_self, flat_ast_index_t block,
+						struct String* p_entry, struct String* p_output);
+
+/**
+ * Emits leaving an '@arena' block, which releases everything allocated in it. It must be emitted
+ * at the end of the block, and before every 'return' inside it, innermost blocks first. The block
+ * must be one of the last analysed function.
+ *
+ * @param p_self   The current Regions struct.
+ * @param block    The block's node.
+ * @param p_output Where to append the IR of the current block.
+ */
+void regions_emit_leave(const struct Regions* p_self, flat_ast_index_t block,
+						struct String* p_output);
@@ -0,0 +1,151 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./report.h"
+#include "../utils/array.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// X-Macro to define report kind names
+static char* const g_REPORT_KIND_NAMES_INTERNAL[] = {
+#define REPORT_KIND_TO_STRING(name, string) string,
+	REPORT_KINDS(REPORT_KIND_TO_STRING)
+#undef REPORT_KIND_TO_STRING
+};
+
+const struct Array g_REPORT_KIND_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_REPORT_KIND_NAMES_INTERNAL,
+						sizeof(g_REPORT_KIND_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* report_kind_get_name(const enum ReportKinds KIND) {
+	if ((size_t)KIND + 1 > g_REPORT_KIND_NAMES.length) {
+		PANIC("g_REPORT_KIND_NAMES get index out of bounds");
+	}
+
+	return g_REPORT_KIND_NAMES._values[KIND];
+}
+
+/**
+ * Stringifies a report kind name, for array_join.
+ *
+ * @param p_name The name.
+ *
+ * @return The name.
+ */
+char* report___stringify_name(const void* p_name) {
+	return (char*)p_name;
+}
+
+struct Report* report_new(const char* p_kinds) {
+	struct Report* lp_self = malloc(REPORT_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Report struct");
+	}
+
+	lp_self->enabled = 0;
+	lp_self->output	 = string_new("\0", true);
+
+	const char* lp_kind = p_kinds;
+
+	while (lp_kind && *lp_kind) {
+		const char* lp_end = strchr(lp_kind, ',');
+		size_t		length = lp_end ? (size_t)(lp_end - lp_kind) : strlen_safe(lp_kind);
+		bool		found  = false;
+
+		for (size_t kind = 0; kind < g_REPORT_KIND_NAMES.length; kind++) {
+			const char* lp_name = g_REPORT_KIND_NAMES._values[kind];
+
+			if (strlen_safe(lp_name) == length && strncmp(lp_name, lp_kind, length) == 0) {
+				lp_self->enabled |= 1U << kind;
+				found = true;
+				break;
+			}
+		}
+
+		if (!found && length > 0) {
+			char* lp_names = array_join((struct Array*)&g_REPORT_KIND_NAMES, ", ",
+										report___stringify_name);
+
+			error(CONCATENATE_STRING("unknown report kind (expected one of: ", lp_names, ")"));
+		}
+
+		lp_kind = lp_end ? lp_end + 1 : NULL;
+	}
+
+	return lp_self;
+}
+
+void report_free(struct Report** p_self) {
+	if (p_self && *p_self) {
+		string_free(&(*p_self)->output);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Report struct has already been freed");
+	}
+}
+
+bool report_enabled(const struct Report* p_self, const enum ReportKinds KIND) {
+	return p_self && (p_self->enabled & (1U << KIND));
+}
+
+void report_add(struct Report* p_self, const enum ReportKinds KIND, const char* p_line) {
+	if (!report_enabled(p_self, KIND)) {
+		return;
+	}
+
+	string_append_str(p_self->output, report_kind_get_name(KIND));
+	string_append_str(p_self->output, ": ");
+	string_append_str(p_self->output, p_line);
+	string_append_chr(p_self->output, '\n');
+}
+
+void report_replay(struct Report* p_self, const char* p_lines) {
+	const char* lp_line = p_lines;
+
+	while (p_self && lp_line && *lp_line) {
+		const char* lp_end	 = strchr(lp_line, '\n');
+		size_t		length	 = lp_end ? (size_t)(lp_end - lp_line) + 1 : strlen_safe(lp_line);
+		const char* lp_colon = memchr(lp_line, ':', length);
+
+		for (size_t kind = 0; lp_colon && kind < g_REPORT_KIND_NAMES.length; kind++) {
+			const char* lp_name = g_REPORT_KIND_NAMES._values[kind];
+
+			if (strlen_safe(lp_name) == (size_t)(lp_colon - lp_line)
+				&& strncmp(lp_name, lp_line, (size_t)(lp_colon - lp_line)) == 0) {
+				if (report_enabled(p_self, (enum ReportKinds)kind)) {
+					string_append_bytes(p_self->output, lp_line, length);
+				}
+
+				break;
+			}
+		}
+
+		lp_line += length;
+	}
+}
+
+void report_print(const struct Report* p_self) {
+	if (p_self->output->length > 0) {
+		fputs(p_self->output->_value, stdout);
+	}
+}
+
+uint64_t report_clock(void) {
+#ifdef _WIN32
+	return (uint64_t)clock() * (1000000000U / CLOCKS_PER_SEC);
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+#endif
+}
@@ -0,0 +1,109 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// X-Macro to define the kinds of reports that can be requested with '--report'
+#define REPORT_KINDS(X)                                                                            \
+	X(TIME, "time")		/* Time spent per module, and inference cost per function */               \
+	X(DEVIRT, "devirt") /* Method call sites that stayed dynamically dispatched */                 \
+	X(ESCAPE, "escape") /* Struct literals allocated on the heap, and why */                       \
+	X(LAYOUT, "layout") /* Size, field offsets and padding of every struct */                      \
+	X(COPIES, "copies") /* Deep copies of strings and arrays that remain, and why */
+
+/**
+ * Used to identify the kinds of reports.
+ */
+enum ReportKinds {
+#define REPORT_KIND_ENUM_ENTRY(name, string) REPORT_##name,
+	REPORT_KINDS(REPORT_KIND_ENUM_ENTRY)
+#undef REPORT_KIND_ENUM_ENTRY
+};
+
+/**
+ * Represents the reports requested by the user. Lines are collected while compiling and printed
+ * once compiling has finished, so reports never interleave with diagnostics.
+ */
+struct Report {
+	uint32_t	   enabled; // Bitset of enabled report kinds.
+	struct String* output;
+};
+
+#define REPORT_STRUCT_SIZE sizeof(struct Report)
+
+/**
+ * Gets the name of a report kind.
+ *
+ * @param KIND The report kind.
+ *
+ * @return The name of the report kind.
+ */
+const char* report_kind_get_name(
+	const enum ReportKinds KIND); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Creates a new Report struct.
+ *
+ * @param p_kinds The comma separated report kinds to enable, e.g. 'time,devirt' (can be empty).
+ *
+ * @return The created Report struct.
+ */
+struct Report* report_new(const char* p_kinds);
+
+/**
+ * Frees a Report struct.
+ *
+ * @param p_self The current Report struct.
+ */
+void report_free(struct Report** p_self);
+
+/**
+ * Checks whether a report kind is enabled.
+ *
+ * @param p_self The current Report struct (can be NULL).
+ * @param KIND   The report kind.
+ *
+ * @return Whether the report kind is enabled.
+ */
+bool report_enabled(const struct Report* p_self,
+					const enum ReportKinds KIND); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Adds a line to a report, if its kind is enabled.
+ *
+ * @param p_self The current Report struct (can be NULL).
+ * @param KIND   The report kind.
+ * @param p_line The line to add.
+ */
+void report_add(struct Report*			p_self,
+				const enum ReportKinds KIND, // NOLINT(readability-avoid-const-params-in-decls)
+				const char*			p_line);
+
+/**
+ * Adds the lines collected by another report, e.g. one stored in the cache, keeping those whose
+ * kind is enabled.
+ *
+ * @param p_self  The current Report struct (can be NULL).
+ * @param p_lines The lines, each prefixed with its kind as report_add writes them.
+ */
+void report_replay(struct Report* p_self, const char* p_lines);
+
+/**
+ * Prints the collected reports.
+ *
+ * @param p_self The current Report struct.
+ */
+void report_print(const struct Report* p_self);
+
+/**
+ * Gets a monotonic timestamp, for timing compiler phases.
+ *
+ * @return The timestamp in nanoseconds.
+ */
+uint64_t report_clock(void);
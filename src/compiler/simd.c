@@ -0,0 +1,774 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./simd.h"
+#include "./diagnostics.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIMD_TEMPORARY_LENGTH	32U
+#define SIMD_NAME_LENGTH		64U
+#define SIMD_SUFFIX_LENGTH		16U
+#define SIMD_LINE_LENGTH		512U
+#define SIMD_INITIAL_CAPACITY	8U
+#define SIMD_FEATURE_SEPARATORS ","
+
+// X-Macro to define reduction method names
+static char* const g_SIMD_REDUCTION_NAMES_INTERNAL[] = {
+#define SIMD_REDUCTION_TO_STRING(name, string) string,
+	SIMD_REDUCTIONS(SIMD_REDUCTION_TO_STRING)
+#undef SIMD_REDUCTION_TO_STRING
+};
+
+const struct Array g_SIMD_REDUCTION_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_SIMD_REDUCTION_NAMES_INTERNAL,
+						sizeof(g_SIMD_REDUCTION_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+// X-Macros to define the target features' names and widths
+static const char* const g_SIMD_FEATURE_NAMES[] = {
+#define SIMD_FEATURE_TO_NAME(name, width) name,
+	SIMD_FEATURES(SIMD_FEATURE_TO_NAME)
+#undef SIMD_FEATURE_TO_NAME
+};
+
+static const uint32_t g_SIMD_FEATURE_WIDTHS[] = {
+#define SIMD_FEATURE_TO_WIDTH(name, width) width,
+	SIMD_FEATURES(SIMD_FEATURE_TO_WIDTH)
+#undef SIMD_FEATURE_TO_WIDTH
+};
+
+const char* simd_reduction_get_name(const enum SimdReductions REDUCTION) {
+	if ((size_t)REDUCTION + 1 > g_SIMD_REDUCTION_NAMES.length) {
+		PANIC("g_SIMD_REDUCTION_NAMES get index out of bounds");
+	}
+
+	return g_SIMD_REDUCTION_NAMES._values[REDUCTION];
+}
+
+struct SimdLowering* simd_lowering_new(const char* p_filePath, const struct TypeTable* p_types,
+									   const char* p_targetFeatures) {
+	struct SimdLowering* lp_self = calloc(1, SIMDLOWERING_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc SimdLowering struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->types	  = p_types;
+	lp_self->width	  = SIMD_DEFAULT_WIDTH;
+
+	// e.g. '+avx2,+fma', features turned off with '-' are ignored
+	for (const char* lp_feature = p_targetFeatures; lp_feature && *lp_feature;) {
+		size_t length = strcspn(lp_feature, SIMD_FEATURE_SEPARATORS);
+
+		if (*lp_feature != '-') {
+			const char* lp_name	   = lp_feature + (*lp_feature == '+');
+			size_t		nameLength = length - (size_t)(lp_name - lp_feature);
+
+			for (size_t index = 0; index < sizeof(g_SIMD_FEATURE_WIDTHS) / sizeof(uint32_t);
+				 index++) {
+				if (strlen(g_SIMD_FEATURE_NAMES[index]) == nameLength
+					&& strncmp(lp_name, g_SIMD_FEATURE_NAMES[index], nameLength) == 0
+					&& g_SIMD_FEATURE_WIDTHS[index] > lp_self->width) {
+					lp_self->width = g_SIMD_FEATURE_WIDTHS[index];
+				}
+			}
+		}
+
+		lp_feature += length + (lp_feature[length] != '\0');
+	}
+
+	return lp_self;
+}
+
+void simd_lowering_free(struct SimdLowering** p_self) {
+	if (p_self && *p_self) {
+		for (size_t index = 0; index < (*p_self)->declarationCount; index++) {
+			free((*p_self)->declarations[index]);
+		}
+
+		free((*p_self)->declarations);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("SimdLowering struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether a primitive is a float.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return Whether the primitive is a float.
+ */
+bool simd___is_float(const enum TypePrimitives PRIMITIVE) {
+	return PRIMITIVE == TYPE_PRIMITIVE_F32 || PRIMITIVE == TYPE_PRIMITIVE_F64;
+}
+
+/**
+ * Checks whether a primitive is a signed integer.
+ *
+ * @param PRIMITIVE The primitive.
+ *
+ * @return Whether the primitive is a signed integer.
+ */
+bool simd___is_signed(const enum TypePrimitives PRIMITIVE) {
+	return PRIMITIVE >= TYPE_PRIMITIVE_I8 && PRIMITIVE <= TYPE_PRIMITIVE_I64;
+}
+
+/**
+ * Gets the width of a lane.
+ *
+ * @param PRIMITIVE The primitive type of the lane.
+ *
+ * @return The width in bits, 1 for masks.
+ */
+uint32_t simd___bits(const enum TypePrimitives PRIMITIVE) {
+	switch (PRIMITIVE) {
+	case TYPE_PRIMITIVE_BOOL:
+		return 1;
+	case TYPE_PRIMITIVE_I8:
+	case TYPE_PRIMITIVE_U8:
+		return 8;
+	case TYPE_PRIMITIVE_I16:
+	case TYPE_PRIMITIVE_U16:
+		return 16;
+	case TYPE_PRIMITIVE_I32:
+	case TYPE_PRIMITIVE_U32:
+	case TYPE_PRIMITIVE_F32:
+		return 32;
+	case TYPE_PRIMITIVE_I64:
+	case TYPE_PRIMITIVE_U64:
+	case TYPE_PRIMITIVE_F64:
+		return 64;
+	default:
+		PANIC("unsupported primitive for a vector lane");
+	}
+}
+
+/**
+ * Gets the LLVM type of a lane.
+ *
+ * @param PRIMITIVE The primitive type of the lane.
+ *
+ * @return The LLVM type, e.g. 'float'.
+ */
+const char* simd___llvm_lane(const enum TypePrimitives PRIMITIVE) {
+	if (simd___is_float(PRIMITIVE)) {
+		return PRIMITIVE == TYPE_PRIMITIVE_F32 ? "float" : "double";
+	}
+
+	switch (simd___bits(PRIMITIVE)) {
+	case 1:
+		return "i1";
+	case 8:
+		return "i8";
+	case 16:
+		return "i16";
+	case 32:
+		return "i32";
+	default:
+		return "i64";
+	}
+}
+
+/**
+ * Gets a vector type, checking it is one.
+ *
+ * @param p_self The current SimdLowering struct.
+ * @param type   The type.
+ *
+ * @return The vector type.
+ */
+const struct Type* simd___vector(const struct SimdLowering* p_self, type_id_t type) {
+	const struct Type* lp_type = type_table_get(p_self->types, type);
+
+	if (lp_type->kind != TYPE_VECTOR) {
+		PANIC("SimdLowering type is not a vector");
+	}
+
+	return lp_type;
+}
+
+/**
+ * Writes the suffix of the intrinsics of a vector type, e.g. 'v8f32'.
+ *
+ * @param p_vector The vector type.
+ * @param p_suffix Where to write the suffix (SIMD_SUFFIX_LENGTH characters).
+ */
+void simd___suffix(const struct Type* p_vector, char* p_suffix) {
+	snprintf(p_suffix, SIMD_SUFFIX_LENGTH, "v%" PRIu32 "%c%" PRIu32, p_vector->name,
+			 simd___is_float(p_vector->primitive) ? 'f' : 'i', simd___bits(p_vector->primitive));
+}
+
+/**
+ * Creates the name of a new temporary.
+ *
+ * @param p_self      The current SimdLowering struct.
+ * @param p_temporary Where to write the name (SIMD_TEMPORARY_LENGTH characters).
+ */
+void simd___temporary(struct SimdLowering* p_self, char* p_temporary) {
+	snprintf(p_temporary, SIMD_TEMPORARY_LENGTH, "%%simd.%zu", p_self->temporaries++);
+}
+
+/**
+ * Declares an intrinsic, once per module.
+ *
+ * @param p_self        The current SimdLowering struct.
+ * @param p_name        The intrinsic's name, without the '@'.
+ * @param p_declaration The intrinsic's declaration.
+ * @param p_module      Where to append the declaration, at module level.
+ */
+void simd___declare(struct SimdLowering* p_self, const char* p_name, const char* p_declaration,
+					struct String* p_module) {
+	for (size_t index = 0; index < p_self->declarationCount; index++) {
+		if (strcmp(p_self->declarations[index], p_name) == 0) {
+			return;
+		}
+	}
+
+	if (p_self->declarationCount == p_self->declarationCapacity) {
+		size_t capacity =
+			p_self->declarationCapacity ? p_self->declarationCapacity * 2 : SIMD_INITIAL_CAPACITY;
+		char** lp_declarationsTemp = realloc(p_self->declarations, capacity * sizeof(char*));
+
+		if (!lp_declarationsTemp) {
+			PANIC("failed to realloc SimdLowering declarations");
+		}
+
+		p_self->declarations		= lp_declarationsTemp;
+		p_self->declarationCapacity = capacity;
+	}
+
+	size_t length  = strlen(p_name) + 1;
+	char*  lp_name = malloc(length);
+
+	if (!lp_name) {
+		PANIC("failed to malloc SimdLowering declaration");
+	}
+
+	memcpy(lp_name, p_name, length);
+	p_self->declarations[p_self->declarationCount++] = lp_name;
+
+	string_append_str(p_module, p_declaration);
+}
+
+/**
+ * Checks a vector fits the target's registers, erroring if it does not.
+ *
+ * @param p_self The current SimdLowering struct.
+ * @param type   The vector type.
+ * @param line   The line it is used on, for diagnostics.
+ */
+void simd___check(struct SimdLowering* p_self, type_id_t type, uint32_t line) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	uint32_t		   bits		 = simd___bits(lp_vector->primitive) * lp_vector->name;
+
+	p_self->vectors++;
+
+	if (bits <= p_self->width) {
+		return;
+	}
+
+	char* lp_type  = type_table_to_string(p_self->types, type);
+	char* lp_bits  = ul_to_string(bits);
+	char* lp_width = ul_to_string(p_self->width);
+
+	compiler_error(p_self->filePath, line, C0009,
+				   CONCATENATE_STRING("'", lp_type, "' is ", lp_bits,
+									  " bits wide, but the target's vectors are at most ",
+									  lp_width, " bits (see '--target-features')"));
+}
+
+/**
+ * Walks a node of a function's body, checking the vectors it uses. Nested functions are analysed
+ * on their own.
+ *
+ * @param p_self      The current SimdLowering struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was inferred with.
+ * @param node        The node.
+ */
+void simd___walk(struct SimdLowering* p_self, const struct FlatAST* p_ast,
+				 const struct Inference* p_inference, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_ast, node);
+	type_id_t				  type	  = inference_get_node_type(p_inference, node);
+
+	if (lp_node->kind == FLATAST_FUNCTION || lp_node->kind == FLATAST_TYPE) {
+		return;
+	}
+
+	if (type != TYPE_ID_NONE && type_table_get(p_self->types, type)->kind == TYPE_VECTOR) {
+		simd___check(p_self, type, lp_node->line);
+	}
+
+	simd___walk(p_self, p_ast, p_inference, lp_node->lhs);
+	simd___walk(p_self, p_ast, p_inference, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_FOR:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			simd___walk(p_self, p_ast, p_inference, flat_ast_get_list_item(p_ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void simd_lowering_analyse(struct SimdLowering* p_self, const struct FlatAST* p_ast,
+						   const struct Inference* p_inference, flat_ast_index_t function) {
+	const struct FlatASTNode* lp_function = flat_ast_get(p_ast, function);
+	type_id_t				  type		  = inference_get_node_type(p_inference, function);
+
+	// The parameters and the result, which the body may never mention
+	if (type != TYPE_ID_NONE && type_table_get(p_self->types, type)->kind == TYPE_FUNCTION) {
+		uint32_t argCount = type_table_get(p_self->types, type)->argCount;
+
+		for (uint32_t index = 0; index < argCount; index++) {
+			type_id_t arg = type_table_get_args(p_self->types, type)[index];
+
+			if (type_table_get(p_self->types, arg)->kind == TYPE_VECTOR) {
+				simd___check(p_self, arg, lp_function->line);
+			}
+		}
+	}
+
+	simd___walk(p_self, p_ast, p_inference, lp_function->rhs);
+}
+
+void simd_lowering_llvm_type(const struct TypeTable* p_types, type_id_t type, char* p_llvmType) {
+	const struct Type* lp_vector = type_table_get(p_types, type);
+
+	if (lp_vector->kind != TYPE_VECTOR) {
+		PANIC("SimdLowering type is not a vector");
+	}
+
+	snprintf(p_llvmType, SIMD_TYPE_LENGTH, "<%" PRIu32 " x %s>", lp_vector->name,
+			 simd___llvm_lane(lp_vector->primitive));
+}
+
+void simd_lowering_emit_binary(struct SimdLowering* p_self, type_id_t type,
+							   const enum LexerTokenIdentifiers OPERATION, const char* p_lhs,
+							   const char* p_rhs, const char* p_result, struct String* p_function) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	bool			   isFloat	 = simd___is_float(lp_vector->primitive);
+	bool			   isSigned	 = simd___is_signed(lp_vector->primitive);
+	const char*		   lp_instruction = NULL;
+
+	switch (OPERATION) {
+	case LEXERTOKENS_ADDITION:
+		lp_instruction = isFloat ? "fadd" : "add";
+		break;
+	case LEXERTOKENS_SUBTRACTION:
+		lp_instruction = isFloat ? "fsub" : "sub";
+		break;
+	case LEXERTOKENS_MULTIPLICATION:
+		lp_instruction = isFloat ? "fmul" : "mul";
+		break;
+	case LEXERTOKENS_DIVISION:
+		lp_instruction = isFloat ? "fdiv" : isSigned ? "sdiv" : "udiv";
+		break;
+	case LEXERTOKENS_MODULO:
+		lp_instruction = isFloat ? "frem" : isSigned ? "srem" : "urem";
+		break;
+	case LEXERTOKENS_BITWISE_AND:
+		lp_instruction = isFloat ? NULL : "and";
+		break;
+	case LEXERTOKENS_BITWISE_OR:
+		lp_instruction = isFloat ? NULL : "or";
+		break;
+	case LEXERTOKENS_BITWISE_XOR:
+		lp_instruction = isFloat ? NULL : "xor";
+		break;
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+		lp_instruction = isFloat ? NULL : "shl";
+		break;
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+		lp_instruction = isFloat ? NULL : isSigned ? "ashr" : "lshr";
+		break;
+	default:
+		break;
+	}
+
+	if (!lp_instruction) {
+		PANIC("unsupported operator for a vector");
+	}
+
+	char llvmType[SIMD_TYPE_LENGTH];
+	char line[SIMD_LINE_LENGTH];
+
+	// %result = OP <N x T> %lhs, %rhs
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	snprintf(line, sizeof(line), "  %s = %s %s %s, %s\n", p_result, lp_instruction, llvmType, p_lhs,
+			 p_rhs);
+	string_append_str(p_function, line);
+	p_self->operations++;
+}
+
+void simd_lowering_emit_compare(struct SimdLowering* p_self, type_id_t type,
+								const enum LexerTokenIdentifiers OPERATION, const char* p_lhs,
+								const char* p_rhs, const char* p_result,
+								struct String* p_function) {
+	const struct Type* lp_vector	= simd___vector(p_self, type);
+	bool			   isFloat		= simd___is_float(lp_vector->primitive);
+	bool			   isSigned		= simd___is_signed(lp_vector->primitive);
+	const char*		   lp_predicate = NULL;
+
+	switch (OPERATION) { // Float comparisons are ordered, except '!=' which holds for NaN
+	case LEXERTOKENS_EQUAL_TO:
+		lp_predicate = isFloat ? "oeq" : "eq";
+		break;
+	case LEXERTOKENS_NOT_EQUAL_TO:
+		lp_predicate = isFloat ? "une" : "ne";
+		break;
+	case LEXERTOKENS_GREATER_THAN:
+		lp_predicate = isFloat ? "ogt" : isSigned ? "sgt" : "ugt";
+		break;
+	case LEXERTOKENS_LESS_THAN:
+		lp_predicate = isFloat ? "olt" : isSigned ? "slt" : "ult";
+		break;
+	case LEXERTOKENS_GREATER_THAN_OR_EQUAL:
+		lp_predicate = isFloat ? "oge" : isSigned ? "sge" : "uge";
+		break;
+	case LEXERTOKENS_LESS_THAN_OR_EQUAL:
+		lp_predicate = isFloat ? "ole" : isSigned ? "sle" : "ule";
+		break;
+	default:
+		PANIC("unsupported comparison for a vector");
+	}
+
+	char llvmType[SIMD_TYPE_LENGTH];
+	char line[SIMD_LINE_LENGTH];
+
+	// %result = fcmp|icmp PREDICATE <N x T> %lhs, %rhs
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	snprintf(line, sizeof(line), "  %s = %s %s %s %s, %s\n", p_result, isFloat ? "fcmp" : "icmp",
+			 lp_predicate, llvmType, p_lhs, p_rhs);
+	string_append_str(p_function, line);
+	p_self->operations++;
+}
+
+void simd_lowering_emit_splat(struct SimdLowering* p_self, type_id_t type, const char* p_scalar,
+							  const char* p_result, struct String* p_function) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	char			   llvmType[SIMD_TYPE_LENGTH];
+	char			   temporary[SIMD_TEMPORARY_LENGTH];
+	char			   line[SIMD_LINE_LENGTH];
+
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	simd___temporary(p_self, temporary);
+
+	// %simd.n = insertelement <N x T> undef, T %scalar, i32 0
+	// %result = shufflevector <N x T> %simd.n, <N x T> undef, <N x i32> zeroinitializer
+	snprintf(line, sizeof(line),
+			 "  %s = insertelement %s undef, %s %s, i32 0\n  %s = shufflevector %s %s, %s undef, "
+			 "<%" PRIu32 " x i32> zeroinitializer\n",
+			 temporary, llvmType, simd___llvm_lane(lp_vector->primitive), p_scalar, p_result,
+			 llvmType, temporary, llvmType, lp_vector->name);
+	string_append_str(p_function, line);
+	p_self->operations++;
+}
+
+void simd_lowering_emit_shuffle(struct SimdLowering* p_self, type_id_t type, const char* p_lhs,
+								const char* p_rhs, const uint32_t* p_lanes, uint32_t laneCount,
+								const char* p_result, struct String* p_function) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	char			   llvmType[SIMD_TYPE_LENGTH];
+	char			   line[SIMD_LINE_LENGTH];
+
+	if (laneCount == 0 || laneCount > TYPE_VECTOR_MAX_LANES || (laneCount & (laneCount - 1))) {
+		PANIC("unsupported number of lanes for a shuffle");
+	}
+
+	// %result = shufflevector <N x T> %lhs, <N x T> %rhs, <M x i32> <i32 a, i32 b, ...>
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	snprintf(line, sizeof(line), "  %s = shufflevector %s %s, %s %s, <%" PRIu32 " x i32> <",
+			 p_result, llvmType, p_lhs, llvmType, p_rhs ? p_rhs : "undef", laneCount);
+	string_append_str(p_function, line);
+
+	for (uint32_t index = 0; index < laneCount; index++) {
+		if (p_lanes[index] >= 2 * lp_vector->name) {
+			PANIC("shuffle lane out of bounds");
+		}
+
+		snprintf(line, sizeof(line), "%si32 %" PRIu32, index ? ", " : "", p_lanes[index]);
+		string_append_str(p_function, line);
+	}
+
+	string_append_str(p_function, ">\n");
+	p_self->operations++;
+}
+
+void simd_lowering_emit_select(struct SimdLowering* p_self, type_id_t type, const char* p_mask,
+							   const char* p_lhs, const char* p_rhs, const char* p_result,
+							   struct String* p_function) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	char			   llvmType[SIMD_TYPE_LENGTH];
+	char			   line[SIMD_LINE_LENGTH];
+
+	// %result = select <N x i1> %mask, <N x T> %lhs, <N x T> %rhs
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	snprintf(line, sizeof(line), "  %s = select <%" PRIu32 " x i1> %s, %s %s, %s %s\n", p_result,
+			 lp_vector->name, p_mask, llvmType, p_lhs, llvmType, p_rhs);
+	string_append_str(p_function, line);
+	p_self->operations++;
+}
+
+void simd_lowering_emit_reduce(struct SimdLowering* p_self, type_id_t type,
+							   const enum SimdReductions REDUCTION, const char* p_value,
+							   const char* p_result, struct String* p_function,
+							   struct String* p_module) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	bool			   isFloat	 = simd___is_float(lp_vector->primitive);
+	bool			   isSigned	 = simd___is_signed(lp_vector->primitive);
+	bool			   isMask	 = lp_vector->primitive == TYPE_PRIMITIVE_BOOL;
+	const char*		   lp_lane	 = simd___llvm_lane(lp_vector->primitive);
+	const char*		   lp_kind	 = NULL;
+	const char*		   lp_start	 = NULL; // The start value of ordered float reductions
+
+	switch (REDUCTION) {
+	case SIMD_REDUCTION_SUM:
+		lp_kind	 = isFloat ? "fadd" : "add";
+		lp_start = isFloat ? "-0.0" : NULL;
+		break;
+	case SIMD_REDUCTION_PRODUCT:
+		lp_kind	 = isFloat ? "fmul" : "mul";
+		lp_start = isFloat ? "1.0" : NULL;
+		break;
+	case SIMD_REDUCTION_MIN:
+		lp_kind = isFloat ? "fmin" : isSigned ? "smin" : "umin";
+		break;
+	case SIMD_REDUCTION_MAX:
+		lp_kind = isFloat ? "fmax" : isSigned ? "smax" : "umax";
+		break;
+	case SIMD_REDUCTION_ANY:
+		lp_kind = "or";
+		break;
+	case SIMD_REDUCTION_ALL:
+		lp_kind = "and";
+		break;
+	default:
+		PANIC("unknown vector reduction");
+	}
+
+	if (isMask != (REDUCTION == SIMD_REDUCTION_ANY || REDUCTION == SIMD_REDUCTION_ALL)) {
+		PANIC("unsupported reduction for the vector");
+	}
+
+	char llvmType[SIMD_TYPE_LENGTH];
+	char suffix[SIMD_SUFFIX_LENGTH];
+	char name[SIMD_NAME_LENGTH];
+	char start[SIMD_NAME_LENGTH];
+	char line[SIMD_LINE_LENGTH];
+
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	simd___suffix(lp_vector, suffix);
+	snprintf(name, sizeof(name), "llvm.vector.reduce.%s.%s", lp_kind, suffix);
+	snprintf(start, sizeof(start), "%s, ", lp_lane);
+
+	// declare T @llvm.vector.reduce.KIND.vNT([T,] <N x T>)
+	snprintf(line, sizeof(line), "declare %s @%s(%s%s)\n", lp_lane, name, lp_start ? start : "",
+			 llvmType);
+	simd___declare(p_self, name, line, p_module);
+
+	// %result = call [reassoc] T @llvm.vector.reduce.KIND.vNT([T START,] <N x T> %value)
+	snprintf(start, sizeof(start), "%s %s, ", lp_lane, lp_start ? lp_start : "");
+	snprintf(line, sizeof(line), "  %s = call %s%s @%s(%s%s %s)\n", p_result,
+			 lp_start ? "reassoc " : "", lp_lane, name, lp_start ? start : "", llvmType, p_value);
+	string_append_str(p_function, line);
+	p_self->operations++;
+	p_self->intrinsicCalls++;
+}
+
+/**
+ * Emits the mask of the lanes of a load or store that are within its array and set in its mask,
+ * and the pointer to the first lane's element.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param p_vector   The vector type.
+ * @param p_array    The array, an '%array*'.
+ * @param p_index    The index of the first lane's element, an 'i64'.
+ * @param p_mask     The mask of the lanes, or NULL for every lane.
+ * @param p_lanes    Where to write the name of the mask (SIMD_TEMPORARY_LENGTH characters).
+ * @param p_pointer  Where to write the name of the pointer (SIMD_TEMPORARY_LENGTH characters).
+ * @param p_function Where to append the IR of the function being generated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void simd___emit_lanes(struct SimdLowering* p_self, const struct Type* p_vector,
+					   const char* p_array, const char* p_index, const char* p_mask, char* p_lanes,
+					   char* p_pointer, struct String* p_function) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	uint32_t	lanes	= p_vector->name;
+	const char* lp_lane = simd___llvm_lane(p_vector->primitive);
+	char		temporaries[11][SIMD_TEMPORARY_LENGTH];
+	char		line[SIMD_LINE_LENGTH];
+
+	for (size_t index = 0; index < sizeof(temporaries) / sizeof(temporaries[0]); index++) {
+		simd___temporary(p_self, temporaries[index]);
+	}
+
+	// The indexes of the lanes' elements, compared unsigned so negative indexes are out too
+	// %0 = insertelement <N x i64> undef, i64 %index, i32 0
+	// %1 = shufflevector <N x i64> %0, <N x i64> undef, <N x i32> zeroinitializer
+	// %2 = add <N x i64> %1, <i64 0, i64 1, ...>
+	snprintf(line, sizeof(line),
+			 "  %s = insertelement <%" PRIu32 " x i64> undef, i64 %s, i32 0\n  %s = shufflevector "
+			 "<%" PRIu32 " x i64> %s, <%" PRIu32 " x i64> undef, <%" PRIu32
+			 " x i32> zeroinitializer\n  %s = add <%" PRIu32 " x i64> %s, <",
+			 temporaries[0], lanes, p_index, temporaries[1], lanes, temporaries[0], lanes, lanes,
+			 temporaries[2], lanes, temporaries[1]);
+	string_append_str(p_function, line);
+
+	for (uint32_t index = 0; index < lanes; index++) {
+		snprintf(line, sizeof(line), "%si64 %" PRIu32, index ? ", " : "", index);
+		string_append_str(p_function, line);
+	}
+
+	// %3 = getelementptr inbounds %array, %array* %array, i32 0, i32 1
+	// %4 = load i64, i64* %3
+	// %5 = insertelement <N x i64> undef, i64 %4, i32 0
+	// %6 = shufflevector <N x i64> %5, <N x i64> undef, <N x i32> zeroinitializer
+	// %lanes = icmp ult <N x i64> %2, %6
+	snprintf(line, sizeof(line),
+			 ">\n  %s = getelementptr inbounds %%array, %%array* %s, i32 0, i32 1\n  %s = load "
+			 "i64, i64* %s\n",
+			 temporaries[3], p_array, temporaries[4], temporaries[3]);
+	string_append_str(p_function, line);
+	snprintf(line, sizeof(line),
+			 "  %s = insertelement <%" PRIu32 " x i64> undef, i64 %s, i32 0\n  %s = shufflevector "
+			 "<%" PRIu32 " x i64> %s, <%" PRIu32 " x i64> undef, <%" PRIu32
+			 " x i32> zeroinitializer\n",
+			 temporaries[5], lanes, temporaries[4], temporaries[6], lanes, temporaries[5], lanes,
+			 lanes);
+	string_append_str(p_function, line);
+	simd___temporary(p_self, p_lanes);
+	snprintf(line, sizeof(line), "  %s = icmp ult <%" PRIu32 " x i64> %s, %s\n", p_lanes, lanes,
+			 temporaries[2], temporaries[6]);
+	string_append_str(p_function, line);
+
+	if (p_mask) {
+		char inBounds[SIMD_TEMPORARY_LENGTH];
+
+		// %lanes = and <N x i1> %inBounds, %mask
+		memcpy(inBounds, p_lanes, SIMD_TEMPORARY_LENGTH);
+		simd___temporary(p_self, p_lanes);
+		snprintf(line, sizeof(line), "  %s = and <%" PRIu32 " x i1> %s, %s\n", p_lanes, lanes,
+				 inBounds, p_mask);
+		string_append_str(p_function, line);
+	}
+
+	// The first lane's element, which may be past the end of the array if no lane is loaded
+	// %7 = getelementptr inbounds %array, %array* %array, i32 0, i32 0
+	// %8 = load i8*, i8** %7
+	// %9 = bitcast i8* %8 to T*
+	// %10 = getelementptr T, T* %9, i64 %index
+	// %pointer = bitcast T* %10 to <N x T>*
+	snprintf(line, sizeof(line),
+			 "  %s = getelementptr inbounds %%array, %%array* %s, i32 0, i32 0\n  %s = load i8*, "
+			 "i8** %s\n",
+			 temporaries[7], p_array, temporaries[8], temporaries[7]);
+	string_append_str(p_function, line);
+	snprintf(line, sizeof(line),
+			 "  %s = bitcast i8* %s to %s*\n  %s = getelementptr %s, %s* %s, i64 %s\n",
+			 temporaries[9], temporaries[8], lp_lane, temporaries[10], lp_lane, lp_lane,
+			 temporaries[9], p_index);
+	string_append_str(p_function, line);
+	simd___temporary(p_self, p_pointer);
+	snprintf(line, sizeof(line), "  %s = bitcast %s* %s to <%" PRIu32 " x %s>*\n", p_pointer,
+			 lp_lane, temporaries[10], lanes, lp_lane);
+	string_append_str(p_function, line);
+}
+
+void simd_lowering_emit_load(struct SimdLowering* p_self, type_id_t type, const char* p_array,
+							 const char* p_index, const char* p_mask, const char* p_result,
+							 struct String* p_function, struct String* p_module) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	char			   llvmType[SIMD_TYPE_LENGTH];
+	char			   suffix[SIMD_SUFFIX_LENGTH];
+	char			   name[SIMD_NAME_LENGTH];
+	char			   lanes[SIMD_TEMPORARY_LENGTH];
+	char			   pointer[SIMD_TEMPORARY_LENGTH];
+	char			   line[SIMD_LINE_LENGTH];
+
+	if (lp_vector->primitive == TYPE_PRIMITIVE_BOOL) { // 'bool' elements are bytes, mask lanes bits
+		PANIC("masks cannot be loaded from an array");
+	}
+
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	simd___suffix(lp_vector, suffix);
+	snprintf(name, sizeof(name), "llvm.masked.load.%s.p0%s", suffix, suffix);
+
+	// declare <N x T> @llvm.masked.load.vNT.p0vNT(<N x T>*, i32, <N x i1>, <N x T>)
+	snprintf(line, sizeof(line), "declare %s @%s(%s*, i32, <%" PRIu32 " x i1>, %s)\n", llvmType,
+			 name, llvmType, lp_vector->name, llvmType);
+	simd___declare(p_self, name, line, p_module);
+
+	simd___emit_lanes(p_self, lp_vector, p_array, p_index, p_mask, lanes, pointer, p_function);
+
+	// %result = call <N x T> @llvm.masked.load.vNT.p0vNT(<N x T>* %pointer, i32 ALIGN,
+	//                                                    <N x i1> %lanes, <N x T> zeroinitializer)
+	snprintf(line, sizeof(line),
+			 "  %s = call %s @%s(%s* %s, i32 %" PRIu32 ", <%" PRIu32
+			 " x i1> %s, %s zeroinitializer)\n",
+			 p_result, llvmType, name, llvmType, pointer, simd___bits(lp_vector->primitive) / 8,
+			 lp_vector->name, lanes, llvmType);
+	string_append_str(p_function, line);
+	p_self->operations++;
+	p_self->intrinsicCalls++;
+}
+
+void simd_lowering_emit_store(struct SimdLowering* p_self, type_id_t type, const char* p_value,
+							  const char* p_array, const char* p_index, const char* p_mask,
+							  struct String* p_function, struct String* p_module) {
+	const struct Type* lp_vector = simd___vector(p_self, type);
+	char			   llvmType[SIMD_TYPE_LENGTH];
+	char			   suffix[SIMD_SUFFIX_LENGTH];
+	char			   name[SIMD_NAME_LENGTH];
+	char			   lanes[SIMD_TEMPORARY_LENGTH];
+	char			   pointer[SIMD_TEMPORARY_LENGTH];
+	char			   line[SIMD_LINE_LENGTH];
+
+	if (lp_vector->primitive == TYPE_PRIMITIVE_BOOL) {
+		PANIC("masks cannot be stored into an array");
+	}
+
+	simd_lowering_llvm_type(p_self->types, type, llvmType);
+	simd___suffix(lp_vector, suffix);
+	snprintf(name, sizeof(name), "llvm.masked.store.%s.p0%s", suffix, suffix);
+
+	// declare void @llvm.masked.store.vNT.p0vNT(<N x T>, <N x T>*, i32, <N x i1>)
+	snprintf(line, sizeof(line), "declare void @%s(%s, %s*, i32, <%" PRIu32 " x i1>)\n", name,
+			 llvmType, llvmType, lp_vector->name);
+	simd___declare(p_self, name, line, p_module);
+
+	simd___emit_lanes(p_self, lp_vector, p_array, p_index, p_mask, lanes, pointer, p_function);
+
+	// call void @llvm.masked.store.vNT.p0vNT(<N x T> %value, <N x T>* %pointer, i32 ALIGN,
+	//                                        <N x i1> %lanes)
+	snprintf(line, sizeof(line),
+			 "  call void @%s(%s %s, %s* %s, i32 %" PRIu32 ", <%" PRIu32 " x i1> %s)\n", name,
+			 llvmType, p_value, llvmType, pointer, simd___bits(lp_vector->primitive) / 8,
+			 lp_vector->name, lanes);
+	string_append_str(p_function, line);
+	p_self->operations++;
+	p_self->intrinsicCalls++;
+}
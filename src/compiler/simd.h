@@ -0,0 +1,255 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./types.h"
+#include "../lexer/tokens.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIMD_DEFAULT_WIDTH 128U // Bits, the vectors every x86-64 (SSE2) and AArch64 (NEON) CPU has.
+#define SIMD_TYPE_LENGTH   32U	// Enough for the LLVM type of any vector, e.g. '<64 x double>'.
+
+// X-Macro to define the target features that allow wider vectors, and their width in bits
+#define SIMD_FEATURES(X)                                                                           \
+	X("sse2", 128U)                                                                                \
+	X("neon", 128U)                                                                                \
+	X("avx", 256U)                                                                                 \
+	X("avx2", 256U)                                                                                \
+	X("avx512f", 512U)
+
+// X-Macro to define the reductions of a vector to one value, and the methods they are called with
+#define SIMD_REDUCTIONS(X)                                                                         \
+	X(SUM, "sum")                                                                                  \
+	X(PRODUCT, "product")                                                                          \
+	X(MIN, "min")                                                                                  \
+	X(MAX, "max")                                                                                  \
+	X(ANY, "any") /* Masks only */                                                                 \
+	X(ALL, "all") /* Masks only */
+
+/**
+ * Used to identify the reductions of a vector.
+ */
+enum SimdReductions {
+#define SIMD_REDUCTION_ENUM_ENTRY(name, string) SIMD_REDUCTION_##name,
+	SIMD_REDUCTIONS(SIMD_REDUCTION_ENUM_ENTRY)
+#undef SIMD_REDUCTION_ENUM_ENTRY
+};
+
+/**
+ * Contains the method names of each of the reductions.
+ */
+extern const struct Array g_SIMD_REDUCTION_NAMES;
+
+/**
+ * Gets the method name of a reduction.
+ *
+ * @param REDUCTION The reduction.
+ *
+ * @return The method name of the reduction.
+ */
+const char* simd_reduction_get_name(
+	const enum SimdReductions REDUCTION); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Represents the lowering of SIMD vectors, 'Vec<T, N>', which map directly onto LLVM's '<N x T>'.
+ * Operators work lane by lane, comparisons give a mask ('Vec<bool, N>'), and the methods become
+ * shuffles, selects and the 'llvm.vector.reduce' and 'llvm.masked' intrinsics, so kernels the
+ * auto-vectorizer gives up on can be written with explicit vectors. Loads and stores never touch
+ * the lanes past the end of their array. Vectors wider than the target's registers are an error,
+ * as LLVM would silently split them.
+ */
+struct SimdLowering {
+	const char*				filePath; // For diagnostics.
+	const struct TypeTable* types;
+	uint32_t				width;		  // The widest vectors the target has, in bits.
+	char**					declarations; // The intrinsics declared.
+	size_t					declarationCount, declarationCapacity;
+	size_t					temporaries;
+	size_t					vectors, operations, intrinsicCalls; // For the time report.
+};
+
+#define SIMDLOWERING_STRUCT_SIZE sizeof(struct SimdLowering)
+
+/**
+ * Creates a new SimdLowering struct.
+ *
+ * @param p_filePath       The path of the module, for diagnostics.
+ * @param p_types          The module's type table.
+ * @param p_targetFeatures The target features, comma separated like LLVM's, e.g. '+avx2,+fma'.
+ *
+ * @return The created SimdLowering struct.
+ */
+struct SimdLowering* simd_lowering_new(const char* p_filePath, const struct TypeTable* p_types,
+									   const char* p_targetFeatures);
+
+/**
+ * Frees a SimdLowering struct.
+ *
+ * @param p_self The current SimdLowering struct.
+ */
+void simd_lowering_free(struct SimdLowering** p_self);
+
+/**
+ * Checks the vectors of the last inferred function fit the target's registers. Errors on any
+ * wider vector.
+ *
+ * @param p_self      The current SimdLowering struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param function    The function's node.
+ */
+void simd_lowering_analyse(struct SimdLowering* p_self, const struct FlatAST* p_ast,
+						   const struct Inference* p_inference, flat_ast_index_t function);
+
+/**
+ * Writes the LLVM type of a vector.
+ *
+ * @param p_types    The type table.
+ * @param type       The vector type.
+ * @param p_llvmType Where to write the LLVM type (SIMD_TYPE_LENGTH characters), e.g. '<8 x float>'.
+ */
+void simd_lowering_llvm_type(const struct TypeTable* p_types, type_id_t type, char* p_llvmType);
+
+/**
+ * Emits a lane by lane arithmetic or bitwise operation, e.g. 'a + b'.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type of both operands.
+ * @param OPERATION  The operator.
+ * @param p_lhs      The left operand, e.g. '%a'.
+ * @param p_rhs      The right operand.
+ * @param p_result   The name of the result, which has the same type.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+void simd_lowering_emit_binary(
+	struct SimdLowering* p_self, type_id_t type,
+	const enum LexerTokenIdentifiers OPERATION, // NOLINT(readability-avoid-const-params-in-decls)
+	const char* p_lhs, const char* p_rhs, const char* p_result, struct String* p_function);
+
+/**
+ * Emits a lane by lane comparison, e.g. 'a < b', whose result is a mask.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type of both operands.
+ * @param OPERATION  The comparison operator.
+ * @param p_lhs      The left operand.
+ * @param p_rhs      The right operand.
+ * @param p_result   The name of the result, a '<N x i1>'.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+void simd_lowering_emit_compare(
+	struct SimdLowering* p_self, type_id_t type,
+	const enum LexerTokenIdentifiers OPERATION, // NOLINT(readability-avoid-const-params-in-decls)
+	const char* p_lhs, const char* p_rhs, const char* p_result, struct String* p_function);
+
+/**
+ * Emits a vector with every lane set to the same value, 'Vec<T, N>.splat(value)'.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type.
+ * @param p_scalar   The value, of the lanes' type.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void simd_lowering_emit_splat(struct SimdLowering* p_self, type_id_t type, const char* p_scalar,
+							  const char* p_result, struct String* p_function);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits a shuffle, 'a.shuffle(b, [lanes])'. Lane i of the result is lane p_lanes[i] of 'a' and 'b'
+ * put end to end, so the result may have a different number of lanes.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type of both operands.
+ * @param p_lhs      The first operand.
+ * @param p_rhs      The second operand, or NULL to shuffle the first alone.
+ * @param p_lanes    The lane each lane of the result is taken from, each below twice the lanes.
+ * @param laneCount  The number of lanes of the result, a power of two.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+void simd_lowering_emit_shuffle(struct SimdLowering* p_self, type_id_t type, const char* p_lhs,
+								const char* p_rhs, const uint32_t* p_lanes, uint32_t laneCount,
+								const char* p_result, struct String* p_function);
+
+/**
+ * Emits a lane by lane choice between two vectors, 'mask.select(a, b)'.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type of both operands.
+ * @param p_mask     The mask, a '<N x i1>' choosing 'a' where it is set.
+ * @param p_lhs      The vector chosen where the mask is set.
+ * @param p_rhs      The vector chosen elsewhere.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the IR of the function being generated.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void simd_lowering_emit_select(struct SimdLowering* p_self, type_id_t type, const char* p_mask,
+							   const char* p_lhs, const char* p_rhs, const char* p_result,
+							   struct String* p_function);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits the reduction of a vector to one value, e.g. 'v.sum()'. Float sums and products may be
+ * reassociated, so they are computed as a tree instead of lane by lane.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type.
+ * @param REDUCTION  The reduction. 'any' and 'all' take masks, the others numeric vectors.
+ * @param p_value    The vector.
+ * @param p_result   The name of the result, of the lanes' type.
+ * @param p_function Where to append the IR of the function being generated.
+ * @param p_module   Where to append intrinsic declarations, at module level.
+ */
+void simd_lowering_emit_reduce(
+	struct SimdLowering* p_self, type_id_t type,
+	const enum SimdReductions REDUCTION, // NOLINT(readability-avoid-const-params-in-decls)
+	const char* p_value, const char* p_result, struct String* p_function,
+	struct String* p_module);
+
+/**
+ * Emits a load of lanes from an 'Array<T>', 'Vec<T, N>.load(array, index, mask)'. Lanes past the
+ * end of the array, or not set in the mask, are zero and never read.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type.
+ * @param p_array    The array, an '%array*'.
+ * @param p_index    The index of the first lane's element, an 'i64'.
+ * @param p_mask     The mask of the lanes to load, or NULL to load every lane.
+ * @param p_result   The name of the result.
+ * @param p_function Where to append the IR of the function being generated.
+ * @param p_module   Where to append intrinsic declarations, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void simd_lowering_emit_load(struct SimdLowering* p_self, type_id_t type, const char* p_array,
+							 const char* p_index, const char* p_mask, const char* p_result,
+							 struct String* p_function, struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
+
+/**
+ * Emits a store of lanes into an 'Array<T>', 'v.store(array, index, mask)'. Lanes past the end of
+ * the array, or not set in the mask, are never written.
+ *
+ * @param p_self     The current SimdLowering struct.
+ * @param type       The vector type.
+ * @param p_value    The vector.
+ * @param p_array    The array, an '%array*'.
+ * @param p_index    The index of the first lane's element, an 'i64'.
+ * @param p_mask     The mask of the lanes to store, or NULL to store every lane.
+ * @param p_function Where to append the IR of the function being generated.
+ * @param p_module   Where to append intrinsic declarations, at module level.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void simd_lowering_emit_store(struct SimdLowering* p_self, type_id_t type, const char* p_value,
+							  const char* p_array, const char* p_index, const char* p_mask,
+							  struct String* p_function, struct String* p_module);
+// NOLINTEND(bugprone-easily-swappable-parameters)
@@ -0,0 +1,106 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./symbols.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include <stdlib.h>
+
+struct SymbolTable* symbol_table_new(void) {
+	struct SymbolTable* lp_self = calloc(1, SYMBOLTABLE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc SymbolTable struct");
+	}
+
+	lp_self->bindings = buffer_grow(NULL, &lp_self->bindingCapacity, 1, SYMBOL_BINDING_SIZE);
+	lp_self->bindingCount = 1; // Reserve SYMBOL_BINDING_NONE
+
+	symbol_table_push_scope(lp_self); // The module scope
+
+	return lp_self;
+}
+
+void symbol_table_free(struct SymbolTable** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->bindings);
+		free((*p_self)->current);
+		free((*p_self)->scopes);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("SymbolTable struct has already been freed");
+	}
+}
+
+void symbol_table_push_scope(struct SymbolTable* p_self) {
+	p_self->scopes = buffer_grow(p_self->scopes, &p_self->scopeCapacity, p_self->scopeCount + 1,
+								 sizeof(uint32_t));
+	p_self->scopes[p_self->scopeCount++] = (uint32_t)p_self->bindingCount;
+}
+
+void symbol_table_pop_scope(struct SymbolTable* p_self) {
+	if (p_self->scopeCount == 0) {
+		PANIC("SymbolTable has no scope to pop");
+	}
+
+	size_t mark = p_self->scopes[--p_self->scopeCount];
+
+	while (p_self->bindingCount > mark) {
+		struct SymbolBinding* lp_binding = &p_self->bindings[--p_self->bindingCount];
+
+		p_self->current[lp_binding->name] = lp_binding->shadowed;
+	}
+}
+
+size_t symbol_table_depth(const struct SymbolTable* p_self) {
+	return p_self->scopeCount;
+}
+
+uint32_t symbol_table_declare(struct SymbolTable* p_self, intern_id_t name, enum SymbolKinds kind,
+							  flat_ast_index_t declaration) {
+	if (p_self->scopeCount == 0) {
+		PANIC("SymbolTable declare with no open scope");
+	}
+
+	p_self->current =
+		buffer_grow(p_self->current, &p_self->currentCapacity, name + 1, sizeof(uint32_t));
+
+	uint32_t shadowed = p_self->current[name];
+
+	if (shadowed != SYMBOL_BINDING_NONE && shadowed >= p_self->scopes[p_self->scopeCount - 1]) {
+		return SYMBOL_BINDING_NONE; // Already declared in this scope
+	}
+
+	p_self->bindings = buffer_grow(p_self->bindings, &p_self->bindingCapacity,
+								   p_self->bindingCount + 1, SYMBOL_BINDING_SIZE);
+
+	uint32_t			  index		 = (uint32_t)p_self->bindingCount++;
+	struct SymbolBinding* lp_binding = &p_self->bindings[index];
+
+	lp_binding->name		= name;
+	lp_binding->kind		= kind;
+	lp_binding->depth		= (uint32_t)p_self->scopeCount;
+	lp_binding->shadowed	= shadowed;
+	lp_binding->declaration = declaration;
+	lp_binding->type		= TYPE_ID_NONE;
+
+	p_self->current[name] = index;
+
+	return index;
+}
+
+uint32_t symbol_table_resolve(const struct SymbolTable* p_self, intern_id_t name) {
+	return name < p_self->currentCapacity ? p_self->current[name] : SYMBOL_BINDING_NONE;
+}
+
+struct SymbolBinding* symbol_table_get(const struct SymbolTable* p_self, uint32_t index) {
+	if (index == SYMBOL_BINDING_NONE || index >= p_self->bindingCount) {
+		PANIC("SymbolTable get index out of bounds");
+	}
+
+	return &p_self->bindings[index];
+}
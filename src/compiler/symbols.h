@@ -0,0 +1,129 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/intern.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SYMBOL_BINDING_NONE 0U // Binding index 0 is reserved, so 0 can mean "unbound".
+
+/**
+ * Used to identify the kinds of symbols.
+ */
+enum SymbolKinds {
+	SYMBOL_VARIABLE,
+	SYMBOL_PARAMETER,
+	SYMBOL_FUNCTION,
+	SYMBOL_STRUCT,
+	SYMBOL_TRAIT,
+	SYMBOL_TYPE_PARAMETER,
+	SYMBOL_MODULE,
+};
+
+/**
+ * Represents a binding of a symbol in a scope.
+ */
+struct SymbolBinding {
+	intern_id_t		 name;
+	uint32_t		 kind;
+	uint32_t		 depth;		  // The depth of the scope the binding was declared in.
+	uint32_t		 shadowed;	  // The shadowed binding, restored when this scope is popped.
+	flat_ast_index_t declaration; // The declaration's node.
+	type_id_t		 type;		  // The symbol's type, TYPE_ID_NONE until it is known.
+};
+
+#define SYMBOL_BINDING_SIZE sizeof(struct SymbolBinding)
+
+/**
+ * Represents a scoped symbol table. All bindings live in one array in declaration order, which
+ * doubles as the undo log: popping a scope walks back over its bindings restoring what each one
+ * shadowed, then truncates the array. The innermost binding of every symbol is indexed by its
+ * interned id, so resolution is a single array read. The arrays only ever grow, so once they are
+ * large enough for the deepest nesting seen, pushing, declaring and popping never allocate.
+ */
+struct SymbolTable {
+	struct SymbolBinding* bindings;
+	uint32_t*			  current; // The innermost binding of each interned id.
+	uint32_t*			  scopes;  // The bindings length when each open scope was pushed.
+	size_t bindingCount, bindingCapacity, currentCapacity, scopeCount, scopeCapacity;
+};
+
+#define SYMBOLTABLE_STRUCT_SIZE sizeof(struct SymbolTable)
+
+/**
+ * Creates a new SymbolTable struct, with the module scope open.
+ *
+ * @return The created SymbolTable struct.
+ */
+struct SymbolTable* symbol_table_new(void);
+
+/**
+ * Frees a SymbolTable struct.
+ *
+ * @param p_self The current SymbolTable struct.
+ */
+void symbol_table_free(struct SymbolTable** p_self);
+
+/**
+ * Opens a new scope.
+ *
+ * @param p_self The current SymbolTable struct.
+ */
+void symbol_table_push_scope(struct SymbolTable* p_self);
+
+/**
+ * Closes the innermost scope, unbinding everything declared in it.
+ *
+ * @param p_self The current SymbolTable struct.
+ */
+void symbol_table_pop_scope(struct SymbolTable* p_self);
+
+/**
+ * Gets the depth of the innermost scope. The module scope has depth 1.
+ *
+ * @param p_self The current SymbolTable struct.
+ *
+ * @return The depth.
+ */
+size_t symbol_table_depth(const struct SymbolTable* p_self);
+
+/**
+ * Declares a symbol in the innermost scope, shadowing any outer binding of it.
+ *
+ * @param p_self      The current SymbolTable struct.
+ * @param name        The interned name of the symbol.
+ * @param kind        The kind of the symbol.
+ * @param declaration The declaration's node.
+ *
+ * @return The index of the new binding, or SYMBOL_BINDING_NONE if the symbol is already declared
+ * in the innermost scope.
+ */
+uint32_t symbol_table_declare(struct SymbolTable* p_self, intern_id_t name, enum SymbolKinds kind,
+							  flat_ast_index_t declaration);
+
+/**
+ * Resolves a symbol to its innermost binding.
+ *
+ * @param p_self The current SymbolTable struct.
+ * @param name   The interned name of the symbol.
+ *
+ * @return The index of the binding, or SYMBOL_BINDING_NONE if the symbol is unbound.
+ */
+uint32_t symbol_table_resolve(const struct SymbolTable* p_self, intern_id_t name);
+
+/**
+ * Gets a binding. The pointer is invalidated by the next declaration.
+ *
+ * @param p_self The current SymbolTable struct.
+ * @param index  The index of the binding.
+ *
+ * @return The binding.
+ */
+struct SymbolBinding* symbol_table_get(const struct SymbolTable* p_self, uint32_t index);
@@ -0,0 +1,283 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./tailcall.h"
+#include "./attributes.h"
+#include "./diagnostics.h"
+#include "../utils/panic.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TAIL_CALLS_INITIAL_CAPACITY 64U
+
+// X-Macro to define tail call reason explanations
+static char* const g_TAIL_CALL_REASON_NAMES_INTERNAL[] = {
+#define TAIL_CALL_REASON_TO_STRING(name, string) string,
+	TAIL_CALL_REASONS(TAIL_CALL_REASON_TO_STRING)
+#undef TAIL_CALL_REASON_TO_STRING
+};
+
+const struct Array g_TAIL_CALL_REASON_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_TAIL_CALL_REASON_NAMES_INTERNAL,
+						sizeof(g_TAIL_CALL_REASON_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* tail_call_reason_get_name(const enum TailCallReasons REASON) {
+	if ((size_t)REASON + 1 > g_TAIL_CALL_REASON_NAMES.length) {
+		PANIC("g_TAIL_CALL_REASON_NAMES get index out of bounds");
+	}
+
+	return g_TAIL_CALL_REASON_NAMES._values[REASON];
+}
+
+struct TailCalls* tail_calls_new(const char* p_filePath, const struct TypeTable* p_types) {
+	struct TailCalls* lp_self = calloc(1, TAILCALLS_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc TailCalls struct");
+	}
+
+	lp_self->filePath = p_filePath;
+	lp_self->types	  = p_types;
+
+	return lp_self;
+}
+
+void tail_calls_free(struct TailCalls** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->kinds);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("TailCalls struct has already been freed");
+	}
+}
+
+/**
+ * Checks whether the arguments of a call are primitives, so none of them can point into the
+ * caller's stack frame once it is gone.
+ *
+ * @param p_self The current TailCalls struct.
+ * @param p_call The call.
+ *
+ * @return Whether the arguments are primitives.
+ */
+bool tail_calls___primitive_arguments(const struct TailCalls* p_self,
+									  const struct FlatASTNode* p_call) {
+	for (size_t index = 0; index < p_call->value.list.length; index++) {
+		type_id_t type = inference_get_node_type(
+			p_self->inference, flat_ast_get_list_item(p_self->ast, p_call, index));
+
+		if (type == TYPE_ID_NONE) {
+			return false;
+		}
+
+		const struct Type* lp_type = type_table_get(p_self->types, type);
+
+		if (lp_type->kind != TYPE_PRIMITIVE || lp_type->primitive == TYPE_PRIMITIVE_STR) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Decides how a call in tail position is emitted.
+ *
+ * @param p_self  The current TailCalls struct.
+ * @param call    The call's node.
+ * @param p_kind  Where to write the kind of the call.
+ *
+ * @return Why the call cannot be a guaranteed tail call, TAIL_CALL_REASON_NONE if it can.
+ */
+enum TailCallReasons tail_calls___classify(const struct TailCalls* p_self, flat_ast_index_t call,
+										   enum TailCallKinds* p_kind) {
+	const struct FlatASTNode* lp_call	  = flat_ast_get(p_self->ast, call);
+	const struct FlatASTNode* lp_callee	  = flat_ast_get(p_self->ast, lp_call->lhs);
+	const struct FlatASTNode* lp_function = flat_ast_get(p_self->ast, p_self->function);
+
+	*p_kind = TAIL_CALL_NONE;
+
+	// A self call names the module's binding of the function, not a parameter or local shadowing it
+	if (lp_callee->kind == FLATAST_VARIABLE
+		&& strcmp(flat_ast_get_string(p_self->ast, lp_callee->value.string), p_self->name) == 0
+		&& inference_get_node_depth(p_self->inference, lp_call->lhs) == 1) {
+		if (lp_call->value.list.length != lp_function->value.list.length) {
+			return TAIL_CALL_REASON_SIGNATURE;
+		}
+
+		*p_kind = TAIL_CALL_LOOP;
+	} else {
+		type_id_t callee = inference_get_node_type(p_self->inference, lp_call->lhs);
+
+		// 'musttail' needs the same prototype, so the caller's argument area fits the callee's
+		if (callee == TYPE_ID_NONE
+			|| callee != inference_get_node_type(p_self->inference, p_self->function)) {
+			return TAIL_CALL_REASON_SIGNATURE;
+		}
+
+		*p_kind = TAIL_CALL_MUSTTAIL;
+	}
+
+	if (!tail_calls___primitive_arguments(p_self, lp_call)) {
+		*p_kind = TAIL_CALL_NONE;
+
+		return TAIL_CALL_REASON_STACK;
+	}
+
+	return TAIL_CALL_REASON_NONE;
+}
+
+/**
+ * Records how a call is emitted, erroring if it is marked '@tailcall' and cannot be a guaranteed
+ * tail call.
+ *
+ * @param p_self   The current TailCalls struct.
+ * @param call     The call's node.
+ * @param isTail   Whether the call is in tail position.
+ */
+void tail_calls___call(struct TailCalls* p_self, flat_ast_index_t call, bool isTail) {
+	enum TailCallKinds	 kind	= TAIL_CALL_NONE;
+	enum TailCallReasons reason = isTail ? tail_calls___classify(p_self, call, &kind)
+										 : TAIL_CALL_REASON_NOT_TAIL;
+
+	if (reason != TAIL_CALL_REASON_NONE && attributes_has(p_self->ast, call, ATTRIBUTE_TAILCALL)) {
+		compiler_error(p_self->filePath, flat_ast_get(p_self->ast, call)->line, C0006,
+					   CONCATENATE_STRING("cannot guarantee the tail call in '", p_self->name,
+										  "': ", tail_call_reason_get_name(reason)));
+	}
+
+	p_self->kinds[call] = (uint8_t)kind;
+
+	if (kind == TAIL_CALL_LOOP) {
+		p_self->looping = true;
+		p_self->loops++;
+	} else if (kind == TAIL_CALL_MUSTTAIL) {
+		p_self->musttails++;
+	}
+}
+
+/**
+ * Walks a node of a function's body, recording how its calls are emitted. Nested functions are
+ * analysed on their own.
+ *
+ * @param p_self The current TailCalls struct.
+ * @param node   The node.
+ */
+void tail_calls___walk(struct TailCalls* p_self, flat_ast_index_t node) {
+	if (node == FLATAST_INDEX_NONE) {
+		return;
+	}
+
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	switch (lp_node->kind) {
+	case FLATAST_FUNCTION:
+		return;
+	case FLATAST_RETURN:
+		if (lp_node->lhs != FLATAST_INDEX_NONE
+			&& flat_ast_get(p_self->ast, lp_node->lhs)->kind == FLATAST_CALL) {
+			const struct FlatASTNode* lp_call = flat_ast_get(p_self->ast, lp_node->lhs);
+
+			tail_calls___call(p_self, lp_node->lhs, true);
+			tail_calls___walk(p_self, lp_call->lhs);
+
+			for (size_t index = 0; index < lp_call->value.list.length; index++) {
+				tail_calls___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_call, index));
+			}
+
+			return;
+		}
+
+		break;
+	case FLATAST_CALL:
+		tail_calls___call(p_self, node, false);
+		break;
+	default:
+		break;
+	}
+
+	tail_calls___walk(p_self, lp_node->lhs);
+	tail_calls___walk(p_self, lp_node->rhs);
+
+	switch (lp_node->kind) {
+	case FLATAST_CALL:
+	case FLATAST_STRUCT_LITERAL:
+	case FLATAST_ARRAY_LITERAL:
+	case FLATAST_BLOCK:
+	case FLATAST_IF:
+	case FLATAST_MATCH:
+		for (size_t index = 0; index < lp_node->value.list.length; index++) {
+			tail_calls___walk(p_self, flat_ast_get_list_item(p_self->ast, lp_node, index));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+bool tail_calls_analyse(struct TailCalls* p_self, const struct FlatAST* p_ast,
+						const struct Inference* p_inference, flat_ast_index_t function,
+						const char* p_name) {
+	if (p_ast->nodeCount > p_self->kindCapacity) {
+		size_t capacity = p_self->kindCapacity ? p_self->kindCapacity : TAIL_CALLS_INITIAL_CAPACITY;
+
+		while (capacity < p_ast->nodeCount) {
+			capacity *= 2;
+		}
+
+		uint8_t* lp_kindsTemp = realloc(p_self->kinds, capacity);
+
+		if (!lp_kindsTemp) {
+			PANIC("failed to realloc TailCalls kinds");
+		}
+
+		memset(lp_kindsTemp + p_self->kindCapacity, 0, capacity - p_self->kindCapacity);
+		p_self->kinds		 = lp_kindsTemp;
+		p_self->kindCapacity = capacity;
+	}
+
+	p_self->ast		  = p_ast;
+	p_self->inference = p_inference;
+	p_self->function  = function;
+	p_self->name	  = p_name;
+	p_self->looping	  = false;
+
+	tail_calls___walk(p_self, flat_ast_get(p_ast, function)->rhs);
+
+	return p_self->looping;
+}
+
+enum TailCallKinds tail_calls_get_kind(const struct TailCalls* p_self, flat_ast_index_t call) {
+	return call < p_self->kindCapacity ? (enum TailCallKinds)p_self->kinds[call] : TAIL_CALL_NONE;
+}
+
+void tail_calls_emit_header(struct String* p_output) {
+	// br label %tail.loop
+	string_append_str(p_output, "  br label %" TAIL_CALL_LOOP_LABEL "\n");
+
+	// tail.loop:
+	string_append_str(p_output, TAIL_CALL_LOOP_LABEL ":\n");
+}
+
+void tail_calls_emit_jump(const char* const* p_llvmTypes, const char* const* p_values,
+						  const char* const* p_slots, size_t count, struct String* p_output) {
+	for (size_t index = 0; index < count; index++) {
+		// store T %value, T* %slot
+		string_append_str(p_output, "  store ");
+		string_append_str(p_output, p_llvmTypes[index]);
+		string_append_chr(p_output, ' ');
+		string_append_str(p_output, p_values[index]);
+		string_append_str(p_output, ", ");
+		string_append_str(p_output, p_llvmTypes[index]);
+		string_append_str(p_output, "* ");
+		string_append_str(p_output, p_slots[index]);
+		string_append_chr(p_output, '\n');
+	}
+
+	// br label %tail.loop
+	string_append_str(p_output, "  br label %" TAIL_CALL_LOOP_LABEL "\n");
+}
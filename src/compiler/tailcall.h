@@ -0,0 +1,144 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./infer.h"
+#include "./types.h"
+#include "../parser/flat.h"
+#include "../utils/str.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TAIL_CALL_LOOP_LABEL "tail.loop" // The block self tail calls jump back to.
+
+/**
+ * Used to identify how a call is emitted.
+ */
+enum TailCallKinds {
+	TAIL_CALL_NONE,		// A normal call, which uses a stack frame.
+	TAIL_CALL_LOOP,		// A self tail call, lowered to a jump back to the start of the function.
+	TAIL_CALL_MUSTTAIL, // A tail call to another function, emitted with 'musttail'.
+};
+
+// X-Macro to define why a call cannot be a guaranteed tail call, and how it is explained
+#define TAIL_CALL_REASONS(X)                                                                       \
+	X(NONE, "it can be")                                                                           \
+	X(NOT_TAIL, "it is not in tail position ('return f(...)')")                                    \
+	X(SIGNATURE, "the callee's type is unknown or differs from the caller's")                      \
+	X(STACK, "an argument is not a primitive, so it may point into the caller's stack frame")
+
+/**
+ * Used to identify why a call cannot be a guaranteed tail call.
+ */
+enum TailCallReasons {
+#define TAIL_CALL_REASON_ENUM_ENTRY(name, string) TAIL_CALL_REASON_##name,
+	TAIL_CALL_REASONS(TAIL_CALL_REASON_ENUM_ENTRY)
+#undef TAIL_CALL_REASON_ENUM_ENTRY
+};
+
+/**
+ * Contains the explanations of each of the tail call reasons.
+ */
+extern const struct Array g_TAIL_CALL_REASON_NAMES;
+
+/**
+ * Gets the explanation of a tail call reason.
+ *
+ * @param REASON The tail call reason.
+ *
+ * @return The explanation of the tail call reason.
+ */
+const char* tail_call_reason_get_name(
+	const enum TailCallReasons REASON); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Represents the tail call pass. Calls in tail position ('return f(...)') run in constant stack:
+ * self calls become a jump back to the start of the function, which stores the arguments into
+ * the parameters' slots first, and calls to functions of the same type are emitted with
+ * 'musttail', which LLVM guarantees to turn into a jump. Calls marked '@tailcall' that cannot be
+ * either are an error.
+ */
+struct TailCalls {
+	const char*				filePath; // For diagnostics.
+	const struct TypeTable* types;
+	uint8_t*				kinds; // enum TailCallKinds of each call, by node.
+	size_t					kindCapacity;
+	const struct FlatAST*	ast;	   // The AST of the current function.
+	const struct Inference* inference; // The inference of the current function.
+	flat_ast_index_t		function;  // The current function.
+	const char*				name;	   // The name of the current function.
+	bool					looping;   // Whether the current function has self tail calls.
+	size_t					loops, musttails; // For the time report.
+};
+
+#define TAILCALLS_STRUCT_SIZE sizeof(struct TailCalls)
+
+/**
+ * Creates a new TailCalls struct.
+ *
+ * @param p_filePath The path of the module, for diagnostics.
+ * @param p_types    The module's type table.
+ *
+ * @return The created TailCalls struct.
+ */
+struct TailCalls* tail_calls_new(const char* p_filePath, const struct TypeTable* p_types);
+
+/**
+ * Frees a TailCalls struct.
+ *
+ * @param p_self The current TailCalls struct.
+ */
+void tail_calls_free(struct TailCalls** p_self);
+
+/**
+ * Decides how each call of the last inferred function is emitted. Errors if a call marked
+ * '@tailcall' cannot be a guaranteed tail call.
+ *
+ * @param p_self      The current TailCalls struct.
+ * @param p_ast       The AST containing the function.
+ * @param p_inference The inference the function was just inferred with.
+ * @param function    The function's node.
+ * @param p_name      The function's name, as its calls name it, e.g. 'fibonacci'.
+ *
+ * @return Whether the function has self tail calls, so needs tail_calls_emit_header.
+ */
+bool tail_calls_analyse(struct TailCalls* p_self, const struct FlatAST* p_ast,
+						const struct Inference* p_inference, flat_ast_index_t function,
+						const char* p_name);
+
+/**
+ * Gets how a call is emitted.
+ *
+ * @param p_self The current TailCalls struct.
+ * @param call   The call's node.
+ *
+ * @return The kind of the call, TAIL_CALL_NONE if its function has not been analysed.
+ */
+enum TailCallKinds tail_calls_get_kind(const struct TailCalls* p_self, flat_ast_index_t call);
+
+/**
+ * Emits the start of the loop self tail calls jump to, once the parameters have been stored into
+ * their slots at the end of the entry block.
+ *
+ * @param p_output Where to append the IR.
+ */
+void tail_calls_emit_header(struct String* p_output);
+
+/**
+ * Emits a self tail call: the arguments are stored into the parameters' slots, then the function
+ * starts again. Every argument must have been evaluated first, as they may read the parameters.
+ *
+ * @param p_llvmTypes The LLVM types of the parameters, e.g. 'i32'.
+ * @param p_values    The values of the arguments, e.g. '%5'.
+ * @param p_slots     The slots of the parameters, e.g. '%n.addr'.
+ * @param count       The number of parameters.
+ * @param p_output    Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void tail_calls_emit_jump(const char* const* p_llvmTypes, const char* const* p_values,
+						  const char* const* p_slots, size_t count, struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
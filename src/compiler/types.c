@@ -0,0 +1,639 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./types.h"
+#include "../utils/array.h"
+#include "../utils/buffer.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include "../utils/str.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TYPETABLE_INITIAL_CAPACITY 64U
+#define TYPETABLE_PARSE_PARAMS	   32U // The most parameters of a parsed function type.
+#define TYPETABLE_PARSE_NAME	   16U // Longer than the name of any primitive.
+
+// X-Macro to define primitive type names
+static char* const g_TYPE_PRIMITIVE_NAMES_INTERNAL[] = {
+#define TYPE_PRIMITIVE_TO_STRING(name, string) string,
+	TYPE_PRIMITIVES(TYPE_PRIMITIVE_TO_STRING)
+#undef TYPE_PRIMITIVE_TO_STRING
+};
+
+const struct Array g_TYPE_PRIMITIVE_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_TYPE_PRIMITIVE_NAMES_INTERNAL,
+						sizeof(g_TYPE_PRIMITIVE_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* type_primitive_get_name(const enum TypePrimitives PRIMITIVE) {
+	if ((size_t)PRIMITIVE + 1 > g_TYPE_PRIMITIVE_NAMES.length) {
+		PANIC("g_TYPE_PRIMITIVE_NAMES get index out of bounds");
+	}
+
+	return g_TYPE_PRIMITIVE_NAMES._values[PRIMITIVE];
+}
+
+/**
+ * Mixes a value into a hash (FNV-1a over 32 bit words).
+ *
+ * @param hash  The hash so far.
+ * @param value The value to mix in.
+ *
+ * @return The new hash.
+ */
+uint32_t type_table___mix(uint32_t hash, uint32_t value) {
+	return (hash ^ value) * 16777619U;
+}
+
+/**
+ * Inserts a type id into the hash table, without checking for duplicates.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param id     The id of the type.
+ */
+void type_table___insert_slot(struct TypeTable* p_self, type_id_t id) {
+	size_t slot = p_self->types[id].hash & (p_self->slotCount - 1);
+
+	while (p_self->slots[slot]) {
+		slot = (slot + 1) & (p_self->slotCount - 1);
+	}
+
+	p_self->slots[slot] = id;
+}
+
+/**
+ * Doubles the hash table of types.
+ *
+ * @param p_self The current TypeTable struct.
+ */
+void type_table___grow_slots(struct TypeTable* p_self) {
+	free(p_self->slots);
+
+	p_self->slotCount = p_self->slotCount ? p_self->slotCount * 2 : TYPETABLE_INITIAL_CAPACITY;
+	p_self->slots	  = calloc(p_self->slotCount, sizeof(type_id_t));
+
+	if (!p_self->slots) {
+		PANIC("failed to calloc TypeTable slots");
+	}
+
+	for (type_id_t id = 1; id < p_self->typeCount; id++) {
+		type_table___insert_slot(p_self, id);
+	}
+}
+
+/**
+ * Gets the unique id of a type, creating it if it does not exist yet. This is where types are
+ * hash-consed: every constructor goes through here.
+ *
+ * @param p_self    The current TypeTable struct.
+ * @param kind      The kind of the type.
+ * @param primitive The primitive, if the type is a primitive.
+ * @param name      The interned name, if the type has one.
+ * @param p_args    The arguments of the type. Must not point into the table's args array.
+ * @param argCount  The number of arguments.
+ *
+ * @return The id of the type.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+type_id_t type_table___intern(struct TypeTable* p_self, enum TypeKinds kind, uint8_t primitive,
+							  intern_id_t name, const type_id_t* p_args, size_t argCount) {
+	// NOLINTEND(bugprone-easily-swappable-parameters)
+	uint32_t hash = 2166136261U;
+
+	hash = type_table___mix(hash, kind);
+	hash = type_table___mix(hash, primitive);
+	hash = type_table___mix(hash, name);
+
+	for (size_t index = 0; index < argCount; index++) {
+		hash = type_table___mix(hash, p_args[index]);
+	}
+
+	size_t slot = hash & (p_self->slotCount - 1);
+
+	while (p_self->slots[slot]) {
+		const struct Type* lp_type = &p_self->types[p_self->slots[slot]];
+
+		if (lp_type->hash == hash && lp_type->kind == kind && lp_type->primitive == primitive
+			&& lp_type->name == name && lp_type->argCount == argCount
+			&& (argCount == 0
+				|| memcmp(&p_self->args[lp_type->args], p_args, argCount * sizeof(type_id_t))
+					   == 0)) {
+			return p_self->slots[slot];
+		}
+
+		slot = (slot + 1) & (p_self->slotCount - 1);
+	}
+
+	if (p_self->typeCount == UINT32_MAX) {
+		PANIC("too many types");
+	}
+
+	p_self->types = buffer_grow(p_self->types, &p_self->typeCapacity, p_self->typeCount + 1,
+								TYPE_STRUCT_SIZE);
+	p_self->args  = buffer_grow(p_self->args, &p_self->argCapacity, p_self->argCount + argCount,
+								sizeof(type_id_t));
+
+	type_id_t	 id		 = (type_id_t)p_self->typeCount++;
+	struct Type* lp_type = &p_self->types[id];
+
+	lp_type->kind	   = (uint8_t)kind;
+	lp_type->primitive = primitive;
+	lp_type->flags	   = kind == TYPE_PARAMETER	 ? TYPE_FLAG_GENERIC
+						 : kind == TYPE_VARIABLE ? TYPE_FLAG_VARIABLE
+												 : 0;
+	lp_type->name	   = name;
+	lp_type->hash	   = hash;
+	lp_type->argCount  = (uint32_t)argCount;
+	lp_type->args	   = (uint32_t)p_self->argCount;
+
+	for (size_t index = 0; index < argCount; index++) {
+		p_self->args[p_self->argCount++] = p_args[index];
+		lp_type->flags |= p_self->types[p_args[index]].flags;
+	}
+
+	p_self->slots[slot] = id;
+
+	if (p_self->typeCount * 2 > p_self->slotCount) { // Keep the load factor at or below 0.5
+		type_table___grow_slots(p_self);
+	}
+
+	return id;
+}
+
+struct TypeTable* type_table_new(struct Interner* p_interner) {
+	struct TypeTable* lp_self = calloc(1, TYPETABLE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc TypeTable struct");
+	}
+
+	lp_self->interner = p_interner;
+	lp_self->types	  = buffer_grow(NULL, &lp_self->typeCapacity, TYPETABLE_INITIAL_CAPACITY,
+									TYPE_STRUCT_SIZE);
+	lp_self->typeCount = 1; // Reserve TYPE_ID_NONE
+
+	type_table___grow_slots(lp_self);
+
+	for (uint8_t primitive = 0; primitive < TYPE_PRIMITIVE_COUNT; primitive++) {
+		type_table___intern(lp_self, TYPE_PRIMITIVE, primitive, INTERN_ID_NONE, NULL, 0);
+	}
+
+	return lp_self;
+}
+
+void type_table_free(struct TypeTable** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->types);
+		free((*p_self)->args);
+		free((*p_self)->slots);
+		free((*p_self)->substitutions);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("TypeTable struct has already been freed");
+	}
+}
+
+const struct Type* type_table_get(const struct TypeTable* p_self, type_id_t id) {
+	if (id == TYPE_ID_NONE || id >= p_self->typeCount) {
+		PANIC("TypeTable get id out of bounds");
+	}
+
+	return &p_self->types[id];
+}
+
+const type_id_t* type_table_get_args(const struct TypeTable* p_self, type_id_t id) {
+	return &p_self->args[type_table_get(p_self, id)->args];
+}
+
+type_id_t type_table_primitive_by_name(const struct TypeTable* p_self, const char* p_name) {
+	(void)p_self;
+
+	if (strcmp(p_name, TYPE_STRING_NAME) == 0) {
+		return TYPE_ID_PRIMITIVE(TYPE_PRIMITIVE_STR);
+	}
+
+	for (size_t primitive = 0; primitive < TYPE_PRIMITIVE_COUNT; primitive++) {
+		if (strcmp(g_TYPE_PRIMITIVE_NAMES._values[primitive], p_name) == 0) {
+			return TYPE_ID_PRIMITIVE(primitive);
+		}
+	}
+
+	return TYPE_ID_NONE;
+}
+
+type_id_t type_table_named(struct TypeTable* p_self, intern_id_t name, const type_id_t* p_args,
+						   size_t argCount) {
+	return type_table___intern(p_self, TYPE_NAMED, 0, name, p_args, argCount);
+}
+
+type_id_t type_table_parameter(struct TypeTable* p_self, intern_id_t name, type_id_t bound) {
+	return type_table___intern(p_self, TYPE_PARAMETER, 0, name, &bound,
+							   bound == TYPE_ID_NONE ? 0 : 1);
+}
+
+/**
+ * Compares two type ids, for qsort.
+ *
+ * @param p_a The first type id.
+ * @param p_b The second type id.
+ *
+ * @return The comparison.
+ */
+int type_table___compare_ids(const void* p_a, const void* p_b) {
+	type_id_t a = *(const type_id_t*)p_a;
+	type_id_t b = *(const type_id_t*)p_b;
+
+	return (a > b) - (a < b);
+}
+
+type_id_t type_table_union(struct TypeTable* p_self, const type_id_t* p_members,
+						   size_t memberCount) {
+	size_t memberCapacity = 0;
+	size_t flatCount	  = 0;
+
+	for (size_t index = 0; index < memberCount; index++) {
+		const struct Type* lp_member = type_table_get(p_self, p_members[index]);
+
+		memberCapacity += lp_member->kind == TYPE_UNION ? lp_member->argCount : 1;
+	}
+
+	type_id_t* lp_flat = malloc((memberCapacity ? memberCapacity : 1) * sizeof(type_id_t));
+
+	if (!lp_flat) {
+		PANIC("failed to malloc union members");
+	}
+
+	for (size_t index = 0; index < memberCount; index++) { // Members are already flat
+		const struct Type* lp_member = type_table_get(p_self, p_members[index]);
+
+		if (lp_member->kind == TYPE_UNION) {
+			memcpy(&lp_flat[flatCount], &p_self->args[lp_member->args],
+				   lp_member->argCount * sizeof(type_id_t));
+			flatCount += lp_member->argCount;
+		} else {
+			lp_flat[flatCount++] = p_members[index];
+		}
+	}
+
+	qsort(lp_flat, flatCount, sizeof(type_id_t), type_table___compare_ids);
+
+	size_t uniqueCount = 0;
+
+	for (size_t index = 0; index < flatCount; index++) {
+		if (uniqueCount == 0 || lp_flat[uniqueCount - 1] != lp_flat[index]) {
+			lp_flat[uniqueCount++] = lp_flat[index];
+		}
+	}
+
+	type_id_t id = uniqueCount == 1
+					 ? lp_flat[0]
+					 : type_table___intern(p_self, TYPE_UNION, 0, INTERN_ID_NONE, lp_flat,
+										   uniqueCount);
+
+	free(lp_flat);
+
+	return id;
+}
+
+type_id_t type_table_function(struct TypeTable* p_self, const type_id_t* p_params,
+							  size_t paramCount, type_id_t result) {
+	type_id_t* lp_args = malloc((paramCount + 1) * sizeof(type_id_t));
+
+	if (!lp_args) {
+		PANIC("failed to malloc function type arguments");
+	}
+
+	if (paramCount) {
+		memcpy(lp_args, p_params, paramCount * sizeof(type_id_t));
+	}
+
+	lp_args[paramCount] = result;
+
+	type_id_t id =
+		type_table___intern(p_self, TYPE_FUNCTION, 0, INTERN_ID_NONE, lp_args, paramCount + 1);
+
+	free(lp_args);
+
+	return id;
+}
+
+type_id_t type_table_tuple(struct TypeTable* p_self, const type_id_t* p_members,
+						   size_t memberCount) {
+	return type_table___intern(p_self, TYPE_TUPLE, 0, INTERN_ID_NONE, p_members, memberCount);
+}
+
+type_id_t type_table_variable(struct TypeTable* p_self, uint32_t index) {
+	return type_table___intern(p_self, TYPE_VARIABLE, 0, index, NULL, 0);
+}
+
+type_id_t type_table_vector(struct TypeTable* p_self, const enum TypePrimitives ELEMENT,
+							uint32_t lanes) {
+	return type_table___intern(p_self, TYPE_VECTOR, (uint8_t)ELEMENT, lanes, NULL, 0);
+}
+
+type_id_t type_table_rebuild(struct TypeTable* p_self, type_id_t type, const type_id_t* p_args) {
+	struct Type original = *type_table_get(p_self, type);
+
+	if (original.kind == TYPE_UNION) { // Members can have become equal
+		return type_table_union(p_self, p_args, original.argCount);
+	}
+
+	return type_table___intern(p_self, original.kind, original.primitive, original.name, p_args,
+							   original.argCount);
+}
+
+/**
+ * Finds the memo slot of a substitution, or the empty slot it would be inserted into.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param type   The type substituted in.
+ * @param params The tuple of type parameters.
+ * @param args   The tuple of type arguments.
+ *
+ * @return The memo slot.
+ */
+struct TypeSubstitution* type_table___find_substitution(struct TypeTable* p_self, type_id_t type,
+														type_id_t params, type_id_t args) {
+	uint32_t hash = type_table___mix(type_table___mix(type_table___mix(2166136261U, type), params),
+									 args);
+	size_t	 slot = hash & (p_self->substitutionSlotCount - 1);
+
+	while (p_self->substitutions[slot].type) {
+		const struct TypeSubstitution* lp_substitution = &p_self->substitutions[slot];
+
+		if (lp_substitution->type == type && lp_substitution->params == params
+			&& lp_substitution->args == args) {
+			break;
+		}
+
+		slot = (slot + 1) & (p_self->substitutionSlotCount - 1);
+	}
+
+	return &p_self->substitutions[slot];
+}
+
+/**
+ * Memoizes a substitution, growing the memo if needed.
+ *
+ * @param p_self       The current TypeTable struct.
+ * @param substitution The substitution.
+ */
+void type_table___memoize(struct TypeTable* p_self, struct TypeSubstitution substitution) {
+	if ((p_self->substitutionCount + 1) * 2 > p_self->substitutionSlotCount) {
+		struct TypeSubstitution* lp_old		  = p_self->substitutions;
+		size_t					 oldSlotCount = p_self->substitutionSlotCount;
+
+		p_self->substitutionSlotCount =
+			oldSlotCount ? oldSlotCount * 2 : TYPETABLE_INITIAL_CAPACITY;
+		p_self->substitutions =
+			calloc(p_self->substitutionSlotCount, sizeof(struct TypeSubstitution));
+
+		if (!p_self->substitutions) {
+			PANIC("failed to calloc TypeTable substitutions");
+		}
+
+		for (size_t slot = 0; slot < oldSlotCount; slot++) {
+			if (lp_old[slot].type) {
+				*type_table___find_substitution(p_self, lp_old[slot].type, lp_old[slot].params,
+												lp_old[slot].args) = lp_old[slot];
+			}
+		}
+
+		free(lp_old);
+	}
+
+	*type_table___find_substitution(p_self, substitution.type, substitution.params,
+									substitution.args) = substitution;
+	p_self->substitutionCount++;
+}
+
+type_id_t type_table_substitute(struct TypeTable* p_self, type_id_t type, type_id_t params,
+								type_id_t args) {
+	if (!(type_table_get(p_self, type)->flags & TYPE_FLAG_GENERIC)) {
+		return type;
+	}
+
+	if (p_self->substitutionSlotCount) {
+		const struct TypeSubstitution* lp_memo =
+			type_table___find_substitution(p_self, type, params, args);
+
+		if (lp_memo->type) {
+			return lp_memo->result;
+		}
+	}
+
+	struct Type original = *type_table_get(p_self, type); // Copied, creating types moves the table
+	type_id_t	result	 = type;
+
+	if (original.kind == TYPE_PARAMETER) {
+		const struct Type* lp_params = type_table_get(p_self, params);
+
+		for (uint32_t index = 0; index < lp_params->argCount; index++) {
+			if (p_self->args[lp_params->args + index] == type) {
+				result = type_table_get_args(p_self, args)[index];
+				break;
+			}
+		}
+
+		if (result == type && original.argCount) { // Not replaced, but its bound may be generic
+			result = type_table_parameter(
+				p_self, original.name,
+				type_table_substitute(p_self, p_self->args[original.args], params, args));
+		}
+	} else {
+		type_id_t* lp_args =
+			malloc((original.argCount ? original.argCount : 1) * sizeof(type_id_t));
+
+		if (!lp_args) {
+			PANIC("failed to malloc substituted type arguments");
+		}
+
+		for (uint32_t index = 0; index < original.argCount; index++) {
+			lp_args[index] =
+				type_table_substitute(p_self, p_self->args[original.args + index], params, args);
+		}
+
+		result = type_table_rebuild(p_self, type, lp_args);
+
+		free(lp_args);
+	}
+
+	type_table___memoize(p_self, (struct TypeSubstitution){type, params, args, result});
+
+	return result;
+}
+
+/**
+ * Appends the source representation of a list of types.
+ *
+ * @param p_self      The current TypeTable struct.
+ * @param p_string    The String struct to append to.
+ * @param p_args      The types.
+ * @param argCount    The number of types.
+ * @param p_separator The separator between types.
+ */
+void type_table___append_list(const struct TypeTable* p_self, struct String* p_string,
+							  const type_id_t* p_args, size_t argCount, const char* p_separator);
+
+/**
+ * Appends the source representation of a type.
+ *
+ * @param p_self   The current TypeTable struct.
+ * @param p_string The String struct to append to.
+ * @param id       The id of the type.
+ */
+void type_table___append(const struct TypeTable* p_self, struct String* p_string, type_id_t id) {
+	if (id == TYPE_ID_NONE) {
+		string_append_str(p_string, "?");
+		return;
+	}
+
+	const struct Type* lp_type = type_table_get(p_self, id);
+	const type_id_t*   lp_args = &p_self->args[lp_type->args];
+
+	switch (lp_type->kind) {
+	case TYPE_PRIMITIVE:
+		string_append_str(p_string, type_primitive_get_name(lp_type->primitive));
+		break;
+	case TYPE_NAMED:
+		string_append_str(p_string, interner_get(p_self->interner, lp_type->name));
+
+		if (lp_type->argCount) {
+			string_append_chr(p_string, '<');
+			type_table___append_list(p_self, p_string, lp_args, lp_type->argCount, ", ");
+			string_append_chr(p_string, '>');
+		}
+		break;
+	case TYPE_PARAMETER:
+		string_append_str(p_string, interner_get(p_self->interner, lp_type->name));
+		break;
+	case TYPE_UNION:
+		type_table___append_list(p_self, p_string, lp_args, lp_type->argCount, "|");
+		break;
+	case TYPE_FUNCTION:
+		string_append_str(p_string, "func(");
+		type_table___append_list(p_self, p_string, lp_args, lp_type->argCount - 1, ", ");
+		string_append_str(p_string, ") -> ");
+		type_table___append(p_self, p_string, lp_args[lp_type->argCount - 1]);
+		break;
+	case TYPE_TUPLE:
+		string_append_chr(p_string, '(');
+		type_table___append_list(p_self, p_string, lp_args, lp_type->argCount, ", ");
+		string_append_chr(p_string, ')');
+		break;
+	case TYPE_VARIABLE: {
+		char* lp_index = ul_to_string(lp_type->name);
+
+		string_append_chr(p_string, '?');
+		string_append_str(p_string, lp_index);
+
+		free(lp_index);
+		break;
+	}
+	case TYPE_VECTOR: {
+		char* lp_lanes = ul_to_string(lp_type->name);
+
+		string_append_str(p_string, "Vec<");
+		string_append_str(p_string, type_primitive_get_name(lp_type->primitive));
+		string_append_str(p_string, ", ");
+		string_append_str(p_string, lp_lanes);
+		string_append_chr(p_string, '>');
+
+		free(lp_lanes);
+		break;
+	}
+	default:
+		PANIC("unknown type kind");
+	}
+}
+
+void type_table___append_list(const struct TypeTable* p_self, struct String* p_string,
+							  const type_id_t* p_args, size_t argCount, const char* p_separator) {
+	for (size_t index = 0; index < argCount; index++) {
+		if (index) {
+			string_append_str(p_string, p_separator);
+		}
+
+		type_table___append(p_self, p_string, p_args[index]);
+	}
+}
+
+char* type_table_to_string(const struct TypeTable* p_self, type_id_t id) {
+	struct String* lp_string = string_new("", true);
+
+	type_table___append(p_self, lp_string, id);
+
+	char* lp_value	  = lp_string->_value;
+	lp_string->_value = NULL;
+	free(lp_string);
+
+	return lp_value;
+}
+
+/**
+ * Parses a type made of primitives and functions, advancing past it.
+ *
+ * @param p_self   The current TypeTable struct.
+ * @param p_cursor The representation, e.g. 'func(i64, str) -> bool'.
+ *
+ * @return The type, or TYPE_ID_NONE if it is not made of primitives and functions.
+ */
+type_id_t type_table___parse(struct TypeTable* p_self, const char** p_cursor) {
+	const char* lp_cursor = *p_cursor;
+
+	if (strncmp(lp_cursor, "func(", strlen("func(")) != 0) { // e.g. 'i64'
+		char   name[TYPETABLE_PARSE_NAME];
+		size_t length = strcspn(lp_cursor, ",) ");
+
+		if (length >= sizeof(name)) {
+			return TYPE_ID_NONE;
+		}
+
+		memcpy(name, lp_cursor, length);
+		name[length] = '\0';
+		*p_cursor += length;
+
+		return type_table_primitive_by_name(p_self, name);
+	}
+
+	type_id_t params[TYPETABLE_PARSE_PARAMS];
+	size_t	  count = 0;
+
+	lp_cursor += strlen("func(");
+
+	while (*lp_cursor != ')') {
+		if (count == TYPETABLE_PARSE_PARAMS
+			|| (params[count++] = type_table___parse(p_self, &lp_cursor)) == TYPE_ID_NONE) {
+			return TYPE_ID_NONE;
+		}
+
+		if (strncmp(lp_cursor, ", ", 2) == 0) {
+			lp_cursor += 2;
+		} else if (*lp_cursor != ')') {
+			return TYPE_ID_NONE;
+		}
+	}
+
+	if (strncmp(lp_cursor, ") -> ", strlen(") -> ")) != 0) {
+		return TYPE_ID_NONE;
+	}
+
+	lp_cursor += strlen(") -> ");
+
+	type_id_t result = type_table___parse(p_self, &lp_cursor);
+
+	*p_cursor = lp_cursor;
+
+	return result == TYPE_ID_NONE ? TYPE_ID_NONE
+								  : type_table_function(p_self, params, count, result);
+}
+
+type_id_t type_table_parse(struct TypeTable* p_self, const char* p_string) {
+	type_id_t type = type_table___parse(p_self, &p_string);
+
+	return *p_string ? TYPE_ID_NONE : type;
+}
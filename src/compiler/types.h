@@ -0,0 +1,297 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../utils/intern.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Identifies a type in a TypeTable. Every structurally distinct type has exactly one id, so two
+ * types are equal iff their ids are.
+ */
+typedef uint32_t type_id_t;
+
+#define TYPE_ID_NONE 0U
+
+#define TYPE_PRIMITIVES(X)                                                                         \
+	X(VOID, "void")                                                                                \
+	X(BOOL, "bool")                                                                                \
+	X(I8, "i8")                                                                                    \
+	X(I16, "i16")                                                                                  \
+	X(I32, "i32")                                                                                  \
+	X(I64, "i64")                                                                                  \
+	X(U8, "u8")                                                                                    \
+	X(U16, "u16")                                                                                  \
+	X(U32, "u32")                                                                                  \
+	X(U64, "u64")                                                                                  \
+	X(F32, "f32")                                                                                  \
+	X(F64, "f64")                                                                                  \
+	X(CHR, "chr")                                                                                  \
+	X(STR, "str")
+
+#define TYPE_PRIMITIVE_ENUM(name, string) TYPE_PRIMITIVE_##name,
+
+/**
+ * Used to identify the primitive types.
+ */
+enum TypePrimitives { TYPE_PRIMITIVES(TYPE_PRIMITIVE_ENUM) TYPE_PRIMITIVE_COUNT };
+
+#undef TYPE_PRIMITIVE_ENUM
+
+/**
+ * Gets the id of a primitive type. Primitives are created first, so their ids are fixed.
+ */
+#define TYPE_ID_PRIMITIVE(primitive) ((type_id_t)(primitive) + 1U)
+
+/**
+ * Used to identify the kinds of types.
+ */
+enum TypeKinds {
+	TYPE_NONE,
+	TYPE_PRIMITIVE, // primitive
+	TYPE_NAMED,		// name, args = type arguments, e.g. 'Array<T>'
+	TYPE_PARAMETER, // name, args = [bound], e.g. 'T: Int|Float'
+	TYPE_UNION,		// args = members, flattened, sorted and deduplicated
+	TYPE_FUNCTION,	// args = parameters followed by the return type
+	TYPE_TUPLE,		// args = members
+	TYPE_VARIABLE,	// name = index of the inference variable
+	TYPE_VECTOR,	// primitive = element, name = lanes, e.g. 'Vec<f32, 8>'
+};
+
+#define TYPE_VECTOR_NAME	  "Vec" // The name SIMD vector types are written with, e.g. 'Vec<f32, 8>'.
+#define TYPE_VECTOR_MAX_LANES 64U
+
+#define TYPE_STRING_NAME "String" // The name 'std.types.string' gives 'str', e.g. 'String.from'.
+
+#define TYPE_FLAG_GENERIC  0x1U // The type mentions a type parameter.
+#define TYPE_FLAG_VARIABLE 0x2U // The type mentions an inference variable.
+
+/**
+ * Represents a type. Types are immutable once created.
+ */
+struct Type {
+	uint8_t		kind;
+	uint8_t		primitive;
+	uint16_t	flags;
+	intern_id_t name;
+	uint32_t	hash;
+	uint32_t	argCount;
+	uint32_t	args; // The index of the first argument in the table's args array.
+};
+
+#define TYPE_STRUCT_SIZE sizeof(struct Type)
+
+/**
+ * Represents a memoized substitution, 'type' with each of 'params' replaced by 'args'.
+ */
+struct TypeSubstitution {
+	type_id_t type, params, args, result; // params and args are tuple types.
+};
+
+/**
+ * Represents a table of hash-consed types.
+ */
+struct TypeTable {
+	struct Interner*		 interner; // Not owned, used for the names of types.
+	struct Type*			 types;
+	type_id_t*				 args;
+	type_id_t*				 slots; // Open addressing table of type ids, 0 marks an empty slot.
+	struct TypeSubstitution* substitutions; // Open addressing memo, type 0 marks an empty slot.
+	size_t typeCount, typeCapacity, argCount, argCapacity, slotCount;
+	size_t substitutionCount, substitutionSlotCount;
+};
+
+#define TYPETABLE_STRUCT_SIZE sizeof(struct TypeTable)
+
+/**
+ * Gets the name of a primitive type.
+ *
+ * @param PRIMITIVE The primitive type.
+ *
+ * @return The name of the primitive type.
+ */
+const char* type_primitive_get_name(const enum TypePrimitives PRIMITIVE);
+
+/**
+ * Creates a new TypeTable struct, holding the primitive types.
+ *
+ * @param p_interner The interner used for the names of types.
+ *
+ * @return The created TypeTable struct.
+ */
+struct TypeTable* type_table_new(struct Interner* p_interner);
+
+/**
+ * Frees a TypeTable struct.
+ *
+ * @param p_self The current TypeTable struct.
+ */
+void type_table_free(struct TypeTable** p_self);
+
+/**
+ * Gets a type. The pointer is invalidated by the next type created.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param id     The id of the type.
+ *
+ * @return The type.
+ */
+const struct Type* type_table_get(const struct TypeTable* p_self, type_id_t id);
+
+/**
+ * Gets the arguments of a type. The pointer is invalidated by the next type created.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param id     The id of the type.
+ *
+ * @return The arguments of the type.
+ */
+const type_id_t* type_table_get_args(const struct TypeTable* p_self, type_id_t id);
+
+/**
+ * Gets the primitive type with a name, or with TYPE_STRING_NAME for 'str'.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param p_name The name of the primitive type.
+ *
+ * @return The primitive type, or TYPE_ID_NONE if there is none with the name.
+ */
+type_id_t type_table_primitive_by_name(const struct TypeTable* p_self, const char* p_name);
+
+/**
+ * Gets a named type, e.g. 'Stack<T>'.
+ *
+ * @param p_self   The current TypeTable struct.
+ * @param name     The interned name of the type.
+ * @param p_args   The type arguments (can be NULL if there are none).
+ * @param argCount The number of type arguments.
+ *
+ * @return The named type.
+ */
+type_id_t type_table_named(struct TypeTable* p_self, intern_id_t name, const type_id_t* p_args,
+						   size_t argCount);
+
+/**
+ * Gets a type parameter, e.g. 'T: Int|Float'.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param name   The interned name of the type parameter.
+ * @param bound  The bound of the type parameter, or TYPE_ID_NONE if it is unbounded.
+ *
+ * @return The type parameter.
+ */
+type_id_t type_table_parameter(struct TypeTable* p_self, intern_id_t name, type_id_t bound);
+
+/**
+ * Gets a union type. Nested unions are flattened and members are deduplicated, so 'A|B', 'B|A'
+ * and 'A|(B|A)' are the same type, and a union of a single member is that member.
+ *
+ * @param p_self      The current TypeTable struct.
+ * @param p_members   The members of the union.
+ * @param memberCount The number of members.
+ *
+ * @return The union type.
+ */
+type_id_t type_table_union(struct TypeTable* p_self, const type_id_t* p_members,
+						   size_t memberCount);
+
+/**
+ * Gets a function type.
+ *
+ * @param p_self     The current TypeTable struct.
+ * @param p_params   The parameter types (can be NULL if there are none).
+ * @param paramCount The number of parameters.
+ * @param result     The return type.
+ *
+ * @return The function type.
+ */
+type_id_t type_table_function(struct TypeTable* p_self, const type_id_t* p_params,
+							  size_t paramCount, type_id_t result);
+
+/**
+ * Gets a tuple type.
+ *
+ * @param p_self      The current TypeTable struct.
+ * @param p_members   The members of the tuple (can be NULL if there are none).
+ * @param memberCount The number of members.
+ *
+ * @return The tuple type.
+ */
+type_id_t type_table_tuple(struct TypeTable* p_self, const type_id_t* p_members,
+						   size_t memberCount);
+
+/**
+ * Gets an inference variable. Variables are numbered per function being inferred, so the same
+ * few variable types are reused by every function.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param index  The index of the variable.
+ *
+ * @return The inference variable.
+ */
+type_id_t type_table_variable(struct TypeTable* p_self, uint32_t index);
+
+/**
+ * Gets a SIMD vector type, e.g. 'Vec<f32, 8>'.
+ *
+ * @param p_self  The current TypeTable struct.
+ * @param ELEMENT The primitive type of the lanes.
+ * @param lanes   The number of lanes.
+ *
+ * @return The vector type.
+ */
+type_id_t type_table_vector(
+	struct TypeTable* p_self,
+	const enum TypePrimitives ELEMENT, // NOLINT(readability-avoid-const-params-in-decls)
+	uint32_t lanes);
+
+/**
+ * Gets a type of the same kind and name as another, but with different arguments.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param type   The type to rebuild.
+ * @param p_args The new arguments, as many as the type has. Must not point into the table.
+ *
+ * @return The rebuilt type.
+ */
+type_id_t type_table_rebuild(struct TypeTable* p_self, type_id_t type, const type_id_t* p_args);
+
+/**
+ * Substitutes type parameters in a type. Results are memoized, and types without type parameters
+ * are returned as is without a lookup.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param type   The type to substitute in.
+ * @param params A tuple of the type parameters to replace.
+ * @param args   A tuple of the types to replace them with.
+ *
+ * @return The substituted type.
+ */
+type_id_t type_table_substitute(struct TypeTable* p_self, type_id_t type, type_id_t params,
+								type_id_t args);
+
+/**
+ * Gets the source representation of a type, for diagnostics and reports.
+ *
+ * @param p_self The current TypeTable struct.
+ * @param id     The id of the type.
+ *
+ * @return The representation of the type.
+ */
+char* type_table_to_string(const struct TypeTable* p_self, type_id_t id);
+
+/**
+ * Parses the source representation of a type made of primitives and functions, as written by
+ * type_table_to_string, e.g. for the signatures in interfaces.
+ *
+ * @param p_self   The current TypeTable struct.
+ * @param p_string The representation, e.g. 'func(i64) -> i64'.
+ *
+ * @return The type, or TYPE_ID_NONE if it mentions other types, e.g. structs or type parameters.
+ */
+type_id_t type_table_parse(struct TypeTable* p_self, const char* p_string);
@@ -0,0 +1,425 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./vtable.h"
+#include "../globals.h"
+#include "../utils/buffer.h"
+#include "../utils/conversions.h"
+#include "../utils/panic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VTABLE_INITIAL_CAPACITY 64U
+
+/**
+ * Hashes a (type, trait) pair.
+ *
+ * @param trait The index of the trait.
+ * @param type  The type.
+ *
+ * @return The hash.
+ */
+uint32_t vtable___hash(uint32_t trait, type_id_t type) {
+	return ((type * 16777619U) ^ trait) * 2654435761U;
+}
+
+/**
+ * Rebuilds the vtable index with double the slots.
+ *
+ * @param p_self The current VtableTable struct.
+ */
+void vtable___grow_slots(struct VtableTable* p_self) {
+	free(p_self->slots);
+
+	p_self->slotCount = p_self->slotCount ? p_self->slotCount * 2 : VTABLE_INITIAL_CAPACITY;
+	p_self->slots	  = calloc(p_self->slotCount, sizeof(uint32_t));
+
+	if (!p_self->slots) {
+		PANIC("failed to calloc VtableTable slots");
+	}
+
+	for (uint32_t index = 0; index < p_self->vtableCount; index++) {
+		size_t slot = vtable___hash(p_self->vtables[index].trait, p_self->vtables[index].type)
+					  & (p_self->slotCount - 1);
+
+		while (p_self->slots[slot]) {
+			slot = (slot + 1) & (p_self->slotCount - 1);
+		}
+
+		p_self->slots[slot] = index + 1;
+	}
+}
+
+/**
+ * Finds the slot of a (type, trait) pair's vtable, or the empty slot it would be inserted into.
+ *
+ * @param p_self The current VtableTable struct.
+ * @param trait  The index of the trait.
+ * @param type   The type.
+ *
+ * @return The slot.
+ */
+size_t vtable___find_slot(const struct VtableTable* p_self, uint32_t trait, type_id_t type) {
+	size_t slot = vtable___hash(trait, type) & (p_self->slotCount - 1);
+
+	while (p_self->slots[slot]) {
+		const struct Vtable* lp_vtable = &p_self->vtables[p_self->slots[slot] - 1];
+
+		if (lp_vtable->trait == trait && lp_vtable->type == type) {
+			break;
+		}
+
+		slot = (slot + 1) & (p_self->slotCount - 1);
+	}
+
+	return slot;
+}
+
+struct VtableTable* vtable_table_new(struct TypeTable* p_types, struct Interner* p_interner) {
+	struct VtableTable* lp_self = calloc(1, VTABLETABLE_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc VtableTable struct");
+	}
+
+	lp_self->types	  = p_types;
+	lp_self->interner = p_interner;
+
+	vtable___grow_slots(lp_self);
+
+	return lp_self;
+}
+
+void vtable_table_free(struct VtableTable** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->traits);
+		free((*p_self)->methods);
+		free((*p_self)->vtables);
+		free((*p_self)->slots);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("VtableTable struct has already been freed");
+	}
+}
+
+/**
+ * Appends the name of one of a trait's types, e.g. '%"Container<i32>.vtable"'.
+ *
+ * @param p_self   The current VtableTable struct.
+ * @param trait    The index of the trait.
+ * @param p_suffix The suffix of the type, 'vtable' or 'dyn'.
+ * @param p_output Where to append the name.
+ */
+void vtable___append_type(const struct VtableTable* p_self, uint32_t trait, const char* p_suffix,
+						  struct String* p_output) {
+	char* lp_trait = type_table_to_string(p_self->types, p_self->traits[trait].type);
+
+	string_append_str(p_output, "%\"");
+	string_append_str(p_output, lp_trait);
+	string_append_chr(p_output, '.');
+	string_append_str(p_output, p_suffix);
+	string_append_chr(p_output, '"');
+
+	free(lp_trait);
+}
+
+/**
+ * Appends the type of a method with its receiver erased, e.g. 'double (i8*, i32)'.
+ *
+ * @param p_self   The current VtableTable struct.
+ * @param p_method The method.
+ * @param p_output Where to append the type.
+ */
+void vtable___append_method_type(const struct VtableTable* p_self,
+								 const struct VtableMethod* p_method, struct String* p_output) {
+	const char* lp_params = interner_get(p_self->interner, p_method->paramTypes);
+
+	string_append_str(p_output, interner_get(p_self->interner, p_method->returnType));
+	string_append_str(p_output, " (i8*");
+
+	if (*lp_params) {
+		string_append_str(p_output, ", ");
+		string_append_str(p_output, lp_params);
+	}
+
+	string_append_chr(p_output, ')');
+}
+
+uint32_t vtable_table_declare_trait(struct VtableTable* p_self, type_id_t type,
+									const struct VtableMethod* p_methods, size_t count,
+									struct String* p_output) {
+	if (vtable_table_find_trait(p_self, type) != VTABLE_TRAIT_NONE) {
+		PANIC("VtableTable trait has already been declared");
+	}
+
+	p_self->traits	= buffer_grow(p_self->traits, &p_self->traitCapacity, p_self->traitCount + 1,
+								  VTABLE_TRAIT_SIZE);
+	p_self->methods = buffer_grow(p_self->methods, &p_self->methodCapacity,
+								  p_self->methodCount + count, VTABLE_METHOD_SIZE);
+
+	uint32_t trait = (uint32_t)p_self->traitCount++;
+
+	p_self->traits[trait].type		  = type;
+	p_self->traits[trait].methodStart = (uint32_t)p_self->methodCount;
+	p_self->traits[trait].methodCount = (uint32_t)count;
+
+	memcpy(&p_self->methods[p_self->methodCount], p_methods, count * VTABLE_METHOD_SIZE);
+	p_self->methodCount += count;
+
+	// %"Trait.vtable" = type { double (i8*)*, ... }
+	vtable___append_type(p_self, trait, "vtable", p_output);
+	string_append_str(p_output, " = type {");
+
+	for (size_t index = 0; index < count; index++) {
+		string_append_str(p_output, index ? ", " : " ");
+		vtable___append_method_type(p_self, &p_methods[index], p_output);
+		string_append_chr(p_output, '*');
+	}
+
+	string_append_str(p_output, count ? " }\n" : "}\n");
+
+	// %"Trait.dyn" = type { i8*, %"Trait.vtable"* }
+	vtable___append_type(p_self, trait, "dyn", p_output);
+	string_append_str(p_output, " = type { i8*, ");
+	vtable___append_type(p_self, trait, "vtable", p_output);
+	string_append_str(p_output, "* }\n");
+
+	return trait;
+}
+
+uint32_t vtable_table_find_trait(const struct VtableTable* p_self, type_id_t type) {
+	for (uint32_t trait = 0; trait < p_self->traitCount; trait++) {
+		if (p_self->traits[trait].type == type) { // Types are hash-consed, so equal types are equal
+			return trait;
+		}
+	}
+
+	return VTABLE_TRAIT_NONE;
+}
+
+uint32_t vtable_table_find_method(const struct VtableTable* p_self, uint32_t trait,
+								  intern_id_t name) {
+	const struct VtableTrait* lp_trait = &p_self->traits[trait];
+
+	for (uint32_t method = 0; method < lp_trait->methodCount; method++) {
+		if (p_self->methods[lp_trait->methodStart + method].name == name) {
+			return method;
+		}
+	}
+
+	return VTABLE_METHOD_NONE;
+}
+
+/**
+ * Appends the symbol of a vtable.
+ *
+ * @param p_self   The current VtableTable struct.
+ * @param symbol   The interned symbol.
+ * @param p_output Where to append the symbol.
+ */
+void vtable___append_symbol(const struct VtableTable* p_self, intern_id_t symbol,
+							struct String* p_output) {
+	string_append_str(p_output, "@\"");
+	string_append_str(p_output, interner_get(p_self->interner, symbol));
+	string_append_chr(p_output, '"');
+}
+
+intern_id_t vtable_table_emit(struct VtableTable* p_self, uint32_t trait, type_id_t type,
+							  const struct VtableEntry* p_entries, struct String* p_output) {
+	size_t slot = vtable___find_slot(p_self, trait, type);
+
+	if (p_self->slots[slot]) {
+		return p_self->vtables[p_self->slots[slot] - 1].symbol;
+	}
+
+	const struct VtableTrait* lp_trait	= &p_self->traits[trait];
+	char*					  lp_type	= type_table_to_string(p_self->types, type);
+	char*					  lp_name	= type_table_to_string(p_self->types, lp_trait->type);
+	char*					  lp_symbol = CONCATENATE_STRING(lp_type, ".", lp_name, ".vtable");
+
+	p_self->vtables = buffer_grow(p_self->vtables, &p_self->vtableCapacity, p_self->vtableCount + 1,
+								  VTABLE_SIZE);
+
+	struct Vtable* lp_vtable = &p_self->vtables[p_self->vtableCount];
+
+	lp_vtable->trait  = trait;
+	lp_vtable->type	  = type;
+	lp_vtable->symbol = interner_intern(p_self->interner, lp_symbol);
+
+	p_self->slots[slot] = (uint32_t)++p_self->vtableCount;
+
+	free(lp_type);
+	free(lp_name);
+	free(lp_symbol);
+
+	// @"Type.Trait.vtable" = internal unnamed_addr constant %"Trait.vtable" { ... }
+	vtable___append_symbol(p_self, lp_vtable->symbol, p_output);
+	string_append_str(p_output, " = internal unnamed_addr constant ");
+	vtable___append_type(p_self, trait, "vtable", p_output);
+	string_append_str(p_output, " {");
+
+	for (uint32_t index = 0; index < lp_trait->methodCount; index++) {
+		struct String* lp_erased = string_new("\0", true);
+
+		vtable___append_method_type(p_self, &p_self->methods[lp_trait->methodStart + index],
+									lp_erased);
+
+		string_append_str(p_output, index ? ", " : " ");
+		string_append_str(p_output, lp_erased->_value);
+		string_append_str(p_output, "* ");
+
+		if (strcmp(lp_erased->_value, p_entries[index].llvmType) == 0) {
+			string_append_str(p_output, "@\"");
+			string_append_str(p_output, p_entries[index].symbol);
+			string_append_chr(p_output, '"');
+		} else { // The receiver is a typed pointer, which the vtable entry erases
+			string_append_str(p_output, "bitcast (");
+			string_append_str(p_output, p_entries[index].llvmType);
+			string_append_str(p_output, "* @\"");
+			string_append_str(p_output, p_entries[index].symbol);
+			string_append_str(p_output, "\" to ");
+			string_append_str(p_output, lp_erased->_value);
+			string_append_str(p_output, "*)");
+		}
+
+		string_free(&lp_erased);
+	}
+
+	string_append_str(p_output, lp_trait->methodCount ? " }\n" : "}\n");
+
+	if (p_self->vtableCount * 2 > p_self->slotCount) { // Keep the load factor at or below 0.5
+		vtable___grow_slots(p_self);
+	}
+
+	return lp_vtable->symbol;
+}
+
+void vtable_table_emit_object(struct VtableTable* p_self, uint32_t trait, type_id_t type,
+							  const char* p_data, const char* p_result, struct String* p_output) {
+	size_t slot = vtable___find_slot(p_self, trait, type);
+
+	if (!p_self->slots[slot]) {
+		PANIC("VtableTable vtable has not been emitted");
+	}
+
+	char* lp_temporary = ul_to_string(p_self->temporaries++);
+
+	// %vt.N = insertvalue %"Trait.dyn" undef, i8* %data, 0
+	string_append_str(p_output, "  %vt.");
+	string_append_str(p_output, lp_temporary);
+	string_append_str(p_output, " = insertvalue ");
+	vtable___append_type(p_self, trait, "dyn", p_output);
+	string_append_str(p_output, " undef, i8* ");
+	string_append_str(p_output, p_data);
+	string_append_str(p_output, ", 0\n");
+
+	// %result = insertvalue %"Trait.dyn" %vt.N, %"Trait.vtable"* @"Type.Trait.vtable", 1
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, p_result);
+	string_append_str(p_output, " = insertvalue ");
+	vtable___append_type(p_self, trait, "dyn", p_output);
+	string_append_str(p_output, " %vt.");
+	string_append_str(p_output, lp_temporary);
+	string_append_str(p_output, ", ");
+	vtable___append_type(p_self, trait, "vtable", p_output);
+	string_append_str(p_output, "* ");
+	vtable___append_symbol(p_self, p_self->vtables[p_self->slots[slot] - 1].symbol, p_output);
+	string_append_str(p_output, ", 1\n");
+
+	free(lp_temporary);
+}
+
+void vtable_table_emit_call(struct VtableTable* p_self, uint32_t trait, uint32_t method,
+							const char* p_object, const char* p_args, const char* p_result,
+							struct String* p_output) {
+	const struct VtableTrait*  lp_trait = &p_self->traits[trait];
+	const struct VtableMethod* lp_method;
+	char					   temporaries[4][MAX_STRING_LENGTH];
+
+	if (method >= lp_trait->methodCount) {
+		PANIC("VtableTable method index out of bounds");
+	}
+
+	lp_method = &p_self->methods[lp_trait->methodStart + method];
+
+	for (size_t index = 0; index < 4; index++) {
+		snprintf(temporaries[index], MAX_STRING_LENGTH, "%%vt.%zu", p_self->temporaries++);
+	}
+
+	struct String* lp_type = string_new("\0", true);
+	char*		   lp_slot = ul_to_string(method);
+
+	vtable___append_method_type(p_self, lp_method, lp_type);
+
+	// %data = extractvalue %"Trait.dyn" %object, 0
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, temporaries[0]);
+	string_append_str(p_output, " = extractvalue ");
+	vtable___append_type(p_self, trait, "dyn", p_output);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, p_object);
+	string_append_str(p_output, ", 0\n");
+
+	// %vtable = extractvalue %"Trait.dyn" %object, 1
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, temporaries[1]);
+	string_append_str(p_output, " = extractvalue ");
+	vtable___append_type(p_self, trait, "dyn", p_output);
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, p_object);
+	string_append_str(p_output, ", 1\n");
+
+	// %entry = getelementptr inbounds %"Trait.vtable", %"Trait.vtable"* %vtable, i32 0, i32 SLOT
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, temporaries[2]);
+	string_append_str(p_output, " = getelementptr inbounds ");
+	vtable___append_type(p_self, trait, "vtable", p_output);
+	string_append_str(p_output, ", ");
+	vtable___append_type(p_self, trait, "vtable", p_output);
+	string_append_str(p_output, "* ");
+	string_append_str(p_output, temporaries[1]);
+	string_append_str(p_output, ", i32 0, i32 ");
+	string_append_str(p_output, lp_slot);
+	string_append_chr(p_output, '\n');
+
+	// %function = load RET (i8*, ...)*, RET (i8*, ...)** %entry
+	string_append_str(p_output, "  ");
+	string_append_str(p_output, temporaries[3]);
+	string_append_str(p_output, " = load ");
+	string_append_str(p_output, lp_type->_value);
+	string_append_str(p_output, "*, ");
+	string_append_str(p_output, lp_type->_value);
+	string_append_str(p_output, "** ");
+	string_append_str(p_output, temporaries[2]);
+	string_append_chr(p_output, '\n');
+
+	// %result = call RET %function(i8* %data, ...)
+	string_append_str(p_output, "  ");
+
+	if (p_result) {
+		string_append_str(p_output, p_result);
+		string_append_str(p_output, " = ");
+	}
+
+	string_append_str(p_output, "call ");
+	string_append_str(p_output, interner_get(p_self->interner, lp_method->returnType));
+	string_append_chr(p_output, ' ');
+	string_append_str(p_output, temporaries[3]);
+	string_append_str(p_output, "(i8* ");
+	string_append_str(p_output, temporaries[0]);
+
+	if (*p_args) {
+		string_append_str(p_output, ", ");
+		string_append_str(p_output, p_args);
+	}
+
+	string_append_str(p_output, ")\n");
+
+	string_free(&lp_type);
+	free(lp_slot);
+}
@@ -0,0 +1,177 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./types.h"
+#include "../utils/intern.h"
+#include "../utils/str.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define VTABLE_TRAIT_NONE  UINT32_MAX
+#define VTABLE_METHOD_NONE UINT32_MAX
+
+/**
+ * Represents a method of a trait, with the receiver erased to 'i8*'.
+ */
+struct VtableMethod {
+	intern_id_t name;
+	intern_id_t returnType; // LLVM type, e.g. 'double'.
+	intern_id_t paramTypes; // LLVM types of the parameters after the receiver, e.g. 'i32, i32'.
+};
+
+#define VTABLE_METHOD_SIZE sizeof(struct VtableMethod)
+
+/**
+ * Represents an instantiated trait, e.g. 'Container<i32>', whose methods are a slice of the methods
+ * array in declaration order. Each instantiation of a generic trait is a trait of its own, as its
+ * methods have different types.
+ */
+struct VtableTrait {
+	type_id_t type;
+	uint32_t  methodStart, methodCount;
+};
+
+#define VTABLE_TRAIT_SIZE sizeof(struct VtableTrait)
+
+/**
+ * Represents the vtable of a (type, trait) pair.
+ */
+struct Vtable {
+	uint32_t	trait; // Index of the trait.
+	type_id_t	type;
+	intern_id_t symbol;
+};
+
+#define VTABLE_SIZE sizeof(struct Vtable)
+
+/**
+ * Represents an implementation of a trait method, in the order of the trait's methods.
+ */
+struct VtableEntry {
+	const char* symbol;	  // The implementing function, e.g. 'Circle.area'.
+	const char* llvmType; // Its LLVM type, e.g. 'double (%Circle*)'.
+};
+
+/**
+ * Represents the vtables of a module. A trait object is a fat pointer '%"Trait.dyn"' made of the
+ * data pointer and a pointer to a read-only vtable, emitted once per (type, trait) pair with the
+ * methods in declaration order. Calling a method is therefore a load from a constant offset of the
+ * vtable and an indirect call, with no lookup by name at runtime.
+ */
+struct VtableTable {
+	struct TypeTable*	 types;
+	struct Interner*	 interner;
+	struct VtableTrait*	 traits;
+	struct VtableMethod* methods;
+	struct Vtable*		 vtables;
+	uint32_t*			 slots; // Open addressing table of vtable indexes + 1.
+	size_t traitCount, traitCapacity, methodCount, methodCapacity, vtableCount, vtableCapacity,
+		slotCount;
+	size_t temporaries; // Counter for unique temporary names.
+};
+
+#define VTABLETABLE_STRUCT_SIZE sizeof(struct VtableTable)
+
+/**
+ * Creates a new VtableTable struct.
+ *
+ * @param p_types    The module's type table.
+ * @param p_interner The module's interner.
+ *
+ * @return The created VtableTable struct.
+ */
+struct VtableTable* vtable_table_new(struct TypeTable* p_types, struct Interner* p_interner);
+
+/**
+ * Frees a VtableTable struct.
+ *
+ * @param p_self The current VtableTable struct.
+ */
+void vtable_table_free(struct VtableTable** p_self);
+
+/**
+ * Declares an instantiated trait, emitting its vtable and fat pointer types, e.g.
+ * '%"Container<i32>.vtable"'.
+ *
+ * @param p_self    The current VtableTable struct.
+ * @param type      The instantiated trait, e.g. 'Container<i32>'.
+ * @param p_methods The trait's methods, in declaration order.
+ * @param count     The number of methods.
+ * @param p_output  Where to append the IR.
+ *
+ * @return The index of the trait.
+ */
+uint32_t vtable_table_declare_trait(struct VtableTable* p_self, type_id_t type,
+									const struct VtableMethod* p_methods, size_t count,
+									struct String* p_output);
+
+/**
+ * Finds a declared instantiated trait.
+ *
+ * @param p_self The current VtableTable struct.
+ * @param type   The instantiated trait, e.g. 'Container<i32>'.
+ *
+ * @return The index of the trait, or VTABLE_TRAIT_NONE if it has not been declared.
+ */
+uint32_t vtable_table_find_trait(const struct VtableTable* p_self, type_id_t type);
+
+/**
+ * Finds the slot of a method in a trait's vtable.
+ *
+ * @param p_self The current VtableTable struct.
+ * @param trait  The index of the trait.
+ * @param name   The interned name of the method.
+ *
+ * @return The slot, or VTABLE_METHOD_NONE if the trait has no such method.
+ */
+uint32_t vtable_table_find_method(const struct VtableTable* p_self, uint32_t trait,
+								  intern_id_t name);
+
+/**
+ * Emits the vtable of a (type, trait) pair, unless it has already been emitted.
+ *
+ * @param p_self    The current VtableTable struct.
+ * @param trait     The index of the trait.
+ * @param type      The implementing type.
+ * @param p_entries The implementations of the trait's methods, in declaration order.
+ * @param p_output  Where to append the IR.
+ *
+ * @return The interned symbol of the vtable.
+ */
+intern_id_t vtable_table_emit(struct VtableTable* p_self, uint32_t trait, type_id_t type,
+							  const struct VtableEntry* p_entries, struct String* p_output);
+
+/**
+ * Emits the creation of a trait object from a pointer to a value, whose vtable must have been
+ * emitted.
+ *
+ * @param p_self   The current VtableTable struct.
+ * @param trait    The index of the trait.
+ * @param type     The type of the value.
+ * @param p_data   The 'i8*' pointer to the value, e.g. '%3'.
+ * @param p_result The name of the resulting trait object, e.g. '%shape'.
+ * @param p_output Where to append the IR.
+ */
+void vtable_table_emit_object(struct VtableTable* p_self, uint32_t trait, type_id_t type,
+							  const char* p_data, const char* p_result, struct String* p_output);
+
+/**
+ * Emits a method call on a trait object: a load from the vtable and an indirect call.
+ *
+ * @param p_self   The current VtableTable struct.
+ * @param trait    The index of the trait.
+ * @param method   The slot of the method.
+ * @param p_object The trait object, e.g. '%shape'.
+ * @param p_args   The arguments after the receiver, e.g. 'i32 %x', or an empty string.
+ * @param p_result The name of the result, or NULL to discard it.
+ * @param p_output Where to append the IR.
+ */
+// NOLINTBEGIN(bugprone-easily-swappable-parameters)
+void vtable_table_emit_call(struct VtableTable* p_self, uint32_t trait, uint32_t method,
+							const char* p_object, const char* p_args, const char* p_result,
+							struct String* p_output);
+// NOLINTEND(bugprone-easily-swappable-parameters)
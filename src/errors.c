@@ -9,7 +9,9 @@
 
 const struct Array g_ERRORIDENTIFIER_NAMES =
 	ARRAY_NEW_STACK("A0001", "A0002", "A0003", "A0004", "L0001", "L0002", "L0003", "L0004", "L0005",
-					"L0006", "L0007", "P0001", "P0002", "P0003");
+					"L0006", "L0007", "P0001", "P0002", "P0003", "C0001", "C0002", "C0003", "C0004",
+					"C0005", "C0006", "C0007", "C0008", "C0009", "C0010", "C0011", "C0012", "C0013",
+					"C0014");
 
 const char* error_get(const enum ErrorIdentifiers IDENTIFIER) {
 	if ((size_t)IDENTIFIER + 1 > g_ERRORIDENTIFIER_NAMES.length) {
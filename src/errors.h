@@ -28,6 +28,22 @@ enum ErrorIdentifiers {
 	P0001,
 	P0002,
 	P0003,
+
+	// Compiler
+	C0001,
+	C0002,
+	C0003,
+	C0004,
+	C0005,
+	C0006,
+	C0007,
+	C0008,
+	C0009,
+	C0010,
+	C0011,
+	C0012,
+	C0013,
+	C0014,
 };
 
 /**
@@ -189,7 +189,7 @@ bool lexer_get_chr(struct Lexer* p_self, bool skipWhitespace) {
 
 void lexer_check_for_continuation(struct Lexer* p_self, const struct LexerToken* p_token) {
 	if (lexer_get_chr(p_self, false)) {
-		if (!isspace(p_self->chr) && !isalnum(p_self->chr)) {
+		if (!isspace(p_self->chr) && !isalnum(p_self->chr) && p_self->chr != '_') {
 			lexer_error(p_self, L0002,
 						CONCATENATE_STRING("unexpected continuation of token '",
 										   p_token->value->_value, "'"),
@@ -322,6 +322,9 @@ void lexer_lex_three_char(struct Lexer* p_self, const char SECOND_CHR, const cha
 					if (continuationCheckIfThreeAndThird) {
 						lexer_check_for_continuation(p_self, lp_token);
 					}
+				} else { // THIRD_CHR was not found, un-get it
+					lexer_un_get_chr(p_self);
+					p_self->prevChr = l_PREV_CHR;
 				}
 			}
 
@@ -508,7 +511,7 @@ void lexer_lex_keyword_or_identifier(struct Lexer* p_self) {
 	struct String* lp_identifier	 = string_new(chr_to_string(p_self->chr), false);
 
 	while (lexer_get_chr(p_self, false)) {
-		if (!isalnum(p_self->chr)) {
+		if (!isalnum(p_self->chr) && p_self->chr != '_') {
 			lexer_un_get_chr(p_self);
 			break;
 		}
@@ -606,8 +609,8 @@ bool lexer_lex_next(struct Lexer* p_self) {
 	case '>':
 		lexer_lex_three_char(p_self, p_self->chr, '=', LEXERTOKENS_GREATER_THAN,
 							 LEXERTOKENS_BITWISE_RIGHT_SHIFT, LEXERTOKENS_GREATER_THAN_OR_EQUAL,
-							 LEXERTOKENS_BITWISE_RIGHT_SHIFT_ASSIGNMENT, false, true, true,
-							 true); // 'e.g., 'Example: trait<io::Stringify>(Type) = {}'
+							 LEXERTOKENS_BITWISE_RIGHT_SHIFT_ASSIGNMENT, false, false, true,
+							 true); // e.g. 'trait<io::Stringify>(Type) = {}', 'Array<T>>)'
 		break;
 	case '<':
 		lexer_lex_three_char(p_self, p_self->chr, '=', LEXERTOKENS_LESS_THAN,
@@ -4,9 +4,13 @@
  */
 
 #include "./args/args.h"
+#include "./compiler/cache.h"
 #include "./compiler/compiler.h"
+#include "./compiler/lto.h"
+#include "./compiler/report.h"
 #include "./utils/hashmap.h"
 #include "./utils/panic.h"
+#include "./utils/str.h"
 #include <locale.h>
 
 #define NAME	"exeme"
@@ -23,6 +27,21 @@ static const struct Array g_ARGUMENTS_FORMAT = ARRAY_NEW_STACK(
 			  .description = "The path to the folder containing the standard library",
 			  .def = "./../../lib", .flagShort = "-s", .flagLong = "--stdlib",
 			  .type = VARIABLE_TYPE_STRING),
+	&ARG_INIT(.name = "cache-dir",
+			  .description = "The compilation cache directory (default '~/.cache/exeme')",
+			  .def = "", .flagLong = "--cache-dir", .type = VARIABLE_TYPE_STRING),
+	&ARG_INIT(.name = "no-cache", .description = "Recompile every module, bypassing the cache",
+			  .flagLong = "--no-cache"),
+	&ARG_INIT(.name = "report",
+			  .description =
+				  "Comma separated reports to print (time, devirt, escape, layout, copies)",
+			  .def = "", .flagLong = "--report", .type = VARIABLE_TYPE_STRING),
+	&ARG_INIT(.name = "target-features",
+			  .description = "Comma separated target features, e.g. '+avx2' for 256 bit vectors",
+			  .def = "", .flagLong = "--target-features", .type = VARIABLE_TYPE_STRING),
+	&ARG_INIT(.name = "lto",
+			  .description = "Link time optimisation across modules and the runtime (thin, full)",
+			  .def = "", .flagLong = "--lto", .type = VARIABLE_TYPE_STRING),
 	&SUBCOMMAND_INIT(.name = "run", .help = "Runs the specified program",
 					 .argumentsFormat = ARRAY_NEW_STACK(
 						 &ARG_INIT(.name = "file", .description = "The path of the file to compile",
@@ -54,11 +73,56 @@ int main(int argc, char** argv) {
 		error("no file path specified");
 	}
 
-	struct Compiler* lp_compiler = compiler_new(*lp_filePath);
+	enum LtoModes ltoMode = LTO_NONE;
+
+	if (!lto_mode_parse(*hashmap_get(lp_parsedArgs, "lto"), &ltoMode)) {
+		error("invalid '--lto' mode, expected 'thin' or 'full'");
+	}
+
+	struct Cache* lp_cache = NULL;
+
+	if (!hashmap_get(lp_parsedArgs, "no-cache")) {
+		lp_cache = cache_new(*hashmap_get(lp_parsedArgs, "cache-dir"));
+	}
+
+	// The module's cache key is computed once its imports are known
+	char* lp_flags = CONCATENATE_STRING("stdlib=", *hashmap_get(lp_parsedArgs, "stdlib"),
+										",target-features=",
+										*hashmap_get(lp_parsedArgs, "target-features"));
+	struct Report*	 lp_report	 = report_new(*hashmap_get(lp_parsedArgs, "report"));
+	struct Compiler* lp_compiler = compiler_new(*lp_filePath, lp_cache, VERSION, lp_flags,
+												lp_report,
+												*hashmap_get(lp_parsedArgs, "target-features"));
 
 	while (compiler_compile(lp_compiler)) {
 	}
 
+	compiler_finish(lp_compiler);
+
+	char*		lp_programPath = lto_program_path(*lp_filePath);
+	struct Lto* lp_lto		   = lto_new(ltoMode, lp_cache, lp_report, lp_programPath,
+										 *hashmap_get(lp_parsedArgs, "target-features"));
+
+	lto_add_module(lp_lto, lp_compiler->cacheKey, lp_compiler->output);
+	lto_add_imports(lp_lto, lp_compiler->linked, VERSION);
+	lto_add_entry(lp_lto, lp_compiler->entry, VERSION);
+	lto_add_runtime(lp_lto, *hashmap_get(lp_parsedArgs, "stdlib"), VERSION);
+	lto_link(lp_lto);
+	lto_free(&lp_lto);
+
+	report_print(lp_report);
+
+	bool ran = !hashmap_get(lp_parsedArgs, "run") || lto_run(lp_programPath);
+
+	free(lp_programPath);
 	compiler_free(&lp_compiler);
+	free(lp_flags);
+	report_free(&lp_report);
 	hashmap_free(&lp_parsedArgs, NULL);
+
+	if (lp_cache) {
+		cache_free(&lp_cache);
+	}
+
+	return ran ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,221 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./flat.h"
+#include "../utils/buffer.h"
+#include "../utils/panic.h"
+#include "../utils/str.h"
+#include <string.h>
+
+// X-Macro to define flat AST node kind names
+static char* const g_FLATAST_KIND_NAMES_INTERNAL[] = {
+#define FLATAST_KIND_TO_STRING(name) #name,
+	FLATAST_KINDS(FLATAST_KIND_TO_STRING)
+#undef FLATAST_KIND_TO_STRING
+};
+
+const struct Array g_FLATAST_KIND_NAMES =
+	ARRAY_UPGRADE_STACK((const void**)g_FLATAST_KIND_NAMES_INTERNAL,
+						sizeof(g_FLATAST_KIND_NAMES_INTERNAL) / ARRAY_STRUCT_ELEMENT_SIZE);
+
+const char* flat_ast_kind_get_name(const enum FlatASTKinds KIND) {
+	if ((size_t)KIND + 1 > g_FLATAST_KIND_NAMES.length) {
+		PANIC("g_FLATAST_KIND_NAMES get index out of bounds");
+	}
+
+	return g_FLATAST_KIND_NAMES._values[KIND];
+}
+
+struct FlatAST* flat_ast_new(void) {
+	struct FlatAST* lp_self = calloc(1, FLATAST_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc FlatAST struct");
+	}
+
+	lp_self->borrowed = false;
+
+	flat_ast_add(lp_self, &(struct FlatASTNode){.kind = FLATAST_NONE}); // Reserve index 0
+	flat_ast_add_string(lp_self, ""); // Offset 0 is the empty string
+
+	return lp_self;
+}
+
+struct FlatAST* flat_ast_view(const struct FlatASTNode* p_nodes, size_t nodeCount,
+							  const flat_ast_index_t* p_extra, size_t extraCount,
+							  const char* p_strings, size_t stringsLength) {
+	struct FlatAST* lp_self = malloc(FLATAST_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc FlatAST struct");
+	}
+
+	lp_self->borrowed		 = true;
+	lp_self->nodes			 = (struct FlatASTNode*)p_nodes;
+	lp_self->nodeCount		 = nodeCount;
+	lp_self->nodeCapacity	 = nodeCount;
+	lp_self->extra			 = (flat_ast_index_t*)p_extra;
+	lp_self->extraCount		 = extraCount;
+	lp_self->extraCapacity	 = extraCount;
+	lp_self->strings		 = (char*)p_strings;
+	lp_self->stringsLength	 = stringsLength;
+	lp_self->stringsCapacity = stringsLength;
+
+	return lp_self;
+}
+
+void flat_ast_free(struct FlatAST** p_self) {
+	if (p_self && *p_self) {
+		if (!(*p_self)->borrowed) {
+			free((*p_self)->nodes);
+			free((*p_self)->extra);
+			free((*p_self)->strings);
+		}
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("FlatAST struct has already been freed");
+	}
+}
+
+bool flat_ast_validate(const struct FlatAST* p_self) {
+	// Strings are read up to their terminator, so the pool has to end with one
+	if (p_self->stringsLength == 0 || p_self->strings[p_self->stringsLength - 1] != '\0') {
+		return false;
+	}
+
+	for (size_t index = 0; index < p_self->extraCount; index++) {
+		if (p_self->extra[index] >= p_self->nodeCount) {
+			return false;
+		}
+	}
+
+	for (size_t index = 0; index < p_self->nodeCount; index++) {
+		const struct FlatASTNode* lp_node = &p_self->nodes[index];
+
+		if (lp_node->kind >= g_FLATAST_KIND_NAMES.length || lp_node->lhs >= p_self->nodeCount
+			|| lp_node->rhs >= p_self->nodeCount) {
+			return false;
+		}
+
+		switch (lp_node->kind) {
+		case FLATAST_STRING:
+		case FLATAST_VARIABLE:
+		case FLATAST_MEMBER:
+		case FLATAST_FIELD:
+		case FLATAST_PARAMETER:
+			if (lp_node->value.string >= p_self->stringsLength) {
+				return false;
+			}
+			break;
+		case FLATAST_TYPE:
+		case FLATAST_CALL:
+		case FLATAST_STRUCT_LITERAL:
+		case FLATAST_ARRAY_LITERAL:
+		case FLATAST_BLOCK:
+		case FLATAST_IF:
+		case FLATAST_FOR:
+		case FLATAST_FUNCTION:
+		case FLATAST_MATCH:
+		case FLATAST_STRUCT:
+		case FLATAST_TRAIT:
+		case FLATAST_IMPL:
+			if ((uint64_t)lp_node->value.list.start + lp_node->value.list.length
+				> p_self->extraCount) {
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+flat_ast_index_t flat_ast_add(struct FlatAST* p_self, const struct FlatASTNode* p_node) {
+	if (p_self->borrowed) {
+		PANIC("cannot add a node to a borrowed FlatAST");
+	} else if (p_self->nodeCount >= UINT32_MAX) {
+		PANIC("too many FlatAST nodes");
+	}
+
+	p_self->nodes = buffer_grow(p_self->nodes, &p_self->nodeCapacity, p_self->nodeCount + 1,
+								FLATAST_NODE_SIZE);
+
+	p_self->nodes[p_self->nodeCount] = *p_node;
+
+	return (flat_ast_index_t)p_self->nodeCount++;
+}
+
+uint32_t flat_ast_add_list(struct FlatAST* p_self, const flat_ast_index_t* p_items, size_t length) {
+	if (p_self->borrowed) {
+		PANIC("cannot add a list to a borrowed FlatAST");
+	}
+
+	p_self->extra = buffer_grow(p_self->extra, &p_self->extraCapacity, p_self->extraCount + length,
+								sizeof(flat_ast_index_t));
+
+	uint32_t start = (uint32_t)p_self->extraCount;
+
+	if (length > 0) {
+		memcpy(p_self->extra + start, p_items, length * sizeof(flat_ast_index_t));
+	}
+
+	p_self->extraCount += length;
+
+	return start;
+}
+
+uint32_t flat_ast_add_string(struct FlatAST* p_self, const char* p_string) {
+	if (p_self->borrowed) {
+		PANIC("cannot add a string to a borrowed FlatAST");
+	}
+
+	size_t length = strlen_safe(p_string) + 1; // Include the null terminator
+	// The string can be one of the AST's own, e.g. a variable's name given to a field, which
+	// growing the buffer would free
+	bool   own	  = p_string && p_string >= p_self->strings
+				 && p_string < p_self->strings + p_self->stringsLength;
+	size_t source = own ? (size_t)(p_string - p_self->strings) : 0;
+
+	p_self->strings =
+		buffer_grow(p_self->strings, &p_self->stringsCapacity, p_self->stringsLength + length, 1);
+
+	uint32_t offset = (uint32_t)p_self->stringsLength;
+
+	memcpy(p_self->strings + offset, own ? p_self->strings + source : p_string ? p_string : "",
+		   length);
+	p_self->stringsLength += length;
+
+	return offset;
+}
+
+const struct FlatASTNode* flat_ast_get(const struct FlatAST* p_self, flat_ast_index_t index) {
+	if (index >= p_self->nodeCount) {
+		PANIC("FlatAST get index out of bounds");
+	}
+
+	return &p_self->nodes[index];
+}
+
+flat_ast_index_t flat_ast_get_list_item(const struct FlatAST*	  p_self,
+										const struct FlatASTNode* p_node, size_t index) {
+	if (index >= p_node->value.list.length
+		|| p_node->value.list.start + index >= p_self->extraCount) {
+		PANIC("FlatAST list index out of bounds");
+	}
+
+	return p_self->extra[p_node->value.list.start + index];
+}
+
+const char* flat_ast_get_string(const struct FlatAST* p_self, uint32_t offset) {
+	if (offset >= p_self->stringsLength) {
+		PANIC("FlatAST string offset out of bounds");
+	}
+
+	return p_self->strings + offset;
+}
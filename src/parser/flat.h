@@ -0,0 +1,214 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "../utils/array.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Index of a node in a FlatAST. Index 0 is reserved for the 'none' node, so it doubles as 'absent'.
+ */
+typedef uint32_t flat_ast_index_t;
+
+#define FLATAST_INDEX_NONE ((flat_ast_index_t)0)
+
+// X-Macro to define flat AST node kinds, and which fields of the node they use
+#define FLATAST_KINDS(X)                                                                           \
+	X(NONE)			  /* - */                                                                      \
+	X(INTEGER)		  /* value.integer */                                                          \
+	X(FLOAT)		  /* value.floating */                                                         \
+	X(CHR)			  /* value.integer */                                                          \
+	X(STRING)		  /* value.string */                                                           \
+	X(VARIABLE)		  /* value.string = name */                                                    \
+	X(TYPE)			  /* lhs = name (VARIABLE), value.list = type arguments */                     \
+	X(UNARY)		  /* operation, lhs = operand */                                               \
+	X(BINARY)		  /* operation, lhs, rhs */                                                    \
+	X(ASSIGNMENT)	  /* operation, lhs = target, rhs = value */                                   \
+	X(MEMBER)		  /* lhs = object, value.string = member name */                               \
+	X(CALL)			  /* lhs = callee, value.list = arguments */                                   \
+	X(STRUCT_LITERAL) /* lhs = type, value.list = fields */                                        \
+	X(ARRAY_LITERAL)  /* value.list = elements */                                                  \
+	X(FIELD)		  /* value.string = name, lhs = value / type */                                \
+	X(BLOCK)		  /* value.list = statements */                                                \
+	X(IF)			  /* lhs = condition, rhs = then block, value.list = elif / else */            \
+	X(WHILE)		  /* lhs = condition, rhs = body */                                            \
+	X(FOR)			  /* lhs = iterable, rhs = body, value.list = bindings */                      \
+	X(RETURN)		  /* lhs = value (optional) */                                                 \
+	X(PARAMETER)	  /* value.string = name, lhs = type (optional) */                             \
+	X(FUNCTION)		  /* lhs = return type (optional), rhs = body, value.list = parameters */      \
+	X(MATCH)		  /* lhs = scrutinee, value.list = cases */                                    \
+	X(CASE)			  /* lhs = pattern, rhs = body */                                              \
+	X(STRUCT)		  /* lhs = IMPL (optional), value.list = fields (FIELD, lhs = type) */         \
+	X(TRAIT)		  /* value.list = methods (FIELD, lhs = FUNCTION without a body) */            \
+	X(IMPL)			  /* value.list = implemented traits (TYPE, or VARIABLE for a bare name) */
+
+/**
+ * Used to identify flat AST node kinds.
+ */
+enum FlatASTKinds {
+#define FLATAST_KIND_ENUM_ENTRY(name) FLATAST_##name,
+	FLATAST_KINDS(FLATAST_KIND_ENUM_ENTRY)
+#undef FLATAST_KIND_ENUM_ENTRY
+};
+
+/**
+ * Contains the names of each of the flat AST node kinds.
+ */
+extern const struct Array g_FLATAST_KIND_NAMES;
+
+/**
+ * Gets the name of a flat AST node kind.
+ *
+ * @param KIND The node kind.
+ *
+ * @return The name of the node kind.
+ */
+const char* flat_ast_kind_get_name(
+	const enum FlatASTKinds KIND); // NOLINT(readability-avoid-const-params-in-decls)
+
+/**
+ * Represents a node of a FlatAST. Nodes only use fixed-width fields and refer to each other by
+ * index, so a whole tree can be written to disk and read back (or memory-mapped) as-is.
+ */
+struct FlatASTNode {
+	uint8_t			 kind;		// enum FlatASTKinds
+	uint8_t			 operation; // enum LexerTokenIdentifiers, for operator nodes
+	uint16_t		 flags;		// Kind specific flags.
+	flat_ast_index_t lhs, rhs;	// Child nodes.
+	uint32_t		 line;		// The line the node starts on, for diagnostics.
+	union {
+		int64_t	 integer;
+		double	 floating;
+		uint32_t string; // Offset into the string pool.
+		struct {
+			uint32_t start, length; // Range of node indexes in the extra array.
+		} list;
+	} value;
+};
+
+#define FLATAST_NODE_SIZE sizeof(struct FlatASTNode)
+
+/**
+ * Represents an AST stored as a single array of nodes, instead of a tree of individually allocated
+ * nodes. Child lists live in a shared 'extra' array of node indexes and strings in one pool, so a
+ * whole module is three allocations, cache friendly to walk, and trivially serialisable.
+ */
+struct FlatAST {
+	bool				borrowed; // Whether the arrays are owned by someone else (e.g. a mapping).
+	struct FlatASTNode* nodes;
+	flat_ast_index_t*	extra;
+	char*				strings;
+	size_t				nodeCount, nodeCapacity, extraCount, extraCapacity, stringsLength,
+		stringsCapacity;
+};
+
+#define FLATAST_STRUCT_SIZE sizeof(struct FlatAST)
+
+/**
+ * Creates a new, empty FlatAST struct.
+ *
+ * @return The created FlatAST struct.
+ */
+struct FlatAST* flat_ast_new(void);
+
+/**
+ * Creates a read-only FlatAST struct over arrays owned by someone else, e.g. a memory-mapped
+ * interface file.
+ *
+ * @param p_nodes       The nodes.
+ * @param nodeCount     The number of nodes.
+ * @param p_extra       The extra array.
+ * @param extraCount    The length of the extra array.
+ * @param p_strings     The string pool.
+ * @param stringsLength The length of the string pool.
+ *
+ * @return The created FlatAST struct.
+ */
+struct FlatAST* flat_ast_view(const struct FlatASTNode* p_nodes, size_t nodeCount,
+							  const flat_ast_index_t* p_extra, size_t extraCount,
+							  const char* p_strings, size_t stringsLength);
+
+/**
+ * Frees a FlatAST struct.
+ *
+ * @param p_self The current FlatAST struct.
+ */
+void flat_ast_free(struct FlatAST** p_self);
+
+/**
+ * Checks that every child index, list range and string offset of a FlatAST is in bounds, and that
+ * the string pool is terminated. ASTs read from disk must be validated before they are walked.
+ *
+ * @param p_self The current FlatAST struct.
+ *
+ * @return Whether the FlatAST is well formed.
+ */
+bool flat_ast_validate(const struct FlatAST* p_self);
+
+/**
+ * Adds a node.
+ *
+ * @param p_self The current FlatAST struct.
+ * @param p_node The node to add (copied).
+ *
+ * @return The index of the added node.
+ */
+flat_ast_index_t flat_ast_add(struct FlatAST* p_self, const struct FlatASTNode* p_node);
+
+/**
+ * Adds a list of node indexes to the extra array.
+ *
+ * @param p_self  The current FlatAST struct.
+ * @param p_items The node indexes.
+ * @param length  The number of node indexes.
+ *
+ * @return The start of the list in the extra array.
+ */
+uint32_t flat_ast_add_list(struct FlatAST* p_self, const flat_ast_index_t* p_items, size_t length);
+
+/**
+ * Adds a string to the string pool.
+ *
+ * @param p_self   The current FlatAST struct.
+ * @param p_string The string to add.
+ *
+ * @return The offset of the string in the pool.
+ */
+uint32_t flat_ast_add_string(struct FlatAST* p_self, const char* p_string);
+
+/**
+ * Gets a node.
+ *
+ * @param p_self The current FlatAST struct.
+ * @param index  The index of the node.
+ *
+ * @return The node.
+ */
+const struct FlatASTNode* flat_ast_get(const struct FlatAST* p_self, flat_ast_index_t index);
+
+/**
+ * Gets an item of a node's list.
+ *
+ * @param p_self The current FlatAST struct.
+ * @param p_node The node.
+ * @param index  The index of the item in the list.
+ *
+ * @return The node index stored at that position of the list.
+ */
+flat_ast_index_t flat_ast_get_list_item(const struct FlatAST* p_self,
+										const struct FlatASTNode* p_node, size_t index);
+
+/**
+ * Gets a string from the string pool.
+ *
+ * @param p_self The current FlatAST struct.
+ * @param offset The offset of the string.
+ *
+ * @return The string.
+ */
+const char* flat_ast_get_string(const struct FlatAST* p_self, uint32_t offset);
@@ -0,0 +1,1414 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./flat_parser.h"
+#include "../compiler/attributes.h"
+#include "../utils/panic.h"
+#include "../utils/str.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct FlatParser* flat_parser_new(const char* p_filePath, struct FlatAST* p_ast) {
+	struct FlatParser* lp_self = malloc(FLATPARSER_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc FlatParser struct");
+	}
+
+	lp_self->filePath		 = p_filePath;
+	lp_self->lexer			 = lexer_new(p_filePath);
+	lp_self->ast			 = p_ast;
+	lp_self->tokens			 = array_new();
+	lp_self->current		 = 0;
+	lp_self->nesting		 = 0;
+	lp_self->noStructLiteral = false;
+	lp_self->splitShift		 = false;
+	lp_self->imports		 = array_new();
+	lp_self->importLines	 = NULL;
+
+	while (lexer_lex(lp_self->lexer, true)) {
+		const struct LexerToken* lp_token =
+			lp_self->lexer->tokens->_values[lp_self->lexer->tokens->length - 1];
+
+		if (lp_token->identifier != LEXERTOKENS_SINGLE_LINE_COMMENT
+			&& lp_token->identifier != LEXERTOKENS_MULTI_LINE_COMMENT) {
+			array_append(lp_self->tokens, lp_token);
+		}
+	}
+
+	return lp_self;
+}
+
+void flat_parser_free(struct FlatParser** p_self) {
+	if (p_self && *p_self) {
+		array_clear((*p_self)->imports, (void (*)(const void*))free);
+		array_free(&(*p_self)->imports);
+		free((*p_self)->importLines);
+		array_free(&(*p_self)->tokens);
+		lexer_free(&(*p_self)->lexer);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("FlatParser struct has already been freed");
+	}
+}
+
+__attribute__((noreturn)) void flat_parser_error(struct FlatParser*			 p_self,
+												 const enum ErrorIdentifiers ERROR,
+												 const char*				 p_errorMsg,
+												 const struct LexerToken*	 p_token) {
+	if (!p_token && p_self->tokens->length > 0) { // The end of the file, point after the last token
+		p_token = p_self->tokens->_values[p_self->tokens->length - 1];
+	}
+
+	p_self->lexer->lineIndex = p_token ? p_token->lineIndex : 0;
+
+	lexer_error(p_self->lexer, ERROR, p_errorMsg, p_token);
+}
+
+/**
+ * Gets a token after the current one, without consuming it.
+ *
+ * @param p_self The current FlatParser struct.
+ * @param offset How many tokens after the current one.
+ *
+ * @return The token, or NULL past the end of the file.
+ */
+const struct LexerToken* flat_parser___peek(const struct FlatParser* p_self, size_t offset) {
+	size_t index = p_self->current + offset;
+
+	return index < p_self->tokens->length ? p_self->tokens->_values[index] : NULL;
+}
+
+/**
+ * Gets the last consumed token.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The token, or NULL if none has been consumed.
+ */
+const struct LexerToken* flat_parser___previous(const struct FlatParser* p_self) {
+	return p_self->current > 0 ? p_self->tokens->_values[p_self->current - 1] : NULL;
+}
+
+/**
+ * Consumes the current token.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The consumed token.
+ */
+const struct LexerToken* flat_parser___advance(struct FlatParser* p_self) {
+	const struct LexerToken* lp_token = flat_parser___peek(p_self, 0);
+
+	if (!lp_token) {
+		flat_parser_error(p_self, P0002, "unexpected end of file", NULL);
+	}
+
+	p_self->current++;
+
+	return lp_token;
+}
+
+/**
+ * Checks whether a token is of a kind, and optionally has a value.
+ *
+ * @param p_token    The token (can be NULL).
+ * @param IDENTIFIER The kind of token.
+ * @param p_value    The value, NULL for any.
+ *
+ * @return Whether the token matches.
+ */
+bool flat_parser___is(const struct LexerToken*		   p_token,
+					  const enum LexerTokenIdentifiers IDENTIFIER, const char* p_value) {
+	return p_token && p_token->identifier == IDENTIFIER
+		   && (!p_value || strcmp(p_token->value->_value, p_value) == 0);
+}
+
+/**
+ * Checks whether the current token is of a kind, and optionally has a value.
+ *
+ * @param p_self     The current FlatParser struct.
+ * @param IDENTIFIER The kind of token.
+ * @param p_value    The value, NULL for any.
+ *
+ * @return Whether the current token matches.
+ */
+bool flat_parser___check(const struct FlatParser*		  p_self,
+						 const enum LexerTokenIdentifiers IDENTIFIER, const char* p_value) {
+	return flat_parser___is(flat_parser___peek(p_self, 0), IDENTIFIER, p_value);
+}
+
+/**
+ * Consumes the current token if it is of a kind, and optionally has a value.
+ *
+ * @param p_self     The current FlatParser struct.
+ * @param IDENTIFIER The kind of token.
+ * @param p_value    The value, NULL for any.
+ *
+ * @return Whether the token was consumed.
+ */
+bool flat_parser___match(struct FlatParser* p_self, const enum LexerTokenIdentifiers IDENTIFIER,
+						 const char* p_value) {
+	if (!flat_parser___check(p_self, IDENTIFIER, p_value)) {
+		return false;
+	}
+
+	p_self->current++;
+
+	return true;
+}
+
+/**
+ * Consumes the current token, erroring unless it is of a kind, and optionally has a value.
+ *
+ * @param p_self     The current FlatParser struct.
+ * @param IDENTIFIER The kind of token.
+ * @param p_value    The value, NULL for any.
+ * @param p_expected What was expected, for the error, e.g. "'{'".
+ *
+ * @return The consumed token.
+ */
+const struct LexerToken* flat_parser___expect(struct FlatParser*			   p_self,
+											  const enum LexerTokenIdentifiers IDENTIFIER,
+											  const char* p_value, const char* p_expected) {
+	if (!flat_parser___check(p_self, IDENTIFIER, p_value)) {
+		flat_parser_error(p_self, P0002, CONCATENATE_STRING("expected ", p_expected),
+						  flat_parser___peek(p_self, 0));
+	}
+
+	return flat_parser___advance(p_self);
+}
+
+/**
+ * Checks whether the current token continues the current statement, which it does if it is on the
+ * same line as the last consumed token, or the parser is inside brackets.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return Whether the current token continues the statement.
+ */
+bool flat_parser___same_line(const struct FlatParser* p_self) {
+	const struct LexerToken* lp_token	 = flat_parser___peek(p_self, 0);
+	const struct LexerToken* lp_previous = flat_parser___previous(p_self);
+
+	return lp_token
+		   && (p_self->nesting > 0 || !lp_previous
+			   || lp_token->lineIndex == lp_previous->lineIndex);
+}
+
+/**
+ * Checks whether the current statement has ended: at the end of the line or file, or before the
+ * '}' closing its block.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return Whether the statement has ended.
+ */
+bool flat_parser___at_end(const struct FlatParser* p_self) {
+	return !flat_parser___same_line(p_self)
+		   || flat_parser___check(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL);
+}
+
+/**
+ * Creates a node of a kind, starting at a token.
+ *
+ * @param KIND    The node's kind.
+ * @param p_token The token the node starts at.
+ *
+ * @return The node.
+ */
+struct FlatASTNode flat_parser___node(const enum FlatASTKinds KIND,
+									  const struct LexerToken* p_token) {
+	struct FlatASTNode node = {0};
+
+	node.kind = (uint8_t)KIND;
+	node.line = (uint32_t)p_token->lineIndex;
+
+	return node;
+}
+
+/**
+ * Adds a node holding a name, e.g. a VARIABLE.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param KIND    The node's kind.
+ * @param p_token The token the node starts at.
+ * @param p_name  The name.
+ * @param lhs     The node's lhs.
+ *
+ * @return The added node.
+ */
+flat_ast_index_t flat_parser___add_named(struct FlatParser* p_self, const enum FlatASTKinds KIND,
+										 const struct LexerToken* p_token, const char* p_name,
+										 flat_ast_index_t lhs) {
+	struct FlatASTNode node = flat_parser___node(KIND, p_token);
+
+	node.lhs		  = lhs;
+	node.value.string = flat_ast_add_string(p_self->ast, p_name);
+
+	return flat_ast_add(p_self->ast, &node);
+}
+
+/**
+ * Appends a node index to a growable list.
+ *
+ * @param p_items    The list.
+ * @param p_count    The number of items in the list.
+ * @param p_capacity The capacity of the list.
+ * @param item       The node index.
+ */
+void flat_parser___push(flat_ast_index_t** p_items, size_t* p_count, size_t* p_capacity,
+						flat_ast_index_t item) {
+	if (*p_count == *p_capacity) {
+		*p_capacity				  = *p_capacity ? *p_capacity * 2 : 4;
+		flat_ast_index_t* lp_temp = realloc(*p_items, *p_capacity * sizeof(flat_ast_index_t));
+
+		if (!lp_temp) {
+			PANIC("failed to realloc FlatParser list");
+		}
+
+		*p_items = lp_temp;
+	}
+
+	(*p_items)[(*p_count)++] = item;
+}
+
+/**
+ * Adds a node with a list, freeing the list.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_node  The node, without its list.
+ * @param p_items The list.
+ * @param count   The number of items in the list.
+ *
+ * @return The added node.
+ */
+flat_ast_index_t flat_parser___add_list(struct FlatParser* p_self, struct FlatASTNode* p_node,
+										flat_ast_index_t* p_items, size_t count) {
+	p_node->value.list.start  = flat_ast_add_list(p_self->ast, p_items, count);
+	p_node->value.list.length = (uint32_t)count;
+
+	free(p_items);
+
+	return flat_ast_add(p_self->ast, p_node);
+}
+
+/**
+ * Consumes a '>' closing type arguments. The first half of a '>>' closes the inner arguments of
+ * nested ones, e.g. 'Array<Geometry<i32>>'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return Whether a '>' was consumed.
+ */
+bool flat_parser___close_angle(struct FlatParser* p_self) {
+	if (p_self->splitShift) {
+		p_self->splitShift = false;
+		p_self->current++;
+
+		return true;
+	}
+
+	if (flat_parser___match(p_self, LEXERTOKENS_GREATER_THAN, NULL)) {
+		return true;
+	}
+
+	if (flat_parser___check(p_self, LEXERTOKENS_BITWISE_RIGHT_SHIFT, NULL)) {
+		p_self->splitShift = true;
+
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Scans, without consuming, whether the current token opens angle brackets that close before a
+ * token of a kind, e.g. 'Stack<T>.' or 'Square<MU: UInt|Float> ='.
+ *
+ * @param p_self      The current FlatParser struct.
+ * @param declaration Whether the brackets declare type parameters, which can have bounds.
+ * @param FOLLOWING   The first kind of token that can follow the brackets.
+ * @param OTHER       The other kind of token that can follow the brackets.
+ *
+ * @return Whether the brackets are type arguments or parameters.
+ */
+bool flat_parser___scan_angles(const struct FlatParser* p_self, bool declaration,
+							   const enum LexerTokenIdentifiers FOLLOWING,
+							   const enum LexerTokenIdentifiers OTHER) {
+	const struct LexerToken* lp_name  = flat_parser___previous(p_self);
+	const struct LexerToken* lp_angle = flat_parser___peek(p_self, 0);
+	size_t					 depth	  = 1;
+
+	if (!flat_parser___is(lp_angle, LEXERTOKENS_LESS_THAN, NULL)
+		|| lp_angle->lineIndex != lp_name->lineIndex
+		|| lp_angle->startChrIndex != lp_name->endChrIndex + 1) { // 'a < b' is a comparison
+		return false;
+	}
+
+	for (size_t offset = 1;; offset++) {
+		const struct LexerToken* lp_token = flat_parser___peek(p_self, offset);
+
+		if (!lp_token) {
+			return false;
+		}
+
+		switch (lp_token->identifier) {
+		case LEXERTOKENS_IDENTIFIER:
+		case LEXERTOKENS_INTEGER:
+		case LEXERTOKENS_COMMA:
+			break;
+		case LEXERTOKENS_COLON:
+		case LEXERTOKENS_BITWISE_OR:
+			if (!declaration) {
+				return false;
+			}
+			break;
+		case LEXERTOKENS_LESS_THAN:
+			depth++;
+			break;
+		case LEXERTOKENS_GREATER_THAN:
+			depth--;
+			break;
+		case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+			if (depth < 2) {
+				return false;
+			}
+
+			depth -= 2;
+			break;
+		default:
+			return false;
+		}
+
+		if (depth == 0) {
+			const struct LexerToken* lp_next = flat_parser___peek(p_self, offset + 1);
+
+			return flat_parser___is(lp_next, FOLLOWING, NULL)
+				   || flat_parser___is(lp_next, OTHER, NULL);
+		}
+	}
+}
+
+flat_ast_index_t flat_parser___type(struct FlatParser* p_self);
+
+/**
+ * Parses the type arguments following a type's name, e.g. '<i32>' of 'Stack<i32>'.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param name    The name's node.
+ * @param p_token The name's token.
+ *
+ * @return The TYPE node.
+ */
+flat_ast_index_t flat_parser___type_arguments(struct FlatParser* p_self, flat_ast_index_t name,
+											  const struct LexerToken* p_token) {
+	struct FlatASTNode node		= flat_parser___node(FLATAST_TYPE, p_token);
+	flat_ast_index_t*  lp_items = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	flat_parser___expect(p_self, LEXERTOKENS_LESS_THAN, NULL, "'<'");
+
+	do {
+		flat_parser___push(&lp_items, &count, &capacity, flat_parser___type(p_self));
+	} while (flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL));
+
+	if (!flat_parser___close_angle(p_self)) {
+		flat_parser_error(p_self, P0002, "expected '>'", flat_parser___peek(p_self, 0));
+	}
+
+	node.lhs = name;
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a type, e.g. 'i32', 'Array<T>' or the lanes of 'Vec<f32, 8>'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The type's node, a TYPE, or a VARIABLE for a bare name.
+ */
+flat_ast_index_t flat_parser___type(struct FlatParser* p_self) {
+	if (flat_parser___check(p_self, LEXERTOKENS_INTEGER, NULL)) {
+		const struct LexerToken* lp_token = flat_parser___advance(p_self);
+		struct FlatASTNode		 node	  = flat_parser___node(FLATAST_INTEGER, lp_token);
+
+		node.value.integer = strtoll(lp_token->value->_value, NULL, 10);
+
+		return flat_ast_add(p_self->ast, &node);
+	}
+
+	const struct LexerToken* lp_token =
+		flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a type");
+	flat_ast_index_t name =
+		flat_parser___add_named(p_self, FLATAST_VARIABLE, lp_token, lp_token->value->_value, 0);
+
+	if (!flat_parser___check(p_self, LEXERTOKENS_LESS_THAN, NULL)) {
+		return name;
+	}
+
+	return flat_parser___type_arguments(p_self, name, lp_token);
+}
+
+/**
+ * Parses the bound of a type parameter, e.g. 'Geometry<MU>' or 'Int|UInt|Float'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The bound's node, unions are BINARY '|' nodes.
+ */
+flat_ast_index_t flat_parser___bound(struct FlatParser* p_self) {
+	flat_ast_index_t bound = flat_parser___type(p_self);
+
+	while (flat_parser___check(p_self, LEXERTOKENS_BITWISE_OR, NULL)) {
+		struct FlatASTNode node = flat_parser___node(FLATAST_BINARY, flat_parser___advance(p_self));
+
+		node.operation = LEXERTOKENS_BITWISE_OR;
+		node.lhs	   = bound;
+		node.rhs	   = flat_parser___type(p_self);
+		bound		   = flat_ast_add(p_self->ast, &node);
+	}
+
+	return bound;
+}
+
+/**
+ * Parses the target of a generic declaration, e.g. 'Stack<T: Any>'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return A TYPE node, whose arguments are FIELD nodes holding each parameter's name and bound.
+ */
+flat_ast_index_t flat_parser___generic_declaration(struct FlatParser* p_self) {
+	const struct LexerToken* lp_token = flat_parser___advance(p_self);
+	struct FlatASTNode		 node	  = flat_parser___node(FLATAST_TYPE, lp_token);
+	flat_ast_index_t*		 lp_items = NULL;
+	size_t					 count = 0, capacity = 0;
+
+	node.lhs =
+		flat_parser___add_named(p_self, FLATAST_VARIABLE, lp_token, lp_token->value->_value, 0);
+
+	flat_parser___expect(p_self, LEXERTOKENS_LESS_THAN, NULL, "'<'");
+
+	do {
+		const struct LexerToken* lp_param =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a type parameter");
+		flat_ast_index_t bound = FLATAST_INDEX_NONE;
+
+		if (flat_parser___match(p_self, LEXERTOKENS_COLON, NULL)) {
+			bound = flat_parser___bound(p_self);
+		}
+
+		flat_ast_index_t field = flat_parser___add_named(p_self, FLATAST_FIELD, lp_param,
+														 lp_param->value->_value, bound);
+
+		flat_parser___push(&lp_items, &count, &capacity, field);
+	} while (flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL));
+
+	if (!flat_parser___close_angle(p_self)) {
+		flat_parser_error(p_self, P0002, "expected '>'", flat_parser___peek(p_self, 0));
+	}
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+flat_ast_index_t flat_parser___expression(struct FlatParser* p_self);
+
+flat_ast_index_t flat_parser___statement(struct FlatParser* p_self);
+
+/**
+ * Parses a block, e.g. '{ x = 1 }'. Each statement of the block ends with its line, even if the
+ * block is inside brackets.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The BLOCK node.
+ */
+flat_ast_index_t flat_parser___block(struct FlatParser* p_self) {
+	const struct LexerToken* lp_open =
+		flat_parser___expect(p_self, LEXERTOKENS_OPEN_CURLY_BRACE, NULL, "'{'");
+	struct FlatASTNode node			   = flat_parser___node(FLATAST_BLOCK, lp_open);
+	size_t			   nesting		   = p_self->nesting;
+	bool			   noStructLiteral = p_self->noStructLiteral;
+	flat_ast_index_t*  lp_items		   = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	p_self->nesting			= 0;
+	p_self->noStructLiteral = false;
+
+	while (!flat_parser___check(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL)) {
+		if (!flat_parser___peek(p_self, 0)) {
+			flat_parser_error(p_self, P0003, "unclosed '{'", lp_open);
+		}
+
+		flat_parser___push(&lp_items, &count, &capacity, flat_parser___statement(p_self));
+
+		if (!flat_parser___at_end(p_self)) {
+			flat_parser_error(p_self, P0001, "unexpected token, expected the end of the line",
+							  flat_parser___peek(p_self, 0));
+		}
+	}
+
+	flat_parser___advance(p_self);
+
+	p_self->nesting			= nesting;
+	p_self->noStructLiteral = noStructLiteral;
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a function, after its 'func' keyword, e.g. 'func(a: i32) -> i32 { return a }'.
+ *
+ * @param p_self      The current FlatParser struct.
+ * @param p_token     The 'func' keyword.
+ * @param declaration Whether the function is a trait's method, whose parameters are only types and
+ *                    which has no body, e.g. 'func(Self, T) -> bool'.
+ *
+ * @return The FUNCTION node.
+ */
+flat_ast_index_t flat_parser___function(struct FlatParser* p_self, const struct LexerToken* p_token,
+										bool declaration) {
+	struct FlatASTNode node		= flat_parser___node(FLATAST_FUNCTION, p_token);
+	flat_ast_index_t*  lp_items = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	flat_parser___expect(p_self, LEXERTOKENS_OPEN_BRACE, NULL, "'('");
+	p_self->nesting++;
+
+	while (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_BRACE, NULL)) {
+		if (count > 0) {
+			flat_parser___expect(p_self, LEXERTOKENS_COMMA, NULL, "',' or ')'");
+		}
+
+		const struct LexerToken* lp_param = flat_parser___peek(p_self, 0);
+		flat_ast_index_t		 param	  = FLATAST_INDEX_NONE;
+
+		if (declaration) {
+			param = flat_parser___add_named(p_self, FLATAST_PARAMETER, lp_param, "",
+											flat_parser___type(p_self));
+		} else {
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a parameter");
+
+			flat_ast_index_t annotation = FLATAST_INDEX_NONE;
+
+			if (flat_parser___match(p_self, LEXERTOKENS_COLON, NULL)) {
+				annotation = flat_parser___type(p_self);
+			}
+
+			param = flat_parser___add_named(p_self, FLATAST_PARAMETER, lp_param,
+											lp_param->value->_value, annotation);
+		}
+
+		flat_parser___push(&lp_items, &count, &capacity, param);
+	}
+
+	p_self->nesting--;
+
+	if (flat_parser___same_line(p_self)
+		&& flat_parser___match(p_self, LEXERTOKENS_TYPE_ARROW, NULL)) {
+		node.lhs = flat_parser___type(p_self);
+	}
+
+	if (!declaration) {
+		node.rhs = flat_parser___block(p_self);
+	}
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a struct, after its 'struct' keyword, e.g. 'struct impl Shape { side: f64 }'.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_token The 'struct' keyword.
+ *
+ * @return The STRUCT node.
+ */
+flat_ast_index_t flat_parser___struct(struct FlatParser* p_self, const struct LexerToken* p_token) {
+	struct FlatASTNode node		= flat_parser___node(FLATAST_STRUCT, p_token);
+	flat_ast_index_t*  lp_items = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	if (flat_parser___check(p_self, LEXERTOKENS_KEYWORD, "impl")) {
+		struct FlatASTNode impl = flat_parser___node(FLATAST_IMPL, flat_parser___advance(p_self));
+
+		do {
+			flat_parser___push(&lp_items, &count, &capacity, flat_parser___type(p_self));
+		} while (flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL));
+
+		node.lhs = flat_parser___add_list(p_self, &impl, lp_items, count);
+		lp_items = NULL;
+		count = capacity = 0;
+	}
+
+	const struct LexerToken* lp_open =
+		flat_parser___expect(p_self, LEXERTOKENS_OPEN_CURLY_BRACE, NULL, "'{'");
+
+	while (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL)) {
+		if (!flat_parser___peek(p_self, 0)) {
+			flat_parser_error(p_self, P0003, "unclosed '{'", lp_open);
+		}
+
+		const struct LexerToken* lp_field =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a field");
+
+		flat_parser___expect(p_self, LEXERTOKENS_COLON, NULL, "':'");
+		flat_parser___push(&lp_items, &count, &capacity,
+						   flat_parser___add_named(p_self, FLATAST_FIELD, lp_field,
+												   lp_field->value->_value,
+												   flat_parser___type(p_self)));
+		flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL);
+	}
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a trait, after its 'trait' keyword, e.g. 'trait { area = func(Self) -> f64 }'.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_token The 'trait' keyword.
+ *
+ * @return The TRAIT node.
+ */
+flat_ast_index_t flat_parser___trait(struct FlatParser* p_self, const struct LexerToken* p_token) {
+	struct FlatASTNode		 node	  = flat_parser___node(FLATAST_TRAIT, p_token);
+	flat_ast_index_t*		 lp_items = NULL;
+	size_t					 count = 0, capacity = 0;
+	const struct LexerToken* lp_open =
+		flat_parser___expect(p_self, LEXERTOKENS_OPEN_CURLY_BRACE, NULL, "'{'");
+
+	while (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL)) {
+		if (!flat_parser___peek(p_self, 0)) {
+			flat_parser_error(p_self, P0003, "unclosed '{'", lp_open);
+		}
+
+		const struct LexerToken* lp_method =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a method");
+
+		flat_parser___expect(p_self, LEXERTOKENS_ASSIGNMENT, NULL, "'='");
+
+		flat_ast_index_t function = flat_parser___function(
+			p_self, flat_parser___expect(p_self, LEXERTOKENS_KEYWORD, "func", "'func'"), true);
+
+		flat_parser___push(&lp_items, &count, &capacity,
+						   flat_parser___add_named(p_self, FLATAST_FIELD, lp_method,
+												   lp_method->value->_value, function));
+		flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL);
+	}
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a comma separated list of expressions, until a closing bracket.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_node  The node the list belongs to.
+ * @param CLOSING The closing bracket.
+ * @param p_open  The opening bracket, for errors.
+ *
+ * @return The added node.
+ */
+flat_ast_index_t flat_parser___expression_list(struct FlatParser*			   p_self,
+											   struct FlatASTNode*			   p_node,
+											   const enum LexerTokenIdentifiers CLOSING,
+											   const struct LexerToken*		   p_open) {
+	flat_ast_index_t* lp_items		  = NULL;
+	size_t			  count			  = 0;
+	size_t			  capacity		  = 0;
+	bool			  noStructLiteral = p_self->noStructLiteral;
+
+	p_self->nesting++;
+	p_self->noStructLiteral = false;
+
+	while (!flat_parser___match(p_self, CLOSING, NULL)) {
+		if (!flat_parser___peek(p_self, 0)) {
+			flat_parser_error(p_self, P0003, "unclosed bracket", p_open);
+		}
+
+		flat_parser___push(&lp_items, &count, &capacity, flat_parser___expression(p_self));
+
+		if (!flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL)
+			&& !flat_parser___check(p_self, CLOSING, NULL)) {
+			flat_parser_error(p_self, P0002, "expected ',' or a closing bracket",
+							  flat_parser___peek(p_self, 0));
+		}
+	}
+
+	p_self->nesting--;
+	p_self->noStructLiteral = noStructLiteral;
+
+	return flat_parser___add_list(p_self, p_node, lp_items, count);
+}
+
+/**
+ * Parses the fields of a struct literal, e.g. '{ x = 1, y = 2 }'. In match patterns, the values
+ * are patterns.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param type    The struct's type.
+ *
+ * @return The STRUCT_LITERAL node.
+ */
+flat_ast_index_t flat_parser___struct_literal(struct FlatParser* p_self, flat_ast_index_t type) {
+	const struct LexerToken* lp_open		 = flat_parser___advance(p_self);
+	struct FlatASTNode		 node			 = flat_parser___node(FLATAST_STRUCT_LITERAL, lp_open);
+	flat_ast_index_t*		 lp_items		 = NULL;
+	size_t					 count			 = 0;
+	size_t					 capacity		 = 0;
+	bool					 noStructLiteral = p_self->noStructLiteral;
+
+	node.line = flat_ast_get(p_self->ast, type)->line;
+	node.lhs  = type;
+
+	p_self->nesting++;
+	p_self->noStructLiteral = false;
+
+	while (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL)) {
+		if (!flat_parser___peek(p_self, 0)) {
+			flat_parser_error(p_self, P0003, "unclosed '{'", lp_open);
+		}
+
+		const struct LexerToken* lp_field =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a field");
+
+		flat_parser___expect(p_self, LEXERTOKENS_ASSIGNMENT, NULL, "'='");
+		flat_parser___push(&lp_items, &count, &capacity,
+						   flat_parser___add_named(p_self, FLATAST_FIELD, lp_field,
+												   lp_field->value->_value,
+												   flat_parser___expression(p_self)));
+
+		if (!flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL)
+			&& !flat_parser___check(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL)) {
+			flat_parser_error(p_self, P0002, "expected ',' or '}'", flat_parser___peek(p_self, 0));
+		}
+	}
+
+	p_self->nesting--;
+	p_self->noStructLiteral = noStructLiteral;
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a primary expression: a literal, a name, a function, a struct, a trait, or a bracketed
+ * expression.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The expression's node.
+ */
+flat_ast_index_t flat_parser___primary(struct FlatParser* p_self) {
+	const struct LexerToken* lp_token = flat_parser___advance(p_self);
+	struct FlatASTNode		 node	  = {0};
+
+	switch (lp_token->identifier) {
+	case LEXERTOKENS_INTEGER:
+		node			   = flat_parser___node(FLATAST_INTEGER, lp_token);
+		node.value.integer = (int64_t)strtoull(lp_token->value->_value, NULL, 10);
+		return flat_ast_add(p_self->ast, &node);
+	case LEXERTOKENS_FLOAT:
+		node				= flat_parser___node(FLATAST_FLOAT, lp_token);
+		node.value.floating = strtod(lp_token->value->_value, NULL);
+		return flat_ast_add(p_self->ast, &node);
+	case LEXERTOKENS_CHR:
+		node			   = flat_parser___node(FLATAST_CHR, lp_token);
+		node.value.integer = (unsigned char)lp_token->value->_value[0];
+		return flat_ast_add(p_self->ast, &node);
+	case LEXERTOKENS_STRING:
+		return flat_parser___add_named(p_self, FLATAST_STRING, lp_token, lp_token->value->_value,
+									   0);
+	case LEXERTOKENS_IDENTIFIER: {
+		flat_ast_index_t name = flat_parser___add_named(p_self, FLATAST_VARIABLE, lp_token,
+														lp_token->value->_value, 0);
+
+		// e.g. 'Stack<T>.new()' or 'Rectangle<i32> { ... }'
+		if (flat_parser___scan_angles(p_self, false, LEXERTOKENS_DOT,
+									  LEXERTOKENS_OPEN_CURLY_BRACE)) {
+			return flat_parser___type_arguments(p_self, name, lp_token);
+		}
+
+		return name;
+	}
+	case LEXERTOKENS_KEYWORD:
+		if (strcmp(lp_token->value->_value, "func") == 0) {
+			return flat_parser___function(p_self, lp_token, false);
+		}
+		if (strcmp(lp_token->value->_value, "struct") == 0) {
+			return flat_parser___struct(p_self, lp_token);
+		}
+		if (strcmp(lp_token->value->_value, "trait") == 0) {
+			return flat_parser___trait(p_self, lp_token);
+		}
+		break;
+	case LEXERTOKENS_OPEN_BRACE: {
+		bool noStructLiteral = p_self->noStructLiteral;
+
+		p_self->nesting++;
+		p_self->noStructLiteral = false;
+
+		flat_ast_index_t expression = flat_parser___expression(p_self);
+
+		if (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_BRACE, NULL)) {
+			flat_parser_error(p_self, P0003, "unclosed '('", lp_token);
+		}
+
+		p_self->nesting--;
+		p_self->noStructLiteral = noStructLiteral;
+
+		return expression;
+	}
+	case LEXERTOKENS_OPEN_SQUARE_BRACE:
+		node = flat_parser___node(FLATAST_ARRAY_LITERAL, lp_token);
+
+		return flat_parser___expression_list(p_self, &node, LEXERTOKENS_CLOSE_SQUARE_BRACE,
+											 lp_token);
+	default:
+		break;
+	}
+
+	flat_parser_error(p_self, P0001,
+					  CONCATENATE_STRING("unexpected token '", lp_token->value->_value, "'"),
+					  lp_token);
+}
+
+/**
+ * Checks whether a '{' after an expression opens a struct literal, which it does after a type with
+ * arguments, or a capitalised name outside of conditions, e.g. 'Point { x = 1 }'.
+ *
+ * @param p_self The current FlatParser struct.
+ * @param node   The expression before the '{'.
+ *
+ * @return Whether the '{' opens a struct literal.
+ */
+bool flat_parser___opens_struct_literal(const struct FlatParser* p_self, flat_ast_index_t node) {
+	const struct FlatASTNode* lp_node = flat_ast_get(p_self->ast, node);
+
+	if (lp_node->kind == FLATAST_TYPE) {
+		return true;
+	}
+
+	return lp_node->kind == FLATAST_VARIABLE && !p_self->noStructLiteral
+		   && isupper((unsigned char)flat_ast_get_string(p_self->ast, lp_node->value.string)[0]);
+}
+
+/**
+ * Parses a primary expression followed by calls, members, '::' names, indexes and struct literal
+ * fields. Indexing is sugar for the 'get' method, e.g. 'a[i]' is 'a.get(i)'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The expression's node.
+ */
+flat_ast_index_t flat_parser___postfix(struct FlatParser* p_self) {
+	flat_ast_index_t expression = flat_parser___primary(p_self);
+
+	while (flat_parser___same_line(p_self)) {
+		const struct LexerToken* lp_token = flat_parser___peek(p_self, 0);
+		struct FlatASTNode		 node	  = {0};
+
+		if (lp_token->identifier == LEXERTOKENS_OPEN_BRACE) {
+			flat_parser___advance(p_self);
+
+			node	 = flat_parser___node(FLATAST_CALL, lp_token);
+			node.lhs = expression;
+			node.line = flat_ast_get(p_self->ast, expression)->line;
+			expression =
+				flat_parser___expression_list(p_self, &node, LEXERTOKENS_CLOSE_BRACE, lp_token);
+		} else if (lp_token->identifier == LEXERTOKENS_DOT) {
+			flat_parser___advance(p_self);
+
+			const struct LexerToken* lp_member =
+				flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a member");
+
+			expression = flat_parser___add_named(p_self, FLATAST_MEMBER, lp_member,
+												 lp_member->value->_value, expression);
+		} else if (lp_token->identifier == LEXERTOKENS_SCOPE_RESOLUTION) {
+			flat_parser___advance(p_self);
+
+			const struct LexerToken* lp_name =
+				flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a name");
+
+			node		   = flat_parser___node(FLATAST_BINARY, lp_token);
+			node.operation = LEXERTOKENS_SCOPE_RESOLUTION;
+			node.lhs	   = expression;
+			node.rhs	   = flat_parser___add_named(p_self, FLATAST_VARIABLE, lp_name,
+													 lp_name->value->_value, 0);
+			expression	   = flat_ast_add(p_self->ast, &node);
+		} else if (lp_token->identifier == LEXERTOKENS_OPEN_SQUARE_BRACE) {
+			flat_parser___advance(p_self);
+			p_self->nesting++;
+
+			flat_ast_index_t index	= flat_parser___expression(p_self);
+			flat_ast_index_t member = flat_parser___add_named(p_self, FLATAST_MEMBER, lp_token,
+															  "get", expression);
+
+			if (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_SQUARE_BRACE, NULL)) {
+				flat_parser_error(p_self, P0003, "unclosed '['", lp_token);
+			}
+
+			p_self->nesting--;
+
+			flat_ast_index_t* lp_items = NULL;
+			size_t			  count = 0, capacity = 0;
+
+			flat_parser___push(&lp_items, &count, &capacity, index);
+
+			node	   = flat_parser___node(FLATAST_CALL, lp_token);
+			node.lhs   = member;
+			expression = flat_parser___add_list(p_self, &node, lp_items, count);
+		} else if (lp_token->identifier == LEXERTOKENS_OPEN_CURLY_BRACE
+				   && flat_parser___opens_struct_literal(p_self, expression)) {
+			expression = flat_parser___struct_literal(p_self, expression);
+		} else {
+			break;
+		}
+	}
+
+	return expression;
+}
+
+/**
+ * Parses a unary expression: a prefix operator or attribute, then a power, e.g. '-x ** 2' is
+ * '-(x ** 2)', and '@await fetch()' applies '@await' to the call.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The expression's node.
+ */
+flat_ast_index_t flat_parser___unary(struct FlatParser* p_self) {
+	const struct LexerToken* lp_token = flat_parser___peek(p_self, 0);
+
+	if (flat_parser___is(lp_token, LEXERTOKENS_SUBTRACTION, NULL)
+		|| flat_parser___is(lp_token, LEXERTOKENS_LOGICAL_NOT, NULL)
+		|| flat_parser___is(lp_token, LEXERTOKENS_BITWISE_NOT, NULL)) {
+		struct FlatASTNode node = flat_parser___node(FLATAST_UNARY, flat_parser___advance(p_self));
+
+		node.operation = (uint8_t)lp_token->identifier;
+		node.lhs	   = flat_parser___unary(p_self);
+
+		return flat_ast_add(p_self->ast, &node);
+	}
+
+	if (flat_parser___is(lp_token, LEXERTOKENS_AT, NULL)) {
+		flat_parser___advance(p_self);
+
+		const struct LexerToken* lp_name =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "an attribute");
+		flat_ast_index_t operand = flat_parser___unary(p_self);
+
+		attributes_apply(p_self->filePath, p_self->ast, operand, lp_name->value->_value);
+
+		return operand;
+	}
+
+	flat_ast_index_t base = flat_parser___postfix(p_self);
+
+	if (flat_parser___same_line(p_self)
+		&& flat_parser___check(p_self, LEXERTOKENS_EXPONENT, NULL)) {
+		struct FlatASTNode node = flat_parser___node(FLATAST_BINARY, flat_parser___advance(p_self));
+
+		node.operation = LEXERTOKENS_EXPONENT;
+		node.lhs	   = base;
+		node.rhs	   = flat_parser___unary(p_self); // Right associative, '2 ** 3 ** 2' is 2 ** 9
+
+		return flat_ast_add(p_self->ast, &node);
+	}
+
+	return base;
+}
+
+/**
+ * Gets the precedence of a binary operator.
+ *
+ * @param IDENTIFIER The operator's token.
+ *
+ * @return The precedence, higher binds tighter, 0 if the token is not a binary operator.
+ */
+unsigned int flat_parser___precedence(const enum LexerTokenIdentifiers IDENTIFIER) {
+	switch (IDENTIFIER) {
+	case LEXERTOKENS_LOGICAL_OR:
+		return 1;
+	case LEXERTOKENS_LOGICAL_AND:
+		return 2;
+	case LEXERTOKENS_EQUAL_TO:
+	case LEXERTOKENS_NOT_EQUAL_TO:
+		return 3;
+	case LEXERTOKENS_GREATER_THAN:
+	case LEXERTOKENS_LESS_THAN:
+	case LEXERTOKENS_GREATER_THAN_OR_EQUAL:
+	case LEXERTOKENS_LESS_THAN_OR_EQUAL:
+		return 4;
+	case LEXERTOKENS_BITWISE_OR:
+		return 5;
+	case LEXERTOKENS_BITWISE_XOR:
+		return 6;
+	case LEXERTOKENS_BITWISE_AND:
+		return 7;
+	case LEXERTOKENS_BITWISE_LEFT_SHIFT:
+	case LEXERTOKENS_BITWISE_RIGHT_SHIFT:
+		return 8;
+	case LEXERTOKENS_ADDITION:
+	case LEXERTOKENS_SUBTRACTION:
+		return 9;
+	case LEXERTOKENS_MULTIPLICATION:
+	case LEXERTOKENS_DIVISION:
+	case LEXERTOKENS_FLOOR_DIVISION:
+	case LEXERTOKENS_MODULO:
+		return 10;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Parses binary operations binding at least as tightly as a precedence, by precedence climbing.
+ *
+ * @param p_self        The current FlatParser struct.
+ * @param minPrecedence The lowest precedence to parse.
+ *
+ * @return The expression's node.
+ */
+flat_ast_index_t flat_parser___binary(struct FlatParser* p_self, unsigned int minPrecedence) {
+	flat_ast_index_t lhs = flat_parser___unary(p_self);
+
+	while (flat_parser___same_line(p_self)) {
+		const struct LexerToken* lp_token	= flat_parser___peek(p_self, 0);
+		unsigned int			 precedence = flat_parser___precedence(lp_token->identifier);
+
+		if (precedence == 0 || precedence < minPrecedence) {
+			break;
+		}
+
+		struct FlatASTNode node = flat_parser___node(FLATAST_BINARY, flat_parser___advance(p_self));
+
+		node.operation = (uint8_t)lp_token->identifier;
+		node.lhs	   = lhs;
+		node.rhs	   = flat_parser___binary(p_self, precedence + 1);
+		lhs			   = flat_ast_add(p_self->ast, &node);
+	}
+
+	return lhs;
+}
+
+flat_ast_index_t flat_parser___expression(struct FlatParser* p_self) {
+	return flat_parser___binary(p_self, 1);
+}
+
+/**
+ * Parses an expression where '{' starts the block after it, e.g. the condition of an 'if'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The expression's node.
+ */
+flat_ast_index_t flat_parser___condition(struct FlatParser* p_self) {
+	bool noStructLiteral = p_self->noStructLiteral;
+
+	p_self->noStructLiteral = true;
+
+	flat_ast_index_t condition = flat_parser___expression(p_self);
+
+	p_self->noStructLiteral = noStructLiteral;
+
+	return condition;
+}
+
+/**
+ * Parses an 'if' with its 'elif' and 'else' branches, after the 'if' keyword.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_token The 'if' keyword.
+ *
+ * @return The IF node, whose list holds an IF node for each 'elif', then the 'else' BLOCK.
+ */
+flat_ast_index_t flat_parser___if(struct FlatParser* p_self, const struct LexerToken* p_token) {
+	struct FlatASTNode node		= flat_parser___node(FLATAST_IF, p_token);
+	flat_ast_index_t*  lp_items = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	node.lhs = flat_parser___condition(p_self);
+	node.rhs = flat_parser___block(p_self);
+
+	while (flat_parser___check(p_self, LEXERTOKENS_KEYWORD, "elif")) {
+		struct FlatASTNode branch = flat_parser___node(FLATAST_IF, flat_parser___advance(p_self));
+
+		branch.lhs = flat_parser___condition(p_self);
+		branch.rhs = flat_parser___block(p_self);
+		flat_parser___push(&lp_items, &count, &capacity, flat_ast_add(p_self->ast, &branch));
+	}
+
+	if (flat_parser___match(p_self, LEXERTOKENS_KEYWORD, "else")) {
+		flat_parser___push(&lp_items, &count, &capacity, flat_parser___block(p_self));
+	}
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a 'for' loop, after the 'for' keyword, e.g. 'for range(0, 5) => i { ... }'.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_token The 'for' keyword.
+ *
+ * @return The FOR node.
+ */
+flat_ast_index_t flat_parser___for(struct FlatParser* p_self, const struct LexerToken* p_token) {
+	struct FlatASTNode node		= flat_parser___node(FLATAST_FOR, p_token);
+	flat_ast_index_t*  lp_items = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	node.lhs = flat_parser___condition(p_self);
+
+	flat_parser___expect(p_self, LEXERTOKENS_ASSIGNMENT_ARROW, NULL, "'=>'");
+
+	do {
+		const struct LexerToken* lp_binding =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "a binding");
+
+		flat_parser___push(&lp_items, &count, &capacity,
+						   flat_parser___add_named(p_self, FLATAST_VARIABLE, lp_binding,
+												   lp_binding->value->_value, 0));
+	} while (flat_parser___match(p_self, LEXERTOKENS_COMMA, NULL));
+
+	node.rhs = flat_parser___block(p_self);
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Parses a 'match', after the 'match' keyword, e.g. 'match x { case 0 => { ... } }'.
+ *
+ * @param p_self  The current FlatParser struct.
+ * @param p_token The 'match' keyword.
+ *
+ * @return The MATCH node.
+ */
+flat_ast_index_t flat_parser___match_statement(struct FlatParser*		p_self,
+											   const struct LexerToken* p_token) {
+	struct FlatASTNode node		= flat_parser___node(FLATAST_MATCH, p_token);
+	flat_ast_index_t*  lp_items = NULL;
+	size_t			   count = 0, capacity = 0;
+
+	node.lhs = flat_parser___condition(p_self);
+
+	const struct LexerToken* lp_open =
+		flat_parser___expect(p_self, LEXERTOKENS_OPEN_CURLY_BRACE, NULL, "'{'");
+
+	while (!flat_parser___match(p_self, LEXERTOKENS_CLOSE_CURLY_BRACE, NULL)) {
+		if (!flat_parser___peek(p_self, 0)) {
+			flat_parser_error(p_self, P0003, "unclosed '{'", lp_open);
+		}
+
+		struct FlatASTNode item = flat_parser___node(
+			FLATAST_CASE, flat_parser___expect(p_self, LEXERTOKENS_KEYWORD, "case", "'case'"));
+
+		item.lhs = flat_parser___expression(p_self);
+
+		flat_parser___expect(p_self, LEXERTOKENS_ASSIGNMENT_ARROW, NULL, "'=>'");
+
+		item.rhs = flat_parser___block(p_self);
+		flat_parser___push(&lp_items, &count, &capacity, flat_ast_add(p_self->ast, &item));
+	}
+
+	return flat_parser___add_list(p_self, &node, lp_items, count);
+}
+
+/**
+ * Gets the node an attribute before a statement applies to: the function or struct of a
+ * declaration, the value of a 'return', or else the statement itself.
+ *
+ * @param p_self    The current FlatParser struct.
+ * @param statement The statement's node.
+ *
+ * @return The node the attribute applies to.
+ */
+flat_ast_index_t flat_parser___attribute_target(const struct FlatParser* p_self,
+												flat_ast_index_t		 statement) {
+	const struct FlatASTNode* lp_statement = flat_ast_get(p_self->ast, statement);
+
+	if (lp_statement->kind == FLATAST_ASSIGNMENT) {
+		uint8_t kind = flat_ast_get(p_self->ast, lp_statement->rhs)->kind;
+
+		if (kind == FLATAST_FUNCTION || kind == FLATAST_STRUCT) {
+			return lp_statement->rhs;
+		}
+	}
+
+	if (lp_statement->kind == FLATAST_RETURN && lp_statement->lhs != FLATAST_INDEX_NONE) {
+		return lp_statement->lhs;
+	}
+
+	return statement;
+}
+
+/**
+ * Checks whether a token is an assignment operator, e.g. '=' or '+='.
+ *
+ * @param p_token The token (can be NULL).
+ *
+ * @return Whether the token is an assignment operator.
+ */
+bool flat_parser___is_assignment(const struct LexerToken* p_token) {
+	return p_token && p_token->identifier >= LEXERTOKENS_ASSIGNMENT
+		   && p_token->identifier <= LEXERTOKENS_BITWISE_RIGHT_SHIFT_ASSIGNMENT;
+}
+
+flat_ast_index_t flat_parser___statement(struct FlatParser* p_self) {
+	const struct LexerToken* lp_token = flat_parser___peek(p_self, 0);
+	struct FlatASTNode		 node	  = {0};
+
+	if (flat_parser___is(lp_token, LEXERTOKENS_AT, NULL)) { // e.g. '@memo' before a declaration
+		flat_parser___advance(p_self);
+
+		const struct LexerToken* lp_name =
+			flat_parser___expect(p_self, LEXERTOKENS_IDENTIFIER, NULL, "an attribute");
+		flat_ast_index_t statement = flat_parser___statement(p_self);
+
+		attributes_apply(p_self->filePath, p_self->ast,
+						 flat_parser___attribute_target(p_self, statement), lp_name->value->_value);
+
+		return statement;
+	}
+
+	if (flat_parser___is(lp_token, LEXERTOKENS_OPEN_CURLY_BRACE, NULL)) {
+		return flat_parser___block(p_self);
+	}
+
+	if (lp_token->identifier == LEXERTOKENS_KEYWORD) {
+		const char* lp_keyword = lp_token->value->_value;
+
+		if (strcmp(lp_keyword, "if") == 0) {
+			return flat_parser___if(p_self, flat_parser___advance(p_self));
+		}
+		if (strcmp(lp_keyword, "while") == 0) {
+			node	 = flat_parser___node(FLATAST_WHILE, flat_parser___advance(p_self));
+			node.lhs = flat_parser___condition(p_self);
+			node.rhs = flat_parser___block(p_self);
+
+			return flat_ast_add(p_self->ast, &node);
+		}
+		if (strcmp(lp_keyword, "for") == 0) {
+			return flat_parser___for(p_self, flat_parser___advance(p_self));
+		}
+		if (strcmp(lp_keyword, "match") == 0) {
+			return flat_parser___match_statement(p_self, flat_parser___advance(p_self));
+		}
+		if (strcmp(lp_keyword, "return") == 0) {
+			node = flat_parser___node(FLATAST_RETURN, flat_parser___advance(p_self));
+
+			if (!flat_parser___at_end(p_self)) {
+				node.lhs = flat_parser___expression(p_self);
+			}
+
+			return flat_ast_add(p_self->ast, &node);
+		}
+		if (strcmp(lp_keyword, "pass") == 0) {
+			node = flat_parser___node(FLATAST_BLOCK, flat_parser___advance(p_self));
+
+			return flat_ast_add(p_self->ast, &node);
+		}
+	}
+
+	flat_ast_index_t target = FLATAST_INDEX_NONE;
+
+	if (flat_parser___is(lp_token, LEXERTOKENS_IDENTIFIER, NULL)) {
+		p_self->current++; // Scanning starts after the name
+
+		bool generic = flat_parser___scan_angles(p_self, true, LEXERTOKENS_ASSIGNMENT,
+												 LEXERTOKENS_ASSIGNMENT);
+
+		p_self->current--;
+
+		if (generic) { // e.g. 'Stack<T: Any> = struct { ... }'
+			target = flat_parser___generic_declaration(p_self);
+		}
+	}
+
+	if (target == FLATAST_INDEX_NONE) {
+		target = flat_parser___expression(p_self);
+	}
+
+	// e.g. 'x: i32 = 20'
+	if (flat_ast_get(p_self->ast, target)->kind == FLATAST_VARIABLE
+		&& flat_parser___same_line(p_self)
+		&& flat_parser___check(p_self, LEXERTOKENS_COLON, NULL)) {
+		flat_parser___advance(p_self);
+
+		target = flat_parser___add_named(
+			p_self, FLATAST_FIELD, lp_token,
+			flat_ast_get_string(p_self->ast, flat_ast_get(p_self->ast, target)->value.string),
+			flat_parser___type(p_self));
+
+		if (!flat_parser___check(p_self, LEXERTOKENS_ASSIGNMENT, NULL)) {
+			flat_parser_error(p_self, P0002, "expected '=', declarations need a value",
+							  flat_parser___peek(p_self, 0));
+		}
+	}
+
+	if (!flat_parser___same_line(p_self)
+		|| !flat_parser___is_assignment(flat_parser___peek(p_self, 0))) {
+		if (flat_ast_get(p_self->ast, target)->kind == FLATAST_TYPE) {
+			flat_parser_error(p_self, P0002, "expected '='", flat_parser___peek(p_self, 0));
+		}
+
+		return target;
+	}
+
+	node			= flat_parser___node(FLATAST_ASSIGNMENT, lp_token);
+	node.operation	= (uint8_t)flat_parser___advance(p_self)->identifier;
+	node.lhs		= target;
+	node.rhs		= flat_parser___expression(p_self);
+
+	return flat_ast_add(p_self->ast, &node);
+}
+
+flat_ast_index_t flat_parser_parse(struct FlatParser* p_self) {
+	while (flat_parser___peek(p_self, 0)) {
+		if (flat_parser___match(p_self, LEXERTOKENS_KEYWORD, "import")) {
+			const struct LexerToken* lp_path =
+				flat_parser___expect(p_self, LEXERTOKENS_STRING, NULL, "a module path");
+
+			array_append(p_self->imports, duplicate_string(lp_path->value->_value));
+
+			size_t* lp_importLinesTemp =
+				realloc(p_self->importLines, p_self->imports->length * sizeof(size_t));
+
+			if (!lp_importLinesTemp) {
+				PANIC("failed to realloc FlatParser import lines");
+			}
+
+			p_self->importLines								 = lp_importLinesTemp;
+			p_self->importLines[p_self->imports->length - 1] = lp_path->lineIndex;
+
+			continue;
+		}
+
+		if (flat_parser___match(p_self, LEXERTOKENS_KEYWORD, "use")) {
+			while (flat_parser___same_line(p_self)) {
+				flat_parser___advance(p_self);
+			}
+
+			continue;
+		}
+
+		flat_ast_index_t statement = flat_parser___statement(p_self);
+
+		if (flat_parser___same_line(p_self)) {
+			flat_parser_error(p_self, P0001, "unexpected token, expected the end of the line",
+							  flat_parser___peek(p_self, 0));
+		}
+
+		return statement;
+	}
+
+	return FLATAST_INDEX_NONE;
+}
@@ -0,0 +1,73 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include "./flat.h"
+#include "../errors.h"
+#include "../lexer/lexer.h"
+#include "../utils/array.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Represents a parser building a FlatAST. The whole file is lexed up front, so the parser can look
+ * ahead and backtrack, e.g. to tell 'Stack<T>.new()' from 'a < b'. Statements end at the end of
+ * their line, unless they are inside brackets.
+ */
+struct FlatParser {
+	const char*	  filePath;
+	struct Lexer* lexer;
+	struct FlatAST* ast;	 // Not owned, the AST the nodes are added to.
+	struct Array*	tokens;	 // The tokens of the file, without comments (not owned).
+	size_t			current; // The index of the next token.
+	size_t			nesting; // How many brackets the parser is in, where newlines do not matter.
+	bool			noStructLiteral; // Whether '{' ends the expression, e.g. in an 'if' condition.
+	bool			splitShift;		 // Whether the first '>' of the next '>>' has been consumed.
+	struct Array*	imports;		 // The paths of the imported modules, e.g. 'std.io'.
+	size_t*			importLines;	 // The line index of each import, for diagnostics.
+};
+
+#define FLATPARSER_STRUCT_SIZE sizeof(struct FlatParser)
+
+/**
+ * Creates a new FlatParser struct, lexing the whole file.
+ *
+ * @param p_filePath The path of the file to parse.
+ * @param p_ast      The AST to add the nodes to.
+ *
+ * @return The created FlatParser struct.
+ */
+struct FlatParser* flat_parser_new(const char* p_filePath, struct FlatAST* p_ast);
+
+/**
+ * Frees a FlatParser struct.
+ *
+ * @param p_self The current FlatParser struct.
+ */
+void flat_parser_free(struct FlatParser** p_self);
+
+/**
+ * Prints a parsing error at a token and exits.
+ *
+ * @param p_self     The current FlatParser struct.
+ * @param ERROR      The error's identifier.
+ * @param p_errorMsg The error message.
+ * @param p_token    The erroneous token, NULL for the end of the file.
+ */
+__attribute__((noreturn)) void
+flat_parser_error(struct FlatParser*		  p_self,
+				  const enum ErrorIdentifiers ERROR, // NOLINT(readability-avoid-const-params-in-decls)
+				  const char* p_errorMsg, const struct LexerToken* p_token);
+
+/**
+ * Parses the next top-level statement. Imports are recorded in the parser's imports, and 'use'
+ * statements are skipped, as every name of a module is reached through 'module::name'.
+ *
+ * @param p_self The current FlatParser struct.
+ *
+ * @return The statement's node, or FLATAST_INDEX_NONE at the end of the file.
+ */
+flat_ast_index_t flat_parser_parse(struct FlatParser* p_self);
@@ -0,0 +1,32 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./buffer.h"
+#include "./panic.h"
+#include <stdlib.h>
+#include <string.h>
+
+void* buffer_grow(void* p_buffer, size_t* p_capacity, size_t required, size_t elementSize) {
+	if (required <= *p_capacity) {
+		return p_buffer;
+	}
+
+	size_t capacity = *p_capacity ? *p_capacity : BUFFER_INITIAL_CAPACITY;
+
+	while (capacity < required) {
+		capacity *= 2;
+	}
+
+	char* lp_bufferTemp = realloc(p_buffer, capacity * elementSize);
+
+	if (!lp_bufferTemp) {
+		PANIC("failed to realloc buffer");
+	}
+
+	memset(lp_bufferTemp + (*p_capacity * elementSize), 0, (capacity - *p_capacity) * elementSize);
+	*p_capacity = capacity;
+
+	return lp_bufferTemp;
+}
@@ -0,0 +1,23 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define BUFFER_INITIAL_CAPACITY 16U // The capacity of a buffer's first allocation, in elements.
+
+/**
+ * Grows a buffer so it can hold at least the required number of elements, doubling its capacity.
+ * New elements are zeroed.
+ *
+ * @param p_buffer    The buffer to grow (can be NULL).
+ * @param p_capacity  The capacity of the buffer, in elements, updated when it grows.
+ * @param required    The number of elements the buffer must be able to hold.
+ * @param elementSize The size of an element.
+ *
+ * @return The grown buffer, which may have moved.
+ */
+void* buffer_grow(void* p_buffer, size_t* p_capacity, size_t required, size_t elementSize);
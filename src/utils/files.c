@@ -4,11 +4,25 @@
  */
 
 #include "./files.h"
+#include "./conversions.h"
 #include "./panic.h"
 #include "./str.h"
 #include <errno.h>
 #include <limits.h>
 #include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define getpid			   _getpid
+#define mkdir(path, mode) _mkdir(path)
+#define S_ISDIR(mode)	  (((mode) & _S_IFMT) == _S_IFDIR)
+#else
+#include <unistd.h>
+#endif
+
+#define DIRECTORY_MODE 0755
 
 void fclose_safe(FILE* p_filePointer) {
 	if (fclose(p_filePointer) != 0) {
@@ -29,3 +43,110 @@ int fgetc_safe(FILE* p_filePointer) {
 
 	return chr;
 }
+
+char* file_read(const char* p_filePath, size_t* p_length) {
+	FILE* lp_filePointer = fopen(p_filePath, "rb");
+
+	if (!lp_filePointer) {
+		return NULL;
+	}
+
+	size_t capacity = BUFSIZ;
+	size_t length	= 0;
+	char*  lp_data	= malloc(capacity + 1);
+
+	if (!lp_data) {
+		PANIC("failed to malloc file contents");
+	}
+
+	size_t read = 0;
+
+	while ((read = fread(lp_data + length, 1, capacity - length, lp_filePointer)) > 0) {
+		length += read;
+
+		if (length == capacity) { // Buffer is full, double it
+			capacity *= 2;
+
+			char* lp_dataTemp = realloc(lp_data, capacity + 1);
+
+			if (!lp_dataTemp) {
+				PANIC("failed to realloc file contents");
+			}
+
+			lp_data = lp_dataTemp;
+		}
+	}
+
+	if (ferror(lp_filePointer)) {
+		PANIC(CONCATENATE_STRING("failed to fread file '", p_filePath, "': ",
+								 strerror(errno))); // NOLINT(concurrency-mt-unsafe)
+	}
+
+	fclose_safe(lp_filePointer);
+
+	lp_data[length] = '\0';
+
+	if (p_length) {
+		*p_length = length;
+	}
+
+	return lp_data;
+}
+
+bool file_write_atomic(const char* p_filePath, const void* p_data, size_t length) {
+	char* lp_pid	  = ul_to_string((size_t)getpid());
+	char* lp_tempPath = CONCATENATE_STRING(p_filePath, ".", lp_pid, ".tmp"); // Unique per process
+
+	free(lp_pid);
+
+	FILE* lp_filePointer = fopen(lp_tempPath, "wb");
+
+	if (!lp_filePointer) {
+		free(lp_tempPath);
+
+		return false;
+	}
+
+	bool written = fwrite(p_data, 1, length, lp_filePointer) == length;
+
+	written = fclose(lp_filePointer) == 0 && written;
+
+	if (written) {
+#ifdef _WIN32
+		remove(p_filePath); // Windows' rename does not replace an existing file
+#endif
+		written = rename(lp_tempPath, p_filePath) == 0;
+	}
+
+	if (!written) {
+		remove(lp_tempPath);
+	}
+
+	free(lp_tempPath);
+
+	return written;
+}
+
+bool directory_create(const char* p_directoryPath) {
+	char* lp_path = duplicate_string(p_directoryPath);
+
+	// Create each parent in turn by temporarily terminating the path at every separator
+	for (char* lp_chr = lp_path + 1; *lp_chr; lp_chr++) {
+		if (*lp_chr == '/' || *lp_chr == '\\') {
+			char separator = *lp_chr;
+
+			*lp_chr = '\0';
+			mkdir(lp_path, DIRECTORY_MODE);
+			*lp_chr = separator;
+		}
+	}
+
+	mkdir(lp_path, DIRECTORY_MODE);
+
+	struct stat info;
+	bool		exists = stat(lp_path, &info) == 0 && S_ISDIR(info.st_mode);
+
+	free(lp_path);
+
+	return exists;
+}
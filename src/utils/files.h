@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdio.h>
 
 /**
@@ -22,3 +23,34 @@ void fclose_safe(FILE* p_filePointer);
  * @return The character.
  */
 int fgetc_safe(FILE* p_filePointer);
+
+/**
+ * Reads the entire contents of a file.
+ *
+ * @param p_filePath The path of the file to read.
+ * @param p_length   Where to write the length of the contents (can be NULL).
+ *
+ * @return The null-terminated contents, or NULL if the file could not be opened.
+ */
+char* file_read(const char* p_filePath, size_t* p_length);
+
+/**
+ * Writes data to a file atomically, by writing to a temporary file next to it and renaming it over
+ * the destination. Readers therefore never observe a partially written file.
+ *
+ * @param p_filePath The path of the file to write.
+ * @param p_data     The data to write.
+ * @param length     The length of the data.
+ *
+ * @return Whether the file was written.
+ */
+bool file_write_atomic(const char* p_filePath, const void* p_data, size_t length);
+
+/**
+ * Creates a directory and any missing parent directories.
+ *
+ * @param p_directoryPath The path of the directory to create.
+ *
+ * @return Whether the directory exists afterwards.
+ */
+bool directory_create(const char* p_directoryPath);
@@ -63,6 +63,7 @@ void hashmap_free(struct Hashmap** p_self, void (*p_freeElement)(const void*)) {
 			}
 		}
 
+		free((*p_self)->buckets);
 		free(*p_self);
 		*p_self = NULL;
 	} else {
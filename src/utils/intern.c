@@ -0,0 +1,171 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./intern.h"
+#include "../globals.h"
+#include "./hashmap.h"
+#include "./panic.h"
+#include "./str.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERNER_INITIAL_CAPACITY 64U
+
+/**
+ * Reallocates a buffer, panicking on failure.
+ *
+ * @param p_buffer The buffer to reallocate.
+ * @param size     The new size of the buffer.
+ *
+ * @return The reallocated buffer.
+ */
+void* interner___realloc(void* p_buffer, size_t size) {
+	void* lp_bufferTemp = realloc(p_buffer, size);
+
+	if (!lp_bufferTemp) {
+		PANIC("failed to realloc Interner buffer");
+	}
+
+	return lp_bufferTemp;
+}
+
+/**
+ * Rebuilds the hash table with double the slots. Uses the stored hashes, so no string is rehashed.
+ *
+ * @param p_self The current Interner struct.
+ */
+void interner___grow_slots(struct Interner* p_self) {
+	free(p_self->slots);
+
+	p_self->slotCount *= 2;
+	p_self->slots = calloc(p_self->slotCount, sizeof(intern_id_t));
+
+	if (!p_self->slots) {
+		PANIC("failed to calloc Interner slots");
+	}
+
+	for (intern_id_t id = 0; id < p_self->count; id++) {
+		size_t slot = p_self->hashes[id] & (p_self->slotCount - 1);
+
+		while (p_self->slots[slot]) {
+			slot = (slot + 1) & (p_self->slotCount - 1);
+		}
+
+		p_self->slots[slot] = id + 1;
+	}
+}
+
+struct Interner* interner_new(void) {
+	struct Interner* lp_self = calloc(1, INTERNER_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Interner struct");
+	}
+
+	lp_self->slotCount = INTERNER_INITIAL_CAPACITY / 2; // Doubled by the first grow
+	interner___grow_slots(lp_self);
+
+	interner_intern(lp_self, ""); // Reserve INTERN_ID_NONE
+
+	return lp_self;
+}
+
+void interner_free(struct Interner** p_self) {
+	if (p_self && *p_self) {
+		free((*p_self)->strings);
+		free((*p_self)->offsets);
+		free((*p_self)->hashes);
+		free((*p_self)->slots);
+
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Interner struct has already been freed");
+	}
+}
+
+/**
+ * Finds the slot of a string, or the empty slot it would be inserted into.
+ *
+ * @param p_self   The current Interner struct.
+ * @param p_string The string to find.
+ * @param hash     The hash of the string.
+ *
+ * @return The index of the slot.
+ */
+size_t interner___find_slot(const struct Interner* p_self, const char* p_string, uint32_t hash) {
+	size_t slot = hash & (p_self->slotCount - 1);
+
+	while (p_self->slots[slot]) {
+		intern_id_t id = p_self->slots[slot] - 1;
+
+		if (p_self->hashes[id] == hash
+			&& strcmp(p_self->strings + p_self->offsets[id], p_string) == 0) {
+			break;
+		}
+
+		slot = (slot + 1) & (p_self->slotCount - 1);
+	}
+
+	return slot;
+}
+
+intern_id_t interner_intern(struct Interner* p_self, const char* p_string) {
+	uint32_t hash = (uint32_t)hashmap_hash_djb2(p_string);
+	size_t	 slot = interner___find_slot(p_self, p_string, hash);
+
+	if (p_self->slots[slot]) { // Already interned
+		return p_self->slots[slot] - 1;
+	}
+
+	if (p_self->count == UINT32_MAX - 1) {
+		PANIC("too many interned strings");
+	}
+
+	if (p_self->count == p_self->capacity) {
+		p_self->capacity = p_self->capacity ? p_self->capacity * 2 : INTERNER_INITIAL_CAPACITY;
+		p_self->offsets	 = interner___realloc(p_self->offsets, p_self->capacity * sizeof(uint32_t));
+		p_self->hashes	 = interner___realloc(p_self->hashes, p_self->capacity * sizeof(uint32_t));
+	}
+
+	size_t length = strlen_safe(p_string) + 1; // Include the null terminator
+
+	if (p_self->stringsLength + length > p_self->stringsCapacity) {
+		while (p_self->stringsLength + length > p_self->stringsCapacity) {
+			p_self->stringsCapacity =
+				p_self->stringsCapacity ? p_self->stringsCapacity * 2 : MAX_STRING_LENGTH;
+		}
+
+		p_self->strings = interner___realloc(p_self->strings, p_self->stringsCapacity);
+	}
+
+	intern_id_t id = (intern_id_t)p_self->count++;
+
+	memcpy(p_self->strings + p_self->stringsLength, p_string, length);
+	p_self->offsets[id] = (uint32_t)p_self->stringsLength;
+	p_self->hashes[id]	= hash;
+	p_self->stringsLength += length;
+	p_self->slots[slot] = id + 1;
+
+	if (p_self->count * 2 > p_self->slotCount) { // Keep the load factor at or below 0.5
+		interner___grow_slots(p_self);
+	}
+
+	return id;
+}
+
+intern_id_t interner_find(const struct Interner* p_self, const char* p_string) {
+	size_t slot = interner___find_slot(p_self, p_string, (uint32_t)hashmap_hash_djb2(p_string));
+
+	return p_self->slots[slot] ? p_self->slots[slot] - 1 : INTERN_ID_NONE;
+}
+
+const char* interner_get(const struct Interner* p_self, intern_id_t id) {
+	if (id >= p_self->count) {
+		PANIC("Interner get id out of bounds");
+	}
+
+	return p_self->strings + p_self->offsets[id];
+}
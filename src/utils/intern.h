@@ -0,0 +1,74 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Identifies an interned string. Equal strings always get the same id, so comparing two interned
+ * strings is an integer compare, and ids can directly index side tables.
+ */
+typedef uint32_t intern_id_t;
+
+#define INTERN_ID_NONE ((intern_id_t)0) // The id of the empty string.
+
+/**
+ * Represents a string interner.
+ */
+struct Interner {
+	char*		 strings; // Pool holding every interned string, null-terminated.
+	uint32_t*	 offsets; // Offset of each id's string in the pool.
+	uint32_t*	 hashes;  // Hash of each id's string, so the table can grow without rehashing.
+	intern_id_t* slots;	  // Open addressing table of ids + 1, 0 marks an empty slot.
+	size_t		 count, capacity, stringsLength, stringsCapacity, slotCount;
+};
+
+#define INTERNER_STRUCT_SIZE sizeof(struct Interner)
+
+/**
+ * Creates a new Interner struct.
+ *
+ * @return The created Interner struct.
+ */
+struct Interner* interner_new(void);
+
+/**
+ * Frees an Interner struct.
+ *
+ * @param p_self The current Interner struct.
+ */
+void interner_free(struct Interner** p_self);
+
+/**
+ * Interns a string, copying it into the interner if it has not been seen before.
+ *
+ * @param p_self   The current Interner struct.
+ * @param p_string The string to intern.
+ *
+ * @return The id of the string.
+ */
+intern_id_t interner_intern(struct Interner* p_self, const char* p_string);
+
+/**
+ * Looks up the id of a string without interning it.
+ *
+ * @param p_self   The current Interner struct.
+ * @param p_string The string to look up.
+ *
+ * @return The id of the string, or INTERN_ID_NONE if it has not been interned.
+ */
+intern_id_t interner_find(const struct Interner* p_self, const char* p_string);
+
+/**
+ * Gets the string of an id. The pointer is invalidated by the next call to interner_intern.
+ *
+ * @param p_self The current Interner struct.
+ * @param id     The id of the string.
+ *
+ * @return The string.
+ */
+const char* interner_get(const struct Interner* p_self, intern_id_t id);
@@ -0,0 +1,169 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#include "./sha256.h"
+#include "./panic.h"
+#include "./str.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The first 32 bits of the fractional parts of the cube roots of the first 64 primes.
+static const uint32_t g_SHA256_ROUND_CONSTANTS[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+// The first 32 bits of the fractional parts of the square roots of the first 8 primes.
+static const uint32_t g_SHA256_INITIAL_STATE[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+												   0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+#define SHA256_ROTR(value, bits) (((value) >> (bits)) | ((value) << (32U - (bits))))
+
+struct Sha256* sha256_new(void) {
+	struct Sha256* lp_self = malloc(SHA256_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc Sha256 struct");
+	}
+
+	memcpy(lp_self->state, g_SHA256_INITIAL_STATE, sizeof(g_SHA256_INITIAL_STATE));
+	lp_self->length		  = 0;
+	lp_self->bufferLength = 0;
+
+	return lp_self;
+}
+
+/**
+ * Compresses a single 64 byte block into the state.
+ *
+ * @param p_self  The current Sha256 struct.
+ * @param p_block The block to compress.
+ */
+void sha256___compress(struct Sha256* p_self, const unsigned char* p_block) {
+	uint32_t schedule[64];
+
+	for (size_t index = 0; index < 16; index++) {
+		schedule[index] = ((uint32_t)p_block[index * 4] << 24U)
+						  | ((uint32_t)p_block[index * 4 + 1] << 16U)
+						  | ((uint32_t)p_block[index * 4 + 2] << 8U)
+						  | (uint32_t)p_block[index * 4 + 3];
+	}
+
+	for (size_t index = 16; index < 64; index++) {
+		uint32_t sigma0 = SHA256_ROTR(schedule[index - 15], 7U)
+						  ^ SHA256_ROTR(schedule[index - 15], 18U) ^ (schedule[index - 15] >> 3U);
+		uint32_t sigma1 = SHA256_ROTR(schedule[index - 2], 17U)
+						  ^ SHA256_ROTR(schedule[index - 2], 19U) ^ (schedule[index - 2] >> 10U);
+
+		schedule[index] = schedule[index - 16] + sigma0 + schedule[index - 7] + sigma1;
+	}
+
+	uint32_t working[8];
+	memcpy(working, p_self->state, sizeof(working));
+
+	for (size_t index = 0; index < 64; index++) {
+		uint32_t sum1 = SHA256_ROTR(working[4], 6U) ^ SHA256_ROTR(working[4], 11U)
+					  ^ SHA256_ROTR(working[4], 25U);
+		uint32_t choice = (working[4] & working[5]) ^ (~working[4] & working[6]);
+		uint32_t temp1 =
+			working[7] + sum1 + choice + g_SHA256_ROUND_CONSTANTS[index] + schedule[index];
+		uint32_t sum0 = SHA256_ROTR(working[0], 2U) ^ SHA256_ROTR(working[0], 13U)
+					  ^ SHA256_ROTR(working[0], 22U);
+		uint32_t majority =
+			(working[0] & working[1]) ^ (working[0] & working[2]) ^ (working[1] & working[2]);
+
+		memmove(working + 1, working, 7 * sizeof(uint32_t)); // Shift the working variables down.
+
+		working[4] += temp1;
+		working[0] = temp1 + sum0 + majority;
+	}
+
+	for (size_t index = 0; index < 8; index++) {
+		p_self->state[index] += working[index];
+	}
+}
+
+void sha256_update(struct Sha256* p_self, const void* p_data, size_t length) {
+	const unsigned char* lp_bytes = p_data;
+
+	p_self->length += length;
+
+	while (length > 0) {
+		size_t toCopy = SHA256_BLOCK_SIZE - p_self->bufferLength;
+
+		if (toCopy > length) {
+			toCopy = length;
+		}
+
+		memcpy(p_self->buffer + p_self->bufferLength, lp_bytes, toCopy);
+
+		p_self->bufferLength += toCopy;
+		lp_bytes += toCopy;
+		length -= toCopy;
+
+		if (p_self->bufferLength == SHA256_BLOCK_SIZE) {
+			sha256___compress(p_self, p_self->buffer);
+			p_self->bufferLength = 0;
+		}
+	}
+}
+
+void sha256_update_str(struct Sha256* p_self, const char* p_string) {
+	sha256_update(p_self, p_string ? p_string : "", strlen_safe(p_string) + 1);
+}
+
+void sha256_digest(struct Sha256* p_self, unsigned char p_digest[SHA256_DIGEST_SIZE]) {
+	uint64_t bitLength = p_self->length * 8U;
+
+	p_self->buffer[p_self->bufferLength++] = 0x80;
+
+	if (p_self->bufferLength > SHA256_BLOCK_SIZE - 8) { // No room left for the length.
+		memset(p_self->buffer + p_self->bufferLength, 0, SHA256_BLOCK_SIZE - p_self->bufferLength);
+		sha256___compress(p_self, p_self->buffer);
+		p_self->bufferLength = 0;
+	}
+
+	memset(p_self->buffer + p_self->bufferLength, 0, SHA256_BLOCK_SIZE - 8 - p_self->bufferLength);
+
+	for (size_t index = 0; index < 8; index++) { // Big-endian message length in bits.
+		p_self->buffer[SHA256_BLOCK_SIZE - 1 - index] = (unsigned char)(bitLength >> (index * 8U));
+	}
+
+	sha256___compress(p_self, p_self->buffer);
+
+	for (size_t index = 0; index < SHA256_DIGEST_SIZE; index++) {
+		p_digest[index] = (unsigned char)(p_self->state[index / 4] >> (24U - (index % 4) * 8U));
+	}
+}
+
+char* sha256_hex_digest(struct Sha256* p_self) {
+	static const char* const lp_HEX_DIGITS = "0123456789abcdef";
+
+	unsigned char digest[SHA256_DIGEST_SIZE];
+	char*		  lp_hex = create_string_safe(SHA256_HEX_SIZE);
+
+	sha256_digest(p_self, digest);
+
+	for (size_t index = 0; index < SHA256_DIGEST_SIZE; index++) {
+		lp_hex[index * 2]	  = lp_HEX_DIGITS[digest[index] >> 4U];
+		lp_hex[index * 2 + 1] = lp_HEX_DIGITS[digest[index] & 0x0FU];
+	}
+
+	return lp_hex;
+}
+
+void sha256_free(struct Sha256** p_self) {
+	if (p_self && *p_self) {
+		free(*p_self);
+		*p_self = NULL;
+	} else {
+		PANIC("Sha256 struct has already been freed");
+	}
+}
@@ -0,0 +1,74 @@
+/**
+ * Part of the Exeme Project, under the MIT license. See '/LICENSE' for
+ * license information. SPDX-License-Identifier: MIT License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_BLOCK_SIZE  64U
+#define SHA256_DIGEST_SIZE 32U
+#define SHA256_HEX_SIZE	   (SHA256_DIGEST_SIZE * 2U)
+
+/**
+ * Represents an in-progress SHA-256 computation.
+ */
+struct Sha256 {
+	uint32_t	  state[8];					// The intermediate hash value.
+	uint64_t	  length;					// Number of bytes hashed so far.
+	size_t		  bufferLength;				// Number of bytes waiting in the buffer.
+	unsigned char buffer[SHA256_BLOCK_SIZE]; // Bytes not yet forming a full block.
+};
+
+#define SHA256_STRUCT_SIZE sizeof(struct Sha256)
+
+/**
+ * Creates a new Sha256 struct.
+ *
+ * @return The created Sha256 struct.
+ */
+struct Sha256* sha256_new(void);
+
+/**
+ * Feeds data into the hash.
+ *
+ * @param p_self The current Sha256 struct.
+ * @param p_data The data to hash.
+ * @param length The length of the data.
+ */
+void sha256_update(struct Sha256* p_self, const void* p_data, size_t length);
+
+/**
+ * Feeds a string, including its null terminator, into the hash. Including the terminator keeps
+ * consecutive strings from running into each other (e.g. "ab" + "c" vs "a" + "bc").
+ *
+ * @param p_self   The current Sha256 struct.
+ * @param p_string The string to hash.
+ */
+void sha256_update_str(struct Sha256* p_self, const char* p_string);
+
+/**
+ * Finishes the hash. The struct must not be updated afterwards.
+ *
+ * @param p_self   The current Sha256 struct.
+ * @param p_digest Where to write the digest.
+ */
+void sha256_digest(struct Sha256* p_self, unsigned char p_digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * Finishes the hash, returning the digest as a lowercase hexadecimal string.
+ *
+ * @param p_self The current Sha256 struct.
+ *
+ * @return The hexadecimal digest.
+ */
+char* sha256_hex_digest(struct Sha256* p_self);
+
+/**
+ * Frees a Sha256 struct.
+ *
+ * @param p_self The current Sha256 struct.
+ */
+void sha256_free(struct Sha256** p_self);
@@ -36,6 +36,19 @@ struct String* string_new(char* p_string, bool copy) {
 	return lp_self;
 }
 
+struct String* string_new_with_length(char* p_string, size_t length) {
+	struct String* lp_self = malloc(STRING_STRUCT_SIZE);
+
+	if (!lp_self) {
+		PANIC("failed to malloc String struct");
+	}
+
+	lp_self->_value = p_string;
+	lp_self->length = length;
+
+	return lp_self;
+}
+
 /**
  * Reallocates the struct's string.
  *
@@ -60,14 +73,14 @@ void string_append_chr(struct String* p_self, char chr) {
 }
 
 void string_append_str(struct String* p_self, const char* p_string) {
-	size_t length = strlen_safe(p_string);
+	string_append_bytes(p_self, p_string, strlen_safe(p_string));
+}
 
+void string_append_bytes(struct String* p_self, const char* p_bytes, size_t length) {
 	string___realloc(p_self, p_self->length + length + 1); // 1 for null terminator
 
-	for (size_t index = 0; index < length; index++) {
-		p_self->_value[p_self->length++] = p_string[index];
-	}
-
+	memcpy(p_self->_value + p_self->length, p_bytes, length);
+	p_self->length += length;
 	p_self->_value[p_self->length] = '\0';
 }
 
@@ -29,6 +29,17 @@ struct String {
  */
 struct String* string_new(char* p_string, bool copy);
 
+/**
+ * Creates a new String struct that takes ownership of a buffer whose length is already known.
+ * Unlike string_new, this is not limited to MAX_STRING_LENGTH, so it suits file contents.
+ *
+ * @param p_string The null-terminated buffer to take ownership of.
+ * @param length The length of the buffer, excluding the null terminator.
+ *
+ * @return The created String struct.
+ */
+struct String* string_new_with_length(char* p_string, size_t length);
+
 /**
  * Appends a char to the String.
  *
@@ -45,6 +56,15 @@ void string_append_chr(struct String* p_self, char chr);
  */
 void string_append_str(struct String* p_self, const char* p_string);
 
+/**
+ * Appends bytes to the String, e.g. another String, which can be longer than MAX_STRING_LENGTH.
+ *
+ * @param p_self The current String struct.
+ * @param p_bytes The bytes to append.
+ * @param length The number of bytes.
+ */
+void string_append_bytes(struct String* p_self, const char* p_bytes, size_t length);
+
 /**
  * Removes all the elements from the String.
  *